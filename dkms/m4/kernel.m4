@@ -47,6 +47,8 @@ AC_DEFUN([AC_CONFIG_KERNEL], [
 	AC_POLL_T
 	AC_RTC_KTIME_TO_TM
 	AC_KFREE_SENSITIVE
+	AC_VM_FLAGS_SET
+	AC_WAIT_QUEUE_ENTRY
 	AC_GET_USER_PAGES_REMOTE_6_ARG
 	AC_GET_USER_PAGES_REMOTE_7_ARG
 	AC_UP_DOWN_READ
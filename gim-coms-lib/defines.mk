@@ -41,3 +41,8 @@ DEFAULT_CFLAGS   = -Wall -Wextra -Werror \
 			-Wno-missing-field-initializers \
 			-Wmissing-prototypes \
 			-Werror=conversion \
+
+DEFAULT_CXXFLAGS = -Wall -Wextra -Werror \
+			-Wno-missing-field-initializers \
+			-Wmissing-declarations \
+			-Werror=conversion \
@@ -66,6 +66,11 @@ package: default
 .PHONY: all
 all: default
 
+# Build and run the unit tests
+.PHONY: tests
+tests:
+	$(MAKE) -f $(GIM_COMS_ROOT)/tests/gim_coms_tests.mk run
+
 vpath %.c $(GIM_COMS_SOURCE_DIR)
 
 $(OBJS): Makefile
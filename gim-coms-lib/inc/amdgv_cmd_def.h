@@ -421,12 +421,24 @@ struct amdgv_common_ioctl_out{
 	uint8_t clt_output[AMDGV_COMMON_IOCTL_OUT_SIZE];
 };
 
+/* cmd_header flags
+ * CMD_HDR_FLAG_MUX: the connection is shared by several threads of the
+ *   client. The server answers each command with a cmd_header echoing
+ *   cmd_id (IOCTL_RECV_HDR_MASK kept set) and req_id, followed by the
+ *   command, in any order. A server ignoring the flag answers with the bare
+ *   command, which the client detects on the first reply and then falls
+ *   back to a connection per thread.
+ */
+#define CMD_HDR_FLAG_MUX	(1 << 0)
+
 struct cmd_header {
 	uint32_t cmd_id;
 	uint32_t thread_fd;
 	uint32_t primary_fd;
 	uint32_t pid;
-	uint32_t reserved[8];
+	uint32_t req_id;
+	uint32_t flags;
+	uint32_t reserved[6];
 };
 
 struct amdgv_cmd {
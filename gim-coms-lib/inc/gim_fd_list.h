@@ -23,11 +23,12 @@
 #ifndef _GIM_FD_LIST_H_
 #define _GIM_FD_LIST_H_
 
+#include <stdint.h>
 #include <pthread.h>
-#define __USE_GNU
-#include <search.h>
 #include <sys/queue.h>
 
+struct gim_mux_conn;
+
 typedef struct fd_list_entry {
 	int fd;
 	pthread_t tid;
@@ -37,12 +38,21 @@ typedef struct fd_list_entry {
 typedef struct fd_list_head {
 	struct fd_list_entry *slh_first;
 	pthread_mutex_t fd_list_mutex;
+	/* tells a reused primary fd number apart in the per-thread cache */
+	uint32_t gen;
+	/* multiplexed connection on the primary fd, see gim_ioctl_mux.h */
+	struct gim_mux_conn *mux;
+	/* one for the table and one per get_fd_list() caller, counted under
+	 * fd_list_mutex. The sockets and mux go with the last reference.
+	 */
+	int refcnt;
 } fd_list_head;
 
 int create_fd_list(int fd);
 struct fd_list_head *get_fd_list(int fd);
+void put_fd_list(struct fd_list_head *fd_list);
 int search_fd_from_fd_list(int fd);
 int insert_fd_into_fd_list(int curr_fd, int fd);
 int destroy_fd_list(int fd);
 
-#endif // _GIM_FD_LIST_H_
\ No newline at end of file
+#endif // _GIM_FD_LIST_H_
@@ -26,6 +26,8 @@
 #include "amdgv_cmd_def.h"
 #include "smi_cmd_def.h"
 
+ssize_t gim_ioctl_msghdr_send_cmd(int fd, struct cmd_header *hdr, void *cmd, size_t cmd_size);
+ssize_t gim_ioctl_msghdr_recv_all(int fd, void *buf, size_t len);
 ssize_t gim_ioctl_msghdr_send_fd(int fd, int fd2ser);
 ssize_t gim_ioctl_msghdr_send_shm_fd(struct amdgv_cmd_shm_info *shm_info, int fd);
 ssize_t gim_ioctl_msghdr_send_smi_fd(uint32_t *smi_payload, int fd);
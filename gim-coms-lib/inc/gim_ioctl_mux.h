@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _GIM_IOCTL_MUX_H_
+#define _GIM_IOCTL_MUX_H_
+
+#include <stddef.h>
+
+struct gim_mux_conn;
+
+/* gim_mux_ioctl() result when the server turned out not to support
+ * CMD_HDR_FLAG_MUX, the caller should use a connection per thread
+ */
+#define GIM_MUX_UNSUPPORTED 1
+
+struct gim_mux_conn *gim_mux_conn_create(int fd);
+void gim_mux_conn_destroy(struct gim_mux_conn *conn);
+int gim_mux_ioctl(struct gim_mux_conn *conn, int primary_fd, void *cmd, size_t cmd_size);
+
+#endif // _GIM_IOCTL_MUX_H_
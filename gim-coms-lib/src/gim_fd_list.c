@@ -30,88 +30,102 @@
 #include <sys/socket.h>
 
 #include "gim_fd_list.h"
+#include "gim_ioctl_mux.h"
 
-#define MAX_THREADS	64
+#define FD_TABLE_MIN_SIZE	64
+#define FD_CACHE_SLOTS		8
 
-pthread_mutex_t ht_mutex = PTHREAD_MUTEX_INITIALIZER;
-static int hash_table_cnt;
-struct hsearch_data htab_fd_list;
+/* primary fd -> fd list, indexed by the fd number itself. Lookups only
+ * take the read side, the table is written on open and close.
+ */
+static pthread_rwlock_t fd_table_lock = PTHREAD_RWLOCK_INITIALIZER;
+static struct fd_list_head **fd_table;
+static int fd_table_size;
+static int fd_table_cnt;
+static uint32_t fd_list_gen;
+
+/* per-thread cache of the socket a thread uses for a primary fd, so the
+ * common case neither takes fd_list_mutex nor walks the list
+ */
+struct fd_cache_entry {
+	int primary_fd;
+	uint32_t gen;
+	int fd;
+};
 
-static int __hash_table_create(struct hsearch_data *htab)
-{
-	if (!hcreate_r(MAX_THREADS, htab))
-		return -1;
-	return 0;
-}
+static __thread struct fd_cache_entry fd_cache[FD_CACHE_SLOTS];
 
-static int __hash_table_insert(struct hsearch_data *htab, char *key, void *data)
+static void fd_cache_update(int primary_fd, uint32_t gen, int fd)
 {
-	ENTRY e, *ep;
-	e.key = strdup(key);
-	e.data = data;
+	struct fd_cache_entry *cache = &fd_cache[(unsigned int)primary_fd % FD_CACHE_SLOTS];
 
-	if (!hsearch_r(e, ENTER, &ep, htab))
-		return -1;
-
-	return 0;
+	cache->primary_fd = primary_fd;
+	cache->gen = gen;
+	cache->fd = fd;
 }
 
-static void *__hash_table_search(struct hsearch_data *htab, char *key)
+static int fd_table_insert(int fd, struct fd_list_head *fd_list)
 {
-	ENTRY e, *ep;
-	e.key = key;
-	e.data = NULL;
+	struct fd_list_head **table;
+	int size;
+
+	pthread_rwlock_wrlock(&fd_table_lock);
+	if (fd >= fd_table_size) {
+		size = fd_table_size ? fd_table_size : FD_TABLE_MIN_SIZE;
+		while (size <= fd)
+			size *= 2;
+
+		table = (struct fd_list_head **)realloc(fd_table, (size_t)size * sizeof(*table));
+		if (!table) {
+			pthread_rwlock_unlock(&fd_table_lock);
+			return -ENOMEM;
+		}
+		memset(table + fd_table_size, 0, (size_t)(size - fd_table_size) * sizeof(*table));
+		fd_table = table;
+		fd_table_size = size;
+	}
+
+	if (fd_table[fd]) {
+		pthread_rwlock_unlock(&fd_table_lock);
+		return -EEXIST;
+	}
 
-	if (!hsearch_r(e, FIND, &ep, htab) || !ep)
-		return NULL;
+	/* gen 0 is never handed out, it marks an empty cache slot */
+	if (++fd_list_gen == 0)
+		++fd_list_gen;
+	fd_list->gen = fd_list_gen;
+	fd_table[fd] = fd_list;
+	fd_table_cnt++;
+	pthread_rwlock_unlock(&fd_table_lock);
 
-	return ep->data;
+	return 0;
 }
 
-static void __hash_table_delete(struct hsearch_data *htab, char *key)
+static struct fd_list_head *fd_table_remove(int fd)
 {
-	ENTRY e, *ep;
-	e.key = key;
-	e.data = NULL;
+	struct fd_list_head *fd_list = NULL;
 
-	if (hsearch_r(e, FIND, &ep, htab) && ep) {
-		free(ep->key);
-		ep->key = NULL;
+	pthread_rwlock_wrlock(&fd_table_lock);
+	if (fd >= 0 && fd < fd_table_size && fd_table[fd]) {
+		fd_list = fd_table[fd];
+		fd_table[fd] = NULL;
+		if (--fd_table_cnt == 0) {
+			free(fd_table);
+			fd_table = NULL;
+			fd_table_size = 0;
+		}
 	}
+	pthread_rwlock_unlock(&fd_table_lock);
 
-	return;
-}
-
-static void __hash_table_destroy(struct hsearch_data *htab)
-{
-	hdestroy_r(htab);
-	return;
+	return fd_list;
 }
 
 int create_fd_list(int fd)
 {
 	int ret;
-	char ht_key[20];
 	struct fd_list_head *fd_list = NULL;
 	struct fd_list_entry *fd_entry = NULL;
 
-	pthread_mutex_lock(&ht_mutex);
-	if (!hash_table_cnt) {
-		hash_table_cnt = 1;
-
-		ret = __hash_table_create(&htab_fd_list);
-		if (ret < 0) {
-			printf("failed to init fd list\n");
-			close(fd);
-			pthread_mutex_unlock(&ht_mutex);
-			return ret;
-		}
-	} else {
-		hash_table_cnt++;
-	}
-
-	pthread_mutex_unlock(&ht_mutex);
-
 	fd_entry = (struct fd_list_entry *)calloc(1, sizeof(struct fd_list_entry));
 	if (!fd_entry) {
 		printf("failed to allocate memory for fd_entry\n");
@@ -130,28 +144,72 @@ int create_fd_list(int fd)
 	}
 	SLIST_INIT(fd_list);
 	SLIST_INSERT_HEAD(fd_list, fd_entry, entries);
+	fd_list->refcnt = 1;
 
 	pthread_mutex_init(&fd_list->fd_list_mutex, NULL);
 
-	sprintf(ht_key, "%d", fd);
-	ret = __hash_table_insert(&htab_fd_list, ht_key, (void *)fd_list);
+	ret = fd_table_insert(fd, fd_list);
 	if (ret < 0) {
 		printf("failed to init fd list\n");
 		close(fd);
+		pthread_mutex_destroy(&fd_list->fd_list_mutex);
 		free(fd_entry);
 		free(fd_list);
 		return ret;
 	}
 
+	fd_cache_update(fd, fd_list->gen, fd);
+
 	return ret;
 }
 
+/* close every socket of the list, only once nobody holds a reference */
+static void free_fd_list(struct fd_list_head *fd_list)
+{
+	struct fd_list_entry *fd_entry;
+
+	while (!SLIST_EMPTY(fd_list)) {
+		fd_entry = SLIST_FIRST(fd_list);
+		close(fd_entry->fd);
+		SLIST_REMOVE_HEAD(fd_list, entries);
+		free(fd_entry);
+	}
+	pthread_mutex_destroy(&fd_list->fd_list_mutex);
+	gim_mux_conn_destroy(fd_list->mux);
+	free(fd_list);
+}
+
+/* returns the list with a reference held, drop it with put_fd_list() */
 struct fd_list_head *get_fd_list(int fd)
 {
-	char ht_key[20];
+	struct fd_list_head *fd_list = NULL;
+
+	pthread_rwlock_rdlock(&fd_table_lock);
+	if (fd >= 0 && fd < fd_table_size)
+		fd_list = fd_table[fd];
+	if (fd_list) {
+		pthread_mutex_lock(&fd_list->fd_list_mutex);
+		fd_list->refcnt++;
+		pthread_mutex_unlock(&fd_list->fd_list_mutex);
+	}
+	pthread_rwlock_unlock(&fd_table_lock);
+
+	return fd_list;
+}
+
+void put_fd_list(struct fd_list_head *fd_list)
+{
+	int refcnt;
+
+	if (!fd_list)
+		return;
 
-	sprintf(ht_key, "%d", fd);
-	return (struct fd_list_head *)__hash_table_search(&htab_fd_list, ht_key);
+	pthread_mutex_lock(&fd_list->fd_list_mutex);
+	refcnt = --fd_list->refcnt;
+	pthread_mutex_unlock(&fd_list->fd_list_mutex);
+
+	if (refcnt == 0)
+		free_fd_list(fd_list);
 }
 
 int search_fd_from_fd_list(int fd)
@@ -159,26 +217,37 @@ int search_fd_from_fd_list(int fd)
 	pthread_t tid;
 	struct fd_list_head *fd_list;
 	struct fd_list_entry *fd_entry;
-
-	tid = pthread_self();
+	struct fd_cache_entry *cache;
+	int primary_fd = fd;
 
 	fd_list = get_fd_list(fd);
+	if (!fd_list) {
+		printf("incorrect fd %d, ioctl open should be called first\n", fd);
+		return -EINVAL;
+	}
+
+	cache = &fd_cache[(unsigned int)fd % FD_CACHE_SLOTS];
+	if (cache->primary_fd == fd && cache->gen == fd_list->gen) {
+		put_fd_list(fd_list);
+		return cache->fd;
+	}
+
+	tid = pthread_self();
 	fd = 0;
 
-	if (fd_list) {
-		pthread_mutex_lock(&fd_list->fd_list_mutex);
-		SLIST_FOREACH(fd_entry, fd_list, entries)
-		{
-			if (fd_entry && fd_entry->tid == tid) {
-				fd = fd_entry->fd;
-				break;
-			}
+	pthread_mutex_lock(&fd_list->fd_list_mutex);
+	SLIST_FOREACH(fd_entry, fd_list, entries)
+	{
+		if (fd_entry && pthread_equal(fd_entry->tid, tid)) {
+			fd = fd_entry->fd;
+			break;
 		}
-		pthread_mutex_unlock(&fd_list->fd_list_mutex);
-	} else {
-		printf("incorrect fd %d, ioctl open should be called first\n", fd);
-		return -EINVAL;
 	}
+	pthread_mutex_unlock(&fd_list->fd_list_mutex);
+
+	if (fd > 0)
+		fd_cache_update(primary_fd, fd_list->gen, fd);
+	put_fd_list(fd_list);
 
 	return fd;
 }
@@ -198,12 +267,15 @@ int insert_fd_into_fd_list(int curr_fd, int fd)
 		if (fd_entry == NULL) {
 			printf("failed to allocate memory for fd entry during insert fd into fd list\n");
 			pthread_mutex_unlock(&fd_list->fd_list_mutex);
+			put_fd_list(fd_list);
 			return -ENOMEM;
 		}
 		fd_entry->fd = fd;
 		fd_entry->tid = tid;
 		SLIST_INSERT_HEAD(fd_list, fd_entry, entries);
 		pthread_mutex_unlock(&fd_list->fd_list_mutex);
+		fd_cache_update(curr_fd, fd_list->gen, fd);
+		put_fd_list(fd_list);
 	} else {
 		printf("incorrect fd %d, ioctl open should be called first\n", fd);
 		return -EINVAL;
@@ -216,34 +288,23 @@ int destroy_fd_list(int fd)
 {
 	struct fd_list_head *fd_list;
 	struct fd_list_entry *fd_entry;
-	char ht_key[20];
 
-	fd_list = get_fd_list(fd);
-	if (fd_list) {
-		pthread_mutex_lock(&fd_list->fd_list_mutex);
-		while (!SLIST_EMPTY(fd_list)) {
-			fd_entry = SLIST_FIRST(fd_list);
-			shutdown(fd_entry->fd, SHUT_RDWR);
-			close(fd_entry->fd);
-			SLIST_REMOVE_HEAD(fd_list, entries);
-			free(fd_entry);
-		}
-		pthread_mutex_unlock(&fd_list->fd_list_mutex);
-		pthread_mutex_destroy(&fd_list->fd_list_mutex);
-	} else {
+	fd_list = fd_table_remove(fd);
+	if (!fd_list) {
 		printf("incorrect fd %d, ioctl open should be called first\n", fd);
 		return -EINVAL;
 	}
-	free(fd_list);
 
-	sprintf(ht_key, "%d", fd);
-	__hash_table_delete(&htab_fd_list, ht_key);
+	/* wake up the ioctls still blocked on the sockets, the last
+	 * reference closes them
+	 */
+	pthread_mutex_lock(&fd_list->fd_list_mutex);
+	SLIST_FOREACH(fd_entry, fd_list, entries)
+		shutdown(fd_entry->fd, SHUT_RDWR);
+	pthread_mutex_unlock(&fd_list->fd_list_mutex);
 
-	pthread_mutex_lock(&ht_mutex);
-	hash_table_cnt--;
-	if (!hash_table_cnt)
-		__hash_table_destroy(&htab_fd_list);
-	pthread_mutex_unlock(&ht_mutex);
+	/* drop the reference of the table */
+	put_fd_list(fd_list);
 
 	return 0;
 }
@@ -36,6 +36,7 @@
 
 #include "gim_ioctl.h"
 #include "gim_fd_list.h"
+#include "gim_ioctl_mux.h"
 
 #include "dcore_ioctl.h"
 
@@ -111,6 +112,7 @@ static int create_connect_sock_fd(void)
 
 static int gim_user_mode_open(int type, int flags)
 {
+	struct fd_list_head *fd_list;
 	int fd;
 	int ret;
 
@@ -125,6 +127,13 @@ static int gim_user_mode_open(int type, int flags)
 	if (ret < 0)
 		return ret;
 
+	/* without it every thread falls back to a socket of its own */
+	fd_list = get_fd_list(fd);
+	if (fd_list) {
+		fd_list->mux = gim_mux_conn_create(fd);
+		put_fd_list(fd_list);
+	}
+
 	return fd;
 }
 
@@ -135,6 +144,7 @@ static int gim_user_mode_ioctl(int fd, void *cmd)
 	int curr_fd;
 	struct amdgv_cmd_ctx ctx;
 	struct cmd_header hdr = {0};
+	struct fd_list_head *fd_list;
 
 	if (cmd == NULL) {
 		printf("NULL arguments\n");
@@ -143,37 +153,52 @@ static int gim_user_mode_ioctl(int fd, void *cmd)
 
 	cmd_size = gim_ioctl_get_cmd_size(GIM_IOCTL_GET_TYPE(cmd));
 
+	/* the reference keeps the sockets and mux open until the reply is in,
+	 * even if another thread closes fd meanwhile
+	 */
+	fd_list = get_fd_list(fd);
+	if (fd_list && fd_list->mux) {
+		ret = gim_mux_ioctl(fd_list->mux, fd, cmd, cmd_size);
+		if (ret != GIM_MUX_UNSUPPORTED) {
+			if (ret < 0)
+				printf("failed to talk to server: %s\n",
+						USER_MODE_IPC_SERVER_PATH);
+			goto out;
+		}
+	}
+
+	/* server without request ids, one socket per thread */
 	curr_fd = fd;
 	fd = search_fd_from_fd_list(fd);
-	if (fd < 0)
-		return fd;
-	else if (fd == 0) {
+	if (fd < 0) {
+		ret = fd;
+		goto out;
+	} else if (fd == 0) {
 		fd = create_connect_sock_fd();
-		if (fd < 0)
-			return fd;
+		if (fd < 0) {
+			ret = fd;
+			goto out;
+		}
 
 		ret = (int)insert_fd_into_fd_list(curr_fd, fd);
 		if (ret < 0)
-			return (int)ret;
+			goto out;
 	}
 
-	/* send header */
+	/* send header and command */
 	hdr.cmd_id = (*(uint32_t *)cmd) | IOCTL_RECV_HDR_MASK;
 	hdr.pid = (uint32_t)getpid();
 	hdr.primary_fd = (uint32_t)curr_fd;
 	hdr.thread_fd = (uint32_t)fd;
-	ret = write(fd, &hdr, sizeof(struct cmd_header));
-
-	/* send command */
 	gim_ioctl_ctx_save(cmd, &ctx);
-	ret = write(fd, cmd, cmd_size);
+	ret = gim_ioctl_msghdr_send_cmd(fd, &hdr, cmd, cmd_size);
 
-	if (AMDGV_CMD_SHM_CLI2SER(cmd)) {
+	if (ret >= 0 && AMDGV_CMD_SHM_CLI2SER(cmd)) {
 		struct amdgv_cmd *s_cmd = (struct amdgv_cmd *)cmd;
 		ret = gim_ioctl_msghdr_send_shm_fd((struct amdgv_cmd_shm_info *)s_cmd->input_buff_raw, fd);
 	}
 
-	if (SMI_CMD_FD_CLI2SER(cmd)) {
+	if (ret >= 0 && SMI_CMD_FD_CLI2SER(cmd)) {
 		struct smi_ioctl_cmd *smi_cmd = (struct smi_ioctl_cmd *)cmd;
 		ret = gim_ioctl_msghdr_send_smi_fd(smi_cmd->payload, fd);
 	}
@@ -181,13 +206,13 @@ static int gim_user_mode_ioctl(int fd, void *cmd)
 	if (ret < 0) {
 		printf("failed to send data to server: %s\n",
 				USER_MODE_IPC_SERVER_PATH);
-		return (int)ret;
+		goto out;
 	}
 	/* receive response */
-	ret = read(fd, cmd, cmd_size);
+	ret = gim_ioctl_msghdr_recv_all(fd, cmd, cmd_size);
 	gim_ioctl_ctx_restore(cmd, &ctx);
 
-	if (AMDGV_CMD_SHM_SER2CLI(cmd)) {
+	if (ret >= 0 && AMDGV_CMD_SHM_SER2CLI(cmd)) {
 		struct amdgv_cmd *r_cmd = (struct amdgv_cmd *)cmd;
 		ret = gim_ioctl_msghdr_recv((struct amdgv_cmd_shm_info *)r_cmd->output_buff_raw, fd);
 	}
@@ -195,10 +220,14 @@ static int gim_user_mode_ioctl(int fd, void *cmd)
 	if (ret < 0) {
 		printf("failed to receive response from server: %s\n",
 				USER_MODE_IPC_SERVER_PATH);
-		return (int)ret;
+		goto out;
 	}
 
-	return 0;
+	ret = 0;
+out:
+	put_fd_list(fd_list);
+
+	return (int)ret;
 }
 
 static int gim_user_mode_access(int type)
@@ -218,6 +247,7 @@ static int gim_user_mode_access(int type)
 
 static int gim_user_mode_close(int fd)
 {
+	/* the mux goes with the last reference to the list */
 	return destroy_fd_list(fd);
 }
 
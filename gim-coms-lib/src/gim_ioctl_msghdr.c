@@ -32,6 +32,68 @@
 #include <sys/mman.h>
 #include "gim_ioctl_msghdr.h"
 
+/* Send the cmd header and the command in one sendmsg, retrying on short
+ * writes so the pair always lands contiguously on the stream.
+ */
+ssize_t gim_ioctl_msghdr_send_cmd(int fd, struct cmd_header *hdr, void *cmd, size_t cmd_size)
+{
+	struct msghdr msg = {0};
+	struct iovec io[2] = {
+		{ .iov_base = hdr, .iov_len = sizeof(*hdr) },
+		{ .iov_base = cmd, .iov_len = cmd_size },
+	};
+	size_t total = sizeof(*hdr) + cmd_size;
+	size_t sent = 0;
+	ssize_t ret;
+
+	msg.msg_iov = io;
+	msg.msg_iovlen = 2;
+
+	while (sent < total) {
+		ret = sendmsg(fd, &msg, MSG_NOSIGNAL);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		sent += (size_t)ret;
+
+		/* skip what went out already */
+		while (msg.msg_iovlen && (size_t)ret >= msg.msg_iov->iov_len) {
+			ret -= (ssize_t)msg.msg_iov->iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+		if (msg.msg_iovlen) {
+			msg.msg_iov->iov_base = (char *)msg.msg_iov->iov_base + ret;
+			msg.msg_iov->iov_len -= (size_t)ret;
+		}
+	}
+
+	return (ssize_t)sent;
+}
+
+/* Read exactly len bytes, a closed connection is reported as -EPIPE */
+ssize_t gim_ioctl_msghdr_recv_all(int fd, void *buf, size_t len)
+{
+	size_t done = 0;
+	ssize_t ret;
+
+	while (done < len) {
+		ret = read(fd, (char *)buf + done, len - done);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		if (ret == 0)
+			return -EPIPE;
+		done += (size_t)ret;
+	}
+
+	return (ssize_t)done;
+}
+
 ssize_t gim_ioctl_msghdr_send_fd(int fd, int fd2ser)
 {
 	ssize_t ret = 0;
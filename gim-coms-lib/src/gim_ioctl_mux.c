@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Multiplexed user mode connection.
+ *
+ * All threads of a client share the socket opened by gim_user_mode_open().
+ * Every request carries a req_id in its cmd_header, the server tags the
+ * reply with it, so replies may come back in any order. There is no
+ * receive thread: a caller waiting for its reply reads whatever reply is
+ * next on the socket (one reader at a time), hands it to its owner and
+ * keeps going until its own reply has arrived.
+ *
+ * Whether the server speaks this protocol is learned from the first reply,
+ * see CMD_HDR_FLAG_MUX. Until then only that first request is in flight.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include "gim_ioctl.h"
+#include "gim_ioctl_mux.h"
+#include "gim_ioctl_msghdr.h"
+
+#include "amdgv_cmd_def.h"
+#include "smi_cmd_def.h"
+
+enum gim_mux_state {
+	GIM_MUX_UNKNOWN,	/* nothing sent yet */
+	GIM_MUX_PROBING,	/* first request in flight, reply format unknown */
+	GIM_MUX_ON,
+	GIM_MUX_OFF,
+};
+
+struct gim_mux_waiter {
+	uint32_t req_id;
+	void *cmd;
+	size_t cmd_size;
+	struct amdgv_cmd_ctx ctx;
+	int ret;
+	bool done;
+	struct gim_mux_waiter *next;
+};
+
+struct gim_mux_conn {
+	int fd;
+	/* keeps header, command and passed fds of one request together */
+	pthread_mutex_t send_lock;
+	/* protects the fields below */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	enum gim_mux_state state;
+	uint32_t next_req_id;
+	bool reader_active;
+	int error;
+	struct gim_mux_waiter *waiters;
+};
+
+struct gim_mux_conn *gim_mux_conn_create(int fd)
+{
+	struct gim_mux_conn *conn;
+
+	conn = (struct gim_mux_conn *)calloc(1, sizeof(*conn));
+	if (!conn)
+		return NULL;
+
+	conn->fd = fd;
+	conn->state = GIM_MUX_UNKNOWN;
+	pthread_mutex_init(&conn->send_lock, NULL);
+	pthread_mutex_init(&conn->lock, NULL);
+	pthread_cond_init(&conn->cond, NULL);
+
+	return conn;
+}
+
+void gim_mux_conn_destroy(struct gim_mux_conn *conn)
+{
+	if (!conn)
+		return;
+
+	pthread_cond_destroy(&conn->cond);
+	pthread_mutex_destroy(&conn->lock);
+	pthread_mutex_destroy(&conn->send_lock);
+	free(conn);
+}
+
+static void gim_mux_unlink(struct gim_mux_conn *conn, struct gim_mux_waiter *waiter)
+{
+	struct gim_mux_waiter **pw;
+
+	for (pw = &conn->waiters; *pw; pw = &(*pw)->next) {
+		if (*pw == waiter) {
+			*pw = waiter->next;
+			break;
+		}
+	}
+}
+
+/* the stream is out of sync, nobody will get a reply anymore */
+static void gim_mux_fail(struct gim_mux_conn *conn, int error)
+{
+	struct gim_mux_waiter *waiter;
+
+	conn->error = error;
+	while (conn->waiters) {
+		waiter = conn->waiters;
+		conn->waiters = waiter->next;
+		waiter->ret = error;
+		waiter->done = true;
+	}
+	pthread_cond_broadcast(&conn->cond);
+}
+
+static int gim_mux_send(struct gim_mux_conn *conn, int primary_fd, struct gim_mux_waiter *waiter)
+{
+	struct cmd_header hdr = {0};
+	void *cmd = waiter->cmd;
+	ssize_t ret;
+
+	hdr.cmd_id = (*(uint32_t *)cmd) | IOCTL_RECV_HDR_MASK;
+	hdr.pid = (uint32_t)getpid();
+	hdr.primary_fd = (uint32_t)primary_fd;
+	hdr.thread_fd = (uint32_t)conn->fd;
+	hdr.req_id = waiter->req_id;
+	hdr.flags = CMD_HDR_FLAG_MUX;
+
+	pthread_mutex_lock(&conn->send_lock);
+	ret = gim_ioctl_msghdr_send_cmd(conn->fd, &hdr, cmd, waiter->cmd_size);
+
+	if (ret >= 0 && AMDGV_CMD_SHM_CLI2SER(cmd)) {
+		struct amdgv_cmd *s_cmd = (struct amdgv_cmd *)cmd;
+		ret = gim_ioctl_msghdr_send_shm_fd((struct amdgv_cmd_shm_info *)s_cmd->input_buff_raw,
+						   conn->fd);
+	}
+
+	if (ret >= 0 && SMI_CMD_FD_CLI2SER(cmd)) {
+		struct smi_ioctl_cmd *smi_cmd = (struct smi_ioctl_cmd *)cmd;
+		ret = gim_ioctl_msghdr_send_smi_fd(smi_cmd->payload, conn->fd);
+	}
+	pthread_mutex_unlock(&conn->send_lock);
+
+	if (ret < 0)
+		return ret < -1 ? (int)ret : -EIO;
+
+	return 0;
+}
+
+/* read the command of a reply into the waiter's buffer */
+static int gim_mux_recv_body(struct gim_mux_conn *conn, struct gim_mux_waiter *waiter)
+{
+	void *cmd = waiter->cmd;
+	ssize_t ret;
+
+	ret = gim_ioctl_msghdr_recv_all(conn->fd, cmd, waiter->cmd_size);
+	if (ret < 0)
+		return (int)ret;
+
+	gim_ioctl_ctx_restore(cmd, &waiter->ctx);
+
+	if (AMDGV_CMD_SHM_SER2CLI(cmd)) {
+		struct amdgv_cmd *r_cmd = (struct amdgv_cmd *)cmd;
+		if (gim_ioctl_msghdr_recv((struct amdgv_cmd_shm_info *)r_cmd->output_buff_raw,
+					  conn->fd) < 0)
+			return -EIO;
+	}
+
+	return 0;
+}
+
+/* read the next reply on the socket and complete its waiter */
+static int gim_mux_read_reply(struct gim_mux_conn *conn)
+{
+	struct gim_mux_waiter *waiter;
+	struct cmd_header hdr;
+	ssize_t ret;
+
+	ret = gim_ioctl_msghdr_recv_all(conn->fd, &hdr, sizeof(hdr));
+	if (ret < 0)
+		return (int)ret;
+
+	if (!(hdr.cmd_id & IOCTL_RECV_HDR_MASK) || !(hdr.flags & CMD_HDR_FLAG_MUX))
+		return -EPROTO;
+
+	pthread_mutex_lock(&conn->lock);
+	for (waiter = conn->waiters; waiter; waiter = waiter->next)
+		if (waiter->req_id == hdr.req_id)
+			break;
+	if (waiter)
+		gim_mux_unlink(conn, waiter);
+	pthread_mutex_unlock(&conn->lock);
+
+	if (!waiter)
+		return -EPROTO;
+
+	ret = gim_mux_recv_body(conn, waiter);
+
+	pthread_mutex_lock(&conn->lock);
+	waiter->ret = (int)ret;
+	waiter->done = true;
+	pthread_mutex_unlock(&conn->lock);
+
+	return (int)ret;
+}
+
+/* First reply on the connection. A multiplexing server echoes the cmd
+ * header, whose cmd_id has IOCTL_RECV_HDR_MASK set; a bare command never
+ * has. Returns 1 for a multiplexing server, 0 for a bare command. Nothing
+ * is consumed from the socket either way.
+ */
+static int gim_mux_probe_reply(struct gim_mux_conn *conn)
+{
+	uint32_t cmd_id;
+	ssize_t ret;
+
+	do {
+		ret = recv(conn->fd, &cmd_id, sizeof(cmd_id), MSG_PEEK | MSG_WAITALL);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0)
+		return -errno;
+	if (ret != sizeof(cmd_id))
+		return -EPIPE;
+
+	return (cmd_id & IOCTL_RECV_HDR_MASK) ? 1 : 0;
+}
+
+int gim_mux_ioctl(struct gim_mux_conn *conn, int primary_fd, void *cmd, size_t cmd_size)
+{
+	struct gim_mux_waiter waiter = {0};
+	bool probe = false;
+	bool desync = false;
+	int mux = 1;
+	int ret;
+
+	pthread_mutex_lock(&conn->lock);
+	while (conn->state == GIM_MUX_PROBING)
+		pthread_cond_wait(&conn->cond, &conn->lock);
+
+	if (conn->state == GIM_MUX_OFF) {
+		pthread_mutex_unlock(&conn->lock);
+		return GIM_MUX_UNSUPPORTED;
+	}
+
+	if (conn->error) {
+		ret = conn->error;
+		pthread_mutex_unlock(&conn->lock);
+		return ret;
+	}
+
+	if (conn->state == GIM_MUX_UNKNOWN) {
+		conn->state = GIM_MUX_PROBING;
+		probe = true;
+	}
+
+	waiter.req_id = conn->next_req_id++;
+	waiter.cmd = cmd;
+	waiter.cmd_size = cmd_size;
+	gim_ioctl_ctx_save(cmd, &waiter.ctx);
+	waiter.next = conn->waiters;
+	conn->waiters = &waiter;
+	pthread_mutex_unlock(&conn->lock);
+
+	ret = gim_mux_send(conn, primary_fd, &waiter);
+	if (ret == 0 && probe) {
+		mux = gim_mux_probe_reply(conn);
+		if (mux == 0) {
+			ret = gim_mux_recv_body(conn, &waiter);
+			desync = ret < 0;
+		} else if (mux < 0) {
+			ret = mux;
+		}
+	}
+
+	pthread_mutex_lock(&conn->lock);
+	if (probe) {
+		if (ret == 0)
+			conn->state = mux ? GIM_MUX_ON : GIM_MUX_OFF;
+		else
+			conn->state = GIM_MUX_UNKNOWN;
+		pthread_cond_broadcast(&conn->cond);
+	}
+
+	if (ret < 0 || !mux) {
+		gim_mux_unlink(conn, &waiter);
+		/* a partial bare reply leaves the stream unusable, any other
+		 * failure happened before a byte of the reply was read and
+		 * only fails this request
+		 */
+		if (desync)
+			gim_mux_fail(conn, ret);
+		pthread_mutex_unlock(&conn->lock);
+		return ret;
+	}
+
+	/* wait for the reply, reading the socket whenever nobody else does */
+	while (!waiter.done) {
+		if (conn->reader_active) {
+			pthread_cond_wait(&conn->cond, &conn->lock);
+			continue;
+		}
+
+		conn->reader_active = true;
+		pthread_mutex_unlock(&conn->lock);
+
+		ret = gim_mux_read_reply(conn);
+
+		pthread_mutex_lock(&conn->lock);
+		conn->reader_active = false;
+		if (ret < 0)
+			gim_mux_fail(conn, ret);
+		else
+			pthread_cond_broadcast(&conn->cond);
+	}
+	ret = waiter.ret;
+	pthread_mutex_unlock(&conn->lock);
+
+	return ret;
+}
@@ -0,0 +1,82 @@
+#
+# Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+# Unit tests of the library, talking to a fake server over a socketpair.
+# Build with "make -f tests/gim_coms_tests.mk", run with its "run" target.
+
+include $(dir $(lastword $(MAKEFILE_LIST)))../defines.mk
+
+GIM_COMS_TEST_DIR := $(GIM_COMS_ROOT)/tests
+
+OUTPUT_DIR := $(GIM_COMS_BUILD_DIR)/test
+
+LIB_SRCS := gim_ioctl_mux.c
+LIB_SRCS += gim_ioctl_msghdr.c
+
+TEST_SRCS := gim_test_ioctl_mux.cpp
+
+OBJSC   := $(addprefix $(OUTPUT_DIR)/,$(LIB_SRCS:.c=.c.o))
+OBJSCPP := $(addprefix $(OUTPUT_DIR)/,$(TEST_SRCS:.cpp=.cpp.o))
+
+DEPS := $(OBJSC:.o=.d) $(OBJSCPP:.o=.d)
+
+TARGET := gim_coms_tests
+
+INCLUDE := $(addprefix -I,$(GIM_COMS_INCLUDE_DIR))
+
+CFLAGS   = $(DEFAULT_CFLAGS) $(INCLUDE) -g
+# amdgv_cmd_def.h pastes string literals without a space, fine in C only
+CXXFLAGS = -std=c++17 $(DEFAULT_CXXFLAGS) -Wno-literal-suffix $(INCLUDE) -g
+
+LDFLAGS = -lgtest -lgtest_main -pthread
+
+ifeq ($(ADDRESS_SANITIZER), True)
+CFLAGS  += -fsanitize=address,undefined
+CXXFLAGS  += -fsanitize=address,undefined
+LDFLAGS += -fsanitize=address,undefined
+endif
+
+vpath %.c $(GIM_COMS_SOURCE_DIR)
+vpath %.cpp $(GIM_COMS_TEST_DIR)
+
+default: $(OUTPUT_DIR)/$(TARGET)
+
+.PHONY: clean
+clean:
+	$(RM) $(OBJSC) $(OBJSCPP) $(OUTPUT_DIR)/$(TARGET) $(DEPS)
+
+.PHONY: run
+run: $(OUTPUT_DIR)/$(TARGET)
+	$(OUTPUT_DIR)/$(TARGET)
+
+-include $(DEPS)
+
+$(OUTPUT_DIR)/%.c.o: %.c | $(OUTPUT_DIR)
+	$(CC) $(CFLAGS) -MMD -MP -c $< -o $@
+
+$(OUTPUT_DIR)/%.cpp.o: %.cpp | $(OUTPUT_DIR)
+	$(CXX) $(CXXFLAGS) -MMD -MP -c $< -o $@
+
+$(OUTPUT_DIR)/$(TARGET): $(OBJSC) $(OBJSCPP) | $(OUTPUT_DIR)
+	$(CXX) -o $@ $^ $(LDFLAGS)
+
+$(OUTPUT_DIR):
+	mkdir -p $(OUTPUT_DIR)
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "amdgv_cmd_def.h"
+#include "gim_ioctl.h"
+#include "gim_ioctl_msghdr.h"
+#include "gim_ioctl_mux.h"
+}
+
+using namespace ::testing;
+
+/* smallest command the connection will carry: no shm, no passed fds */
+struct test_cmd {
+	uint32_t cmd_id;
+	uint32_t value;
+};
+
+struct test_request {
+	struct cmd_header hdr;
+	struct test_cmd cmd;
+};
+
+static uint32_t test_reply_value(uint32_t value)
+{
+	return value * 10 + 1;
+}
+
+class GimIoctlMuxTests : public Test {
+protected:
+	void SetUp() override
+	{
+		ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+		conn = gim_mux_conn_create(fds[0]);
+		ASSERT_NE(conn, nullptr);
+	}
+
+	void TearDown() override
+	{
+		if (server.joinable())
+			server.join();
+		gim_mux_conn_destroy(conn);
+		close(fds[0]);
+		close(fds[1]);
+	}
+
+	int Call(uint32_t value, struct test_cmd *cmd)
+	{
+		cmd->cmd_id = AMDGV_CMD_PSP_VBFLASH_PROCESS;
+		cmd->value = value;
+		return gim_mux_ioctl(conn, -1, cmd, sizeof(*cmd));
+	}
+
+	/* server side, every request carries a cmd_header */
+	bool RecvRequest(struct test_request *req)
+	{
+		return gim_ioctl_msghdr_recv_all(fds[1], req, sizeof(*req)) ==
+		       (ssize_t)sizeof(*req);
+	}
+
+	/* reply of a multiplexing server: the header echoed, then the command */
+	void SendMuxReply(const struct test_request &req, uint32_t req_id)
+	{
+		struct test_request reply = req;
+
+		reply.hdr.req_id = req_id;
+		reply.cmd.value = test_reply_value(req.cmd.value);
+		ASSERT_EQ(write(fds[1], &reply, sizeof(reply)), (ssize_t)sizeof(reply));
+	}
+
+	/* reply of a server that does not know the header: the command alone */
+	void SendBareReply(const struct test_request &req, size_t len)
+	{
+		struct test_cmd reply = req.cmd;
+
+		reply.value = test_reply_value(req.cmd.value);
+		ASSERT_EQ(write(fds[1], &reply, len), (ssize_t)len);
+	}
+
+	/* nothing may reach the server once the connection gave up */
+	void ExpectNoRequest()
+	{
+		struct test_request req;
+
+		EXPECT_EQ(recv(fds[1], &req, sizeof(req), MSG_DONTWAIT), -1);
+		EXPECT_EQ(errno, EAGAIN);
+	}
+
+	int fds[2] = {-1, -1};
+	struct gim_mux_conn *conn = nullptr;
+	std::thread server;
+};
+
+TEST_F(GimIoctlMuxTests, echo_server_out_of_order)
+{
+	const uint32_t nr_clients = 4;
+	std::vector<std::thread> clients;
+	struct test_cmd cmd;
+
+	server = std::thread([this] {
+		struct test_request probe;
+		std::vector<struct test_request> reqs(nr_clients);
+
+		ASSERT_TRUE(RecvRequest(&probe));
+		EXPECT_TRUE(probe.hdr.cmd_id & IOCTL_RECV_HDR_MASK);
+		EXPECT_TRUE(probe.hdr.flags & CMD_HDR_FLAG_MUX);
+		EXPECT_EQ(probe.cmd.cmd_id, (uint32_t)AMDGV_CMD_PSP_VBFLASH_PROCESS);
+		SendMuxReply(probe, probe.hdr.req_id);
+
+		/* hold every reply until all clients are waiting, answer the
+		 * last request first
+		 */
+		for (auto &req : reqs)
+			ASSERT_TRUE(RecvRequest(&req));
+		for (auto it = reqs.rbegin(); it != reqs.rend(); ++it)
+			SendMuxReply(*it, it->hdr.req_id);
+	});
+
+	ASSERT_EQ(Call(7, &cmd), 0);
+	EXPECT_EQ(cmd.value, test_reply_value(7));
+
+	for (uint32_t i = 0; i < nr_clients; i++) {
+		clients.emplace_back([this, i] {
+			struct test_cmd c;
+
+			EXPECT_EQ(Call(100 + i, &c), 0);
+			EXPECT_EQ(c.cmd_id, (uint32_t)AMDGV_CMD_PSP_VBFLASH_PROCESS);
+			EXPECT_EQ(c.value, test_reply_value(100 + i));
+		});
+	}
+	for (auto &client : clients)
+		client.join();
+}
+
+TEST_F(GimIoctlMuxTests, bare_reply_server)
+{
+	struct test_cmd cmd;
+
+	server = std::thread([this] {
+		struct test_request req;
+
+		ASSERT_TRUE(RecvRequest(&req));
+		SendBareReply(req, sizeof(req.cmd));
+	});
+
+	/* the first request is still answered, the reply peeked at decides */
+	ASSERT_EQ(Call(7, &cmd), 0);
+	EXPECT_EQ(cmd.cmd_id, (uint32_t)AMDGV_CMD_PSP_VBFLASH_PROCESS);
+	EXPECT_EQ(cmd.value, test_reply_value(7));
+	server.join();
+
+	EXPECT_EQ(Call(8, &cmd), GIM_MUX_UNSUPPORTED);
+	ExpectNoRequest();
+}
+
+TEST_F(GimIoctlMuxTests, bare_reply_desync_poisons_connection)
+{
+	struct test_cmd cmd;
+
+	server = std::thread([this] {
+		struct test_request req;
+
+		ASSERT_TRUE(RecvRequest(&req));
+		SendBareReply(req, sizeof(req.cmd) - 2);
+		shutdown(fds[1], SHUT_WR);
+	});
+
+	EXPECT_EQ(Call(7, &cmd), -EPIPE);
+	server.join();
+
+	/* part of a reply was consumed, the stream cannot be trusted again */
+	EXPECT_EQ(Call(8, &cmd), -EPIPE);
+	ExpectNoRequest();
+}
+
+TEST_F(GimIoctlMuxTests, unknown_req_id_poisons_connection)
+{
+	struct test_cmd cmd;
+
+	server = std::thread([this] {
+		struct test_request req;
+
+		ASSERT_TRUE(RecvRequest(&req));
+		SendMuxReply(req, req.hdr.req_id);
+		ASSERT_TRUE(RecvRequest(&req));
+		SendMuxReply(req, req.hdr.req_id + 1000);
+	});
+
+	ASSERT_EQ(Call(7, &cmd), 0);
+	EXPECT_EQ(Call(8, &cmd), -EPROTO);
+	server.join();
+
+	EXPECT_EQ(Call(9, &cmd), -EPROTO);
+	ExpectNoRequest();
+}
+
+TEST_F(GimIoctlMuxTests, probe_failure_does_not_poison_connection)
+{
+	struct test_cmd cmd;
+
+	/* the server closes before replying: no reply byte was read, so
+	 * the next request may probe again
+	 */
+	server = std::thread([this] {
+		struct test_request req;
+
+		ASSERT_TRUE(RecvRequest(&req));
+		shutdown(fds[1], SHUT_WR);
+	});
+
+	EXPECT_EQ(Call(7, &cmd), -EPIPE);
+	server.join();
+
+	EXPECT_EQ(Call(8, &cmd), -EPIPE);
+	struct test_request req;
+	EXPECT_TRUE(RecvRequest(&req));
+	EXPECT_EQ(req.cmd.value, 8u);
+}
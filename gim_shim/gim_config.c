@@ -283,12 +283,13 @@ uint sch_policy[AMDGV_MAX_GPU_NUM] = {0};
 module_param_array(sch_policy, uint, &sch_policy_size, 0444);
 MODULE_PARM_DESC(sch_policy, "specify scheduler for GPUs\n\t"
 			"sch_policy=[S0[,S1[...[,Sx]]]]\n\t"
-			"1 <= Sx <= 5, 0 <= x <= 31\n\t"
+			"1 <= Sx <= 6, 0 <= x <= 31\n\t"
 			"1: HW solid mode\n\t"
 			"2: HW liquid mode\n\t"
 			"3: SW fairness scheduling mode\n\t"
 			"4: SW round robin mode\n\t"
-			"5: Hybrid liquid mode\n\t");
+			"5: Hybrid liquid mode\n\t"
+			"6: SW virtual time (weighted fair) mode\n\t");
 
 int log_level_size;
 uint log_level[AMDGV_MAX_GPU_NUM] = {0};
@@ -334,6 +335,43 @@ uint gpu_data_size;
 module_param(gpu_data_size, uint, 0444);
 MODULE_PARM_DESC(gpu_data_size, "Size of transferring gpu data memory\n\t"
 		"gpu_data_size=0xxxxxxxxx\n\t");
+
+uint live_update_format;
+module_param(live_update_format, uint, 0444);
+MODULE_PARM_DESC(live_update_format, "Format of the exported live update file\n\t"
+		"live_update_format=D\n\t"
+		"0: raw gpu data image, readable by every driver (default)\n\t"
+		"1: sectioned file, only readable by drivers that know it\n\t");
+
+uint live_update_compress = 1;
+module_param(live_update_compress, uint, 0444);
+MODULE_PARM_DESC(live_update_compress, "Compress sections of the sectioned live update file\n\t"
+		"live_update_compress=D\n\t"
+		"0: store sections uncompressed\n\t"
+		"1: zero run-length encode sections (default)\n\t");
+
+uint live_update_parallel = 1;
+module_param(live_update_parallel, uint, 0444);
+MODULE_PARM_DESC(live_update_parallel, "Export and import live update data in parallel\n\t"
+		"live_update_parallel=D\n\t"
+		"0: one GPU and one live info op at a time\n\t"
+		"1: XGMI hives, standalone GPUs and independent live info ops in parallel (default)\n\t");
+
+uint init_parallel;
+module_param(init_parallel, uint, 0444);
+MODULE_PARM_DESC(init_parallel, "Run device init stages in parallel\n\t"
+		"init_parallel=D\n\t"
+		"0: one init stage at a time in table order (default)\n\t"
+		"1: stages whose declared dependencies are done in parallel,\n\t"
+		"   no asic init table declares any yet\n\t");
+
+uint wait_adaptive = 1;
+module_param(wait_adaptive, uint, 0444);
+MODULE_PARM_DESC(wait_adaptive, "Adapt hardware waits to the completion time learned per wait site\n\t"
+		"wait_adaptive=D\n\t"
+		"0: fixed delay then sleep backoff\n\t"
+		"1: hold for the learned time, then poll finely (default)\n\t");
+
 char *gim_enabled_devices;
  MODULE_PARM_DESC(enabled_devices, "Enabled device strings (will be set like aaaa:xx:yy.z;bbbb:xx:yy.z)");
  module_param_named(enabled_devices, gim_enabled_devices, charp, 0444);
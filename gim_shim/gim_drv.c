@@ -58,6 +58,16 @@ struct gim_init_thread_context {
 };
 
 static struct gim_init_thread_context gim_init_thread[AMDGV_MAX_GPU_NUM];
+
+/* one fini thread per XGMI hive, or per GPU outside of a hive */
+struct gim_fini_thread_context {
+	uint64_t hive_id;
+	uint32_t num_dev;
+	struct gim_dev_data *dev_data[AMDGV_MAX_GPU_NUM];
+	void *fini_thread;
+};
+
+static struct gim_fini_thread_context gim_fini_thread[AMDGV_MAX_GPU_NUM];
 uint32_t shim_log_level = AMDGV_INFO_LEVEL;
 static amdgv_dev_t adapt_list[AMDGV_MAX_GPU_NUM] = {0};
 LIST_HEAD(gim_device_list);
@@ -68,12 +78,19 @@ struct mutex gim_xgmi_gpumon_hive_lock;
 struct gim_error_ring_buffer *gim_error_rb;
 
 static atomic64_t gim_gpu_initing_num;
+static atomic64_t gim_gpu_finiing_num;
+static struct completion gim_gpu_fini_event;
 
 struct completion gim_gpu_init_event;
 static uint32_t gim_gpu_id;
 extern uint gpu_data_addr_hi;
 extern uint gpu_data_addr_lo;
 extern uint gpu_data_size;
+extern uint live_update_format;
+extern uint live_update_compress;
+extern uint live_update_parallel;
+extern uint init_parallel;
+extern uint wait_adaptive;
 extern struct gim_live_update_manager update_mgr;
 static const char gim_driver_name[] = "gim";
 const char gim_driver_version[] = PACKAGE_VERSION;
@@ -337,6 +354,9 @@ static int gim_init_thread_func(void *context)
 	data->opt.debug_dump_reserve_size =
 		gim_conf_get_debug_dump_reserve_size_opt(dev_data->gpu_index);
 	data->opt.deferred_full_live_update = gim_conf_get_deferred_full_live_update_opt(dev_data->gpu_index);
+	data->opt.parallel_live_update = !!live_update_parallel;
+	data->opt.parallel_init = !!init_parallel;
+	data->opt.adaptive_wait = !!wait_adaptive;
 	data->opt.bp_debug_mode = gim_conf_get_bp_mode_opt(dev_data->gpu_index);
 
 	data->opt.fb_sharing_mode =
@@ -504,6 +524,115 @@ err_out:
 	return 0;
 }
 
+/* tear down the adapter and export its live update data */
+static void gim_fini_device(struct gim_dev_data *dev_data)
+{
+	struct pci_dev *pdev = dev_data->pdev;
+	struct amdgv_init_data *data = &dev_data->init_data;
+
+	gim_mon_remove_dev_sys(dev_data);
+	gim_guard_remove_dev_sys(pdev);
+	mutex_lock(&gim_device_list_lock);
+	list_del(&dev_data->list);
+	adapt_list[dev_data->gpu_index] = NULL;
+	mutex_unlock(&gim_device_list_lock);
+
+	amdgv_device_fini_ex(dev_data->adev, &data->fini_opt);
+	gim_live_update_export_data(&update_mgr, pdev, &gim_gpu_id);
+
+	dev_data->adev = AMDGV_INVALID_HANDLE;
+}
+
+static int gim_fini_thread_func(void *context)
+{
+	struct gim_fini_thread_context *fini_context = context;
+	uint32_t i;
+
+	/*
+	 * Members of one hive share the hive locks and barriers, and the last
+	 * one out tears the hive down, so they go one after another.
+	 */
+	for (i = 0; i < fini_context->num_dev; i++)
+		gim_fini_device(fini_context->dev_data[i]);
+
+	if (atomic64_dec_and_test(&gim_gpu_finiing_num))
+		complete(&gim_gpu_fini_event);
+
+	return 0;
+}
+
+static uint64_t gim_get_hive_id(struct gim_dev_data *dev_data)
+{
+	union amdgv_dev_info dev_info;
+
+	memset(&dev_info, 0, sizeof(dev_info));
+	if (amdgv_get_dev_info(dev_data->adev, AMDGV_GET_XGMI_INFO, &dev_info))
+		return 0;
+
+	return dev_info.xgmi_info.hive_id;
+}
+
+/*
+ * For a live update the adapters only export their state, so tear them
+ * down at once instead of one by one from gim_remove. GPUs run in
+ * parallel across hives and serially within a hive.
+ */
+static void gim_fini_devices_parallel(void)
+{
+	struct gim_fini_thread_context *fini_context;
+	struct gim_dev_data *dev_data;
+	uint64_t hive_id;
+	uint32_t i, num = 0, num_dev = 0;
+	ktime_t start = ktime_get();
+
+	mutex_lock(&gim_device_list_lock);
+	list_for_each_entry(dev_data, &gim_device_list, list) {
+		if (dev_data->adev == AMDGV_INVALID_HANDLE)
+			continue;
+
+		hive_id = gim_get_hive_id(dev_data);
+		fini_context = NULL;
+		for (i = 0; hive_id && i < num; i++) {
+			if (gim_fini_thread[i].hive_id == hive_id) {
+				fini_context = &gim_fini_thread[i];
+				break;
+			}
+		}
+		if (!fini_context) {
+			if (num >= AMDGV_MAX_GPU_NUM)
+				break;
+			fini_context = &gim_fini_thread[num++];
+			fini_context->hive_id = hive_id;
+			fini_context->num_dev = 0;
+		}
+		if (fini_context->num_dev >= AMDGV_MAX_GPU_NUM)
+			break;
+		fini_context->dev_data[fini_context->num_dev++] = dev_data;
+		num_dev++;
+	}
+	mutex_unlock(&gim_device_list_lock);
+
+	if (!num)
+		return;
+
+	init_completion(&gim_gpu_fini_event);
+	atomic64_set(&gim_gpu_finiing_num, num);
+
+	for (i = 0; i < num; i++) {
+		gim_fini_thread[i].fini_thread = kthread_run(gim_fini_thread_func,
+				(void *)&gim_fini_thread[i], "gpu_fini_thread");
+		if (IS_ERR(gim_fini_thread[i].fini_thread)) {
+			gim_warn("failed to create gpu fini thread!\n");
+			gim_fini_thread_func(&gim_fini_thread[i]);
+		}
+	}
+
+	wait_for_completion(&gim_gpu_fini_event);
+
+	gim_info("live update export of %u GPUs in %u groups took %lldus\n",
+		 num_dev, num, ktime_us_delta(ktime_get(), start));
+}
+
 static void gim_remove(struct pci_dev *pdev)
 {
 	struct gim_dev_data *dev_data;
@@ -516,17 +645,8 @@ static void gim_remove(struct pci_dev *pdev)
 
 	data = &dev_data->init_data;
 
-	if (dev_data->adev != AMDGV_INVALID_HANDLE) {
-		gim_mon_remove_dev_sys(dev_data);
-		gim_guard_remove_dev_sys(pdev);
-		mutex_lock(&gim_device_list_lock);
-		list_del(&dev_data->list);
-		adapt_list[dev_data->gpu_index] = NULL;
-		mutex_unlock(&gim_device_list_lock);
-
-		amdgv_device_fini_ex(dev_data->adev, &data->fini_opt);
-		gim_live_update_export_data(&update_mgr, pdev, &gim_gpu_id);
-	}
+	if (dev_data->adev != AMDGV_INVALID_HANDLE)
+		gim_fini_device(dev_data);
 
 	if (!data->fini_opt.skip_hw_fini)
 		pci_disable_device(pdev);
@@ -689,6 +809,8 @@ static int gim_init(void)
 
 	memset(&update_mgr, 0, sizeof(update_mgr));
 	update_mgr.update_type = GIM_LIVE_UPDATE_FILE;
+	update_mgr.sectioned = !!live_update_format;
+	update_mgr.compress = !!live_update_compress;
 	if (gpu_data_size) {
 		update_mgr.update_type = GIM_LIVE_UPDATE_MEM;
 		update_mgr.gpu_data_addr_lo = gpu_data_addr_lo;
@@ -825,6 +947,9 @@ static void gim_exit(void)
 
 	gim_ftrace_fini();
 
+	if (update_mgr.is_export && live_update_parallel)
+		gim_fini_devices_parallel();
+
 	pci_unregister_driver(&gim_driver);
 
 	amdgv_fini();
@@ -27,6 +27,7 @@
 #include <linux/pci.h>
 #include <linux/stat.h>
 #include <linux/vmalloc.h>
+#include <linux/crc32.h>
 #if defined(HAVE_ASM_SET_MEMORY_H)
 #include <asm/set_memory.h>
 #else
@@ -34,13 +35,13 @@
 #endif
 
 #include "gim_live_update.h"
+#include "gim_live_update_zrle.h"
 #include "gim_debug.h"
 
 struct gim_live_update_manager update_mgr;
 
 #define GIM_LIVE_UPDATE_DATA_PATH "/var/log/gim_live_update_data"
-#define GIM_LIVE_UPDATE_DEFAULT_MAX_GPU 8
-#define GIM_LIVE_UPDATE_DEFAULT_SIZE (sizeof(struct amdgv_live_update_file_header) + GIM_LIVE_UPDATE_DEFAULT_MAX_GPU * AMDGV_GPU_DATA_V2_SIZE)
+#define GIM_LIVE_UPDATE_DEFAULT_SIZE (sizeof(struct amdgv_live_update_file_header) + GIM_LIVE_UPDATE_MAX_GPU * AMDGV_GPU_DATA_V2_SIZE)
 
 struct amdgv_live_update_file_header *gim_live_update_get_file_header_ptr(struct gim_live_update_manager *mgr)
 {
@@ -108,6 +109,14 @@ static bool gim_live_update_validate_crc(struct gim_live_update_manager *mgr)
 	if (mgr->gpu_num == 0)
 		return false;
 
+	/*
+	 * sectioned file: only the header sections have been decoded and checked
+	 * against their crc so far, gim_live_update_load_gpu() checks the rest
+	 * before the matching GPU reads them
+	 */
+	if (mgr->file_ptr)
+		return true;
+
 	for (i = 0; i < mgr->gpu_num; i++) {
 		gpu_data = gim_live_update_get_data_ptr(mgr, i);
 		gim_calc_hash_ext("crc32", &hash, (void *)&gpu_data->header.size, gpu_data->header.size);
@@ -124,15 +133,284 @@ static bool gim_live_update_data_size_check(struct gim_live_update_manager *mgr,
 		(current_index + 1) * AMDGV_GPU_DATA_V2_SIZE);
 }
 
-static uint32_t gim_live_update_flush_file(struct gim_live_update_manager *mgr)
+static uint32_t gim_live_update_section_crc(const uint8_t *data, uint32_t size)
+{
+	return crc32_le(~0U, data, size) ^ ~0U;
+}
+
+/* end of the hashed part of amdgv_gpu_data_v2, anything after it is not live data */
+static uint32_t gim_live_update_data_end(struct amdgv_gpu_data_v2 *gpu_data)
+{
+	uint64_t end = offsetof(struct amdgv_gpu_data_v2, header.size) + (uint64_t)gpu_data->header.size;
+
+	if (end < sizeof(struct amdgv_gpu_data_header_v2) || end > AMDGV_GPU_DATA_V2_SIZE)
+		return AMDGV_GPU_DATA_V2_SIZE;
+
+	return (uint32_t)end;
+}
+
+/*
+ * Split the hashed range into the data header and one section per op.
+ * Ops without a live data struct share their offset with the next op, the
+ * later op names the section. The ranges are contiguous, so the sections
+ * cover exactly what header.hash covers.
+ */
+static uint32_t gim_live_update_get_sections(struct amdgv_gpu_data_v2 *gpu_data,
+					     struct gim_live_update_section *sect)
+{
+	uint32_t end = gim_live_update_data_end(gpu_data);
+	uint32_t op, offset, num = 0;
+	uint32_t prev = sizeof(struct amdgv_gpu_data_header_v2);
+
+	sect[num].op = GIM_LIVE_UPDATE_SECTION_HEADER;
+	sect[num].offset = 0;
+	num++;
+
+	for (op = AMDGV_LIVE_INFO_DATA__CRITICAL_STATE;
+	     op < min_t(uint32_t, gpu_data->header.op_num, AMDGV_LIVE_INFO_DATA__END); op++) {
+		offset = gpu_data->header.op_offset[op];
+		if (offset < prev || offset >= end)
+			break;
+
+		if (offset == prev && num > 1) {
+			sect[num - 1].op = op;
+			continue;
+		}
+
+		sect[num].op = op;
+		sect[num].offset = offset;
+		num++;
+		prev = offset;
+	}
+
+	/* no op table, keep the whole range in the header section */
+	if (num == 1)
+		sect[0].size = end;
+	else
+		sect[0].size = sect[1].offset;
+
+	for (op = 1; op < num; op++)
+		sect[op].size = ((op + 1 < num) ? sect[op + 1].offset : end) - sect[op].offset;
+
+	return num;
+}
+
+/* returns the encoded size of one GPU, 0 if it does not fit in out_size */
+static uint32_t gim_live_update_encode_gpu(struct gim_live_update_manager *mgr,
+					   struct amdgv_gpu_data_v2 *gpu_data,
+					   uint8_t *out, uint32_t out_size)
+{
+	struct gim_live_update_section sect[GIM_LIVE_UPDATE_SECTION_MAX];
+	struct gim_live_update_snapshot_gpu *gpu;
+	struct gim_live_update_section *table;
+	const uint8_t *data = (const uint8_t *)gpu_data;
+	uint32_t i, num, kept = 0;
+	uint32_t pos, stored;
+
+	memset(sect, 0, sizeof(sect));
+	num = gim_live_update_get_sections(gpu_data, sect);
+
+	/* strip trailing zeros, drop sections that hold nothing but defaults */
+	for (i = 0; i < num; i++) {
+		sect[i].data_size = sect[i].size;
+		while (sect[i].data_size && data[sect[i].offset + sect[i].data_size - 1] == 0)
+			sect[i].data_size--;
+
+		if (sect[i].data_size == 0 && sect[i].op != GIM_LIVE_UPDATE_SECTION_HEADER)
+			continue;
+
+		sect[i].crc = gim_live_update_section_crc(data + sect[i].offset, sect[i].size);
+		sect[kept++] = sect[i];
+	}
+
+	pos = sizeof(*gpu) + kept * sizeof(*table);
+	if (out_size < pos)
+		return 0;
+
+	gpu = (struct gim_live_update_snapshot_gpu *)out;
+	table = (struct gim_live_update_section *)(out + sizeof(*gpu));
+
+	for (i = 0; i < kept; i++) {
+		stored = 0;
+		if (mgr->compress && sect[i].data_size > 1)
+			stored = gim_live_update_zrle_encode(data + sect[i].offset, sect[i].data_size,
+							     out + pos,
+							     min(out_size - pos, sect[i].data_size - 1));
+		if (stored) {
+			sect[i].flags |= GIM_LIVE_UPDATE_SECTION_FLAG_ZRLE;
+		} else {
+			if (out_size - pos < sect[i].data_size)
+				return 0;
+			memcpy(out + pos, data + sect[i].offset, sect[i].data_size);
+			stored = sect[i].data_size;
+		}
+
+		sect[i].stored_size = stored;
+		table[i] = sect[i];
+		pos += stored;
+	}
+
+	/* keep the next GPU record aligned */
+	if (out_size - pos < ALIGN(pos, 8) - pos)
+		return 0;
+	memset(out + pos, 0, ALIGN(pos, 8) - pos);
+	pos = ALIGN(pos, 8);
+
+	gpu->section_num = kept;
+	gpu->payload_size = pos - sizeof(*gpu) - kept * sizeof(*table);
+
+	return pos;
+}
+
+/* decode the sections of one GPU into its amdgv_gpu_data_v2 slot */
+static bool gim_live_update_load_sections(struct gim_live_update_manager *mgr,
+					  uint32_t gpu_index, bool header_only)
 {
+	struct gim_live_update_snapshot_gpu *gpu;
+	struct gim_live_update_section *sect;
+	const uint8_t *payload;
+	uint8_t *data;
+	uint32_t i, cur, pos = 0;
+
+	gpu = (struct gim_live_update_snapshot_gpu *)(mgr->file_ptr + mgr->snap_offset[gpu_index]);
+	sect = (struct gim_live_update_section *)(gpu + 1);
+	payload = (const uint8_t *)(sect + gpu->section_num);
+	data = (uint8_t *)gim_live_update_get_data_ptr(mgr, gpu_index);
+
+	for (i = 0; i < gpu->section_num; i++) {
+		if (sect[i].stored_size > gpu->payload_size - pos ||
+		    (uint64_t)sect[i].offset + sect[i].size > AMDGV_GPU_DATA_V2_SIZE ||
+		    sect[i].data_size > sect[i].size)
+			return false;
+
+		cur = pos;
+		pos += sect[i].stored_size;
+
+		if ((sect[i].op == GIM_LIVE_UPDATE_SECTION_HEADER) != header_only)
+			continue;
+
+		if (sect[i].flags & GIM_LIVE_UPDATE_SECTION_FLAG_ZRLE) {
+			if (!gim_live_update_zrle_decode(payload + cur, sect[i].stored_size,
+							 data + sect[i].offset, sect[i].data_size))
+				return false;
+		} else {
+			if (sect[i].stored_size != sect[i].data_size)
+				return false;
+			memcpy(data + sect[i].offset, payload + cur, sect[i].data_size);
+		}
+
+		if (gim_live_update_section_crc(data + sect[i].offset, sect[i].size) != sect[i].crc) {
+			gim_warn("live update section %u of GPU%u crc mismatch\n", sect[i].op, gpu_index);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Index the sectioned file and decode only the data headers, which are
+ * needed to match GPUs. The rest is decoded by gim_live_update_load_gpu()
+ * when the matching GPU probes.
+ */
+static bool gim_live_update_parse_snapshot(struct gim_live_update_manager *mgr)
+{
+	struct gim_live_update_snapshot_header *snap;
+	struct gim_live_update_snapshot_gpu *gpu;
 	struct amdgv_live_update_file_header *file_header;
+	uint64_t pos, len;
+	uint32_t i;
+
+	snap = (struct gim_live_update_snapshot_header *)mgr->file_ptr;
+	if (mgr->file_size < sizeof(*snap) ||
+	    snap->gpu_num == 0 || snap->gpu_num > GIM_LIVE_UPDATE_MAX_GPU)
+		return false;
+
+	pos = sizeof(*snap);
+	for (i = 0; i < snap->gpu_num; i++) {
+		if (mgr->file_size - pos < sizeof(*gpu))
+			return false;
+
+		gpu = (struct gim_live_update_snapshot_gpu *)(mgr->file_ptr + pos);
+		if (gpu->section_num == 0 || gpu->section_num > GIM_LIVE_UPDATE_SECTION_MAX)
+			return false;
+
+		len = sizeof(*gpu) + (uint64_t)gpu->section_num * sizeof(struct gim_live_update_section) +
+		      gpu->payload_size;
+		if (mgr->file_size - pos < len || len % 8)
+			return false;
 
-	uint32_t size;
+		mgr->snap_offset[i] = pos;
+		pos += len;
+
+		if (!gim_live_update_load_sections(mgr, i, true))
+			return false;
+	}
+
+	file_header = gim_live_update_get_file_header_ptr(mgr);
+	memcpy(&file_header->signature, LIVE_INFO_SIG_STR, LIVE_INFO_SIG_SIZE);
+	file_header->version = snap->version;
+	file_header->gpu_num = snap->gpu_num;
+
+	return true;
+}
+
+static bool gim_live_update_load_gpu(struct gim_live_update_manager *mgr, uint32_t gpu_index)
+{
+	bool ret;
+
+	/* legacy file or reserved memory, the image is already complete */
+	if (!mgr->file_ptr || test_and_set_bit(gpu_index, &mgr->loaded_map))
+		return true;
+
+	ret = gim_live_update_load_sections(mgr, gpu_index, false);
+
+	if (atomic_inc_return(&mgr->loaded_num) == mgr->gpu_num) {
+		vfree(mgr->file_ptr);
+		mgr->file_ptr = NULL;
+	}
+
+	return ret;
+}
+
+static uint32_t gim_live_update_write_file(uint8_t *buf, uint32_t size)
+{
 	uint32_t write_size;
 	loff_t pos = 0;
 	struct file *file;
 
+	file = filp_open(GIM_LIVE_UPDATE_DATA_PATH, O_WRONLY | O_TRUNC | O_CREAT, 0644);
+	if (IS_ERR(file)) {
+		gim_warn("live update file open failure\n");
+		return 0;
+	}
+
+	write_size = gim_kernel_write(file, (char *)buf, size, pos);
+	if (write_size != size)
+		gim_warn("live update file write failure\n");
+	filp_close(file, NULL);
+
+	return write_size;
+}
+
+/* the plain amdgv_gpu_data_v2 image, readable by every driver version */
+static uint32_t gim_live_update_write_raw(struct gim_live_update_manager *mgr,
+					  struct amdgv_live_update_file_header *file_header)
+{
+	return gim_live_update_write_file(mgr->gpu_data_ptr, sizeof(*file_header) +
+					  file_header->gpu_num * AMDGV_GPU_DATA_V2_SIZE);
+}
+
+static uint32_t gim_live_update_flush_file(struct gim_live_update_manager *mgr)
+{
+	struct amdgv_live_update_file_header *file_header;
+	struct gim_live_update_snapshot_header *snap;
+	struct amdgv_gpu_data_v2 *gpu_data;
+
+	uint32_t i, len;
+	uint64_t size, pos;
+	uint8_t *buf;
+
 	if (!mgr->is_export)
 		return 0;
 
@@ -144,20 +422,46 @@ static uint32_t gim_live_update_flush_file(struct gim_live_update_manager *mgr)
 		gim_warn("live update file size incorrect\n");
 		return 0;
 	}
-	size = sizeof(file_header) + file_header->gpu_num * AMDGV_GPU_DATA_V2_SIZE;
 
-	file = filp_open(GIM_LIVE_UPDATE_DATA_PATH, O_WRONLY | O_TRUNC | O_CREAT, 0644);
-	if (IS_ERR(file)) {
-		gim_warn("live update file open failure\n");
-		return 0;
+	if (!mgr->sectioned)
+		return gim_live_update_write_raw(mgr, file_header);
+
+	/* every GPU record is padded to 8 bytes by gim_live_update_encode_gpu() */
+	size = sizeof(*snap);
+	for (i = 0; i < file_header->gpu_num; i++)
+		size += ALIGN(sizeof(struct gim_live_update_snapshot_gpu) +
+			      GIM_LIVE_UPDATE_SECTION_MAX * sizeof(struct gim_live_update_section) +
+			      gim_live_update_data_end(gim_live_update_get_data_ptr(mgr, i)), 8);
+
+	buf = vmalloc(size);
+	if (!buf) {
+		gim_warn("live update snapshot allocate failed, write raw data\n");
+		return gim_live_update_write_raw(mgr, file_header);
 	}
 
-	write_size = gim_kernel_write(file, (char *)mgr->gpu_data_ptr, size, pos);
-	if (write_size != size)
-		gim_warn("live update file write failure\n");
-	filp_close(file, NULL);
+	snap = (struct gim_live_update_snapshot_header *)buf;
+	memcpy(snap->signature, GIM_LIVE_UPDATE_SNAPSHOT_SIG_STR, GIM_LIVE_UPDATE_SNAPSHOT_SIG_SIZE);
+	snap->version = file_header->version;
+	snap->gpu_num = file_header->gpu_num;
 
-	return write_size;
+	pos = sizeof(*snap);
+	for (i = 0; i < file_header->gpu_num; i++) {
+		gpu_data = gim_live_update_get_data_ptr(mgr, i);
+		len = gim_live_update_encode_gpu(mgr, gpu_data, buf + pos, size - pos);
+		if (!len) {
+			gim_warn("live update snapshot encode failed for GPU%u, write raw data\n", i);
+			vfree(buf);
+			return gim_live_update_write_raw(mgr, file_header);
+		}
+		pos += len;
+	}
+
+	gim_info("live update snapshot %llu bytes for %u GPUs\n", pos, file_header->gpu_num);
+
+	len = gim_live_update_write_file(buf, pos);
+	vfree(buf);
+
+	return len;
 }
 
 void gim_live_update_init_manager(struct gim_live_update_manager *mgr)
@@ -166,6 +470,7 @@ void gim_live_update_init_manager(struct gim_live_update_manager *mgr)
 	struct file *file = NULL;
 	struct kstat stat;
 	uint32_t file_size;
+	ssize_t read_size;
 	loff_t pos = 0;
 
 	uint64_t gpu_data_addr;
@@ -194,10 +499,32 @@ retry:
 		}
 
 		file = filp_open(GIM_LIVE_UPDATE_DATA_PATH, O_RDONLY, 0);
-		if (!IS_ERR(file) && file_size > 0) {
-			gim_kernel_read(file, mgr->gpu_data_ptr, file_size, pos);
-			filp_close(file, NULL);
+		if (IS_ERR(file))
+			break;
+
+		if (file_size > 0 && file_size <= mgr->gpu_data_size)
+			mgr->file_ptr = (uint8_t *)vmalloc(file_size);
+
+		if (mgr->file_ptr) {
+			read_size = gim_kernel_read(file, mgr->file_ptr, file_size, pos);
+			mgr->file_size = (read_size > 0) ? read_size : 0;
+			if (mgr->file_size == file_size &&
+			    !memcmp(mgr->file_ptr, GIM_LIVE_UPDATE_SNAPSHOT_SIG_STR,
+				    GIM_LIVE_UPDATE_SNAPSHOT_SIG_SIZE)) {
+				if (!gim_live_update_parse_snapshot(mgr)) {
+					gim_warn("live update snapshot is malformed\n");
+					memset(mgr->gpu_data_ptr, 0, mgr->gpu_data_size);
+					vfree(mgr->file_ptr);
+					mgr->file_ptr = NULL;
+				}
+			} else {
+				/* raw data from an older driver */
+				memcpy(mgr->gpu_data_ptr, mgr->file_ptr, mgr->file_size);
+				vfree(mgr->file_ptr);
+				mgr->file_ptr = NULL;
+			}
 		}
+		filp_close(file, NULL);
 		break;
 	case GIM_LIVE_UPDATE_MEM:
 		if (mgr->gpu_data_addr_lo & (AMDGV_GPU_DATA_V2_SIZE - 1)) {
@@ -247,6 +574,10 @@ void gim_live_update_fini_manager(struct gim_live_update_manager *mgr)
 		gim_live_update_flush_file(mgr);
 		if (mgr->gpu_data_ptr)
 			vfree(mgr->gpu_data_ptr);
+		if (mgr->file_ptr) {
+			vfree(mgr->file_ptr);
+			mgr->file_ptr = NULL;
+		}
 		break;
 	case GIM_LIVE_UPDATE_MEM:
 		if (mgr->io_ptr) {
@@ -338,8 +669,6 @@ static enum gim_live_update_data_status gim_import_data(struct gim_live_update_m
 			is_found = true;
 			if (data->info.bdf != gpu_data->header.bdf)
 				gim_warn_bdf(data->info.bdf, "domain mismatch but bdf and header validation passed. Continue live update\n");
-
-			gim_live_update_fill_compatibility(mgr, data, gpu_data);
 			break;
 		}
 	}
@@ -349,6 +678,15 @@ static enum gim_live_update_data_status gim_import_data(struct gim_live_update_m
 		goto out;
 	}
 
+	/* decode the remaining sections first, module_param is one of them */
+	if (!gim_live_update_load_gpu(mgr, current_index)) {
+		gim_warn_bdf(data->info.bdf, "live update data section is corrupted\n");
+		mgr->is_valid_update = false;
+		goto out;
+	}
+
+	gim_live_update_fill_compatibility(mgr, data, gpu_data);
+
 	gim_info_bdf(data->info.bdf, "proceed to live update\n");
 	data->opt.skip_hw_init = true;
 	data->sys_mem_info.va_ptr = gim_live_update_get_data_ptr(mgr, current_index);
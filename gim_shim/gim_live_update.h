@@ -37,6 +37,51 @@ enum gim_live_update_type {
 	GIM_LIVE_UPDATE_DISABLED,
 };
 
+#define GIM_LIVE_UPDATE_MAX_GPU 8
+
+/*
+ * sectioned live update file
+ *
+ * [ snapshot header ][ gpu0 | section table | payloads ][ gpu1 | ... ]...
+ *
+ * Each section covers one amdgv_live_info_data op range of amdgv_gpu_data_v2
+ * (plus the data header itself) and carries its own crc32. All-zero sections
+ * are omitted, trailing zeros are stripped and the payload is optionally
+ * zero run-length encoded.
+ *
+ * The import side reads both this and the raw amdgv_gpu_data_v2 image, but
+ * drivers that predate it only read the raw image, so the export only writes
+ * it when live_update_format=1. Switching an update chain to it is one way:
+ * the older driver cannot be loaded back on top of it.
+ */
+#define GIM_LIVE_UPDATE_SNAPSHOT_SIG_STR    "GIMLUSEC"
+#define GIM_LIVE_UPDATE_SNAPSHOT_SIG_SIZE   8
+#define GIM_LIVE_UPDATE_SECTION_HEADER      0xffffffff
+#define GIM_LIVE_UPDATE_SECTION_MAX         (AMDGV_LIVE_INFO_DATA__END + 1)
+#define GIM_LIVE_UPDATE_SECTION_FLAG_ZRLE   0x1
+
+struct gim_live_update_snapshot_header {
+	char     signature[GIM_LIVE_UPDATE_SNAPSHOT_SIG_SIZE];
+	uint32_t version; //LIVE_INFO_HEADER_VERSION
+	uint32_t gpu_num;
+};
+
+struct gim_live_update_snapshot_gpu {
+	uint32_t section_num;
+	uint32_t payload_size; // bytes of payload following the section table
+};
+
+struct gim_live_update_section {
+	uint32_t op;          // amdgv_live_info_data or GIM_LIVE_UPDATE_SECTION_HEADER
+	uint32_t offset;      // offset in amdgv_gpu_data_v2
+	uint32_t size;        // size of the range in amdgv_gpu_data_v2
+	uint32_t data_size;   // leading bytes of the range that are stored
+	uint32_t stored_size; // bytes in the payload, after encoding
+	uint32_t flags;
+	uint32_t crc;         // crc32 of the whole range
+	uint32_t reserved;
+};
+
 struct gim_live_update_manager {
 	enum gim_live_update_type update_type;
 
@@ -51,6 +96,15 @@ struct gim_live_update_manager {
 	bool is_valid_crc;
 	bool is_valid_update;
 	bool is_export;
+
+	/* sectioned file, kept until every GPU has pulled its sections */
+	bool     sectioned;
+	bool     compress;
+	uint8_t  *file_ptr;
+	uint32_t file_size;
+	uint32_t snap_offset[GIM_LIVE_UPDATE_MAX_GPU];
+	unsigned long loaded_map;
+	atomic_t loaded_num;
 };
 
 struct amdgv_live_update_file_header *gim_live_update_get_file_header_ptr(struct gim_live_update_manager *mgr);
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2017-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE
+ */
+
+#include "gim_live_update_zrle.h"
+
+/*
+ * Zero run-length encoding: a stream of [u16 literal][u16 zeros] records,
+ * each followed by its literal bytes. Returns 0 if the result does not fit.
+ */
+uint32_t gim_live_update_zrle_encode(const uint8_t *src, uint32_t len,
+				     uint8_t *dst, uint32_t dst_size)
+{
+	uint32_t i = 0, out = 0, start, run;
+	uint16_t lit, zeros;
+
+	while (i < len) {
+		start = i;
+		while (i < len && i - start < GIM_LIVE_UPDATE_ZRLE_MAX_LEN) {
+			if (src[i] == 0) {
+				for (run = 0; run < GIM_LIVE_UPDATE_ZRLE_MIN_RUN &&
+				     i + run < len && src[i + run] == 0; run++)
+					;
+				if (run == GIM_LIVE_UPDATE_ZRLE_MIN_RUN)
+					break;
+			}
+			i++;
+		}
+		lit = i - start;
+
+		for (run = 0; i < len && src[i] == 0 && run < GIM_LIVE_UPDATE_ZRLE_MAX_LEN; i++)
+			run++;
+		zeros = run;
+
+		if (dst_size - out < sizeof(lit) + sizeof(zeros) + lit)
+			return 0;
+
+		memcpy(dst + out, &lit, sizeof(lit));
+		memcpy(dst + out + sizeof(lit), &zeros, sizeof(zeros));
+		out += sizeof(lit) + sizeof(zeros);
+		memcpy(dst + out, src + start, lit);
+		out += lit;
+	}
+
+	return out;
+}
+
+/*
+ * Decode a whole stream into exactly dst_size bytes, false on a truncated
+ * record or a stream that does not fill dst (or runs past it).
+ */
+bool gim_live_update_zrle_decode(const uint8_t *src, uint32_t len,
+				 uint8_t *dst, uint32_t dst_size)
+{
+	uint32_t i = 0, out = 0;
+	uint16_t lit, zeros;
+
+	while (i < len) {
+		if (len - i < sizeof(lit) + sizeof(zeros))
+			return false;
+
+		memcpy(&lit, src + i, sizeof(lit));
+		memcpy(&zeros, src + i + sizeof(lit), sizeof(zeros));
+		i += sizeof(lit) + sizeof(zeros);
+
+		if (lit > len - i || (uint32_t)lit + zeros > dst_size - out)
+			return false;
+
+		memcpy(dst + out, src + i, lit);
+		i += lit;
+		out += lit;
+		memset(dst + out, 0, zeros);
+		out += zeros;
+	}
+
+	return out == dst_size;
+}
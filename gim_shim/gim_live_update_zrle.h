@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2017-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE
+ */
+
+#ifndef __GIM_LIVE_UPDATE_ZRLE_H__
+#define __GIM_LIVE_UPDATE_ZRLE_H__
+
+/* also built into the userspace check in tools/live_update_zrle_check */
+#ifdef __KERNEL__
+#include <linux/types.h>
+#include <linux/string.h>
+#else
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#endif
+
+/* shorter zero runs are cheaper to keep inside the literal */
+#define GIM_LIVE_UPDATE_ZRLE_MIN_RUN 8
+#define GIM_LIVE_UPDATE_ZRLE_MAX_LEN 0xffff
+
+uint32_t gim_live_update_zrle_encode(const uint8_t *src, uint32_t len,
+				     uint8_t *dst, uint32_t dst_size);
+bool gim_live_update_zrle_decode(const uint8_t *src, uint32_t len,
+				 uint8_t *dst, uint32_t dst_size);
+
+#endif
@@ -1413,6 +1413,19 @@ static void gim_event_fini(void *event)
 	kfree(ge);
 }
 
+static void gim_reset_event(void *event)
+{
+	struct gim_event *ge = container_of(event, struct gim_event, cp);
+
+	reinit_completion(&ge->cp);
+}
+
+/* gim_wait_event() rounds its timeout up to whole jiffies */
+static uint32_t gim_wait_event_min_us(void)
+{
+	return jiffies_to_usecs(1);
+}
+
 
 static void *gim_atomic_init(void)
 {
@@ -1621,8 +1634,7 @@ static void gim_yield(void)
 
 static void gim_memory_fence(void)
 {
-	/* dummy functions */
-	return;
+	smp_mb();
 }
 
 static uint64_t gim_get_time_stamp(void)
@@ -2284,6 +2296,8 @@ struct oss_interface gim_oss_interfaces = {
 	.signal_event_forever_with_flag = gim_signal_event_forever_with_flag,
 	.wait_event = gim_wait_event,
 	.event_fini = gim_event_fini,
+	.reset_event = gim_reset_event,
+	.wait_event_min_us = gim_wait_event_min_us,
 	.atomic_init = gim_atomic_init,
 	.atomic_read = gim_atomic_read,
 	.atomic_set = gim_atomic_set,
@@ -29,6 +29,7 @@
 
 #include "gim_debug.h"
 #include "gim.h"
+#include "gim_gpumon.h"
 #include "gim_debugfs.h"
 
 extern struct gim_error_ring_buffer *gim_error_rb;
@@ -2229,6 +2230,449 @@ static const struct file_operations fb_defragment_fops = {
 	.llseek         = default_llseek,
 };
 
+static int pp_metrics_cache_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	union amdgv_dev_conf conf;
+	int ret;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	ret = amdgv_get_dev_conf(dev_data->adev, AMDGV_CONF_PP_METRICS_CACHE, &conf);
+	if (ret)
+		return -EINVAL;
+
+	seq_printf(f, "max_age_us = %u\n", conf.pp_metrics_cache.max_age_us);
+	seq_printf(f, "hit = %llu\n", conf.pp_metrics_cache.hit);
+	seq_printf(f, "miss = %llu\n", conf.pp_metrics_cache.miss);
+	seq_printf(f, "unchanged = %llu\n", conf.pp_metrics_cache.unchanged);
+
+	return 0;
+}
+
+static int pp_metrics_cache_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, pp_metrics_cache_show, inode->i_private);
+}
+
+/* takes the new max age in us, 0 turns the cache off; counters restart */
+static ssize_t pp_metrics_cache_write(struct file *file,
+		const char __user *user_buf,
+		size_t count, loff_t *ppos)
+{
+	struct seq_file *f = file->private_data;
+	struct gim_dev_data *dev_data = f->private;
+	union amdgv_dev_conf conf;
+	u32 val;
+	int ret;
+
+	ret = kstrtou32_from_user(user_buf, count, 0, &val);
+	if (ret)
+		return ret;
+
+	conf.pp_metrics_cache.max_age_us = val;
+	ret = amdgv_set_dev_conf(dev_data->adev, AMDGV_CONF_PP_METRICS_CACHE, &conf);
+	if (ret)
+		return -EINVAL;
+
+	return count;
+}
+
+static const struct file_operations pp_metrics_cache_fops = {
+	.open           = pp_metrics_cache_open,
+	.read           = seq_read,
+	.write          = pp_metrics_cache_write,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
+static int gpumon_latency_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	struct amdgv_gpumon_latency *latency;
+	int i;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	latency = kzalloc(sizeof(*latency), GFP_KERNEL);
+	if (latency == NULL)
+		return -ENOMEM;
+
+	if (amdgv_gpumon_get_latency(dev_data->adev, latency)) {
+		kfree(latency);
+		return -EINVAL;
+	}
+
+	seq_printf(f, "%10s %12s %12s %12s\n", "<us", "fast_path",
+		   "queue_wait", "handler");
+	for (i = 0; i < AMDGV_HISTOGRAM_SIZE; i++)
+		seq_printf(f, "%10u %12llu %12llu %12llu\n",
+			   latency->fast_path_us.range[i],
+			   latency->fast_path_us.count[i],
+			   latency->queue_wait_us.count[i],
+			   latency->handler_us.count[i]);
+	seq_printf(f, "%10s %12llu %12llu %12llu\n", "total",
+		   latency->fast_path_us.total,
+		   latency->queue_wait_us.total,
+		   latency->handler_us.total);
+
+	kfree(latency);
+
+	return 0;
+}
+
+static int gpumon_latency_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, gpumon_latency_show, inode->i_private);
+}
+
+static const struct file_operations gpumon_latency_fops = {
+	.open           = gpumon_latency_open,
+	.read           = seq_read,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
+static void sched_event_hist_show(struct seq_file *f, const char *name,
+				  struct amdgv_histogram *hist)
+{
+	int i;
+
+	seq_printf(f, "  %-8s", name);
+	for (i = 0; i < AMDGV_HISTOGRAM_SIZE; i++) {
+		if (hist->count[i] == 0)
+			continue;
+		if (i == AMDGV_HISTOGRAM_SIZE - 1)
+			seq_printf(f, " >=%u:%llu", hist->range[i - 1], hist->count[i]);
+		else
+			seq_printf(f, " <%u:%llu", hist->range[i], hist->count[i]);
+	}
+	seq_puts(f, "\n");
+}
+
+static int sched_event_stats_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	struct amdgv_sched_event_queue_stats queue;
+	struct amdgv_sched_event_stats *stats;
+	uint32_t i;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	if (amdgv_sched_get_event_queue_stats(dev_data->adev, &queue))
+		return -EINVAL;
+
+	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
+	if (stats == NULL)
+		return -ENOMEM;
+
+	seq_printf(f, "depth = %llu\n", queue.depth);
+	seq_printf(f, "max_depth = %llu\n", queue.max_depth);
+	seq_printf(f, "pool_overflow = %llu\n", queue.pool_overflow);
+	seq_printf(f, "pool_backoff = %llu\n", queue.pool_backoff);
+
+	/* only events seen since the last clear */
+	for (i = 0; i < AMDGV_SCHED_EVENT_STATS_NUM; i++) {
+		if (amdgv_sched_get_event_stats(dev_data->adev, i, stats))
+			break;
+		if (stats->queued == 0 && stats->handled == 0)
+			continue;
+
+		seq_printf(f, "event 0x%x queued %llu coalesced %llu skipped %llu handled %llu\n",
+			   stats->event_id, stats->queued, stats->coalesced,
+			   stats->skipped, stats->handled);
+		if (stats->handled == 0)
+			continue;
+		seq_printf(f, "  wait_us avg %llu max %u, run_us avg %llu max %u\n",
+			   stats->wait_sum_us / stats->handled, stats->wait_max_us,
+			   stats->run_sum_us / stats->handled, stats->run_max_us);
+		sched_event_hist_show(f, "wait_us", &stats->wait_us);
+		sched_event_hist_show(f, "run_us", &stats->run_us);
+	}
+
+	kfree(stats);
+
+	return 0;
+}
+
+static int sched_event_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, sched_event_stats_show, inode->i_private);
+}
+
+/* any write restarts the counters */
+static ssize_t sched_event_stats_write(struct file *file,
+		const char __user *user_buf,
+		size_t count, loff_t *ppos)
+{
+	struct seq_file *f = file->private_data;
+	struct gim_dev_data *dev_data = f->private;
+
+	if (amdgv_sched_clear_event_stats(dev_data->adev))
+		return -EINVAL;
+
+	return count;
+}
+
+static const struct file_operations sched_event_stats_fops = {
+	.open           = sched_event_stats_open,
+	.read           = seq_read,
+	.write          = sched_event_stats_write,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
+static int live_update_timing_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	struct amdgv_live_info_timing timing;
+	uint32_t i;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	if (amdgv_get_live_info_timing(dev_data->adev, &timing))
+		return -EINVAL;
+
+	/* export runs while the driver unloads, after this file is gone,
+	 * its timings only go to the kernel log
+	 */
+	seq_printf(f, "import_total_us = %llu\n", timing.import_total_us);
+
+	for (i = 0; i < AMDGV_LIVE_INFO_TIMING_MAX_OP; i++) {
+		if (timing.import_us[i] == 0)
+			continue;
+		seq_printf(f, "op %u import_us %u\n", i, timing.import_us[i]);
+	}
+
+	return 0;
+}
+
+static int live_update_timing_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, live_update_timing_show, inode->i_private);
+}
+
+static const struct file_operations live_update_timing_fops = {
+	.open           = live_update_timing_open,
+	.read           = seq_read,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
+static int init_timing_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	struct amdgv_init_timing *timing;
+	uint32_t i;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	timing = kzalloc(sizeof(*timing), GFP_KERNEL);
+	if (timing == NULL)
+		return -ENOMEM;
+
+	if (amdgv_get_init_timing(dev_data->adev, timing)) {
+		kfree(timing);
+		return -EINVAL;
+	}
+
+	seq_printf(f, "sw_total_us = %llu\n", timing->sw_total_us);
+	seq_printf(f, "sw_critical_path_us = %llu\n", timing->sw_critical_path_us);
+	seq_printf(f, "hw_total_us = %llu\n", timing->hw_total_us);
+	seq_printf(f, "hw_critical_path_us = %llu\n", timing->hw_critical_path_us);
+
+	for (i = 0; i < timing->num_stages && i < AMDGV_INIT_TIMING_MAX_STAGE; i++)
+		seq_printf(f, "%-32s start_us %u sw_init_us %u hw_init_us %u\n",
+			   timing->stage[i].name, timing->stage[i].sw_start_us,
+			   timing->stage[i].sw_init_us, timing->stage[i].hw_init_us);
+
+	sched_event_hist_show(f, "stage_us", &timing->stage_us);
+
+	kfree(timing);
+
+	return 0;
+}
+
+static int init_timing_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, init_timing_show, inode->i_private);
+}
+
+static const struct file_operations init_timing_fops = {
+	.open           = init_timing_open,
+	.read           = seq_read,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
+static int eeprom_xfer_stats_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	struct amdgv_ras_eeprom_xfer_stats stats;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	if (amdgv_ras_get_eeprom_xfer_stats(dev_data->adev, &stats))
+		return -EINVAL;
+
+	seq_printf(f, "xfers = %llu\n", stats.xfers);
+	seq_printf(f, "flushes = %llu\n", stats.flushes);
+	seq_printf(f, "flush_records = %llu\n", stats.flush_records);
+	seq_printf(f, "flush_xfers = %llu\n", stats.flush_xfers);
+	seq_printf(f, "last_flush_records = %u\n", stats.last_flush_records);
+	seq_printf(f, "last_flush_xfers = %u\n", stats.last_flush_xfers);
+	seq_printf(f, "max_flush_xfers = %u\n", stats.max_flush_xfers);
+
+	return 0;
+}
+
+static int eeprom_xfer_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, eeprom_xfer_stats_show, inode->i_private);
+}
+
+/* any write restarts the counters */
+static ssize_t eeprom_xfer_stats_write(struct file *file,
+		const char __user *user_buf,
+		size_t count, loff_t *ppos)
+{
+	struct seq_file *f = file->private_data;
+	struct gim_dev_data *dev_data = f->private;
+
+	if (amdgv_ras_clear_eeprom_xfer_stats(dev_data->adev))
+		return -EINVAL;
+
+	return count;
+}
+
+static const struct file_operations eeprom_xfer_stats_fops = {
+	.open           = eeprom_xfer_stats_open,
+	.read           = seq_read,
+	.write          = eeprom_xfer_stats_write,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
+static int psp_cmd_stats_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	struct amdgv_psp_cmd_stats *stats;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
+	if (stats == NULL)
+		return -ENOMEM;
+
+	if (amdgv_psp_get_cmd_stats(dev_data->adev, stats)) {
+		kfree(stats);
+		return -EINVAL;
+	}
+
+	seq_printf(f, "submitted = %llu\n", stats->submitted);
+	seq_printf(f, "completed = %llu\n", stats->completed);
+	seq_printf(f, "failed = %llu\n", stats->failed);
+	if (stats->completed)
+		seq_printf(f, "latency_us avg %llu max %u\n",
+			   stats->latency_sum_us / stats->completed,
+			   stats->latency_max_us);
+	sched_event_hist_show(f, "latency", &stats->latency_us);
+
+	kfree(stats);
+
+	return 0;
+}
+
+static int psp_cmd_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, psp_cmd_stats_show, inode->i_private);
+}
+
+/* any write restarts the counters */
+static ssize_t psp_cmd_stats_write(struct file *file,
+		const char __user *user_buf,
+		size_t count, loff_t *ppos)
+{
+	struct seq_file *f = file->private_data;
+	struct gim_dev_data *dev_data = f->private;
+
+	if (amdgv_psp_clear_cmd_stats(dev_data->adev))
+		return -EINVAL;
+
+	return count;
+}
+
+static const struct file_operations psp_cmd_stats_fops = {
+	.open           = psp_cmd_stats_open,
+	.read           = seq_read,
+	.write          = psp_cmd_stats_write,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
+static int wait_site_stats_show(struct seq_file *f, void *p)
+{
+	struct gim_dev_data *dev_data;
+	struct amdgv_wait_site_stats *stats;
+	uint32_t i;
+
+	dev_data = (struct gim_dev_data *)f->private;
+
+	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
+	if (stats == NULL)
+		return -ENOMEM;
+
+	if (amdgv_get_wait_site_stats(dev_data->adev, stats)) {
+		kfree(stats);
+		return -EINVAL;
+	}
+
+	seq_printf(f, "%-20s %10s %8s %12s %8s %8s %8s %8s %8s %10s\n", "site",
+		   "count", "timeouts", "total_us", "p50_us", "p99_us", "max_us",
+		   "avg_us", "dev_us", "irq_wakes");
+	for (i = 0; i < stats->num_sites && i < AMDGV_WAIT_SITE_STATS_MAX; i++) {
+		if (stats->site[i].count == 0)
+			continue;
+		seq_printf(f, "%-20s %10llu %8llu %12llu %8u %8u %8u %8u %8u %10llu\n",
+			   stats->site[i].name, stats->site[i].count,
+			   stats->site[i].timeouts, stats->site[i].total_us,
+			   stats->site[i].p50_us, stats->site[i].p99_us,
+			   stats->site[i].max_us, stats->site[i].avg_us,
+			   stats->site[i].dev_us, stats->site[i].irq_wakeups);
+	}
+
+	kfree(stats);
+
+	return 0;
+}
+
+static int wait_site_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, wait_site_stats_show, inode->i_private);
+}
+
+/* any write restarts the counters */
+static ssize_t wait_site_stats_write(struct file *file,
+		const char __user *user_buf,
+		size_t count, loff_t *ppos)
+{
+	struct seq_file *f = file->private_data;
+	struct gim_dev_data *dev_data = f->private;
+
+	if (amdgv_clear_wait_site_stats(dev_data->adev))
+		return -EINVAL;
+
+	return count;
+}
+
+static const struct file_operations wait_site_stats_fops = {
+	.open           = wait_site_stats_open,
+	.read           = seq_read,
+	.write          = wait_site_stats_write,
+	.llseek         = seq_lseek,
+	.release        = single_release,
+};
+
 void gim_debugfs_init(void)
 {
 	int i;
@@ -2565,6 +3009,70 @@ void gim_debugfs_init(void)
 			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
 			goto err;
 		}
+
+		entry = debugfs_create_file("pp_metrics_cache", 0600,
+				adapt_dir,
+				dev_data, &pp_metrics_cache_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
+
+		entry = debugfs_create_file("gpumon_latency", 0400,
+				adapt_dir,
+				dev_data, &gpumon_latency_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
+
+		entry = debugfs_create_file("sched_event_stats", 0600,
+				adapt_dir,
+				dev_data, &sched_event_stats_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
+
+		entry = debugfs_create_file("live_update_timing", 0400,
+				adapt_dir,
+				dev_data, &live_update_timing_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
+
+		entry = debugfs_create_file("init_timing", 0400,
+				adapt_dir,
+				dev_data, &init_timing_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
+
+		entry = debugfs_create_file("eeprom_xfer_stats", 0600,
+				adapt_dir,
+				dev_data, &eeprom_xfer_stats_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
+
+		entry = debugfs_create_file("psp_cmd_stats", 0600,
+				adapt_dir,
+				dev_data, &psp_cmd_stats_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
+
+		entry = debugfs_create_file("wait_site_stats", 0600,
+				adapt_dir,
+				dev_data, &wait_site_stats_fops);
+		if (entry == NULL) {
+			gim_put_error(AMDGV_ERROR_DRIVER_CREATE_DEBUGFS_FILE_FAIL, 0);
+			goto err;
+		}
 	}
 
 	return;
@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Live update ZRLE check.
+ *
+ * Round-trips buffers through gim_live_update_zrle_encode() and
+ * gim_live_update_zrle_decode() the way the sectioned live update file
+ * stores a section, and checks that
+ *   - decode(encode(buf)) gives buf back,
+ *   - the stream is never longer than the buffer plus one record header
+ *     per GIM_LIVE_UPDATE_ZRLE_MAX_LEN bytes,
+ *   - encode fits in exactly the stream size and gives up one byte short,
+ *   - the decoder rejects every truncated stream, streams with a record
+ *     appended, and destinations one byte too short or too long,
+ *   - neither side ever writes past dst_size, checked with guard bytes,
+ *     also for random garbage streams.
+ * Buffers are random, sparse, all-zero, every 0/1 buffer up to 12 bytes,
+ * and worst cases for the format: no zeros at all, zero runs right at
+ * GIM_LIVE_UPDATE_ZRLE_MIN_RUN and around GIM_LIVE_UPDATE_ZRLE_MAX_LEN.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "gim_live_update_zrle.h"
+
+/* bytes after dst_size that must stay untouched */
+#define CHECK_GUARD		64
+#define CHECK_GUARD_BYTE	0xa5
+/* record header, u16 literal and u16 zeros */
+#define CHECK_RECORD		4
+/* streams up to this size get every prefix decoded */
+#define CHECK_ALL_PREFIXES	4096
+/* record boundaries to truncate at, sampled on longer streams */
+#define CHECK_BOUNDARIES	256
+
+static uint64_t check_seed = 1;
+static bool check_verbose;
+
+/* xorshift64*, runs must not depend on the libc generator */
+static uint64_t check_rand(void)
+{
+	check_seed ^= check_seed >> 12;
+	check_seed ^= check_seed << 25;
+	check_seed ^= check_seed >> 27;
+	return check_seed * 2685821657736338717ULL;
+}
+
+static uint8_t *check_alloc(uint32_t size)
+{
+	uint8_t *buf;
+
+	buf = malloc(size + CHECK_GUARD);
+	if (!buf) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	memset(buf, CHECK_GUARD_BYTE, size + CHECK_GUARD);
+
+	return buf;
+}
+
+static bool check_guard(const uint8_t *buf, uint32_t size)
+{
+	uint32_t i;
+
+	for (i = 0; i < CHECK_GUARD; i++)
+		if (buf[size + i] != CHECK_GUARD_BYTE)
+			return false;
+
+	return true;
+}
+
+static uint32_t check_bound(uint32_t len)
+{
+	return len + CHECK_RECORD * (len / GIM_LIVE_UPDATE_ZRLE_MAX_LEN + 1);
+}
+
+/* decode into a fresh dst_size buffer, false if it writes past it */
+static bool check_decode(const uint8_t *stream, uint32_t len, uint32_t dst_size, bool *ok,
+			 const uint8_t *expect)
+{
+	uint8_t *dst = check_alloc(dst_size);
+	bool guard;
+
+	*ok = gim_live_update_zrle_decode(stream, len, dst, dst_size);
+	if (*ok && expect && memcmp(dst, expect, dst_size))
+		*ok = false;
+	guard = check_guard(dst, dst_size);
+	free(dst);
+
+	return guard;
+}
+
+/* the decoder has to refuse stream[0..len) into dst_size */
+static int check_reject(const char *name, const char *what, const uint8_t *stream,
+			uint32_t len, uint32_t dst_size)
+{
+	bool ok;
+
+	if (!check_decode(stream, len, dst_size, &ok, NULL)) {
+		fprintf(stderr, "%s: %s %u of stream into %u wrote past dst\n", name, what, len,
+			dst_size);
+		return 1;
+	}
+	if (ok) {
+		fprintf(stderr, "%s: %s %u of stream into %u accepted\n", name, what, len,
+			dst_size);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int check_buf(const char *name, const uint8_t *buf, uint32_t len)
+{
+	uint8_t *stream, *ext;
+	uint32_t size, size_again, cap, pos, i, records = 0;
+	uint16_t lit, zeros;
+	bool ok;
+	int ret = 1;
+
+	cap = check_bound(len);
+	stream = check_alloc(cap);
+	ext = check_alloc(cap + CHECK_RECORD + 1);
+
+	size = gim_live_update_zrle_encode(buf, len, stream, cap);
+	if ((size == 0 && len) || size > cap || !check_guard(stream, cap)) {
+		fprintf(stderr, "%s: %u bytes encoded to %u, bound %u\n", name, len, size, cap);
+		goto out;
+	}
+
+	/* exactly the stream size fits, one byte less does not */
+	memset(ext, CHECK_GUARD_BYTE, cap + CHECK_GUARD);
+	size_again = gim_live_update_zrle_encode(buf, len, ext, size);
+	if (size_again != size || memcmp(ext, stream, size) || !check_guard(ext, size)) {
+		fprintf(stderr, "%s: encode into %u bytes gave %u\n", name, size, size_again);
+		goto out;
+	}
+	if (size) {
+		memset(ext, CHECK_GUARD_BYTE, cap + CHECK_GUARD);
+		size_again = gim_live_update_zrle_encode(buf, len, ext, size - 1);
+		if (size_again || !check_guard(ext, size - 1)) {
+			fprintf(stderr, "%s: encode into %u bytes gave %u\n", name, size - 1,
+				size_again);
+			goto out;
+		}
+	}
+
+	if (!check_decode(stream, size, len, &ok, buf) || !ok) {
+		fprintf(stderr, "%s: round trip of %u bytes failed\n", name, len);
+		goto out;
+	}
+
+	/* a destination that does not match the stream */
+	if (len && check_reject(name, "whole", stream, size, len - 1))
+		goto out;
+	if (check_reject(name, "whole", stream, size, len + 1))
+		goto out;
+
+	for (pos = 0; pos < size; pos += CHECK_RECORD + lit) {
+		memcpy(&lit, stream + pos, sizeof(lit));
+		records++;
+	}
+
+	/* truncated streams, at and around the record boundaries */
+	for (pos = 0; pos < size; pos += CHECK_RECORD + lit) {
+		memcpy(&lit, stream + pos, sizeof(lit));
+		if (records > CHECK_BOUNDARIES && check_rand() % records >= CHECK_BOUNDARIES)
+			continue;
+		for (i = pos; i < pos + CHECK_RECORD + 1 && i < size; i++)
+			if (check_reject(name, "prefix", stream, i, len))
+				goto out;
+	}
+	if (size <= CHECK_ALL_PREFIXES) {
+		for (i = 0; i < size; i++)
+			if (check_reject(name, "prefix", stream, i, len))
+				goto out;
+	} else {
+		for (i = 0; i < 64; i++)
+			if (check_reject(name, "prefix", stream, check_rand() % size, len))
+				goto out;
+	}
+
+	/* overlong streams, one more literal byte or one more zero */
+	memcpy(ext, stream, size);
+	lit = 1;
+	zeros = 0;
+	memcpy(ext + size, &lit, sizeof(lit));
+	memcpy(ext + size + sizeof(lit), &zeros, sizeof(zeros));
+	ext[size + CHECK_RECORD] = 0x5a;
+	if (check_reject(name, "overlong", ext, size + CHECK_RECORD + 1, len))
+		goto out;
+	lit = 0;
+	zeros = 1;
+	memcpy(ext + size, &lit, sizeof(lit));
+	memcpy(ext + size + sizeof(lit), &zeros, sizeof(zeros));
+	if (check_reject(name, "overlong", ext, size + CHECK_RECORD, len))
+		goto out;
+	/* a last literal that claims more bytes than the stream holds */
+	lit = 2;
+	zeros = 0;
+	memcpy(ext + size, &lit, sizeof(lit));
+	memcpy(ext + size + sizeof(lit), &zeros, sizeof(zeros));
+	if (check_reject(name, "overlong", ext, size + CHECK_RECORD + 1, len + 2))
+		goto out;
+
+	if (check_verbose)
+		printf("    %-28s %8u -> %8u bytes, %6u records ok\n", name, len, size, records);
+	ret = 0;
+
+out:
+	free(ext);
+	free(stream);
+
+	return ret;
+}
+
+/* the pattern repeated up to len bytes */
+static int check_pattern(const char *name, const uint8_t *pattern, uint32_t plen, uint32_t len)
+{
+	uint8_t *buf = check_alloc(len);
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < len; i++)
+		buf[i] = pattern[i % plen];
+	ret = check_buf(name, buf, len);
+	free(buf);
+
+	return ret;
+}
+
+/* zero runs of the given length between single non-zero bytes */
+static int check_gaps(const char *name, uint32_t gap, uint32_t len)
+{
+	uint8_t *buf = check_alloc(len);
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (i % (gap + 1)) ? 0 : 1;
+	ret = check_buf(name, buf, len);
+	free(buf);
+
+	return ret;
+}
+
+/* a literal of lit_len bytes, then zero_len zeros, then a literal tail */
+static int check_split(const char *name, uint32_t lit_len, uint32_t zero_len)
+{
+	uint32_t len = lit_len + zero_len + 3, i;
+	uint8_t *buf = check_alloc(len);
+	int ret;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (i >= lit_len && i < lit_len + zero_len) ? 0 : 0x11;
+	ret = check_buf(name, buf, len);
+	free(buf);
+
+	return ret;
+}
+
+/* every buffer of 0 and 1 bytes up to max_len */
+static int check_small(uint32_t max_len)
+{
+	uint8_t buf[32];
+	uint32_t len, bits, i, count = 0;
+
+	for (len = 0; len <= max_len; len++) {
+		for (bits = 0; bits < (1U << len); bits++) {
+			for (i = 0; i < len; i++)
+				buf[i] = (bits >> i) & 1;
+			if (check_buf("small", buf, len))
+				return 1;
+			count++;
+		}
+	}
+
+	printf("%-24s %8u buffers ok\n", "small", count);
+
+	return 0;
+}
+
+/* random lengths, with one byte in density non-zero */
+static int check_random(uint32_t rounds)
+{
+	static const uint32_t densities[] = { 1, 2, 8, 64, 4096 };
+	uint32_t round, len, density, i;
+	uint8_t *buf;
+	char name[32];
+	int ret = 0;
+
+	for (round = 0; round < rounds && !ret; round++) {
+		len = check_rand() % (1 << (check_rand() % 20));
+		density = densities[check_rand() % (sizeof(densities) / sizeof(densities[0]))];
+		buf = check_alloc(len);
+		for (i = 0; i < len; i++)
+			buf[i] = (check_rand() % density) ? 0 : 1 + check_rand() % 255;
+
+		snprintf(name, sizeof(name), "random %u", round);
+		ret = check_buf(name, buf, len);
+		free(buf);
+	}
+
+	if (!ret)
+		printf("%-24s %8u buffers ok\n", "random", rounds);
+
+	return ret;
+}
+
+/* random streams, the decoder may refuse them but must stay inside dst */
+static int check_garbage(uint32_t rounds)
+{
+	uint32_t round, len, dst_size, i;
+	uint16_t field;
+	uint8_t *stream;
+	bool ok;
+	int ret = 0;
+
+	for (round = 0; round < rounds && !ret; round++) {
+		len = check_rand() % 256;
+		dst_size = check_rand() % 4096;
+		stream = check_alloc(len);
+		for (i = 0; i < len; i++)
+			stream[i] = check_rand();
+		/* mostly short records, so that streams get decoded past the first one */
+		for (i = 0; i + CHECK_RECORD <= len; i += CHECK_RECORD + field) {
+			if (check_rand() & 1) {
+				field = check_rand() % 2048;
+				memcpy(stream + i + sizeof(field), &field, sizeof(field));
+			}
+			field = check_rand() % 32;
+			memcpy(stream + i, &field, sizeof(field));
+		}
+
+		if (!check_decode(stream, len, dst_size, &ok, NULL)) {
+			fprintf(stderr, "garbage %u: %u bytes into %u wrote past dst\n", round, len,
+				dst_size);
+			ret = 1;
+		}
+		free(stream);
+	}
+
+	if (!ret)
+		printf("%-24s %8u streams ok\n", "garbage", rounds);
+
+	return ret;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [-n rounds] [-r seed] [-v]\n"
+		"  -n  random buffers and garbage streams to check (default 500)\n"
+		"  -r  random seed (default 1)\n"
+		"  -v  print every buffer\n",
+		name);
+}
+
+#define CHECK(name, expr)						\
+	do {								\
+		int __ret = (expr);					\
+		if (!__ret)						\
+			printf("%-24s ok\n", name);			\
+		ret |= __ret;						\
+	} while (0)
+
+int main(int argc, char **argv)
+{
+	static const uint8_t zero[] = { 0 };
+	static const uint8_t ramp[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+	const uint32_t max = GIM_LIVE_UPDATE_ZRLE_MAX_LEN;
+	const uint32_t min_run = GIM_LIVE_UPDATE_ZRLE_MIN_RUN;
+	uint32_t rounds = 500;
+	int opt, ret = 0;
+
+	while ((opt = getopt(argc, argv, "n:r:vh")) != -1) {
+		switch (opt) {
+		case 'n':
+			rounds = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			check_seed = strtoull(optarg, NULL, 0);
+			break;
+		case 'v':
+			check_verbose = true;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (check_seed == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	CHECK("all zero", check_pattern("all zero", zero, 1, 1) |
+			  check_pattern("all zero", zero, 1, min_run) |
+			  check_pattern("all zero", zero, 1, max) |
+			  check_pattern("all zero", zero, 1, max + 1) |
+			  check_pattern("all zero", zero, 1, 3 * max + 7) |
+			  check_pattern("all zero", zero, 1, 1 << 20));
+	CHECK("no zeros", check_pattern("no zeros", ramp, sizeof(ramp), max - 1) |
+			  check_pattern("no zeros", ramp, sizeof(ramp), max) |
+			  check_pattern("no zeros", ramp, sizeof(ramp), max + 1) |
+			  check_pattern("no zeros", ramp, sizeof(ramp), 4 * max + 5));
+	CHECK("min run gaps", check_gaps("min run gaps", min_run, 1 << 18) |
+			      check_gaps("short gaps", min_run - 1, 1 << 18) |
+			      check_gaps("single gaps", 1, 1 << 16));
+	CHECK("max len splits", check_split("zeros after max literal", max, min_run) |
+				check_split("zeros inside max literal", max - 3, min_run) |
+				check_split("max zero run", 5, max) |
+				check_split("max zero run + 1", 5, max + 1) |
+				check_split("short zero tail", 5, min_run - 1));
+	ret |= check_small(12);
+	ret |= check_random(rounds);
+	ret |= check_garbage(rounds * 100);
+
+	return ret ? 1 : 0;
+}
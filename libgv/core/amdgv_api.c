@@ -143,6 +143,8 @@ const char *const amdgv_inf_name[] = {
 	"signal_event_forever_with_flag",
 	"wait_event",
 	"event_fini",
+	"reset_event",
+	"wait_event_min_us",
 	"notifier_wakeup",
 	"atomic_init",
 	"atomic_read",
@@ -1102,6 +1104,18 @@ int AMDGV_API amdgv_set_dev_conf(amdgv_dev_t dev, enum amdgv_dev_conf_type type,
 		amdgv_error_dump_stack_filter_set(adapt,
 			conf->error_dump_stack_entry, conf->error_dump_stack_add);
 		break;
+	case AMDGV_CONF_PP_METRICS_CACHE:
+		if (adapt->pp.table_cache.lock == OSS_INVALID_HANDLE) {
+			ret = AMDGV_FAILURE;
+			break;
+		}
+		oss_mutex_lock(adapt->pp.table_cache.lock);
+		adapt->pp.table_cache.max_age_us = conf->pp_metrics_cache.max_age_us;
+		adapt->pp.table_cache.hit = 0;
+		adapt->pp.table_cache.miss = 0;
+		adapt->pp.table_cache.unchanged = 0;
+		oss_mutex_unlock(adapt->pp.table_cache.lock);
+		break;
 
 	default:
 		ret = AMDGV_FAILURE;
@@ -1238,6 +1252,18 @@ int AMDGV_API amdgv_get_dev_conf(amdgv_dev_t dev, enum amdgv_dev_conf_type type,
 	case AMDGV_CONF_ERROR_DUMP_STACK_MAX:
 		conf->error_dump_stack_max = adapt->error_dump_stack_max;
 		break;
+	case AMDGV_CONF_PP_METRICS_CACHE:
+		if (adapt->pp.table_cache.lock == OSS_INVALID_HANDLE) {
+			ret = AMDGV_FAILURE;
+			break;
+		}
+		oss_mutex_lock(adapt->pp.table_cache.lock);
+		conf->pp_metrics_cache.max_age_us = adapt->pp.table_cache.max_age_us;
+		conf->pp_metrics_cache.hit = adapt->pp.table_cache.hit;
+		conf->pp_metrics_cache.miss = adapt->pp.table_cache.miss;
+		conf->pp_metrics_cache.unchanged = adapt->pp.table_cache.unchanged;
+		oss_mutex_unlock(adapt->pp.table_cache.lock);
+		break;
 	default:
 		ret = AMDGV_FAILURE;
 		break;
@@ -1908,6 +1934,41 @@ int amdgv_import_live_info_data(amdgv_dev_t dev, uint32_t data_op, void *data,
 	return ret;
 }
 
+int amdgv_get_live_info_timing(amdgv_dev_t dev, struct amdgv_live_info_timing *timing)
+{
+	struct amdgv_adapter *adapt;
+
+	if (dev != NULL)
+		adapt = (struct amdgv_adapter *)dev;
+	else
+		return AMDGV_ERROR_GPU_DEVICE_LOST;
+
+	if (timing == NULL)
+		return AMDGV_FAILURE;
+
+	oss_memcpy(timing, &adapt->live_info_timing, sizeof(*timing));
+
+	return 0;
+}
+
+int amdgv_get_init_timing(amdgv_dev_t dev, struct amdgv_init_timing *timing)
+{
+	struct amdgv_adapter *adapt;
+
+	if (dev != NULL)
+		adapt = (struct amdgv_adapter *)dev;
+	else
+		return AMDGV_ERROR_GPU_DEVICE_LOST;
+
+	if (timing == NULL)
+		return AMDGV_FAILURE;
+
+	/* no api_lock, written once during init */
+	oss_memcpy(timing, &adapt->init_timing, sizeof(*timing));
+
+	return 0;
+}
+
 int amdgv_lock_sched(amdgv_dev_t dev)
 {
 	int ret;
@@ -1976,6 +2037,75 @@ int amdgv_unlock_sched_ex(amdgv_dev_t dev, struct amdgv_lock_sched_opt opt)
 	return ret;
 }
 
+/* no api_lock, readers must not queue behind a long running API call */
+int amdgv_sched_get_event_stats(amdgv_dev_t dev, uint32_t idx,
+				struct amdgv_sched_event_stats *stats)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	return amdgv_sched_event_get_stats(adapt, idx, stats);
+}
+
+int amdgv_sched_get_event_queue_stats(amdgv_dev_t dev,
+				      struct amdgv_sched_event_queue_stats *stats)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	amdgv_sched_event_get_queue_stats(adapt, stats);
+
+	return 0;
+}
+
+int amdgv_sched_clear_event_stats(amdgv_dev_t dev)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	return amdgv_sched_event_clear_stats(adapt);
+}
+
+int amdgv_psp_get_cmd_stats(amdgv_dev_t dev, struct amdgv_psp_cmd_stats *stats)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	return amdgv_psp_cmd_km_get_stats(adapt, stats);
+}
+
+int amdgv_psp_clear_cmd_stats(amdgv_dev_t dev)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	return amdgv_psp_cmd_km_clear_stats(adapt);
+}
+
+int amdgv_get_wait_site_stats(amdgv_dev_t dev, struct amdgv_wait_site_stats *stats)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	/* no api_lock, the wait sites have their own lock */
+	return amdgv_wait_sites_get_stats(adapt, stats);
+}
+
+int amdgv_clear_wait_site_stats(amdgv_dev_t dev)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	return amdgv_wait_sites_clear_stats(adapt);
+}
+
 int amdgv_set_time_quanta_option(amdgv_dev_t dev, enum amdgv_sched_block sched_block,
 				 uint32_t opt)
 {
@@ -2205,6 +2335,26 @@ int amdgv_ras_get_bad_page_info(amdgv_dev_t dev, uint32_t index,
 	return ret;
 }
 
+/* no api_lock, flush counters are updated under the EEPROM table mutex */
+int amdgv_ras_get_eeprom_xfer_stats(amdgv_dev_t dev,
+				    struct amdgv_ras_eeprom_xfer_stats *stats)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	return amdgv_ras_eeprom_get_xfer_stats(adapt, &adapt->eeprom_control, stats);
+}
+
+int amdgv_ras_clear_eeprom_xfer_stats(amdgv_dev_t dev)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	return amdgv_ras_eeprom_clear_xfer_stats(adapt, &adapt->eeprom_control);
+}
+
 int amdgv_ras_get_ecc_block_info(amdgv_dev_t dev, struct amdgv_smi_ras_query_if *info)
 {
 	int ret;
@@ -2720,6 +2870,95 @@ out:
 	return ret;
 }
 
+int amdgv_migration_export_chunked_start(amdgv_dev_t dev,
+					struct amdgv_migration_chunked *copy)
+{
+	int ret = 0;
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	oss_mutex_lock(adapt->api_lock);
+
+	if (amdgv_migration_chunked_start(adapt, copy, true)) {
+		AMDGV_ERROR("failed to get VF%d do phase%d chunked export.\n",
+			    copy->idx_vf, copy->phase);
+		ret = AMDGV_FAILURE;
+	}
+
+	oss_mutex_unlock(adapt->api_lock);
+	return ret;
+}
+
+/* no api_lock, chunks are drained concurrently under the copy lock */
+int amdgv_migration_export_chunked_read(amdgv_dev_t dev,
+				       struct amdgv_migration_chunked *copy, uint32_t chunk,
+				       void *buf, uint32_t *size)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	if (buf == NULL || size == NULL)
+		return AMDGV_FAILURE;
+
+	return amdgv_migration_chunked_read(adapt, copy, chunk, buf, size);
+}
+
+int amdgv_migration_import_chunked_start(amdgv_dev_t dev,
+					struct amdgv_migration_chunked *copy)
+{
+	int ret = 0;
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	oss_mutex_lock(adapt->api_lock);
+
+	if (amdgv_migration_chunked_start(adapt, copy, false)) {
+		AMDGV_ERROR("failed to prepare VF%d phase%d chunked import.\n",
+			    copy->idx_vf, copy->phase);
+		ret = AMDGV_FAILURE;
+	}
+
+	oss_mutex_unlock(adapt->api_lock);
+	return ret;
+}
+
+int amdgv_migration_import_chunked_write(amdgv_dev_t dev,
+					struct amdgv_migration_chunked *copy, uint32_t chunk,
+					const void *buf, uint32_t size)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	if (buf == NULL)
+		return AMDGV_FAILURE;
+
+	return amdgv_migration_chunked_write(adapt, copy, chunk, buf, size);
+}
+
+int amdgv_migration_import_chunked_finish(amdgv_dev_t dev,
+					 struct amdgv_migration_chunked *copy)
+{
+	int ret = 0;
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	oss_mutex_lock(adapt->api_lock);
+
+	if (amdgv_migration_chunked_finish(adapt, copy)) {
+		AMDGV_ERROR("failed to get VF%d do phase%d chunked import.\n",
+			    copy->idx_vf, copy->phase);
+		ret = AMDGV_FAILURE;
+	}
+
+	oss_mutex_unlock(adapt->api_lock);
+	return ret;
+}
+
 int amdgv_get_migration_static_package(amdgv_dev_t dev, void *buf, uint64_t *size)
 {
 	int ret = 0;
@@ -102,6 +102,15 @@ struct amdgv_ras_eeprom_control {
 	uint32_t bad_channel_bitmap;
 
 	uint32_t max_record_num;
+
+	/* I2C messages issued for the table, and per flush of records to it */
+	uint64_t xfer_count;
+	uint64_t flush_count;
+	uint64_t flush_recs;
+	uint64_t flush_xfers;
+	uint32_t last_flush_recs;
+	uint32_t last_flush_xfers;
+	uint32_t max_flush_xfers;
 };
 
 struct i2c_msg {
@@ -310,22 +310,140 @@ int amdgv_cper_entry_fill_bad_page_thr_section(struct amdgv_adapter *adapt,
 	return 0;
 }
 
+static uint32_t amdgv_cper_sev_idx(enum cper_error_severity sev)
+{
+	/* Records with an unknown severity are accounted as fatal */
+	return ((uint32_t)sev < CPER_SEV_NUM) ? (uint32_t)sev : CPER_SEV_FATAL;
+}
+
+/*
+ * Find room for a record of size bytes, dropping the oldest records until
+ * there is both a free index slot and a contiguous free byte range.
+ */
+static struct cper_hdr *amdgv_cper_ring_reserve(struct amdgv_adapter *adapt,
+						uint32_t size)
+{
+	struct amdgv_cper *cper = &adapt->cper;
+	uint32_t offset = 0;
+	uint32_t tail;
+
+	if (size > cper->data_size)
+		return NULL;
+
+	while (cper->rptr != cper->wptr) {
+		if (cper->wptr - cper->rptr < CPER_MAX_COUNT) {
+			tail = cper->index[cper->rptr % CPER_MAX_COUNT].offset;
+			if (cper->head > tail) {
+				/* Live bytes are [tail, head) */
+				if (cper->head + size <= cper->data_size) {
+					offset = cper->head;
+					break;
+				}
+				if (size <= tail) {
+					offset = 0;
+					break;
+				}
+			} else if (cper->head + size <= tail) {
+				/* Live bytes are [tail, end) and [0, head) */
+				offset = cper->head;
+				break;
+			}
+		}
+		cper->rptr++;
+	}
+
+	cper->reserve_offset = offset;
+	cper->reserve_size = size;
+
+	oss_memset(cper->data + offset, 0, size);
+
+	return (struct cper_hdr *)(cper->data + offset);
+}
+
+/* Number and size of the records in [rptr, wptr) whose severity is in sev_mask */
+static void amdgv_cper_window(struct amdgv_adapter *adapt, uint64_t rptr,
+			      uint32_t sev_mask, uint64_t *count, uint64_t *bytes)
+{
+	struct amdgv_cper *cper = &adapt->cper;
+	struct amdgv_cper_index *entry;
+	uint32_t i;
+
+	*count = 0;
+	*bytes = 0;
+
+	if (rptr >= cper->wptr)
+		return;
+
+	entry = &cper->index[rptr % CPER_MAX_COUNT];
+	for (i = 0; i < CPER_SEV_NUM; i++) {
+		if (!(sev_mask & (1U << i)))
+			continue;
+		*count += cper->total_count[i] - entry->cum_count[i];
+		*bytes += cper->total_bytes[i] - entry->cum_bytes[i];
+	}
+}
+
+/* First record at or after rptr whose severity is in sev_mask, wptr if none */
+static uint64_t amdgv_cper_next_match(struct amdgv_adapter *adapt, uint64_t rptr,
+				      uint32_t sev_mask)
+{
+	struct amdgv_cper *cper = &adapt->cper;
+	struct amdgv_cper_index *entry;
+	uint64_t next = cper->wptr;
+	uint64_t rank, seq;
+	uint32_t i;
+
+	if (rptr >= cper->wptr)
+		return cper->wptr;
+
+	entry = &cper->index[rptr % CPER_MAX_COUNT];
+	for (i = 0; i < CPER_SEV_NUM; i++) {
+		if (!(sev_mask & (1U << i)))
+			continue;
+		/* Records of severity i before rptr give the rank of the next one */
+		rank = entry->cum_count[i];
+		if (rank == cper->total_count[i])
+			continue;
+		seq = cper->sev_seq[i][rank % CPER_MAX_COUNT];
+		if (seq < next)
+			next = seq;
+	}
+
+	return next;
+}
+
 int amdgv_cper_commit_entry(struct amdgv_adapter *adapt,
 			    struct cper_hdr *hdr)
 {
-	uint32_t wr_idx = 0;
+	struct amdgv_cper *cper = &adapt->cper;
+	struct amdgv_cper_index *entry;
+	uint32_t sev;
+	uint32_t i;
 
-	if (!adapt->cper.enabled)
+	if (!cper->reserve_size)
 		return AMDGV_FAILURE;
 
-	wr_idx = adapt->cper.wptr % CPER_MAX_COUNT;
+	sev = amdgv_cper_sev_idx(hdr->error_severity);
+
+	entry = &cper->index[cper->wptr % CPER_MAX_COUNT];
+	entry->offset = cper->reserve_offset;
+	entry->length = hdr->record_length;
+	for (i = 0; i < CPER_SEV_NUM; i++) {
+		entry->cum_count[i] = cper->total_count[i];
+		entry->cum_bytes[i] = cper->total_bytes[i];
+	}
+
+	cper->sev_seq[sev][cper->total_count[sev] % CPER_MAX_COUNT] = cper->wptr;
+	cper->total_count[sev]++;
+	cper->total_bytes[sev] += hdr->record_length;
+
+	cper->head = cper->reserve_offset + cper->reserve_size;
+	cper->reserve_size = 0;
 
-	if (adapt->cper.ring[wr_idx])
-		oss_free(adapt->cper.ring[wr_idx]);
+	cper->count++;
+	cper->wptr++;
 
-	adapt->cper.ring[wr_idx] = hdr;
-	adapt->cper.count++;
-	adapt->cper.wptr++;
+	oss_mutex_unlock(cper->lock);
 
 	return 0;
 }
@@ -359,9 +477,16 @@ struct cper_hdr *amdgv_cper_alloc_entry(struct amdgv_adapter *adapt,
 		return 0;
 	}
 
-	hdr = oss_zalloc(size);
+	size = roundup(size, 8);
+
+	/* Released by amdgv_cper_commit_entry() */
+	oss_mutex_lock(adapt->cper.lock);
+
+	hdr = amdgv_cper_ring_reserve(adapt, size);
 	if (!hdr) {
-		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_SYSTEM_MEM_FAIL, size);
+		oss_mutex_unlock(adapt->cper.lock);
+		AMDGV_ERROR("CPER of %d bytes exceeds the %d byte ring\n",
+			    size, adapt->cper.data_size);
 		return 0;
 	}
 
@@ -373,37 +498,79 @@ struct cper_hdr *amdgv_cper_alloc_entry(struct amdgv_adapter *adapt,
 
 int amdgv_cper_sw_init(struct amdgv_adapter *adapt)
 {
+	struct amdgv_cper *cper = &adapt->cper;
+	uint32_t i;
+
 	if (adapt->opt.max_cper_count < 0) {
-		adapt->cper.enabled = false;
+		cper->enabled = false;
 		return 0;
 	}
 
 	if (adapt->opt.max_cper_count > 0 &&
 	    adapt->opt.max_cper_count <= AMDGV_CPER_MAX_ALLOWED_COUNT)
-		adapt->cper.max_count = (uint64_t)adapt->opt.max_cper_count;
+		cper->max_count = (uint64_t)adapt->opt.max_cper_count;
 	else
-		adapt->cper.max_count = AMDGV_CPER_MAX_ALLOWED_COUNT;
+		cper->max_count = AMDGV_CPER_MAX_ALLOWED_COUNT;
+
+	cper->data_size = (uint32_t)(CPER_MAX_COUNT * CPER_RING_ENTRY_SIZE);
+	cper->data = oss_alloc_memory(cper->data_size);
+	cper->index = oss_alloc_memory((uint32_t)(CPER_MAX_COUNT *
+						  sizeof(struct amdgv_cper_index)));
+	for (i = 0; i < CPER_SEV_NUM; i++)
+		cper->sev_seq[i] = oss_alloc_memory((uint32_t)(CPER_MAX_COUNT *
+							       sizeof(uint64_t)));
+	cper->lock = oss_mutex_init();
+
+	if (!cper->data || !cper->index || !cper->sev_seq[0] ||
+	    !cper->sev_seq[1] || !cper->sev_seq[2] ||
+	    cper->lock == OSS_INVALID_HANDLE) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_SYSTEM_MEM_FAIL,
+				cper->data_size);
+		amdgv_cper_sw_fini(adapt);
+		return AMDGV_FAILURE;
+	}
 
-	adapt->cper.enabled = true;
+	cper->enabled = true;
 
 	return 0;
 }
 
 int amdgv_cper_sw_fini(struct amdgv_adapter *adapt)
 {
-	int i = 0;
+	struct amdgv_cper *cper = &adapt->cper;
+	uint32_t i;
 
-	adapt->cper.enabled = 0;
+	cper->enabled = 0;
 
-	for (i = 0; i < CPER_MAX_COUNT; i++) {
-		if (adapt->cper.ring[i]) {
-			oss_free(adapt->cper.ring[i]);
-			adapt->cper.ring[i] = NULL;
+	if (cper->lock != OSS_INVALID_HANDLE) {
+		oss_mutex_fini(cper->lock);
+		cper->lock = OSS_INVALID_HANDLE;
+	}
+
+	if (cper->data) {
+		oss_free_memory(cper->data);
+		cper->data = NULL;
+	}
+
+	if (cper->index) {
+		oss_free_memory(cper->index);
+		cper->index = NULL;
+	}
+
+	for (i = 0; i < CPER_SEV_NUM; i++) {
+		if (cper->sev_seq[i]) {
+			oss_free_memory(cper->sev_seq[i]);
+			cper->sev_seq[i] = NULL;
 		}
+		cper->total_count[i] = 0;
+		cper->total_bytes[i] = 0;
 	}
 
-	adapt->cper.count = 0;
-	adapt->cper.wptr = 0;
+	cper->count = 0;
+	cper->wptr = 0;
+	cper->rptr = 0;
+	cper->head = 0;
+	cper->reserve_size = 0;
 
 	return 0;
 }
@@ -413,50 +580,62 @@ int amdgv_cper_get_count(struct amdgv_adapter *adapt,
 			 uint64_t *avail_count,
 			 uint64_t *size)
 {
-	uint64_t i = 0;
+	oss_mutex_lock(adapt->cper.lock);
 
-	*size = 0;
+	if (rptr > adapt->cper.wptr)
+		rptr = adapt->cper.wptr;
+	rptr = CPER_MOVE_TO_FIRST_VALID(rptr);
 
-	*avail_count = adapt->cper.wptr - CPER_MOVE_TO_FIRST_VALID(rptr);
 	*wptr = adapt->cper.wptr;
+	amdgv_cper_window(adapt, rptr, AMDGV_CPER_SEV_MASK_ALL, avail_count, size);
 
-	for (i = CPER_MOVE_TO_FIRST_VALID(rptr); i < adapt->cper.wptr; i++)
-		*size += ((struct cper_hdr *)adapt->cper.ring[i % CPER_MAX_COUNT])->record_length;
+	oss_mutex_unlock(adapt->cper.lock);
 
 	return 0;
 }
 
 int amdgv_cper_get_entries(struct amdgv_adapter *adapt, uint64_t rptr,
+			   uint32_t sev_mask,
 			   void *buf, uint64_t buf_size,
+			   uint64_t max_entries,
 			   uint64_t *write_count,
 			   uint64_t *overflow_count,
-			   uint64_t *left_size)
+			   uint64_t *left_size,
+			   uint64_t *next_rptr)
 {
-	uint32_t offset = 0;
+	struct amdgv_cper_index *entry;
+	uint64_t offset = 0;
+	uint64_t left_count;
 	uint64_t i = 0;
-	struct cper_hdr *hdr;
 
 	*write_count = 0;
 	*overflow_count = 0;
-	*left_size = 0;
+
+	oss_mutex_lock(adapt->cper.lock);
+
+	if (rptr > adapt->cper.wptr)
+		rptr = adapt->cper.wptr;
 
 	*overflow_count = CPER_MOVE_TO_FIRST_VALID(rptr) - rptr;
 
-	/* Fill user buffer */
-	for (i = CPER_MOVE_TO_FIRST_VALID(rptr); i < adapt->cper.wptr; i++) {
-		hdr = (struct cper_hdr *)adapt->cper.ring[i % CPER_MAX_COUNT];
-		if (offset + hdr->record_length > buf_size)
+	/* Fill user buffer, skipping straight to each matching record */
+	for (i = amdgv_cper_next_match(adapt, CPER_MOVE_TO_FIRST_VALID(rptr), sev_mask);
+	     i < adapt->cper.wptr && *write_count < max_entries;
+	     i = amdgv_cper_next_match(adapt, i + 1, sev_mask)) {
+		entry = &adapt->cper.index[i % CPER_MAX_COUNT];
+		if (offset + entry->length > buf_size)
 			break;
-		oss_memcpy(((char *)buf + offset), hdr, hdr->record_length);
-		offset += hdr->record_length;
+		oss_memcpy(((char *)buf + offset), adapt->cper.data + entry->offset,
+			   entry->length);
+		offset += entry->length;
 		(*write_count)++;
 	}
 
 	/* Report remaining buffer size */
-	for (; i < adapt->cper.wptr; i++) {
-		hdr = (struct cper_hdr *)adapt->cper.ring[i % CPER_MAX_COUNT];
-		*left_size += hdr->record_length;
-	}
+	amdgv_cper_window(adapt, i, sev_mask, &left_count, left_size);
+	*next_rptr = i;
+
+	oss_mutex_unlock(adapt->cper.lock);
 
 	return 0;
 }
@@ -466,7 +645,11 @@ struct cper_hdr *amdgv_cper_get_ring_entry(struct amdgv_adapter *adapt, uint64_t
 	if (!adapt->cper.enabled)
 		return NULL;
 
-	return (struct cper_hdr *)adapt->cper.ring[rptr % CPER_MAX_COUNT];
+	if (rptr < adapt->cper.rptr || rptr >= adapt->cper.wptr)
+		return NULL;
+
+	return (struct cper_hdr *)(adapt->cper.data +
+				   adapt->cper.index[rptr % CPER_MAX_COUNT].offset);
 }
 
 enum amdgv_cper_type amdgv_cper_get_type(struct amdgv_adapter *adapt, struct cper_hdr *hdr, uint32_t idx)
@@ -41,7 +41,13 @@
 #define FATAL_SEC_OFFSET(count, idx)	(HDR_LEN + (SEC_DESC_LEN * count) + (FATAL_SEC_LEN * idx))
 #define NONSTD_SEC_OFFSET(count, idx)	(HDR_LEN + (SEC_DESC_LEN * count) + (NONSTD_SEC_LEN * idx))
 
-#define CPER_MOVE_TO_FIRST_VALID(rptr) (((adapt->cper.wptr - rptr) > CPER_MAX_COUNT) ? adapt->cper.wptr - CPER_MAX_COUNT : rptr)
+#define CPER_MOVE_TO_FIRST_VALID(rptr) (((rptr) < adapt->cper.rptr) ? adapt->cper.rptr : (rptr))
+
+/* Bit (1 << severity) selects records of that cper_error_severity */
+#define AMDGV_CPER_SEV_MASK_ALL		((1U << CPER_SEV_NUM) - 1)
+
+/* Ring bytes reserved per record slot, sized for a single section runtime CPER */
+#define CPER_RING_ENTRY_SIZE		(HDR_LEN + SEC_DESC_LEN + NONSTD_SEC_LEN)
 
 enum amdgv_cper_type {
 	AMDGV_CPER_TYPE_RUNTIME,
@@ -51,6 +57,18 @@ enum amdgv_cper_type {
 	AMDGV_CPER_TYPE_MAX,
 };
 
+/*
+ * Location of one record in the byte ring. The cumulative totals count every
+ * record committed before this one, per severity, so the number and size of
+ * the records between any rptr and wptr is a subtraction.
+ */
+struct amdgv_cper_index {
+	uint32_t offset;
+	uint32_t length;
+	uint64_t cum_count[CPER_SEV_NUM];
+	uint64_t cum_bytes[CPER_SEV_NUM];
+};
+
 struct amdgv_cper {
 	bool enabled;
 	atomic_t next_uid;
@@ -59,7 +77,28 @@ struct amdgv_cper {
 	uint64_t count;
 
 	uint64_t wptr;
-	void *ring[AMDGV_CPER_MAX_ALLOWED_COUNT];
+	/* Oldest record still held in the ring */
+	uint64_t rptr;
+
+	/*
+	 * Held from amdgv_cper_alloc_entry() until amdgv_cper_commit_entry(),
+	 * and by readers of the ring.
+	 */
+	mutex_t lock;
+
+	/* Records are stored back to back and never wrap around the end */
+	uint8_t *data;
+	uint32_t data_size;
+	uint32_t head;
+	uint32_t reserve_offset;
+	uint32_t reserve_size;
+
+	struct amdgv_cper_index *index;
+	/* Lifetime totals per severity */
+	uint64_t total_count[CPER_SEV_NUM];
+	uint64_t total_bytes[CPER_SEV_NUM];
+	/* Sequence number of the n-th record of each severity, indexed by n % max_count */
+	uint64_t *sev_seq[CPER_SEV_NUM];
 };
 
 void amdgv_cper_entry_fill_hdr(struct amdgv_adapter *adapt,
@@ -100,10 +139,13 @@ int amdgv_cper_get_count(struct amdgv_adapter *adapt,
 			 uint64_t *avail_count,
 			 uint64_t *size);
 int amdgv_cper_get_entries(struct amdgv_adapter *adapt, uint64_t rptr,
+			   uint32_t sev_mask,
 			   void *buf, uint64_t buf_size,
+			   uint64_t max_entries,
 			   uint64_t *write_count,
 			   uint64_t *overflow_count,
-			   uint64_t *left_size);
+			   uint64_t *left_size,
+			   uint64_t *next_rptr);
 
 
 struct cper_hdr *amdgv_cper_get_ring_entry(struct amdgv_adapter *adapt, uint64_t rptr);
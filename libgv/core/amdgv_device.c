@@ -32,6 +32,7 @@
 #include "amdgv_psp_gfx_if.h"
 #include "amdgv_ras.h"
 #include "amdgv_xgmi.h"
+#include "amdgv_init_sched.h"
 
 #include "hw/AI/ai.h"
 
@@ -514,6 +515,334 @@ static uint64_t amdgv_wait_get_timeout(uint64_t start, uint64_t timeout_all,
 	return now + ((timeout_phase < time_left) ? timeout_phase : time_left);
 }
 
+static const char *amdgv_wait_site_names[AMDGV_WAIT_SITE_MAX] = {
+	[AMDGV_WAIT_SITE_OTHER]            = "other",
+	[AMDGV_WAIT_SITE_REG]              = "reg",
+	[AMDGV_WAIT_SITE_MEM]              = "mem",
+	[AMDGV_WAIT_SITE_PCI_CFG]          = "pci_cfg",
+	[AMDGV_WAIT_SITE_GPUIOV_CMD]       = "gpuiov_cmd",
+	[AMDGV_WAIT_SITE_GPUIOV_FIRST_CMD] = "gpuiov_first_cmd",
+	[AMDGV_WAIT_SITE_PSP_REG]          = "psp_reg",
+	[AMDGV_WAIT_SITE_PSP_FENCE]        = "psp_fence",
+	[AMDGV_WAIT_SITE_MAILBOX_ACK]      = "mailbox_ack",
+	[AMDGV_WAIT_SITE_GUEST_RESET]      = "guest_reset",
+	[AMDGV_WAIT_SITE_CP_DMA]           = "cp_dma",
+	[AMDGV_WAIT_SITE_GFX_STATUS]       = "gfx_status",
+	[AMDGV_WAIT_SITE_SMU_REG]          = "smu_reg",
+};
+
+int amdgv_wait_sites_init(struct amdgv_adapter *adapt)
+{
+	/* sites with an IH source, without the event the site just polls */
+	adapt->wait_sites.site[AMDGV_WAIT_SITE_MAILBOX_ACK].irq_event = oss_event_init();
+	adapt->wait_sites.ready = true;
+
+	return 0;
+}
+
+void amdgv_wait_sites_fini(struct amdgv_adapter *adapt)
+{
+	struct amdgv_wait_site *site;
+	uint32_t i;
+
+	adapt->wait_sites.ready = false;
+
+	for (i = 0; i < AMDGV_WAIT_SITE_MAX; i++) {
+		site = &adapt->wait_sites.site[i];
+		if (site->irq_event != OSS_INVALID_HANDLE) {
+			oss_event_fini(site->irq_event);
+			site->irq_event = OSS_INVALID_HANDLE;
+		}
+	}
+}
+
+/* called by the IH handler of the interrupt a site waits for */
+void amdgv_wait_site_irq(struct amdgv_adapter *adapt, enum amdgv_wait_site_id site)
+{
+	if (site < AMDGV_WAIT_SITE_MAX &&
+	    adapt->wait_sites.site[site].irq_event != OSS_INVALID_HANDLE)
+		oss_signal_event(adapt->wait_sites.site[site].irq_event);
+}
+
+static void amdgv_wait_site_add(oss_atomic64_t *counter, uint64_t val)
+{
+	uint64_t old;
+
+	do {
+		old = oss_atomic_read(counter);
+	} while (oss_atomic_cmpxchg(counter, old, old + val) != old);
+}
+
+static void amdgv_wait_site_max(oss_atomic64_t *counter, uint64_t val)
+{
+	uint64_t old;
+
+	do {
+		old = oss_atomic_read(counter);
+		if (val <= old)
+			return;
+	} while (oss_atomic_cmpxchg(counter, old, val) != old);
+}
+
+/* upper bound of the bucket holding the given share of the successful waits */
+static uint32_t amdgv_wait_site_percentile(struct amdgv_wait_site *site, uint64_t waits,
+					   uint32_t percent)
+{
+	uint64_t rank = (waits * percent + 99) / 100;
+	uint64_t seen = 0;
+	uint32_t bucket;
+
+	if (waits == 0)
+		return 0;
+
+	for (bucket = 0; bucket < AMDGV_WAIT_SITE_BUCKETS - 1; bucket++) {
+		seen += oss_atomic_read(&site->bucket[bucket]);
+		if (seen >= rank)
+			break;
+	}
+
+	/* the last bucket has no bound, report the slowest wait */
+	if (bucket == AMDGV_WAIT_SITE_BUCKETS - 1)
+		return (uint32_t)oss_atomic_read(&site->max_us);
+
+	return 1U << bucket;
+}
+
+/* the counters are read one by one, a wait finishing meanwhile may show
+ * up in some of them only
+ */
+int amdgv_wait_sites_get_stats(struct amdgv_adapter *adapt, struct amdgv_wait_site_stats *stats)
+{
+	struct amdgv_wait_site *site;
+	uint64_t waits;
+	uint32_t i;
+
+	if (stats == NULL || !adapt->wait_sites.ready)
+		return AMDGV_FAILURE;
+
+	oss_memset(stats, 0, sizeof(*stats));
+	stats->num_sites = min(AMDGV_WAIT_SITE_MAX, AMDGV_WAIT_SITE_STATS_MAX);
+
+	for (i = 0; i < stats->num_sites; i++) {
+		site = &adapt->wait_sites.site[i];
+		oss_memcpy(stats->site[i].name, amdgv_wait_site_names[i],
+			   min(oss_strlen(amdgv_wait_site_names[i]),
+			       sizeof(stats->site[i].name) - 1));
+		stats->site[i].count = oss_atomic_read(&site->count);
+		stats->site[i].timeouts = oss_atomic_read(&site->timeouts);
+		stats->site[i].irq_wakeups = oss_atomic_read(&site->irq_wakeups);
+		stats->site[i].total_us = oss_atomic_read(&site->total_us);
+		stats->site[i].max_us = (uint32_t)oss_atomic_read(&site->max_us);
+		waits = stats->site[i].count > stats->site[i].timeouts ?
+			stats->site[i].count - stats->site[i].timeouts : 0;
+		stats->site[i].p50_us = amdgv_wait_site_percentile(site, waits, 50);
+		stats->site[i].p99_us = amdgv_wait_site_percentile(site, waits, 99);
+		stats->site[i].avg_us = site->avg8_us >> 3;
+		stats->site[i].dev_us = site->dev4_us >> 2;
+	}
+
+	return 0;
+}
+
+int amdgv_wait_sites_clear_stats(struct amdgv_adapter *adapt)
+{
+	struct amdgv_wait_site *site;
+	uint32_t i, bucket;
+
+	if (!adapt->wait_sites.ready)
+		return AMDGV_FAILURE;
+
+	for (i = 0; i < AMDGV_WAIT_SITE_MAX; i++) {
+		site = &adapt->wait_sites.site[i];
+		oss_atomic_set(&site->count, 0);
+		oss_atomic_set(&site->timeouts, 0);
+		oss_atomic_set(&site->irq_wakeups, 0);
+		oss_atomic_set(&site->total_us, 0);
+		oss_atomic_set(&site->max_us, 0);
+		for (bucket = 0; bucket < AMDGV_WAIT_SITE_BUCKETS; bucket++)
+			oss_atomic_set(&site->bucket[bucket], 0);
+	}
+
+	return 0;
+}
+
+static struct amdgv_wait_site *amdgv_wait_get_site(struct amdgv_adapter *adapt,
+						   uint32_t wait_flag)
+{
+	uint32_t site = AMDGV_WAIT_FLAG_GET_SITE(wait_flag);
+
+	if (!adapt || !adapt->wait_sites.ready || site >= AMDGV_WAIT_SITE_MAX)
+		return NULL;
+
+	return &adapt->wait_sites.site[site];
+}
+
+/* update the site telemetry, successful waits also teach the site its completion time */
+static void amdgv_wait_site_account(struct amdgv_adapter *adapt, struct amdgv_wait_site *site,
+				    uint64_t wait_us, bool timed_out)
+{
+	uint32_t us = (uint32_t)min(wait_us, (uint64_t)0xFFFFFFFF);
+	uint32_t avg_us, err_us;
+	uint32_t bucket;
+
+	if (!site)
+		return;
+
+	oss_atomic_inc(&site->count);
+	amdgv_wait_site_add(&site->total_us, us);
+	amdgv_wait_site_max(&site->max_us, us);
+
+	if (timed_out) {
+		oss_atomic_inc(&site->timeouts);
+		return;
+	}
+
+	for (bucket = 0; bucket < AMDGV_WAIT_SITE_BUCKETS - 1; bucket++)
+		if (us < (1U << bucket))
+			break;
+	oss_atomic_inc(&site->bucket[bucket]);
+
+	/* moving average with 1/8 gain, mean deviation with 1/4 gain */
+	if (site->samples == 0) {
+		site->avg8_us = us << 3;
+		site->dev4_us = (us / 2) << 2;
+	} else {
+		avg_us = site->avg8_us >> 3;
+		err_us = (us > avg_us) ? us - avg_us : avg_us - us;
+		site->avg8_us = site->avg8_us - avg_us + us;
+		site->dev4_us = site->dev4_us - (site->dev4_us >> 2) + err_us;
+	}
+	if (site->samples < AMDGV_WAIT_ADAPT_MIN_SAMPLES)
+		site->samples++;
+}
+
+/* forget interrupts raised before this wait started, a completion counts
+ * every signal and stale ones would end later pauses right away
+ */
+static void amdgv_wait_irq_arm(struct amdgv_wait_site *site, uint32_t wait_flag)
+{
+	if (site && site->irq_event != OSS_INVALID_HANDLE && (wait_flag & AMDGV_WAIT_FLAG_IRQ))
+		oss_reset_event(site->irq_event);
+}
+
+/* pause on the site interrupt, false if the caller has to delay or sleep
+ * itself. Pauses shorter than the event wait granularity are left to the
+ * caller, a missed interrupt would otherwise stretch them to a full tick.
+ * So is a wait cut short by a pending signal, which would come back at once
+ * for the rest of the wait and turn it into a busy poll.
+ */
+static bool amdgv_wait_irq_pause(struct amdgv_adapter *adapt, struct amdgv_wait_site *site,
+				 uint32_t wait_flag, uint64_t pause_us)
+{
+	if (!site || site->irq_event == OSS_INVALID_HANDLE ||
+	    !(wait_flag & AMDGV_WAIT_FLAG_IRQ) || pause_us < oss_wait_event_min_us())
+		return false;
+
+	switch (oss_wait_event(site->irq_event, (uint32_t)pause_us)) {
+	case OSS_EVENT_STATE_WAKE_UP:
+		oss_atomic_inc(&site->irq_wakeups);
+		return true;
+	case OSS_EVENT_STATE_TIMEOUT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Pause an adaptive wait for pause_us the way the regular phases would at
+ * this point of the wait that began at start: delay, or usleep for USLEEP
+ * callers, until the phase 1 threshold, then sleep like phase 2 does. Only
+ * AUTO callers sleep in phase 2, FORCE_DELAY and USLEEP callers keep
+ * delaying there as they always have. Pauses too short to sleep for are
+ * delayed.
+ */
+static void amdgv_wait_adaptive_pause(uint64_t start, uint64_t pause_us, uint32_t wait_flag)
+{
+	uint64_t phase1_us = 0, spin_us, elapsed, delay;
+
+	elapsed = oss_get_time_stamp() - start;
+	if (elapsed < AMDGV_WAIT_PHASE1_THRESHOLD_US)
+		phase1_us = min(pause_us, AMDGV_WAIT_PHASE1_THRESHOLD_US - elapsed);
+	pause_us -= phase1_us;
+
+	if (phase1_us > 10 && (wait_flag & AMDGV_WAIT_FLAG_USLEEP)) {
+		oss_usleep((uint32_t)phase1_us);
+		spin_us = 0;
+	} else {
+		spin_us = phase1_us;
+	}
+
+	if ((wait_flag & (AMDGV_WAIT_FLAG_FORCE_DELAY | AMDGV_WAIT_FLAG_USLEEP)) ||
+	    pause_us < AMDGV_WAIT_MIN_SLEEP_US) {
+		spin_us += pause_us;
+		pause_us = 0;
+	}
+
+	while (spin_us) {
+		delay = min(spin_us, (uint64_t)AMDGV_WAIT_MAX_DELAY_US);
+		oss_udelay((uint32_t)delay);
+		spin_us -= delay;
+	}
+
+	if (pause_us > AMDGV_WAIT_PHASE2_MSLEEP_THRESHOLD_US)
+		oss_msleep((uint32_t)(pause_us / 1000));
+	else if (pause_us)
+		oss_usleep((uint32_t)pause_us);
+}
+
+/*
+ * Wait for a site with a learned completion time: hold for the part of it
+ * that nearly every wait needs without touching the hardware, then poll
+ * at a fraction of the learned deviation until the learned time plus a
+ * few deviations.
+ * Only sites a caller tagged with AMDGV_WAIT_FLAG_SITE() adapt, the generic
+ * sites mix unrelated waits and only keep telemetry.
+ * Returns 0 when cb_func matched, non-zero when the caller should go on
+ * with the regular phases.
+ */
+static int amdgv_wait_adaptive(struct amdgv_adapter *adapt, struct amdgv_wait_site *site,
+			       amdgv_wait_cb_t cb_func, void *cb_context,
+			       uint64_t start, uint64_t timeout_us, uint32_t wait_flag)
+{
+	uint64_t avg_us, dev_us, hold_us, end, now, interval;
+
+	/* read without the lock, a stale average only costs a few polls */
+	if (!site || !adapt->opt.adaptive_wait ||
+	    AMDGV_WAIT_FLAG_GET_SITE(wait_flag) < AMDGV_WAIT_SITE_FIRST_TAGGED ||
+	    site->samples < AMDGV_WAIT_ADAPT_MIN_SAMPLES)
+		return AMDGV_FAILURE;
+
+	avg_us = site->avg8_us >> 3;
+	dev_us = site->dev4_us >> 2;
+	hold_us = (avg_us > 2 * dev_us) ? avg_us - 2 * dev_us : 0;
+	end = start + min(avg_us + 4 * dev_us, timeout_us);
+
+	if (hold_us >= AMDGV_WAIT_ADAPT_MIN_HOLD_US && hold_us < timeout_us) {
+		if (cb_func(cb_context) == 0)
+			return 0;
+
+		if (!amdgv_wait_irq_pause(adapt, site, wait_flag, hold_us))
+			amdgv_wait_adaptive_pause(start, hold_us, wait_flag);
+	}
+
+	interval = dev_us >> AMDGV_WAIT_ADAPT_POLL_SHIFT;
+	if (interval == 0)
+		interval = 1;
+
+	now = oss_get_time_stamp();
+	while (now < end) {
+		if (cb_func(cb_context) == 0)
+			return 0;
+		amdgv_wait_adaptive_pause(start, min(interval, end - now), wait_flag);
+		if (wait_flag & AMDGV_WAIT_FLAG_FORCE_YIELD)
+			oss_yield();
+		now = oss_get_time_stamp();
+	}
+
+	return AMDGV_FAILURE;
+}
+
 /*
 	amdgv_wait_for : wait for cb_func to return 0 or timeout.
 	input:
@@ -522,6 +851,7 @@ static uint64_t amdgv_wait_get_timeout(uint64_t start, uint64_t timeout_all,
 		cb_context: parameter which will be sent to cb_func
 		timeout_us: timeout value in us
 		wait_flag: config flag in waiting. Currently used to forcibly set wait function to udelay.
+			   AMDGV_WAIT_FLAG_SITE() names the caller for the adaptive wait and the telemetry.
 	output:
 		return: 0 as succeeded, AMDGV_WAIT_RET_TIMED_OUT as timed out, AMDGV_WAIT_RET_INVALID as invalid parameter.
 */
@@ -530,6 +860,7 @@ int amdgv_wait_for(struct amdgv_adapter *adapt, amdgv_wait_cb_t cb_func, void *c
 {
 	int interval;
 	uint64_t start, now, phase_timeout, sub_timeout, time_left;
+	struct amdgv_wait_site *site = NULL;
 	start = now = oss_get_time_stamp();
 
 	/* 2 special timeout values */
@@ -546,6 +877,12 @@ int amdgv_wait_for(struct amdgv_adapter *adapt, amdgv_wait_cb_t cb_func, void *c
 			return AMDGV_WAIT_RET_TIMED_OUT;
 	}
 
+	site = amdgv_wait_get_site(adapt, wait_flag);
+	amdgv_wait_irq_arm(site, wait_flag);
+	if (amdgv_wait_adaptive(adapt, site, cb_func, cb_context, start, timeout_us,
+				wait_flag) == 0)
+		goto success;
+
 	/* phase 1, delay in 0~AMDGV_WAIT_PHASE1_THRESHOLD_US */
 	interval = 2;
 	/* select phase 1 time out */
@@ -559,10 +896,12 @@ int amdgv_wait_for(struct amdgv_adapter *adapt, amdgv_wait_cb_t cb_func, void *c
 		while (now < sub_timeout && now < phase_timeout) {
 			if (cb_func(cb_context) == 0)
 				goto success;
-			if ((interval > 10) && (wait_flag & AMDGV_WAIT_FLAG_USLEEP))
-				oss_usleep(interval);
-			else
-				oss_udelay(interval);
+			if (!amdgv_wait_irq_pause(adapt, site, wait_flag, interval)) {
+				if ((interval > 10) && (wait_flag & AMDGV_WAIT_FLAG_USLEEP))
+					oss_usleep(interval);
+				else
+					oss_udelay(interval);
+			}
 			if (wait_flag & AMDGV_WAIT_FLAG_FORCE_YIELD) {
 				oss_yield();
 			}
@@ -595,16 +934,19 @@ int amdgv_wait_for(struct amdgv_adapter *adapt, amdgv_wait_cb_t cb_func, void *c
 			}
 		} else if (wait_flag & AMDGV_WAIT_FLAG_USLEEP)
 			oss_udelay(AMDGV_WAIT_MAX_DELAY_US);
-		else if (interval > AMDGV_WAIT_PHASE2_MSLEEP_THRESHOLD_US)
-			oss_msleep(interval / 1000);
-		else
-			oss_usleep(interval);
+		else if (!amdgv_wait_irq_pause(adapt, site, wait_flag, interval)) {
+			if (interval > AMDGV_WAIT_PHASE2_MSLEEP_THRESHOLD_US)
+				oss_msleep(interval / 1000);
+			else
+				oss_usleep(interval);
+		}
 
 		now = oss_get_time_stamp();
 	}
 	/* check again if last sleep successes */
 	if (cb_func(cb_context) == 0)
 		goto success;
+	amdgv_wait_site_account(adapt, site, now - start, true);
 	if (!(wait_flag & AMDGV_WAIT_FLAG_NO_WARNING)) {
 		if (adapt)
 			AMDGV_WARN("wait timed out after %ld us, timeout=%ld us\n", now - start,
@@ -616,6 +958,7 @@ int amdgv_wait_for(struct amdgv_adapter *adapt, amdgv_wait_cb_t cb_func, void *c
 	return AMDGV_WAIT_RET_TIMED_OUT;
 success:
 	time_left = oss_get_time_stamp() - start;
+	amdgv_wait_site_account(adapt, site, time_left, false);
 	if (adapt)
 		AMDGV_DEBUG("wait passed after %d us in %d us' timeout\n", time_left,
 				timeout_us);
@@ -668,6 +1011,8 @@ int amdgv_wait_for_register(struct amdgv_adapter *adapt, uint32_t offset, uint32
 	reg_context.mask = mask;
 	reg_context.value = value;
 	reg_context.check_flag = check_flag;
+	if (!AMDGV_WAIT_FLAG_GET_SITE(wait_flag))
+		wait_flag |= AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_REG);
 	if (adapt)
 		AMDGV_DEBUG("start wait for register 0x%x in timeout %ld us\n", offset,
 				timeout_us);
@@ -694,7 +1039,7 @@ int amdgv_wait_for_memory(struct amdgv_adapter *adapt, uint32_t *addr, uint32_t
 	if (adapt)
 		AMDGV_DEBUG("start wait for memory %p in timeout %ld us\n", addr, timeout_us);
 	return amdgv_wait_for(adapt, amdgv_wait_for_memory_cb, (void *)&mm_context, timeout_us,
-				  0);
+				  AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_MEM));
 }
 
 static int amdgv_wait_for_pci_cfg_cb(void *context)
@@ -769,6 +1114,8 @@ int amdgv_wait_for_pci_cfg(struct amdgv_adapter *adapt, oss_dev_t dev, uint32_t
 	cfg_context.value = value;
 	cfg_context.byte_len = byte_len;
 	cfg_context.check_flag = check_flag;
+	if (!AMDGV_WAIT_FLAG_GET_SITE(wait_flag))
+		wait_flag |= AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_PCI_CFG);
 	if (adapt)
 		AMDGV_DEBUG("start wait for pci cfg %p in timeout %ld us\n", offset,
 				timeout_us);
@@ -1038,7 +1385,7 @@ static const uint32_t amdgv_ranges[] = {
 	2354, 2915, 3609, 4470, 5535, 6855, 8489, 10513, 13019, 16122,
 };
 
-static void amdgv_init_histogram_range(struct amdgv_histogram *hist)
+void amdgv_init_histogram_range(struct amdgv_histogram *hist)
 {
 	int i;
 
@@ -1059,6 +1406,18 @@ static void amdgv_init_histogram_range(struct amdgv_histogram *hist)
 	hist->total = 0;
 }
 
+void amdgv_histogram_add(struct amdgv_histogram *hist, uint64_t val)
+{
+	int bucket;
+
+	for (bucket = 0; bucket < AMDGV_HISTOGRAM_SIZE - 1; bucket++)
+		if (val < hist->range[bucket])
+			break;
+
+	hist->count[bucket]++;
+	hist->total++;
+}
+
 void amdgv_time_log_increase_vf_reset_cnt(struct amdgv_adapter *adapt, uint32_t idx_vf)
 {
 	uint32_t hw_sched_id;
@@ -1211,14 +1570,124 @@ static void amdgv_init_histogram(struct amdgv_adapter *adapt)
 	}
 }
 
-#define MAX_INIT_FUNCS 50
+#define MAX_INIT_FUNCS AMDGV_INIT_TIMING_MAX_STAGE
+
+/* state shared by the init stages of one phase, see amdgv_init_sched.h */
+struct amdgv_device_init_ctx {
+	struct amdgv_adapter *adapt;
+	struct amdgv_init_sched sched;
+	bool imported_memmgr;
+	bool sw_init_complete[MAX_INIT_FUNCS];
+	bool hw_init_complete[MAX_INIT_FUNCS];
+};
+
+static int amdgv_device_init_ctx_alloc(struct amdgv_adapter *adapt,
+				       int (*run)(void *context, uint32_t idx),
+				       struct amdgv_device_init_ctx **out)
+{
+	struct amdgv_device_init_ctx *ctx;
+	int ret;
+
+	ctx = oss_zalloc(sizeof(*ctx));
+	if (!ctx) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_SYSTEM_MEM_FAIL,
+				sizeof(*ctx));
+		return AMDGV_FAILURE;
+	}
+
+	ctx->adapt = adapt;
+	ret = amdgv_init_sched_build(&ctx->sched, adapt->init_funcs, adapt->num_funcs);
+	if (ret) {
+		AMDGV_ERROR("cannot schedule %u init stages\n", adapt->num_funcs);
+		oss_free(ctx);
+		return ret;
+	}
+	ctx->sched.dev = adapt->dev;
+	/* live update imports state between the stages, keep the table order */
+	ctx->sched.parallel = adapt->opt.parallel_init && !adapt->opt.skip_hw_init;
+	ctx->sched.run = run;
+	ctx->sched.context = ctx;
+
+	*out = ctx;
+	return 0;
+}
+
+static void amdgv_device_record_init_timing(struct amdgv_adapter *adapt,
+					    struct amdgv_init_sched *sched, bool sw)
+{
+	struct amdgv_init_timing *timing = &adapt->init_timing;
+	struct amdgv_init_sched_stage *stage;
+	uint32_t us;
+	uint32_t i;
+
+	for (i = 0; i < sched->num_stages; i++) {
+		stage = &sched->stage[i];
+		if (!stage->ran)
+			continue;
+		/* hw_priority entries did their hw_init during sw init */
+		if (!sw && adapt->init_funcs[i]->hw_priority)
+			continue;
+
+		us = (uint32_t)(stage->end_us - stage->start_us);
+		if (sw) {
+			timing->stage[i].sw_init_us = us;
+			timing->stage[i].sw_start_us = (uint32_t)stage->start_us;
+		} else {
+			timing->stage[i].hw_init_us = us;
+		}
+		amdgv_histogram_add(&timing->stage_us, us);
+	}
+
+	if (sw) {
+		timing->sw_total_us = sched->total_us;
+		timing->sw_critical_path_us = sched->critical_path_us;
+	} else {
+		timing->hw_total_us = sched->total_us;
+		timing->hw_critical_path_us = sched->critical_path_us;
+	}
+
+	AMDGV_INFO("%s init took %lluus, critical path %lluus\n", sw ? "sw" : "hw",
+		   sched->total_us, sched->critical_path_us);
+}
+
+static int amdgv_device_sw_init_stage(void *context, uint32_t idx)
+{
+	struct amdgv_device_init_ctx *ctx = (struct amdgv_device_init_ctx *)context;
+	struct amdgv_adapter *adapt = ctx->adapt;
+	struct amdgv_init_func *init_func = adapt->init_funcs[idx];
+
+	AMDGV_INFO("start sw_init of %s\n", init_func->name);
+	if (init_func->sw_init && init_func->sw_init(adapt) < 0) {
+		amdgv_print_failed_init_name(adapt, true, init_func->name);
+		return AMDGV_FAILURE;
+	}
+	ctx->sw_init_complete[idx] = true;
+
+	if (adapt->opt.skip_hw_init && adapt->memmgr_pf.is_init && !ctx->imported_memmgr) {
+		if (amdgv_import_data_by_op(adapt, AMDGV_LIVE_INFO_DATA__MEMMGR)) {
+			init_func->sw_fini(adapt);
+			init_func->sw_init(adapt);
+		}
+		ctx->imported_memmgr = true;
+	}
+
+	if (init_func->hw_priority) {
+		AMDGV_INFO("start hw_init of %s\n", init_func->name);
+		if (init_func->hw_init && init_func->hw_init(adapt) < 0) {
+			amdgv_print_failed_init_name(adapt, false, init_func->name);
+			return AMDGV_FAILURE;
+		}
+		ctx->hw_init_complete[idx] = true;
+	}
+
+	return 0;
+}
+
 static int amdgv_device_func_sw_init(struct amdgv_adapter *adapt)
 {
-	int i, j;
-	struct amdgv_init_func *init_func;
-	bool imported_memmgr = false;
-	bool sw_init_complete[MAX_INIT_FUNCS] = { 0 };
-	bool hw_init_complete[MAX_INIT_FUNCS] = { 0 };
+	int i, j, ret;
+	struct amdgv_device_init_ctx *ctx;
+	struct amdgv_init_timing *timing = &adapt->init_timing;
 
 	if (amdgv_error_init(adapt) == AMDGV_FAILURE) {
 		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ERROR_LOGGING_FAILED, 0);
@@ -1231,33 +1700,26 @@ static int amdgv_device_func_sw_init(struct amdgv_adapter *adapt)
 		return AMDGV_FAILURE;
 	}
 
-	/* sw init */
-	for (i = 0; i < adapt->num_funcs; i++) {
-		init_func = adapt->init_funcs[i];
-		AMDGV_INFO("start sw_init of %s\n", init_func->name);
-		if (init_func->sw_init && init_func->sw_init(adapt) < 0) {
-			amdgv_print_failed_init_name(adapt, true, init_func->name);
-			goto init_fail;
-		}
-		sw_init_complete[i] = true;
+	ret = amdgv_device_init_ctx_alloc(adapt, amdgv_device_sw_init_stage, &ctx);
+	if (ret) {
+		amdgv_error_fini(adapt);
+		return ret;
+	}
 
-		if (adapt->opt.skip_hw_init && adapt->memmgr_pf.is_init && !imported_memmgr) {
-			if (amdgv_import_data_by_op(adapt, AMDGV_LIVE_INFO_DATA__MEMMGR)) {
-				init_func->sw_fini(adapt);
-				init_func->sw_init(adapt);
-			}
-			imported_memmgr = true;
-		}
+	oss_memset(timing, 0, sizeof(*timing));
+	amdgv_init_histogram_range(&timing->stage_us);
+	timing->num_stages = adapt->num_funcs;
+	for (i = 0; i < adapt->num_funcs; i++)
+		oss_memcpy(timing->stage[i].name, adapt->init_funcs[i]->name,
+			   sizeof(timing->stage[i].name));
 
-		if (init_func->hw_priority) {
-			AMDGV_INFO("start hw_init of %s\n", init_func->name);
-			if (init_func->hw_init && init_func->hw_init(adapt) < 0) {
-				amdgv_print_failed_init_name(adapt, false, init_func->name);
-				goto init_fail;
-			}
-			hw_init_complete[i] = true;
-		}
-	}
+	/* sw init */
+	i = amdgv_init_sched_run(&ctx->sched);
+	amdgv_device_record_init_timing(adapt, &ctx->sched, true);
+	if (i < 0)
+		goto init_fail;
+
+	oss_free(ctx);
 
 	/* histogram init*/
 	amdgv_init_histogram(adapt);
@@ -1265,39 +1727,69 @@ static int amdgv_device_func_sw_init(struct amdgv_adapter *adapt)
 	return 0;
 
 init_fail:
-	for (j = i; j >= 0; j--) {
+	/* reverse table order, dependencies always come earlier in the table */
+	for (j = adapt->num_funcs - 1; j >= 0; j--) {
 		/* hw fini */
-		if (adapt->init_funcs[j]->hw_priority && hw_init_complete[j]) {
+		if (adapt->init_funcs[j]->hw_priority && ctx->hw_init_complete[j]) {
 			if (adapt->init_funcs[j]->hw_fini) {
 				AMDGV_INFO("start hw_fini of %s\n",
 					   adapt->init_funcs[j]->name);
 				adapt->init_funcs[j]->hw_fini(adapt);
-				hw_init_complete[j] = false;
+				ctx->hw_init_complete[j] = false;
 			}
 		}
 		/* sw fini */
-		if (adapt->init_funcs[j]->sw_fini && sw_init_complete[j]) {
+		if (adapt->init_funcs[j]->sw_fini && ctx->sw_init_complete[j]) {
 			AMDGV_INFO("start sw_fini of %s\n", adapt->init_funcs[j]->name);
 			adapt->init_funcs[j]->sw_fini(adapt);
-			sw_init_complete[j] = false;
+			ctx->sw_init_complete[j] = false;
 		}
 	}
 
+	oss_free(ctx);
 	amdgv_error_fini(adapt);
 
 	return AMDGV_FAILURE;
 }
 
+static int amdgv_device_hw_init_stage(void *context, uint32_t idx)
+{
+	struct amdgv_device_init_ctx *ctx = (struct amdgv_device_init_ctx *)context;
+	struct amdgv_adapter *adapt = ctx->adapt;
+	struct amdgv_init_func *init_func = adapt->init_funcs[idx];
+
+	if (init_func->hw_priority) {
+		ctx->hw_init_complete[idx] = true;
+		return 0;
+	}
+
+	if (init_func->hw_init) {
+		AMDGV_INFO("start hw_init of %s\n", init_func->name);
+		if (init_func->hw_init(adapt) < 0) {
+			amdgv_print_failed_init_name(adapt, false, init_func->name);
+			return AMDGV_FAILURE;
+		}
+	} else if (init_func->hw_engine_init) {
+		AMDGV_INFO("start hw_engine_init of %s\n", init_func->name);
+		if (init_func->hw_engine_init(adapt) < 0) {
+			amdgv_print_failed_init_name(adapt, false, init_func->name);
+			return AMDGV_FAILURE;
+		}
+	}
+	ctx->hw_init_complete[idx] = true;
+
+	return 0;
+}
+
 static int amdgv_device_func_hw_init(struct amdgv_adapter *adapt)
 {
-	int j;
-	struct amdgv_init_func *init_func;
+	int j, ret;
+	struct amdgv_device_init_ctx *ctx;
 
 	if (adapt->opt.skip_hw_init) {
 		AMDGV_INFO("Skip hw init for live update.\n");
 
 		if (adapt->flags & AMDGV_FLAG_GPUV_LIVE_UPDATE) {
-			int ret;
 			uint32_t world_switch_id;
 			uint32_t hw_sched_id;
 			struct amdgv_sched_world_switch *world_switch;
@@ -1332,30 +1824,20 @@ static int amdgv_device_func_hw_init(struct amdgv_adapter *adapt)
 	}
 
 	/* hw init */
-	for (j = 0; j < adapt->num_funcs; j++) {
-		init_func = adapt->init_funcs[j];
-
-		if (init_func->hw_priority)
-			continue;
+	ret = amdgv_device_init_ctx_alloc(adapt, amdgv_device_hw_init_stage, &ctx);
+	if (ret)
+		return ret;
 
-		if (init_func->hw_init) {
-			AMDGV_INFO("start hw_init of %s\n", init_func->name);
-			if (init_func->hw_init(adapt) < 0) {
-				amdgv_print_failed_init_name(adapt, false, init_func->name);
-				goto hw_init_fail;
-			}
-		} else if (init_func->hw_engine_init) {
-			AMDGV_INFO("start hw_engine_init of %s\n", init_func->name);
-			if (init_func->hw_engine_init(adapt) < 0) {
-				amdgv_print_failed_init_name(adapt, false, init_func->name);
-				goto hw_init_fail;
-			}
-		}
-	}
+	ret = amdgv_init_sched_run(&ctx->sched);
+	amdgv_device_record_init_timing(adapt, &ctx->sched, false);
+	if (ret < 0)
+		goto hw_init_fail;
 
 	if (adapt->continue_init_other_block_hw == true)
 		goto hw_init_fail;
 
+	oss_free(ctx);
+
 	return 0;
 
 hw_init_fail:
@@ -1364,7 +1846,9 @@ hw_init_fail:
 	if (amdgv_diag_data_cache_dump(adapt, AMDGV_PF_IDX,
 						AMDGV_DIAG_DATA_LOG_COLLECT_CACHE_INIT_FAIL))
 		AMDGV_WARN("Can't collect HW init fail debug log\n");
-	for (j = j - 1; j >= 0; j--) {
+	for (j = adapt->num_funcs - 1; j >= 0; j--) {
+		if (!ctx->hw_init_complete[j])
+			continue;
 		if (adapt->init_funcs[j]->hw_fini) {
 			AMDGV_INFO("start hw_fini of %s\n", adapt->init_funcs[j]->name);
 			adapt->init_funcs[j]->hw_fini(adapt);
@@ -1374,6 +1858,8 @@ hw_init_fail:
 		}
 	}
 
+	oss_free(ctx);
+
 	return AMDGV_FAILURE;
 }
 
@@ -1481,6 +1967,8 @@ static void amdgv_device_cleanup(struct amdgv_adapter *adapt)
 		adapt->smu_msg_lock = OSS_INVALID_HANDLE;
 	}
 
+	amdgv_wait_sites_fini(adapt);
+
 	if (adapt->api_lock != OSS_INVALID_HANDLE) {
 		oss_mutex_fini(adapt->api_lock);
 		adapt->api_lock = OSS_INVALID_HANDLE;
@@ -1516,6 +2004,13 @@ static void amdgv_device_cleanup(struct amdgv_adapter *adapt)
 		adapt->bp_lock = OSS_INVALID_HANDLE;
 	}
 
+	amdgv_gpumon_sw_fini(adapt);
+
+	if (adapt->live_migration.chunked.lock != OSS_INVALID_HANDLE) {
+		oss_rwsema_fini(adapt->live_migration.chunked.lock);
+		adapt->live_migration.chunked.lock = OSS_INVALID_HANDLE;
+	}
+
 	for (i = 0; i < AMDGV_MAX_NUM_HW_SCHED; ++i) {
 		if (adapt->sched.hw_state_machine[i].ws_lock != OSS_INVALID_HANDLE) {
 			oss_rwsema_fini(adapt->sched.hw_state_machine[i].ws_lock);
@@ -1622,6 +2117,9 @@ struct amdgv_adapter *amdgv_device_internal_init(struct amdgv_init_data *init_da
 		goto fail;
 	}
 
+	if (amdgv_wait_sites_init(adapt))
+		goto fail;
+
 	adapt->api_lock = oss_mutex_init();
 	if (adapt->api_lock == OSS_INVALID_HANDLE) {
 		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_MUTEX_FAIL, 0);
@@ -1664,6 +2162,15 @@ struct amdgv_adapter *amdgv_device_internal_init(struct amdgv_init_data *init_da
 		goto fail;
 	}
 
+	if (amdgv_gpumon_sw_init(adapt))
+		goto fail;
+
+	adapt->live_migration.chunked.lock = oss_rwsema_init();
+	if (adapt->live_migration.chunked.lock == OSS_INVALID_HANDLE) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_RWSEMA_FAIL, 0);
+		goto fail;
+	}
+
 	for (i = 0; i < AMDGV_MAX_NUM_HW_SCHED; ++i) {
 		adapt->sched.hw_state_machine[i].ws_lock = oss_rwsema_init();
 		if (adapt->sched.hw_state_machine[i].ws_lock == OSS_INVALID_HANDLE) {
@@ -329,6 +329,10 @@ struct amdgv_init_func {
 	int (*post_reset)(struct amdgv_adapter *adapt);
 	/* clean up before reset */
 	int (*pre_reset)(struct amdgv_adapter *adapt);
+	/* NULL terminated list of entries whose init must finish first,
+	 * NULL means every entry before this one, see amdgv_init_sched.h
+	 */
+	const struct amdgv_init_func *const *deps;
 };
 
 struct amdgv_live_info_func {
@@ -535,6 +539,54 @@ struct amdgv_vf_fb_block {
     struct amdgv_list_head vf_fb_block_node; //List of allocated fb blocks
 };
 
+/* callers of the amdgv_wait_for family, see AMDGV_WAIT_FLAG_SITE() */
+enum amdgv_wait_site_id {
+	AMDGV_WAIT_SITE_OTHER = 0,
+	AMDGV_WAIT_SITE_REG,
+	AMDGV_WAIT_SITE_MEM,
+	AMDGV_WAIT_SITE_PCI_CFG,
+	AMDGV_WAIT_SITE_GPUIOV_CMD,
+	AMDGV_WAIT_SITE_GPUIOV_FIRST_CMD,
+	AMDGV_WAIT_SITE_PSP_REG,
+	AMDGV_WAIT_SITE_PSP_FENCE,
+	AMDGV_WAIT_SITE_MAILBOX_ACK,
+	AMDGV_WAIT_SITE_GUEST_RESET,
+	AMDGV_WAIT_SITE_CP_DMA,
+	AMDGV_WAIT_SITE_GFX_STATUS,
+	AMDGV_WAIT_SITE_SMU_REG,
+	AMDGV_WAIT_SITE_MAX
+};
+
+/* the sites before this one are shared by untagged callers, telemetry only */
+#define AMDGV_WAIT_SITE_FIRST_TAGGED AMDGV_WAIT_SITE_GPUIOV_CMD
+
+/* waits of one site fall in bucket n when they took less than 2^n us */
+#define AMDGV_WAIT_SITE_BUCKETS 24
+
+struct amdgv_wait_site {
+	/* learned completion time and its mean deviation, in 1/8 and 1/4 us.
+	 * Updated without a lock, concurrent waits may lose an update.
+	 */
+	uint32_t avg8_us;
+	uint32_t dev4_us;
+	uint32_t samples;
+	/* signaled by the IH handler of the site's interrupt, if there is one */
+	event_t irq_event;
+
+	/* telemetry, every wait updates it so it stays lock free */
+	oss_atomic64_t count;
+	oss_atomic64_t timeouts;
+	oss_atomic64_t irq_wakeups;
+	oss_atomic64_t total_us;
+	oss_atomic64_t max_us;
+	oss_atomic64_t bucket[AMDGV_WAIT_SITE_BUCKETS];
+};
+
+struct amdgv_wait_sites {
+	bool ready;
+	struct amdgv_wait_site site[AMDGV_WAIT_SITE_MAX];
+};
+
 struct amdgv_adapter {
 	oss_dev_t         dev;
 	uint32_t          domain; // not used
@@ -653,6 +705,7 @@ struct amdgv_adapter {
 	spin_lock_t mmio_idx_lock;
 	spin_lock_t pcie_idx_lock;
 	spin_lock_t smu_msg_lock;
+	struct amdgv_wait_sites wait_sites;
 	mutex_t api_lock;
 	mutex_t hive_lock;
 	mutex_t gpumon_hive_lock;
@@ -754,6 +807,8 @@ struct amdgv_adapter {
 	event_t new_error_event;
 	struct amdgv_error_notifier notifier_list;
 	mutex_t notifier_list_lock;
+	/* highest mask level any notifier accepts, per category */
+	uint8_t notifier_level_index[AMDGV_ERROR_CATEGORY_MAX];
 	uint32_t error_dump_stack_max;
 	uint32_t error_dump_stack_count;
 	uint32_t error_dump_stack_filter_list[AMDGV_ERROR_FILTER_LIST_SIZE_MAX];
@@ -787,6 +842,8 @@ struct amdgv_adapter {
 	/* used for live update to store and compare the hash */
 	uint64_t hash_addr;
 	bool in_chain_live_update;
+	struct amdgv_live_info_timing live_info_timing;
+	struct amdgv_init_timing init_timing;
 
 	struct amdgv_mmsch mmsch;
 	struct amdgv_smuio smuio;
@@ -941,6 +998,12 @@ void amdgv_gpuiov_record_queue_push(struct amdgv_adapter *adapt, uint32_t idx_vf
 #define AMDGV_WAIT_FLAG_FORCE_YIELD     (1 << 1)     /* force append an yield after delay, prevent some register to be read to die */
 #define AMDGV_WAIT_FLAG_USLEEP          (1 << 2)     /* use udelay for the 1st loop (200us) but switch to usleep for the rest loops to release CPU */
 #define AMDGV_WAIT_FLAG_NO_WARNING      (1 << 3)     /* disable warning message when timeout, used when timeout is possible but not an exception */
+#define AMDGV_WAIT_FLAG_IRQ             (1 << 4)     /* the caller may sleep on the interrupt of its wait site between polls */
+
+/* the wait site of the caller lives in the top byte of the wait flag */
+#define AMDGV_WAIT_FLAG_SITE_SHIFT      24
+#define AMDGV_WAIT_FLAG_SITE(site)      ((uint32_t)(site) << AMDGV_WAIT_FLAG_SITE_SHIFT)
+#define AMDGV_WAIT_FLAG_GET_SITE(flag)  ((flag) >> AMDGV_WAIT_FLAG_SITE_SHIFT)
 
 /* return value */
 #define AMDGV_WAIT_RET_TIMED_OUT        -1
@@ -958,6 +1021,15 @@ void amdgv_gpuiov_record_queue_push(struct amdgv_adapter *adapt, uint32_t idx_vf
 /* phase 2 property */
 #define AMDGV_WAIT_PHASE2_MSLEEP_THRESHOLD_US       (5000)           /* if interval bigger than this value, use msleep */
 
+/* adaptive property, a site with a learned completion time first waits
+ * out the part of it that is nearly always needed, then polls finely
+ * until the completion time plus a few deviations, then falls back to
+ * the phases above
+ */
+#define AMDGV_WAIT_ADAPT_MIN_SAMPLES                (8)              /* successful waits before the site is trusted */
+#define AMDGV_WAIT_ADAPT_MIN_HOLD_US                (4)              /* do not bother holding for less */
+#define AMDGV_WAIT_ADAPT_POLL_SHIFT                 (2)              /* poll every 1/4 deviation around the learned time */
+
 /* mode for common wait */
 #define AMDGV_WAIT_CHECK_EQ				0				/* check for equal */
 #define AMDGV_WAIT_CHECK_NE				1				/* check for not-equal */
@@ -996,6 +1068,11 @@ int amdgv_wait_for_irq_handler(void *context);
 int amdgv_wait_for_register(struct amdgv_adapter *adapt, uint32_t offset, uint32_t mask, uint32_t value, uint64_t timeout_us, uint32_t check_flag, uint32_t wait_flag);
 int amdgv_wait_for_memory(struct amdgv_adapter *adapt, uint32_t *addr, uint32_t value, uint64_t timeout_us);
 int amdgv_wait_for_pci_cfg(struct amdgv_adapter *adapt, oss_dev_t dev, uint32_t offset, uint32_t mask, uint32_t value, uint8_t byte_len, uint64_t timeout_us, uint32_t check_flag, uint32_t wait_flag);
+int amdgv_wait_sites_init(struct amdgv_adapter *adapt);
+void amdgv_wait_sites_fini(struct amdgv_adapter *adapt);
+void amdgv_wait_site_irq(struct amdgv_adapter *adapt, enum amdgv_wait_site_id site);
+int amdgv_wait_sites_get_stats(struct amdgv_adapter *adapt, struct amdgv_wait_site_stats *stats);
+int amdgv_wait_sites_clear_stats(struct amdgv_adapter *adapt);
 
 /* --------------- WAIT END --------------*/
 
@@ -1213,6 +1290,8 @@ int amdgv_hw_sched_init(struct amdgv_adapter *adapt);
 int amdgv_sched_shutdown_vf(struct amdgv_adapter *adapt, uint32_t idx_vf);
 void amdgv_print_failed_init_name(struct amdgv_adapter *adapt, bool is_sw, const char *func_name);
 struct amdgv_hive_info *amdgv_get_xgmi_hive(struct amdgv_adapter *adapt);
+void amdgv_init_histogram_range(struct amdgv_histogram *hist);
+void amdgv_histogram_add(struct amdgv_histogram *hist, uint64_t val);
 void amdgv_time_log_increase_vf_reset_cnt(struct amdgv_adapter *adapt, uint32_t idx_vf);
 void amdgv_time_log_clear_vf(struct amdgv_adapter *adapt, uint32_t idx_vf);
 void amdgv_time_log_note_vf_init_start(struct amdgv_adapter *adapt, uint32_t idx_vf);
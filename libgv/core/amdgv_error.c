@@ -60,6 +60,26 @@ static void amdgv_error_list_sanity_test(struct amdgv_adapter *adapt)
 	}
 }
 
+/* called with notifier_list_lock held */
+static void amdgv_error_notifier_index_rebuild(struct amdgv_adapter *adapt)
+{
+	struct amdgv_error_notifier *notifier;
+	uint8_t *index = adapt->notifier_level_index;
+	uint32_t category;
+
+	oss_memset(index, AMDGV_ERROR_NOTIFIER_LEVEL_NONE, sizeof(adapt->notifier_level_index));
+	amdgv_list_for_each_entry (notifier, &adapt->notifier_list.head,
+				   struct amdgv_error_notifier, head) {
+		for (category = 0; category < AMDGV_ERROR_CATEGORY_MAX; category++) {
+			if (!((1ULL << category) & notifier->mask_category))
+				continue;
+			if (index[category] == AMDGV_ERROR_NOTIFIER_LEVEL_NONE ||
+			    index[category] < notifier->mask_level)
+				index[category] = notifier->mask_level;
+		}
+	}
+}
+
 int amdgv_error_alloc_new_notifier(amdgv_dev_t dev, uint64_t event_mask, void *priv,
 				   struct amdgv_error_notifier **ctx)
 {
@@ -73,17 +93,23 @@ int amdgv_error_alloc_new_notifier(amdgv_dev_t dev, uint64_t event_mask, void *p
 		return AMDGV_FAILURE;
 
 	err_rb = oss_zalloc(sizeof(struct amdgv_error_ring_buffer));
-	if (err_rb == OSS_INVALID_HANDLE)
+	if (err_rb == OSS_INVALID_HANDLE) {
+		oss_free(notifier);
 		return AMDGV_FAILURE;
+	}
 
 	notifier = (struct amdgv_error_notifier *)notifier;
 	err_rb = (struct amdgv_error_ring_buffer *)err_rb;
 	AMDGV_INIT_LIST_HEAD(&notifier->head);
 	notifier->event_mask = event_mask;
+	notifier->mask_category = AMDGV_ERROR_MASK_CATEGORY(event_mask);
+	notifier->mask_level = AMDGV_ERROR_MASK_SEVERITY(event_mask);
+	notifier->batch_count = 0;
 	notifier->error_ring_buffer = err_rb;
 	notifier->priv = priv;
 	oss_mutex_lock(adapt->notifier_list_lock);
 	amdgv_list_add_tail(&notifier->head, &adapt->notifier_list.head);
+	amdgv_error_notifier_index_rebuild(adapt);
 	oss_mutex_unlock(adapt->notifier_list_lock);
 	*ctx = notifier;
 
@@ -104,6 +130,7 @@ void amdgv_error_delete_notifier(amdgv_dev_t dev, struct amdgv_error_notifier *n
 
 	oss_mutex_lock(adapt->notifier_list_lock);
 	amdgv_list_del(&notifier->head);
+	amdgv_error_notifier_index_rebuild(adapt);
 	oss_mutex_unlock(adapt->notifier_list_lock);
 
 	oss_free(notifier->error_ring_buffer);
@@ -124,28 +151,33 @@ static void amdgv_error_copy_error(struct amdgv_adapter *adapt,
 	index = AMDGV_ERROR_INDEX(err_rb->write_count);
 	if (entry) {
 		err_rb->error_entry_buffer[index] = *entry;
+		/* the consumer reads without a lock, publish the entry first */
+		oss_memory_fence();
 		err_rb->write_count++;
+		notifier->batch_count++;
 	} else
 		AMDGV_WARN("Assignment of uninitialized entry attempted.\n");
 }
 
-static bool amdgv_error_check_mask(uint32_t error_code, uint64_t event_mask)
+static uint8_t amdgv_error_mask_level(uint32_t error_code)
 {
 	uint8_t error_category = AMDGV_ERROR_CATEGORY(error_code);
 	uint16_t error_sub_code = AMDGV_ERROR_SUBCODE(error_code);
 	const struct error_text *error_text;
-	uint8_t error_level;
-
-	uint64_t mask_category = AMDGV_ERROR_MASK_CATEGORY(event_mask);
-	uint8_t mask_level = AMDGV_ERROR_MASK_SEVERITY(event_mask);
 
 	error_text = &amdgv_error_list[error_category].error_msg[error_sub_code];
-	error_level = AMDGV_SHIFT_ERROR_SEVERITY_LEVEL(error_text->severity);
 
+	return AMDGV_SHIFT_ERROR_SEVERITY_LEVEL(error_text->severity);
+}
+
+static bool amdgv_error_check_mask(struct amdgv_error_notifier *notifier,
+				   uint8_t error_category, uint8_t error_level)
+{
 	/* mask level 0xF means including all events,
 	 * mask level 0x0 means only including high severity error events
 	 * other mask levels are in between */
-	if (((1ULL << error_category) & mask_category) && (mask_level >= error_level))
+	if (((1ULL << error_category) & notifier->mask_category) &&
+	    (notifier->mask_level >= error_level))
 		return true;
 
 	return false;
@@ -160,9 +192,12 @@ static void amdgv_error_iterate_ring_buffer(struct amdgv_adapter *adapt, uint32_
 
 	struct amdgv_error_entry overflow_entry = { 0 };
 	uint32_t wr_diff;
+	uint8_t error_category, error_level, index_level;
 
 	err_rb = adapt->error_ring_buffer;
 
+	/* the whole batch is dispatched under a single hold of the list lock */
+	oss_mutex_lock(adapt->notifier_list_lock);
 	while (write_count != err_rb->read_count) {
 		wr_diff = write_count - err_rb->read_count;
 
@@ -199,14 +234,20 @@ static void amdgv_error_iterate_ring_buffer(struct amdgv_adapter *adapt, uint32_
 			entry = &err_rb->error_entry_buffer[index];
 		}
 
-		oss_mutex_lock(adapt->notifier_list_lock);
+		/* skip the notifier walk when nobody accepts this event */
+		error_category = AMDGV_ERROR_CATEGORY(entry->error_code);
+		error_level = amdgv_error_mask_level(entry->error_code);
+		index_level = adapt->notifier_level_index[error_category];
+		if (index_level == AMDGV_ERROR_NOTIFIER_LEVEL_NONE || index_level < error_level)
+			continue;
+
 		amdgv_list_for_each_entry (notifier, &adapt->notifier_list.head,
 					   struct amdgv_error_notifier, head) {
-			if (amdgv_error_check_mask(entry->error_code, notifier->event_mask))
+			if (amdgv_error_check_mask(notifier, error_category, error_level))
 				amdgv_error_copy_error(adapt, notifier, entry);
 		}
-		oss_mutex_unlock(adapt->notifier_list_lock);
 	}
+	oss_mutex_unlock(adapt->notifier_list_lock);
 }
 
 static void amdgv_error_notify_users(struct amdgv_adapter *adapt)
@@ -216,6 +257,9 @@ static void amdgv_error_notify_users(struct amdgv_adapter *adapt)
 	oss_mutex_lock(adapt->notifier_list_lock);
 	amdgv_list_for_each_entry (notifier, &adapt->notifier_list.head,
 				   struct amdgv_error_notifier, head) {
+		if (!notifier->batch_count)
+			continue;
+		notifier->batch_count = 0;
 		oss_notifier_wakeup(notifier->priv, 1);
 	}
 	oss_mutex_unlock(adapt->notifier_list_lock);
@@ -272,6 +316,8 @@ int amdgv_error_init(struct amdgv_adapter *adapt)
 	adapt->notifier_list_lock = OSS_INVALID_HANDLE;
 	adapt->error_process_thread = OSS_INVALID_HANDLE;
 	AMDGV_INIT_LIST_HEAD(&adapt->notifier_list.head);
+	oss_memset(adapt->notifier_level_index, AMDGV_ERROR_NOTIFIER_LEVEL_NONE,
+		   sizeof(adapt->notifier_level_index));
 
 	adapt->error_ring_buffer = (struct amdgv_error_ring_buffer *)oss_zalloc(
 		sizeof(struct amdgv_error_ring_buffer));
@@ -468,6 +514,64 @@ int amdgv_error_get_error_text_ext(uint32_t error_code, uint64_t data, char *buf
 	return oss_strlen(buf);
 }
 
+/*
+ * Copy the printf format of an error text, without the log header and the
+ * trailing newline, so the error can be rendered later from its code and
+ * data alone. Errors with extended data are not covered.
+ */
+int amdgv_error_get_error_format(uint32_t error_code, char *buf, uint32_t size, uint32_t *arg_type)
+{
+	uint8_t error_category = AMDGV_ERROR_CATEGORY(error_code);
+	uint16_t error_sub_code = AMDGV_ERROR_SUBCODE(error_code);
+	const struct error_text *error_text;
+	const char *text_ptr;
+	uint32_t len;
+
+	if ((error_category == AMDGV_ERROR_CATEGORY_NON_USED) ||
+	    (error_category >= AMDGV_ERROR_CATEGORY_MAX))
+		return 0;
+
+	if (error_sub_code >= amdgv_error_list[error_category].count)
+		return 0;
+
+	error_text = &amdgv_error_list[error_category].error_msg[error_sub_code];
+
+	switch (error_text->arg_type) {
+	case ERROR_DATA_ARG_NONE:
+		*arg_type = AMDGV_ERROR_TEXT_ARG_NONE;
+		break;
+	case ERROR_DATA_ARG_64:
+		*arg_type = AMDGV_ERROR_TEXT_ARG_64;
+		break;
+	case ERROR_DATA_ARG_32_32:
+		*arg_type = AMDGV_ERROR_TEXT_ARG_32_32;
+		break;
+	case ERROR_DATA_ARG_16_16_32:
+		*arg_type = AMDGV_ERROR_TEXT_ARG_16_16_32;
+		break;
+	case ERROR_DATA_ARG_16_16_16_16:
+		*arg_type = AMDGV_ERROR_TEXT_ARG_16_16_16_16;
+		break;
+	default:
+		return 0;
+	}
+
+	/* skip the header */
+	text_ptr = error_text->text;
+	text_ptr += oss_strlen(AMDGV_ERROR_PRINT_HEADER);
+
+	/* a cut format could end in the middle of a conversion */
+	len = oss_strlen(text_ptr);
+	if (len == 0 || len > size)
+		return 0;
+
+	/* skip the last \n */
+	oss_memcpy(buf, text_ptr, len - 1);
+	buf[len - 1] = 0;
+
+	return len - 1;
+}
+
 static int amdgv_error_print_error_text(uint32_t pf_bdf, uint32_t idx_vf,
 					const char *func_name, uint32_t line_num,
 					uint32_t error_code, uint64_t data)
@@ -949,6 +1053,8 @@ int amdgv_error_get_error(amdgv_dev_t dev, struct amdgv_error_notifier *notifier
 	read_count = err_rb->read_count;
 
 	if (write_count != read_count) {
+		/* pairs with the fence in amdgv_error_copy_error */
+		oss_memory_fence();
 		index = AMDGV_ERROR_INDEX(read_count);
 		*error_entry = &err_rb->error_entry_buffer[index];
 		err_rb->read_count++;
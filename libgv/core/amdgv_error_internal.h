@@ -80,11 +80,27 @@ struct amdgv_error_ring_buffer {
 	struct amdgv_error_entry error_entry_buffer[AMDGV_ERROR_BUF_ENTRY_SIZE];
 };
 
+/* no notifier accepts any event of this category */
+#define AMDGV_ERROR_NOTIFIER_LEVEL_NONE 0xFF
+
+/**
+ * Error notifier, one per user listening for events
+ *
+ * @ error_ring_buffer: Single producer (error thread) / single consumer
+ *			(user) ring, published with a fence before
+ *			write_count is advanced.
+ * @ mask_category, mask_level: event_mask decoded once at allocation.
+ * @ batch_count: Entries delivered in the current dispatch batch, only
+ *		  notifiers with a non-zero count are woken.
+ */
 struct amdgv_error_notifier {
 	struct amdgv_list_head		head;
 	uint64_t			event_mask;
 	struct amdgv_error_ring_buffer *error_ring_buffer;
 	void			       *priv;
+	uint64_t			mask_category;
+	uint8_t				mask_level;
+	uint32_t			batch_count;
 };
 
 int  amdgv_error_init(struct amdgv_adapter *adapt);
@@ -27,6 +27,8 @@
 static const uint32_t this_block = AMDGV_MEMORY_BLOCK;
 
 static void amdgv_ffbm_unmap_pteb(struct amdgv_adapter *adapt, struct amdgv_ffbm_pte_block *pteb);
+static void amdgv_ffbm_invalidate_and_unapply_pteb(struct amdgv_adapter *adapt,
+						   struct amdgv_ffbm_pte_block *pteb);
 
 static struct amdgv_ffbm_pte_block *amdgv_ffbm_allocate_block(struct amdgv_adapter *adapt)
 {
@@ -90,6 +92,370 @@ static void amdgv_ffbm_pteb_init(struct amdgv_ffbm_pte_block *pteb, uint64_t gpa
 	AMDGV_INIT_LIST_HEAD(&pteb->spa_list_node);
 }
 
+/* bucket n >= 1 holds blocks of at least page << n, bucket 0 everything smaller */
+static uint32_t amdgv_ffbm_free_bucket(struct amdgv_adapter *adapt, uint64_t size)
+{
+	uint64_t page_size = AMDGV_FFBM_PAGE_SIZE(adapt->ffbm.default_fragment);
+	uint32_t bucket = 0;
+
+	while (bucket + 1 < AMDGV_FFBM_FREE_BUCKETS && (page_size << (bucket + 1)) <= size)
+		bucket++;
+
+	return bucket;
+}
+
+/* gpa_list insertion does not keep the list ordered, so sort each function's run */
+static void amdgv_ffbm_index_sort_gpa(struct amdgv_ffbm_pte_block **gpa, uint32_t count)
+{
+	struct amdgv_ffbm_pte_block *pteb;
+	uint32_t i, j;
+
+	for (i = 1; i < count; i++) {
+		pteb = gpa[i];
+		for (j = i; j > 0 && gpa[j - 1]->gpa > pteb->gpa; j--)
+			gpa[j] = gpa[j - 1];
+		gpa[j] = pteb;
+	}
+}
+
+/* walk backwards so each bucket ends up with its lowest spa block */
+static void amdgv_ffbm_index_fill_buckets(struct amdgv_adapter *adapt)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	uint32_t bucket, i;
+
+	for (bucket = 0; bucket < AMDGV_FFBM_FREE_BUCKETS; bucket++)
+		index->free_bucket[bucket] = index->free_count;
+	for (i = index->free_count; i-- > 0;) {
+		bucket = amdgv_ffbm_free_bucket(adapt, index->free[i]->size);
+		do {
+			index->free_bucket[bucket] = i;
+		} while (bucket-- > 0);
+	}
+}
+
+static void amdgv_ffbm_index_overflow(struct amdgv_adapter *adapt)
+{
+	if (adapt->ffbm.index.valid)
+		AMDGV_WARN("FFBM: lookup index is full, falling back to list walks\n");
+	adapt->ffbm.index.valid = false;
+}
+
+/*
+ * Rebuild the whole index from the lists. Only needed at init, after bulk
+ * list changes that mark the index invalid, and to recover from an
+ * overflow; single block changes go through the add and del helpers below.
+ * Called with pt_lock held for write.
+ */
+void amdgv_ffbm_index_rebuild(struct amdgv_adapter *adapt)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	struct amdgv_ffbm_pte_block *pteb;
+	uint32_t vf_idx, count = 0;
+	bool full = false;
+
+	index->spa_count = 0;
+	index->free_count = 0;
+	index->reserved_count = 0;
+	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block,
+				   spa_list_node) {
+		if (index->spa_count == AMDGV_FFBM_MEMORY_ALLOCATION_COUNT) {
+			full = true;
+			break;
+		}
+		index->spa[index->spa_count++] = pteb;
+		if (pteb->type == AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED)
+			index->free[index->free_count++] = pteb;
+		else if (pteb->type == AMDGV_FFBM_MEM_TYPE_RESERVED)
+			index->reserved[index->reserved_count++] = pteb;
+	}
+
+	for (vf_idx = 0; vf_idx < AMDGV_MAX_VF_SLOT; vf_idx++) {
+		index->gpa_start[vf_idx] = count;
+		amdgv_list_for_each_entry(pteb, &adapt->array_vf[vf_idx].gpa_list,
+					   struct amdgv_ffbm_pte_block, gpa_list_node) {
+			if (count == AMDGV_FFBM_MEMORY_ALLOCATION_COUNT) {
+				full = true;
+				break;
+			}
+			index->gpa[count++] = pteb;
+		}
+		amdgv_ffbm_index_sort_gpa(&index->gpa[index->gpa_start[vf_idx]],
+					  count - index->gpa_start[vf_idx]);
+	}
+	index->gpa_start[AMDGV_MAX_VF_SLOT] = count;
+
+	amdgv_ffbm_index_fill_buckets(adapt);
+
+	/* stay on the list walks, FFBM_UNLOCK_LIST retries on the next change */
+	if (full)
+		amdgv_ffbm_index_overflow(adapt);
+	else
+		index->valid = true;
+}
+
+/* first slot in [lo, hi) whose spa (or gpa) is not below key */
+static uint32_t amdgv_ffbm_index_lower_bound(struct amdgv_ffbm_pte_block **arr, uint32_t lo,
+					     uint32_t hi, uint64_t key, bool by_gpa)
+{
+	uint32_t mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if ((by_gpa ? arr[mid]->gpa : arr[mid]->spa) < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/* slot of pteb in [lo, hi), hi if it is not there */
+static uint32_t amdgv_ffbm_index_slot(struct amdgv_ffbm_pte_block **arr, uint32_t lo,
+				      uint32_t hi, struct amdgv_ffbm_pte_block *pteb, bool by_gpa)
+{
+	uint64_t key = by_gpa ? pteb->gpa : pteb->spa;
+	uint32_t i;
+
+	/* a replaced page briefly shares its gpa with the replacement */
+	for (i = amdgv_ffbm_index_lower_bound(arr, lo, hi, key, by_gpa);
+	     i < hi && (by_gpa ? arr[i]->gpa : arr[i]->spa) == key; i++) {
+		if (arr[i] == pteb)
+			return i;
+	}
+
+	return hi;
+}
+
+static bool amdgv_ffbm_index_insert(struct amdgv_adapter *adapt,
+				    struct amdgv_ffbm_pte_block **arr, uint32_t *count,
+				    uint32_t slot, struct amdgv_ffbm_pte_block *pteb)
+{
+	uint32_t i;
+
+	if (*count == AMDGV_FFBM_MEMORY_ALLOCATION_COUNT) {
+		amdgv_ffbm_index_overflow(adapt);
+		return false;
+	}
+
+	for (i = *count; i > slot; i--)
+		arr[i] = arr[i - 1];
+	arr[slot] = pteb;
+	(*count)++;
+
+	return true;
+}
+
+static void amdgv_ffbm_index_erase(struct amdgv_ffbm_pte_block **arr, uint32_t *count,
+				   uint32_t slot)
+{
+	uint32_t i;
+
+	for (i = slot; i + 1 < *count; i++)
+		arr[i] = arr[i + 1];
+	(*count)--;
+}
+
+/*
+ * The add and del helpers keep the index in step with the lists. Call del
+ * before changing the spa, size, type or vf of a block the index holds and
+ * add once the block is back in its list; both need pt_lock held for write.
+ */
+static void amdgv_ffbm_index_add_spa(struct amdgv_adapter *adapt,
+				     struct amdgv_ffbm_pte_block *pteb)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	uint32_t slot;
+
+	if (!index->valid)
+		return;
+
+	slot = amdgv_ffbm_index_lower_bound(index->spa, 0, index->spa_count, pteb->spa, false);
+	if (!amdgv_ffbm_index_insert(adapt, index->spa, &index->spa_count, slot, pteb))
+		return;
+
+	if (pteb->type == AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED) {
+		slot = amdgv_ffbm_index_lower_bound(index->free, 0, index->free_count,
+						    pteb->spa, false);
+		amdgv_ffbm_index_insert(adapt, index->free, &index->free_count, slot, pteb);
+		amdgv_ffbm_index_fill_buckets(adapt);
+	} else if (pteb->type == AMDGV_FFBM_MEM_TYPE_RESERVED) {
+		slot = amdgv_ffbm_index_lower_bound(index->reserved, 0, index->reserved_count,
+						    pteb->spa, false);
+		amdgv_ffbm_index_insert(adapt, index->reserved, &index->reserved_count, slot,
+					pteb);
+	}
+}
+
+static void amdgv_ffbm_index_del_spa(struct amdgv_adapter *adapt,
+				     struct amdgv_ffbm_pte_block *pteb)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	uint32_t slot;
+
+	if (!index->valid)
+		return;
+
+	slot = amdgv_ffbm_index_slot(index->spa, 0, index->spa_count, pteb, false);
+	if (slot < index->spa_count)
+		amdgv_ffbm_index_erase(index->spa, &index->spa_count, slot);
+
+	if (pteb->type == AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED) {
+		slot = amdgv_ffbm_index_slot(index->free, 0, index->free_count, pteb, false);
+		if (slot < index->free_count) {
+			amdgv_ffbm_index_erase(index->free, &index->free_count, slot);
+			amdgv_ffbm_index_fill_buckets(adapt);
+		}
+	} else if (pteb->type == AMDGV_FFBM_MEM_TYPE_RESERVED) {
+		slot = amdgv_ffbm_index_slot(index->reserved, 0, index->reserved_count, pteb,
+					     false);
+		if (slot < index->reserved_count)
+			amdgv_ffbm_index_erase(index->reserved, &index->reserved_count, slot);
+	}
+}
+
+static void amdgv_ffbm_index_add_gpa(struct amdgv_adapter *adapt,
+				     struct amdgv_ffbm_pte_block *pteb)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	uint32_t slot, vf_idx;
+
+	if (!index->valid || pteb->vf_idx >= AMDGV_MAX_VF_SLOT)
+		return;
+
+	slot = amdgv_ffbm_index_lower_bound(index->gpa, index->gpa_start[pteb->vf_idx],
+					    index->gpa_start[pteb->vf_idx + 1], pteb->gpa, true);
+	if (!amdgv_ffbm_index_insert(adapt, index->gpa, &index->gpa_start[AMDGV_MAX_VF_SLOT],
+				     slot, pteb))
+		return;
+	for (vf_idx = pteb->vf_idx + 1; vf_idx < AMDGV_MAX_VF_SLOT; vf_idx++)
+		index->gpa_start[vf_idx]++;
+}
+
+static void amdgv_ffbm_index_del_gpa(struct amdgv_adapter *adapt,
+				     struct amdgv_ffbm_pte_block *pteb)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	uint32_t slot, vf_idx;
+
+	if (!index->valid || pteb->vf_idx >= AMDGV_MAX_VF_SLOT)
+		return;
+
+	slot = amdgv_ffbm_index_slot(index->gpa, index->gpa_start[pteb->vf_idx],
+				     index->gpa_start[pteb->vf_idx + 1], pteb, true);
+	if (slot == index->gpa_start[pteb->vf_idx + 1])
+		return;
+	amdgv_ffbm_index_erase(index->gpa, &index->gpa_start[AMDGV_MAX_VF_SLOT], slot);
+	for (vf_idx = pteb->vf_idx + 1; vf_idx < AMDGV_MAX_VF_SLOT; vf_idx++)
+		index->gpa_start[vf_idx]--;
+}
+
+static bool amdgv_ffbm_index_has_gpa(struct amdgv_adapter *adapt,
+				     struct amdgv_ffbm_pte_block *pteb)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+
+	if (!index->valid || pteb->vf_idx >= AMDGV_MAX_VF_SLOT)
+		return false;
+
+	return amdgv_ffbm_index_slot(index->gpa, index->gpa_start[pteb->vf_idx],
+				     index->gpa_start[pteb->vf_idx + 1], pteb, true) <
+	       index->gpa_start[pteb->vf_idx + 1];
+}
+
+/* called with pt_lock held */
+static struct amdgv_ffbm_pte_block *amdgv_ffbm_index_find_spa(struct amdgv_adapter *adapt,
+								uint64_t spa)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	struct amdgv_ffbm_pte_block *pteb;
+	uint32_t lo, hi, mid;
+
+	if (!index->valid) {
+		amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list,
+					   struct amdgv_ffbm_pte_block, spa_list_node) {
+			if (AMDGV_FFBM_ADDR_IN_RANGE(pteb->spa, pteb->size, spa))
+				return pteb;
+		}
+		return NULL;
+	}
+
+	/* last block starting at or below spa */
+	lo = 0;
+	hi = index->spa_count;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (index->spa[mid]->spa <= spa)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo > 0 && AMDGV_FFBM_ADDR_IN_RANGE(index->spa[lo - 1]->spa,
+					       index->spa[lo - 1]->size, spa))
+		return index->spa[lo - 1];
+
+	return NULL;
+}
+
+/* called with pt_lock held */
+static struct amdgv_ffbm_pte_block *amdgv_ffbm_index_find_gpa(struct amdgv_adapter *adapt,
+								uint64_t gpa, uint32_t vf_idx)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	struct amdgv_ffbm_pte_block *pteb;
+	uint32_t lo, hi, mid;
+
+	if (vf_idx >= AMDGV_MAX_VF_SLOT)
+		return NULL;
+
+	if (!index->valid) {
+		amdgv_list_for_each_entry(pteb, &adapt->array_vf[vf_idx].gpa_list,
+					   struct amdgv_ffbm_pte_block, gpa_list_node) {
+			if (AMDGV_FFBM_ADDR_IN_RANGE(pteb->gpa, pteb->size, gpa))
+				return pteb;
+		}
+		return NULL;
+	}
+
+	/* last block of this function starting at or below gpa */
+	lo = index->gpa_start[vf_idx];
+	hi = index->gpa_start[vf_idx + 1];
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (index->gpa[mid]->gpa <= gpa)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == index->gpa_start[vf_idx])
+		return NULL;
+
+	pteb = index->gpa[lo - 1];
+	if (!AMDGV_FFBM_ADDR_IN_RANGE(pteb->gpa, pteb->size, gpa))
+		return NULL;
+
+	return pteb;
+}
+
+/* lowest spa RESERVED block, called with pt_lock held */
+static struct amdgv_ffbm_pte_block *amdgv_ffbm_index_find_reserved(struct amdgv_adapter *adapt)
+{
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	struct amdgv_ffbm_pte_block *pteb;
+
+	if (!index->valid) {
+		amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list,
+					   struct amdgv_ffbm_pte_block, spa_list_node) {
+			if (pteb->type == AMDGV_FFBM_MEM_TYPE_RESERVED)
+				return pteb;
+		}
+		return NULL;
+	}
+
+	return index->reserved_count ? index->reserved[0] : NULL;
+}
+
 int amdgv_ffbm_apply_page_table(struct amdgv_adapter *adapt)
 {
 	struct amdgv_ffbm_pte_block *pteb;
@@ -124,17 +490,11 @@ int amdgv_ffbm_apply_page_table(struct amdgv_adapter *adapt)
 static struct amdgv_ffbm_pte_block *amdgv_ffbm_find_pteb_by_phy(struct amdgv_adapter *adapt,
 								uint64_t spa)
 {
-	struct amdgv_ffbm_pte_block *pteb, *ret = NULL;
+	struct amdgv_ffbm_pte_block *ret;
 
-	FFBM_LOCK_LIST;
-	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block,
-				   spa_list_node) {
-		if (AMDGV_FFBM_ADDR_IN_RANGE(pteb->spa, pteb->size, spa)) {
-			ret = pteb;
-			break;
-		}
-	}
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_LOCK_LIST;
+	ret = amdgv_ffbm_index_find_spa(adapt, spa);
+	FFBM_READ_UNLOCK_LIST;
 
 	return ret;
 }
@@ -142,17 +502,11 @@ static struct amdgv_ffbm_pte_block *amdgv_ffbm_find_pteb_by_phy(struct amdgv_ada
 static struct amdgv_ffbm_pte_block *amdgv_ffbm_find_pteb_by_ffbm(struct amdgv_adapter *adapt,
 								 uint64_t gpa, uint32_t vf_idx)
 {
-	struct amdgv_ffbm_pte_block *pteb, *ret = NULL;
+	struct amdgv_ffbm_pte_block *ret;
 
-	FFBM_LOCK_LIST;
-	amdgv_list_for_each_entry(pteb, &adapt->array_vf[vf_idx].gpa_list,
-				   struct amdgv_ffbm_pte_block, gpa_list_node) {
-		if (AMDGV_FFBM_ADDR_IN_RANGE(pteb->gpa, pteb->size, gpa)) {
-			ret = pteb;
-			break;
-		}
-	}
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_LOCK_LIST;
+	ret = amdgv_ffbm_index_find_gpa(adapt, gpa, vf_idx);
+	FFBM_READ_UNLOCK_LIST;
 
 	return ret;
 }
@@ -160,17 +514,33 @@ static struct amdgv_ffbm_pte_block *amdgv_ffbm_find_pteb_by_ffbm(struct amdgv_ad
 static struct amdgv_ffbm_pte_block *amdgv_ffbm_find_empty_pteb(struct amdgv_adapter *adapt,
 							       uint64_t min_size)
 {
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
 	struct amdgv_ffbm_pte_block *pteb, *ret = NULL;
+	uint32_t i;
 
-	FFBM_LOCK_LIST;
-	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block,
-				   spa_list_node) {
-		if (pteb->type == AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED && pteb->size >= min_size) {
-			ret = pteb;
+	FFBM_READ_LOCK_LIST;
+	if (!index->valid) {
+		amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list,
+					   struct amdgv_ffbm_pte_block, spa_list_node) {
+			if (pteb->type == AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED &&
+			    pteb->size >= min_size) {
+				ret = pteb;
+				break;
+			}
+		}
+		FFBM_READ_UNLOCK_LIST;
+		return ret;
+	}
+
+	/* every block big enough sits at or after the first block of min_size's bucket */
+	for (i = index->free_bucket[amdgv_ffbm_free_bucket(adapt, min_size)];
+	     i < index->free_count; i++) {
+		if (index->free[i]->size >= min_size) {
+			ret = index->free[i];
 			break;
 		}
 	}
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 
 	return ret;
 }
@@ -207,14 +577,19 @@ amdgv_ffbm_pteb_divide_size(struct amdgv_adapter *adapt, struct amdgv_ffbm_pte_b
 	amdgv_ffbm_pteb_init(new_pteb, new_gpa, pteb->spa + size, pteb->size - size,
 			     pteb->fragment, pteb->vf_idx, pteb->permission, pteb->type, pteb->applied);
 
-	/* shink the size */
-	pteb->size = size;
-
-	/* insert to the list after pteb */
+	/* shink the size and insert to the list after pteb */
 	FFBM_LOCK_LIST;
+	amdgv_ffbm_index_del_spa(adapt, pteb);
+	pteb->size = size;
+	amdgv_ffbm_index_add_spa(adapt, pteb);
 	amdgv_list_add(&new_pteb->spa_list_node, &pteb->spa_list_node);
-	if (pteb->gpa != AMDGV_FFBM_INVALID_ADDR)
+	amdgv_ffbm_index_add_spa(adapt, new_pteb);
+	if (pteb->gpa != AMDGV_FFBM_INVALID_ADDR) {
 		amdgv_list_add(&new_pteb->gpa_list_node, &pteb->gpa_list_node);
+		/* blocks not mapped to a function only share a ring among themselves */
+		if (amdgv_ffbm_index_has_gpa(adapt, pteb))
+			amdgv_ffbm_index_add_gpa(adapt, new_pteb);
+	}
 	FFBM_UNLOCK_LIST;
 
 	return new_pteb;
@@ -267,9 +642,11 @@ amdgv_ffbm_pteb_hole_by_phy(struct amdgv_adapter *adapt, struct amdgv_ffbm_pte_b
 static bool is_gpaess_valid(struct amdgv_adapter *adapt, uint64_t size, uint64_t gpa,
 			    uint32_t vf_idx)
 {
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
 	uint64_t previous_end = 0, current_start = 0;
 	struct amdgv_ffbm_pte_block *pteb;
 	bool ret = false;
+	uint32_t i;
 
 	if ((gpa >= MBYTES_TO_BYTES(AMDGV_FFBM_FB_TMR_OFFSET) &&
 		gpa < MBYTES_TO_BYTES(adapt->tmr_size + AMDGV_FFBM_FB_TMR_OFFSET)) ||
@@ -279,9 +656,22 @@ static bool is_gpaess_valid(struct amdgv_adapter *adapt, uint64_t size, uint64_t
 		return ret;
 	}
 
-	FFBM_LOCK_LIST;
-	amdgv_list_for_each_entry(pteb, &adapt->array_vf[vf_idx].gpa_list,
-				   struct amdgv_ffbm_pte_block, gpa_list_node) {
+	FFBM_READ_LOCK_LIST;
+	if (!index->valid) {
+		/* the list is not ordered, so only look for overlaps */
+		ret = gpa + size <= adapt->ffbm.total_physical_size;
+		amdgv_list_for_each_entry(pteb, &adapt->array_vf[vf_idx].gpa_list,
+					   struct amdgv_ffbm_pte_block, gpa_list_node) {
+			if (gpa < pteb->gpa + pteb->size && pteb->gpa < gpa + size) {
+				ret = false;
+				break;
+			}
+		}
+		goto exit;
+	}
+
+	for (i = index->gpa_start[vf_idx]; i < index->gpa_start[vf_idx + 1]; i++) {
+		pteb = index->gpa[i];
 		current_start = pteb->gpa;
 		if (AMDGV_FFBM_ADDR_SIZE_IN_RANGE(previous_end, current_start - previous_end,
 						  gpa, size)) {
@@ -302,7 +692,7 @@ static bool is_gpaess_valid(struct amdgv_adapter *adapt, uint64_t size, uint64_t
 					  size))
 		ret = true;
 exit:
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 	return ret;
 }
 
@@ -322,12 +712,13 @@ static void amdgv_ffbm_insert_new_ffbm_node(struct amdgv_adapter *adapt,
 			break;
 	}
 	amdgv_list_add(&pteb->gpa_list_node, &tmp->gpa_list_node);
+	amdgv_ffbm_index_add_gpa(adapt, pteb);
 	FFBM_UNLOCK_LIST;
 }
 
 static int amdgv_ffbm_replace_page(struct amdgv_adapter *adapt, uint64_t spa)
 {
-	struct amdgv_ffbm_pte_block *pteb, *new_pteb, *reserved_pteb;
+	struct amdgv_ffbm_pte_block *pteb, *new_pteb;
 	uint64_t aligned_spa, page_size = 0;
 	uint64_t bad_spa = 0;
 	uint64_t bad_spa_end = 0;
@@ -356,18 +747,39 @@ static int amdgv_ffbm_replace_page(struct amdgv_adapter *adapt, uint64_t spa)
 		return AMDGV_FFBM_ERROR_NO_MEM;
 	}
 
-	/* find a reserved PTEB */
-	new_pteb = NULL;
+	/* without a replacement the VF keeps its mapping, bad page included */
+	FFBM_READ_LOCK_LIST;
+	new_pteb = amdgv_ffbm_index_find_reserved(adapt);
+	FFBM_READ_UNLOCK_LIST;
+	if (!new_pteb) {
+		AMDGV_ERROR("FFBM: Can't find reserved PTE for swapping\n");
+		return AMDGV_FFBM_ERROR_NO_MEM;
+	}
+
+	/* unmap the broken block from the VF first, the swap below keeps the
+	 * write lock and the tlb invalidation must not run under it
+	 */
+	amdgv_ffbm_invalidate_and_unapply_pteb(adapt, pteb);
+
+	/* redo the lookups under the write lock, the lists may have changed
+	 * since the read locked lookup above. The copy stays under it too, so
+	 * nobody sees the new block and the broken one mapped at once.
+	 */
 	FFBM_LOCK_LIST;
-	amdgv_list_for_each_entry(reserved_pteb, &adapt->ffbm.spa_list,
-				   struct amdgv_ffbm_pte_block, spa_list_node) {
-		if (reserved_pteb->type == AMDGV_FFBM_MEM_TYPE_RESERVED) {
-			new_pteb = reserved_pteb;
-			break;
-		}
+	if (amdgv_ffbm_index_find_spa(adapt, spa) != pteb ||
+	    pteb->type != AMDGV_FFBM_MEM_TYPE_VF || pteb->size != page_size) {
+		FFBM_UNLOCK_LIST;
+		AMDGV_ERROR("FFBM: broken page changed while being replaced\n");
+		return AMDGV_FFBM_ERROR_BAD_ADDR;
 	}
-	FFBM_UNLOCK_LIST;
+
+	/* another replacement took the last reserved PTEB meanwhile, map the
+	 * broken block back like the check above would have left it
+	 */
+	new_pteb = amdgv_ffbm_index_find_reserved(adapt);
 	if (!new_pteb) {
+		adapt->ffbm.apply_pteb(adapt, pteb, true);
+		FFBM_UNLOCK_LIST;
 		AMDGV_ERROR("FFBM: Can't find reserved PTE for swapping\n");
 		return AMDGV_FFBM_ERROR_NO_MEM;
 	}
@@ -397,26 +809,29 @@ static int amdgv_ffbm_replace_page(struct amdgv_adapter *adapt, uint64_t spa)
 	}
 
 	/* this new pteb is a reserved one which is already in the physical list, so just update */
+	amdgv_ffbm_index_del_spa(adapt, new_pteb);
 	amdgv_ffbm_pteb_update(new_pteb, pteb->gpa, new_pteb->spa, page_size, pteb->fragment,
 			       pteb->vf_idx, pteb->permission, pteb->type, false);
+	amdgv_ffbm_index_add_spa(adapt, new_pteb);
 
 	adapt->ffbm.reserved_block_count--;
 
-	/* not assigned block doesn't required to be removed from mapped list */
-	/* insert before pteb */
-	FFBM_LOCK_LIST;
+	/* take the place of the bad one in the mapped ffbm list */
+	amdgv_ffbm_index_del_gpa(adapt, pteb);
 	amdgv_list_add_tail(&new_pteb->gpa_list_node, &pteb->gpa_list_node);
-	/* remove the bad one from the mapped ffbm list */
-	FFBM_UNLOCK_LIST;
+	amdgv_list_del_init(&pteb->gpa_list_node);
+	amdgv_ffbm_index_add_gpa(adapt, new_pteb);
 
-	amdgv_ffbm_unmap_pteb(adapt, pteb);
-
-	/* update bad pteb */
+	/* retire the bad one in place: going through unmap_pteb would merge it
+	 * into a free neighbour or hand it out again before it is marked bad
+	 */
+	amdgv_ffbm_index_del_spa(adapt, pteb);
 	amdgv_ffbm_pteb_update(pteb, AMDGV_FFBM_INVALID_ADDR, pteb->spa, page_size,
 			       pteb->fragment, AMDGV_INVALID_IDX_VF, 0,
 			       AMDGV_FFBM_MEM_TYPE_BAD_PAGE, pteb->applied);
-
+	amdgv_ffbm_index_add_spa(adapt, pteb);
 	adapt->ffbm.bad_block_count++;
+	FFBM_UNLOCK_LIST;
 
 	return 0;
 }
@@ -512,8 +927,12 @@ int amdgv_ffbm_manual_map(struct amdgv_adapter *adapt, uint32_t vf_idx, uint64_t
 			AMDGV_ERROR("FFBM: map range failed\n");
 			return AMDGV_FFBM_ERROR_NO_MEM;
 		}
+		FFBM_LOCK_LIST;
+		amdgv_ffbm_index_del_spa(adapt, pteb);
 		amdgv_ffbm_pteb_update(pteb, gpa, spa, size, adapt->ffbm.default_fragment,
 				       vf_idx, permission, type, false);
+		amdgv_ffbm_index_add_spa(adapt, pteb);
+		FFBM_UNLOCK_LIST;
 	}
 
 	if (type == AMDGV_FFBM_MEM_TYPE_VF ||
@@ -561,8 +980,12 @@ static int amdgv_ffbm_map(struct amdgv_adapter *adapt, uint32_t vf_idx, uint64_t
 		if (pteb->size > size_left)
 			amdgv_ffbm_pteb_divide_size(adapt, pteb, size_left);
 
+		FFBM_LOCK_LIST;
+		amdgv_ffbm_index_del_spa(adapt, pteb);
 		amdgv_ffbm_pteb_update(pteb, gpa_start, pteb->spa, pteb->size, pteb->fragment,
 				       vf_idx, permission, type, false);
+		amdgv_ffbm_index_add_spa(adapt, pteb);
+		FFBM_UNLOCK_LIST;
 
 		if (type == AMDGV_FFBM_MEM_TYPE_VF) {
 			gpa_start += pteb->size;
@@ -611,10 +1034,10 @@ static void amdgv_ffbm_unmap_pteb(struct amdgv_adapter *adapt,
 
 	/* 1. remove from list */
 	amdgv_ffbm_invalidate_and_unapply_pteb(adapt, pteb);
+	FFBM_LOCK_LIST;
 	if (!amdgv_list_empty(&pteb->gpa_list_node)) {
-		FFBM_LOCK_LIST;
+		amdgv_ffbm_index_del_gpa(adapt, pteb);
 		amdgv_list_del_init(&pteb->gpa_list_node);
-		FFBM_UNLOCK_LIST;
 	}
 
 	/* 2. Remove TMR type pteb or return back VF type pteb */
@@ -624,6 +1047,7 @@ static void amdgv_ffbm_unmap_pteb(struct amdgv_adapter *adapt,
 		amdgv_ffbm_free_block(pteb);
 	} else if (pteb->type == AMDGV_FFBM_MEM_TYPE_VF) {
 		/*2.1 return back VF FB to unassigned */
+		amdgv_ffbm_index_del_spa(adapt, pteb);
 		amdgv_ffbm_pteb_update(pteb, AMDGV_FFBM_INVALID_ADDR, pteb->spa, pteb->size,
 				       adapt->ffbm.default_fragment, AMDGV_INVALID_IDX_VF, 0,
 				       AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED, pteb->applied);
@@ -633,10 +1057,9 @@ static void amdgv_ffbm_unmap_pteb(struct amdgv_adapter *adapt,
 		tmp_pteb = amdgv_list_entry(pteb->spa_list_node.prev,
 					    struct amdgv_ffbm_pte_block, spa_list_node);
 		if (tmp_pteb->type == AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED) {
+			amdgv_ffbm_index_del_spa(adapt, tmp_pteb);
 			tmp_pteb->size += pteb->size;
-			FFBM_LOCK_LIST;
 			amdgv_list_del(&pteb->spa_list_node);
-			FFBM_UNLOCK_LIST;
 			amdgv_ffbm_free_block(pteb);
 			pteb = tmp_pteb;
 		}
@@ -645,13 +1068,14 @@ static void amdgv_ffbm_unmap_pteb(struct amdgv_adapter *adapt,
 		tmp_pteb = amdgv_list_entry(pteb->spa_list_node.next,
 					    struct amdgv_ffbm_pte_block, spa_list_node);
 		if (tmp_pteb->type == AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED) {
+			amdgv_ffbm_index_del_spa(adapt, tmp_pteb);
 			pteb->size += tmp_pteb->size;
-			FFBM_LOCK_LIST;
 			amdgv_list_del(&tmp_pteb->spa_list_node);
-			FFBM_UNLOCK_LIST;
 			amdgv_ffbm_free_block(tmp_pteb);
 		}
+		amdgv_ffbm_index_add_spa(adapt, pteb);
 	}
+	FFBM_UNLOCK_LIST;
 }
 
 static void amdgv_ffbm_unmap_by_spa(struct amdgv_adapter *adapt, uint64_t spa)
@@ -675,7 +1099,7 @@ void amdgv_ffbm_unmap_by_fcn(struct amdgv_adapter *adapt, uint32_t vf_idx, bool
 		     AMDGV_INVALID_IDX_VF); /* the invalid part shouldn't be unmapped */
 	do {
 		found = false;
-		FFBM_LOCK_LIST;
+		FFBM_READ_LOCK_LIST;
 		amdgv_list_for_each_entry(pteb, &entry->gpa_list, struct amdgv_ffbm_pte_block,
 					   gpa_list_node) {
 			if (pteb->vf_idx == vf_idx && pteb->applied) {
@@ -683,7 +1107,7 @@ void amdgv_ffbm_unmap_by_fcn(struct amdgv_adapter *adapt, uint32_t vf_idx, bool
 				break;
 			}
 		}
-		FFBM_UNLOCK_LIST;
+		FFBM_READ_UNLOCK_LIST;
 		if (found) {
 			if (reserve)
 				/* Invalidate ffbm mapping but reserve the pteb in the list */
@@ -701,28 +1125,26 @@ uint64_t amdgv_ffbm_copy_to_gpa(struct amdgv_adapter *adapt, uint32_t *data, uin
 	struct amdgv_ffbm_pte_block *pteb;
 	uint64_t size_left = size;
 	uint64_t size_copy = 0;
-	FFBM_LOCK_LIST;
-	amdgv_list_for_each_entry(pteb, &adapt->array_vf[idx_vf].gpa_list,
-				   struct amdgv_ffbm_pte_block, gpa_list_node) {
-		if (AMDGV_FFBM_ADDR_IN_RANGE(pteb->gpa, pteb->size, gpa)) {
-			size_copy = min(pteb->size - (gpa - pteb->gpa), size_left);
-			/* copy using MM_INDEX/DATA regs */
-			if (type == AMDGV_FFBM_MM_COPY)
-				amdgv_mm_copy_to_fb(adapt, pteb->spa + (gpa - pteb->gpa),
-						(uint64_t)&data[((size - size_left) / 4)], size_copy);
-			/* copy using PF bar */
-			else if (type == AMDGV_FFBM_PF_COPY)
-				oss_memcpy((void *)((uint64_t)adapt->fb + pteb->spa + (gpa - pteb->gpa)),
-						&data[((size - size_left) / 4)], size_copy);
-			else
-				break;
-			size_left -= size_copy;
-			gpa += size_copy;
-		}
-		if (size_left == 0)
+	FFBM_READ_LOCK_LIST;
+	while (size_left > 0) {
+		pteb = amdgv_ffbm_index_find_gpa(adapt, gpa, idx_vf);
+		if (!pteb)
 			break;
+		size_copy = min(pteb->size - (gpa - pteb->gpa), size_left);
+		/* copy using MM_INDEX/DATA regs */
+		if (type == AMDGV_FFBM_MM_COPY)
+			amdgv_mm_copy_to_fb(adapt, pteb->spa + (gpa - pteb->gpa),
+					(uint64_t)&data[((size - size_left) / 4)], size_copy);
+		/* copy using PF bar */
+		else if (type == AMDGV_FFBM_PF_COPY)
+			oss_memcpy((void *)((uint64_t)adapt->fb + pteb->spa + (gpa - pteb->gpa)),
+					&data[((size - size_left) / 4)], size_copy);
+		else
+			break;
+		size_left -= size_copy;
+		gpa += size_copy;
 	}
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 	return size_left;
 }
 
@@ -733,28 +1155,26 @@ uint64_t amdgv_ffbm_copy_from_gpa(struct amdgv_adapter *adapt, uint32_t *data, u
 	struct amdgv_ffbm_pte_block *pteb;
 	uint64_t size_left = size;
 	uint64_t size_copy = 0;
-	FFBM_LOCK_LIST;
-	amdgv_list_for_each_entry(pteb, &adapt->array_vf[idx_vf].gpa_list,
-				   struct amdgv_ffbm_pte_block, gpa_list_node) {
-		if (AMDGV_FFBM_ADDR_IN_RANGE(pteb->gpa, pteb->size, gpa)) {
-			size_copy = min(pteb->size - (gpa - pteb->gpa), size_left);
-			/* copy using MM_INDEX/DATA regs */
-			if (type == AMDGV_FFBM_MM_COPY)
-				amdgv_mm_copy_from_fb(adapt, (uint64_t)&data[((size - size_left) / 4)],
-						pteb->spa + (gpa - pteb->gpa), size_copy);
-			/* copy using PF bar */
-			else if (type == AMDGV_FFBM_PF_COPY)
-				oss_memcpy(&data[((size - size_left) / 4)],
-						(void *)((uint64_t)adapt->fb + pteb->spa + (gpa - pteb->gpa)), size_copy);
-			else
-				break;
-			size_left -= size_copy;
-			gpa += size_copy;
-		}
-		if (size_left == 0)
+	FFBM_READ_LOCK_LIST;
+	while (size_left > 0) {
+		pteb = amdgv_ffbm_index_find_gpa(adapt, gpa, idx_vf);
+		if (!pteb)
+			break;
+		size_copy = min(pteb->size - (gpa - pteb->gpa), size_left);
+		/* copy using MM_INDEX/DATA regs */
+		if (type == AMDGV_FFBM_MM_COPY)
+			amdgv_mm_copy_from_fb(adapt, (uint64_t)&data[((size - size_left) / 4)],
+					pteb->spa + (gpa - pteb->gpa), size_copy);
+		/* copy using PF bar */
+		else if (type == AMDGV_FFBM_PF_COPY)
+			oss_memcpy(&data[((size - size_left) / 4)],
+					(void *)((uint64_t)adapt->fb + pteb->spa + (gpa - pteb->gpa)), size_copy);
+		else
 			break;
+		size_left -= size_copy;
+		gpa += size_copy;
 	}
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 	return size_left;
 }
 
@@ -784,12 +1204,13 @@ int amdgv_ffbm_sw_init(struct amdgv_adapter *adapt)
 	int i;
 	/* sw init */
 	adapt->ffbm.memory_lock = oss_mutex_init();
-	adapt->ffbm.pt_lock = oss_mutex_init();
+	adapt->ffbm.pt_lock = oss_rwsema_init();
 	for (i = 0; i < AMDGV_MAX_VF_SLOT; i++) {
 		AMDGV_INIT_LIST_HEAD(&adapt->array_vf[i].gpa_list);
 	}
 	AMDGV_INIT_LIST_HEAD(&adapt->ffbm.spa_list);
 	adapt->ffbm.bad_block_count = 0;
+	amdgv_ffbm_index_rebuild(adapt);
 	adapt->ffbm.enabled = true;
 	return 0;
 }
@@ -798,7 +1219,7 @@ int amdgv_ffbm_sw_fini(struct amdgv_adapter *adapt)
 {
 	/* sw fini */
 	if (adapt->ffbm.pt_lock)
-		oss_mutex_fini(adapt->ffbm.pt_lock);
+		oss_rwsema_fini(adapt->ffbm.pt_lock);
 	if (adapt->ffbm.memory_lock)
 		oss_mutex_fini(adapt->ffbm.memory_lock);
 	return 0;
@@ -896,11 +1317,17 @@ int amdgv_ffbm_page_table_init(struct amdgv_adapter *adapt)
 		return AMDGV_FFBM_ERROR_NO_MEM;
 	}
 	adapt->ffbm.total_physical_size = aligned_size;
-	amdgv_ffbm_pteb_init(pteb, 0, 0, aligned_size, adapt->ffbm.default_fragment,
+	/* free blocks have no gpa, like the ones unmap returns. With one, every
+	 * block cut from it would share its gpa_list ring and stay linked into
+	 * it once mapped to a VF list.
+	 */
+	amdgv_ffbm_pteb_init(pteb, AMDGV_FFBM_INVALID_ADDR, 0, aligned_size,
+			     adapt->ffbm.default_fragment,
 			     AMDGV_INVALID_IDX_VF, 0, AMDGV_FFBM_MEM_TYPE_NOT_ASSIGNED, false);
 
 	FFBM_LOCK_LIST;
 	amdgv_list_add(&pteb->spa_list_node, &adapt->ffbm.spa_list);
+	amdgv_ffbm_index_add_spa(adapt, pteb);
 	FFBM_UNLOCK_LIST;
 
 	/* 2. top fb, which reserved for gpu functionalities*/
@@ -930,7 +1357,7 @@ int amdgv_ffbm_page_table_init(struct amdgv_adapter *adapt)
 void amdgv_ffbm_reserve_all_bad_pages(struct amdgv_adapter *adapt)
 {
 	int ret, i;
-	uint32_t bp_cnt;
+	int bp_cnt;
 	struct eeprom_table_record *record;
 
 	record = oss_zalloc(sizeof(*record));
@@ -966,6 +1393,8 @@ void amdgv_ffbm_page_table_destroy(struct amdgv_adapter *adapt)
 	struct amdgv_list_head *head;
 
 	FFBM_LOCK_LIST;
+	/* every block goes, FFBM_UNLOCK_LIST rebuilds the now empty index */
+	adapt->ffbm.index.valid = false;
 
 	for (vf_idx = 0; vf_idx < adapt->num_vf; vf_idx++) {
 		head = &adapt->array_vf[vf_idx].gpa_list;
@@ -998,7 +1427,7 @@ void amdgv_ffbm_dump_page_table(struct amdgv_adapter *adapt)
 	struct amdgv_ffbm_pte_block *pteb;
 	AMDGV_ERROR("FFBM list dump start\n");
 	AMDGV_INFO("Physical List:");
-	FFBM_LOCK_LIST;
+	FFBM_READ_LOCK_LIST;
 	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block,
 				   spa_list_node) {
 		AMDGV_INFO(
@@ -1006,7 +1435,7 @@ void amdgv_ffbm_dump_page_table(struct amdgv_adapter *adapt)
 			pteb->spa, pteb->gpa, pteb->size, pteb->vf_idx,
 			amdgv_ffbm_type_name_str(pteb->type));
 	}
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 }
 
 void amdgv_ffbm_read_page_table(struct amdgv_adapter *adapt, char *page_table_content,
@@ -1016,7 +1445,7 @@ void amdgv_ffbm_read_page_table(struct amdgv_adapter *adapt, char *page_table_co
 	int length, ret;
 	bool dump_table = false;
 	length = 0;
-	FFBM_LOCK_LIST;
+	FFBM_READ_LOCK_LIST;
 	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block,
 				   spa_list_node) {
 		if (length >= restore_length) {
@@ -1033,7 +1462,7 @@ void amdgv_ffbm_read_page_table(struct amdgv_adapter *adapt, char *page_table_co
 		length += ret;
 	}
 	*len = length;
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 	if (dump_table)
 		amdgv_ffbm_dump_page_table(adapt);
 	return;
@@ -1046,7 +1475,7 @@ void amdgv_ffbm_copy_page_table(struct amdgv_adapter *adapt, void *page_table_co
 	int index = 0;
 	int pte_size = sizeof(struct amdgv_ffbm_pte_block);
 
-	FFBM_LOCK_LIST;
+	FFBM_READ_LOCK_LIST;
 	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block,
 				   spa_list_node) {
 		oss_memcpy(pteb_buff, pteb, pte_size);
@@ -1056,7 +1485,7 @@ void amdgv_ffbm_copy_page_table(struct amdgv_adapter *adapt, void *page_table_co
 			break;
 	}
 	*len = index * pte_size;
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 }
 
 enum amdgv_live_info_status amdgv_ffbm_export_spa(struct amdgv_adapter *adapt, struct amdgv_live_info_ffbm *ffbm_info)
@@ -1064,7 +1493,7 @@ enum amdgv_live_info_status amdgv_ffbm_export_spa(struct amdgv_adapter *adapt, s
 	struct amdgv_ffbm_pte_block *pteb = NULL;
 	uint32_t block_idx = 0;
 
-	FFBM_LOCK_LIST;
+	FFBM_READ_LOCK_LIST;
 	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block, spa_list_node) {
 		ffbm_info->blocks[block_idx].gpa = pteb->gpa;
 		ffbm_info->blocks[block_idx].spa = pteb->spa;
@@ -1076,7 +1505,7 @@ enum amdgv_live_info_status amdgv_ffbm_export_spa(struct amdgv_adapter *adapt, s
 		ffbm_info->blocks[block_idx].applied = pteb->applied;
 		block_idx += 1;
 	}
-	FFBM_UNLOCK_LIST;
+	FFBM_READ_UNLOCK_LIST;
 
 	ffbm_info->used_blocks = block_idx;
 	ffbm_info->bad_block_count = adapt->ffbm.bad_block_count;
@@ -1098,6 +1527,8 @@ enum amdgv_live_info_status amdgv_ffbm_import_spa_and_gpa(struct amdgv_adapter *
 	struct amdgv_ffbm_pte_block *pf_tmr_pteb = NULL;
 
 	FFBM_LOCK_LIST;
+	/* bulk change, FFBM_UNLOCK_LIST rebuilds the index once at the end */
+	adapt->ffbm.index.valid = false;
 	for (block_idx = 0; block_idx < ffbm_info->used_blocks; block_idx++) {
 		new_pteb = amdgv_ffbm_allocate_block(adapt);
 		if (!new_pteb) {
@@ -1191,7 +1622,7 @@ int amdgv_get_vf_fb_mapping_list(struct amdgv_adapter *adapt,
 	list->count = 0;
 	list->ffbm_enabled = adapt->ffbm.enabled ? 1 : 0;
 	if (list->ffbm_enabled && vf_idx < AMDGV_PF_IDX) {
-		FFBM_LOCK_LIST;
+		FFBM_READ_LOCK_LIST;
 		amdgv_list_for_each_entry(pteb, &adapt->array_vf[vf_idx].gpa_list,
 					struct amdgv_ffbm_pte_block, gpa_list_node) {
 			if (pteb->type != AMDGV_FFBM_MEM_TYPE_TMR || include_tmr_block) {
@@ -1207,7 +1638,7 @@ int amdgv_get_vf_fb_mapping_list(struct amdgv_adapter *adapt,
 				}
 			}
 		}
-		FFBM_UNLOCK_LIST;
+		FFBM_READ_UNLOCK_LIST;
 
 		list->count = index;
 		// Sort the array by ascending "gpa" using Bubble Sort
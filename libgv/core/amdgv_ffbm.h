@@ -25,8 +25,16 @@
 
 #include <amdgv_device.h>
 
-#define FFBM_LOCK_LIST      (oss_mutex_lock(adapt->ffbm.pt_lock))
-#define FFBM_UNLOCK_LIST    (oss_mutex_unlock(adapt->ffbm.pt_lock))
+/* writers update the lookup index along with the lists, and rebuild it
+ * before dropping the lock if a bulk change or an overflow invalidated it,
+ * so readers only ever see an index that matches the lists
+ */
+#define FFBM_LOCK_LIST           (oss_rwsema_write_lock(adapt->ffbm.pt_lock))
+#define FFBM_UNLOCK_LIST         do { if (!adapt->ffbm.index.valid) \
+					      amdgv_ffbm_index_rebuild(adapt); \
+				      oss_rwsema_write_unlock(adapt->ffbm.pt_lock); } while (0)
+#define FFBM_READ_LOCK_LIST      (oss_rwsema_read_lock(adapt->ffbm.pt_lock))
+#define FFBM_READ_UNLOCK_LIST    (oss_rwsema_read_unlock(adapt->ffbm.pt_lock))
 
 /* pre-allocate memory blocks:
  * 3 block for each PF/VF, PF needs additional one, so it is 17 * 3 + 1 = 52 blocks
@@ -36,6 +44,9 @@
 */
 #define AMDGV_FFBM_MEMORY_ALLOCATION_COUNT 256
 
+/* free blocks are bucketed by size: bucket n holds blocks of at least page << n */
+#define AMDGV_FFBM_FREE_BUCKETS 16
+
 #define AMDGV_FFBM_FB_TMR_OFFSET 2 /* 2 MB*/
 
 /* 2^fragment * 4kb */
@@ -101,6 +112,23 @@ struct amdgv_ffbm_memory_block {
 	bool used;
 };
 
+/* sorted views of the lists, updated under pt_lock on every list change.
+ * Lookups binary search these instead of walking the lists, and walk the
+ * lists again while valid is false.
+ */
+struct amdgv_ffbm_index {
+	struct amdgv_ffbm_pte_block *spa[AMDGV_FFBM_MEMORY_ALLOCATION_COUNT];      /* spa_list, by spa asc */
+	struct amdgv_ffbm_pte_block *gpa[AMDGV_FFBM_MEMORY_ALLOCATION_COUNT];      /* every gpa_list, by vf then gpa asc */
+	struct amdgv_ffbm_pte_block *free[AMDGV_FFBM_MEMORY_ALLOCATION_COUNT];     /* NOT_ASSIGNED blocks, by spa asc */
+	struct amdgv_ffbm_pte_block *reserved[AMDGV_FFBM_MEMORY_ALLOCATION_COUNT]; /* RESERVED blocks, by spa asc */
+	uint32_t spa_count;
+	uint32_t free_count;
+	uint32_t reserved_count;
+	uint32_t gpa_start[AMDGV_MAX_VF_SLOT + 1];         /* gpa[] range of each function */
+	uint32_t free_bucket[AMDGV_FFBM_FREE_BUCKETS];     /* first free[] slot in each size bucket or above */
+	bool valid;                                        /* false: an array overflowed or a bulk change is pending */
+};
+
 struct amdgv_ffbm {
 	int (*apply_pteb)(struct amdgv_adapter *adapt, struct amdgv_ffbm_pte_block *pteb, bool valid);
 	int (*invalidate_tlb)(struct amdgv_adapter *adapt, struct amdgv_ffbm_pte_block *pteb, bool flush);
@@ -113,8 +141,9 @@ struct amdgv_ffbm {
 	uint8_t reserved_block_count;
 	uint64_t total_physical_size;                   /* total physical size managed by ffbm */
 
-	/* mutex */
-	mutex_t pt_lock;
+	/* read-mostly: lookups and copies take it shared, list changes exclusive */
+	rwsema_t pt_lock;
+	struct amdgv_ffbm_index index;
 
 	/* core structure */
 	bool enabled;
@@ -130,6 +159,7 @@ struct amdgv_ffbm {
 
 int amdgv_ffbm_sw_init(struct amdgv_adapter *adapt);
 int amdgv_ffbm_sw_fini(struct amdgv_adapter *adapt);
+void amdgv_ffbm_index_rebuild(struct amdgv_adapter *adapt);
 int amdgv_ffbm_page_table_update_by_fcn(struct amdgv_adapter *adapt, uint32_t vf_idx);
 int amdgv_ffbm_page_table_init(struct amdgv_adapter *adapt);
 uint64_t amdgv_ffbm_gpa_to_spa(struct amdgv_adapter *adapt, uint64_t gpa, uint32_t vf_idx);
@@ -360,12 +360,14 @@ void amdgv_update_histogram(struct amdgv_adapter *adapt, uint32_t idx_vf,
 	hist->count[bucket]++;
 }
 
-static int amdgv_wait_detect_hang(struct amdgv_adapter *adapt, amdgv_wait_cb_t cb_func, void *cb_context, uint64_t timeout)
+static int amdgv_wait_detect_hang(struct amdgv_adapter *adapt, amdgv_wait_cb_t cb_func, void *cb_context, uint64_t timeout,
+				  enum amdgv_wait_site_id site)
 {
 	if (adapt->gfx.funcs->wait_detect_hang)
 		return adapt->gfx.funcs->wait_detect_hang(adapt, cb_func, cb_context, timeout);
 	else
-		return amdgv_wait_for(adapt, cb_func, cb_context, timeout, AMDGV_WAIT_FLAG_USLEEP);
+		return amdgv_wait_for(adapt, cb_func, cb_context, timeout,
+				      AMDGV_WAIT_FLAG_USLEEP | AMDGV_WAIT_FLAG_SITE(site));
 }
 
 static int wait_cmd_complete_cb(void *context)
@@ -390,9 +392,10 @@ static int wait_cmd_complete(struct amdgv_adapter *adapt, uint32_t idx_vf,
 
 	if (IS_HW_SCHED_TYPE_MM(hw_sched_id) || !adapt->gfx.hang_detection_supported)
 		wait_ret = amdgv_wait_for(adapt, wait_cmd_complete_cb, (void *)&wc, timeout,
-			AMDGV_WAIT_FLAG_USLEEP);
+			AMDGV_WAIT_FLAG_USLEEP | AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_GPUIOV_CMD));
 	else
-		wait_ret = amdgv_wait_detect_hang(adapt, wait_cmd_complete_cb, (void *)&wc, timeout);
+		wait_ret = amdgv_wait_detect_hang(adapt, wait_cmd_complete_cb, (void *)&wc, timeout,
+						  AMDGV_WAIT_SITE_GPUIOV_CMD);
 
 	/* Add to diagnosis data */
 	AMDGV_DIAG_DATA_TRACE_LOG_GPUIOV_CMD_END(
@@ -460,9 +463,10 @@ int wait_for_first_cmd_complete(struct amdgv_adapter *adapt,
 
 	if (!if_gfx_engine_in_mask(adapt, hw_sched_mask) || !adapt->gfx.hang_detection_supported)
 		wait_ret = amdgv_wait_for(adapt, wait_for_first_cmd_complete_cb, (void *)&wc, timeout,
-			AMDGV_WAIT_FLAG_USLEEP);
+			AMDGV_WAIT_FLAG_USLEEP | AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_GPUIOV_FIRST_CMD));
 	else
-		wait_ret = amdgv_wait_detect_hang(adapt, wait_for_first_cmd_complete_cb, (void *)&wc, timeout);
+		wait_ret = amdgv_wait_detect_hang(adapt, wait_for_first_cmd_complete_cb, (void *)&wc, timeout,
+						  AMDGV_WAIT_SITE_GPUIOV_FIRST_CMD);
 
 	if (wait_ret) {
 		for_each_id(hw_sched_id, hw_sched_mask) {
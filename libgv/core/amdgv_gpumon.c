@@ -3013,10 +3013,13 @@ int amdgv_gpumon_cper_get_count(amdgv_dev_t dev,
 }
 
 int amdgv_gpumon_cper_get_entries(amdgv_dev_t dev, uint64_t rptr,
+				  uint32_t sev_mask,
 				  void *buf, uint64_t buf_size,
+				  uint64_t max_entries,
 				  uint64_t *write_count,
 				  uint64_t *overflow_count,
-				  uint64_t *left_size)
+				  uint64_t *left_size,
+				  uint64_t *next_rptr)
 {
 	struct amdgv_adapter *adapt;
 	union amdgv_sched_event_data data;
@@ -3028,15 +3031,18 @@ int amdgv_gpumon_cper_get_entries(amdgv_dev_t dev, uint64_t rptr,
 	if (!adapt->cper.enabled)
 		return AMDGV_ERROR_GPUMON_NOT_SUPPORTED;
 
-	if (!buf || !write_count || !overflow_count)
+	if (!buf || !write_count || !overflow_count || !left_size || !next_rptr)
 		return AMDGV_FAILURE;
 
 	data.gpumon_data.cper.get_entries.rptr = rptr;
+	data.gpumon_data.cper.get_entries.sev_mask = sev_mask;
 	data.gpumon_data.cper.get_entries.buf = buf;
 	data.gpumon_data.cper.get_entries.buf_size = buf_size;
+	data.gpumon_data.cper.get_entries.max_entries = max_entries;
 	data.gpumon_data.cper.get_entries.write_count = write_count;
 	data.gpumon_data.cper.get_entries.overflow_count = overflow_count;
 	data.gpumon_data.cper.get_entries.left_size = left_size;
+	data.gpumon_data.cper.get_entries.next_rptr = next_rptr;
 
 	data.gpumon_data.type = GPUMON_CPER_GET_ENTRIES;
 	data.gpumon_data.result = &event_ret;
@@ -3093,8 +3099,8 @@ static void amdgv_gpumon_log_event(struct amdgv_adapter *adapt,
 }
 
 
-int amdgv_gpumon_handle_sched_event(struct amdgv_adapter *adapt,
-				    struct amdgv_sched_event *event)
+static int amdgv_gpumon_process(struct amdgv_adapter *adapt,
+				struct amdgv_sched_event *event)
 {
 	int ret = 0;
 	struct amdgv_gpumon_metrics *metrics = NULL;
@@ -3126,18 +3132,24 @@ int amdgv_gpumon_handle_sched_event(struct amdgv_adapter *adapt,
 		tstamp = oss_get_time_stamp();
 		size = sizeof(struct amdgv_gpumon_metrics);
 
-		if ((tstamp - adapt->pp.metrics_cache.tstamp < PP_METRICS_CACHE_EXPIRY_US)) {
+		oss_spin_lock(adapt->gpumon.lock);
+		if (adapt->pp.metrics_cache.tstamp &&
+		    (tstamp - adapt->pp.metrics_cache.tstamp < PP_METRICS_CACHE_EXPIRY_US)) {
 			oss_memcpy(metrics, adapt->pp.metrics_cache.metrics, size);
+			oss_spin_unlock(adapt->gpumon.lock);
 			*event->data.gpumon_data.result = 0;
 			break;
 		}
+		oss_spin_unlock(adapt->gpumon.lock);
 
 		ret = adapt->gpumon.funcs->get_pp_metrics(adapt, metrics);
 		*event->data.gpumon_data.result = ret;
 
 		if (!ret) {
+			oss_spin_lock(adapt->gpumon.lock);
 			oss_memcpy(adapt->pp.metrics_cache.metrics, metrics, size);
 			adapt->pp.metrics_cache.tstamp = tstamp;
+			oss_spin_unlock(adapt->gpumon.lock);
 		}
 
 		break;
@@ -3527,11 +3539,14 @@ int amdgv_gpumon_handle_sched_event(struct amdgv_adapter *adapt,
 			amdgv_mca_get_new_banks(adapt, AMDGV_MCA_ERROR_TYPE_CE);
 		ret = amdgv_cper_get_entries(adapt,
 			event->data.gpumon_data.cper.get_entries.rptr,
+			event->data.gpumon_data.cper.get_entries.sev_mask,
 			event->data.gpumon_data.cper.get_entries.buf,
 			event->data.gpumon_data.cper.get_entries.buf_size,
+			event->data.gpumon_data.cper.get_entries.max_entries,
 			event->data.gpumon_data.cper.get_entries.write_count,
 			event->data.gpumon_data.cper.get_entries.overflow_count,
-			event->data.gpumon_data.cper.get_entries.left_size);
+			event->data.gpumon_data.cper.get_entries.left_size,
+			event->data.gpumon_data.cper.get_entries.next_rptr);
 		*event->data.gpumon_data.result = ret;
 		break;
 	case GPUMON_GET_GFX_CONFIG:
@@ -3547,6 +3562,186 @@ int amdgv_gpumon_handle_sched_event(struct amdgv_adapter *adapt,
 	return ret;
 }
 
+int amdgv_gpumon_handle_sched_event(struct amdgv_adapter *adapt,
+				    struct amdgv_sched_event *event)
+{
+	uint64_t start, end;
+	int ret;
+
+	start = oss_get_time_stamp();
+	ret = amdgv_gpumon_process(adapt, event);
+	end = oss_get_time_stamp();
+
+	oss_spin_lock(adapt->gpumon.lock);
+	amdgv_histogram_add(&adapt->gpumon.latency.queue_wait_us,
+			    start - event->timestamp);
+	amdgv_histogram_add(&adapt->gpumon.latency.handler_us, end - start);
+	oss_spin_unlock(adapt->gpumon.lock);
+
+	return ret;
+}
+
+/*
+ * Queries answered purely from driver memory (pptable, dpm tables, ip
+ * discovery, static attributes). They never touch registers or the SMU
+ * mailbox, so they do not need the serialization of the event thread.
+ * Only add a type here after checking every asic backend for it.
+ */
+static bool amdgv_gpumon_is_static_query(enum amdgv_gpumon_type type)
+{
+	switch (type) {
+	case GPUMON_GET_MAX_SCLK:
+	case GPUMON_GET_MAX_MCLK:
+	case GPUMON_GET_MAX_VCLK0:
+	case GPUMON_GET_MAX_VCLK1:
+	case GPUMON_GET_MAX_DCLK0:
+	case GPUMON_GET_MAX_DCLK1:
+	case GPUMON_GET_MIN_SCLK:
+	case GPUMON_GET_MIN_MCLK:
+	case GPUMON_GET_MIN_VCLK0:
+	case GPUMON_GET_MIN_VCLK1:
+	case GPUMON_GET_MIN_DCLK0:
+	case GPUMON_GET_MIN_DCLK1:
+	case GPUMON_GET_DPM_CAP:
+	case GPUMON_GET_CARD_FORM_FACTOR:
+	case GPUMON_GET_MAX_CONFIG_POWER_LIMIT:
+	case GPUMON_GET_DEFAULT_POWER_LIMIT:
+	case GPUMON_GET_MIN_POWER_LIMIT:
+	case GPUMON_GET_NUM_METRICS_EXT_ENTRIES:
+	case GPUMON_GET_SHUTDOWN_TEMP:
+	case GPUMON_GET_GPU_CACHE_INFO:
+	case GPUMON_GET_MAX_PCIE_LINK_GENERATION:
+	case GPUMON_GET_GFX_CONFIG:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Queries whose only input is the type and whose only output is the
+ * fixed-size buffer behind gpumon_data.ptr. Identical requests of these
+ * types can share one handler run. Returns the output size, or 0 when
+ * the type cannot be coalesced.
+ */
+uint32_t amdgv_gpumon_coalesce_size(int type)
+{
+	switch (type) {
+	case GPUMON_GET_PP_METRICS:
+		return sizeof(struct amdgv_gpumon_metrics);
+	case GPUMON_GET_ALL_TEMP:
+		return sizeof(struct amdgv_gpumon_temp);
+	case GPUMON_GET_SCLK:
+	case GPUMON_GET_ASIC_TEMP:
+	case GPUMON_GET_GPU_POWER_USAGE:
+	case GPUMON_GET_GPU_POWER_CAP:
+	case GPUMON_GET_VDDC:
+	case GPUMON_GET_DPM_STATUS:
+	case GPUMON_GET_GFX_ACT:
+	case GPUMON_GET_MEM_ACT:
+	case GPUMON_GET_UVD_ACT:
+	case GPUMON_GET_VCE_ACT:
+		return sizeof(int);
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Try to answer a gpumon query in the caller's context. Returns true when
+ * the query was handled and *data->gpumon_data.result is set, false when
+ * it has to go through the event thread.
+ */
+bool amdgv_gpumon_handle_fast_path(struct amdgv_adapter *adapt,
+				   union amdgv_sched_event_data *data)
+{
+	struct amdgv_sched_event event;
+	uint64_t start;
+	bool hit = false;
+
+	/* tables may be rebuilt while a reset is in flight */
+	if (in_whole_gpu_reset() || adapt->reset.in_xgmi_chain_reset)
+		return false;
+
+	if (adapt->gpumon.funcs == NULL)
+		return false;
+
+	start = oss_get_time_stamp();
+
+	if (amdgv_gpumon_is_static_query(data->gpumon_data.type)) {
+		oss_memset(&event, 0, sizeof(event));
+		event.idx_vf = AMDGV_PF_IDX;
+		event.id = AMDGV_EVENT_SCHED_GPUMON;
+		event.timestamp = start;
+		event.data = *data;
+		amdgv_gpumon_process(adapt, &event);
+		hit = true;
+	} else if (data->gpumon_data.type == GPUMON_GET_PP_METRICS) {
+		oss_spin_lock(adapt->gpumon.lock);
+		if (adapt->pp.metrics_cache.metrics && adapt->pp.metrics_cache.tstamp &&
+		    (start - adapt->pp.metrics_cache.tstamp < PP_METRICS_CACHE_EXPIRY_US)) {
+			oss_memcpy(data->gpumon_data.ptr, adapt->pp.metrics_cache.metrics,
+				   sizeof(struct amdgv_gpumon_metrics));
+			*data->gpumon_data.result = 0;
+			hit = true;
+		}
+		oss_spin_unlock(adapt->gpumon.lock);
+	}
+
+	if (!hit)
+		return false;
+
+	oss_spin_lock(adapt->gpumon.lock);
+	amdgv_histogram_add(&adapt->gpumon.latency.fast_path_us,
+			    oss_get_time_stamp() - start);
+	oss_spin_unlock(adapt->gpumon.lock);
+
+	return true;
+}
+
+int amdgv_gpumon_get_latency(amdgv_dev_t dev, struct amdgv_gpumon_latency *latency)
+{
+	struct amdgv_adapter *adapt;
+
+	SET_ADAPT_AND_CHECK_STATUS(adapt, dev);
+
+	oss_spin_lock(adapt->gpumon.lock);
+	oss_memcpy(latency, &adapt->gpumon.latency, sizeof(*latency));
+	oss_spin_unlock(adapt->gpumon.lock);
+
+	return 0;
+}
+
+int amdgv_gpumon_sw_init(struct amdgv_adapter *adapt)
+{
+	adapt->gpumon.lock = oss_spin_lock_init(AMDGV_SPIN_LOCK_HIGHEST_RANK);
+	if (adapt->gpumon.lock == OSS_INVALID_HANDLE)
+		return AMDGV_FAILURE;
+
+	/* a failed allocation only disables the pp metrics cache */
+	adapt->pp.metrics_cache.metrics = oss_zalloc(sizeof(struct amdgv_gpumon_metrics));
+	adapt->pp.metrics_cache.tstamp = 0;
+
+	amdgv_init_histogram_range(&adapt->gpumon.latency.fast_path_us);
+	amdgv_init_histogram_range(&adapt->gpumon.latency.queue_wait_us);
+	amdgv_init_histogram_range(&adapt->gpumon.latency.handler_us);
+
+	return 0;
+}
+
+void amdgv_gpumon_sw_fini(struct amdgv_adapter *adapt)
+{
+	if (adapt->pp.metrics_cache.metrics) {
+		oss_free(adapt->pp.metrics_cache.metrics);
+		adapt->pp.metrics_cache.metrics = NULL;
+	}
+
+	if (adapt->gpumon.lock != OSS_INVALID_HANDLE) {
+		oss_spin_lock_fini(adapt->gpumon.lock);
+		adapt->gpumon.lock = OSS_INVALID_HANDLE;
+	}
+}
+
 enum amdgv_xgmi_fb_sharing_mode amdgv_gpumon_xgmi_mode_map(
 	enum amdgv_gpumon_xgmi_fb_sharing_mode gpumon_mode)
 {
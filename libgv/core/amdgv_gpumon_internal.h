@@ -252,6 +252,9 @@ struct amdgv_gpumon {
 	uint32_t dev_id;
 	uint32_t rev_id;
 	const struct amdgv_gpumon_funcs *funcs;
+	/* protects pp.metrics_cache and the latency histograms */
+	spin_lock_t lock;
+	struct amdgv_gpumon_latency latency;
 };
 
 void amdgv_gpumon_update_load_start_time(struct amdgv_adapter *adapt, uint32_t idx_vf,
@@ -260,6 +263,11 @@ void amdgv_gpumon_update_save_end_time(struct amdgv_adapter *adapt, uint32_t idx
 				       struct amdgv_sched_world_switch *world_switch);
 int amdgv_gpumon_handle_sched_event(struct amdgv_adapter *adapt,
 				    struct amdgv_sched_event *event);
+uint32_t amdgv_gpumon_coalesce_size(int type);
+bool amdgv_gpumon_handle_fast_path(struct amdgv_adapter *adapt,
+				   union amdgv_sched_event_data *data);
+int amdgv_gpumon_sw_init(struct amdgv_adapter *adapt);
+void amdgv_gpumon_sw_fini(struct amdgv_adapter *adapt);
 
 int amdgv_vf_get_option_type(struct amdgv_adapter *adapt, enum amdgv_set_vf_opt_type *opt_type,
 			     struct amdgv_vf_option *opt);
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "amdgv_device.h"
+#include "amdgv_init_sched.h"
+
+#define STAGE_BIT(idx) (1ULL << (idx))
+
+static int amdgv_init_sched_find(struct amdgv_init_func **funcs, uint32_t num,
+				 const struct amdgv_init_func *func)
+{
+	uint32_t i;
+
+	for (i = 0; i < num; i++) {
+		if (funcs[i] == func)
+			return i;
+	}
+
+	return -1;
+}
+
+int amdgv_init_sched_build(struct amdgv_init_sched *sched,
+			   struct amdgv_init_func **funcs, uint32_t num)
+{
+	const struct amdgv_init_func *const *dep;
+	struct amdgv_init_sched_stage *stage;
+	uint32_t i;
+	int j;
+
+	if (num > AMDGV_INIT_SCHED_MAX_STAGES)
+		return AMDGV_FAILURE;
+
+	sched->num_stages = num;
+	sched->has_deps = false;
+
+	for (i = 0; i < num; i++) {
+		stage = &sched->stage[i];
+		oss_memset(stage, 0, sizeof(*stage));
+		stage->sched = sched;
+		stage->idx = i;
+
+		/* no declared dependencies, wait for everything before it */
+		stage->deps = STAGE_BIT(i) - 1;
+		if (funcs[i]->deps == NULL)
+			continue;
+
+		stage->deps = 0;
+		for (dep = funcs[i]->deps; *dep; dep++) {
+			j = amdgv_init_sched_find(funcs, num, *dep);
+			/* blocks the asic does not have are not waited for */
+			if (j < 0)
+				continue;
+			/* the table order is also the fini order, keep it */
+			if (j >= (int)i) {
+				stage->deps = STAGE_BIT(i) - 1;
+				break;
+			}
+			stage->deps |= STAGE_BIT(j);
+		}
+
+		if (stage->deps != STAGE_BIT(i) - 1)
+			sched->has_deps = true;
+	}
+
+	return 0;
+}
+
+static void amdgv_init_sched_run_stage(struct amdgv_init_sched_stage *stage)
+{
+	struct amdgv_init_sched *sched = stage->sched;
+
+	stage->ran = true;
+	stage->start_us = oss_get_time_stamp();
+	stage->ret = sched->run(sched->context, stage->idx);
+	stage->end_us = oss_get_time_stamp();
+}
+
+static int amdgv_init_sched_work_func(void *context)
+{
+	struct amdgv_init_sched_stage *stage = (struct amdgv_init_sched_stage *)context;
+	struct amdgv_init_sched *sched = stage->sched;
+
+	amdgv_init_sched_run_stage(stage);
+
+	oss_mutex_lock(sched->lock);
+	sched->finished |= STAGE_BIT(stage->idx);
+	oss_mutex_unlock(sched->lock);
+	oss_signal_event(sched->done);
+
+	return 0;
+}
+
+static void amdgv_init_sched_run_in_order(struct amdgv_init_sched *sched)
+{
+	uint32_t i;
+
+	for (i = 0; i < sched->num_stages; i++) {
+		amdgv_init_sched_run_stage(&sched->stage[i]);
+		if (sched->stage[i].ret < 0) {
+			sched->failed_stage = i;
+			break;
+		}
+	}
+}
+
+static void amdgv_init_sched_run_parallel(struct amdgv_init_sched *sched)
+{
+	struct amdgv_init_sched_stage *stage;
+	uint64_t started = 0;
+	uint64_t done = 0;
+	uint64_t finished;
+	uint64_t ready;
+	uint32_t i;
+
+	sched->finished = 0;
+
+	while (true) {
+		oss_mutex_lock(sched->lock);
+		finished = sched->finished;
+		oss_mutex_unlock(sched->lock);
+
+		for (i = 0; i < sched->num_stages; i++) {
+			if (!(finished & ~done & STAGE_BIT(i)))
+				continue;
+			if (sched->stage[i].ret < 0 &&
+			    (sched->failed_stage < 0 || (int)i < sched->failed_stage))
+				sched->failed_stage = i;
+		}
+		done = finished;
+
+		/* after a failure only wait for the stages still running */
+		ready = 0;
+		if (sched->failed_stage < 0) {
+			for (i = 0; i < sched->num_stages; i++) {
+				stage = &sched->stage[i];
+				if (!(started & STAGE_BIT(i)) && !(stage->deps & ~done))
+					ready |= STAGE_BIT(i);
+			}
+		}
+
+		if (!ready) {
+			if (started == done)
+				break;
+			oss_wait_event(sched->done, AMDGV_INIT_SCHED_WAIT_USEC);
+			continue;
+		}
+
+		started |= ready;
+
+		/* a lone stage with nothing else running is not worth a worker */
+		if (started == (done | ready) && !(ready & (ready - 1))) {
+			for (i = 0; !(ready & STAGE_BIT(i)); i++)
+				;
+			amdgv_init_sched_work_func(&sched->stage[i]);
+			continue;
+		}
+
+		/* any stage the OS refused runs here */
+		for (i = 0; i < sched->num_stages; i++) {
+			if (!(ready & STAGE_BIT(i)))
+				continue;
+			if (oss_schedule_work(sched->dev, amdgv_init_sched_work_func,
+					      &sched->stage[i]))
+				amdgv_init_sched_work_func(&sched->stage[i]);
+		}
+	}
+}
+
+/* longest chain of dependent stages that ran, in microseconds */
+static uint64_t amdgv_init_sched_critical_path(struct amdgv_init_sched *sched)
+{
+	uint64_t path[AMDGV_INIT_SCHED_MAX_STAGES];
+	uint64_t longest = 0;
+	uint64_t before;
+	uint32_t i, j;
+
+	for (i = 0; i < sched->num_stages; i++) {
+		path[i] = 0;
+		if (!sched->stage[i].ran)
+			continue;
+
+		before = 0;
+		for (j = 0; j < i; j++) {
+			if ((sched->stage[i].deps & STAGE_BIT(j)) && path[j] > before)
+				before = path[j];
+		}
+
+		path[i] = before + sched->stage[i].end_us - sched->stage[i].start_us;
+		if (path[i] > longest)
+			longest = path[i];
+	}
+
+	return longest;
+}
+
+/**
+ * amdgv_init_sched_run - run every stage once
+ *
+ * @sched: scheduler set up by amdgv_init_sched_build()
+ *
+ * Returns:
+ * 0 if all stages succeeded, else the return value of the first failed
+ * stage. Stages that depend on a failed one are not run, see ran.
+ */
+int amdgv_init_sched_run(struct amdgv_init_sched *sched)
+{
+	struct amdgv_init_sched_stage *stage;
+	uint64_t start;
+	uint32_t i;
+
+	sched->failed_stage = -1;
+	sched->lock = OSS_INVALID_HANDLE;
+	sched->done = OSS_INVALID_HANDLE;
+
+	for (i = 0; i < sched->num_stages; i++) {
+		sched->stage[i].ran = false;
+		sched->stage[i].ret = 0;
+	}
+
+	/* a plain chain has nothing to overlap, skip the lock and event */
+	if (sched->parallel && sched->has_deps && sched->num_stages > 1) {
+		sched->lock = oss_mutex_init();
+		sched->done = oss_event_init();
+	}
+
+	start = oss_get_time_stamp();
+
+	if (sched->lock == OSS_INVALID_HANDLE || sched->done == OSS_INVALID_HANDLE)
+		amdgv_init_sched_run_in_order(sched);
+	else
+		amdgv_init_sched_run_parallel(sched);
+
+	sched->total_us = oss_get_time_stamp() - start;
+
+	if (sched->lock != OSS_INVALID_HANDLE)
+		oss_mutex_fini(sched->lock);
+	if (sched->done != OSS_INVALID_HANDLE)
+		oss_event_fini(sched->done);
+
+	for (i = 0; i < sched->num_stages; i++) {
+		stage = &sched->stage[i];
+		if (!stage->ran)
+			continue;
+		stage->start_us -= start;
+		stage->end_us -= start;
+	}
+
+	sched->critical_path_us = amdgv_init_sched_critical_path(sched);
+
+	if (sched->failed_stage >= 0)
+		return sched->stage[sched->failed_stage].ret;
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AMDGV_INIT_SCHED_H
+#define AMDGV_INIT_SCHED_H
+
+#include "amdgv_oss_wrapper.h"
+
+struct amdgv_init_func;
+
+/* dependencies are tracked in one 64 bit mask per stage */
+#define AMDGV_INIT_SCHED_MAX_STAGES 64
+/* how long the scheduler sleeps between checks for finished stages */
+#define AMDGV_INIT_SCHED_WAIT_USEC  1000
+
+struct amdgv_init_sched;
+
+struct amdgv_init_sched_stage {
+	struct amdgv_init_sched *sched;
+	uint32_t idx;
+	int ret;
+	bool ran;
+	/* stages that must finish before this one starts */
+	uint64_t deps;
+	/* relative to the start of amdgv_init_sched_run() */
+	uint64_t start_us;
+	uint64_t end_us;
+};
+
+/* Runs the stages of an init function table in dependency order.
+ *
+ * Each entry lists the entries it depends on in its deps field. With
+ * parallel set, stages whose dependencies have all finished are handed
+ * to the OS work queue together. Otherwise, or without any declared
+ * dependencies, the stages run one by one in table order as before.
+ * Only the oss helpers are used here, so the scheduler can be linked
+ * into a userspace program, see tools/init_sched_sim.
+ */
+struct amdgv_init_sched {
+	oss_dev_t dev;
+	bool parallel;
+	/* runs one stage, a negative return stops the scheduling */
+	int (*run)(void *context, uint32_t idx);
+	void *context;
+
+	uint32_t num_stages;
+	struct amdgv_init_sched_stage stage[AMDGV_INIT_SCHED_MAX_STAGES];
+	/* some stage does not wait for every stage before it */
+	bool has_deps;
+
+	/* results of the last run */
+	uint64_t total_us;
+	/* longest chain of dependent stages, the floor for total_us */
+	uint64_t critical_path_us;
+	/* index of the failed stage, -1 if all stages succeeded */
+	int failed_stage;
+
+	/* set by the stages as they finish, under lock */
+	mutex_t lock;
+	event_t done;
+	uint64_t finished;
+};
+
+int amdgv_init_sched_build(struct amdgv_init_sched *sched,
+			   struct amdgv_init_func **funcs, uint32_t num);
+int amdgv_init_sched_run(struct amdgv_init_sched *sched);
+
+#endif // AMDGV_INIT_SCHED_H
@@ -349,6 +349,9 @@ int amdgv_ih_iv_ring_entry_process(struct amdgv_adapter *adapt, struct amdgv_iv_
 	case IH_IV_SRCID_BIF_PF_VF_MSGBUF_ACK:
 		AMDGV_DEBUG("PF_VF_MSGBUF_ACK received\n");
 
+		/* wake up amdgv_mailbox_wait_trn_msg_ack() */
+		amdgv_wait_site_irq(adapt, AMDGV_WAIT_SITE_MAILBOX_ACK);
+
 		idx_vf = entry->src_data[0];
 		if (idx_vf < adapt->num_vf) {
 			if (amdgv_guard_add_active_event(adapt, idx_vf,
@@ -29,6 +29,142 @@
 
 static const uint32_t this_block = AMDGV_COMMUNICATION_BLOCK;
 
+/* one live info op handed to the OS work queue */
+struct amdgv_live_info_work {
+	struct amdgv_adapter *adapt;
+	uint32_t data_op;
+	bool is_export;
+	void *data;
+	enum amdgv_live_info_status status;
+	atomic_t pending;
+	event_t done;
+};
+
+/*
+ * Ops that only touch their own block's state and do not depend on
+ * their neighbours. With parallel_live_update a run of adjacent ones is
+ * held back and run together before the next ordered op, so every op
+ * still runs after the ones it used to follow. WS_STATE is left out,
+ * VF import updates the time slices it restores.
+ */
+static bool amdgv_live_info_op_is_parallel(struct amdgv_adapter *adapt, uint32_t data_op)
+{
+	if (!adapt->opt.parallel_live_update)
+		return false;
+
+	switch (data_op) {
+	case AMDGV_LIVE_INFO_DATA__VF:
+	case AMDGV_LIVE_INFO_DATA__FFBM:
+	case AMDGV_LIVE_INFO_DATA__RING:
+	case AMDGV_LIVE_INFO_DATA__MCA:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void amdgv_live_info_run_op(struct amdgv_live_info_work *work)
+{
+	struct amdgv_adapter *adapt = work->adapt;
+	uint64_t start = oss_get_time_stamp();
+	uint32_t *timing;
+
+	if (work->is_export) {
+		amdgv_live_info_export_data(adapt, work->data_op, work->data, &work->status);
+		timing = adapt->live_info_timing.export_us;
+	} else {
+		amdgv_live_info_import_data(adapt, work->data_op, work->data, &work->status);
+		timing = adapt->live_info_timing.import_us;
+	}
+
+	timing[work->data_op] = (uint32_t)(oss_get_time_stamp() - start);
+}
+
+static int amdgv_live_info_work_func(void *context)
+{
+	struct amdgv_live_info_work *work = (struct amdgv_live_info_work *)context;
+
+	amdgv_live_info_run_op(work);
+
+	if (oss_atomic_dec_return(work->pending) == 0)
+		oss_signal_event(work->done);
+
+	return 0;
+}
+
+/* run the held back ops side by side, returns the first failing status */
+static enum amdgv_live_info_status amdgv_live_info_run_parallel(struct amdgv_adapter *adapt,
+								struct amdgv_live_info_work *work,
+								uint32_t num, uint32_t *failed_op)
+{
+	bool run_here[AMDGV_LIVE_INFO_DATA__END];
+	atomic_t pending = OSS_INVALID_HANDLE;
+	event_t done = OSS_INVALID_HANDLE;
+	uint32_t i;
+
+	if (num > 1) {
+		pending = oss_atomic_init();
+		done = oss_event_init();
+	}
+
+	if (pending == OSS_INVALID_HANDLE || done == OSS_INVALID_HANDLE) {
+		for (i = 0; i < num; i++)
+			amdgv_live_info_run_op(&work[i]);
+	} else {
+		oss_atomic_set(pending, num);
+		for (i = 0; i < num; i++) {
+			work[i].pending = pending;
+			work[i].done = done;
+		}
+
+		/* the caller takes the first op and any the OS refused */
+		run_here[0] = true;
+		for (i = 1; i < num; i++)
+			run_here[i] = oss_schedule_work(adapt->dev, amdgv_live_info_work_func,
+							&work[i]) != 0;
+
+		for (i = 0; i < num; i++) {
+			if (run_here[i])
+				amdgv_live_info_work_func(&work[i]);
+		}
+
+		while (oss_atomic_read(pending) != 0)
+			oss_wait_event(done, LIVE_INFO_PARALLEL_WAIT_USEC);
+	}
+
+	if (pending != OSS_INVALID_HANDLE)
+		oss_atomic_fini(pending);
+	if (done != OSS_INVALID_HANDLE)
+		oss_event_fini(done);
+
+	for (i = 0; i < num; i++) {
+		if (work[i].status) {
+			*failed_op = work[i].data_op;
+			return work[i].status;
+		}
+	}
+
+	return AMDGV_LIVE_INFO_STATUS_SUCCESS;
+}
+
+/* the adapter is torn down right after an export, so export logs every op */
+static void amdgv_live_info_log_timing(struct amdgv_adapter *adapt, const char *dir,
+				       const uint32_t *timing, uint64_t total, bool per_op)
+{
+	uint32_t data_op, slowest = 0;
+
+	for (data_op = 0; data_op < AMDGV_LIVE_INFO_DATA__END; data_op++) {
+		if (timing[data_op] > timing[slowest])
+			slowest = data_op;
+		if (per_op && timing[data_op])
+			AMDGV_INFO("Live info %s op %u took %uus\n", dir, data_op,
+				   timing[data_op]);
+	}
+
+	AMDGV_INFO("Live info %s took %lluus, slowest op %u %uus\n", dir, total, slowest,
+		   timing[slowest]);
+}
+
 enum amdgv_live_info_status amdgv_import_data_by_op(struct amdgv_adapter *adapt,
 							   uint32_t data_op)
 {
@@ -59,11 +195,12 @@ enum amdgv_live_info_status amdgv_import_data_by_op(struct amdgv_adapter *adapt,
 enum amdgv_live_info_status amdgv_import_data(struct amdgv_adapter *adapt)
 {
 	enum amdgv_live_info_status status = AMDGV_LIVE_INFO_STATUS_FEATURE_NOT_SUPPORTED;
+	struct amdgv_live_info_work work[AMDGV_LIVE_INFO_DATA__END];
 	void *gpu_data;
-	struct live_info_table_header *header;
-	uint32_t op_num, offset;
+	uint32_t op_num, num = 0;
 	uint32_t *op_offset;
-	enum amdgv_live_info_data data_op;
+	uint32_t data_op, failed_op = AMDGV_LIVE_INFO_DATA__END;
+	uint64_t start;
 
 	if (!adapt->opt.skip_hw_init)
 		return 0;
@@ -72,23 +209,54 @@ enum amdgv_live_info_status amdgv_import_data(struct amdgv_adapter *adapt)
 	op_num    =  ((struct amdgv_gpu_data_v2 *)gpu_data)->header.op_num;
 	op_offset = &((struct amdgv_gpu_data_v2 *)gpu_data)->header.op_offset[0];
 
-	for (data_op = AMDGV_LIVE_INFO_DATA__CRITICAL_STATE; data_op < op_num; data_op++) {
+	start = oss_get_time_stamp();
+	for (data_op = AMDGV_LIVE_INFO_DATA__CRITICAL_STATE;
+	     data_op < min(op_num, (uint32_t)AMDGV_LIVE_INFO_DATA__END); data_op++) {
 		if ((data_op != AMDGV_LIVE_INFO_DATA__MODULE_PARAM_PRE) &&
 			(data_op != AMDGV_LIVE_INFO_DATA__MEMMGR) &&
 			(data_op != AMDGV_LIVE_INFO_DATA__UNPROCESSED_EVENT)) {
-			offset = op_offset[data_op];
-			header = (struct live_info_table_header *)((char *)gpu_data + offset);
-			amdgv_live_info_import_data(adapt, data_op, (void *)header,
-							&status);
+			/* the held back group goes before the next ordered op */
+			if (num && !amdgv_live_info_op_is_parallel(adapt, data_op)) {
+				status = amdgv_live_info_run_parallel(adapt, work, num, &failed_op);
+				num = 0;
+				if (status)
+					break;
+			}
+
+			work[num].adapt = adapt;
+			work[num].data_op = data_op;
+			work[num].is_export = false;
+			work[num].data = (char *)gpu_data + op_offset[data_op];
+			work[num].status = AMDGV_LIVE_INFO_STATUS_FEATURE_NOT_SUPPORTED;
+			if (amdgv_live_info_op_is_parallel(adapt, data_op)) {
+				num++;
+				continue;
+			}
+
+			amdgv_live_info_run_op(&work[num]);
+			status = work[num].status;
 			if (status) {
-				adapt->opt.skip_hw_init = 0;
-				AMDGV_ERROR("Import %d data fail, Enable interrupt.\n", data_op);
-				amdgv_toggle_interrupt(adapt, true);
-				return status;
+				failed_op = data_op;
+				break;
 			}
 		}
 	}
 
+	if (failed_op == AMDGV_LIVE_INFO_DATA__END && num)
+		status = amdgv_live_info_run_parallel(adapt, work, num, &failed_op);
+
+	adapt->live_info_timing.import_total_us = oss_get_time_stamp() - start;
+
+	if (failed_op != AMDGV_LIVE_INFO_DATA__END) {
+		adapt->opt.skip_hw_init = 0;
+		AMDGV_ERROR("Import %d data fail, Enable interrupt.\n", failed_op);
+		amdgv_toggle_interrupt(adapt, true);
+		return status;
+	}
+
+	amdgv_live_info_log_timing(adapt, "import", adapt->live_info_timing.import_us,
+				   adapt->live_info_timing.import_total_us, false);
+
 	/* get ih info */
 	if (!adapt->irqmgr.disable_parse_ih) {
 		if (adapt->irqmgr.ih_funcs->get_rptr) {
@@ -117,10 +285,11 @@ enum amdgv_live_info_status amdgv_import_data(struct amdgv_adapter *adapt)
 enum amdgv_live_info_status amdgv_export_data(struct amdgv_adapter *adapt)
 {
 	enum amdgv_live_info_status status = AMDGV_LIVE_INFO_STATUS_SUCCESS;
+	struct amdgv_live_info_work work[AMDGV_LIVE_INFO_DATA__END];
 	void *gpu_data;
-	struct live_info_table_header *header;
-	uint32_t offset;
-	enum amdgv_live_info_data data_op;
+	uint32_t offset, num = 0;
+	uint32_t data_op, failed_op = AMDGV_LIVE_INFO_DATA__END;
+	uint64_t start;
 
 	if ((adapt->flags & AMDGV_FLAG_GPUV_LIVE_UPDATE) || adapt->fini_opt.skip_hw_fini) {
 		gpu_data = adapt->sys_mem_info.va_ptr;
@@ -128,18 +297,51 @@ enum amdgv_live_info_status amdgv_export_data(struct amdgv_adapter *adapt)
 			AMDGV_ERROR("no gpu_data!!\n");
 			return 0;
 		}
+
+		start = oss_get_time_stamp();
 		for (data_op = AMDGV_LIVE_INFO_DATA__CRITICAL_STATE; data_op < AMDGV_LIVE_INFO_DATA__END; data_op++) {
 			if (data_op != AMDGV_LIVE_INFO_DATA__IP_DISCOVERY) {
+				if (num && !amdgv_live_info_op_is_parallel(adapt, data_op)) {
+					status = amdgv_live_info_run_parallel(adapt, work, num,
+									      &failed_op);
+					num = 0;
+					if (status)
+						break;
+				}
+
 				offset = ((struct amdgv_gpu_data_v2 *)gpu_data)->header.op_offset[data_op];
-				header = (struct live_info_table_header *)((char *)gpu_data + offset);
-				amdgv_live_info_export_data(adapt, data_op, (void *)header, &status);
+				work[num].adapt = adapt;
+				work[num].data_op = data_op;
+				work[num].is_export = true;
+				work[num].data = (char *)gpu_data + offset;
+				work[num].status = AMDGV_LIVE_INFO_STATUS_GENERIC_ERROR;
+				if (amdgv_live_info_op_is_parallel(adapt, data_op)) {
+					num++;
+					continue;
+				}
+
+				amdgv_live_info_run_op(&work[num]);
+				status = work[num].status;
 				if (status) {
-					adapt->fini_opt.export_status = false;
-					AMDGV_INFO("Export %d data fail\n", data_op);
-					return status;
+					failed_op = data_op;
+					break;
 				}
 			}
 		}
+
+		if (failed_op == AMDGV_LIVE_INFO_DATA__END && num)
+			status = amdgv_live_info_run_parallel(adapt, work, num, &failed_op);
+
+		adapt->live_info_timing.export_total_us = oss_get_time_stamp() - start;
+
+		if (failed_op != AMDGV_LIVE_INFO_DATA__END) {
+			adapt->fini_opt.export_status = false;
+			AMDGV_INFO("Export %d data fail\n", failed_op);
+			return status;
+		}
+
+		amdgv_live_info_log_timing(adapt, "export", adapt->live_info_timing.export_us,
+					   adapt->live_info_timing.export_total_us, true);
 	}
 
 	if (adapt->fini_opt.skip_hw_fini)
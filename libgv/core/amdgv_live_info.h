@@ -56,6 +56,7 @@ extern struct amdgv_adapter *adapt;
 #define LIVE_INFO_HASH_ADDR 0x108
 
 #define LIVE_INFO_DELAY_CHECK_USEC 500000
+#define LIVE_INFO_PARALLEL_WAIT_USEC 1000
 
 enum amdgv_live_info_data {
 	/* critical state*/
@@ -827,6 +828,10 @@ _Static_assert(
 	sizeof(struct __common_data_size_check) == AMDGV_LIVE_INFO_COMMON_DATA_SIZE,
 	"amdgv_live_update_common_data size must match AMDGV_LIVE_INFO_COMMON_DATA_SIZE");
 
+_Static_assert(
+	AMDGV_LIVE_INFO_DATA__END <= AMDGV_LIVE_INFO_TIMING_MAX_OP,
+	"amdgv_live_info_timing must have a slot for every live info data op");
+
 #undef _stringification
 #undef stringification
 #endif
@@ -265,3 +265,196 @@ exit:
 	return ret;
 }
 
+
+/* package buffer and section behind an export or import phase */
+static struct amdgv_memmgr_mem *amdgv_migration_chunked_mem(struct amdgv_adapter *adapt,
+							   uint32_t phase, bool to_export,
+							   enum amdgv_migration_data_section *section)
+{
+	if ((to_export && phase == AMDGV_MIGRATION_EXPORT_PHASE1_STATIC_DATA) ||
+	    (!to_export && phase == AMDGV_MIGRATION_IMPORT_PHASE2_STATIC_DATA)) {
+		*section = AMDGV_MIGRATION_CONTENT_VF_HW_STATIC_DATA;
+		return adapt->live_migration.static_data_mem;
+	}
+
+	if ((to_export && phase == AMDGV_MIGRATION_EXPORT_PHASE2_DYNAMIC_DATA) ||
+	    (!to_export && phase == AMDGV_MIGRATION_IMPORT_PHASE3_DYNAMIC_DATA)) {
+		*section = AMDGV_MIGRATION_CONTENT_VF_HW_DYNAMIC_DATA;
+		return adapt->live_migration.dynamic_data_mem;
+	}
+
+	return NULL;
+}
+
+int amdgv_migration_chunked_start(struct amdgv_adapter *adapt,
+				 struct amdgv_migration_chunked *copy, bool to_export)
+{
+	struct amdgv_migration_chunked_state *state = &adapt->live_migration.chunked;
+	enum amdgv_migration_data_section section;
+	struct amdgv_memmgr_mem *mem;
+	uint64_t size = 0;
+	uint32_t chunk_size;
+	uint32_t i;
+
+	if (copy->idx_vf >= adapt->num_vf)
+		return AMDGV_FAILURE;
+
+	mem = amdgv_migration_chunked_mem(adapt, copy->phase, to_export, &section);
+	if (mem == NULL) {
+		AMDGV_ERROR("No migration package buffer for phase%d.\n", copy->phase);
+		return AMDGV_FAILURE;
+	}
+
+	if (amdgv_migration_get_psp_data_size(adapt, &size, section) || size == 0) {
+		AMDGV_ERROR("Failed to get package size for phase%d.\n", copy->phase);
+		return AMDGV_FAILURE;
+	}
+
+	/* a large package gets larger chunks rather than a larger chunk map */
+	chunk_size = copy->chunk_size ? copy->chunk_size : AMDGV_MIGRATION_CHUNK_SIZE;
+	if (size > (uint64_t)chunk_size * AMDGV_MIGRATION_MAX_CHUNKS)
+		chunk_size = (uint32_t)roundup((size + AMDGV_MIGRATION_MAX_CHUNKS - 1) /
+					       AMDGV_MIGRATION_MAX_CHUNKS, AMDGV_GPU_PAGE_SIZE);
+
+	/* a new copy invalidates readers and writers of the old one, wait
+	 * for the chunk copies in flight before the buffer is reused
+	 */
+	oss_rwsema_write_lock(state->lock);
+	state->active = false;
+
+	if (to_export && amdgv_migration_export_vf(adapt, copy->idx_vf,
+						   amdgv_memmgr_get_cpu_addr(mem),
+						   copy->phase)) {
+		oss_rwsema_write_unlock(state->lock);
+		return AMDGV_FAILURE;
+	}
+
+	state->to_export = to_export;
+	state->idx_vf = copy->idx_vf;
+	state->phase = copy->phase;
+	state->mem = mem;
+	state->size = size;
+	state->chunk_size = chunk_size;
+	state->num_chunks = (uint32_t)((size + chunk_size - 1) / chunk_size);
+	for (i = 0; i < AMDGV_MIGRATION_CHUNK_MAP_WORDS; i++)
+		oss_atomic_set(&state->chunk_map[i], 0);
+	oss_atomic_set(&state->chunks_done, 0);
+	state->active = true;
+
+	copy->chunk_size = chunk_size;
+	copy->size = size;
+	copy->num_chunks = state->num_chunks;
+	oss_rwsema_write_unlock(state->lock);
+
+	return 0;
+}
+
+/* bytes of chunk inside the package, 0 if copy does not match the state,
+ * called with the copy lock held
+ */
+static uint32_t amdgv_migration_chunk_len(struct amdgv_adapter *adapt,
+						 struct amdgv_migration_chunked *copy,
+						 uint32_t chunk, bool to_export)
+{
+	struct amdgv_migration_chunked_state *state = &adapt->live_migration.chunked;
+	uint64_t offset;
+
+	if (!state->active || state->to_export != to_export ||
+	    state->idx_vf != copy->idx_vf || state->phase != copy->phase ||
+	    state->chunk_size != copy->chunk_size || chunk >= state->num_chunks)
+		return 0;
+
+	offset = (uint64_t)chunk * state->chunk_size;
+
+	return (uint32_t)min((uint64_t)state->chunk_size, state->size - offset);
+}
+
+int amdgv_migration_chunked_read(struct amdgv_adapter *adapt,
+				struct amdgv_migration_chunked *copy, uint32_t chunk,
+				void *buf, uint32_t *size)
+{
+	struct amdgv_migration_chunked_state *state = &adapt->live_migration.chunked;
+	uint32_t len;
+
+	oss_rwsema_read_lock(state->lock);
+	len = amdgv_migration_chunk_len(adapt, copy, chunk, true);
+	if (len == 0) {
+		oss_rwsema_read_unlock(state->lock);
+		return AMDGV_FAILURE;
+	}
+
+	oss_memcpy(buf, (uint8_t *)amdgv_memmgr_get_cpu_addr(state->mem) +
+		   (uint64_t)chunk * state->chunk_size, len);
+	oss_rwsema_read_unlock(state->lock);
+	*size = len;
+
+	return 0;
+}
+
+int amdgv_migration_chunked_write(struct amdgv_adapter *adapt,
+				 struct amdgv_migration_chunked *copy, uint32_t chunk,
+				 const void *buf, uint32_t size)
+{
+	struct amdgv_migration_chunked_state *state = &adapt->live_migration.chunked;
+	oss_atomic64_t *word;
+	uint64_t old, bit;
+	uint32_t len;
+
+	/* writers of distinct chunks share the lock, the chunk map is atomic */
+	oss_rwsema_read_lock(state->lock);
+	len = amdgv_migration_chunk_len(adapt, copy, chunk, false);
+	if (len == 0 || len != size) {
+		oss_rwsema_read_unlock(state->lock);
+		return AMDGV_FAILURE;
+	}
+
+	oss_memcpy((uint8_t *)amdgv_memmgr_get_cpu_addr(state->mem) +
+		   (uint64_t)chunk * state->chunk_size, buf, len);
+
+	/* a chunk sent twice is copied again but counted once */
+	word = &state->chunk_map[chunk / 64];
+	bit = 1ULL << (chunk % 64);
+	do {
+		old = oss_atomic_read(word);
+		if (old & bit)
+			goto out;
+	} while (oss_atomic_cmpxchg(word, old, old | bit) != old);
+
+	oss_atomic_inc(&state->chunks_done);
+
+out:
+	oss_rwsema_read_unlock(state->lock);
+	return 0;
+}
+
+int amdgv_migration_chunked_finish(struct amdgv_adapter *adapt,
+				  struct amdgv_migration_chunked *copy)
+{
+	struct amdgv_migration_chunked_state *state = &adapt->live_migration.chunked;
+	uint64_t done;
+	int ret;
+
+	/* no chunk writer may touch the package while PSP imports it */
+	oss_rwsema_write_lock(state->lock);
+	if (amdgv_migration_chunk_len(adapt, copy, 0, false) == 0) {
+		ret = AMDGV_FAILURE;
+		goto out;
+	}
+
+	done = oss_atomic_read(&state->chunks_done);
+	if (done != state->num_chunks) {
+		AMDGV_ERROR("Migration import: %llu of %u chunks received.\n",
+			    done, state->num_chunks);
+		ret = AMDGV_FAILURE;
+		goto out;
+	}
+
+	state->active = false;
+
+	ret = amdgv_migration_import_vf(adapt, copy->idx_vf,
+					amdgv_memmgr_get_cpu_addr(state->mem), copy->phase);
+
+out:
+	oss_rwsema_write_unlock(state->lock);
+	return ret;
+}
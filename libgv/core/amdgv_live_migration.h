@@ -24,6 +24,27 @@
 #ifndef AMDGV_LIVE_MIGRATION_H
 #define AMDGV_LIVE_MIGRATION_H
 
+/* chunks a package copy can span, one bit each */
+#define AMDGV_MIGRATION_MAX_CHUNKS	1024
+#define AMDGV_MIGRATION_CHUNK_MAP_WORDS	(AMDGV_MIGRATION_MAX_CHUNKS / 64)
+
+struct amdgv_migration_chunked_state {
+	/* chunk copies hold it for read, start and finish for write */
+	rwsema_t		lock;
+	bool			active;
+	bool			to_export;
+	uint32_t		idx_vf;
+	uint32_t		phase;
+	/* package buffer on FB, static_data_mem or dynamic_data_mem */
+	struct amdgv_memmgr_mem *mem;
+	uint64_t		size;
+	uint32_t		chunk_size;
+	uint32_t		num_chunks;
+	/* chunks written so far, import only */
+	oss_atomic64_t		chunk_map[AMDGV_MIGRATION_CHUNK_MAP_WORDS];
+	oss_atomic64_t		chunks_done;
+};
+
 struct amdgv_live_migration {
 
 	struct amdgv_memmgr_mem		*static_data_mem;
@@ -31,6 +52,8 @@ struct amdgv_live_migration {
 
 	mutex_t						lm_lock;
 	const struct amdgv_lm_funcs *lm_funcs;
+
+	struct amdgv_migration_chunked_state chunked;
 };
 
 struct amdgv_lm_funcs {
@@ -56,5 +79,13 @@ int amdgv_migration_export_vf(struct amdgv_adapter *adapt, uint32_t idx_vf,
 	void* data_dst, enum amdgv_migration_export_phase phase);
 int amdgv_migration_import_vf(struct amdgv_adapter *adapt, uint32_t idx_vf,
 	void* data_src, enum amdgv_migration_import_phase phase);
+int amdgv_migration_chunked_start(struct amdgv_adapter *adapt,
+	struct amdgv_migration_chunked *copy, bool to_export);
+int amdgv_migration_chunked_read(struct amdgv_adapter *adapt,
+	struct amdgv_migration_chunked *copy, uint32_t chunk, void *buf, uint32_t *size);
+int amdgv_migration_chunked_write(struct amdgv_adapter *adapt,
+	struct amdgv_migration_chunked *copy, uint32_t chunk, const void *buf, uint32_t size);
+int amdgv_migration_chunked_finish(struct amdgv_adapter *adapt,
+	struct amdgv_migration_chunked *copy);
 
 #endif
@@ -436,7 +436,9 @@ static int amdgv_mailbox_wait_trn_msg_ack_cb(void *context)
  */
 int amdgv_mailbox_wait_trn_msg_ack(struct amdgv_adapter *adapt)
 {
-	uint32_t wait_flag = 0;
+	/* the VF ack raises PF_VF_MSGBUF_ACK, sleep on it between polls */
+	uint32_t wait_flag = AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_MAILBOX_ACK) |
+			     AMDGV_WAIT_FLAG_IRQ;
 
 	if (!adapt->mailbox.funcs->peek_ack) {
 		return AMDGV_FAILURE;
@@ -34,6 +34,7 @@ static const uint32_t this_block = AMDGV_MEMORY_BLOCK;
 #define DEFAULT_ALIGN_SHIFT		12
 #define DEFAULT_SIZE			(0x1ULL << 36)
 #define AMDGV_MEMMGR_ALIGN(addr, align) (((addr) + (align)-1) & ~(align - 1))
+#define MEMMGR_PRIO_SEED		0x9E3779B9
 
 static const char *amdgv_mem_id_name(uint32_t id)
 {
@@ -194,6 +195,10 @@ int amdgv_memmgr_init(struct amdgv_adapter *adapt, struct amdgv_memmgr *memmgr,
 	memmgr->allocs->len = 0;
 	memmgr->allocs->memmgr = memmgr;
 
+	memmgr->root = NULL;
+	memmgr->prio_seed = MEMMGR_PRIO_SEED;
+	oss_memset(memmgr->id_hash, 0, sizeof(memmgr->id_hash));
+
 	memmgr->tom = offset;
 
 	memmgr->adapt = adapt;
@@ -206,45 +211,283 @@ int amdgv_memmgr_init(struct amdgv_adapter *adapt, struct amdgv_memmgr *memmgr,
 	return 0;
 }
 
+static inline uint64_t amdgv_memmgr_mem_start(struct amdgv_memmgr_mem *mem)
+{
+	return mem->alloc_off - mem->len;
+}
+
+/* Treap order: start offset, then end offset, then node address as tie breaker */
+static bool amdgv_memmgr_mem_before(struct amdgv_memmgr_mem *a, struct amdgv_memmgr_mem *b)
+{
+	if (amdgv_memmgr_mem_start(a) != amdgv_memmgr_mem_start(b))
+		return amdgv_memmgr_mem_start(a) < amdgv_memmgr_mem_start(b);
+	if (a->alloc_off != b->alloc_off)
+		return a->alloc_off < b->alloc_off;
+	return a < b;
+}
+
+static uint32_t amdgv_memmgr_next_prio(struct amdgv_memmgr *memmgr)
+{
+	uint32_t x = memmgr->prio_seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	memmgr->prio_seed = x;
+
+	return x;
+}
+
+static void amdgv_memmgr_tree_update(struct amdgv_memmgr_mem *t)
+{
+	t->max_gap = t->gap;
+	if (t->left && t->left->max_gap > t->max_gap)
+		t->max_gap = t->left->max_gap;
+	if (t->right && t->right->max_gap > t->max_gap)
+		t->max_gap = t->right->max_gap;
+}
+
+/* Split t into nodes ordered before key (l) and the rest (r) */
+static void amdgv_memmgr_tree_split(struct amdgv_memmgr_mem *t, struct amdgv_memmgr_mem *key,
+				    struct amdgv_memmgr_mem **l, struct amdgv_memmgr_mem **r)
+{
+	if (!t) {
+		*l = NULL;
+		*r = NULL;
+		return;
+	}
+
+	if (amdgv_memmgr_mem_before(t, key)) {
+		amdgv_memmgr_tree_split(t->right, key, &t->right, r);
+		*l = t;
+	} else {
+		amdgv_memmgr_tree_split(t->left, key, l, &t->left);
+		*r = t;
+	}
+	amdgv_memmgr_tree_update(t);
+}
+
+/* Join two treaps, every node of l is ordered before every node of r */
+static struct amdgv_memmgr_mem *amdgv_memmgr_tree_merge(struct amdgv_memmgr_mem *l,
+							struct amdgv_memmgr_mem *r)
+{
+	if (!l)
+		return r;
+	if (!r)
+		return l;
+
+	if (l->prio > r->prio) {
+		l->right = amdgv_memmgr_tree_merge(l->right, r);
+		amdgv_memmgr_tree_update(l);
+		return l;
+	}
+
+	r->left = amdgv_memmgr_tree_merge(l, r->left);
+	amdgv_memmgr_tree_update(r);
+	return r;
+}
+
+static struct amdgv_memmgr_mem *amdgv_memmgr_tree_remove(struct amdgv_memmgr_mem *t,
+							 struct amdgv_memmgr_mem *mem)
+{
+	if (!t)
+		return NULL;
+
+	if (t == mem)
+		return amdgv_memmgr_tree_merge(t->left, t->right);
+
+	if (amdgv_memmgr_mem_before(mem, t))
+		t->left = amdgv_memmgr_tree_remove(t->left, mem);
+	else
+		t->right = amdgv_memmgr_tree_remove(t->right, mem);
+	amdgv_memmgr_tree_update(t);
+
+	return t;
+}
+
+/* Propagate a changed gap of mem up to the root */
+static void amdgv_memmgr_tree_refresh(struct amdgv_memmgr_mem *t, struct amdgv_memmgr_mem *mem)
+{
+	if (!t)
+		return;
+
+	if (t != mem) {
+		if (amdgv_memmgr_mem_before(mem, t))
+			amdgv_memmgr_tree_refresh(t->left, mem);
+		else
+			amdgv_memmgr_tree_refresh(t->right, mem);
+	}
+	amdgv_memmgr_tree_update(t);
+}
+
+/* Last allocation ordered before mem, NULL if mem would be the first one */
+static struct amdgv_memmgr_mem *amdgv_memmgr_tree_prev(struct amdgv_memmgr *memmgr,
+						       struct amdgv_memmgr_mem *mem)
+{
+	struct amdgv_memmgr_mem *t = memmgr->root;
+	struct amdgv_memmgr_mem *prev = NULL;
+
+	while (t) {
+		if (amdgv_memmgr_mem_before(t, mem)) {
+			prev = t;
+			t = t->right;
+		} else {
+			t = t->left;
+		}
+	}
+
+	return prev;
+}
+
+static void amdgv_memmgr_set_gap(struct amdgv_memmgr *memmgr, struct amdgv_memmgr_mem *mem)
+{
+	struct amdgv_memmgr_mem *prev;
+	uint64_t start = amdgv_memmgr_mem_start(mem);
+
+	if (mem->node.prev == &memmgr->allocs->node) {
+		mem->gap = MEMMGR_GAP_UNBOUND;
+		return;
+	}
+
+	prev = amdgv_list_last_entry(&mem->node, struct amdgv_memmgr_mem, node);
+	mem->gap = (start > prev->alloc_off) ? (start - prev->alloc_off) : 0;
+}
+
+static inline uint32_t amdgv_memmgr_id_hash(uint32_t id)
+{
+	return (id * 0x9E3779B1U) >> (32 - MEMMGR_ID_HASH_BITS);
+}
+
+static void amdgv_memmgr_id_hash_add(struct amdgv_memmgr *memmgr, struct amdgv_memmgr_mem *mem)
+{
+	uint32_t bucket = amdgv_memmgr_id_hash(mem->id);
+
+	mem->hash_next = memmgr->id_hash[bucket];
+	memmgr->id_hash[bucket] = mem;
+}
+
+static void amdgv_memmgr_id_hash_del(struct amdgv_memmgr *memmgr, struct amdgv_memmgr_mem *mem)
+{
+	struct amdgv_memmgr_mem **pos = &memmgr->id_hash[amdgv_memmgr_id_hash(mem->id)];
+
+	while (*pos) {
+		if (*pos == mem) {
+			*pos = mem->hash_next;
+			break;
+		}
+		pos = &(*pos)->hash_next;
+	}
+	mem->hash_next = NULL;
+}
+
+/* Insert mem into list, treap and id hash. Caller holds memmgr->lock */
+static void amdgv_memmgr_link(struct amdgv_memmgr *memmgr, struct amdgv_memmgr_mem *mem)
+{
+	struct amdgv_list_head *head = &memmgr->allocs->node;
+	struct amdgv_memmgr_mem *prev, *next, *l, *r;
+
+	prev = amdgv_memmgr_tree_prev(memmgr, mem);
+	amdgv_list_add(&mem->node, prev ? &prev->node : head);
+
+	mem->left = NULL;
+	mem->right = NULL;
+	mem->prio = amdgv_memmgr_next_prio(memmgr);
+	amdgv_memmgr_set_gap(memmgr, mem);
+	mem->max_gap = mem->gap;
+
+	amdgv_memmgr_tree_split(memmgr->root, mem, &l, &r);
+	memmgr->root = amdgv_memmgr_tree_merge(amdgv_memmgr_tree_merge(l, mem), r);
+
+	if (mem->node.next != head) {
+		next = amdgv_list_first_entry(&mem->node, struct amdgv_memmgr_mem, node);
+		amdgv_memmgr_set_gap(memmgr, next);
+		amdgv_memmgr_tree_refresh(memmgr->root, next);
+	}
+
+	amdgv_memmgr_id_hash_add(memmgr, mem);
+}
+
+/* Remove mem from list, treap and id hash. Caller holds memmgr->lock */
+static void amdgv_memmgr_unlink(struct amdgv_memmgr *memmgr, struct amdgv_memmgr_mem *mem)
+{
+	struct amdgv_list_head *head = &memmgr->allocs->node;
+	struct amdgv_memmgr_mem *next = NULL;
+
+	if (mem->node.next != head)
+		next = amdgv_list_first_entry(&mem->node, struct amdgv_memmgr_mem, node);
+
+	memmgr->root = amdgv_memmgr_tree_remove(memmgr->root, mem);
+	amdgv_list_del(&mem->node);
+
+	if (next) {
+		amdgv_memmgr_set_gap(memmgr, next);
+		amdgv_memmgr_tree_refresh(memmgr->root, next);
+	}
+
+	amdgv_memmgr_id_hash_del(memmgr, mem);
+}
+
+/* Leftmost allocation with enough aligned room in front of it */
+static struct amdgv_memmgr_mem *amdgv_memmgr_tree_fit(struct amdgv_memmgr *memmgr,
+						      struct amdgv_memmgr_mem *t,
+						      uint64_t size, uint64_t align)
+{
+	struct amdgv_memmgr_mem *fit, *prev;
+	uint64_t prev_end;
+
+	if (!t || t->max_gap <= size)
+		return NULL;
+
+	fit = amdgv_memmgr_tree_fit(memmgr, t->left, size, align);
+	if (fit)
+		return fit;
+
+	if (t->gap > size) {
+		prev = amdgv_list_last_entry(&t->node, struct amdgv_memmgr_mem, node);
+
+		/* allocations placed at an offset may sit below the heap offset */
+		prev_end = memmgr->offset;
+		if (prev != memmgr->allocs && prev->alloc_off > prev_end)
+			prev_end = prev->alloc_off;
+
+		/* a downwards block is aligned at its end, it must not run into t either */
+		if (amdgv_memmgr_mem_start(t) > AMDGV_MEMMGR_ALIGN(prev_end, align) + size &&
+		    (!memmgr->down ||
+		     amdgv_memmgr_mem_start(t) >= AMDGV_MEMMGR_ALIGN(prev->alloc_off + size, align)))
+			return t;
+	}
+
+	return amdgv_memmgr_tree_fit(memmgr, t->right, size, align);
+}
+
 static struct amdgv_memmgr_mem *amdgv_memmgr_find_size(struct amdgv_memmgr *memmgr,
 						       uint64_t size, uint64_t align)
 {
 	struct amdgv_list_head *head;
 	struct amdgv_memmgr_mem *alloc;
 
-	uint64_t tom = AMDGV_MEMMGR_ALIGN(memmgr->offset, align);
-
 	head = &memmgr->allocs->node;
 
 	if (amdgv_list_empty(head))
 		return memmgr->allocs;
 
-	amdgv_list_for_each_entry (alloc, head, struct amdgv_memmgr_mem, node) {
-		if (tom > alloc->alloc_off)
-			continue;
-		if ((alloc->alloc_off - alloc->len) > (tom + size))
-			return amdgv_list_last_entry(&alloc->node, struct amdgv_memmgr_mem,
-						     node);
-		tom = AMDGV_MEMMGR_ALIGN(alloc->alloc_off, align);
-	}
-	return amdgv_list_last_entry(&alloc->node, struct amdgv_memmgr_mem, node);
+	/* First fit: place in front of the first alloc with a big enough gap */
+	alloc = amdgv_memmgr_tree_fit(memmgr, memmgr->root, size, align);
+	if (alloc)
+		return amdgv_list_last_entry(&alloc->node, struct amdgv_memmgr_mem, node);
+
+	return amdgv_list_last_entry(head, struct amdgv_memmgr_mem, node);
 }
 
-static struct amdgv_memmgr_mem *amdgv_memmgr_find_id(struct amdgv_memmgr_mem *allocs,
-						     enum amdgv_mem_id id)
+struct amdgv_memmgr_mem *amdgv_memmgr_find_id(struct amdgv_memmgr *memmgr,
+					      enum amdgv_mem_id id)
 {
-	struct amdgv_list_head *head;
 	struct amdgv_memmgr_mem *alloc;
 
-	if (allocs == NULL)
+	if (memmgr->allocs == NULL)
 		return NULL;
 
-	head = &allocs->node;
-
-	if (amdgv_list_empty(head))
-		return NULL;
-
-	amdgv_list_for_each_entry(alloc, head, struct amdgv_memmgr_mem, node) {
+	for (alloc = memmgr->id_hash[amdgv_memmgr_id_hash(id)]; alloc; alloc = alloc->hash_next) {
 		if (alloc->id == id)
 			return alloc;
 	}
@@ -393,7 +636,7 @@ static int amdgv_memmgr_import_mem_allocs(struct amdgv_memmgr *memmgr,
 			if (!adapt->gart_size)
 				new->sys_mem.handle = NULL;
 
-			amdgv_list_add_tail(&new->node, &memmgr->allocs->node);
+			amdgv_memmgr_link(memmgr, new);
 		}
 	}
 
@@ -457,6 +700,8 @@ int amdgv_memmgr_fini(struct amdgv_adapter *adapt, struct amdgv_memmgr *memmgr)
 	}
 	oss_free(memmgr->allocs);
 	memmgr->allocs = OSS_INVALID_HANDLE;
+	memmgr->root = NULL;
+	oss_memset(memmgr->id_hash, 0, sizeof(memmgr->id_hash));
 
 fini:
 	memmgr->offset = 0;
@@ -575,6 +820,42 @@ static int amdgv_memmgr_mem_id_remove(struct amdgv_adapter *adapt,
 	return 0;
 }
 
+/* First fit placement of new, caller holds memmgr->lock */
+static int amdgv_memmgr_place(struct amdgv_memmgr *memmgr, struct amdgv_memmgr_mem *new,
+			      uint64_t len, uint64_t align)
+{
+	struct amdgv_memmgr_mem *prev;
+	uint64_t addr;
+
+	/* Find where to place an aligned memory block of the req size */
+	prev = amdgv_memmgr_find_size(memmgr, len, align);
+
+	/* Allocations fail if not enough space is available from the TOM
+	 * to the end of allocable space
+	 */
+	if (prev->alloc_off == memmgr->tom) {
+		if (AMDGV_MEMMGR_ALIGN(memmgr->tom, align) + len >
+		    (memmgr->offset + memmgr->size))
+			return AMDGV_FAILURE;
+	}
+
+	if (memmgr->down)
+		addr = AMDGV_MEMMGR_ALIGN(prev->alloc_off + len, align) - len;
+	else
+		addr = AMDGV_MEMMGR_ALIGN(prev->alloc_off, align);
+	new->len = len;
+	new->alloc_off = addr + len;
+	new->align = align;
+	new->memmgr = memmgr;
+	amdgv_memmgr_link(memmgr, new);
+
+	/* Adding a new allocation beyond current TOP of memory */
+	if (prev->alloc_off == memmgr->tom)
+		memmgr->tom = new->alloc_off;
+
+	return 0;
+}
+
 struct amdgv_memmgr_mem *amdgv_memmgr_alloc(struct amdgv_memmgr *memmgr, uint64_t len,
 					    enum amdgv_mem_id id)
 {
@@ -585,7 +866,7 @@ struct amdgv_memmgr_mem *amdgv_memmgr_alloc_align(struct amdgv_memmgr *memmgr, u
 						  uint64_t align, enum amdgv_mem_id id)
 {
 	struct amdgv_adapter *adapt = memmgr->adapt;
-	struct amdgv_memmgr_mem *prev, *new;
+	struct amdgv_memmgr_mem *new;
 	uint64_t addr;
 	uint32_t mem_id;
 	struct amdgv_memmgr_mem *same_id_mem;
@@ -606,7 +887,7 @@ struct amdgv_memmgr_mem *amdgv_memmgr_alloc_align(struct amdgv_memmgr *memmgr, u
 		 */
 		if (amdgv_memmgr_always_alloc_new(id))
 			goto alloc_new;
-		same_id_mem = amdgv_memmgr_find_id(memmgr->allocs, mem_id);
+		same_id_mem = amdgv_memmgr_find_id(memmgr, mem_id);
 		if (same_id_mem) {
 			AMDGV_DEBUG(
 				"Same ID mem: %s, index: %x, location: %s, alloc_off: 0x%09llx, len: 0x%09llx, align: 0x%09llx\n",
@@ -640,37 +921,15 @@ alloc_new:
 			return NULL;
 		}
 	}
-	oss_mutex_lock(memmgr->lock);
+	new->id = mem_id;
 
-	/* Find where to place an aligned memory block of the req size */
-	prev = amdgv_memmgr_find_size(memmgr, len, align);
+	oss_mutex_lock(memmgr->lock);
 
-	/* Allocations fail if not enough space is available from the TOM
-	 * to the end of allocable space
-	 */
-	if (prev->alloc_off == memmgr->tom) {
-		if (AMDGV_MEMMGR_ALIGN(memmgr->tom, align) + len >
-		    (memmgr->offset + memmgr->size)) {
-			amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_FB_MEM_FAIL,
-					len);
-			goto alloc_fail;
-		}
+	if (amdgv_memmgr_place(memmgr, new, len, align)) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_FB_MEM_FAIL, len);
+		goto alloc_fail;
 	}
-
-	if (memmgr->down)
-		addr = AMDGV_MEMMGR_ALIGN(prev->alloc_off + len, align) - len;
-	else
-		addr = AMDGV_MEMMGR_ALIGN(prev->alloc_off, align);
-	new->len = len;
-	new->alloc_off = addr + len;
-	new->align = align;
-	new->id = mem_id;
-	new->memmgr = memmgr;
-	amdgv_list_add(&new->node, &prev->node);
-
-	/* Adding a new allocation beyond current TOP of memory */
-	if (prev->alloc_off == memmgr->tom)
-		memmgr->tom = new->alloc_off;
+	addr = new->alloc_off - len;
 
 	oss_mutex_unlock(memmgr->lock);
 
@@ -701,7 +960,7 @@ static struct amdgv_memmgr_mem *amdgv_memmgr_find_size_at(struct amdgv_memmgr *m
 							  uint64_t align)
 {
 	struct amdgv_list_head *head;
-	struct amdgv_memmgr_mem *alloc;
+	struct amdgv_memmgr_mem *alloc, *t;
 
 	uint64_t tom = AMDGV_MEMMGR_ALIGN(offset, align);
 
@@ -710,29 +969,61 @@ static struct amdgv_memmgr_mem *amdgv_memmgr_find_size_at(struct amdgv_memmgr *m
 	if (amdgv_list_empty(head))
 		return memmgr->allocs;
 
-	amdgv_list_for_each_entry (alloc, head, struct amdgv_memmgr_mem, node) {
-		if (tom > alloc->alloc_off)
-			continue;
-		/* overlap with alloced section, alloc fail */
-		if ((alloc->alloc_off > tom) &&
-		    ((alloc->alloc_off - alloc->len) <= (tom + size)))
-			return NULL;
-		if ((alloc->alloc_off - alloc->len) > (tom + size))
-			return amdgv_list_last_entry(&alloc->node, struct amdgv_memmgr_mem,
-						     node);
+	/* allocations never overlap, so their ends are ordered like the starts;
+	 * look up the first one ending above tom
+	 */
+	alloc = NULL;
+	t = memmgr->root;
+	while (t) {
+		if (t->alloc_off > tom) {
+			alloc = t;
+			t = t->left;
+		} else {
+			t = t->right;
+		}
 	}
+
+	if (!alloc)
+		return amdgv_list_last_entry(head, struct amdgv_memmgr_mem, node);
+
+	/* overlap with alloced section, alloc fail */
+	if (amdgv_memmgr_mem_start(alloc) <= (tom + size))
+		return NULL;
+
 	return amdgv_list_last_entry(&alloc->node, struct amdgv_memmgr_mem, node);
 }
 
+/* Placement of new at offset, caller holds memmgr->lock */
+static int amdgv_memmgr_place_at(struct amdgv_memmgr *memmgr, struct amdgv_memmgr_mem *new,
+				 uint64_t offset, uint64_t len, uint64_t align)
+{
+	uint64_t addr;
+
+	/* Find where to place an aligned memory block of the req size */
+	if (!amdgv_memmgr_find_size_at(memmgr, offset, len, align))
+		return AMDGV_FAILURE;
+
+	if (memmgr->down)
+		addr = AMDGV_MEMMGR_ALIGN(offset + len, align) - len;
+	else
+		addr = AMDGV_MEMMGR_ALIGN(offset, align);
+	new->len = len;
+	new->alloc_off = addr + len;
+	new->align = align;
+	new->memmgr = memmgr;
+	amdgv_memmgr_link(memmgr, new);
+
+	return 0;
+}
+
 struct amdgv_memmgr_mem *amdgv_memmgr_alloc_align_at(struct amdgv_memmgr *memmgr,
 						     uint64_t offset, uint64_t len,
 						     enum amdgv_mem_id id)
 {
 	struct amdgv_adapter *adapt = memmgr->adapt;
-	struct amdgv_memmgr_mem *prev, *new;
+	struct amdgv_memmgr_mem *new;
 	uint32_t align = 0x1ULL << memmgr->align;
 	uint32_t mem_id;
-	uint64_t addr;
 
 	new = oss_zalloc(sizeof(struct amdgv_memmgr_mem));
 	if (!new) {
@@ -745,37 +1036,28 @@ struct amdgv_memmgr_mem *amdgv_memmgr_alloc_align_at(struct amdgv_memmgr *memmgr
 	mem_id = amdgv_memmgr_mem_id_add(adapt, id);
 	if (mem_id == MEM_ID_NOT_AVAILABLE) {
 		AMDGV_ERROR("Fail to add %s to the mem_id list\n", amdgv_mem_id_name(id));
-		return NULL;
+		goto alloc_fail;
 	}
+	new->id = mem_id;
+
 	/* Allocations fail if not enough space is available from the TOM
 	 * to the end of allocable space
 	 */
 	if (AMDGV_MEMMGR_ALIGN(offset, align) + len > (memmgr->offset + memmgr->size)) {
 		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_FB_MEM_FAIL, len);
-		goto alloc_fail;
+		goto id_fail;
 	}
-	/* Find where to place an aligned memory block of the req size */
-	prev = amdgv_memmgr_find_size_at(memmgr, offset, len, align);
-	if (!prev)
-		goto alloc_fail;
-
-	if (memmgr->down)
-		addr = AMDGV_MEMMGR_ALIGN(offset + len, align) - len;
-	else
-		addr = AMDGV_MEMMGR_ALIGN(offset, align);
-	new->len = len;
-	new->alloc_off = addr + len;
-	new->align = align;
-	new->id = mem_id;
-	new->memmgr = memmgr;
-	amdgv_list_add(&new->node, &prev->node);
+	if (amdgv_memmgr_place_at(memmgr, new, offset, len, align))
+		goto id_fail;
 
 	oss_mutex_unlock(memmgr->lock);
 
-	AMDGV_DEBUG("Alloc addr: 0x%09llx len:0x%09llx\n", addr, len);
+	AMDGV_DEBUG("Alloc addr: 0x%09llx len:0x%09llx\n", new->alloc_off - len, len);
 
 	return new;
 
+id_fail:
+	amdgv_memmgr_mem_id_remove(adapt, mem_id);
 alloc_fail:
 	oss_mutex_unlock(memmgr->lock);
 	oss_free(new);
@@ -824,7 +1106,9 @@ static int amdgv_memmgr_fill_reserved_bad_pages(struct amdgv_memmgr *memmgr,
 			 * the mem_id to MEM_ECC_BAD_PAGE as default value.
 			 */
 			mem_id = amdgv_memmgr_mem_id_add(adapt, MEM_ECC_BAD_PAGE);
+			amdgv_memmgr_id_hash_del(memmgr, alloc);
 			alloc->id = mem_id == MEM_ID_NOT_AVAILABLE ? MEM_ECC_BAD_PAGE : mem_id;
+			amdgv_memmgr_id_hash_add(memmgr, alloc);
 			bps_mem[i] = alloc;
 			i++;
 		}
@@ -863,7 +1147,6 @@ int amdgv_memmgr_free(struct amdgv_memmgr_mem *mem)
 	struct amdgv_memmgr *memmgr;
 	struct amdgv_adapter *adapt;
 	struct amdgv_memmgr_mem *prev;
-	struct amdgv_list_head *alloc_list;
 	uint64_t addr;
 
 	if (!mem)
@@ -875,14 +1158,11 @@ int amdgv_memmgr_free(struct amdgv_memmgr_mem *mem)
 
 	oss_mutex_lock(memmgr->lock);
 
-	alloc_list = &mem->node;
-
-	amdgv_list_del(alloc_list);
+	prev = amdgv_list_last_entry(&mem->node, struct amdgv_memmgr_mem, node);
+	amdgv_memmgr_unlink(memmgr, mem);
 
-	if (mem->alloc_off >= memmgr->tom) {
-		prev = amdgv_list_last_entry(alloc_list, struct amdgv_memmgr_mem, node);
+	if (mem->alloc_off >= memmgr->tom)
 		memmgr->tom = prev->alloc_off;
-	}
 	amdgv_memmgr_mem_id_remove(adapt, mem->id);
 	oss_mutex_unlock(memmgr->lock);
 
@@ -61,6 +61,13 @@ struct amdgv_memmgr_mem;
 #define MEM_ID_GET_ID(mem_id) (mem_id & 0xFFFF)
 #define MEM_ID_GET_INDEX(mem_id) ((mem_id >> 16) & 0xFFFF)
 
+/* Buckets of the per memmgr mem_id -> allocation hash */
+#define MEMMGR_ID_HASH_BITS 8
+#define MEMMGR_ID_HASH_SIZE (1 << MEMMGR_ID_HASH_BITS)
+
+/* gap of the first allocation, it is checked against memmgr->offset instead */
+#define MEMMGR_GAP_UNBOUND (~0ULL)
+
 /*
  *
  * The memory manager implements a manager for the physical FB
@@ -69,6 +76,13 @@ struct amdgv_memmgr_mem;
  * by the end of the allocation (alloc_off). The allocator either
  * grows the heap from the top MC address downwards (down) or from
  * the botto, MC address upwards (up).
+ *
+ * Next to the list, the allocations are kept in a treap ordered the
+ * same way and augmented with the free gap in front of every node
+ * and the largest gap of each subtree. First fit placement descends
+ * only into subtrees whose largest gap can hold the request, so
+ * alloc, alloc_at and free are O(log n) in the number of allocations.
+ * A small hash maps mem_id to its allocation for live update lookups.
  */
 
 /*
@@ -109,6 +123,16 @@ struct amdgv_memmgr_mem {
 	/* node tracker in the memmgr list */
 	struct amdgv_list_head node;
 
+	/* treap node, ordered by start offset like the list */
+	struct amdgv_memmgr_mem *left;
+	struct amdgv_memmgr_mem *right;
+	uint32_t prio;
+	uint64_t gap;     /* free space between the previous alloc and this one */
+	uint64_t max_gap; /* largest gap in this subtree */
+
+	/* chain in the memmgr mem_id hash */
+	struct amdgv_memmgr_mem *hash_next;
+
 	enum amdgv_mem_id id;	/* id to track mem block user */
 };
 
@@ -129,6 +153,11 @@ struct amdgv_memmgr {
 	/* Allocation list */
 	struct amdgv_memmgr_mem *allocs;
 
+	/* Allocation treap and mem_id hash, see above */
+	struct amdgv_memmgr_mem *root;
+	uint32_t prio_seed;
+	struct amdgv_memmgr_mem *id_hash[MEMMGR_ID_HASH_SIZE];
+
 	/* Tracker for the amount of memory consumed by the heap */
 	uint64_t tom;
 
@@ -167,6 +196,9 @@ struct amdgv_memmgr_mem *amdgv_memmgr_alloc_align(struct amdgv_memmgr *memmgr, u
 struct amdgv_memmgr_mem *amdgv_memmgr_alloc_align_at(struct amdgv_memmgr *memmgr,
 						     uint64_t offset, uint64_t len,
 						     enum amdgv_mem_id id);
+/* Allocation with this mem_id (index included), caller holds memmgr->lock */
+struct amdgv_memmgr_mem *amdgv_memmgr_find_id(struct amdgv_memmgr *memmgr,
+					      enum amdgv_mem_id id);
 int amdgv_memmgr_fill_reserved_bad_pages_all(struct amdgv_adapter *adapt,
 					     struct amdgv_memmgr_mem **bps_mem);
 int amdgv_memmgr_export_mem_allocs_all(struct amdgv_adapter *adapt,
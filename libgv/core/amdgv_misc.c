@@ -182,14 +182,14 @@ int amdgv_misc_clear_vf_fb(struct amdgv_adapter *adapt, uint32_t idx_vf, uint8_t
 		   amdgv_idx_to_str(idx_vf), fb_offset, fb_offset_end, fb_size);
 
 	if (adapt->ffbm.enabled) {
-		FFBM_LOCK_LIST;
+		FFBM_READ_LOCK_LIST;
 		amdgv_list_for_each_entry(pteb, &entry->gpa_list, struct amdgv_ffbm_pte_block,
 					   gpa_list_node) {
 			if (pteb->type != AMDGV_FFBM_MEM_TYPE_TMR)
 				filled_size += amdgv_misc_do_clear_vf_fb(adapt, idx_vf, pteb->spa,
 									 pteb->size, pattern);
 		}
-		FFBM_UNLOCK_LIST;
+		FFBM_READ_UNLOCK_LIST;
 	} else
 		filled_size = amdgv_misc_do_clear_vf_fb(adapt, idx_vf, fb_offset, fb_size, pattern);
 
@@ -615,6 +615,30 @@ INLINE void oss_event_fini(event_t event)
 	amdgv_oss_funcs->event_fini(event);
 }
 
+INLINE void oss_reset_event(event_t event)
+{
+	if (!amdgv_oss_funcs->reset_event)
+		return;
+
+	if (!amdgv_oss_funcs->signal_event_forever) {
+		struct amdgv_event *ev = (struct amdgv_event *)event;
+
+		amdgv_oss_funcs->reset_event(ev->event);
+		return;
+	}
+
+	amdgv_oss_funcs->reset_event(event);
+}
+
+/* without the callback assume the coarsest common timer tick, 100 Hz */
+INLINE uint32_t oss_wait_event_min_us(void)
+{
+	if (!amdgv_oss_funcs->wait_event_min_us)
+		return 10000;
+
+	return amdgv_oss_funcs->wait_event_min_us();
+}
+
 INLINE void oss_notifier_wakeup(event_t event, uint64_t count)
 {
 	if (amdgv_oss_funcs->notifier_wakeup)
@@ -1050,7 +1074,8 @@ INLINE int oss_schedule_work(oss_dev_t dev, oss_callback_t fn, void *context)
 	if (amdgv_oss_funcs->schedule_work)
 		return amdgv_oss_funcs->schedule_work(dev, fn, context);
 
-	return 0;
+	/* fn never runs, callers waiting on it must run it themselves */
+	return -1;
 }
 
 INLINE void oss_notify_shim_ext(oss_dev_t dev, uint32_t error_code,
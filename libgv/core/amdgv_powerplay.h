@@ -182,6 +182,28 @@ struct amdgv_pp_metrics_cache {
 	uint64_t tstamp;
 };
 
+/* default freshness window of the SMU metrics table, PMFW refreshes it
+ * about once per millisecond
+ */
+#define AMDGV_PP_METRICS_TABLE_MAX_AGE_US 1000
+
+/* Last metrics table fetched from the SMU. Readers within max_age_us of
+ * the fetch reuse it instead of sending another GetMetricsTable.
+ */
+struct amdgv_pp_table_cache {
+	mutex_t lock;
+	/* 0 disables the cache */
+	uint32_t max_age_us;
+	bool valid;
+	uint64_t tstamp;
+	/* AccumulationCounter of the cached table */
+	uint32_t version;
+	uint64_t hit;
+	uint64_t miss;
+	/* refetches that got the same table back, the window is too short */
+	uint64_t unchanged;
+};
+
 struct amdgv_pp {
 	struct phm_platform_descriptor platform_descriptor;
 	struct pp_thermal_controller_info thermal_controller;
@@ -190,6 +212,7 @@ struct amdgv_pp {
 	void *backend;
 	void *drv_metrics_ext;
 	struct amdgv_pp_metrics_cache metrics_cache;
+	struct amdgv_pp_table_cache table_cache;
 	const void *soft_pp_table;
 	uint32_t soft_pp_table_size;
 	uint32_t available_fb_base;
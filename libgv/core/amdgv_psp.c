@@ -77,6 +77,15 @@ enum psp_status amdgv_psp_cmd_km_init(struct amdgv_adapter *adapt)
 		}
 	}
 
+	if (psp->km_cmd_context.stats_lock == OSS_INVALID_HANDLE) {
+		psp->km_cmd_context.stats_lock = oss_spin_lock_init(AMDGV_SPIN_LOCK_HIGHEST_RANK);
+		if (psp->km_cmd_context.stats_lock == OSS_INVALID_HANDLE) {
+			amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_SPIN_LOCK_FAIL, 0);
+			return PSP_STATUS__ERROR_GENERIC;
+		}
+		amdgv_init_histogram_range(&psp->km_cmd_context.stats.latency_us);
+	}
+
 	local_mem = &psp->km_cmd_context.km_fence_mem_handle;
 	local_mem->alignment = PSP_FENCE_ALIGNMENT;
 	local_mem->size =
@@ -113,6 +122,11 @@ enum psp_status amdgv_psp_cmd_km_fini(struct amdgv_adapter *adapt)
 		}
 	}
 
+	if (psp->km_cmd_context.stats_lock != OSS_INVALID_HANDLE) {
+		oss_spin_lock_fini(psp->km_cmd_context.stats_lock);
+		psp->km_cmd_context.stats_lock = OSS_INVALID_HANDLE;
+	}
+
 	return ret;
 }
 
@@ -428,6 +442,41 @@ enum psp_status amdgv_psp_wait_for_memory(struct amdgv_adapter *adapt,
 	}
 }
 
+/* Fence values only grow, anything at or past the expected value means the
+ * command has been retired.
+ */
+static int amdgv_psp_wait_for_fence_cb(void *context)
+{
+	struct amdgv_wait_for_memory_context *mm_context =
+		(struct amdgv_wait_for_memory_context *)context;
+
+	return (int32_t)(*mm_context->address - mm_context->value) < 0;
+}
+
+static enum psp_status amdgv_psp_wait_for_fence(struct amdgv_adapter *adapt,
+						uint32_t *fence_address, uint32_t fence_value)
+{
+	struct amdgv_wait_for_memory_context mm_context;
+
+	mm_context.address = (volatile uint32_t *)fence_address;
+	mm_context.value = fence_value;
+
+	if (!amdgv_wait_for(adapt, amdgv_psp_wait_for_fence_cb, (void *)&mm_context,
+			    AMDGV_TIMEOUT(TIMEOUT_PSP_MEM),
+			    AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_PSP_FENCE))) {
+		AMDGV_DEBUG4("PSP responded successfully: "
+			     "fence(expected)=0x%08x fence(readback)=0x%08x\n",
+			     fence_value, *fence_address);
+		return PSP_STATUS__SUCCESS;
+	}
+
+	AMDGV_DEBUG("PSP: TIMED-OUT waiting for PSP response! "
+		    "fence(expected)=0x%08x fence(readback)=0x%08x\n",
+		    fence_value, *fence_address);
+
+	return PSP_STATUS__ERROR_GENERIC;
+}
+
 enum psp_status amdgv_psp_cmd_km_fence_wait(struct amdgv_adapter *adapt,
 					    struct psp_context *psp,
 					    struct psp_cmd_km_handle *km_cmd_handle,
@@ -450,9 +499,9 @@ enum psp_status amdgv_psp_cmd_km_fence_wait(struct amdgv_adapter *adapt,
 	/* Wait for fence from PSP FW */
 	if (local_mem->mem == NULL)
 		return PSP_STATUS__ERROR_OUT_OF_MEMORY;
-	ret = amdgv_psp_wait_for_memory(adapt,
-					(uint32_t *)amdgv_memmgr_get_cpu_addr(local_mem->mem),
-					psp_gfx_cmd_buf->fence_value);
+	ret = amdgv_psp_wait_for_fence(adapt,
+				       (uint32_t *)amdgv_memmgr_get_cpu_addr(local_mem->mem),
+				       psp_gfx_cmd_buf->fence_value);
 
 	if (psp_resp) {
 		gfx_cmd = (struct psp_gfx_cmd_resp *)(amdgv_memmgr_get_cpu_addr(
@@ -465,6 +514,27 @@ enum psp_status amdgv_psp_cmd_km_fence_wait(struct amdgv_adapter *adapt,
 	return ret;
 }
 
+static void amdgv_psp_cmd_km_account(struct psp_cmd_km_context *km_ctx,
+				     uint64_t submit_time, bool failed)
+{
+	struct amdgv_psp_cmd_stats *stats = &km_ctx->stats;
+	uint64_t now = oss_get_time_stamp();
+	uint64_t latency_us = now > submit_time ? now - submit_time : 0;
+
+	if (km_ctx->stats_lock == OSS_INVALID_HANDLE)
+		return;
+
+	oss_spin_lock(km_ctx->stats_lock);
+	stats->completed++;
+	if (failed)
+		stats->failed++;
+	stats->latency_sum_us += latency_us;
+	if (latency_us > stats->latency_max_us)
+		stats->latency_max_us = (uint32_t)min(latency_us, (uint64_t)0xFFFFFFFF);
+	amdgv_histogram_add(&stats->latency_us, latency_us);
+	oss_spin_unlock(km_ctx->stats_lock);
+}
+
 enum psp_status amdgv_psp_cmd_km_submit(struct amdgv_adapter *adapt,
 					struct psp_cmd_km *input_index,
 					struct psp_gfx_resp *psp_resp)
@@ -475,6 +545,7 @@ enum psp_status amdgv_psp_cmd_km_submit(struct amdgv_adapter *adapt,
 	struct psp_cmd_km_buf *psp_gfx_cmd_buf;
 	struct psp_context *psp = &adapt->psp;
 	struct psp_local_memory *local_mem = &psp->km_cmd_context.km_fence_mem_handle;
+	uint64_t submit_time;
 
 	/* Add to diagnosis data trace log the start of PSP command */
 	AMDGV_DIAG_DATA_TRACE_LOG_PSP_CMD_START(input_index->cmd_id);
@@ -499,6 +570,7 @@ enum psp_status amdgv_psp_cmd_km_submit(struct amdgv_adapter *adapt,
 
 	/* Update fence value associated with CMD buffer */
 	psp_gfx_cmd_buf->fence_value = psp->km_cmd_context.km_fence_count;
+	submit_time = oss_get_time_stamp();
 
 	/* Submit Gfx CMD to PSP FW */
 	if (!psp_gfx_cmd_buf->cmd_mem.mem || !local_mem->mem ||
@@ -514,6 +586,12 @@ enum psp_status amdgv_psp_cmd_km_submit(struct amdgv_adapter *adapt,
 		return PSP_STATUS__ERROR_GENERIC;
 	}
 
+	if (psp->km_cmd_context.stats_lock != OSS_INVALID_HANDLE) {
+		oss_spin_lock(psp->km_cmd_context.stats_lock);
+		psp->km_cmd_context.stats.submitted++;
+		oss_spin_unlock(psp->km_cmd_context.stats_lock);
+	}
+
 	/* Add to diagnosis data trace log the wait of PSP command */
 	AMDGV_DIAG_DATA_TRACE_LOG_PSP_CMD_WAIT(input_index->cmd_id,
 					  psp->km_cmd_context.km_fence_count);
@@ -533,6 +611,9 @@ enum psp_status amdgv_psp_cmd_km_submit(struct amdgv_adapter *adapt,
 		ret = PSP_STATUS__ERROR_GENERIC;
 	}
 
+	amdgv_psp_cmd_km_account(&psp->km_cmd_context, submit_time,
+				 ret != PSP_STATUS__SUCCESS);
+
 	/* Release CMD buffer */
 	amdgv_psp_cmd_km_release_buf(psp, &buf_handle);
 
@@ -542,6 +623,41 @@ enum psp_status amdgv_psp_cmd_km_submit(struct amdgv_adapter *adapt,
 	return ret;
 }
 
+int amdgv_psp_cmd_km_get_stats(struct amdgv_adapter *adapt,
+			       struct amdgv_psp_cmd_stats *stats)
+{
+	struct psp_cmd_km_context *km_ctx = &adapt->psp.km_cmd_context;
+
+	if (km_ctx->stats_lock == OSS_INVALID_HANDLE)
+		return AMDGV_FAILURE;
+
+	oss_spin_lock(km_ctx->stats_lock);
+	oss_memcpy(stats, &km_ctx->stats, sizeof(*stats));
+	oss_spin_unlock(km_ctx->stats_lock);
+
+	return 0;
+}
+
+int amdgv_psp_cmd_km_clear_stats(struct amdgv_adapter *adapt)
+{
+	struct psp_cmd_km_context *km_ctx = &adapt->psp.km_cmd_context;
+	struct amdgv_psp_cmd_stats *stats = &km_ctx->stats;
+
+	if (km_ctx->stats_lock == OSS_INVALID_HANDLE)
+		return AMDGV_FAILURE;
+
+	oss_spin_lock(km_ctx->stats_lock);
+	stats->submitted = 0;
+	stats->completed = 0;
+	stats->failed = 0;
+	stats->latency_sum_us = 0;
+	stats->latency_max_us = 0;
+	amdgv_init_histogram_range(&stats->latency_us);
+	oss_spin_unlock(km_ctx->stats_lock);
+
+	return 0;
+}
+
 enum psp_bootloader_command_list amdgv_psp_bl_command_map(enum amdgv_firmware_id fw_id)
 {
 	enum psp_bootloader_command_list psp_bl_cmd_id = 0;
@@ -1525,7 +1641,8 @@ enum psp_status amdgv_psp_wait_for_register(struct amdgv_adapter *adapt, uint32_
 		wait_ret = amdgv_wait_for_register(adapt, reg_index, reg_mask, reg_value,
 						   AMDGV_TIMEOUT(TIMEOUT_PSP_REG),
 						   AMDGV_WAIT_CHECK_NE,
-						   AMDGV_WAIT_FLAG_FORCE_YIELD);
+						   AMDGV_WAIT_FLAG_FORCE_YIELD |
+						   AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_PSP_REG));
 		if (!wait_ret) {
 			AMDGV_DEBUG("PSP responded successfully: "
 				    "readback_value=0x%08x should NOT equal reg_value=0x%08x\n",
@@ -1540,7 +1657,8 @@ enum psp_status amdgv_psp_wait_for_register(struct amdgv_adapter *adapt, uint32_
 		wait_ret = amdgv_wait_for_register(adapt, reg_index, reg_mask, reg_value,
 						   AMDGV_TIMEOUT(TIMEOUT_PSP_REG),
 						   AMDGV_WAIT_CHECK_EQ,
-						   AMDGV_WAIT_FLAG_FORCE_YIELD);
+						   AMDGV_WAIT_FLAG_FORCE_YIELD |
+						   AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_PSP_REG));
 		if (!wait_ret) {
 			AMDGV_DEBUG("PSP responded successfully: "
 				    "readback_value=0x%08x should equal reg_value=0x%08x\n",
@@ -179,6 +179,9 @@ struct psp_cmd_km_context {
 	struct psp_local_memory km_fence_mem_handle;
 	uint32_t		next_avail_cmd_buf_index;
 	uint32_t		km_fence_count;
+	/* guards stats against readers, submission itself is single threaded */
+	spin_lock_t		stats_lock;
+	struct amdgv_psp_cmd_stats stats;
 };
 
 struct psp_xgmi_context {
@@ -1081,6 +1081,9 @@ enum psp_status amdgv_psp_ring_km_submit(struct amdgv_adapter *adapt, uint64_t c
 enum psp_status amdgv_psp_cmd_km_submit(struct amdgv_adapter *adapt,
 					struct psp_cmd_km *input_index,
 					struct psp_gfx_resp *psp_resp);
+int amdgv_psp_cmd_km_get_stats(struct amdgv_adapter *adapt,
+			       struct amdgv_psp_cmd_stats *stats);
+int amdgv_psp_cmd_km_clear_stats(struct amdgv_adapter *adapt);
 enum psp_status amdgv_psp_ring_init(struct amdgv_adapter *adapt);
 enum psp_status amdgv_psp_ring_fini(struct amdgv_adapter *adapt);
 enum psp_status amdgv_psp_wait_for_register(struct amdgv_adapter *adapt, uint32_t reg_index,
@@ -25,6 +25,7 @@
 #include "amdgv.h"
 #include "ta_ras_if.h"
 #include "amdgv_ras_eeprom.h"
+#include "amdgv_umc_bp_index.h"
 
 #define BITS_PER_BYTE 8
 #define BITS_PER_TYPE(type) (sizeof(type) * BITS_PER_BYTE)
@@ -419,8 +420,12 @@ struct eeprom_data_record {
 struct ras_err_handler_data {
 	/* the raw records in eeprom */
 	struct eeprom_data_record rom_data;
+	/* retired pages of rom_data, for the duplicate check */
+	struct amdgv_umc_bp_index rom_index;
 	/* the records after expanding  */
 	struct eeprom_table_record *bps;
+	/* retired pages of bps, for page and range lookups */
+	struct amdgv_umc_bp_index index;
 	/* point to reserved bo array */
 	struct amdgv_memmgr_mem **bps_mem;
 	/* the count of entries */
@@ -129,6 +129,49 @@ bool amdgv_ras_eeprom_is_gpu_bad(struct amdgv_adapter *adapt)
 	return (hdr->header == EEPROM_TABLE_HDR_BAD);
 }
 
+int amdgv_ras_eeprom_get_xfer_stats(struct amdgv_adapter *adapt,
+				    struct amdgv_ras_eeprom_control *control,
+				    struct amdgv_ras_eeprom_xfer_stats *stats)
+{
+	if (!adapt->umc.supports_ras_eeprom || control->tbl_mutex == OSS_INVALID_HANDLE)
+		return AMDGV_FAILURE;
+
+	oss_mutex_lock(control->tbl_mutex);
+
+	stats->xfers = control->xfer_count;
+	stats->flushes = control->flush_count;
+	stats->flush_records = control->flush_recs;
+	stats->flush_xfers = control->flush_xfers;
+	stats->last_flush_records = control->last_flush_recs;
+	stats->last_flush_xfers = control->last_flush_xfers;
+	stats->max_flush_xfers = control->max_flush_xfers;
+
+	oss_mutex_unlock(control->tbl_mutex);
+
+	return 0;
+}
+
+int amdgv_ras_eeprom_clear_xfer_stats(struct amdgv_adapter *adapt,
+				      struct amdgv_ras_eeprom_control *control)
+{
+	if (!adapt->umc.supports_ras_eeprom || control->tbl_mutex == OSS_INVALID_HANDLE)
+		return AMDGV_FAILURE;
+
+	oss_mutex_lock(control->tbl_mutex);
+
+	control->xfer_count = 0;
+	control->flush_count = 0;
+	control->flush_recs = 0;
+	control->flush_xfers = 0;
+	control->last_flush_recs = 0;
+	control->last_flush_xfers = 0;
+	control->max_flush_xfers = 0;
+
+	oss_mutex_unlock(control->tbl_mutex);
+
+	return 0;
+}
+
 int amdgv_ras_eeprom_sw_init(struct amdgv_adapter *adapt,
 			     struct amdgv_ras_eeprom_control *control)
 {
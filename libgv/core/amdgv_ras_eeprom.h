@@ -50,6 +50,11 @@ int amdgv_ras_eeprom_process_records(struct amdgv_adapter *adapt,
 				     struct eeprom_table_record *records, bool write, int num);
 
 bool amdgv_ras_eeprom_is_gpu_bad(struct amdgv_adapter *adapt);
+int amdgv_ras_eeprom_get_xfer_stats(struct amdgv_adapter *adapt,
+				    struct amdgv_ras_eeprom_control *control,
+				    struct amdgv_ras_eeprom_xfer_stats *stats);
+int amdgv_ras_eeprom_clear_xfer_stats(struct amdgv_adapter *adapt,
+				      struct amdgv_ras_eeprom_control *control);
 uint64_t amdgv_utc_to_eeprom_format(struct amdgv_adapter *adapt, uint64_t utc_timestamp);
 
 #endif // _AMDGV_RAS_EEPROM_H
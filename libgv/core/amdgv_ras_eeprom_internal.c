@@ -51,6 +51,7 @@ int __smu_i2c_transfer(struct amdgv_adapter *adapt,
 
 	if (adapt->pp.pp_funcs->i2c_eeprom_xfer) {
 		oss_mutex_lock(adapt->smu_i2c_lock);
+		control->xfer_count += num;
 		ret = adapt->pp.pp_funcs->i2c_eeprom_xfer(adapt, control->i2c_port, msgs, num);
 		oss_mutex_unlock(adapt->smu_i2c_lock);
 	}
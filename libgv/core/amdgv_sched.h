@@ -232,10 +232,13 @@ union amdgv_sched_event_data {
 					struct {
 						void *buf;
 						uint64_t rptr;
+						uint32_t sev_mask;
 						uint64_t buf_size;
+						uint64_t max_entries;
 						uint64_t *write_count;
 						uint64_t *overflow_count;
 						uint64_t *left_size;
+						uint64_t *next_rptr;
 					} get_entries;
 				};
 			} cper;
@@ -324,6 +327,12 @@ struct amdgv_sched_event {
 /* MM HW scheduler mode. And MM scheduler is not configurable */
 #define AMDGV_SCHED_FRAME_LOOP_MODE 0
 
+/* virtual time mode: fixed point shift of the per-VF virtual clock and
+ * the heap position of an entry that is not queued
+ */
+#define AMDGV_SCHED_VT_SHIFT	    16
+#define AMDGV_SCHED_VT_NOT_QUEUED   0xFFFFFFFF
+
 /* used by manual switch, it is used to record
  * the present switch data of a vf.
  */
@@ -339,6 +348,10 @@ struct amdgv_sched_active_vf_entry {
 	uint64_t	       total_time;
 	bool		       skip_next_punish;
 	uint32_t	       skip_cnt;
+	/* virtual time mode: service received scaled by 1/time_slice */
+	uint64_t	       vtime;
+	uint64_t	       vt_charged;
+	uint32_t	       vt_heap_pos;
 };
 
 struct amdgv_sched_world_switch;
@@ -473,6 +486,12 @@ struct amdgv_sched_world_switch {
 		/* handle run time self switch on/off */
 		bool self_switch_trigger;
 
+		/* virtual time mode: active entries in a min-heap keyed by vtime */
+		struct amdgv_sched_active_vf_entry *vt_heap[AMDGV_MAX_VF_SLOT];
+		uint32_t vt_heap_size;
+		uint64_t vt_clock;
+		struct amdgv_sched_active_vf_entry *vt_last;
+
 	} manual;
 	struct {
 		/* handle run time self switch on/off */
@@ -494,12 +513,54 @@ struct world_switch_state {
 			  uint32_t hw_sched_id, uint32_t target_state);
 };
 
+/* preallocated event entries, one pool word covers 64 entries */
+#define AMDGV_EVENT_POOL_SIZE	   AMDGV_EVENT_QUEUE_ENTRY_NUM
+#define AMDGV_EVENT_POOL_WORDS	   (AMDGV_EVENT_POOL_SIZE / 64)
+/* entry came from oss_malloc_atomic because the pool was empty */
+#define AMDGV_EVENT_POOL_IDX_HEAP  0xFFFFFFFF
+
+/* completion objects cached for queue_event_and_wait callers */
+#define AMDGV_EVENT_SIGNAL_POOL_SIZE 32
+
+/* how long a waiting caller backs off for a pool entry before it falls
+ * back to the heap
+ */
+#define AMDGV_EVENT_POOL_BACKOFF_MS 100
+
 /* event list entry */
 struct amdgv_sched_event_entry {
 	struct amdgv_sched_event event;
 	struct amdgv_list_head	 list;
+	/* next older entry while the entry sits in the pending chain */
+	struct amdgv_sched_event_entry *pending_next;
+	/* slot in sched.event_pool or AMDGV_EVENT_POOL_IDX_HEAP */
+	uint32_t pool_idx;
+	/* event list the entry is on, and its link in the per-VF index */
+	uint32_t list_idx;
+	struct amdgv_list_head	 vf_list;
+	/* identical GPUMON requests answered together with this one */
+	struct amdgv_list_head	 coalesced;
 };
 
+/* per event id counters, queued is bumped by producers in any context,
+ * the rest only by the event thread; readers copy under event_stats_lock
+ */
+struct amdgv_sched_event_stat {
+	oss_atomic64_t queued;
+	uint64_t coalesced;
+	uint64_t skipped;
+	uint64_t handled;
+	uint64_t wait_sum_us;
+	uint32_t wait_max_us;
+	struct amdgv_histogram wait_us;
+	uint64_t run_sum_us;
+	uint32_t run_max_us;
+	struct amdgv_histogram run_us;
+};
+
+/* hash slots for queued GPUMON leaders, keyed by gpumon type */
+#define AMDGV_SCHED_GPUMON_COALESCE_SLOTS 64
+
 enum {
 	AMDGV_SCHED_EVENT_LIST_0   = 0,
 	AMDGV_SCHED_EVENT_LIST_1   = 1,
@@ -516,11 +577,6 @@ enum amdgv_sched_event_thread_status {
 	AMDGV_EVENT_THREAD_WAITING = 2,
 };
 
-struct amdgv_sched_event_wrapper {
-	struct amdgv_sched_event event;
-	struct amdgv_sched_event_entry *entry;
-};
-
 struct amdgv_sched_spatial_part {
 	// from table
 	uint32_t idx_vf_mask;
@@ -535,15 +591,30 @@ struct amdgv_sched_spatial_part {
 struct amdgv_sched {
 	uint32_t gfx_mode;
 
-	/* the array of sched event, used as ring buffer */
-	struct amdgv_sched_event_wrapper *event_queue;
-
-	/* rptr and wptr of event ring buffer */
-	unsigned char queue_rptr;
-	unsigned char queue_wptr;
-
-	/* event ring buffer */
-	spin_lock_t queue_lock;
+	/* Lock-free multi-producer/single-consumer event queue. Producers
+	 * push entries onto queue_head (newest first) with cmpxchg, only the
+	 * event thread detaches the chain and restores FIFO order.
+	 */
+	oss_atomic64_t queue_head;
+
+	/* preallocated entries, a set bit in event_pool_used marks a busy slot */
+	struct amdgv_sched_event_entry *event_pool;
+	oss_atomic64_t event_pool_used[AMDGV_EVENT_POOL_WORDS];
+	/* entries taken from the pool or the heap and not freed yet */
+	oss_atomic64_t event_pool_inflight;
+	/* entries served from the heap and waiters that had to back off */
+	oss_atomic64_t event_pool_overflow;
+	oss_atomic64_t event_pool_backoff;
+	/* high-water mark of event_pool_inflight */
+	oss_atomic64_t event_pool_max_inflight;
+
+	/* AMDGV_SCHED_EVENT_STATS_NUM buckets, see amdgv_sched_event_stat_idx */
+	struct amdgv_sched_event_stat *event_stats;
+	spin_lock_t event_stats_lock;
+
+	/* completion objects for queue_event_and_wait */
+	event_t event_signal_pool[AMDGV_EVENT_SIGNAL_POOL_SIZE];
+	oss_atomic64_t event_signal_used;
 
 	/* the handle of event process thread */
 	thread_t event_thread;
@@ -572,6 +643,13 @@ struct amdgv_sched {
 
 	int				curr_event_list_idx;
 	struct amdgv_sched_event_entry *next_event;
+	/* bit n set when event_list[n] is not empty */
+	uint32_t			event_list_mask;
+	/* entries of event_list[n] per function, used for dedup */
+	struct amdgv_list_head event_vf_list[AMDGV_SCHED_EVENT_LIST_MAX][AMDGV_MAX_VF_SLOT];
+	/* queued GPUMON request that new identical requests attach to */
+	struct amdgv_sched_event_entry *gpumon_leader[AMDGV_SCHED_GPUMON_COALESCE_SLOTS];
+	uint64_t			gpumon_coalesced;
 
 	bool			  in_full_access;
 	uint32_t		  idx_vf_full_access;
@@ -721,6 +799,11 @@ void amdgv_sched_print_vfs_running_time(struct amdgv_adapter *adapt);
 
 const char *amdgv_sched_block_to_name(enum amdgv_sched_block sched_block);
 const char *amdgv_hw_sched_id_to_name(struct amdgv_adapter *adapt, uint32_t hw_sched_id);
+int amdgv_sched_event_get_stats(struct amdgv_adapter *adapt, uint32_t idx,
+				struct amdgv_sched_event_stats *stats);
+void amdgv_sched_event_get_queue_stats(struct amdgv_adapter *adapt,
+				       struct amdgv_sched_event_queue_stats *stats);
+int amdgv_sched_event_clear_stats(struct amdgv_adapter *adapt);
 int amdgv_sched_export_unprocessed_event_size(struct amdgv_adapter *adapt,
 					      uint32_t *unprocessed_event_count);
 
@@ -350,52 +350,423 @@ static int amdgv_sched_clear_vf_fb(struct amdgv_adapter *adapt, int idx_vf, uint
 	return ret;
 }
 
-static int amdgv_sched_event_queue_init(struct amdgv_adapter *adapt)
+static int amdgv_sched_bitmap_find_zero(uint64_t word)
+{
+	uint64_t low = ~word;
+	int bit = 0;
+
+	if (low == 0)
+		return -1;
+
+	/* isolate the lowest clear bit of word, then log2 it */
+	low &= ~low + 1;
+
+	if (low > 0xFFFFFFFFULL) {
+		low >>= 32;
+		bit += 32;
+	}
+	if (low > 0xFFFF) {
+		low >>= 16;
+		bit += 16;
+	}
+	if (low > 0xFF) {
+		low >>= 8;
+		bit += 8;
+	}
+	if (low > 0xF) {
+		low >>= 4;
+		bit += 4;
+	}
+	if (low > 0x3) {
+		low >>= 2;
+		bit += 2;
+	}
+	if (low > 0x1)
+		bit += 1;
+
+	return bit;
+}
+
+/* lock-free claim of a clear bit, cmpxchg is a full barrier on all oss */
+static bool amdgv_sched_bitmap_claim(oss_atomic64_t *word, uint32_t *bit)
+{
+	uint64_t old;
+	int i;
+
+	do {
+		old = oss_atomic_read(word);
+		i = amdgv_sched_bitmap_find_zero(old);
+		if (i < 0)
+			return false;
+	} while (oss_atomic_cmpxchg(word, old, old | (1ULL << i)) != old);
+
+	*bit = i;
+
+	return true;
+}
+
+static void amdgv_sched_bitmap_release(oss_atomic64_t *word, uint32_t bit)
+{
+	uint64_t old;
+
+	do {
+		old = oss_atomic_read(word);
+	} while (oss_atomic_cmpxchg(word, old, old & ~(1ULL << bit)) != old);
+}
+
+/* safe from any context, producers may run in interrupt handlers */
+static struct amdgv_sched_event_entry *
+amdgv_sched_event_alloc_entry(struct amdgv_adapter *adapt, uint32_t idx_vf)
+{
+	struct amdgv_sched_event_entry *entry;
+	uint32_t i, word, bit;
+
+	/* spread producers of different functions over the pool words */
+	for (i = 0; i < AMDGV_EVENT_POOL_WORDS; i++) {
+		word = (idx_vf + i) % AMDGV_EVENT_POOL_WORDS;
+		if (amdgv_sched_bitmap_claim(&adapt->sched.event_pool_used[word], &bit)) {
+			entry = &adapt->sched.event_pool[word * 64 + bit];
+			entry->pool_idx = word * 64 + bit;
+			oss_atomic_inc(&adapt->sched.event_pool_inflight);
+			return entry;
+		}
+	}
+
+	entry = (struct amdgv_sched_event_entry *)oss_malloc_atomic(
+		sizeof(struct amdgv_sched_event_entry));
+	if (entry == NULL) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_SYSTEM_MEM_FAIL,
+				sizeof(struct amdgv_sched_event_entry));
+		return NULL;
+	}
+
+	entry->pool_idx = AMDGV_EVENT_POOL_IDX_HEAP;
+	oss_atomic_inc(&adapt->sched.event_pool_inflight);
+	oss_atomic_inc(&adapt->sched.event_pool_overflow);
+
+	return entry;
+}
+
+static void amdgv_sched_event_free_entry(struct amdgv_adapter *adapt,
+					 struct amdgv_sched_event_entry *entry)
+{
+	oss_atomic_dec(&adapt->sched.event_pool_inflight);
+
+	if (entry->pool_idx == AMDGV_EVENT_POOL_IDX_HEAP) {
+		oss_free(entry);
+		return;
+	}
+
+	amdgv_sched_bitmap_release(&adapt->sched.event_pool_used[entry->pool_idx / 64],
+				   entry->pool_idx % 64);
+}
+
+/* detach every pending entry, newest first */
+static struct amdgv_sched_event_entry *
+amdgv_sched_event_queue_take_all(struct amdgv_adapter *adapt)
+{
+	uint64_t first;
+
+	do {
+		first = oss_atomic_read(&adapt->sched.queue_head);
+	} while (first && oss_atomic_cmpxchg(&adapt->sched.queue_head, first, 0) != first);
+
+	return (struct amdgv_sched_event_entry *)first;
+}
+
+static event_t amdgv_sched_get_signal(struct amdgv_adapter *adapt, uint32_t *slot)
+{
+	uint32_t bit;
+
+	if (amdgv_sched_bitmap_claim(&adapt->sched.event_signal_used, &bit)) {
+		if (adapt->sched.event_signal_pool[bit] == OSS_INVALID_HANDLE)
+			adapt->sched.event_signal_pool[bit] = oss_event_init();
+
+		if (adapt->sched.event_signal_pool[bit] != OSS_INVALID_HANDLE) {
+			*slot = bit;
+			return adapt->sched.event_signal_pool[bit];
+		}
+
+		amdgv_sched_bitmap_release(&adapt->sched.event_signal_used, bit);
+	}
+
+	*slot = AMDGV_EVENT_POOL_IDX_HEAP;
+
+	return oss_event_init();
+}
+
+/* reusable: the single signal was consumed by a normal wake up */
+static void amdgv_sched_put_signal(struct amdgv_adapter *adapt, event_t signal,
+				   uint32_t slot, bool reusable)
+{
+	if (slot == AMDGV_EVENT_POOL_IDX_HEAP) {
+		oss_event_fini(signal);
+		return;
+	}
+
+	/* skipped flags are sticky, replace the completion on next use */
+	if (!reusable) {
+		oss_event_fini(signal);
+		adapt->sched.event_signal_pool[slot] = OSS_INVALID_HANDLE;
+	}
+
+	amdgv_sched_bitmap_release(&adapt->sched.event_signal_used, slot);
+}
+
+/* event ids that own a stats bucket, in bucket order */
+static const struct {
+	enum amdgv_sched_event_id first;
+	enum amdgv_sched_event_id last;
+} amdgv_sched_event_stat_ranges[] = {
+	{ AMDGV_EVENT_READY_TO_ACCESS_GPU, AMDGV_EVENT_READY_TO_ACCESS_GPU },
+	{ AMDGV_EVENT_IP_DATA_READY, AMDGV_EVENT_IP_DATA_READY },
+	{ AMDGV_EVENT_TEXT_MESSAGE, AMDGV_EVENT_TEXT_MESSAGE },
+	{ AMDGV_EVENT_REQ_GPU_INIT, AMDGV_EVENT_REL_GPU_DEBUG },
+	{ AMDGV_EVENT_SCHED_FORCE_RESET_VF, AMDGV_EVENT_SCHED_FORCE_RESET_GPU_INTERNAL },
+	{ AMDGV_EVENT_SCHED_SUSPEND_LIVE, AMDGV_EVENT_SCHED_RESUME_LIVE },
+	{ AMDGV_EVENT_COLLECT_DIAG_DATA, AMDGV_EVENT_COLLECT_DIAG_DATA },
+	{ AMDGV_EVENT_ENTER_POWER_SAVING, AMDGV_EVENT_EXIT_POWER_SAVING },
+	{ AMDGV_EVENT_SCHED_RAS_POISON_CONSUMPTION, AMDGV_EVENT_SCHED_RAS_POISON_CREATION },
+};
+
+/* enum amdgv_sched_event_id is sparse, map it onto the dense stats buckets */
+static uint32_t amdgv_sched_event_stat_idx(uint32_t event_id)
+{
+	uint32_t i, base = 0;
+
+	for (i = 0; i < ARRAY_SIZE(amdgv_sched_event_stat_ranges); i++) {
+		if (event_id >= amdgv_sched_event_stat_ranges[i].first &&
+		    event_id <= amdgv_sched_event_stat_ranges[i].last) {
+			base += event_id - amdgv_sched_event_stat_ranges[i].first;
+			break;
+		}
+		base += amdgv_sched_event_stat_ranges[i].last -
+			amdgv_sched_event_stat_ranges[i].first + 1;
+	}
+
+	if (base >= AMDGV_SCHED_EVENT_STATS_NUM)
+		base = AMDGV_SCHED_EVENT_STATS_NUM - 1;
+
+	return base;
+}
+
+static uint32_t amdgv_sched_event_stat_id(uint32_t idx)
+{
+	uint32_t i, num;
+
+	for (i = 0; i < ARRAY_SIZE(amdgv_sched_event_stat_ranges); i++) {
+		num = amdgv_sched_event_stat_ranges[i].last -
+		      amdgv_sched_event_stat_ranges[i].first + 1;
+		if (idx < num)
+			break;
+		idx -= num;
+	}
+
+	if (i == ARRAY_SIZE(amdgv_sched_event_stat_ranges))
+		return AMDGV_EVENT_INVALID_EVENT;
+
+	return amdgv_sched_event_stat_ranges[i].first + idx;
+}
+
+static void amdgv_sched_event_stat_reset(struct amdgv_sched_event_stat *stat)
+{
+	oss_atomic_set(&stat->queued, 0);
+	stat->coalesced = 0;
+	stat->skipped = 0;
+	stat->handled = 0;
+	stat->wait_sum_us = 0;
+	stat->wait_max_us = 0;
+	stat->run_sum_us = 0;
+	stat->run_max_us = 0;
+	amdgv_init_histogram_range(&stat->wait_us);
+	amdgv_init_histogram_range(&stat->run_us);
+}
+
+static int amdgv_sched_event_stats_init(struct amdgv_adapter *adapt)
 {
 	int size;
+	uint32_t i;
 
-	size = sizeof(struct amdgv_sched_event_wrapper) * AMDGV_EVENT_QUEUE_ENTRY_NUM;
+	adapt->sched.event_stats_lock = oss_spin_lock_init(AMDGV_SPIN_LOCK_HIGHEST_RANK);
+	if (adapt->sched.event_stats_lock == OSS_INVALID_HANDLE) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_SPIN_LOCK_FAIL, 0);
+		return AMDGV_FAILURE;
+	}
 
-	adapt->sched.event_queue = oss_alloc_memory(size);
-	if (adapt->sched.event_queue == NULL) {
+	size = sizeof(struct amdgv_sched_event_stat) * AMDGV_SCHED_EVENT_STATS_NUM;
+
+	adapt->sched.event_stats = oss_zalloc(size);
+	if (adapt->sched.event_stats == NULL) {
 		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_SYSTEM_MEM_FAIL, size);
+		oss_spin_lock_fini(adapt->sched.event_stats_lock);
+		adapt->sched.event_stats_lock = OSS_INVALID_HANDLE;
 		return AMDGV_FAILURE;
 	}
 
-	oss_memset(adapt->sched.event_queue, 0, size);
+	for (i = 0; i < AMDGV_SCHED_EVENT_STATS_NUM; i++)
+		amdgv_sched_event_stat_reset(&adapt->sched.event_stats[i]);
+	oss_atomic_set(&adapt->sched.event_pool_max_inflight, 0);
 
-	adapt->sched.queue_rptr = 0;
-	adapt->sched.queue_wptr = 0;
+	return 0;
+}
 
-	adapt->sched.queue_lock = oss_spin_lock_init(AMDGV_SPIN_LOCK_HIGHEST_RANK);
-	if (adapt->sched.queue_lock == OSS_INVALID_HANDLE) {
-		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_SPIN_LOCK_FAIL, 0);
-		oss_free(adapt->sched.event_queue);
+/*
+ * Runs from amdgv_sched_event_queue_fini() next to freeing the event pool.
+ * By then the event thread is closed and the interrupt handler has been
+ * unregistered, so no producer can reach the stats anymore; the lock only
+ * keeps out stats readers.
+ */
+static void amdgv_sched_event_stats_fini(struct amdgv_adapter *adapt)
+{
+	struct amdgv_sched_event_stat *stats;
+
+	if (adapt->sched.event_stats_lock == OSS_INVALID_HANDLE)
+		return;
+
+	oss_spin_lock(adapt->sched.event_stats_lock);
+	stats = adapt->sched.event_stats;
+	adapt->sched.event_stats = NULL;
+	oss_spin_unlock(adapt->sched.event_stats_lock);
+
+	oss_free(stats);
+	oss_spin_lock_fini(adapt->sched.event_stats_lock);
+	adapt->sched.event_stats_lock = OSS_INVALID_HANDLE;
+}
+
+/*
+ * producers only touch an atomic, any context is fine; the stats live as
+ * long as the event pool the producer just allocated from
+ */
+static void amdgv_sched_event_stat_queued(struct amdgv_adapter *adapt, uint32_t event_id)
+{
+	uint64_t depth, max;
+
+	oss_atomic_inc(&adapt->sched.event_stats[amdgv_sched_event_stat_idx(event_id)].queued);
+
+	depth = oss_atomic_read(&adapt->sched.event_pool_inflight);
+	do {
+		max = oss_atomic_read(&adapt->sched.event_pool_max_inflight);
+		if (depth <= max)
+			break;
+	} while (oss_atomic_cmpxchg(&adapt->sched.event_pool_max_inflight, max, depth) != max);
+}
+
+static void amdgv_sched_event_stat_coalesced(struct amdgv_adapter *adapt, uint32_t event_id)
+{
+	oss_spin_lock(adapt->sched.event_stats_lock);
+	adapt->sched.event_stats[amdgv_sched_event_stat_idx(event_id)].coalesced++;
+	oss_spin_unlock(adapt->sched.event_stats_lock);
+}
+
+static void amdgv_sched_event_stat_handled(struct amdgv_adapter *adapt, uint32_t event_id,
+					   uint64_t queue_time, uint64_t start_time)
+{
+	struct amdgv_sched_event_stat *stat;
+	uint64_t now, wait_us, run_us;
+
+	now = oss_get_time_stamp();
+	wait_us = start_time > queue_time ? start_time - queue_time : 0;
+	run_us = now > start_time ? now - start_time : 0;
+
+	oss_spin_lock(adapt->sched.event_stats_lock);
+	stat = &adapt->sched.event_stats[amdgv_sched_event_stat_idx(event_id)];
+	stat->handled++;
+	stat->wait_sum_us += wait_us;
+	if (wait_us > stat->wait_max_us)
+		stat->wait_max_us = (uint32_t)min(wait_us, (uint64_t)0xFFFFFFFF);
+	amdgv_histogram_add(&stat->wait_us, wait_us);
+	stat->run_sum_us += run_us;
+	if (run_us > stat->run_max_us)
+		stat->run_max_us = (uint32_t)min(run_us, (uint64_t)0xFFFFFFFF);
+	amdgv_histogram_add(&stat->run_us, run_us);
+	oss_spin_unlock(adapt->sched.event_stats_lock);
+}
+
+/* complete a request that will not be handled */
+static void amdgv_sched_signal_skipped(struct amdgv_adapter *adapt,
+				       struct amdgv_sched_event *event)
+{
+	oss_spin_lock(adapt->sched.event_stats_lock);
+	adapt->sched.event_stats[amdgv_sched_event_stat_idx(event->id)].skipped++;
+	oss_spin_unlock(adapt->sched.event_stats_lock);
+
+	if (event->signal != OSS_INVALID_HANDLE)
+		oss_signal_event_with_flag(event->signal, EVENT_FLAGS_SKIPPED);
+}
+
+static void amdgv_sched_event_queue_fini(struct amdgv_adapter *adapt);
+
+static int amdgv_sched_event_queue_init(struct amdgv_adapter *adapt)
+{
+	int size;
+	uint32_t i;
+
+	size = sizeof(struct amdgv_sched_event_entry) * AMDGV_EVENT_POOL_SIZE;
+
+	adapt->sched.event_pool = oss_alloc_memory(size);
+	if (adapt->sched.event_pool == NULL) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_SYSTEM_MEM_FAIL, size);
+		return AMDGV_FAILURE;
+	}
+
+	oss_memset(adapt->sched.event_pool, 0, size);
+
+	if (amdgv_sched_event_stats_init(adapt)) {
+		oss_free_memory(adapt->sched.event_pool);
+		adapt->sched.event_pool = NULL;
 		return AMDGV_FAILURE;
 	}
 
+	oss_atomic_set(&adapt->sched.queue_head, 0);
+	for (i = 0; i < AMDGV_EVENT_POOL_WORDS; i++)
+		oss_atomic_set(&adapt->sched.event_pool_used[i], 0);
+	oss_atomic_set(&adapt->sched.event_pool_inflight, 0);
+	oss_atomic_set(&adapt->sched.event_pool_overflow, 0);
+	oss_atomic_set(&adapt->sched.event_pool_backoff, 0);
+
+	/* bits above the pool size stay busy forever */
+	oss_atomic_set(&adapt->sched.event_signal_used,
+		       ~((1ULL << AMDGV_EVENT_SIGNAL_POOL_SIZE) - 1));
+	for (i = 0; i < AMDGV_EVENT_SIGNAL_POOL_SIZE; i++) {
+		adapt->sched.event_signal_pool[i] = oss_event_init();
+		if (adapt->sched.event_signal_pool[i] == OSS_INVALID_HANDLE) {
+			amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_EVENT_FAIL, 0);
+			amdgv_sched_event_queue_fini(adapt);
+			return AMDGV_FAILURE;
+		}
+	}
+
 	return 0;
 }
 
 static void amdgv_sched_event_queue_fini(struct amdgv_adapter *adapt)
 {
-	unsigned char rptr, wptr;
+	struct amdgv_sched_event_entry *entry, *next;
+	uint32_t i;
 
-	if (adapt->sched.queue_lock != OSS_INVALID_HANDLE) {
-		oss_spin_lock_fini(adapt->sched.queue_lock);
-		adapt->sched.queue_lock = OSS_INVALID_HANDLE;
+	for (entry = amdgv_sched_event_queue_take_all(adapt); entry; entry = next) {
+		next = entry->pending_next;
+		amdgv_sched_event_free_entry(adapt, entry);
 	}
 
-	if (adapt->sched.event_queue) {
-		wptr = adapt->sched.queue_wptr;
-		rptr = adapt->sched.queue_rptr;
-		for (; wptr != rptr; rptr++)
-			if (adapt->sched.event_queue[rptr].entry)
-				oss_free(adapt->sched.event_queue[rptr].entry);
+	for (i = 0; i < AMDGV_EVENT_SIGNAL_POOL_SIZE; i++) {
+		if (adapt->sched.event_signal_pool[i] != OSS_INVALID_HANDLE) {
+			oss_event_fini(adapt->sched.event_signal_pool[i]);
+			adapt->sched.event_signal_pool[i] = OSS_INVALID_HANDLE;
+		}
+	}
 
-		oss_free_memory(adapt->sched.event_queue);
-		adapt->sched.event_queue = NULL;
+	if (adapt->sched.event_pool) {
+		if (oss_atomic_read(&adapt->sched.event_pool_overflow))
+			AMDGV_INFO("event pool overflowed %llu times, %llu waiters backed off\n",
+				   oss_atomic_read(&adapt->sched.event_pool_overflow),
+				   oss_atomic_read(&adapt->sched.event_pool_backoff));
+
+		oss_free_memory(adapt->sched.event_pool);
+		adapt->sched.event_pool = NULL;
 	}
+
+	amdgv_sched_event_stats_fini(adapt);
 }
 
 
@@ -443,8 +814,9 @@ static int amdgv_sched_event_queue_push_ex(struct amdgv_adapter *adapt, uint32_t
 					   union amdgv_sched_event_data data,
 					   bool wake_event_thread)
 {
+	struct amdgv_sched_event_entry *entry;
 	struct amdgv_sched_event *event;
-	unsigned char rptr, wptr;
+	uint64_t head;
 
 	if (amdgv_sched_event_print_log_in_info(event_id))
 		AMDGV_DEBUG("queue %s request from %s for %s\n", amdgv_event_name(event_id),
@@ -459,43 +831,18 @@ static int amdgv_sched_event_queue_push_ex(struct amdgv_adapter *adapt, uint32_t
 				amdgv_sched_block_to_name(sched_block));
 	}
 
-	oss_spin_lock_irq(adapt->sched.queue_lock);
-
 	if (event_id != AMDGV_EVENT_EXIT_POWER_SAVING && adapt->pp.is_in_powersaving == true) {
 		AMDGV_INFO("queue %s request from %s for %s DENIED \n",
 			   amdgv_event_name(event_id), amdgv_idx_to_str(idx_vf),
 			   amdgv_sched_block_to_name(sched_block));
-		oss_spin_unlock_irq(adapt->sched.queue_lock);
 		return AMDGV_FAILURE;
 	}
 
-	wptr = adapt->sched.queue_wptr;
-	rptr = adapt->sched.queue_rptr;
-
-	AMDGV_DEBUG("rptr=%u, wptr=%u\n", rptr, wptr);
-
-	if ((unsigned char)(wptr + 1) == rptr) {
-		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_SCHED_EVENT_QUEUE_FULL,
-				AMDGV_ERROR_32_32(rptr, wptr));
-		oss_spin_unlock_irq(adapt->sched.queue_lock);
+	entry = amdgv_sched_event_alloc_entry(adapt, idx_vf);
+	if (entry == NULL)
 		return AMDGV_FAILURE;
-	}
-
-	adapt->sched.event_queue[wptr].entry =
-		(struct amdgv_sched_event_entry *)oss_malloc_atomic(
-			sizeof(struct amdgv_sched_event_entry));
-	if (adapt->sched.event_queue[wptr].entry == NULL) {
-		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_ALLOC_SYSTEM_MEM_FAIL,
-				sizeof(struct amdgv_sched_event_entry));
-		oss_spin_unlock_irq(adapt->sched.queue_lock);
-		return AMDGV_FAILURE;
-	}
-
-	adapt->sched.queue_wptr++;
-	event = &adapt->sched.event_queue[wptr].event;
-
-	AMDGV_DEBUG("rptr=%u, wptr=%u\n", rptr, adapt->sched.queue_wptr);
 
+	event = &entry->event;
 	event->idx_vf = idx_vf;
 	event->id = event_id;
 	event->sched_block = sched_block;
@@ -504,7 +851,14 @@ static int amdgv_sched_event_queue_push_ex(struct amdgv_adapter *adapt, uint32_t
 	event->data = data;
 	event->status = AMDGV_EVENT_STATUS_NORMAL;
 
-	oss_spin_unlock_irq(adapt->sched.queue_lock);
+	amdgv_sched_event_stat_queued(adapt, event_id);
+
+	/* publish, the cmpxchg orders the stores above before the link */
+	do {
+		head = oss_atomic_read(&adapt->sched.queue_head);
+		entry->pending_next = (struct amdgv_sched_event_entry *)head;
+	} while (oss_atomic_cmpxchg(&adapt->sched.queue_head, head,
+				    (uint64_t)entry) != head);
 
 	if (wake_event_thread) {
 		/* wake up event queue process thread */
@@ -518,48 +872,45 @@ static struct amdgv_list_head *
 amdgv_sched_event_queue_pop_event_list(struct amdgv_adapter *adapt,
 				       struct amdgv_list_head *head)
 {
-	uint8_t rptr, wptr;
-	struct amdgv_sched_event_entry *entry = NULL;
+	struct amdgv_sched_event_entry *entry, *next;
 
 	AMDGV_INIT_LIST_HEAD(head);
 
-	oss_spin_lock_irq(adapt->sched.queue_lock);
-
-	rptr = adapt->sched.queue_rptr;
-	wptr = adapt->sched.queue_wptr;
-
-	AMDGV_DEBUG("rptr=%u, wptr=%u\n", rptr, wptr);
-
-	for (; wptr != rptr; rptr++) {
-		AMDGV_DEBUG("rptr=%u, wptr=%u\n", rptr, wptr);
-
-		entry = adapt->sched.event_queue[rptr].entry;
-		adapt->sched.event_queue[rptr].entry = NULL;
-
-		/* copy event to event list */
-		oss_memcpy(&entry->event, &adapt->sched.event_queue[rptr].event,
-			   sizeof(struct amdgv_sched_event));
-		AMDGV_INIT_LIST_HEAD(&entry->list);
+	/* the chain is newest first, adding each entry at the front of the
+	 * list restores the queueing order
+	 */
+	for (entry = amdgv_sched_event_queue_take_all(adapt); entry; entry = next) {
+		next = entry->pending_next;
+		entry->pending_next = NULL;
 
 		AMDGV_DEBUG("%s event = 0x%x\n", amdgv_idx_to_str(entry->event.idx_vf),
 			    entry->event.id);
 
-		amdgv_list_add_tail(&entry->list, head);
-		adapt->sched.queue_rptr++;
+		AMDGV_INIT_LIST_HEAD(&entry->list);
+		AMDGV_INIT_LIST_HEAD(&entry->vf_list);
+		AMDGV_INIT_LIST_HEAD(&entry->coalesced);
+		amdgv_list_add(&entry->list, head);
 	}
 
-	oss_spin_unlock_irq(adapt->sched.queue_lock);
 	return head;
 }
 
 static void amdgv_sched_free_event(struct amdgv_adapter *adapt,
 				   struct amdgv_sched_event *event)
 {
-	struct amdgv_sched_event_entry *p;
+	struct amdgv_sched_event_entry *p, *f, *t;
 
 	p = amdgv_list_entry(event, struct amdgv_sched_event_entry, event);
 
-	oss_free(p);
+	/* coalesced requests that did not get an answer share the skip */
+	amdgv_list_for_each_entry_safe (f, t, &p->coalesced,
+					struct amdgv_sched_event_entry, list) {
+		amdgv_list_del(&f->list);
+		amdgv_sched_signal_skipped(adapt, &f->event);
+		amdgv_sched_event_free_entry(adapt, f);
+	}
+
+	amdgv_sched_event_free_entry(adapt, p);
 }
 
 static void amdgv_sched_dump_event_list(struct amdgv_adapter *adapt)
@@ -568,20 +919,18 @@ static void amdgv_sched_dump_event_list(struct amdgv_adapter *adapt)
 
 static bool amdgv_sched_is_find_event(struct amdgv_adapter *adapt, uint32_t idx_vf, enum amdgv_sched_event_id event_id)
 {
-	uint8_t rptr, wptr;
-
-	struct amdgv_sched_event *event;
 	struct amdgv_list_head *event_head;
 	struct amdgv_sched_event_entry *entry;
 
 	uint32_t event_list_idx;
 
-	// Check event queue
-	rptr = adapt->sched.queue_rptr;
-	wptr = adapt->sched.queue_wptr;
-	for (; wptr != rptr; rptr++) {
-		event = &adapt->sched.event_queue[rptr].event;
-		if ((event->id == event_id) && (event->idx_vf == idx_vf))
+	AMDGV_ASSERT(oss_is_current_running_thread(adapt->sched.event_thread));
+
+	// Check event queue, only the event thread detaches entries
+	entry = (struct amdgv_sched_event_entry *)oss_atomic_read(
+		&adapt->sched.queue_head);
+	for (; entry; entry = entry->pending_next) {
+		if ((entry->event.id == event_id) && (entry->event.idx_vf == idx_vf))
 			return true;
 	}
 
@@ -598,32 +947,27 @@ static bool amdgv_sched_is_find_event(struct amdgv_adapter *adapt, uint32_t idx_
 	return false;
 }
 
+/* event thread only, entries in the chain stay valid until it detaches them */
 static void amdgv_sched_mark_event_in_ring(struct amdgv_adapter *adapt,
 					     struct amdgv_sched_event *event,
 					     enum amdgv_event_status status,
 						 bool match_idx_vf)
 {
-	uint8_t rptr, wptr;
+	struct amdgv_sched_event_entry *entry;
 	struct amdgv_sched_event *e = NULL;
 
-	oss_spin_lock_irq(adapt->sched.queue_lock);
-
-	rptr = adapt->sched.queue_rptr;
-	wptr = adapt->sched.queue_wptr;
+	AMDGV_ASSERT(oss_is_current_running_thread(adapt->sched.event_thread));
 
-	AMDGV_DEBUG("rptr=%u, wptr=%u\n", rptr, wptr);
-
-	for (; wptr != rptr; rptr++) {
-		AMDGV_DEBUG("rptr=%u, wptr=%u\n", rptr, wptr);
-		e = &adapt->sched.event_queue[rptr].event;
+	entry = (struct amdgv_sched_event_entry *)oss_atomic_read(
+		&adapt->sched.queue_head);
+	for (; entry; entry = entry->pending_next) {
+		e = &entry->event;
 		if (e->id != event->id)
 			continue;
 		if (match_idx_vf && (e->idx_vf != event->idx_vf))
 			continue;
 		e->status = status;
 	}
-
-	oss_spin_unlock_irq(adapt->sched.queue_lock);
 }
 
 static void amdgv_sched_finish_event(struct amdgv_adapter *adapt,
@@ -672,22 +1016,118 @@ void amdgv_sched_remove_stale_events_after_wgr(struct amdgv_adapter *adapt)
 	amdgv_sched_mark_event_in_ring(adapt, &e, AMDGV_EVENT_STATUS_FINISHED, false);
 }
 
+#define AMDGV_SCHED_GPUMON_SLOT(type) ((uint32_t)(type) % AMDGV_SCHED_GPUMON_COALESCE_SLOTS)
+
+static bool amdgv_sched_gpumon_coalescable(struct amdgv_sched_event_entry *entry)
+{
+	return entry->event.id == AMDGV_EVENT_SCHED_GPUMON &&
+	       entry->event.idx_vf == AMDGV_PF_IDX &&
+	       amdgv_gpumon_coalesce_size(entry->event.data.gpumon_data.type);
+}
+
+/* all event_list updates go through here to keep the mask and indexes exact */
+static void amdgv_sched_event_list_insert(struct amdgv_adapter *adapt, uint32_t list_idx,
+					  struct amdgv_sched_event_entry *entry, bool tail)
+{
+	struct amdgv_sched_event_entry **leader;
+
+	entry->list_idx = list_idx;
+	if (tail)
+		amdgv_list_add_tail(&entry->list, &adapt->sched.event_list[list_idx]);
+	else
+		amdgv_list_add(&entry->list, &adapt->sched.event_list[list_idx]);
+
+	amdgv_list_add_tail(&entry->vf_list,
+			    &adapt->sched.event_vf_list[list_idx][entry->event.idx_vf]);
+	adapt->sched.event_list_mask |= 1 << list_idx;
+
+	if (amdgv_sched_gpumon_coalescable(entry)) {
+		leader = &adapt->sched.gpumon_leader[
+			AMDGV_SCHED_GPUMON_SLOT(entry->event.data.gpumon_data.type)];
+		if (*leader == NULL)
+			*leader = entry;
+	}
+}
+
+static void amdgv_sched_event_list_remove(struct amdgv_adapter *adapt,
+					  struct amdgv_sched_event_entry *entry)
+{
+	struct amdgv_sched_event_entry **leader;
+
+	amdgv_list_del(&entry->list);
+	amdgv_list_del_init(&entry->vf_list);
+
+	if (amdgv_list_empty(&adapt->sched.event_list[entry->list_idx]))
+		adapt->sched.event_list_mask &= ~(1 << entry->list_idx);
+
+	/* once picked the leader may already be running, stop attaching */
+	if (entry->event.id == AMDGV_EVENT_SCHED_GPUMON) {
+		leader = &adapt->sched.gpumon_leader[
+			AMDGV_SCHED_GPUMON_SLOT(entry->event.data.gpumon_data.type)];
+		if (*leader == entry)
+			*leader = NULL;
+	}
+}
+
+/* attach entry to a queued identical GPUMON request, true if attached */
+static bool amdgv_sched_coalesce_gpumon(struct amdgv_adapter *adapt,
+					struct amdgv_sched_event_entry *entry)
+{
+	struct amdgv_sched_event_entry *leader;
+
+	if (!amdgv_sched_gpumon_coalescable(entry))
+		return false;
+
+	leader = adapt->sched.gpumon_leader[
+		AMDGV_SCHED_GPUMON_SLOT(entry->event.data.gpumon_data.type)];
+	if (leader == NULL ||
+	    leader->event.data.gpumon_data.type != entry->event.data.gpumon_data.type ||
+	    leader->event.status != AMDGV_EVENT_STATUS_NORMAL)
+		return false;
+
+	amdgv_list_add_tail(&entry->list, &leader->coalesced);
+	adapt->sched.gpumon_coalesced++;
+	amdgv_sched_event_stat_coalesced(adapt, entry->event.id);
+
+	return true;
+}
+
+/* hand the leader's answer to every request coalesced into it */
+static void amdgv_sched_complete_coalesced_gpumon(struct amdgv_adapter *adapt,
+						  struct amdgv_sched_event *event)
+{
+	struct amdgv_sched_event_entry *entry, *f, *t;
+	uint32_t size;
+
+	entry = amdgv_list_entry(event, struct amdgv_sched_event_entry, event);
+	size = amdgv_gpumon_coalesce_size(event->data.gpumon_data.type);
+
+	amdgv_list_for_each_entry_safe (f, t, &entry->coalesced,
+					struct amdgv_sched_event_entry, list) {
+		amdgv_list_del(&f->list);
+		oss_memcpy(f->event.data.gpumon_data.ptr, event->data.gpumon_data.ptr, size);
+		*f->event.data.gpumon_data.result = *event->data.gpumon_data.result;
+		if (f->event.signal != OSS_INVALID_HANDLE)
+			oss_signal_event(f->event.signal);
+		amdgv_sched_event_free_entry(adapt, f);
+	}
+}
+
 static void amdgv_sched_remove_duplicated_event(struct amdgv_adapter *adapt,
 						uint32_t event_list_idx,
 						struct amdgv_sched_event_entry *new_entry)
 {
-	struct amdgv_list_head *event_head;
+	struct amdgv_list_head *vf_head;
 	struct amdgv_sched_event_entry *e, *t;
 
-	event_head = &adapt->sched.event_list[event_list_idx];
+	vf_head = &adapt->sched.event_vf_list[event_list_idx][new_entry->event.idx_vf];
 
 	/* remove the older duplicated event */
-	amdgv_list_for_each_entry_safe (e, t, event_head, struct amdgv_sched_event_entry,
-					list) {
-		if (e->event.idx_vf == new_entry->event.idx_vf) {
-			amdgv_list_del(&e->list);
-			oss_free(e);
-		}
+	amdgv_list_for_each_entry_safe (e, t, vf_head, struct amdgv_sched_event_entry,
+					vf_list) {
+		amdgv_sched_event_list_remove(adapt, e);
+		amdgv_sched_signal_skipped(adapt, &e->event);
+		amdgv_sched_event_free_entry(adapt, e);
 	}
 }
 
@@ -695,12 +1135,15 @@ static void amdgv_sched_event_arrange_event_list(struct amdgv_adapter *adapt,
 						 struct amdgv_list_head *head)
 {
 	struct amdgv_sched_event_entry *entry, *tmp;
+	uint32_t list_idx;
 
 	amdgv_list_for_each_entry_safe (entry, tmp, head, struct amdgv_sched_event_entry,
 					list) {
 		AMDGV_DEBUG("%s event = 0x%x\n", amdgv_idx_to_str(entry->event.idx_vf),
 			    entry->event.id);
 
+		amdgv_list_del(&entry->list);
+
 		switch (entry->event.id) {
 		case AMDGV_EVENT_SCHED_FORCE_RESET_GPU:
 		case AMDGV_EVENT_SCHED_FORCE_RESET_GPU_INTERNAL:
@@ -713,9 +1156,7 @@ static void amdgv_sched_event_arrange_event_list(struct amdgv_adapter *adapt,
 			amdgv_sched_remove_duplicated_event(adapt, AMDGV_SCHED_EVENT_LIST_0,
 							    entry);
 
-			amdgv_list_move_tail(
-				&entry->list,
-				&adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_0]);
+			list_idx = AMDGV_SCHED_EVENT_LIST_0;
 			break;
 		case AMDGV_EVENT_SCHED_SUSPEND_VF:
 		case AMDGV_EVENT_SCHED_RESUME_VF:
@@ -727,9 +1168,7 @@ static void amdgv_sched_event_arrange_event_list(struct amdgv_adapter *adapt,
 		case AMDGV_EVENT_SCHED_RESUME_LIVE:
 		case AMDGV_EVENT_CUR_VF_CTX_EMPTY:
 		case AMDGV_EVENT_COLLECT_DIAG_DATA:
-			amdgv_list_move_tail(
-				&entry->list,
-				&adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_1]);
+			list_idx = AMDGV_SCHED_EVENT_LIST_1;
 			break;
 		case AMDGV_EVENT_REL_GPU_INIT:
 		case AMDGV_EVENT_REL_GPU_FINI:
@@ -738,9 +1177,7 @@ static void amdgv_sched_event_arrange_event_list(struct amdgv_adapter *adapt,
 			amdgv_sched_remove_duplicated_event(adapt, AMDGV_SCHED_EVENT_LIST_2,
 							    entry);
 
-			amdgv_list_move_tail(
-				&entry->list,
-				&adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_2]);
+			list_idx = AMDGV_SCHED_EVENT_LIST_2;
 			break;
 		case AMDGV_EVENT_SCHED_RMA:
 			amdgv_sched_remove_duplicated_event(adapt, AMDGV_SCHED_EVENT_LIST_3,
@@ -756,9 +1193,7 @@ static void amdgv_sched_event_arrange_event_list(struct amdgv_adapter *adapt,
 		case AMDGV_EVENT_SCHED_PSP_VF_GATE:
 		case AMDGV_EVENT_SCHED_PSP_VF_CMD_RELAY:
 		case AMDGV_EVENT_HANDLE_CRASH:
-			amdgv_list_move_tail(
-				&entry->list,
-				&adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_3]);
+			list_idx = AMDGV_SCHED_EVENT_LIST_3;
 			break;
 		case AMDGV_EVENT_REQ_GPU_INIT:
 		case AMDGV_EVENT_REQ_GPU_FINI:
@@ -770,23 +1205,23 @@ static void amdgv_sched_event_arrange_event_list(struct amdgv_adapter *adapt,
 			amdgv_sched_remove_duplicated_event(adapt, AMDGV_SCHED_EVENT_LIST_4,
 							    entry);
 
-			amdgv_list_move_tail(
-				&entry->list,
-				&adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_4]);
+			list_idx = AMDGV_SCHED_EVENT_LIST_4;
 			break;
 		case AMDGV_EVENT_SCHED_GPUMON:
+			if (amdgv_sched_coalesce_gpumon(adapt, entry))
+				continue;
+		/* fall through */
 		case AMDGV_EVENT_SCHED_UPDATE_MCA_BANKS:
 		case AMDGV_EVENT_SCHED_GET_TOPOLOGY:
-			amdgv_list_move_tail(
-				&entry->list,
-				&adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_5]);
+			list_idx = AMDGV_SCHED_EVENT_LIST_5;
 			break;
 		default:
 			AMDGV_WARN("unknown event id = %d\n", entry->event.id);
-			amdgv_list_del(&entry->list);
-			oss_free(entry);
-			break;
+			amdgv_sched_event_free_entry(adapt, entry);
+			continue;
 		}
+
+		amdgv_sched_event_list_insert(adapt, list_idx, entry, true);
 	}
 
 	amdgv_list_del(head);
@@ -799,18 +1234,13 @@ static void amdgv_sched_event_arrange_event_list(struct amdgv_adapter *adapt,
 
 static bool amdgv_sched_event_queue_empty(struct amdgv_adapter *adapt)
 {
-	bool empty;
-
-	oss_spin_lock_irq(adapt->sched.queue_lock);
-	empty = (adapt->sched.queue_rptr == adapt->sched.queue_wptr);
-	oss_spin_unlock_irq(adapt->sched.queue_lock);
-
-	return empty;
+	return oss_atomic_read(&adapt->sched.queue_head) == 0;
 }
 
 static struct amdgv_sched_event *amdgv_sched_pick_up_next_event(struct amdgv_adapter *adapt)
 {
 	int i;
+	uint32_t mask;
 	struct amdgv_list_head *event_list = NULL;
 	struct amdgv_sched_event_entry *next_event;
 
@@ -828,24 +1258,17 @@ static struct amdgv_sched_event *amdgv_sched_pick_up_next_event(struct amdgv_ada
 		amdgv_sched_event_arrange_event_list(adapt, &queue_events);
 	}
 
-	/* if next_event is null, search the next event from the beginning */
+	/* if next_event is null, start from the highest priority non-empty list */
 	if (adapt->sched.next_event == NULL) {
-		/* try to find out the first non-empty event list */
-		for (i = 0; i < AMDGV_SCHED_EVENT_LIST_MAX; i++) {
-			if (!amdgv_list_empty(&adapt->sched.event_list[i])) {
-				event_list = &adapt->sched.event_list[i];
-				adapt->sched.curr_event_list_idx = i;
-				break;
-			}
-		}
-
-		if (event_list == NULL) {
+		if (adapt->sched.event_list_mask == 0) {
 			amdgv_sched_dump_event_list(adapt);
 			return NULL;
 		}
 
-		next_event = amdgv_list_first_entry(event_list, struct amdgv_sched_event_entry,
-						    list);
+		i = amdgv_ffs(adapt->sched.event_list_mask) - 1;
+		adapt->sched.curr_event_list_idx = i;
+		next_event = amdgv_list_first_entry(&adapt->sched.event_list[i],
+						    struct amdgv_sched_event_entry, list);
 	} else {
 		next_event = adapt->sched.next_event;
 	}
@@ -856,21 +1279,16 @@ static struct amdgv_sched_event *amdgv_sched_pick_up_next_event(struct amdgv_ada
 	/* next_event is the last event of event list,
 	   move to next event list to pick up next event */
 	if (next_event->list.next == event_list) {
-		/* try to find the next non-empty event list */
-		for (i++; i < AMDGV_SCHED_EVENT_LIST_MAX; i++) {
-			if (!amdgv_list_empty(&adapt->sched.event_list[i])) {
-				event_list = &adapt->sched.event_list[i];
-				adapt->sched.curr_event_list_idx = i;
-				break;
-			}
-		}
-
-		if (i == AMDGV_SCHED_EVENT_LIST_MAX) {
+		/* the next non-empty event list of lower priority */
+		mask = adapt->sched.event_list_mask & amdgv_fill(i);
+		if (mask == 0) {
 			adapt->sched.curr_event_list_idx = 0;
 			adapt->sched.next_event = NULL;
 		} else {
+			i = amdgv_ffs(mask) - 1;
+			adapt->sched.curr_event_list_idx = i;
 			adapt->sched.next_event = amdgv_list_first_entry(
-				event_list, struct amdgv_sched_event_entry, list);
+				&adapt->sched.event_list[i], struct amdgv_sched_event_entry, list);
 		}
 	} else {
 		adapt->sched.next_event = amdgv_list_entry(
@@ -880,7 +1298,7 @@ static struct amdgv_sched_event *amdgv_sched_pick_up_next_event(struct amdgv_ada
 	AMDGV_DEBUG("next event entry = %p, event = %p\n", next_event, &next_event->event);
 
 	/* remove next_event from event_list */
-	amdgv_list_del(&next_event->list);
+	amdgv_sched_event_list_remove(adapt, next_event);
 
 	amdgv_sched_dump_event_list(adapt);
 
@@ -891,6 +1309,7 @@ static void amdgv_sched_push_back_event(struct amdgv_adapter *adapt,
 					struct amdgv_sched_event *event)
 {
 	struct amdgv_sched_event_entry *entry;
+	uint32_t list_idx;
 
 	entry = amdgv_list_entry(event, struct amdgv_sched_event_entry, event);
 
@@ -911,9 +1330,7 @@ static void amdgv_sched_push_back_event(struct amdgv_adapter *adapt,
 	case AMDGV_EVENT_SCHED_RAS_POISON_CONSUMPTION:
 	case AMDGV_EVENT_SCHED_RAS_POISON_CREATION:
 	case AMDGV_EVENT_SCHED_RAS_FED:
-		adapt->sched.curr_event_list_idx = AMDGV_SCHED_EVENT_LIST_0;
-		amdgv_list_add(&entry->list,
-			       &adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_0]);
+		list_idx = AMDGV_SCHED_EVENT_LIST_0;
 		break;
 	case AMDGV_EVENT_SCHED_SUSPEND_VF:
 	case AMDGV_EVENT_SCHED_RESUME_VF:
@@ -925,17 +1342,13 @@ static void amdgv_sched_push_back_event(struct amdgv_adapter *adapt,
 	case AMDGV_EVENT_SCHED_RESUME_LIVE:
 	case AMDGV_EVENT_CUR_VF_CTX_EMPTY:
 	case AMDGV_EVENT_COLLECT_DIAG_DATA:
-		adapt->sched.curr_event_list_idx = AMDGV_SCHED_EVENT_LIST_1;
-		amdgv_list_add(&entry->list,
-			       &adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_1]);
+		list_idx = AMDGV_SCHED_EVENT_LIST_1;
 		break;
 	case AMDGV_EVENT_REL_GPU_INIT:
 	case AMDGV_EVENT_REL_GPU_FINI:
 	case AMDGV_EVENT_SCHED_UPDATE_TOPOLOGY:
 	case AMDGV_EVENT_REL_GPU_DEBUG:
-		adapt->sched.curr_event_list_idx = AMDGV_SCHED_EVENT_LIST_2;
-		amdgv_list_add(&entry->list,
-			       &adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_2]);
+		list_idx = AMDGV_SCHED_EVENT_LIST_2;
 		break;
 	case AMDGV_EVENT_SCHED_RESET_VF:
 	case AMDGV_EVENT_SCHED_FORCE_RESET_VF:
@@ -948,33 +1361,29 @@ static void amdgv_sched_push_back_event(struct amdgv_adapter *adapt,
 	case AMDGV_EVENT_SCHED_PSP_VF_CMD_RELAY:
 	case AMDGV_EVENT_HANDLE_CRASH:
 	case AMDGV_EVENT_SCHED_RMA:
-		adapt->sched.curr_event_list_idx = AMDGV_SCHED_EVENT_LIST_3;
-		amdgv_list_add(&entry->list,
-			       &adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_3]);
+		list_idx = AMDGV_SCHED_EVENT_LIST_3;
 		break;
 	case AMDGV_EVENT_REQ_GPU_INIT:
 	case AMDGV_EVENT_REQ_GPU_FINI:
 	case AMDGV_EVENT_REQ_GPU_RESET:
 	case AMDGV_EVENT_REQ_GPU_INIT_DATA:
 	case AMDGV_EVENT_REQ_GPU_DEBUG:
-		adapt->sched.curr_event_list_idx = AMDGV_SCHED_EVENT_LIST_4;
-		amdgv_list_add(&entry->list,
-			       &adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_4]);
+		list_idx = AMDGV_SCHED_EVENT_LIST_4;
 		break;
 	case AMDGV_EVENT_SCHED_GPUMON:
 	case AMDGV_EVENT_SCHED_UPDATE_MCA_BANKS:
 	case AMDGV_EVENT_SCHED_GET_TOPOLOGY:
-		adapt->sched.curr_event_list_idx = AMDGV_SCHED_EVENT_LIST_5;
-		amdgv_list_add(&entry->list,
-			       &adapt->sched.event_list[AMDGV_SCHED_EVENT_LIST_5]);
+		list_idx = AMDGV_SCHED_EVENT_LIST_5;
 		break;
 	default:
 		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_INVALID_VALUE,
 				entry->event.id);
-		oss_free(entry);
+		amdgv_sched_event_free_entry(adapt, entry);
 		return;
 	}
 
+	adapt->sched.curr_event_list_idx = list_idx;
+	amdgv_sched_event_list_insert(adapt, list_idx, entry, false);
 	adapt->sched.next_event = entry;
 
 	amdgv_sched_dump_event_list(adapt);
@@ -3009,6 +3418,7 @@ static int handle_event_in_non_full_access(struct amdgv_adapter *adapt,
 			ret = AMDGV_EVENT_STOP_AND_KEEP;
 		} else {
 			amdgv_gpumon_handle_sched_event(adapt, event);
+			amdgv_sched_complete_coalesced_gpumon(adapt, event);
 		}
 		break;
 
@@ -3135,9 +3545,7 @@ static int amdgv_sched_process_event_fini(struct amdgv_adapter *adapt)
 		AMDGV_INFO("Skipped %s request from %s for %s due to driver unload\n",
 				amdgv_event_name(event->id), amdgv_idx_to_str(event->idx_vf),
 				amdgv_sched_block_to_name(event->sched_block));
-		if (event->signal != OSS_INVALID_HANDLE) {
-			oss_signal_event_with_flag(event->signal, EVENT_FLAGS_SKIPPED);
-		}
+		amdgv_sched_signal_skipped(adapt, event);
 		amdgv_sched_free_event(adapt, event);
 	}
 
@@ -3150,6 +3558,8 @@ static int amdgv_sched_process_event(struct amdgv_adapter *adapt)
 	int i;
 	struct amdgv_sched_event *event;
 	struct amdgv_vf_device *vf_device;
+	enum amdgv_sched_event_id event_id;
+	uint64_t queue_time, start_time;
 
 	do {
 		/* Pick up event from event list according to
@@ -3168,16 +3578,14 @@ static int amdgv_sched_process_event(struct amdgv_adapter *adapt)
 			if (adapt->bp_mode == AMDGV_BP_MODE_1 && AMDGV_PF_IDX == event->idx_vf &&
 				adapt->array_vf[AMDGV_PF_IDX].vf_status == AMDGV_VF_STATUS_END_INIT) {
 				AMDGV_ERROR("BP_MODE1 is enabled skip all PF events and fake signal this event\n");
-				if (event->signal != OSS_INVALID_HANDLE)
-					oss_signal_event_with_flag(event->signal, EVENT_FLAGS_SKIPPED);
+				amdgv_sched_signal_skipped(adapt, event);
 				amdgv_sched_free_event(adapt, event);
 				continue;
 			}
 
 			if (event->status == AMDGV_EVENT_STATUS_FINISHED) {
 				AMDGV_DEBUG("Skip stale event %s\n", amdgv_event_name(event->id));
-				if (event->signal != OSS_INVALID_HANDLE)
-					oss_signal_event_with_flag(event->signal, EVENT_FLAGS_SKIPPED);
+				amdgv_sched_signal_skipped(adapt, event);
 				amdgv_sched_free_event(adapt, event);
 				continue;
 			}
@@ -3191,8 +3599,7 @@ static int amdgv_sched_process_event(struct amdgv_adapter *adapt)
 				AMDGV_WARN("Unrecov Err happened before handling %s from %s. Dropping this event\n",
 						amdgv_event_name(event->id), amdgv_idx_to_str(event->idx_vf));
 
-				if (event->signal != OSS_INVALID_HANDLE)
-					oss_signal_event_with_flag(event->signal, EVENT_FLAGS_SKIPPED);
+				amdgv_sched_signal_skipped(adapt, event);
 
 				amdgv_sched_free_event(adapt, event);
 				continue;
@@ -3224,12 +3631,21 @@ static int amdgv_sched_process_event(struct amdgv_adapter *adapt)
 			 * If any VF sharing common engine with current VF is
 			 * in full access : handle as full access
 			 */
+			event_id = event->id;
+			queue_time = event->timestamp;
+			start_time = oss_get_time_stamp();
+
 			if (is_any_share_engine_vf_in_full_access(event->idx_vf)) {
 				stop = handle_event_in_full_access(adapt, event);
 			} else {
 				stop = handle_event_in_non_full_access(adapt, event);
 			}
 
+			/* a kept event is handled again and counted then */
+			if (stop != AMDGV_EVENT_STOP_AND_KEEP)
+				amdgv_sched_event_stat_handled(adapt, event_id, queue_time,
+							       start_time);
+
 			/* Stop processing the remaining events, wait for new events */
 			if (stop == AMDGV_EVENT_STOP_AND_RELEASE) {
 				/* current event is completed */
@@ -3599,19 +4015,38 @@ int amdgv_sched_queue_event_and_wait_ex(struct amdgv_adapter *adapt, uint32_t id
 					union amdgv_sched_event_data data)
 {
 	event_t signal;
+	uint32_t signal_slot;
+	uint32_t backoff;
 	int ret;
 
 	ret = amdgv_sched_sanitize_queue_event(adapt, idx_vf, event_id, data);
 	if (ret)
 		return ret;
 
+	/* static and freshly cached gpumon queries skip the queue round trip */
+	if (event_id == AMDGV_EVENT_SCHED_GPUMON &&
+	    amdgv_gpumon_handle_fast_path(adapt, &data))
+		return 0;
+
 	/* forbid recursive queue_and_wait in event_thread, which will lead to deadlock */
 	if (oss_is_current_running_thread(adapt->sched.event_thread)) {
 		AMDGV_ERROR("Recursive push_event_and_wait in event_thread detected!\n");
 		return AMDGV_FAILURE;
 	}
 
-	signal = oss_event_init();
+	/* Back-pressure: once the pool is drained, callers that can sleep
+	 * leave the remaining entries to interrupt and mailbox producers for
+	 * a while, then fall back to the heap instead of failing.
+	 */
+	for (backoff = 0; backoff < AMDGV_EVENT_POOL_BACKOFF_MS &&
+	     oss_atomic_read(&adapt->sched.event_pool_inflight) >= AMDGV_EVENT_POOL_SIZE;
+	     backoff++) {
+		if (backoff == 0)
+			oss_atomic_inc(&adapt->sched.event_pool_backoff);
+		oss_msleep(1);
+	}
+
+	signal = amdgv_sched_get_signal(adapt, &signal_slot);
 	if (signal == OSS_INVALID_HANDLE) {
 		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_EVENT_FAIL, 0);
 		return AMDGV_FAILURE;
@@ -3620,7 +4055,7 @@ int amdgv_sched_queue_event_and_wait_ex(struct amdgv_adapter *adapt, uint32_t id
 	/* push event to event queue */
 	if (amdgv_sched_event_queue_push_ex(adapt, idx_vf, event_id, sched_block, signal,
 					    data, true)) {
-		oss_event_fini(signal);
+		amdgv_sched_put_signal(adapt, signal, signal_slot, true);
 		return AMDGV_FAILURE;
 	}
 
@@ -3629,7 +4064,8 @@ int amdgv_sched_queue_event_and_wait_ex(struct amdgv_adapter *adapt, uint32_t id
 		ret = oss_wait_event(signal, 0);
 	} while (ret == OSS_EVENT_STATE_INTERRUPTED);
 
-	oss_event_fini(signal);
+	amdgv_sched_put_signal(adapt, signal, signal_slot,
+			       ret == OSS_EVENT_STATE_WAKE_UP);
 
 	if (ret != OSS_EVENT_STATE_WAKE_UP)
 		return AMDGV_FAILURE;
@@ -3639,11 +4075,17 @@ int amdgv_sched_queue_event_and_wait_ex(struct amdgv_adapter *adapt, uint32_t id
 
 int amdgv_sched_event_queue_process_init(struct amdgv_adapter *adapt)
 {
-	int i;
+	int i, j;
 	thread_t event_thread;
 
-	for (i = 0; i < AMDGV_SCHED_EVENT_LIST_MAX; i++)
+	for (i = 0; i < AMDGV_SCHED_EVENT_LIST_MAX; i++) {
 		AMDGV_INIT_LIST_HEAD(&adapt->sched.event_list[i]);
+		for (j = 0; j < AMDGV_MAX_VF_SLOT; j++)
+			AMDGV_INIT_LIST_HEAD(&adapt->sched.event_vf_list[i][j]);
+	}
+	adapt->sched.event_list_mask = 0;
+	oss_memset(adapt->sched.gpumon_leader, 0, sizeof(adapt->sched.gpumon_leader));
+	adapt->sched.gpumon_coalesced = 0;
 
 	adapt->sched.event = oss_event_init();
 	if (adapt->sched.event == OSS_INVALID_HANDLE) {
@@ -3772,6 +4214,69 @@ void amdgv_sched_event_queue_process_fini(struct amdgv_adapter *adapt)
 	}
 }
 
+int amdgv_sched_event_get_stats(struct amdgv_adapter *adapt, uint32_t idx,
+				struct amdgv_sched_event_stats *stats)
+{
+	struct amdgv_sched_event_stat *stat;
+	int ret = 0;
+
+	if (idx >= AMDGV_SCHED_EVENT_STATS_NUM)
+		return AMDGV_FAILURE;
+
+	if (adapt->sched.event_stats_lock == OSS_INVALID_HANDLE)
+		return AMDGV_FAILURE;
+
+	stats->event_id = amdgv_sched_event_stat_id(idx);
+
+	oss_spin_lock(adapt->sched.event_stats_lock);
+	if (adapt->sched.event_stats) {
+		stat = &adapt->sched.event_stats[idx];
+		stats->queued = oss_atomic_read(&stat->queued);
+		stats->coalesced = stat->coalesced;
+		stats->skipped = stat->skipped;
+		stats->handled = stat->handled;
+		stats->wait_sum_us = stat->wait_sum_us;
+		stats->wait_max_us = stat->wait_max_us;
+		oss_memcpy(&stats->wait_us, &stat->wait_us, sizeof(stats->wait_us));
+		stats->run_sum_us = stat->run_sum_us;
+		stats->run_max_us = stat->run_max_us;
+		oss_memcpy(&stats->run_us, &stat->run_us, sizeof(stats->run_us));
+	} else {
+		ret = AMDGV_FAILURE;
+	}
+	oss_spin_unlock(adapt->sched.event_stats_lock);
+
+	return ret;
+}
+
+void amdgv_sched_event_get_queue_stats(struct amdgv_adapter *adapt,
+				       struct amdgv_sched_event_queue_stats *stats)
+{
+	stats->depth = oss_atomic_read(&adapt->sched.event_pool_inflight);
+	stats->max_depth = oss_atomic_read(&adapt->sched.event_pool_max_inflight);
+	stats->pool_overflow = oss_atomic_read(&adapt->sched.event_pool_overflow);
+	stats->pool_backoff = oss_atomic_read(&adapt->sched.event_pool_backoff);
+}
+
+int amdgv_sched_event_clear_stats(struct amdgv_adapter *adapt)
+{
+	uint32_t i;
+
+	if (adapt->sched.event_stats_lock == OSS_INVALID_HANDLE)
+		return AMDGV_FAILURE;
+
+	oss_spin_lock(adapt->sched.event_stats_lock);
+	if (adapt->sched.event_stats) {
+		for (i = 0; i < AMDGV_SCHED_EVENT_STATS_NUM; i++)
+			amdgv_sched_event_stat_reset(&adapt->sched.event_stats[i]);
+	}
+	oss_atomic_set(&adapt->sched.event_pool_max_inflight,
+		       oss_atomic_read(&adapt->sched.event_pool_inflight));
+	oss_spin_unlock(adapt->sched.event_stats_lock);
+
+	return 0;
+}
+
 int amdgv_sched_export_unprocessed_event_size(struct amdgv_adapter *adapt,
 					      uint32_t *unprocessed_event_count)
 {
@@ -3819,6 +4324,7 @@ enum amdgv_live_info_status amdgv_sched_export_unprocessed_event(struct amdgv_ad
 	struct amdgv_sched_event *event;
 	uint32_t unprocessed_event_size = 0;
 	uint32_t i = 0;
+	uint32_t dropped = 0;
 
 	if (event_info == NULL) {
 		AMDGV_INFO("event_info is NULL!\n");
@@ -3831,30 +4337,33 @@ enum amdgv_live_info_status amdgv_sched_export_unprocessed_event(struct amdgv_ad
 	 * pushed into the list when exporting the unprocessed event size
 	 */
 	while ((event = amdgv_sched_pick_up_next_event(adapt)) != NULL) {
-		AMDGV_INFO("save %s request from %s for %s\n", amdgv_event_name(event->id),
-			   amdgv_idx_to_str(event->idx_vf),
-			   amdgv_sched_block_to_name(event->sched_block));
 		if (event->signal != OSS_INVALID_HANDLE)
 			oss_signal_event(event->signal);
 
-		if (i >= AMDGV_EVENT_QUEUE_ENTRY_NUM) {
-			AMDGV_WARN(
-				"No room left for exporting unprocessed event, maximum is %d\n",
-				AMDGV_EVENT_QUEUE_ENTRY_NUM);
-			break;
-		}
-
 		/* Do not export SCHED_GPUMON, since it calls from user application */
 		if (event->id != AMDGV_EVENT_SCHED_GPUMON) {
-			event_info->unprocessed_events[i].idx_vf = event->idx_vf;
-			event_info->unprocessed_events[i].id = event->id;
-			event_info->unprocessed_events[i].sched_id = event->sched_block;
-			i++;
+			if (i < AMDGV_EVENT_QUEUE_ENTRY_NUM) {
+				AMDGV_INFO("save %s request from %s for %s\n",
+					   amdgv_event_name(event->id),
+					   amdgv_idx_to_str(event->idx_vf),
+					   amdgv_sched_block_to_name(event->sched_block));
+				event_info->unprocessed_events[i].idx_vf = event->idx_vf;
+				event_info->unprocessed_events[i].id = event->id;
+				event_info->unprocessed_events[i].sched_id = event->sched_block;
+				i++;
+			} else {
+				/* keep draining so every waiter is released and entry freed */
+				dropped++;
+			}
 		}
 
 		amdgv_sched_free_event(adapt, event);
 	}
 
+	if (dropped)
+		AMDGV_WARN("No room left for exporting unprocessed event, maximum is %d, "
+			   "dropped %u\n", AMDGV_EVENT_QUEUE_ENTRY_NUM, dropped);
+
 	event_info->unprocessed_event_count = i;
 
 	if (!amdgv_sched_event_queue_empty(adapt))
@@ -32,6 +32,9 @@
 #define AMDGV_SCHED_EXCLUSIVE_TIMEOUT_MS_1VF 3000
 #define AMDGV_SCHED_EXCLUSIVE_TIMEOUT_MS_COMMON 1500
 
+/* hybrid liquid mode: minimum run time of a VF when all VFs are idle */
+#define HLIQUID_ALL_VF_IDLE_MIN_TS (500)
+
 #define set_to_avail_vf(idx_vf) adapt->sched.array_vf[(idx_vf)].state = AMDGV_SCHED_AVAIL
 
 #define set_to_active_vf(idx_vf) adapt->sched.array_vf[(idx_vf)].state = AMDGV_SCHED_ACTIVE
@@ -191,4 +194,18 @@ int amdgv_sched_world_context_sync_abnormal_sched(struct amdgv_adapter *adapt, u
 int64_t amdgv_sched_world_switch_calculate_time_slice(struct amdgv_adapter *adapt,
 							     struct amdgv_sched_world_switch *world_switch,
 							     uint32_t idx_vf);
+
+/* world switch policy, amdgv_sched_policy.c */
+typedef int (*amdgv_sched_policy_func)(struct amdgv_sched_world_switch *world_switch,
+				       struct amdgv_list_head *active_list,
+				       int *vf_idx, uint64_t *ts);
+
+amdgv_sched_policy_func amdgv_sched_policy_select(struct amdgv_adapter *adapt,
+						  enum amdgv_sched_mode sched_mode);
+void amdgv_sched_policy_account(struct amdgv_adapter *adapt,
+				struct amdgv_sched_active_vf_entry *entry, uint64_t curr_ts);
+void amdgv_sched_vt_enqueue(struct amdgv_sched_world_switch *world_switch,
+			    struct amdgv_sched_active_vf_entry *entry);
+void amdgv_sched_vt_dequeue(struct amdgv_sched_world_switch *world_switch,
+			    struct amdgv_sched_active_vf_entry *entry);
 #endif
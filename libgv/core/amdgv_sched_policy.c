@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2017-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* World switch scheduling policies. The functions here only read and
+ * update the manual switch bookkeeping (active list, entries, virtual time
+ * heap) and never touch the hardware, so the same policy code can be linked
+ * into an offline simulator, see tools/sched_sim.
+ */
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_sched_internal.h"
+#include "amdgv_list.h"
+
+static const uint32_t this_block = AMDGV_SCHEDULER_BLOCK;
+
+#define MAX_VF_SKIP_CNT (8)
+
+/* charge the time an entry ran since start_ts: total_time for the
+ * virtual time mode, beyond_time_cycle for the fairness punishment
+ */
+void amdgv_sched_policy_account(struct amdgv_adapter *adapt,
+				struct amdgv_sched_active_vf_entry *entry, uint64_t curr_ts)
+{
+	int64_t duration;
+
+	entry->total_time += curr_ts - entry->start_ts;
+	duration = curr_ts - (entry->start_ts + entry->last_time_slice);
+	if (duration > 0) {
+		/* No Punishment under BP Mode */
+		if (entry->skip_next_punish || adapt->bp_mode != AMDGV_BP_MODE_DISABLE)
+			entry->skip_next_punish = false;
+		else
+			entry->beyond_time_cycle += duration;
+	}
+	entry->start_ts = 0;
+}
+
+int64_t
+amdgv_sched_world_switch_calculate_time_slice(struct amdgv_adapter *adapt,
+						  struct amdgv_sched_world_switch *world_switch,
+						  uint32_t idx_vf)
+{
+	struct amdgv_sched_active_vf_entry *entry;
+	int64_t time_slice;
+	int64_t min_time_slice;
+	bool dummy;
+
+	AMDGV_ASSERT(world_switch->sched_block < AMDGV_SCHED_BLOCK_MAX);
+
+	entry = &world_switch->manual.array_vf[idx_vf];
+
+	/* save the dummy and time_slice from the current entry.
+	 * If we are processing a dummy VF. Calculate the
+	 * timeslice based on the world-switch overhead to the PF
+	 */
+	dummy = entry->dummy_vf;
+	time_slice = entry->time_slice;
+	min_time_slice = entry->time_slice / 2;
+
+	if (dummy)
+		entry = &world_switch->manual.array_vf[AMDGV_PF_IDX];
+
+	if (world_switch->manual.fairness_mode) {
+		/* If a VF is given single VF status, check if self-switch
+		 * is enabled. If it is, reschedule the VF every 500ms, if not
+		 * do not re-schedule the world-switch timer
+		 */
+		if (entry->time_slice == DEFAULT_GFX_TIME_SLICE_1VF) {
+			/* Beyond time cycle is ignored in single VF mode */
+			entry->beyond_time_cycle = 0;
+			entry->last_time_slice =
+				GET_GFX_TIME_SLICE(adapt, adapt->sched.num_vf_per_gfx_sched);
+
+			goto out;
+		}
+
+		time_slice -= entry->beyond_time_cycle;
+
+		/* If beyond_time_cycle overruns time_slice,
+		 * will return 0 to skip scheduling it.
+		 * And if it gets a time_slice smaller than min_time_slice,
+		 * it can to be scheduled with min_time_slice,
+		 * but the credit of delta will be updated to beyond_time_cycle.
+		 */
+		if (time_slice <= 0) {
+			entry->last_time_slice = 0;
+			entry->beyond_time_cycle -= entry->time_slice;
+			AMDGV_DEBUG("skip scheduling %s\n", amdgv_idx_to_str(entry->idx_vf));
+		} else {
+			if (time_slice <= min_time_slice) {
+				entry->last_time_slice = min_time_slice;
+				entry->beyond_time_cycle = (min_time_slice - time_slice);
+				AMDGV_DEBUG("punish %s %dus\n",
+						amdgv_idx_to_str(entry->idx_vf),
+						entry->time_slice - min_time_slice);
+			} else {
+				entry->last_time_slice = time_slice;
+				entry->beyond_time_cycle = 0;
+				AMDGV_DEBUG("punish %s %dus\n",
+						amdgv_idx_to_str(entry->idx_vf),
+						entry->time_slice - time_slice);
+			}
+		}
+		/* For dummy VF, we only care about the cumulated overhead
+		 * on the last world-switch, we need to give a bit more of leeway
+		 * to the PF time slice.
+		 */
+		if (dummy)
+			entry->beyond_time_cycle = 0;
+	} else {
+		entry->last_time_slice = entry->time_slice;
+	}
+out:
+	return entry->last_time_slice;
+}
+
+/* Virtual time mode keeps the active entries in a binary min-heap keyed
+ * by vtime, ties broken by idx_vf so the order is deterministic.
+ */
+static bool amdgv_sched_vt_before(struct amdgv_sched_active_vf_entry *a,
+				  struct amdgv_sched_active_vf_entry *b)
+{
+	if (a->vtime != b->vtime)
+		return a->vtime < b->vtime;
+
+	return a->idx_vf < b->idx_vf;
+}
+
+static void amdgv_sched_vt_heap_set(struct amdgv_sched_world_switch *world_switch,
+				    uint32_t pos, struct amdgv_sched_active_vf_entry *entry)
+{
+	world_switch->manual.vt_heap[pos] = entry;
+	entry->vt_heap_pos = pos;
+}
+
+static void amdgv_sched_vt_sift_up(struct amdgv_sched_world_switch *world_switch, uint32_t pos)
+{
+	struct amdgv_sched_active_vf_entry **heap = world_switch->manual.vt_heap;
+	struct amdgv_sched_active_vf_entry *entry = heap[pos];
+	uint32_t parent;
+
+	while (pos > 0) {
+		parent = (pos - 1) / 2;
+		if (!amdgv_sched_vt_before(entry, heap[parent]))
+			break;
+		amdgv_sched_vt_heap_set(world_switch, pos, heap[parent]);
+		pos = parent;
+	}
+	amdgv_sched_vt_heap_set(world_switch, pos, entry);
+}
+
+static void amdgv_sched_vt_sift_down(struct amdgv_sched_world_switch *world_switch, uint32_t pos)
+{
+	struct amdgv_sched_active_vf_entry **heap = world_switch->manual.vt_heap;
+	struct amdgv_sched_active_vf_entry *entry = heap[pos];
+	uint32_t size = world_switch->manual.vt_heap_size;
+	uint32_t child;
+
+	while ((child = 2 * pos + 1) < size) {
+		if (child + 1 < size && amdgv_sched_vt_before(heap[child + 1], heap[child]))
+			child++;
+		if (!amdgv_sched_vt_before(heap[child], entry))
+			break;
+		amdgv_sched_vt_heap_set(world_switch, pos, heap[child]);
+		pos = child;
+	}
+	amdgv_sched_vt_heap_set(world_switch, pos, entry);
+}
+
+static void amdgv_sched_vt_heap_push(struct amdgv_sched_world_switch *world_switch,
+				     struct amdgv_sched_active_vf_entry *entry)
+{
+	amdgv_sched_vt_heap_set(world_switch, world_switch->manual.vt_heap_size++, entry);
+	amdgv_sched_vt_sift_up(world_switch, entry->vt_heap_pos);
+}
+
+void amdgv_sched_vt_enqueue(struct amdgv_sched_world_switch *world_switch,
+			    struct amdgv_sched_active_vf_entry *entry)
+{
+	if (world_switch->sched_mode != AMDGV_SCHED_VIRTUAL_TIME_MODE ||
+	    entry->vt_heap_pos != AMDGV_SCHED_VT_NOT_QUEUED)
+		return;
+
+	/* a VF joining (or rejoining after idle) starts at the current
+	 * virtual time, it neither monopolizes the GPU to catch up on the
+	 * time it was away nor waits behind the VFs already queued
+	 */
+	if (entry->vtime < world_switch->manual.vt_clock)
+		entry->vtime = world_switch->manual.vt_clock;
+	entry->vt_charged = entry->total_time;
+
+	amdgv_sched_vt_heap_push(world_switch, entry);
+}
+
+void amdgv_sched_vt_dequeue(struct amdgv_sched_world_switch *world_switch,
+			    struct amdgv_sched_active_vf_entry *entry)
+{
+	struct amdgv_sched_active_vf_entry *last;
+	uint32_t pos = entry->vt_heap_pos;
+
+	if (pos == AMDGV_SCHED_VT_NOT_QUEUED)
+		return;
+
+	entry->vt_heap_pos = AMDGV_SCHED_VT_NOT_QUEUED;
+	if (world_switch->manual.vt_last == entry)
+		world_switch->manual.vt_last = NULL;
+
+	last = world_switch->manual.vt_heap[--world_switch->manual.vt_heap_size];
+	if (last == entry)
+		return;
+
+	amdgv_sched_vt_heap_set(world_switch, pos, last);
+	amdgv_sched_vt_sift_up(world_switch, pos);
+	amdgv_sched_vt_sift_down(world_switch, last->vt_heap_pos);
+}
+
+/* advance the virtual time of the entry by the GPU time it consumed since
+ * it was last charged, weighted by its time slice
+ */
+static void amdgv_sched_vt_charge(struct amdgv_sched_world_switch *world_switch,
+				  struct amdgv_sched_active_vf_entry *entry)
+{
+	uint64_t used;
+
+	/* total_time is cleared on VF reset, restart the accounting */
+	if (entry->total_time < entry->vt_charged)
+		entry->vt_charged = 0;
+
+	used = entry->total_time - entry->vt_charged;
+	entry->vt_charged = entry->total_time;
+	if (used == 0)
+		return;
+
+	used <<= AMDGV_SCHED_VT_SHIFT;
+	oss_do_div(&used, entry->time_slice ? (uint32_t)entry->time_slice : 1);
+	entry->vtime += used;
+
+	amdgv_sched_vt_sift_down(world_switch, entry->vt_heap_pos);
+}
+
+static bool amdgv_sched_vt_skip(struct amdgv_adapter *adapt,
+				struct amdgv_sched_active_vf_entry *entry)
+{
+	/* same as the default policy, a suspended PF that is yet to be
+	 * removed is not scheduled, neither is a VF without time slice
+	 */
+	if (entry->idx_vf == AMDGV_PF_IDX && !is_active_vf(AMDGV_PF_IDX))
+		return true;
+
+	return entry->time_slice == 0;
+}
+
+static int amdgv_schedule_vfs_default(struct amdgv_sched_world_switch *world_switch,
+				struct amdgv_list_head *active_list, int *vf_idx, uint64_t *ts)
+{
+
+	struct amdgv_sched_active_vf_entry *entry;
+	struct amdgv_adapter *adapt = world_switch->manual.adapt;
+
+re_schedule:
+	entry = amdgv_list_first_entry(active_list,
+					   struct amdgv_sched_active_vf_entry, list);
+	/* pf may be set to suspend but yet removed
+	 * from world switch, so dont schedual pf here
+	 * since it is going to be removed
+	 */
+	if ((entry->idx_vf == AMDGV_PF_IDX) &&
+		 (!is_active_vf(AMDGV_PF_IDX))) {
+		amdgv_list_move_tail(&entry->list, active_list);
+		entry = amdgv_list_first_entry(active_list, struct amdgv_sched_active_vf_entry, list);
+	}
+
+	*vf_idx = entry->idx_vf;
+	*ts = amdgv_sched_world_switch_calculate_time_slice(adapt, world_switch,
+								   entry->idx_vf);
+
+	if (*ts == 0) {
+		AMDGV_DEBUG("skip scheduling %s\n", amdgv_idx_to_str(entry->idx_vf));
+		amdgv_list_move_tail(&entry->list, &world_switch->manual.active_vf_list);
+
+		goto re_schedule;
+	}
+
+	if (world_switch->manual.fairness_mode && entry->dummy_vf) {
+		AMDGV_DEBUG("load dummy %s, time slice = %d\n",
+				amdgv_idx_to_str(entry->idx_vf), *ts);
+		amdgv_list_move_tail(&entry->list, &world_switch->manual.active_vf_list);
+		*vf_idx = AMDGV_PF_IDX;
+	}
+
+	return 0;
+}
+static int amdgv_schedule_vfs_liquid(struct amdgv_sched_world_switch *world_switch,
+				struct amdgv_list_head *active_list, int *vf_idx, uint64_t *ts)
+{
+	uint32_t vf_status = 0;
+	struct amdgv_sched_active_vf_entry *entry;
+	struct amdgv_adapter *adapt = world_switch->manual.adapt;
+
+	/* Hybrid liquid mode busy status has 2 parts
+	 * 1. vf_busy_status got from HW
+	 * 2. the current VF timeout
+	 */
+	vf_status = (world_switch->vf_busy_status | world_switch->vf_timeout) &
+			 world_switch->vf_inited;
+
+	/* Only hybrid liquid mode update the vf_status, otherwise vf_status = 0
+	 *
+	 * The first busy VF in the list is priority to get the GPU.
+	 * when this VF was switched out, it will be moved to list tail.
+	 *
+	 * If all VF is idle, run the VF one by one.
+	 */
+
+	entry = amdgv_list_first_entry(active_list,
+					   struct amdgv_sched_active_vf_entry, list);
+	if ((entry->idx_vf == AMDGV_PF_IDX) &&
+		 (!is_active_vf(AMDGV_PF_IDX))) {
+		amdgv_list_move_tail(&entry->list, active_list);
+	}
+
+	if (!vf_status)
+		entry = amdgv_list_first_entry(active_list,
+					   struct amdgv_sched_active_vf_entry, list);
+	else
+		amdgv_list_for_each_entry (entry, active_list,
+				   struct amdgv_sched_active_vf_entry, list) {
+			if (vf_status & (1 << entry->idx_vf))
+				break;
+
+			if (entry == amdgv_list_last_entry(active_list,
+					struct amdgv_sched_active_vf_entry, list)) {
+				AMDGV_DEBUG("Failed to get a valid VF, run the first VF in the list\n");
+				entry = amdgv_list_first_entry(active_list,
+						   struct amdgv_sched_active_vf_entry, list);
+
+				break;
+			}
+
+			if ((entry->idx_vf == AMDGV_PF_IDX) &&
+				(!is_active_vf(AMDGV_PF_IDX)))
+				continue;
+
+			if (entry->skip_cnt >= MAX_VF_SKIP_CNT)
+				break;
+
+			entry->skip_cnt++;
+		}
+
+	entry->skip_cnt = 0;
+
+	*vf_idx = entry->idx_vf;
+	*ts = entry->time_slice;
+
+	return 0;
+}
+
+static int amdgv_schedule_vfs_vtime(struct amdgv_sched_world_switch *world_switch,
+				    struct amdgv_list_head *active_list, int *vf_idx, uint64_t *ts)
+{
+	struct amdgv_sched_active_vf_entry *skipped[AMDGV_MAX_VF_SLOT];
+	struct amdgv_sched_active_vf_entry *entry = NULL;
+	struct amdgv_adapter *adapt = world_switch->manual.adapt;
+	uint32_t num_skipped = 0;
+	uint32_t i;
+
+	if (world_switch->manual.vt_heap_size == 0)
+		return AMDGV_FAILURE;
+
+	/* bill the VF that just ran before picking the next one, overrun
+	 * included, so a VF exceeding its slice pays it back in virtual time
+	 */
+	if (world_switch->manual.vt_last)
+		amdgv_sched_vt_charge(world_switch, world_switch->manual.vt_last);
+
+	/* the heap root has the least service per time slice. A root that
+	 * can't run is never charged and would stay there, so set it aside
+	 * until a runnable root shows up and put it back afterwards.
+	 */
+	while (world_switch->manual.vt_heap_size) {
+		entry = world_switch->manual.vt_heap[0];
+		if (!amdgv_sched_vt_skip(adapt, entry))
+			break;
+		skipped[num_skipped++] = entry;
+		amdgv_sched_vt_dequeue(world_switch, entry);
+		entry = NULL;
+	}
+
+	for (i = 0; i < num_skipped; i++)
+		amdgv_sched_vt_heap_push(world_switch, skipped[i]);
+
+	if (entry == NULL)
+		return AMDGV_FAILURE;
+
+	if (entry->vtime > world_switch->manual.vt_clock)
+		world_switch->manual.vt_clock = entry->vtime;
+	world_switch->manual.vt_last = entry;
+
+	*vf_idx = entry->idx_vf;
+	*ts = entry->time_slice;
+
+	return 0;
+}
+
+amdgv_sched_policy_func amdgv_sched_policy_select(struct amdgv_adapter *adapt,
+						  enum amdgv_sched_mode sched_mode)
+{
+	if (sched_mode == AMDGV_SCHED_HYBRID_LIQUID_MODE) {
+		AMDGV_INFO("hybrid liquid mode enabled\n");
+		return amdgv_schedule_vfs_liquid;
+	}
+
+	if (sched_mode == AMDGV_SCHED_VIRTUAL_TIME_MODE) {
+		AMDGV_INFO("virtual time mode enabled\n");
+		return amdgv_schedule_vfs_vtime;
+	}
+
+	return amdgv_schedule_vfs_default;
+}
@@ -80,7 +80,8 @@ static int amdgv_sched_vf_flr(struct amdgv_adapter *adapt, uint32_t idx_vf,
 		adapt->array_vf[idx_vf].ready_to_reset = false;
 		ret = amdgv_wait_for(adapt, amdgv_wait_guest_reset_ready_cb,
 				     (void *)&adapt->array_vf[idx_vf].ready_to_reset,
-				     AMDGV_TIMEOUT(TIMEOUT_GUEST_IDH_RESP), 0);
+				     AMDGV_TIMEOUT(TIMEOUT_GUEST_IDH_RESP),
+				     AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_GUEST_RESET));
 	}
 
 	ret = amdgv_reset_vf_flr(adapt, idx_vf);
@@ -195,7 +196,8 @@ static int amdgv_sched_whole_gpu_reset(struct amdgv_adapter *adapt)
 		/* it's safer to wait guest to response,
 			but no matter it responsed or not, we need to go on reset */
 		amdgv_wait_for(adapt, amdgv_wait_all_guest_reset_ready_cb, (void *)adapt,
-				AMDGV_TIMEOUT(TIMEOUT_GUEST_IDH_RESP_GPU_RESET), 0);
+				AMDGV_TIMEOUT(TIMEOUT_GUEST_IDH_RESP_GPU_RESET),
+				AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_GUEST_RESET));
 	}
 
 	amdgv_sched_world_context_clear_state_rst(adapt);
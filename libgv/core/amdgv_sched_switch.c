@@ -30,12 +30,8 @@
 
 static const uint32_t this_block = AMDGV_SCHEDULER_BLOCK;
 
-int (*amdgv_schedule_vfs) (struct amdgv_sched_world_switch *world_switch,
-			struct amdgv_list_head *active_list,
-			int *vf_idx, uint64_t *ts);
+amdgv_sched_policy_func amdgv_schedule_vfs;
 
-#define MAX_VF_SKIP_CNT (8)
-#define HLIQUID_ALL_VF_IDLE_MIN_TS (500)
 /**********************************************************************
  * Helper functions
  **********************************************************************/
@@ -96,7 +92,6 @@ static void amdgv_sched_stop_record_vf_time(struct amdgv_adapter *adapt,
 	struct amdgv_sched_active_vf_entry *entry;
 	struct amdgv_time_log *time_log;
 	struct amdgv_histogram *run_summation_us;
-	int64_t duration;
 	uint32_t hw_sched_id;
 	uint64_t active_time, time_max, bucket, start, interval, curr_ts = oss_get_time_stamp();
 
@@ -135,16 +130,7 @@ static void amdgv_sched_stop_record_vf_time(struct amdgv_adapter *adapt,
 		}
 
 		// update world switch time credit
-		entry->total_time += curr_ts - entry->start_ts;
-		duration = curr_ts - (entry->start_ts + entry->last_time_slice);
-		if (duration > 0) {
-			/* No Punishment under BP Mode */
-			if (entry->skip_next_punish || adapt->bp_mode != AMDGV_BP_MODE_DISABLE)
-				entry->skip_next_punish = false;
-			else
-				entry->beyond_time_cycle += duration;
-		}
-		entry->start_ts = 0;
+		amdgv_sched_policy_account(adapt, entry, curr_ts);
 	}
 	if (!entry->dummy_vf)
 		amdgv_gpumon_update_save_end_time(adapt, idx_vf, world_switch);
@@ -275,190 +261,6 @@ static int amdgv_switch_world_context(struct amdgv_adapter *adapt, uint32_t idx_
 	return ret;
 }
 
-int64_t
-amdgv_sched_world_switch_calculate_time_slice(struct amdgv_adapter *adapt,
-						  struct amdgv_sched_world_switch *world_switch,
-						  uint32_t idx_vf)
-{
-	struct amdgv_sched_active_vf_entry *entry;
-	int64_t time_slice;
-	int64_t min_time_slice;
-	bool dummy;
-
-	AMDGV_ASSERT(world_switch->sched_block < AMDGV_SCHED_BLOCK_MAX);
-
-	entry = &world_switch->manual.array_vf[idx_vf];
-
-	/* save the dummy and time_slice from the current entry.
-	 * If we are processing a dummy VF. Calculate the
-	 * timeslice based on the world-switch overhead to the PF
-	 */
-	dummy = entry->dummy_vf;
-	time_slice = entry->time_slice;
-	min_time_slice = entry->time_slice / 2;
-
-	if (dummy)
-		entry = &world_switch->manual.array_vf[AMDGV_PF_IDX];
-
-	if (world_switch->manual.fairness_mode) {
-		/* If a VF is given single VF status, check if self-switch
-		 * is enabled. If it is, reschedule the VF every 500ms, if not
-		 * do not re-schedule the world-switch timer
-		 */
-		if (entry->time_slice == DEFAULT_GFX_TIME_SLICE_1VF) {
-			/* Beyond time cycle is ignored in single VF mode */
-			entry->beyond_time_cycle = 0;
-			entry->last_time_slice =
-				GET_GFX_TIME_SLICE(adapt, adapt->sched.num_vf_per_gfx_sched);
-
-			goto out;
-		}
-
-		time_slice -= entry->beyond_time_cycle;
-
-		/* If beyond_time_cycle overruns time_slice,
-		 * will return 0 to skip scheduling it.
-		 * And if it gets a time_slice smaller than min_time_slice,
-		 * it can to be scheduled with min_time_slice,
-		 * but the credit of delta will be updated to beyond_time_cycle.
-		 */
-		if (time_slice <= 0) {
-			entry->last_time_slice = 0;
-			entry->beyond_time_cycle -= entry->time_slice;
-			AMDGV_DEBUG("skip scheduling %s\n", amdgv_idx_to_str(entry->idx_vf));
-		} else {
-			if (time_slice <= min_time_slice) {
-				entry->last_time_slice = min_time_slice;
-				entry->beyond_time_cycle = (min_time_slice - time_slice);
-				AMDGV_DEBUG("punish %s %dus\n",
-						amdgv_idx_to_str(entry->idx_vf),
-						entry->time_slice - min_time_slice);
-			} else {
-				entry->last_time_slice = time_slice;
-				entry->beyond_time_cycle = 0;
-				AMDGV_DEBUG("punish %s %dus\n",
-						amdgv_idx_to_str(entry->idx_vf),
-						entry->time_slice - time_slice);
-			}
-		}
-		/* For dummy VF, we only care about the cumulated overhead
-		 * on the last world-switch, we need to give a bit more of leeway
-		 * to the PF time slice.
-		 */
-		if (dummy)
-			entry->beyond_time_cycle = 0;
-	} else {
-		entry->last_time_slice = entry->time_slice;
-	}
-out:
-	return entry->last_time_slice;
-}
-
-static int amdgv_schedule_vfs_default (struct amdgv_sched_world_switch *world_switch,
-				struct amdgv_list_head *active_list, int *vf_idx, uint64_t *ts)
-{
-
-	struct amdgv_sched_active_vf_entry *entry;
-	struct amdgv_adapter *adapt = world_switch->manual.adapt;
-
-re_schedule:
-	entry = amdgv_list_first_entry(active_list,
-					   struct amdgv_sched_active_vf_entry, list);
-	/* pf may be set to suspend but yet removed
-	 * from world switch, so dont schedual pf here
-	 * since it is going to be removed
-	 */
-	if ((entry->idx_vf == AMDGV_PF_IDX) &&
-		 (!is_active_vf(AMDGV_PF_IDX))) {
-		amdgv_list_move_tail(&entry->list, active_list);
-		entry = amdgv_list_first_entry(active_list, struct amdgv_sched_active_vf_entry, list);
-	}
-
-	*vf_idx = entry->idx_vf;
-	*ts = amdgv_sched_world_switch_calculate_time_slice(adapt, world_switch,
-								   entry->idx_vf);
-
-	if (*ts == 0) {
-		AMDGV_DEBUG("skip scheduling %s\n", amdgv_idx_to_str(entry->idx_vf));
-		amdgv_list_move_tail(&entry->list, &world_switch->manual.active_vf_list);
-
-		goto re_schedule;
-	}
-
-	if (world_switch->manual.fairness_mode && entry->dummy_vf) {
-		AMDGV_DEBUG("load dummy %s, time slice = %d\n",
-				amdgv_idx_to_str(entry->idx_vf), *ts);
-		amdgv_list_move_tail(&entry->list, &world_switch->manual.active_vf_list);
-		*vf_idx = AMDGV_PF_IDX;
-	}
-
-	return 0;
-}
-static int amdgv_schedule_vfs_liquid (struct amdgv_sched_world_switch *world_switch,
-				struct amdgv_list_head *active_list, int *vf_idx, uint64_t *ts)
-{
-	uint32_t vf_status = 0;
-	struct amdgv_sched_active_vf_entry *entry;
-	struct amdgv_adapter *adapt = world_switch->manual.adapt;
-
-	/* Hybrid liquid mode busy status has 2 parts
-	 * 1. vf_busy_status got from HW
-	 * 2. the current VF timeout
-	 */
-	vf_status = (world_switch->vf_busy_status | world_switch->vf_timeout) &
-			 world_switch->vf_inited;
-
-	/* Only hybrid liquid mode update the vf_status, otherwise vf_status = 0
-	 *
-	 * The first busy VF in the list is priority to get the GPU.
-	 * when this VF was switched out, it will be moved to list tail.
-	 *
-	 * If all VF is idle, run the VF one by one.
-	 */
-
-	entry = amdgv_list_first_entry(active_list,
-					   struct amdgv_sched_active_vf_entry, list);
-	if ((entry->idx_vf == AMDGV_PF_IDX) &&
-		 (!is_active_vf(AMDGV_PF_IDX))) {
-		amdgv_list_move_tail(&entry->list, active_list);
-	}
-
-	if (!vf_status)
-		entry = amdgv_list_first_entry(active_list,
-					   struct amdgv_sched_active_vf_entry, list);
-	else
-		amdgv_list_for_each_entry (entry, active_list,
-				   struct amdgv_sched_active_vf_entry, list) {
-			if (vf_status & (1 << entry->idx_vf))
-				break;
-
-			if (entry == amdgv_list_last_entry(active_list,
-					struct amdgv_sched_active_vf_entry, list)) {
-				AMDGV_DEBUG("Failed to get a valid VF, run the first VF in the list\n");
-				entry = amdgv_list_first_entry(active_list,
-						   struct amdgv_sched_active_vf_entry, list);
-
-				break;
-			}
-
-			if ((entry->idx_vf == AMDGV_PF_IDX) &&
-				(!is_active_vf(AMDGV_PF_IDX)))
-				continue;
-
-			if (entry->skip_cnt >= MAX_VF_SKIP_CNT)
-				break;
-
-			entry->skip_cnt++;
-		}
-
-	entry->skip_cnt = 0;
-
-	*vf_idx = entry->idx_vf;
-	*ts = entry->time_slice;
-
-	return 0;
-}
-
 /**********************************************************************
  * World switch manual functions
  **********************************************************************/
@@ -703,6 +505,7 @@ static int amdgv_sched_manual_switch_add_vf(struct amdgv_adapter *adapt,
 
 	/* add new vf to the tail of active vf list */
 	amdgv_list_add_tail(&entry->list, &world_switch->manual.active_vf_list);
+	amdgv_sched_vt_enqueue(world_switch, entry);
 
 out:
 	for_each_id(hw_sched_id, world_switch->hw_sched_mask)
@@ -761,6 +564,7 @@ static int amdgv_sched_manual_switch_remove_vf(struct amdgv_adapter *adapt,
 			amdgv_idx_to_str(idx_vf), world_switch->sched_block);
 
 	amdgv_list_del(&entry->list);
+	amdgv_sched_vt_dequeue(world_switch, entry);
 
 	world_switch->vf_inited &= ~(1 << idx_vf);
 
@@ -833,8 +637,14 @@ static int amdgv_sched_manual_switch_init(struct amdgv_adapter *adapt,
 	AMDGV_INIT_LIST_HEAD(&world_switch->manual.active_vf_list);
 	world_switch->manual.adapt = adapt;
 
-	for (i = 0; i < AMDGV_MAX_VF_SLOT; i++)
+	for (i = 0; i < AMDGV_MAX_VF_SLOT; i++) {
 		world_switch->manual.array_vf[i].idx_vf = AMDGV_INVALID_IDX_VF;
+		world_switch->manual.array_vf[i].vtime = 0;
+		world_switch->manual.array_vf[i].vt_heap_pos = AMDGV_SCHED_VT_NOT_QUEUED;
+	}
+	world_switch->manual.vt_heap_size = 0;
+	world_switch->manual.vt_clock = 0;
+	world_switch->manual.vt_last = NULL;
 
 	if (sched_mode != AMDGV_SCHED_FAIRNESS) {
 		world_switch->manual.fairness_mode = false;
@@ -891,12 +701,7 @@ static int amdgv_sched_manual_switch_init(struct amdgv_adapter *adapt,
 
 	world_switch->manual.self_switch_trigger = false;
 
-	if (world_switch->sched_mode == AMDGV_SCHED_HYBRID_LIQUID_MODE) {
-		AMDGV_INFO("hybrid liquid mode enabled\n");
-		amdgv_schedule_vfs = amdgv_schedule_vfs_liquid;
-	}
-	else
-		amdgv_schedule_vfs = amdgv_schedule_vfs_default;
+	amdgv_schedule_vfs = amdgv_sched_policy_select(adapt, world_switch->sched_mode);
 
 	world_switch->manual.switch_thread =
 		oss_create_thread(amdgv_sched_manual_switch_work_thread, (void *)world_switch,
@@ -947,6 +752,7 @@ static void amdgv_sched_manual_switch_fini(struct amdgv_adapter *adapt,
 			continue;
 
 		amdgv_list_del(&entry->list);
+		amdgv_sched_vt_dequeue(world_switch, entry);
 		entry->idx_vf = AMDGV_INVALID_IDX_VF;
 	}
 
@@ -117,7 +117,6 @@ static bool amdgv_umc_is_dup_record(struct amdgv_adapter *adapt,
 {
 	struct ras_err_handler_data *data = adapt->ecc.eh_data;
 	uint64_t pa_pfn;
-	int i;
 
 	if (from_eeprom) {
 		if (adapt->umc.funcs && adapt->umc.funcs->eeprom_record_to_soc_pa) {
@@ -127,12 +126,7 @@ static bool amdgv_umc_is_dup_record(struct amdgv_adapter *adapt,
 		return false;
 	}
 
-	for (i = 0; i < data->rom_data.count; i++) {
-		if (data->rom_data.bps[i].retired_page == record->retired_page)
-			return true;
-	}
-
-	return false;
+	return amdgv_umc_bp_index_contains(&data->rom_index, record->retired_page);
 }
 
 /* Cache the raw data loaded from eeprom and newly detected data
@@ -151,6 +145,12 @@ static int amdgv_umc_update_eeprom_rom_data(struct amdgv_adapter *adapt,
 		return AMDGV_FAILURE;
 	}
 
+	if (amdgv_umc_bp_index_insert(&adapt->ecc.eh_data->rom_index, bps->retired_page,
+				      (uint32_t)data->count)) {
+		AMDGV_ERROR("Failed to index eeprom rom bad page!\n");
+		return AMDGV_FAILURE;
+	}
+
 	oss_memcpy(&data->bps[data->count], bps, sizeof(struct eeprom_table_record));
 	data->count++;
 
@@ -188,6 +188,11 @@ static int amdgv_umc_update_eeprom_ram_data(struct amdgv_adapter *adapt,
 	for (j = 0; j < count; j++) {
 		if (expand_to_pages)
 			bps->retired_page = page_pfn[j];
+		if (amdgv_umc_bp_index_insert(&data->index, bps->retired_page,
+					      (uint32_t)data->count)) {
+			AMDGV_ERROR("Failed to index eeprom ram bad page!\n");
+			return AMDGV_FAILURE;
+		}
 		oss_memcpy(&data->bps[data->count], bps, sizeof(struct eeprom_table_record));
 		data->count++;
 	}
@@ -357,6 +362,7 @@ int amdgv_umc_reload_bp_from_rom(struct amdgv_adapter *adapt)
 	 * actual used after reload.
 	 */
 	eh_data->count = 0;
+	amdgv_umc_bp_index_reset(&eh_data->index);
 	eh_data->last_retired_pfn = AMDGV_RAS_INV_MEM_PFN;
 	amdgv_vfmgr_clean_bp_block_size(adapt);
 
@@ -381,7 +387,6 @@ int amdgv_umc_reload_bp_from_rom(struct amdgv_adapter *adapt)
 bool amdgv_umc_check_bad_page(struct amdgv_adapter *adapt, uint64_t addr)
 {
 	struct ras_err_handler_data *data = adapt->ecc.eh_data;
-	int i;
 	bool ret = false;
 	uint64_t page_addr;
 
@@ -390,12 +395,10 @@ bool amdgv_umc_check_bad_page(struct amdgv_adapter *adapt, uint64_t addr)
 		goto out;
 
 	page_addr = addr >> AMDGV_GPU_PAGE_SHIFT;
-	for (i = 0; i < data->count; i++)
-		if (page_addr == data->bps[i].retired_page) {
-			AMDGV_ERROR("Address (0x%llx) found in an EEPROM entry as a retired page!\n", addr);
-			ret = true;
-			goto out;
-		}
+	if (amdgv_umc_bp_index_contains(&data->index, page_addr)) {
+		AMDGV_ERROR("Address (0x%llx) found in an EEPROM entry as a retired page!\n", addr);
+		ret = true;
+	}
 
 out:
 	oss_mutex_unlock(adapt->ecc.recovery_lock);
@@ -573,8 +576,8 @@ static bool amdgv_umc_check_bp_in_same_mem_row(struct amdgv_adapter *adapt,
 					       uint64_t err_addr_new)
 {
 	struct ras_err_handler_data *data = adapt->ecc.eh_data;
-	uint64_t err_addr, mem_row_idx;
-	int i;
+	const uint64_t row_pages = AMDGV_GPU_MEM_ROW_SIZE >> AMDGV_GPU_PAGE_SHIFT;
+	uint64_t mem_row_idx;
 	bool ret = false;
 
 	if (adapt->ecc.bad_page_detection_mode & (1 << AMDGV_RAS_ECC_FLAG_IGNORE_RMA))
@@ -583,12 +586,12 @@ static bool amdgv_umc_check_bp_in_same_mem_row(struct amdgv_adapter *adapt,
 	if (adapt->ecc.skip_row_rma)
 		return ret;
 
+	/* only pages reserved so far count, later ones are not checked yet */
 	mem_row_idx = err_addr_new / AMDGV_GPU_MEM_ROW_SIZE;
-	for (i = 0; i < data->last_reserved; i++) {
-		err_addr = data->bps[i].retired_page << AMDGV_GPU_PAGE_SHIFT;
-		if (mem_row_idx == (err_addr / AMDGV_GPU_MEM_ROW_SIZE))
-			ret = true;
-	}
+	if (amdgv_umc_bp_index_first_in_range(&data->index, mem_row_idx * row_pages,
+					      (mem_row_idx + 1) * row_pages) <
+	    (uint32_t)data->last_reserved)
+		ret = true;
 
 	if (ret) {
 		adapt->bp_msg_type = AMDGV_BP_MSG_IN_SAME_ROW;
@@ -812,6 +815,10 @@ int amdgv_umc_recovery_sw_init(struct amdgv_adapter *adapt)
 	if (!(*data)->bps || !(*data)->bps_mem)
 		goto error;
 
+	if (amdgv_umc_bp_index_init(&(*data)->rom_index, (*data)->rom_data.bps_cap) ||
+	    amdgv_umc_bp_index_init(&(*data)->index, (*data)->bps_cap))
+		goto error;
+
 	if (amdgv_ras_eeprom_sw_init(adapt, &(adapt->eeprom_control)))
 		goto error;
 
@@ -925,6 +932,8 @@ int amdgv_umc_recovery_sw_fini(struct amdgv_adapter *adapt)
 			oss_free(data->bps_mem);
 			data->bps_mem = NULL;
 		}
+		amdgv_umc_bp_index_fini(&data->rom_index);
+		amdgv_umc_bp_index_fini(&data->index);
 		oss_free(data);
 		adapt->ecc.eh_data = NULL;
 	}
@@ -1145,11 +1154,14 @@ int amdgv_umc_clean_bad_page_records(struct amdgv_adapter *adapt)
 
 	oss_mutex_lock(adapt->ecc.recovery_lock);
 	adapt->ecc.eh_data->last_retired_pfn = AMDGV_RAS_INV_MEM_PFN;
-	if (data && data->rom_data.bps && data->rom_data.count)
+	if (data && data->rom_data.bps && data->rom_data.count) {
 		data->rom_data.count = 0;
+		amdgv_umc_bp_index_reset(&data->rom_index);
+	}
 
 	if (data && data->count && data->bps && data->bps_mem) {
 		data->count = 0;
+		amdgv_umc_bp_index_reset(&data->index);
 		for (i = data->last_reserved - 1; i >= 0; i--) {
 			mem = data->bps_mem[i];
 			amdgv_memmgr_free(mem);
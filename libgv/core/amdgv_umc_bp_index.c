@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Retired page index for the UMC bad page arrays. Only the oss memory
+ * helpers are used here, so the index can be linked into a userspace
+ * program, see tools/bp_index_bench.
+ */
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_umc_bp_index.h"
+
+/* all ones is AMDGV_RAS_INV_MEM_PFN, never a retired page */
+#define AMDGV_UMC_BP_INDEX_EMPTY   (0xFFFFFFFFFFFFFFFFULL)
+#define AMDGV_UMC_BP_INDEX_MIN_CAP 64
+/* any non zero start for the xorshift treap priorities */
+#define AMDGV_UMC_BP_INDEX_PRIO_SEED 0x2545F491U
+
+static uint32_t amdgv_umc_bp_index_hash(uint64_t pfn, uint32_t slots_cap)
+{
+	/* fibonacci hashing, pages of one row land in different slots */
+	return (uint32_t)((pfn * 0x9E3779B97F4A7C15ULL) >> 32) & (slots_cap - 1);
+}
+
+static uint64_t *amdgv_umc_bp_index_alloc_slots(uint32_t slots_cap)
+{
+	uint64_t *slots;
+
+	slots = oss_malloc(slots_cap * sizeof(*slots));
+	if (slots)
+		oss_memset(slots, 0xFF, slots_cap * sizeof(*slots));
+
+	return slots;
+}
+
+/* returns false if the page is in the set already */
+static bool amdgv_umc_bp_index_slot_add(uint64_t *slots, uint32_t slots_cap, uint64_t pfn)
+{
+	uint32_t i = amdgv_umc_bp_index_hash(pfn, slots_cap);
+
+	while (slots[i] != AMDGV_UMC_BP_INDEX_EMPTY) {
+		if (slots[i] == pfn)
+			return false;
+		i = (i + 1) & (slots_cap - 1);
+	}
+	slots[i] = pfn;
+
+	return true;
+}
+
+/* keep the load factor at 1/2 at most, linear probing degrades above */
+static int amdgv_umc_bp_index_grow(struct amdgv_umc_bp_index *index)
+{
+	struct amdgv_umc_bp_entry *entries;
+	uint64_t *slots;
+	uint32_t slots_cap, cap, i;
+
+	if (index->count == index->cap) {
+		cap = index->cap << 1;
+		entries = oss_zalloc(cap * sizeof(*entries));
+		if (!entries)
+			return AMDGV_FAILURE;
+
+		oss_memcpy(entries, index->entries, index->count * sizeof(*entries));
+		oss_free(index->entries);
+		index->entries = entries;
+		index->cap = cap;
+	}
+
+	if ((index->count + 1) * 2 > index->slots_cap) {
+		slots_cap = index->slots_cap << 1;
+		slots = amdgv_umc_bp_index_alloc_slots(slots_cap);
+		if (!slots)
+			return AMDGV_FAILURE;
+
+		for (i = 0; i < index->count; i++)
+			amdgv_umc_bp_index_slot_add(slots, slots_cap, index->entries[i].pfn);
+		oss_free(index->slots);
+		index->slots = slots;
+		index->slots_cap = slots_cap;
+	}
+
+	return 0;
+}
+
+static uint32_t amdgv_umc_bp_index_next_prio(struct amdgv_umc_bp_index *index)
+{
+	uint32_t x = index->prio_seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	index->prio_seed = x;
+
+	return x;
+}
+
+static uint32_t amdgv_umc_bp_index_min_idx(struct amdgv_umc_bp_index *index, uint32_t t)
+{
+	return t == AMDGV_UMC_BP_INDEX_NONE ? AMDGV_UMC_BP_INDEX_NONE : index->entries[t].min_idx;
+}
+
+static void amdgv_umc_bp_index_update(struct amdgv_umc_bp_index *index, uint32_t t)
+{
+	struct amdgv_umc_bp_entry *e = &index->entries[t];
+	uint32_t min_idx;
+
+	e->size = 1;
+	e->min_idx = e->idx;
+	if (e->left != AMDGV_UMC_BP_INDEX_NONE) {
+		e->size += index->entries[e->left].size;
+		min_idx = index->entries[e->left].min_idx;
+		if (min_idx < e->min_idx)
+			e->min_idx = min_idx;
+	}
+	if (e->right != AMDGV_UMC_BP_INDEX_NONE) {
+		e->size += index->entries[e->right].size;
+		min_idx = index->entries[e->right].min_idx;
+		if (min_idx < e->min_idx)
+			e->min_idx = min_idx;
+	}
+}
+
+/* Split t into pages below pfn (l) and the rest (r) */
+static void amdgv_umc_bp_index_split(struct amdgv_umc_bp_index *index, uint32_t t,
+				     uint64_t pfn, uint32_t *l, uint32_t *r)
+{
+	struct amdgv_umc_bp_entry *e;
+
+	if (t == AMDGV_UMC_BP_INDEX_NONE) {
+		*l = AMDGV_UMC_BP_INDEX_NONE;
+		*r = AMDGV_UMC_BP_INDEX_NONE;
+		return;
+	}
+
+	e = &index->entries[t];
+	if (e->pfn < pfn) {
+		amdgv_umc_bp_index_split(index, e->right, pfn, &e->right, r);
+		*l = t;
+	} else {
+		amdgv_umc_bp_index_split(index, e->left, pfn, l, &e->left);
+		*r = t;
+	}
+	amdgv_umc_bp_index_update(index, t);
+}
+
+/* Join two treaps, every page of l is below every page of r */
+static uint32_t amdgv_umc_bp_index_merge(struct amdgv_umc_bp_index *index, uint32_t l, uint32_t r)
+{
+	if (l == AMDGV_UMC_BP_INDEX_NONE)
+		return r;
+	if (r == AMDGV_UMC_BP_INDEX_NONE)
+		return l;
+
+	if (index->entries[l].prio > index->entries[r].prio) {
+		index->entries[l].right = amdgv_umc_bp_index_merge(index, index->entries[l].right, r);
+		amdgv_umc_bp_index_update(index, l);
+		return l;
+	}
+
+	index->entries[r].left = amdgv_umc_bp_index_merge(index, l, index->entries[r].left);
+	amdgv_umc_bp_index_update(index, r);
+	return r;
+}
+
+/* number of indexed pages below pfn */
+static uint32_t amdgv_umc_bp_index_rank(struct amdgv_umc_bp_index *index, uint64_t pfn)
+{
+	struct amdgv_umc_bp_entry *e;
+	uint32_t t = index->root;
+	uint32_t rank = 0;
+
+	while (t != AMDGV_UMC_BP_INDEX_NONE) {
+		e = &index->entries[t];
+		if (e->pfn < pfn) {
+			rank++;
+			if (e->left != AMDGV_UMC_BP_INDEX_NONE)
+				rank += index->entries[e->left].size;
+			t = e->right;
+		} else {
+			t = e->left;
+		}
+	}
+
+	return rank;
+}
+
+int amdgv_umc_bp_index_init(struct amdgv_umc_bp_index *index, uint32_t cap)
+{
+	uint32_t slots_cap = AMDGV_UMC_BP_INDEX_MIN_CAP;
+
+	if (cap < AMDGV_UMC_BP_INDEX_MIN_CAP)
+		cap = AMDGV_UMC_BP_INDEX_MIN_CAP;
+	while (slots_cap < cap * 2)
+		slots_cap <<= 1;
+
+	index->count = 0;
+	index->root = AMDGV_UMC_BP_INDEX_NONE;
+	index->prio_seed = AMDGV_UMC_BP_INDEX_PRIO_SEED;
+	index->cap = cap;
+	index->slots_cap = slots_cap;
+	index->entries = oss_zalloc(cap * sizeof(*index->entries));
+	index->slots = amdgv_umc_bp_index_alloc_slots(slots_cap);
+	if (!index->entries || !index->slots) {
+		amdgv_umc_bp_index_fini(index);
+		return AMDGV_FAILURE;
+	}
+
+	return 0;
+}
+
+void amdgv_umc_bp_index_fini(struct amdgv_umc_bp_index *index)
+{
+	if (index->entries)
+		oss_free(index->entries);
+	if (index->slots)
+		oss_free(index->slots);
+
+	index->entries = NULL;
+	index->slots = NULL;
+	index->count = 0;
+	index->root = AMDGV_UMC_BP_INDEX_NONE;
+	index->cap = 0;
+	index->slots_cap = 0;
+}
+
+void amdgv_umc_bp_index_reset(struct amdgv_umc_bp_index *index)
+{
+	if (!index->slots)
+		return;
+
+	index->count = 0;
+	index->root = AMDGV_UMC_BP_INDEX_NONE;
+	oss_memset(index->slots, 0xFF, index->slots_cap * sizeof(*index->slots));
+}
+
+/*
+ * add a page recorded at position idx of the bad page array, a page that is
+ * indexed already keeps its first position
+ */
+int amdgv_umc_bp_index_insert(struct amdgv_umc_bp_index *index, uint64_t pfn, uint32_t idx)
+{
+	struct amdgv_umc_bp_entry *e;
+	uint32_t t, l, r;
+
+	if (!index->slots)
+		return AMDGV_FAILURE;
+
+	if (pfn == AMDGV_UMC_BP_INDEX_EMPTY || amdgv_umc_bp_index_contains(index, pfn))
+		return 0;
+
+	if (amdgv_umc_bp_index_grow(index))
+		return AMDGV_FAILURE;
+
+	amdgv_umc_bp_index_slot_add(index->slots, index->slots_cap, pfn);
+
+	t = index->count++;
+	e = &index->entries[t];
+	e->pfn = pfn;
+	e->idx = idx;
+	e->left = AMDGV_UMC_BP_INDEX_NONE;
+	e->right = AMDGV_UMC_BP_INDEX_NONE;
+	e->prio = amdgv_umc_bp_index_next_prio(index);
+	amdgv_umc_bp_index_update(index, t);
+
+	amdgv_umc_bp_index_split(index, index->root, pfn, &l, &r);
+	index->root = amdgv_umc_bp_index_merge(index, amdgv_umc_bp_index_merge(index, l, t), r);
+
+	return 0;
+}
+
+bool amdgv_umc_bp_index_contains(struct amdgv_umc_bp_index *index, uint64_t pfn)
+{
+	uint32_t i;
+
+	if (!index->slots || pfn == AMDGV_UMC_BP_INDEX_EMPTY)
+		return false;
+
+	i = amdgv_umc_bp_index_hash(pfn, index->slots_cap);
+	while (index->slots[i] != AMDGV_UMC_BP_INDEX_EMPTY) {
+		if (index->slots[i] == pfn)
+			return true;
+		i = (i + 1) & (index->slots_cap - 1);
+	}
+
+	return false;
+}
+
+/* lowest array position of a page in [start_pfn, end_pfn) */
+uint32_t amdgv_umc_bp_index_first_in_range(struct amdgv_umc_bp_index *index,
+					   uint64_t start_pfn, uint64_t end_pfn)
+{
+	struct amdgv_umc_bp_entry *e;
+	uint32_t first, min_idx, top, t = index->root;
+
+	/* descend to the topmost page inside the range */
+	while (t != AMDGV_UMC_BP_INDEX_NONE) {
+		e = &index->entries[t];
+		if (e->pfn < start_pfn)
+			t = e->right;
+		else if (e->pfn >= end_pfn)
+			t = e->left;
+		else
+			break;
+	}
+	if (t == AMDGV_UMC_BP_INDEX_NONE)
+		return AMDGV_UMC_BP_INDEX_NONE;
+
+	top = t;
+	first = index->entries[top].idx;
+
+	/* below top every page is under end_pfn, take whole right subtrees */
+	for (t = index->entries[top].left; t != AMDGV_UMC_BP_INDEX_NONE;) {
+		e = &index->entries[t];
+		if (e->pfn < start_pfn) {
+			t = e->right;
+			continue;
+		}
+		min_idx = amdgv_umc_bp_index_min_idx(index, e->right);
+		if (e->idx < first)
+			first = e->idx;
+		if (min_idx < first)
+			first = min_idx;
+		t = e->left;
+	}
+
+	/* above top every page is at or over start_pfn, take whole left subtrees */
+	for (t = index->entries[top].right; t != AMDGV_UMC_BP_INDEX_NONE;) {
+		e = &index->entries[t];
+		if (e->pfn >= end_pfn) {
+			t = e->left;
+			continue;
+		}
+		min_idx = amdgv_umc_bp_index_min_idx(index, e->left);
+		if (e->idx < first)
+			first = e->idx;
+		if (min_idx < first)
+			first = min_idx;
+		t = e->right;
+	}
+
+	return first;
+}
+
+/* number of distinct pages in [start_pfn, end_pfn) */
+uint32_t amdgv_umc_bp_index_count_in_range(struct amdgv_umc_bp_index *index,
+					   uint64_t start_pfn, uint64_t end_pfn)
+{
+	if (start_pfn >= end_pfn)
+		return 0;
+
+	return amdgv_umc_bp_index_rank(index, end_pfn) -
+	       amdgv_umc_bp_index_rank(index, start_pfn);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AMDGV_UMC_BP_INDEX_H
+#define AMDGV_UMC_BP_INDEX_H
+
+#include "amdgv_basetypes.h"
+
+/* returned by amdgv_umc_bp_index_first_in_range() when no page matches */
+#define AMDGV_UMC_BP_INDEX_NONE 0xFFFFFFFF
+
+struct amdgv_umc_bp_entry {
+	uint64_t pfn;
+	/* position of the first record with this page in the bad page array */
+	uint32_t idx;
+	/* smallest idx in the subtree of this entry */
+	uint32_t min_idx;
+	/* treap links, positions in the entry array or AMDGV_UMC_BP_INDEX_NONE */
+	uint32_t left;
+	uint32_t right;
+	uint32_t prio;
+	/* number of entries in the subtree of this entry */
+	uint32_t size;
+};
+
+/* Lookup index over the retired pages of a bad page array.
+ *
+ * slots is an open addressing hash set of the pages for O(1) membership.
+ * entries holds every page once, in insertion order, linked into a treap
+ * ordered by pfn and augmented with subtree sizes and the smallest array
+ * position of each subtree, so insert and the range queries are
+ * O(log n). Both are updated as records are appended to the array, the
+ * array itself stays in append order because the reservation and eeprom
+ * code depend on it.
+ */
+struct amdgv_umc_bp_index {
+	uint64_t *slots;
+	/* number of slots, a power of two */
+	uint32_t slots_cap;
+
+	struct amdgv_umc_bp_entry *entries;
+	uint32_t cap;
+	/* number of distinct pages */
+	uint32_t count;
+	uint32_t root;
+	uint32_t prio_seed;
+};
+
+int  amdgv_umc_bp_index_init(struct amdgv_umc_bp_index *index, uint32_t cap);
+void amdgv_umc_bp_index_fini(struct amdgv_umc_bp_index *index);
+void amdgv_umc_bp_index_reset(struct amdgv_umc_bp_index *index);
+
+int  amdgv_umc_bp_index_insert(struct amdgv_umc_bp_index *index, uint64_t pfn, uint32_t idx);
+bool amdgv_umc_bp_index_contains(struct amdgv_umc_bp_index *index, uint64_t pfn);
+uint32_t amdgv_umc_bp_index_first_in_range(struct amdgv_umc_bp_index *index,
+					   uint64_t start_pfn, uint64_t end_pfn);
+uint32_t amdgv_umc_bp_index_count_in_range(struct amdgv_umc_bp_index *index,
+					   uint64_t start_pfn, uint64_t end_pfn);
+
+#endif // AMDGV_UMC_BP_INDEX_H
@@ -1252,7 +1252,7 @@ int amdgv_vfmgr_dump_cpers(struct amdgv_adapter *adapt, uint32_t idx_vf, uint64_
 	struct cper_hdr *cper_hdr = NULL;
 	struct amdgv_vf_ras *vf_ras = &adapt->array_vf[idx_vf].ras;
 	uint64_t rptr = vf_ras->cper.start_rptr + vf_rptr;
-	uint64_t wptr = adapt->cper.wptr;
+	uint64_t wptr;
 	uint64_t buf_offset =  offsetof(struct amdsriov_ras_telemetry, body.cper_dump) +
 			       offsetof(struct amd_sriov_ras_cper_dump, buf);
 	uint64_t fb_offset = KBYTES_TO_BYTES(AMD_SRIOV_MSG_RAS_TELEMETRY_OFFSET_KB) +
@@ -1262,6 +1262,13 @@ int amdgv_vfmgr_dump_cpers(struct amdgv_adapter *adapt, uint32_t idx_vf, uint64_
 	if (adapt->mca.vf_policy == AMDGV_RAS_VF_TELEMETRY_DISABLE)
 		return AMDGV_FAILURE;
 
+	if (!adapt->cper.enabled)
+		return AMDGV_FAILURE;
+
+	/* Records are patched in place while copied out, keep writers away */
+	oss_mutex_lock(adapt->cper.lock);
+	wptr = adapt->cper.wptr;
+
 	/* sanitize VF rptr & calculate overflow */
 	if (rptr > wptr) {
 		rptr = wptr;
@@ -1295,6 +1302,8 @@ int amdgv_vfmgr_dump_cpers(struct amdgv_adapter *adapt, uint32_t idx_vf, uint64_
 		cper_dump.count++;
 	}
 
+	oss_mutex_unlock(adapt->cper.lock);
+
 	if (rptr != wptr) {
 		cper_dump.more = true;
 	}
@@ -1332,6 +1341,7 @@ int amdgv_vfmgr_dump_cpers(struct amdgv_adapter *adapt, uint32_t idx_vf, uint64_
 
 	return ret;
 fail:
+	oss_mutex_unlock(adapt->cper.lock);
 	return AMDGV_FAILURE;
 }
 
@@ -189,7 +189,7 @@ int mi300_gfx_wait_for_grbm(struct amdgv_adapter *adapt, uint16_t idx_vf)
 			GRBM_STATUS2__EA_BUSY_MASK | GRBM_STATUS2__EA_LINK_BUSY_MASK |
 				GRBM_STATUS2__RLC_BUSY_MASK,
 			0, AMDGV_TIMEOUT(TIMEOUT_GRBM_STATUS), AMDGV_WAIT_CHECK_EQ,
-			AMDGV_WAIT_FLAG_FORCE_YIELD);
+			AMDGV_WAIT_FLAG_FORCE_YIELD | AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_GFX_STATUS));
 
 		grbm_status = RREG32(SOC15_REG_OFFSET(GC, GET_INST(GC, xcc_id), regGRBM_STATUS));
 		grbm_status2 = RREG32(SOC15_REG_OFFSET(GC, GET_INST(GC, xcc_id), regGRBM_STATUS2));
@@ -273,7 +273,8 @@ int mi300_gfx_wait_rlc_idle(struct amdgv_adapter *adapt, uint16_t phys_xcc_id)
 	wait_ret =
 		amdgv_wait_for_register(adapt, SOC15_REG_OFFSET(GC, phys_xcc_id, regRLC_STAT),
 					0, 0, AMDGV_TIMEOUT(TIMEOUT_STATUS_REG),
-					AMDGV_WAIT_CHECK_EQ, AMDGV_WAIT_FLAG_FORCE_YIELD);
+					AMDGV_WAIT_CHECK_EQ, AMDGV_WAIT_FLAG_FORCE_YIELD |
+					AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_GFX_STATUS));
 
 	if (wait_ret) {
 		AMDGV_ERROR("Wait for RLC idle failed\n");
@@ -38,7 +38,8 @@ static const int this_block = AMDGV_COMMUNICATION_BLOCK;
 #define CSA_SIZE_PER_VF 1
 #define UNIT_256KB	(1 << 18)
 #define MI300_MAX_XCD_NUM	8
-#define MI300_SUPPORTED_GFX_SCHED_MODE ((1 << AMDGV_SCHED_FAIRNESS) | (1 << AMDGV_SCHED_ROUND_ROBIN))
+#define MI300_SUPPORTED_GFX_SCHED_MODE ((1 << AMDGV_SCHED_FAIRNESS) | (1 << AMDGV_SCHED_ROUND_ROBIN) | \
+	(1 << AMDGV_SCHED_VIRTUAL_TIME_MODE))
 
 static struct amdgv_gpuiov_hw_sched_static_config mi300_hw_sched_static_config[] = {
 
@@ -186,7 +186,8 @@ static int mi300_cp_dma_copy(struct amdgv_adapter *adapt, uint32_t idx_vf, bool
 		for_each_id (xcc_id, amdgv_sched_get_xcc_mask_by_vf(adapt, idx_vf)) {
 			ctx.adapt = adapt;
 			ctx.xcc_id = xcc_id;
-			wait_ret = amdgv_wait_for(adapt, mi300_wait_for_cp_dma_pio_cb, (void *)&ctx, AMDGV_TIMEOUT(TIMEOUT_CP_DMA), 0);
+			wait_ret = amdgv_wait_for(adapt, mi300_wait_for_cp_dma_pio_cb, (void *)&ctx, AMDGV_TIMEOUT(TIMEOUT_CP_DMA),
+						  AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_CP_DMA));
 
 			if (!wait_ret) {
 				WREG32(SOC15_REG_OFFSET(GC, GET_INST(GC, xcc_id), regCP_DMA_PIO_CONTROL), dma_cntl);
@@ -243,7 +244,8 @@ static int mi300_cp_dma_copy(struct amdgv_adapter *adapt, uint32_t idx_vf, bool
 	for_each_id (xcc_id, amdgv_sched_get_xcc_mask_by_vf(adapt, idx_vf)) {
 		wait_ret = amdgv_wait_for_register(adapt, SOC15_REG_OFFSET(GC, GET_INST(GC, xcc_id), regCP_STAT),
 						dma_busy_flag, 0, AMDGV_TIMEOUT(TIMEOUT_CP_DMA),
-						AMDGV_WAIT_CHECK_EQ, 0);
+						AMDGV_WAIT_CHECK_EQ,
+						AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_CP_DMA));
 
 		if (!wait_ret)
 			continue;
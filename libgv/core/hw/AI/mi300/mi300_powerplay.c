@@ -137,7 +137,8 @@ static int mi300_smu_wait_for_response(struct amdgv_adapter *adapt, uint32_t *va
 
 	ret = amdgv_wait_for_register(adapt, SOC15_REG_OFFSET(MP1, 0, regMP1_SMN_C2PMSG_90),
 				      MP1_SMN_C2PMSG_90__CONTENT_MASK, 0,
-				      AMDGV_TIMEOUT(TIMEOUT_SMU_REG), AMDGV_WAIT_CHECK_NE, 0);
+				      AMDGV_TIMEOUT(TIMEOUT_SMU_REG), AMDGV_WAIT_CHECK_NE,
+				      AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_SMU_REG));
 
 	tmp = RREG32(SOC15_REG_OFFSET(MP1, 0, regMP1_SMN_C2PMSG_90));
 	if (val)
@@ -980,6 +981,13 @@ static int mi300_smu_sw_init(struct amdgv_adapter *adapt)
 		return AMDGV_FAILURE;
 	}
 
+	adapt->pp.table_cache.lock = oss_mutex_init();
+	if (adapt->pp.table_cache.lock == OSS_INVALID_HANDLE) {
+		amdgv_put_error(AMDGV_PF_IDX, AMDGV_ERROR_DRIVER_CREATE_MUTEX_FAIL, 0);
+		return AMDGV_FAILURE;
+	}
+	adapt->pp.table_cache.max_age_us = AMDGV_PP_METRICS_TABLE_MAX_AGE_US;
+
 	return 0;
 }
 
@@ -1001,6 +1009,11 @@ static int mi300_smu_sw_fini(struct amdgv_adapter *adapt)
 		adapt->pp.smu_lock = OSS_INVALID_HANDLE;
 	}
 
+	if (adapt->pp.table_cache.lock != OSS_INVALID_HANDLE) {
+		oss_mutex_fini(adapt->pp.table_cache.lock);
+		adapt->pp.table_cache.lock = OSS_INVALID_HANDLE;
+	}
+
 	return 0;
 }
 
@@ -1046,7 +1059,7 @@ int mi300_smu_get_metrics_version(struct amdgv_adapter *adapt, uint32_t *version
 	return mi300_smu_send_msg(adapt, PPSMC_MSG_GetMetricsVersion, version);
 }
 
-static int mi300_smu_get_metrics_table(struct amdgv_adapter *adapt)
+static int mi300_smu_fetch_metrics_table(struct amdgv_adapter *adapt)
 {
 	struct smu_context *smu = adapt_to_smu(adapt);
 	struct mi300_smu_table_context *table_context =
@@ -1068,6 +1081,55 @@ static int mi300_smu_get_metrics_table(struct amdgv_adapter *adapt)
 	return ret;
 }
 
+/* Metrics table for gpumon readers. It is served from adapt->pp.table_cache
+ * while younger than max_age_us; readers that find it stale queue on the
+ * cache lock and share the refetch done by the first of them.
+ *
+ * On success this returns with the cache lock held, so that no refetch
+ * rewrites table_context->metrics_table under the caller. Copy what is
+ * needed, then drop the lock with mi300_smu_put_metrics_table().
+ */
+static int mi300_smu_get_metrics_table(struct amdgv_adapter *adapt)
+{
+	struct smu_context *smu = adapt_to_smu(adapt);
+	struct mi300_smu_table_context *table_context =
+		(struct mi300_smu_table_context *)smu->smu_table_context;
+	MetricsTable_t *metrics = (MetricsTable_t *)table_context->metrics_table;
+	struct amdgv_pp_table_cache *cache = &adapt->pp.table_cache;
+	uint64_t now;
+	int ret;
+
+	oss_mutex_lock(cache->lock);
+
+	now = oss_get_time_stamp();
+	if (cache->valid && now - cache->tstamp < cache->max_age_us) {
+		cache->hit++;
+		return 0;
+	}
+
+	cache->miss++;
+	ret = mi300_smu_fetch_metrics_table(adapt);
+	if (ret) {
+		cache->valid = false;
+		oss_mutex_unlock(cache->lock);
+		return ret;
+	}
+
+	if (cache->valid && metrics->AccumulationCounter == cache->version)
+		cache->unchanged++;
+
+	cache->version = metrics->AccumulationCounter;
+	cache->tstamp = now;
+	cache->valid = true;
+
+	return 0;
+}
+
+static void mi300_smu_put_metrics_table(struct amdgv_adapter *adapt)
+{
+	oss_mutex_unlock(adapt->pp.table_cache.lock);
+}
+
 static int mi300_smu_set_table_address(struct amdgv_adapter *adapt)
 {
 	struct smu_context *smu = adapt_to_smu(adapt);
@@ -1279,7 +1341,7 @@ static int mi300_smu_init_pptable(struct amdgv_adapter *adapt)
 	 * message to pmfw, add following check to avoid driver a empty data.
 	 * */
 	while (retry--) {
-		ret = mi300_smu_get_metrics_table(adapt);
+		ret = mi300_smu_fetch_metrics_table(adapt);
 		if (ret)
 			return ret;
 
@@ -1522,7 +1584,7 @@ static int mi300_smu_set_default_dpm_table(struct amdgv_adapter *adapt)
 	MetricsTable_t *metrics = (MetricsTable_t *)table_context->metrics_table;
 	int clk_type, ret;
 
-	ret = mi300_smu_get_metrics_table(adapt);
+	ret = mi300_smu_fetch_metrics_table(adapt);
 	if (ret)
 		return ret;
 
@@ -2004,6 +2066,11 @@ static int mi300_smu_hw_init(struct amdgv_adapter *adapt)
 {
 	int ret;
 
+	/* the table cached before a reset is not worth serving */
+	oss_mutex_lock(adapt->pp.table_cache.lock);
+	adapt->pp.table_cache.valid = false;
+	oss_mutex_unlock(adapt->pp.table_cache.lock);
+
 	ret = mi300_smu_check_fw_status(adapt);
 	if (ret)
 		return ret;
@@ -2259,20 +2326,6 @@ static int mi300_smu_pp_get_pp_metrics(struct amdgv_adapter *adapt,
 	metrics->power_limit = SMUQ10_ROUND(metrics_table->SocketPowerLimit);
 	metrics->energy = SMUQ16_TO_UINT(metrics_table->SocketEnergyAcc);
 
-	ret = mi300_smu_send_msg_with_param(adapt, PPSMC_MSG_ReadThrottlerLimit,
-					    PPSMC_THROTTLING_LIMIT_TYPE_HBM, &val);
-	if (ret)
-		return ret;
-
-	metrics->temp_mem_limit = val;
-
-	ret = mi300_smu_send_msg_with_param(adapt, PPSMC_MSG_ReadThrottlerLimit,
-					    PPSMC_THROTTLING_LIMIT_TYPE_SOCKET, &val);
-	if (ret)
-		return ret;
-
-	metrics->temp_hotspot_limit = val;
-
 	if ((adapt->pp.smu_fw_version >= 0x00556300 && adapt->asic_type == CHIP_MI300X) ||
 		(adapt->asic_type == CHIP_MI308X)) {
 		metrics->pcie_rate = metrics_table->PCIeLinkSpeed;
@@ -2298,6 +2351,22 @@ static int mi300_smu_pp_get_pp_metrics(struct amdgv_adapter *adapt,
 		metrics->pcie_nak_received_count = metrics_table->PCIeNAKReceivedCountAcc;
 	}
 
+	mi300_smu_put_metrics_table(adapt);
+
+	ret = mi300_smu_send_msg_with_param(adapt, PPSMC_MSG_ReadThrottlerLimit,
+					    PPSMC_THROTTLING_LIMIT_TYPE_HBM, &val);
+	if (ret)
+		return ret;
+
+	metrics->temp_mem_limit = val;
+
+	ret = mi300_smu_send_msg_with_param(adapt, PPSMC_MSG_ReadThrottlerLimit,
+					    PPSMC_THROTTLING_LIMIT_TYPE_SOCKET, &val);
+	if (ret)
+		return ret;
+
+	metrics->temp_hotspot_limit = val;
+
 	return 0;
 }
 
@@ -2327,6 +2396,8 @@ static int mi300_smu_pp_is_clock_locked(struct amdgv_adapter *adapt,
 		break;
 	}
 
+	mi300_smu_put_metrics_table(adapt);
+
 	return ret;
 }
 
@@ -2450,14 +2521,13 @@ static int mi300_pp_smu_get_metrics_ext(struct amdgv_adapter *adapt,
 	if (ret)
 		return ret;
 
+	/* the ext metrics point into the table, read them under its lock */
 	ret = mi300_pp_smu_update_drv_metrics_ext(adapt, drv_metrics_ext);
-	if (ret)
-		return ret;
+	if (!ret)
+		ret = mi300_pp_smu_copy_drv_metric_ext_to_user(adapt,
+			drv_metrics_ext, metrics_ext);
 
-	ret = mi300_pp_smu_copy_drv_metric_ext_to_user(adapt,
-		drv_metrics_ext, metrics_ext);
-	if (ret)
-		return ret;
+	mi300_smu_put_metrics_table(adapt);
 
 	return ret;
 }
@@ -2561,13 +2631,13 @@ static int mi300_smu_pp_get_link_metrics(struct amdgv_adapter *adapt,
 	struct amdgv_hive_info *hive;
 	struct amdgv_adapter *tmp_adapt = NULL;
 
-	if (mi300_smu_get_metrics_table(adapt))
-		return AMDGV_FAILURE;
-
 	hive = amdgv_get_xgmi_hive(adapt);
 	if (!hive)
 		return AMDGV_FAILURE;
 
+	if (mi300_smu_get_metrics_table(adapt))
+		return AMDGV_FAILURE;
+
 	psp_link_info = &adapt->xgmi.link_info;
 
 	for (j = 0; j < psp_link_info->num_links; j++) {
@@ -2592,6 +2662,8 @@ static int mi300_smu_pp_get_link_metrics(struct amdgv_adapter *adapt,
 
 	link_metrics->num_links = i;
 
+	mi300_smu_put_metrics_table(adapt);
+
 	return 0;
 }
 
@@ -60,7 +60,8 @@ int mi300_psp_ring_destroy(struct amdgv_adapter *adapt)
 	/* Wait for response flag (bit 31) in C2PMSG_64 */
 	wait_ret = amdgv_wait_for_register(
 		adapt, SOC15_REG_OFFSET(MP0, psp->idx, regMP0_SMN_C2PMSG_64), mask, flag,
-		AMDGV_TIMEOUT(TIMEOUT_PSP_REG), AMDGV_WAIT_CHECK_EQ, 0);
+		AMDGV_TIMEOUT(TIMEOUT_PSP_REG), AMDGV_WAIT_CHECK_EQ,
+		AMDGV_WAIT_FLAG_SITE(AMDGV_WAIT_SITE_PSP_REG));
 
 	if (wait_ret)
 		return AMDGV_FAILURE;
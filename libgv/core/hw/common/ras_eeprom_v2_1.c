@@ -30,6 +30,10 @@
 typedef uint64_t __le64;
 static const uint32_t this_block = AMDGV_MEMORY_BLOCK;
 
+/* enough records to cover one EEPROM page from any record offset */
+#define RAS_EEPROM_V2_1_BATCH_RECS \
+	((EEPROM_PAGE__SIZE_BYTES + EEPROM_TABLE_RECORD_SIZE - 1) / EEPROM_TABLE_RECORD_SIZE)
+
 int ras_eeprom_v2_1_process_records(struct amdgv_adapter *adapt,
 				     struct amdgv_ras_eeprom_control *control,
 				     struct eeprom_table_record *records, bool write, int num);
@@ -92,28 +96,20 @@ static void ras_eeprom_v2_1_decode_extra_info_from_buff(struct amdgv_ras_eeprom_
 	egi_v2_1->ecc_page_threshold = (tmp >> 16) & 0xFFFF;
 }
 
-static int ras_eeprom_v2_1_i2c_transfer_record(struct amdgv_adapter *adapt,
+/* buff holds EEPROM_ADDRESS_SIZE address bytes followed by len bytes of encoded records */
+static int ras_eeprom_v2_1_i2c_transfer_records(struct amdgv_adapter *adapt,
 			struct amdgv_ras_eeprom_control *control,
-			unsigned char *encoded_record, uint32_t encoded_record_len, bool write)
+			unsigned char *buff, uint32_t len, bool write)
 {
-	unsigned char eeprom_buff[EEPROM_ADDRESS_SIZE + EEPROM_TABLE_RECORD_SIZE] = { 0 };
 	struct i2c_msg msg = { 0 };
 	int msg_num = 1;
 
-	/* write record to EEPROM buff */
-	if (write)
-		oss_memcpy(eeprom_buff + EEPROM_ADDRESS_SIZE, encoded_record, encoded_record_len);
-
-	ras_eeprom_v2_1_format_i2c_msg(adapt, control, &msg, eeprom_buff,
-		sizeof(eeprom_buff), control->next_addr, write);
+	ras_eeprom_v2_1_format_i2c_msg(adapt, control, &msg, buff,
+		EEPROM_ADDRESS_SIZE + len, control->next_addr, write);
 
 	if (msg_num != __smu_i2c_transfer(adapt, control, &msg, msg_num))
 		return AMDGV_FAILURE;
 
-	/* read record from EEPROM buff */
-	if (!write)
-		oss_memcpy(encoded_record, eeprom_buff + EEPROM_ADDRESS_SIZE, encoded_record_len);
-
 	return 0;
 }
 
@@ -200,30 +196,30 @@ static uint32_t ras_eeprom_v2_1_calc_recs_byte_sum(struct amdgv_ras_eeprom_contr
 }
 
 static inline uint32_t ras_eeprom_v2_1_calc_tbl_byte_sum(struct amdgv_ras_eeprom_control *control,
-					   struct eeprom_table_record *records, int num)
+					   uint32_t recs_byte_sum)
 {
 	return __calc_hdr_byte_sum(control) +
 		__calc_extra_info_byte_sum(control) +
-		ras_eeprom_v2_1_calc_recs_byte_sum(control, records, num);
+		recs_byte_sum;
 }
 
 /* 	Value chosen so that whole table adds up to 0 */
 static void ras_eeprom_v2_1_update_tbl_checksum(struct amdgv_ras_eeprom_control *control,
-				  struct eeprom_table_record *records, int num,
+				  uint32_t recs_byte_sum,
 				  uint32_t old_hdr_byte_sum, uint32_t old_extra_info_byte_sum)
 {
 	control->tbl_byte_sum -= old_extra_info_byte_sum;
 	control->tbl_byte_sum -= old_hdr_byte_sum;
-	control->tbl_byte_sum += ras_eeprom_v2_1_calc_tbl_byte_sum(control, records, num);
+	control->tbl_byte_sum += ras_eeprom_v2_1_calc_tbl_byte_sum(control, recs_byte_sum);
 
 	control->tbl_hdr.checksum = 256 - (control->tbl_byte_sum % 256);
 }
 
 static void ras_eeprom_v2_1_update_tbl_byte_sum(struct amdgv_adapter *adapt,
 				    struct amdgv_ras_eeprom_control *control,
-				    struct eeprom_table_record *records, int num)
+				    uint32_t recs_byte_sum)
 {
-	control->tbl_byte_sum = ras_eeprom_v2_1_calc_tbl_byte_sum(control, records, num);
+	control->tbl_byte_sum = ras_eeprom_v2_1_calc_tbl_byte_sum(control, recs_byte_sum);
 }
 
 static void ras_eeprom_v2_1_mark_gpu_healthy_status(struct amdgv_adapter *adapt,
@@ -324,7 +320,7 @@ static int ras_eeprom_v2_1_reset_table(struct amdgv_adapter *adapt,
 	control->max_record_num = (EEPROM_SIZE_BYTES - EEPROM_TABLE_HEADER_SIZE -
 			EEPROM_TABLE_TOTAL_EXTRA_INFO_SIZE) / EEPROM_TABLE_RECORD_SIZE;
 
-	ras_eeprom_v2_1_update_tbl_checksum(control, NULL, 0, 0, 0);
+	ras_eeprom_v2_1_update_tbl_checksum(control, 0, 0, 0);
 
 	ret = ras_eeprom_v2_1_write_table_header(adapt, control);
 	/* EEPROM Table Format V1 without extra gpu info */
@@ -414,7 +410,7 @@ static int ras_eeprom_v2_1_init_sw_control(struct amdgv_adapter *adapt, struct a
 static void ras_eeprom_v2_1_reset_read_control(struct amdgv_ras_eeprom_control *control)
 {
 	control->next_addr = EEPROM_RECORD_START_V2_1;
-	control->tbl_byte_sum = ras_eeprom_v2_1_calc_tbl_byte_sum(control, NULL, 0);
+	control->tbl_byte_sum = ras_eeprom_v2_1_calc_tbl_byte_sum(control, 0);
 }
 
 /* Reset EEPROM control write count. Keeping the rest of header the same */
@@ -481,7 +477,8 @@ static int ras_eeprom_v2_1_fix_threshold(struct amdgv_adapter *adapt,
 		ras_eeprom_v2_1_calc_gpu_healthy(adapt);
 	}
 
-	ras_eeprom_v2_1_update_tbl_checksum(control, bp_cache, num_recs,
+	ras_eeprom_v2_1_update_tbl_checksum(control,
+					ras_eeprom_v2_1_calc_recs_byte_sum(control, bp_cache, num_recs),
 					old_hdr_byte_sum,
 					old_extra_info_byte_sum);
 
@@ -539,7 +536,8 @@ static int ras_eeprom_v2_1_fix_header_ext(struct amdgv_adapter *adapt,
 {
 	ras_eeprom_v2_1_reset_read_control(control);
 
-	ras_eeprom_v2_1_update_tbl_checksum(control, bp_cache, num_recs,
+	ras_eeprom_v2_1_update_tbl_checksum(control,
+					ras_eeprom_v2_1_calc_recs_byte_sum(control, bp_cache, num_recs),
 					__calc_hdr_byte_sum(control),
 					__calc_extra_info_byte_sum(control));
 
@@ -758,27 +756,65 @@ static int ras_eeprom_v2_1_entry_overflow(struct amdgv_ras_eeprom_control *contr
 		EEPROM_TABLE_RECORD_SIZE) > control->max_record_num;
 }
 
-static int ras_eeprom_v2_1_process_record(struct amdgv_adapter *adapt,
-			struct amdgv_ras_eeprom_control *control,
-			struct eeprom_table_record *record, bool write)
+/* Records that fit before overflow, mirrors ras_eeprom_v2_1_entry_overflow */
+static int ras_eeprom_v2_1_entry_room(struct amdgv_ras_eeprom_control *control)
 {
-	unsigned char encoded_record[EEPROM_TABLE_RECORD_SIZE] = { 0 };
+	return control->max_record_num + 1 -
+		((control->next_addr - control->tbl_hdr.first_rec_offset) /
+		EEPROM_TABLE_RECORD_SIZE);
+}
+
+/* Contiguous records are coalesced into one I2C message holding every record that
+ * starts in the EEPROM page of the first one. The last record may straddle into the
+ * next page, same as a single record crossing it did, and the SMU splits the
+ * message at page boundaries anyway.
+ */
+static int ras_eeprom_v2_1_batch_len(struct amdgv_ras_eeprom_control *control, int left)
+{
+	int len = ras_eeprom_v2_1_i2c_allowed_xfer_len(control->next_addr);
+	int num = (len + EEPROM_TABLE_RECORD_SIZE - 1) / EEPROM_TABLE_RECORD_SIZE;
+	int room = ras_eeprom_v2_1_entry_room(control);
+
+	num = min(num, room);
+
+	return min(num, left);
+}
 
-	if (write)
-		__encode_table_record_to_buff(control, record, encoded_record);
+static int ras_eeprom_v2_1_process_batch(struct amdgv_adapter *adapt,
+			struct amdgv_ras_eeprom_control *control,
+			struct eeprom_table_record *records, int num, bool write,
+			uint32_t *recs_byte_sum)
+{
+	unsigned char buff[EEPROM_ADDRESS_SIZE +
+			   RAS_EEPROM_V2_1_BATCH_RECS * EEPROM_TABLE_RECORD_SIZE] = { 0 };
+	unsigned char *encoded_records = buff + EEPROM_ADDRESS_SIZE;
+	uint32_t len = num * EEPROM_TABLE_RECORD_SIZE;
+	uint32_t j;
+	int i;
+
+	if (write) {
+		for (i = 0; i < num; i++)
+			__encode_table_record_to_buff(control, &records[i],
+				encoded_records + i * EEPROM_TABLE_RECORD_SIZE);
+	}
 
-	if (ras_eeprom_v2_1_i2c_transfer_record(adapt, control,
-		encoded_record,
-		sizeof(encoded_record), write)) {
-		AMDGV_ERROR("Failed to %s EEPROM table record\n", write ? "write" : "read");
+	if (ras_eeprom_v2_1_i2c_transfer_records(adapt, control, buff, len, write)) {
+		AMDGV_ERROR("Failed to %s EEPROM table records\n", write ? "write" : "read");
 		return AMDGV_FAILURE;
 	}
 
-	if (!write)
-		__decode_table_record_from_buff(control, record, encoded_record);
+	for (i = 0; i < num; i++) {
+		if (!write)
+			__decode_table_record_from_buff(control, &records[i],
+				encoded_records + i * EEPROM_TABLE_RECORD_SIZE);
+
+		control->next_addr += EEPROM_TABLE_RECORD_SIZE;
+		__update_bad_channel_bitmap(adapt, control, &records[i]);
+	}
 
-	control->next_addr += EEPROM_TABLE_RECORD_SIZE;
-	__update_bad_channel_bitmap(adapt, control, record);
+	/* byte sum of what went over the bus, saves encoding the records again */
+	for (j = 0; j < len; j++)
+		*recs_byte_sum += encoded_records[j];
 
 	return 0;
 }
@@ -786,7 +822,7 @@ static int ras_eeprom_v2_1_process_record(struct amdgv_adapter *adapt,
 
 static int ras_eeprom_v2_1_update_table_header(struct amdgv_adapter *adapt,
 						struct amdgv_ras_eeprom_control *control,
-						struct eeprom_table_record *records,
+						uint32_t recs_byte_sum,
 						int num)
 {
 	uint32_t old_hdr_byte_sum = __calc_hdr_byte_sum(control);
@@ -797,7 +833,7 @@ static int ras_eeprom_v2_1_update_table_header(struct amdgv_adapter *adapt,
 
 	ras_eeprom_v2_1_update_gpu_health(adapt, control);
 
-	ras_eeprom_v2_1_update_tbl_checksum(control, records, num,
+	ras_eeprom_v2_1_update_tbl_checksum(control, recs_byte_sum,
 					old_hdr_byte_sum,
 					old_extra_info_byte_sum);
 
@@ -807,11 +843,27 @@ static int ras_eeprom_v2_1_update_table_header(struct amdgv_adapter *adapt,
 	return 0;
 }
 
+static void ras_eeprom_v2_1_account_flush(struct amdgv_ras_eeprom_control *control,
+					  uint64_t xfer_start, int num)
+{
+	uint32_t xfers = (uint32_t)(control->xfer_count - xfer_start);
+
+	control->flush_count++;
+	control->flush_recs += num;
+	control->flush_xfers += xfers;
+	control->last_flush_recs = num;
+	control->last_flush_xfers = xfers;
+	if (xfers > control->max_flush_xfers)
+		control->max_flush_xfers = xfers;
+}
+
 int ras_eeprom_v2_1_process_records(struct amdgv_adapter *adapt,
 				     struct amdgv_ras_eeprom_control *control,
 				     struct eeprom_table_record *records, bool write, int num)
 {
-	int i, ret = 0;
+	int i, batch, ret = 0;
+	uint32_t recs_byte_sum = 0;
+	uint64_t xfer_start;
 
 
 	if (!adapt->umc.supports_ras_eeprom)
@@ -819,22 +871,27 @@ int ras_eeprom_v2_1_process_records(struct amdgv_adapter *adapt,
 
 	oss_mutex_lock(control->tbl_mutex);
 
-	for (i = 0; i < num; i++) {
+	xfer_start = control->xfer_count;
+
+	for (i = 0; i < num; i += batch) {
 
 		if (ras_eeprom_v2_1_entry_overflow(control)) {
 			AMDGV_WARN("Reached end of EEPROM. Ignore process request\n");
 			break;
 		}
 
-		ret = ras_eeprom_v2_1_process_record(adapt, control, &records[i], write);
+		batch = ras_eeprom_v2_1_batch_len(control, num - i);
+		ret = ras_eeprom_v2_1_process_batch(adapt, control, &records[i], batch,
+						    write, &recs_byte_sum);
 		if (ret)
 			goto fail;
 	}
 
-	if (write)
-		ras_eeprom_v2_1_update_table_header(adapt, control, records, i);
-	else
-		ras_eeprom_v2_1_update_tbl_byte_sum(adapt, control, records, i);
+	if (write) {
+		ras_eeprom_v2_1_update_table_header(adapt, control, recs_byte_sum, i);
+		ras_eeprom_v2_1_account_flush(control, xfer_start, i);
+	} else
+		ras_eeprom_v2_1_update_tbl_byte_sum(adapt, control, recs_byte_sum);
 
 
 fail:
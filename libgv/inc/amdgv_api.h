@@ -599,6 +599,12 @@ struct gpuv_engine_queue_data {
  *   In this scheme only the initialized (active) VF – meaning there is
  *   guest GFX driver running on this VF - will get a GPU time slice. The
  *   less VF is initialized; the active VF has better performance.
+ * AMDGV_SCHED_VIRTUAL_TIME_MODE – use CPU timer to control the world
+ *   switch. Like round robin only active VFs are scheduled, but the next
+ *   VF is the one with the lowest virtual time, i.e. GPU time received
+ *   divided by its configured time slice. Each VF converges to a share
+ *   proportional to its time slice, and a VF overrunning its slice is
+ *   charged for the overrun instead of delaying the other VFs.
  */
 enum amdgv_sched_mode {
 	AMDGV_SCHED_BEGIN,
@@ -611,7 +617,8 @@ enum amdgv_sched_mode {
 	AMDGV_SCHED_FAIRNESS,
 	AMDGV_SCHED_ROUND_ROBIN,
 	AMDGV_SCHED_HYBRID_LIQUID_MODE,
-	AMDGV_SCHED_MAX_SW_SCHED_MODE = AMDGV_SCHED_HYBRID_LIQUID_MODE,
+	AMDGV_SCHED_VIRTUAL_TIME_MODE,
+	AMDGV_SCHED_MAX_SW_SCHED_MODE = AMDGV_SCHED_VIRTUAL_TIME_MODE,
 
 	AMDGV_SCHED_END,
 };
@@ -839,6 +846,12 @@ struct amdgv_init_config_opt {
 	uint32_t debug_mode;
 
 	bool deferred_full_live_update;
+	/* run independent live info ops on the OS work queue */
+	bool parallel_live_update;
+	/* run init stages with finished dependencies on the OS work queue */
+	bool parallel_init;
+	/* let each tagged wait site skip the polls its learned completion time makes useless */
+	bool adaptive_wait;
 	bool asymmetric_fb_mode;
 	enum amdgv_bad_page_detection_mode bad_page_detection_mode;
 	enum amdgv_ras_vf_telemetry_policy ras_vf_telemetry_policy;
@@ -1001,6 +1014,7 @@ enum amdgv_dev_conf_type {
 	AMDGV_CONF_ASYMMETRIC_FB,
 	AMDGV_CONF_ERROR_DUMP_STACK_MAX,
 	AMDGV_CONF_ERROR_DUMP_STACK_FILTER,
+	AMDGV_CONF_PP_METRICS_CACHE,
 };
 
 union amdgv_dev_conf {
@@ -1039,6 +1053,15 @@ union amdgv_dev_conf {
 		/* perform asymmetric fb defragment */
 		bool defragment;
 	} asymmetric;
+	/* SMU metrics table cache, setting max_age_us clears the counters */
+	struct {
+		/* freshness window in us, 0 fetches the table on every read */
+		uint32_t max_age_us;
+		uint64_t hit;
+		uint64_t miss;
+		/* fetches that returned an unchanged AccumulationCounter */
+		uint64_t unchanged;
+	} pp_metrics_cache;
 };
 
 enum amdgv_vf_info_type {
@@ -1124,6 +1147,52 @@ struct amdgv_time_log {
 	struct amdgv_histogram gfx_run_summation_us;
 };
 
+/* event thread counters, one bucket per scheduler event id plus a last
+ * bucket for ids without one of their own
+ */
+#define AMDGV_SCHED_EVENT_STATS_NUM 49
+
+struct amdgv_sched_event_stats {
+	/* event id of the bucket, 0xffffffff for the last bucket */
+	uint32_t event_id;
+	/* requests queued, answered together with an identical queued
+	 * request, and dropped before or instead of being handled
+	 */
+	uint64_t queued;
+	uint64_t coalesced;
+	uint64_t skipped;
+	/* requests that went through a handler */
+	uint64_t handled;
+	/* queue_event to handler start */
+	uint64_t wait_sum_us;
+	uint32_t wait_max_us;
+	struct amdgv_histogram wait_us;
+	/* handler start to completion */
+	uint64_t run_sum_us;
+	uint32_t run_max_us;
+	struct amdgv_histogram run_us;
+};
+
+struct amdgv_sched_event_queue_stats {
+	/* requests queued or being handled, now and at most */
+	uint64_t depth;
+	uint64_t max_depth;
+	/* requests served from the heap and waiters that had to back off */
+	uint64_t pool_overflow;
+	uint64_t pool_backoff;
+};
+
+/* PSP KM ring commands, latency runs from ring submission to the fence */
+struct amdgv_psp_cmd_stats {
+	uint64_t submitted;
+	uint64_t completed;
+	/* fence timeouts and commands answered with an error status */
+	uint64_t failed;
+	uint64_t latency_sum_us;
+	uint32_t latency_max_us;
+	struct amdgv_histogram latency_us;
+};
+
 // NV32 max range number in runtime = 2 + 2*30(bad pages) + (12VF-1) = 73
 // The max range number in bootup = 2 + 30  (+ 12VF-1) = 43, so 128 is big enough
 #define FFBM_MAP_ENTRY_MAX_COUNT 128
@@ -1420,6 +1489,19 @@ struct amdgv_smi_ras_eeprom_table_record {
 	unsigned char mcumc_id;
 };
 
+/* I2C messages sent to the RAS EEPROM, a flush is one write of new records
+ * together with the table header update
+ */
+struct amdgv_ras_eeprom_xfer_stats {
+	uint64_t xfers;
+	uint64_t flushes;
+	uint64_t flush_records;
+	uint64_t flush_xfers;
+	uint32_t last_flush_records;
+	uint32_t last_flush_xfers;
+	uint32_t max_flush_xfers;
+};
+
 #define ADMGV_SMI_STR_LEN   (128)
 #define AMDGV_SMI_ASIC_NAME (32)
 
@@ -1579,6 +1661,62 @@ enum amdgv_live_info_status {
 	AMDGV_LIVE_INFO_STATUS_SIZE_UNMATCH = 4,
 };
 
+#define AMDGV_LIVE_INFO_TIMING_MAX_OP 32
+
+/* indexed by live info data op, 0 for ops that did not run */
+struct amdgv_live_info_timing {
+	uint32_t export_us[AMDGV_LIVE_INFO_TIMING_MAX_OP];
+	uint32_t import_us[AMDGV_LIVE_INFO_TIMING_MAX_OP];
+	/* wall time of the whole export/import, ops may overlap */
+	uint64_t export_total_us;
+	uint64_t import_total_us;
+};
+
+#define AMDGV_INIT_TIMING_MAX_STAGE 50
+
+/* indexed like the init function table of the asic */
+struct amdgv_init_timing {
+	uint32_t num_stages;
+	struct {
+		char name[32];
+		/* sw_init, and hw_init for hw_priority entries */
+		uint32_t sw_init_us;
+		uint32_t hw_init_us;
+		/* when sw_init started, relative to the start of sw init */
+		uint32_t sw_start_us;
+	} stage[AMDGV_INIT_TIMING_MAX_STAGE];
+	/* wall time of the sw and hw init phases, stages may overlap */
+	uint64_t sw_total_us;
+	uint64_t hw_total_us;
+	/* longest chain of dependent stages in each phase */
+	uint64_t sw_critical_path_us;
+	uint64_t hw_critical_path_us;
+	/* time of every stage that ran, both phases */
+	struct amdgv_histogram stage_us;
+};
+
+#define AMDGV_WAIT_SITE_STATS_MAX 16
+
+/* one entry per caller of the libgv wait helpers */
+struct amdgv_wait_site_stats {
+	uint32_t num_sites;
+	struct {
+		char name[24];
+		uint64_t count;
+		uint64_t timeouts;
+		/* sleeps on the site interrupt that ended early */
+		uint64_t irq_wakeups;
+		uint64_t total_us;
+		uint32_t max_us;
+		/* successful waits, upper bound of the power of two bucket */
+		uint32_t p50_us;
+		uint32_t p99_us;
+		/* learned completion time and its mean deviation */
+		uint32_t avg_us;
+		uint32_t dev_us;
+	} site[AMDGV_WAIT_SITE_STATS_MAX];
+};
+
 /* Hardcoded to be AMDGV_AGP_APERTURE_SIZE for now,
    TODO: dynamically fetch the agp allocated size */
 #define AMDGV_MIGRATION_VF_FB_COPY_BLOCK_SIZE	1LL << 24
@@ -1611,6 +1749,30 @@ enum amdgv_migration_import_phase {
 	AMDGV_MIGRATION_IMPORT_PHASE3_DYNAMIC_DATA = 3,
 };
 
+/* default chunk of a chunked PSP package copy */
+#define AMDGV_MIGRATION_CHUNK_SIZE	(1 << 20)
+
+/*
+ * Copies a PSP package out of (or into) its FB buffer in fixed-size
+ * chunks, so the VMM needs no buffer for the whole package. PSP still
+ * serializes the whole phase before the first chunk can be read, and
+ * parses it only after the last one is written. Chunks of a started copy
+ * can be read or written in any order and from several threads.
+ */
+struct amdgv_migration_chunked {
+	/* target VF */
+	uint32_t idx_vf;
+	/* enum amdgv_migration_export_phase or amdgv_migration_import_phase */
+	uint32_t phase;
+	/* bytes per chunk, 0 picks AMDGV_MIGRATION_CHUNK_SIZE; may be
+	 * raised by the start call so the package fits the chunk map
+	 */
+	uint32_t chunk_size;
+	/* package size in bytes and the number of chunks it spans */
+	uint64_t size;
+	uint32_t num_chunks;
+};
+
 struct amdgv_query_dirty_bit_data {
 	/* the offset of vf fb to be queried by the current dirty bitplane */
 	uint64_t         query_fb_offset;
@@ -2296,6 +2458,51 @@ int amdgv_import_live_info_data(amdgv_dev_t dev,
 				   void *data,
 				   enum amdgv_live_info_status *status);
 
+/**
+ * amdgv_get_live_info_timing - get time spent per live info data op
+ *
+ * @dev: amdgv device handle
+ * @timing: output, per op and total time of the last export and import
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_get_live_info_timing(amdgv_dev_t dev, struct amdgv_live_info_timing *timing);
+
+/**
+ * amdgv_get_init_timing - get time spent per device init stage
+ *
+ * @dev: amdgv device handle
+ * @timing: output, per stage and total time of the sw and hw init
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_get_init_timing(amdgv_dev_t dev, struct amdgv_init_timing *timing);
+
+/**
+ * amdgv_get_wait_site_stats - get the time spent in the wait helpers per caller
+ *
+ * @dev: amdgv device handle
+ * @stats: output, counters and percentiles per wait site
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_get_wait_site_stats(amdgv_dev_t dev, struct amdgv_wait_site_stats *stats);
+
+/**
+ * amdgv_clear_wait_site_stats - restart the wait site counters
+ *
+ * The learned completion times are kept.
+ *
+ * @dev: amdgv device handle
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_clear_wait_site_stats(amdgv_dev_t dev);
+
 /**
  * amdgv_lock_sched - lock scheduler
  *
@@ -2346,6 +2553,62 @@ int amdgv_lock_sched_ex(amdgv_dev_t dev, struct amdgv_lock_sched_opt opt);
  */
 int amdgv_unlock_sched_ex(amdgv_dev_t dev, struct amdgv_lock_sched_opt opt);
 
+/**
+ * amdgv_sched_get_event_stats - get event thread counters of one event id
+ *
+ * @dev: amdgv device handle
+ * @idx: bucket index, 0 to AMDGV_SCHED_EVENT_STATS_NUM - 1
+ * @stats: pointer to the counters
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_sched_get_event_stats(amdgv_dev_t dev, uint32_t idx,
+				struct amdgv_sched_event_stats *stats);
+
+/**
+ * amdgv_sched_get_event_queue_stats - get event queue depth counters
+ *
+ * @dev: amdgv device handle
+ * @stats: pointer to the counters
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_sched_get_event_queue_stats(amdgv_dev_t dev,
+				      struct amdgv_sched_event_queue_stats *stats);
+
+/**
+ * amdgv_sched_clear_event_stats - restart event thread counters
+ *
+ * @dev: amdgv device handle
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_sched_clear_event_stats(amdgv_dev_t dev);
+
+/**
+ * amdgv_psp_get_cmd_stats - get PSP KM command counters
+ *
+ * @dev: amdgv device handle
+ * @stats: pointer to the counters
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_psp_get_cmd_stats(amdgv_dev_t dev, struct amdgv_psp_cmd_stats *stats);
+
+/**
+ * amdgv_psp_clear_cmd_stats - reset PSP KM command counters
+ *
+ * @dev: amdgv device handle
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_psp_clear_cmd_stats(amdgv_dev_t dev);
+
 /**
  * amdgv_set_time_quanta_option - set time quanta option
  *
@@ -2456,6 +2719,28 @@ void amdgv_ras_get_bad_page_record_count(amdgv_dev_t dev, int *bp_cnt);
 int amdgv_ras_get_bad_page_info(amdgv_dev_t dev, uint32_t index,
 					struct amdgv_smi_ras_eeprom_table_record *record);
 
+/**
+ * amdgv_ras_get_eeprom_xfer_stats - get RAS EEPROM I2C transfer counters
+ *
+ * @dev: amdgv device handle
+ * @stats: pointer to the counters
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_ras_get_eeprom_xfer_stats(amdgv_dev_t dev,
+				    struct amdgv_ras_eeprom_xfer_stats *stats);
+
+/**
+ * amdgv_ras_clear_eeprom_xfer_stats - reset RAS EEPROM I2C transfer counters
+ *
+ * @dev: amdgv device handle
+ *
+ * Returns:
+ * 0 for success, errors for failure.
+ */
+int amdgv_ras_clear_eeprom_xfer_stats(amdgv_dev_t dev);
+
 /*
  * amdgv_ras_ta_load - load RAS TA
  *
@@ -2623,6 +2908,67 @@ int amdgv_migration_export(amdgv_dev_t dev, uint32_t idx_vf,
 int amdgv_migration_import(amdgv_dev_t dev, uint32_t idx_vf,
 	void *buf, enum amdgv_migration_import_phase phase);
 
+/*
+ * amdgv_migration_export_chunked_start - export PSP package for a chunked copy
+ *
+ * @dev:	amdgv device handle
+ * @copy:	idx_vf, phase and chunk_size in, size and num_chunks out
+ *
+ * Runs the whole export phase like amdgv_migration_export, the package
+ * is then read with amdgv_migration_export_chunked_read.
+ */
+int amdgv_migration_export_chunked_start(amdgv_dev_t dev,
+	struct amdgv_migration_chunked *copy);
+
+/*
+ * amdgv_migration_export_chunked_read - read one chunk of the package
+ *
+ * @dev:	amdgv device handle
+ * @copy:	copy from amdgv_migration_export_chunked_start
+ * @chunk:	chunk index, below num_chunks
+ * @buf:	dst address, at least chunk_size bytes
+ * @size:	bytes copied, only the last chunk may be short
+ *
+ */
+int amdgv_migration_export_chunked_read(amdgv_dev_t dev,
+	struct amdgv_migration_chunked *copy, uint32_t chunk,
+	void *buf, uint32_t *size);
+
+/*
+ * amdgv_migration_import_chunked_start - prepare a chunked PSP import
+ *
+ * @dev:	amdgv device handle
+ * @copy:	idx_vf, phase and chunk_size in, size and num_chunks out
+ *
+ */
+int amdgv_migration_import_chunked_start(amdgv_dev_t dev,
+	struct amdgv_migration_chunked *copy);
+
+/*
+ * amdgv_migration_import_chunked_write - write one chunk of the package
+ *
+ * @dev:	amdgv device handle
+ * @copy:	copy from amdgv_migration_import_chunked_start
+ * @chunk:	chunk index, below num_chunks
+ * @buf:	src address
+ * @size:	chunk_size, or the remainder for the last chunk
+ *
+ */
+int amdgv_migration_import_chunked_write(amdgv_dev_t dev,
+	struct amdgv_migration_chunked *copy, uint32_t chunk,
+	const void *buf, uint32_t size);
+
+/*
+ * amdgv_migration_import_chunked_finish - import a fully written package
+ *
+ * @dev:	amdgv device handle
+ * @copy:	copy from amdgv_migration_import_chunked_start
+ *
+ * Fails without touching the VF if any chunk is missing.
+ */
+int amdgv_migration_import_chunked_finish(amdgv_dev_t dev,
+	struct amdgv_migration_chunked *copy);
+
 /*
  * amdgv_get_migration_data_size - get size for migration data
  *
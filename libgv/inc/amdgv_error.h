@@ -564,8 +564,18 @@ static const int default_filter_table[] = {
 	AMDGV_ERROR_RESET_FLR,
 };
 
+/* How error_data is split into the arguments of an error text format */
+enum amdgv_error_text_arg {
+	AMDGV_ERROR_TEXT_ARG_NONE = 0,
+	AMDGV_ERROR_TEXT_ARG_64,
+	AMDGV_ERROR_TEXT_ARG_32_32,
+	AMDGV_ERROR_TEXT_ARG_16_16_32,
+	AMDGV_ERROR_TEXT_ARG_16_16_16_16,
+};
+
 int amdgv_error_get_error_text(uint32_t error_code, uint64_t data, char *buf, uint32_t size);
 int amdgv_error_get_error_text_ext(uint32_t error_code, uint64_t data, char *buf, uint32_t size, uint64_t *data_ext);
+int amdgv_error_get_error_format(uint32_t error_code, char *buf, uint32_t size, uint32_t *arg_type);
 
 void amdgv_put_event(amdgv_dev_t dev, uint32_t idx_vf, uint32_t error_code,
 		     uint64_t error_data, const char *func_name, uint32_t line_num);
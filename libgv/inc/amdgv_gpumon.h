@@ -485,6 +485,16 @@ struct amdgv_gpumon_gfx_config {
 	uint32_t minor;
 };
 
+/* gpumon query latency in us */
+struct amdgv_gpumon_latency {
+	/* answered in the caller's context, without the event queue */
+	struct amdgv_histogram fast_path_us;
+	/* queued queries: push to handler start */
+	struct amdgv_histogram queue_wait_us;
+	/* queued queries: time spent in the handler */
+	struct amdgv_histogram handler_us;
+};
+
 enum amdgv_gpumon_metric_ext_category {
 	AMDGV_GPUMON_METRIC_EXT_CATEGORY__ACC_COUNTER = 0ULL,
 	AMDGV_GPUMON_METRIC_EXT_CATEGORY__FREQUENCY = 1ULL,
@@ -792,16 +802,25 @@ int amdgv_gpumon_get_ras_session_id(amdgv_dev_t dev, uint64_t *session_ptr);
 int amdgv_gpumon_ras_get_ta_version(amdgv_dev_t dev, unsigned char *fw_image, uint32_t *ver_ptr);
 int amdgv_gpumon_ras_get_loaded_ta_version(amdgv_dev_t dev, uint32_t *ver_ptr);
 int amdgv_gpumon_get_num_active_vfs(amdgv_dev_t dev, uint32_t *num_vfs);
+int amdgv_gpumon_get_latency(amdgv_dev_t dev, struct amdgv_gpumon_latency *latency);
 
 int amdgv_gpumon_cper_get_count(amdgv_dev_t dev,
 				uint64_t rptr, uint64_t *wptr,
 				uint64_t *avail_count,
 				uint64_t *size);
+/*
+ * Copy the records from rptr onwards whose severity bit (1 << cper_error_severity)
+ * is set in sev_mask. next_rptr is where the following call should resume, and
+ * left_size the bytes of matching records that did not fit.
+ */
 int amdgv_gpumon_cper_get_entries(amdgv_dev_t dev, uint64_t rptr,
+				  uint32_t sev_mask,
 				  void *buf, uint64_t buf_size,
+				  uint64_t max_entries,
 				  uint64_t *write_count,
 				  uint64_t *overflow_count,
-				  uint64_t *left_size);
+				  uint64_t *left_size,
+				  uint64_t *next_rptr);
 int amdgv_gpumon_get_gfx_config(amdgv_dev_t dev,
 	struct amdgv_gpumon_gfx_config *config);
 
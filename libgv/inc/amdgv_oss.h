@@ -362,6 +362,10 @@ struct oss_interface {
 	void (*signal_event_forever_with_flag)(void *event, uint64_t);
 	enum oss_event_state (*wait_event)(void *event, uint32_t timeout);
 	void (*event_fini)(void *event);
+	/* drop signals nobody waited for, optional */
+	void (*reset_event)(void *event);
+	/* shortest wait_event timeout in us that is not rounded up, optional */
+	uint32_t (*wait_event_min_us)(void);
 	/* notifier wakeup */
 	int (*notifier_wakeup)(void *notifier, uint64_t count);
 	/* atomic operations */
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* libgv has its own fixed width types, keep the glibc ones out */
+#include "amdgv_basetypes.h"
+#define _BITS_STDINT_INTN_H
+#define _BITS_STDINT_UINTN_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_tools_oss.h"
+
+static void *tools_alloc(uint32_t size)
+{
+	return malloc(size);
+}
+
+static void *tools_zalloc(uint32_t size)
+{
+	return calloc(1, size);
+}
+
+static void *tools_memset(void *src, int c, uint64_t n)
+{
+	return memset(src, c, n);
+}
+
+static void *tools_memcpy(void *dest, const void *src, uint64_t n)
+{
+	return memcpy(dest, src, n);
+}
+
+static uint32_t tools_do_div(uint64_t *n, uint32_t base)
+{
+	uint32_t rem = *n % base;
+
+	*n /= base;
+	return rem;
+}
+
+static void *tools_mutex_init(void)
+{
+	pthread_mutex_t *mutex = malloc(sizeof(*mutex));
+
+	if (mutex)
+		pthread_mutex_init(mutex, NULL);
+	return mutex;
+}
+
+static void tools_mutex_lock(void *mutex)
+{
+	pthread_mutex_lock(mutex);
+}
+
+static void tools_mutex_unlock(void *mutex)
+{
+	pthread_mutex_unlock(mutex);
+}
+
+static void tools_mutex_fini(void *mutex)
+{
+	pthread_mutex_destroy(mutex);
+	free(mutex);
+}
+
+static void *tools_rwsema_init(void)
+{
+	pthread_rwlock_t *lock = malloc(sizeof(*lock));
+
+	if (lock)
+		pthread_rwlock_init(lock, NULL);
+	return lock;
+}
+
+static void tools_rwsema_read_lock(void *lock)
+{
+	pthread_rwlock_rdlock(lock);
+}
+
+/* 1 if taken, like down_read_trylock */
+static int tools_rwsema_read_trylock(void *lock)
+{
+	return pthread_rwlock_tryrdlock(lock) == 0;
+}
+
+static void tools_rwsema_unlock(void *lock)
+{
+	pthread_rwlock_unlock(lock);
+}
+
+static void tools_rwsema_write_lock(void *lock)
+{
+	pthread_rwlock_wrlock(lock);
+}
+
+static int tools_rwsema_write_trylock(void *lock)
+{
+	return pthread_rwlock_trywrlock(lock) == 0;
+}
+
+static void tools_rwsema_fini(void *lock)
+{
+	pthread_rwlock_destroy(lock);
+	free(lock);
+}
+
+/* counts signals like the kernel completion behind the gim events */
+struct tools_event {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uint32_t count;
+};
+
+static void *tools_event_init(void)
+{
+	struct tools_event *ev = calloc(1, sizeof(*ev));
+	pthread_condattr_t attr;
+
+	if (!ev)
+		return NULL;
+
+	pthread_mutex_init(&ev->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&ev->cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	return ev;
+}
+
+static void tools_signal_event(void *event)
+{
+	struct tools_event *ev = event;
+
+	pthread_mutex_lock(&ev->lock);
+	ev->count++;
+	pthread_cond_signal(&ev->cond);
+	pthread_mutex_unlock(&ev->lock);
+}
+
+static enum oss_event_state tools_wait_event(void *event, uint32_t timeout)
+{
+	struct tools_event *ev = event;
+	enum oss_event_state state = OSS_EVENT_STATE_WAKE_UP;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	ts.tv_sec += timeout / 1000000;
+	ts.tv_nsec += (long)(timeout % 1000000) * 1000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&ev->lock);
+	while (ev->count == 0 && state == OSS_EVENT_STATE_WAKE_UP) {
+		if (pthread_cond_timedwait(&ev->cond, &ev->lock, &ts) == ETIMEDOUT)
+			state = OSS_EVENT_STATE_TIMEOUT;
+	}
+	if (ev->count) {
+		ev->count--;
+		state = OSS_EVENT_STATE_WAKE_UP;
+	}
+	pthread_mutex_unlock(&ev->lock);
+
+	return state;
+}
+
+static void tools_event_fini(void *event)
+{
+	struct tools_event *ev = event;
+
+	pthread_cond_destroy(&ev->cond);
+	pthread_mutex_destroy(&ev->lock);
+	free(ev);
+}
+
+static void tools_udelay(uint32_t usecs)
+{
+	uint64_t end = amdgv_tools_now_ns() + (uint64_t)usecs * 1000;
+
+	while (amdgv_tools_now_ns() < end)
+		;
+}
+
+static void tools_usleep(uint32_t usecs)
+{
+	usleep(usecs);
+}
+
+static void tools_msleep(uint32_t msecs)
+{
+	usleep(msecs * 1000);
+}
+
+uint64_t amdgv_tools_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t tools_now_us(void)
+{
+	return amdgv_tools_now_ns() / 1000;
+}
+
+static void tools_print(int level, const char *fmt, va_list args)
+{
+	vfprintf(stderr, fmt, args);
+}
+
+struct tools_work {
+	oss_callback_t fn;
+	void *context;
+};
+
+static void *tools_work_thread(void *arg)
+{
+	struct tools_work work = *(struct tools_work *)arg;
+
+	free(arg);
+	work.fn(work.context);
+
+	return NULL;
+}
+
+int amdgv_tools_schedule_work(oss_dev_t dev, oss_callback_t fn, void *context)
+{
+	struct tools_work *work;
+	pthread_attr_t attr;
+	pthread_t thread;
+	int ret;
+
+	work = malloc(sizeof(*work));
+	if (!work)
+		return -1;
+	work->fn = fn;
+	work->context = context;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	ret = pthread_create(&thread, &attr, tools_work_thread, work);
+	pthread_attr_destroy(&attr);
+	if (ret) {
+		free(work);
+		return -1;
+	}
+
+	return 0;
+}
+
+struct oss_interface amdgv_tools_oss = {
+	.alloc_small_memory = tools_alloc,
+	.alloc_small_zero_memory = tools_zalloc,
+	.free_small_memory = free,
+	.memset = tools_memset,
+	.memcpy = tools_memcpy,
+	.do_div = tools_do_div,
+	.mutex_init = tools_mutex_init,
+	.mutex_lock = tools_mutex_lock,
+	.mutex_unlock = tools_mutex_unlock,
+	.mutex_fini = tools_mutex_fini,
+	.rwsema_init = tools_rwsema_init,
+	.rwsema_read_lock = tools_rwsema_read_lock,
+	.rwsema_read_trylock = tools_rwsema_read_trylock,
+	.rwsema_read_unlock = tools_rwsema_unlock,
+	.rwsema_write_lock = tools_rwsema_write_lock,
+	.rwsema_write_trylock = tools_rwsema_write_trylock,
+	.rwsema_write_unlock = tools_rwsema_unlock,
+	.rwsema_fini = tools_rwsema_fini,
+	.event_init = tools_event_init,
+	.signal_event = tools_signal_event,
+	.wait_event = tools_wait_event,
+	.event_fini = tools_event_fini,
+	.udelay = tools_udelay,
+	.msleep = tools_msleep,
+	.usleep = tools_usleep,
+	.get_time_stamp = tools_now_us,
+	.print = tools_print,
+	.schedule_work = amdgv_tools_schedule_work,
+};
+
+struct oss_interface *amdgv_oss_funcs = &amdgv_tools_oss;
+
+void amdgv_put_event(amdgv_dev_t dev, uint32_t idx_vf, uint32_t error_code,
+		     uint64_t error_data, const char *func_name, uint32_t line_num)
+{
+	fprintf(stderr, "error 0x%x data 0x%llx at %s:%u\n", error_code,
+		(unsigned long long)error_data, func_name, line_num);
+}
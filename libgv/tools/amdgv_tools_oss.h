@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AMDGV_TOOLS_OSS_H
+#define AMDGV_TOOLS_OSS_H
+
+/*
+ * Userspace oss_interface shared by the libgv tools, built by common.mk.
+ * amdgv_oss_funcs points at amdgv_tools_oss. Memory, locks, counted events,
+ * delays and the time stamp map to libc and pthreads, schedule_work runs
+ * every item on a thread of its own like the kernel work queue runs items
+ * concurrently. A tool that needs another behavior replaces single members
+ * of amdgv_tools_oss before it calls into libgv.
+ */
+extern struct oss_interface amdgv_tools_oss;
+
+/* CLOCK_MONOTONIC in ns, get_time_stamp is the same clock in us */
+uint64_t amdgv_tools_now_ns(void);
+
+int amdgv_tools_schedule_work(oss_dev_t dev, oss_callback_t fn, void *context);
+
+#endif
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Bad page index benchmark.
+ *
+ * Fills a bad page array the way amdgv_umc_update_eeprom_ram_data() does
+ * (each record expands to the pages of one memory row) together with the
+ * retired page index of amdgv_umc_bp_index.c, then times the lookups UMC
+ * does on every RAS interrupt and VF FB validation against the linear
+ * scans they replace:
+ *   lookup  - is a page retired (amdgv_umc_check_bad_page, duplicate check)
+ *   row     - is a reserved page in the same memory row
+ *             (amdgv_umc_check_bp_in_same_mem_row)
+ * Every answer of the index is checked against the scan. Lookups are half
+ * hits and half misses. Times are per operation, insert is the mean cost
+ * of adding one page while the array is filled.
+ */
+
+/* libgv has its own fixed width types, keep the glibc ones out */
+#include "amdgv_basetypes.h"
+#define _BITS_STDINT_INTN_H
+#define _BITS_STDINT_UINTN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_umc_bp_index.h"
+#include "amdgv_tools_oss.h"
+
+/* pages per memory row, AMDGV_GPU_MEM_ROW_SIZE / AMDGV_GPU_PAGE_SIZE */
+#define BENCH_ROW_PAGES	(AMDGV_GPU_MEM_ROW_SIZE >> AMDGV_GPU_PAGE_SHIFT)
+/* 192 GB of HBM in 4 KB pages */
+#define BENCH_FB_PAGES	(192ULL << 18)
+/* bound the work of the linear scans */
+#define BENCH_SCAN_OPS	(200ULL * 1000 * 1000)
+
+/**********************************************************************
+ * Benchmark
+ **********************************************************************/
+static uint64_t bench_seed = 1;
+
+/* xorshift64*, runs must not depend on the libc generator */
+static uint64_t bench_rand(void)
+{
+	bench_seed ^= bench_seed >> 12;
+	bench_seed ^= bench_seed << 25;
+	bench_seed ^= bench_seed >> 27;
+	return bench_seed * 2685821657736338717ULL;
+}
+
+static bool scan_contains(const uint64_t *bps, uint32_t count, uint64_t pfn)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+		if (bps[i] == pfn)
+			return true;
+
+	return false;
+}
+
+static bool scan_same_row(const uint64_t *bps, uint32_t last_reserved, uint64_t pfn)
+{
+	bool ret = false;
+	uint32_t i;
+
+	/* no early exit, same as the loop in amdgv_umc.c */
+	for (i = 0; i < last_reserved; i++)
+		if (bps[i] / BENCH_ROW_PAGES == pfn / BENCH_ROW_PAGES)
+			ret = true;
+
+	return ret;
+}
+
+static bool index_same_row(struct amdgv_umc_bp_index *index, uint32_t last_reserved,
+			   uint64_t pfn)
+{
+	uint64_t start = pfn / BENCH_ROW_PAGES * BENCH_ROW_PAGES;
+
+	return amdgv_umc_bp_index_first_in_range(index, start, start + BENCH_ROW_PAGES) <
+	       last_reserved;
+}
+
+/* half of the queries hit an indexed page */
+static uint64_t bench_query_pfn(const uint64_t *bps, uint32_t count)
+{
+	uint64_t r = bench_rand();
+
+	if (r & 1)
+		return bps[(r >> 1) % count];
+
+	return (r >> 1) % BENCH_FB_PAGES;
+}
+
+static int bench_run(uint32_t num_pages, uint64_t queries)
+{
+	struct amdgv_umc_bp_index index;
+	uint64_t scan_queries, *bps, *query, pfn, t0, t_insert, t_scan, t_index;
+	uint32_t count = 0, last_reserved, i, j, pages, errors = 0;
+	uint64_t hits = 0;
+
+	bps = malloc(num_pages * sizeof(*bps));
+	query = malloc(queries * sizeof(*query));
+	if (!bps || !query || amdgv_umc_bp_index_init(&index, 10)) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	/* records expand to 1..BENCH_ROW_PAGES pages of a random row */
+	t_insert = 0;
+	while (count < num_pages) {
+		pfn = bench_rand() % (BENCH_FB_PAGES / BENCH_ROW_PAGES) * BENCH_ROW_PAGES;
+		pages = 1 + bench_rand() % BENCH_ROW_PAGES;
+		for (j = 0; j < pages && count < num_pages; j++) {
+			bps[count] = pfn + j;
+			t0 = amdgv_tools_now_ns();
+			if (amdgv_umc_bp_index_insert(&index, bps[count], count)) {
+				fprintf(stderr, "out of memory\n");
+				return 1;
+			}
+			t_insert += amdgv_tools_now_ns() - t0;
+			count++;
+		}
+	}
+
+	for (i = 0; i < queries; i++)
+		query[i] = bench_query_pfn(bps, count);
+	scan_queries = BENCH_SCAN_OPS / count;
+	if (scan_queries > queries)
+		scan_queries = queries;
+	if (scan_queries == 0)
+		scan_queries = 1;
+
+	/* lookup */
+	t0 = amdgv_tools_now_ns();
+	for (i = 0; i < scan_queries; i++)
+		hits += scan_contains(bps, count, query[i]);
+	t_scan = amdgv_tools_now_ns() - t0;
+
+	t0 = amdgv_tools_now_ns();
+	for (i = 0; i < queries; i++)
+		hits += amdgv_umc_bp_index_contains(&index, query[i]);
+	t_index = amdgv_tools_now_ns() - t0;
+
+	for (i = 0; i < scan_queries; i++)
+		errors += scan_contains(bps, count, query[i]) !=
+			  amdgv_umc_bp_index_contains(&index, query[i]);
+
+	printf("%8u %-8s %12.1f %12.1f %10.1f\n", count, "lookup",
+	       (double)t_scan / scan_queries, (double)t_index / queries,
+	       (double)t_insert / count);
+
+	/* row, the first half of the array is reserved */
+	last_reserved = count / 2;
+	t0 = amdgv_tools_now_ns();
+	for (i = 0; i < scan_queries; i++)
+		hits += scan_same_row(bps, last_reserved, query[i]);
+	t_scan = amdgv_tools_now_ns() - t0;
+
+	t0 = amdgv_tools_now_ns();
+	for (i = 0; i < queries; i++)
+		hits += index_same_row(&index, last_reserved, query[i]);
+	t_index = amdgv_tools_now_ns() - t0;
+
+	for (i = 0; i < scan_queries; i++)
+		errors += scan_same_row(bps, last_reserved, query[i]) !=
+			  index_same_row(&index, last_reserved, query[i]);
+
+	printf("%8u %-8s %12.1f %12.1f\n", count, "row",
+	       (double)t_scan / scan_queries, (double)t_index / queries);
+
+	amdgv_umc_bp_index_fini(&index);
+	free(query);
+	free(bps);
+
+	if (errors) {
+		fprintf(stderr, "%u mismatches between index and scan (%llu hits)\n", errors,
+			(unsigned long long)hits);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [-n pages[,pages...]] [-q queries] [-r seed]\n"
+		"  -n  bad page array sizes to run (default 1000,10000,100000)\n"
+		"  -q  queries per size (default 1000000)\n"
+		"  -r  random seed (default 1)\n",
+		name);
+}
+
+int main(int argc, char **argv)
+{
+	const char *sizes = "1000,10000,100000";
+	uint64_t queries = 1000000;
+	char *arg, *tok, *save = NULL;
+	int opt, ret = 0;
+
+	while ((opt = getopt(argc, argv, "n:q:r:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			sizes = optarg;
+			break;
+		case 'q':
+			queries = strtoull(optarg, NULL, 0);
+			break;
+		case 'r':
+			bench_seed = strtoull(optarg, NULL, 0);
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (queries == 0 || bench_seed == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	printf("%8s %-8s %12s %12s %10s\n", "pages", "query", "scan ns/op", "index ns/op",
+	       "insert ns");
+
+	arg = strdup(sizes);
+	for (tok = strtok_r(arg, ",", &save); tok && !ret; tok = strtok_r(NULL, ",", &save)) {
+		if (strtoul(tok, NULL, 0) == 0) {
+			usage(argv[0]);
+			ret = 1;
+			break;
+		}
+		ret = bench_run(strtoul(tok, NULL, 0), queries);
+	}
+	free(arg);
+
+	return ret;
+}
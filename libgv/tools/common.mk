@@ -0,0 +1,53 @@
+#
+# Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+
+
+# Shared build of the libgv userspace tools. A tool Makefile sets
+# LIBGV_PATH, TARGET, SRCS (its own sources) and LIBGV_SRCS (the libgv
+# files under test, relative to libgv/core), optionally adds to LDLIBS, and
+# includes this file. Every source becomes an object of its own next to
+# the tool and amdgv_tools_oss.c provides the oss_interface.
+
+TOOLS_PATH := $(LIBGV_PATH)/tools
+
+CFLAGS ?= -O2 -g
+CFLAGS += -std=gnu11 -Wall -Werror -Wno-unused-parameter
+CFLAGS += -D'__packed=__attribute__((packed))'
+CFLAGS += -I$(LIBGV_PATH)/inc -I$(LIBGV_PATH)/core -I$(TOOLS_PATH)
+CFLAGS += -MMD -MP
+
+LDLIBS += -pthread
+
+vpath %.c $(LIBGV_PATH)/core $(TOOLS_PATH)
+
+OBJS := $(SRCS:.c=.o) $(LIBGV_SRCS:.c=.o) amdgv_tools_oss.o
+
+default: $(TARGET)
+
+$(TARGET): $(OBJS)
+	$(CC) $(CFLAGS) $(LDFLAGS) -o $@ $(OBJS) $(LDLIBS)
+
+-include $(OBJS:.o=.d)
+
+.PHONY: clean
+clean:
+	$(RM) $(TARGET) $(OBJS) $(OBJS:.o=.d)
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* FFBM lookup index check.
+ *
+ * Drives the FFBM page table of a scratch adapter through random VF maps
+ * and unmaps, manual maps and bad page replacements, the operations that
+ * update the sorted index in place. After every operation it checks:
+ *   rebuild - the incrementally updated index equals a full rebuild from
+ *             the lists (amdgv_ffbm_index_rebuild)
+ *   lookups - spa and gpa translation, the empty and reserved block
+ *             searches and the gpa range check answer the same with the
+ *             index and with the list walks used while it is invalid
+ *   lists   - spa_list still tiles the FB in spa order
+ * FB accesses are stubbed, so replacements only move page table entries.
+ * amdgv_ffbm.c is included rather than linked to reach its static lookups.
+ */
+
+/* libgv has its own fixed width types, keep the glibc ones out */
+#include "amdgv_basetypes.h"
+#define _BITS_STDINT_INTN_H
+#define _BITS_STDINT_UINTN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_ffbm.c"
+#include "amdgv_tools_oss.h"
+
+/* 8 GB of FB managed in 2 MB pages */
+#define CHECK_FB_MB		8192
+#define CHECK_TOP_MB		256
+#define CHECK_TMR_MB		64
+#define CHECK_FRAGMENT		9
+#define CHECK_RESERVED		16
+#define CHECK_NUM_VF		8
+
+/**********************************************************************
+ * libgv environment
+ **********************************************************************/
+uint32_t amdgv_mm_read_fb(struct amdgv_adapter *adapt, uint64_t addr)
+{
+	return 0;
+}
+
+void amdgv_mm_write_fb(struct amdgv_adapter *adapt, uint64_t addr, uint32_t val)
+{
+}
+
+void amdgv_mm_copy_to_fb(struct amdgv_adapter *adapt, uint64_t dst, uint64_t src,
+			 uint64_t size)
+{
+}
+
+void amdgv_mm_copy_from_fb(struct amdgv_adapter *adapt, uint64_t dst, uint64_t src,
+			   uint64_t size)
+{
+}
+
+void amdgv_umc_badpages_count_read(struct amdgv_adapter *adapt, int *bp_cnt)
+{
+	*bp_cnt = 0;
+}
+
+int amdgv_umc_get_badpages_record(struct amdgv_adapter *adapt, uint32_t index, void *record)
+{
+	return AMDGV_FAILURE;
+}
+
+static int check_apply_pteb(struct amdgv_adapter *adapt, struct amdgv_ffbm_pte_block *pteb,
+			    bool valid)
+{
+	pteb->applied = valid;
+	return 0;
+}
+
+static int check_invalidate_tlb(struct amdgv_adapter *adapt,
+				struct amdgv_ffbm_pte_block *pteb, bool flush)
+{
+	return 0;
+}
+
+/**********************************************************************
+ * Check
+ **********************************************************************/
+enum check_op {
+	CHECK_OP_MAP_VF,
+	CHECK_OP_UNMAP_VF,
+	CHECK_OP_MANUAL_MAP,
+	CHECK_OP_REPLACE,
+	CHECK_OP_COUNT,
+};
+
+static const char *check_op_name[CHECK_OP_COUNT] = {
+	[CHECK_OP_MAP_VF] = "map vf",
+	[CHECK_OP_UNMAP_VF] = "unmap vf",
+	[CHECK_OP_MANUAL_MAP] = "manual map",
+	[CHECK_OP_REPLACE] = "replace",
+};
+
+/* what one probe finds, once through the index and once through the lists */
+struct check_answer {
+	struct amdgv_ffbm_pte_block *by_spa;
+	struct amdgv_ffbm_pte_block *by_gpa;
+	struct amdgv_ffbm_pte_block *empty;
+	struct amdgv_ffbm_pte_block *reserved;
+	bool gpa_free;
+};
+
+static struct amdgv_adapter check_adapt;
+static struct amdgv_ffbm_index check_index;
+static uint64_t check_seed = 1;
+
+/* xorshift64*, runs must not depend on the libc generator */
+static uint64_t check_rand(void)
+{
+	check_seed ^= check_seed >> 12;
+	check_seed ^= check_seed << 25;
+	check_seed ^= check_seed >> 27;
+	return check_seed * 2685821657736338717ULL;
+}
+
+static uint64_t check_page_size(void)
+{
+	return AMDGV_FFBM_PAGE_SIZE(check_adapt.ffbm.default_fragment);
+}
+
+static void check_setup(bool verbose)
+{
+	struct amdgv_adapter *adapt = &check_adapt;
+	uint32_t vf_idx;
+
+	adapt->num_vf = CHECK_NUM_VF;
+	adapt->max_num_vf = CHECK_NUM_VF;
+	adapt->log_mask = verbose ? ~0U : 0;
+	adapt->log_level = AMDGV_WARN_LEVEL;
+	adapt->tmr_size = CHECK_TMR_MB;
+	adapt->psp.allocated_tmr_size = MBYTES_TO_BYTES(CHECK_TMR_MB);
+	adapt->gpuiov.total_fb_avail = CHECK_FB_MB;
+	adapt->gpuiov.total_fb_usable = CHECK_FB_MB - CHECK_TOP_MB;
+	adapt->ffbm.default_fragment = CHECK_FRAGMENT;
+	adapt->ffbm.max_reserved_block = CHECK_RESERVED;
+	adapt->ffbm.apply_pteb = check_apply_pteb;
+	adapt->ffbm.invalidate_tlb = check_invalidate_tlb;
+	for (vf_idx = 0; vf_idx < CHECK_NUM_VF; vf_idx++)
+		adapt->array_vf[vf_idx].fb_size = 0;
+
+	amdgv_ffbm_sw_init(adapt);
+	amdgv_ffbm_page_table_init(adapt);
+}
+
+static int check_do_op(enum check_op op)
+{
+	struct amdgv_adapter *adapt = &check_adapt;
+	struct amdgv_ffbm_pte_block *pteb, *victim = NULL;
+	struct eeprom_table_record record;
+	uint64_t page_size = check_page_size();
+	uint32_t vf_idx = check_rand() % CHECK_NUM_VF;
+	uint64_t gpa, spa, size;
+	uint32_t count = 0, pick;
+
+	switch (op) {
+	case CHECK_OP_MAP_VF:
+		amdgv_ffbm_unmap_by_fcn(adapt, vf_idx, false);
+		/* 16 MB to 1 GB, in 2 MB steps */
+		adapt->array_vf[vf_idx].fb_size = 16 + 2 * (check_rand() % 505);
+		return amdgv_ffbm_page_table_update_by_fcn(adapt, vf_idx);
+
+	case CHECK_OP_UNMAP_VF:
+		amdgv_ffbm_unmap_by_fcn(adapt, vf_idx, false);
+		return 0;
+
+	case CHECK_OP_MANUAL_MAP:
+		size = page_size * (1 + check_rand() % 32);
+		gpa = MBYTES_TO_BYTES(AMDGV_FFBM_FB_TMR_OFFSET + CHECK_TMR_MB) +
+		      page_size * (check_rand() % 1024);
+		spa = page_size * (check_rand() % (adapt->ffbm.total_physical_size / page_size));
+		if (amdgv_ffbm_manual_map(adapt, vf_idx, size, gpa, spa, AMDGV_FFBM_PERM_RW,
+					  AMDGV_FFBM_MEM_TYPE_VF))
+			return AMDGV_FAILURE;
+		return amdgv_ffbm_apply_page_table(adapt);
+
+	case CHECK_OP_REPLACE:
+		/* a random 4 KB page of a random VF block */
+		amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list,
+					   struct amdgv_ffbm_pte_block, spa_list_node)
+			count += pteb->type == AMDGV_FFBM_MEM_TYPE_VF;
+		if (count == 0)
+			return AMDGV_FAILURE;
+		pick = check_rand() % count;
+		amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list,
+					   struct amdgv_ffbm_pte_block, spa_list_node) {
+			if (pteb->type == AMDGV_FFBM_MEM_TYPE_VF && pick-- == 0) {
+				victim = pteb;
+				break;
+			}
+		}
+		memset(&record, 0, sizeof(record));
+		record.retired_page = (victim->spa >> AMDGV_GPU_PAGE_SHIFT) +
+				      check_rand() % (victim->size >> AMDGV_GPU_PAGE_SHIFT);
+		return amdgv_ffbm_replace_bad_pages(adapt, &record, 1);
+
+	default:
+		return AMDGV_FAILURE;
+	}
+}
+
+/* compare the index with a full rebuild, which leaves the index rebuilt */
+static int check_rebuild(void)
+{
+	struct amdgv_adapter *adapt = &check_adapt;
+	struct amdgv_ffbm_index *index = &adapt->ffbm.index;
+	uint32_t i;
+
+	memcpy(&check_index, index, sizeof(check_index));
+	FFBM_LOCK_LIST;
+	amdgv_ffbm_index_rebuild(adapt);
+	FFBM_UNLOCK_LIST;
+
+	if (check_index.spa_count != index->spa_count ||
+	    check_index.free_count != index->free_count ||
+	    check_index.reserved_count != index->reserved_count) {
+		fprintf(stderr, "counts spa %u free %u reserved %u, rebuild %u %u %u\n",
+			check_index.spa_count, check_index.free_count,
+			check_index.reserved_count, index->spa_count, index->free_count,
+			index->reserved_count);
+		return 1;
+	}
+
+	for (i = 0; i <= AMDGV_MAX_VF_SLOT; i++) {
+		if (check_index.gpa_start[i] != index->gpa_start[i]) {
+			fprintf(stderr, "gpa_start[%u] %u, rebuild %u\n", i,
+				check_index.gpa_start[i], index->gpa_start[i]);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < AMDGV_FFBM_FREE_BUCKETS; i++) {
+		if (check_index.free_bucket[i] != index->free_bucket[i]) {
+			fprintf(stderr, "free_bucket[%u] %u, rebuild %u\n", i,
+				check_index.free_bucket[i], index->free_bucket[i]);
+			return 1;
+		}
+	}
+
+	if (memcmp(check_index.spa, index->spa, index->spa_count * sizeof(index->spa[0])) ||
+	    memcmp(check_index.free, index->free, index->free_count * sizeof(index->free[0])) ||
+	    memcmp(check_index.reserved, index->reserved,
+		   index->reserved_count * sizeof(index->reserved[0])) ||
+	    memcmp(check_index.gpa, index->gpa,
+		   index->gpa_start[AMDGV_MAX_VF_SLOT] * sizeof(index->gpa[0]))) {
+		fprintf(stderr, "index order differs from the rebuild\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+static void check_probe(struct check_answer *ans, uint64_t spa, uint64_t gpa, uint64_t size,
+			uint32_t vf_idx)
+{
+	struct amdgv_adapter *adapt = &check_adapt;
+
+	ans->by_spa = amdgv_ffbm_find_pteb_by_phy(adapt, spa);
+	ans->by_gpa = amdgv_ffbm_find_pteb_by_ffbm(adapt, gpa, vf_idx);
+	ans->empty = amdgv_ffbm_find_empty_pteb(adapt, size);
+	FFBM_READ_LOCK_LIST;
+	ans->reserved = amdgv_ffbm_index_find_reserved(adapt);
+	FFBM_READ_UNLOCK_LIST;
+	ans->gpa_free = is_gpaess_valid(adapt, size, gpa, vf_idx);
+}
+
+/* the same probes with the index and with the list walk fallback */
+static int check_lookups(uint32_t probes)
+{
+	struct amdgv_adapter *adapt = &check_adapt;
+	struct check_answer by_index, by_list;
+	uint64_t page_size = check_page_size();
+	uint64_t spa, gpa, size;
+	uint32_t i, vf_idx;
+
+	for (i = 0; i < probes; i++) {
+		vf_idx = check_rand() % CHECK_NUM_VF;
+		spa = (check_rand() % adapt->ffbm.total_physical_size) & ~(PAGE_SIZE - 1ULL);
+		gpa = (check_rand() % MBYTES_TO_BYTES(2048)) & ~(PAGE_SIZE - 1ULL);
+		size = page_size * (1 + check_rand() % 64);
+
+		check_probe(&by_index, spa, gpa, size, vf_idx);
+		adapt->ffbm.index.valid = false;
+		check_probe(&by_list, spa, gpa, size, vf_idx);
+		adapt->ffbm.index.valid = true;
+
+		if (by_index.by_spa != by_list.by_spa || by_index.by_gpa != by_list.by_gpa ||
+		    by_index.empty != by_list.empty || by_index.reserved != by_list.reserved ||
+		    by_index.gpa_free != by_list.gpa_free) {
+			fprintf(stderr,
+				"vf %u spa 0x%llx gpa 0x%llx size 0x%llx: index %p %p %p %p %d,"
+				" lists %p %p %p %p %d\n",
+				vf_idx, spa, gpa, size, by_index.by_spa, by_index.by_gpa,
+				by_index.empty, by_index.reserved, by_index.gpa_free,
+				by_list.by_spa, by_list.by_gpa, by_list.empty, by_list.reserved,
+				by_list.gpa_free);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int check_lists(void)
+{
+	struct amdgv_adapter *adapt = &check_adapt;
+	struct amdgv_ffbm_pte_block *pteb;
+	uint64_t next = 0;
+
+	amdgv_list_for_each_entry(pteb, &adapt->ffbm.spa_list, struct amdgv_ffbm_pte_block,
+				   spa_list_node) {
+		if (pteb->spa != next || pteb->size == 0) {
+			fprintf(stderr, "spa_list block 0x%llx size 0x%llx, expected 0x%llx\n",
+				pteb->spa, pteb->size, next);
+			return 1;
+		}
+		next += pteb->size;
+	}
+
+	if (next != adapt->ffbm.total_physical_size) {
+		fprintf(stderr, "spa_list ends at 0x%llx of 0x%llx\n", next,
+			adapt->ffbm.total_physical_size);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int check_run(uint32_t ops, uint32_t probes, bool verbose)
+{
+	uint32_t done[CHECK_OP_COUNT] = { 0 }, failed[CHECK_OP_COUNT] = { 0 };
+	enum check_op op;
+	uint32_t i;
+
+	check_setup(verbose);
+	if (check_lists() || check_rebuild() || check_lookups(probes)) {
+		fprintf(stderr, "initial page table\n");
+		return 1;
+	}
+
+	for (i = 0; i < ops; i++) {
+		/* replacements use up the reserved blocks, keep them rare */
+		op = check_rand() % 16 == 0 ? CHECK_OP_REPLACE : check_rand() % CHECK_OP_REPLACE;
+		if (check_do_op(op))
+			failed[op]++;
+		else
+			done[op]++;
+
+		if (check_lists() || check_rebuild() || check_lookups(probes)) {
+			fprintf(stderr, "after op %u (%s)\n", i, check_op_name[op]);
+			return 1;
+		}
+	}
+
+	printf("%-12s %8s %8s\n", "op", "done", "failed");
+	for (op = 0; op < CHECK_OP_COUNT; op++)
+		printf("%-12s %8u %8u\n", check_op_name[op], done[op], failed[op]);
+	printf("%u blocks, %u bad, %u reserved left\n", check_adapt.ffbm.index.spa_count,
+	       check_adapt.ffbm.bad_block_count, check_adapt.ffbm.index.reserved_count);
+
+	amdgv_ffbm_page_table_destroy(&check_adapt);
+	amdgv_ffbm_sw_fini(&check_adapt);
+
+	return 0;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [-n ops] [-p probes] [-r seed] [-v]\n"
+		"  -n  page table operations (default 1000)\n"
+		"  -p  lookups compared after each operation (default 64)\n"
+		"  -r  random seed (default 1)\n"
+		"  -v  print the libgv FFBM messages\n",
+		name);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t ops = 1000;
+	uint32_t probes = 64;
+	bool verbose = false;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:p:r:vh")) != -1) {
+		switch (opt) {
+		case 'n':
+			ops = strtoul(optarg, NULL, 0);
+			break;
+		case 'p':
+			probes = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			check_seed = strtoull(optarg, NULL, 0);
+			break;
+		case 'v':
+			verbose = true;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (ops == 0 || check_seed == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	return check_run(ops, probes, verbose);
+}
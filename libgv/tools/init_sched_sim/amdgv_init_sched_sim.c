@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Init stage scheduler simulator.
+ *
+ * Runs amdgv_init_sched.c over a table of stub init functions shaped like
+ * an asic init table: a discovery stage, independent blocks that only
+ * need discovery, blocks that need some of those, and a last stage
+ * without declared dependencies. Stages sleep for a fixed time instead of
+ * touching hardware. Every run checks that
+ *   - no stage starts before all of its dependencies finished
+ *   - in order runs, and tables without dependencies, keep table order
+ *   - after a failure nothing that depends on the failed stage runs and
+ *     nothing is still running when the scheduler returns
+ * and prints the wall time next to the critical path, the floor that
+ * declared dependencies allow, and the sum of all stages, the time of
+ * the old in order init.
+ */
+
+/* libgv has its own fixed width types, keep the glibc ones out */
+#include "amdgv_basetypes.h"
+#define _BITS_STDINT_INTN_H
+#define _BITS_STDINT_UINTN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_init_sched.h"
+#include "amdgv_tools_oss.h"
+
+/**********************************************************************
+ * libgv environment
+ **********************************************************************/
+static bool sim_refuse_work;
+
+/* lets the scheduler fall back to running stages inline */
+static int sim_schedule_work(oss_dev_t dev, oss_callback_t fn, void *context)
+{
+	if (sim_refuse_work)
+		return -1;
+
+	return amdgv_tools_schedule_work(dev, fn, context);
+}
+
+/**********************************************************************
+ * Stub init table
+ **********************************************************************/
+static struct amdgv_init_func sim_ip_discovery;
+static struct amdgv_init_func sim_mcp;
+static struct amdgv_init_func sim_vbios;
+static struct amdgv_init_func sim_mem;
+static struct amdgv_init_func sim_gfx;
+static struct amdgv_init_func sim_sdma;
+static struct amdgv_init_func sim_psp;
+static struct amdgv_init_func sim_smu;
+static struct amdgv_init_func sim_late;
+/* not in the table, like a block another asic has */
+static struct amdgv_init_func sim_absent = { .name = "absent" };
+
+static const struct amdgv_init_func *const sim_discovery_deps[] = { &sim_ip_discovery, NULL };
+static const struct amdgv_init_func *const sim_gfx_deps[] = { &sim_mem, &sim_vbios, NULL };
+static const struct amdgv_init_func *const sim_sdma_deps[] = { &sim_mem, NULL };
+static const struct amdgv_init_func *const sim_psp_deps[] = { &sim_mcp, NULL };
+static const struct amdgv_init_func *const sim_smu_deps[] = { &sim_psp, &sim_absent, NULL };
+/* depends on an entry after it, only table order is safe */
+static const struct amdgv_init_func *const sim_bad_deps[] = { &sim_smu, NULL };
+
+static struct amdgv_init_func sim_ip_discovery = { .name = "ip_discovery" };
+static struct amdgv_init_func sim_mcp = { .name = "mcp", .deps = sim_discovery_deps };
+static struct amdgv_init_func sim_vbios = { .name = "vbios", .deps = sim_discovery_deps };
+static struct amdgv_init_func sim_mem = { .name = "mem", .deps = sim_discovery_deps };
+static struct amdgv_init_func sim_gfx = { .name = "gfx", .deps = sim_gfx_deps };
+static struct amdgv_init_func sim_sdma = { .name = "sdma", .deps = sim_sdma_deps };
+static struct amdgv_init_func sim_psp = { .name = "psp", .deps = sim_psp_deps };
+static struct amdgv_init_func sim_smu = { .name = "smu", .deps = sim_smu_deps };
+static struct amdgv_init_func sim_late = { .name = "late" };
+
+#define SIM_STAGES 9
+
+static struct amdgv_init_func *sim_table[SIM_STAGES] = {
+	&sim_ip_discovery, &sim_mcp, &sim_vbios, &sim_mem, &sim_gfx,
+	&sim_sdma, &sim_psp, &sim_smu, &sim_late,
+};
+
+/* what amdgv_init_sched_build() must make of sim_table */
+static const uint64_t sim_expected_deps[SIM_STAGES] = {
+	0x000,	/* ip_discovery */
+	0x001,	/* mcp */
+	0x001,	/* vbios */
+	0x001,	/* mem */
+	0x00c,	/* gfx: mem, vbios */
+	0x008,	/* sdma: mem */
+	0x002,	/* psp: mcp */
+	0x040,	/* smu: psp, absent is ignored */
+	0x0ff,	/* late: everything before it */
+};
+
+/* stage run time in units */
+static const uint32_t sim_units[SIM_STAGES] = { 4, 10, 12, 6, 8, 5, 15, 4, 2 };
+
+/**********************************************************************
+ * Simulation
+ **********************************************************************/
+struct sim_ctx {
+	uint32_t unit_us;
+	/* stage that returns an error, -1 for none */
+	int fail;
+
+	pthread_mutex_t lock;
+	uint32_t running;
+	uint32_t max_running;
+	bool ran[SIM_STAGES];
+	uint64_t start_us[SIM_STAGES];
+	uint64_t end_us[SIM_STAGES];
+};
+
+static int sim_stage(void *context, uint32_t idx)
+{
+	struct sim_ctx *ctx = context;
+
+	pthread_mutex_lock(&ctx->lock);
+	ctx->ran[idx] = true;
+	ctx->start_us[idx] = (amdgv_tools_now_ns() / 1000);
+	if (++ctx->running > ctx->max_running)
+		ctx->max_running = ctx->running;
+	pthread_mutex_unlock(&ctx->lock);
+
+	usleep(sim_units[idx] * ctx->unit_us);
+
+	pthread_mutex_lock(&ctx->lock);
+	ctx->end_us[idx] = (amdgv_tools_now_ns() / 1000);
+	ctx->running--;
+	pthread_mutex_unlock(&ctx->lock);
+
+	return (int)idx == ctx->fail ? -1 : 0;
+}
+
+/* critical path of the table with the nominal stage times */
+static uint64_t sim_ideal_path_us(struct amdgv_init_sched *sched, uint32_t unit_us)
+{
+	uint64_t path[SIM_STAGES];
+	uint64_t longest = 0;
+	uint32_t i, j;
+
+	for (i = 0; i < SIM_STAGES; i++) {
+		path[i] = 0;
+		for (j = 0; j < i; j++) {
+			if ((sched->stage[i].deps & (1ULL << j)) && path[j] > path[i])
+				path[i] = path[j];
+		}
+		path[i] += (uint64_t)sim_units[i] * unit_us;
+		if (path[i] > longest)
+			longest = path[i];
+	}
+
+	return longest;
+}
+
+static bool sim_depends_on(struct amdgv_init_sched *sched, uint32_t i, uint32_t on)
+{
+	uint32_t j;
+
+	if (sched->stage[i].deps & (1ULL << on))
+		return true;
+
+	for (j = 0; j < i; j++) {
+		if ((sched->stage[i].deps & (1ULL << j)) && sim_depends_on(sched, j, on))
+			return true;
+	}
+
+	return false;
+}
+
+static int sim_run(const char *name, struct amdgv_init_func **table, bool parallel,
+		   bool refuse, int fail, uint32_t unit_us, bool verbose)
+{
+	struct amdgv_init_sched *sched;
+	struct sim_ctx ctx;
+	uint64_t sum_us = 0;
+	uint32_t i, j;
+	int errors = 0;
+	int ret;
+
+	sched = calloc(1, sizeof(*sched));
+	if (!sched)
+		return 1;
+
+	memset(&ctx, 0, sizeof(ctx));
+	pthread_mutex_init(&ctx.lock, NULL);
+	ctx.unit_us = unit_us;
+	ctx.fail = fail;
+
+	if (amdgv_init_sched_build(sched, table, SIM_STAGES)) {
+		fprintf(stderr, "%s: build failed\n", name);
+		free(sched);
+		return 1;
+	}
+	sched->parallel = parallel;
+	sched->run = sim_stage;
+	sched->context = &ctx;
+	sim_refuse_work = refuse;
+
+	ret = amdgv_init_sched_run(sched);
+
+	pthread_mutex_lock(&ctx.lock);
+	if (ctx.running) {
+		fprintf(stderr, "%s: %u stages still running after return\n", name, ctx.running);
+		errors++;
+	}
+	pthread_mutex_unlock(&ctx.lock);
+
+	if ((fail < 0) != (ret == 0) || sched->failed_stage != fail) {
+		fprintf(stderr, "%s: returned %d failed stage %d, expected %d\n", name, ret,
+			sched->failed_stage, fail);
+		errors++;
+	}
+
+	for (i = 0; i < SIM_STAGES; i++) {
+		if (ctx.ran[i] != sched->stage[i].ran) {
+			fprintf(stderr, "%s: %s ran %d, scheduler says %d\n", name, table[i]->name,
+				ctx.ran[i], sched->stage[i].ran);
+			errors++;
+		}
+		if (!ctx.ran[i]) {
+			if (fail < 0) {
+				fprintf(stderr, "%s: %s did not run\n", name, table[i]->name);
+				errors++;
+			}
+			continue;
+		}
+
+		sum_us += ctx.end_us[i] - ctx.start_us[i];
+
+		if (fail >= 0 && (int)i != fail && sim_depends_on(sched, i, fail)) {
+			fprintf(stderr, "%s: %s ran after %s failed\n", name, table[i]->name,
+				table[fail]->name);
+			errors++;
+		}
+
+		for (j = 0; j < SIM_STAGES; j++) {
+			if (!(sched->stage[i].deps & (1ULL << j)))
+				continue;
+			if (!ctx.ran[j] || ctx.end_us[j] > ctx.start_us[i]) {
+				fprintf(stderr, "%s: %s started before %s finished\n", name,
+					table[i]->name, table[j]->name);
+				errors++;
+			}
+		}
+
+		/* in order, each stage starts after the one before it */
+		if ((!parallel || ctx.max_running == 1) && i > 0 &&
+		    ctx.start_us[i] < ctx.end_us[i - 1]) {
+			fprintf(stderr, "%s: %s started before %s finished\n", name,
+				table[i]->name, table[i - 1]->name);
+			errors++;
+		}
+	}
+
+	printf("%-12s %10llu %10llu %10llu %10llu %8u %s\n", name,
+	       (unsigned long long)sched->total_us,
+	       (unsigned long long)sched->critical_path_us,
+	       (unsigned long long)sim_ideal_path_us(sched, unit_us),
+	       (unsigned long long)sum_us, ctx.max_running, errors ? "FAIL" : "ok");
+
+	if (verbose) {
+		for (i = 0; i < SIM_STAGES; i++) {
+			if (!sched->stage[i].ran)
+				continue;
+			printf("  %-12s deps 0x%03llx start %8llu end %8llu\n", table[i]->name,
+			       (unsigned long long)sched->stage[i].deps,
+			       (unsigned long long)sched->stage[i].start_us,
+			       (unsigned long long)sched->stage[i].end_us);
+		}
+	}
+
+	pthread_mutex_destroy(&ctx.lock);
+	free(sched);
+
+	return errors ? 1 : 0;
+}
+
+/* dependency masks amdgv_init_sched_build() derives from the table */
+static int sim_check_build(void)
+{
+	struct amdgv_init_func *table[SIM_STAGES];
+	struct amdgv_init_func bad_psp = sim_psp;
+	struct amdgv_init_sched *sched;
+	int errors = 0;
+	uint32_t i;
+
+	sched = calloc(1, sizeof(*sched));
+	if (!sched)
+		return 1;
+
+	if (amdgv_init_sched_build(sched, sim_table, SIM_STAGES)) {
+		fprintf(stderr, "build: rejected %u stages\n", SIM_STAGES);
+		free(sched);
+		return 1;
+	}
+	for (i = 0; i < SIM_STAGES; i++) {
+		if (sched->stage[i].deps != sim_expected_deps[i]) {
+			fprintf(stderr, "build: %s deps 0x%llx, expected 0x%llx\n",
+				sim_table[i]->name, (unsigned long long)sched->stage[i].deps,
+				(unsigned long long)sim_expected_deps[i]);
+			errors++;
+		}
+	}
+
+	/* a dependency later in the table falls back to table order */
+	memcpy(table, sim_table, sizeof(table));
+	bad_psp.deps = sim_bad_deps;
+	table[6] = &bad_psp;
+	if (amdgv_init_sched_build(sched, table, SIM_STAGES)) {
+		fprintf(stderr, "build: rejected the forward dependency table\n");
+		errors++;
+	} else if (sched->stage[6].deps != 0x3f) {
+		fprintf(stderr, "build: forward dependency gave 0x%llx, expected 0x3f\n",
+			(unsigned long long)sched->stage[6].deps);
+		errors++;
+	}
+
+	if (amdgv_init_sched_build(sched, sim_table, AMDGV_INIT_SCHED_MAX_STAGES + 1) == 0) {
+		fprintf(stderr, "build: accepted more than %u stages\n",
+			AMDGV_INIT_SCHED_MAX_STAGES);
+		errors++;
+	}
+
+	free(sched);
+
+	return errors ? 1 : 0;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [-u unit_us] [-v]\n"
+		"  -u  length of one stage time unit in us (default 1000)\n"
+		"  -v  print the start and end of every stage\n",
+		name);
+}
+
+int main(int argc, char **argv)
+{
+	struct amdgv_init_func plain[SIM_STAGES];
+	struct amdgv_init_func *plain_table[SIM_STAGES];
+	uint32_t unit_us = 1000;
+	bool verbose = false;
+	int opt, ret = 0;
+	uint32_t i;
+
+	while ((opt = getopt(argc, argv, "u:vh")) != -1) {
+		switch (opt) {
+		case 'u':
+			unit_us = strtoul(optarg, NULL, 0);
+			break;
+		case 'v':
+			verbose = true;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (unit_us == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	amdgv_tools_oss.schedule_work = sim_schedule_work;
+
+	/* the same stages without declared dependencies, the old init */
+	for (i = 0; i < SIM_STAGES; i++) {
+		plain[i] = *sim_table[i];
+		plain[i].deps = NULL;
+		plain_table[i] = &plain[i];
+	}
+
+	ret |= sim_check_build();
+
+	printf("%-12s %10s %10s %10s %10s %8s\n", "run", "wall us", "path us", "ideal us",
+	       "sum us", "max par");
+	ret |= sim_run("in order", sim_table, false, false, -1, unit_us, verbose);
+	ret |= sim_run("parallel", sim_table, true, false, -1, unit_us, verbose);
+	ret |= sim_run("no deps", plain_table, true, false, -1, unit_us, verbose);
+	ret |= sim_run("refused", sim_table, true, true, -1, unit_us, verbose);
+	/* mcp fails, psp, smu and late must not run */
+	ret |= sim_run("mcp fails", sim_table, true, false, 1, unit_us, verbose);
+	/* sdma fails while gfx and the psp chain are running */
+	ret |= sim_run("sdma fails", sim_table, true, false, 5, unit_us, verbose);
+
+	return ret;
+}
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* FB memory manager benchmark.
+ *
+ * Replays an allocation trace against a scratch heap of the libgv memory
+ * manager and reports the cost of alloc, alloc_at, free and mem_id lookup
+ * per operation. The trace is the PF driver load reservations, retired
+ * pages scattered over the upper half of the heap, then VFs created and
+ * destroyed in random order. At the end the allocation list, treap and
+ * mem_id hash are checked against each other.
+ *
+ * Allocations go through amdgv_memmgr_alloc_align(), _alloc_align_at() and
+ * _free() like in the driver, so the cost includes the mem_id bookkeeping
+ * and the memmgr lock.
+ */
+
+/* libgv has its own fixed width types, keep the glibc ones out */
+#include "amdgv_basetypes.h"
+#define _BITS_STDINT_INTN_H
+#define _BITS_STDINT_UINTN_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_memmgr.h"
+#include "amdgv_tools_oss.h"
+
+/**********************************************************************
+ * libgv environment
+ **********************************************************************/
+/* the scratch heap has no GART and is never exported */
+void amdgv_gart_map(struct amdgv_adapter *adapt, uint64_t offset, int pages,
+		    uint64_t dma_addr)
+{
+}
+
+int amdgv_wb_memory_hw_init_address(struct amdgv_adapter *adapt)
+{
+	return 0;
+}
+
+/**********************************************************************
+ * Benchmark
+ **********************************************************************/
+
+/*
+ * The init part mirrors what the PF driver reserves at load, the per VF
+ * part what is reserved and released again when VFs are created and
+ * destroyed.
+ */
+struct bench_op {
+	enum amdgv_mem_id id;
+	uint32_t len_kb;
+	uint32_t align_kb;
+};
+
+static const struct bench_op bench_init_trace[] = {
+	{ MEM_PSP_RING, 4, 4 },
+	{ MEM_PSP_FENCE, 4, 4 },
+	{ MEM_PSP_PRIVATE, 1024, 1024 },
+	{ MEM_PSP_TMR, 4096, 1024 },
+	{ MEM_PSP_RAS, 64, 4 },
+	{ MEM_PSP_XGMI, 64, 4 },
+	{ MEM_PSP_DUMMY, 4, 4 },
+	{ MEM_PSP_CMD_BUF_0, 4, 4 },
+	{ MEM_PSP_CMD_BUF_1, 4, 4 },
+	{ MEM_PSP_CMD_BUF_2, 4, 4 },
+	{ MEM_PSP_CMD_BUF_3, 4, 4 },
+	{ MEM_SMC_PPTABLE, 16, 4 },
+	{ MEM_SMC_WATERMARK_TABLE, 4, 4 },
+	{ MEM_SMC_METRICS_TABLE, 8, 4 },
+	{ MEM_SMU_CONFIG_TABLE, 4, 4 },
+	{ MEM_SMC_I2C_TABLE, 4, 4 },
+	{ MEM_SMC_ACTIVITY_TABLE, 4, 4 },
+	{ MEM_SMC_PM_STATUS_TABLE, 4, 4 },
+	{ MEM_IRQMGR_IH_RING, 256, 4 },
+	{ MEM_MMSCH_CMD_BUFFER, 64, 4 },
+	{ MEM_MMSCH_BW_CFG, 4, 4 },
+	{ MEM_GFX_WB, 4, 4 },
+	{ MEM_GFX_EOP, 8, 8 },
+	{ MEM_KIQ_RING, 64, 4 },
+	{ MEM_KIQ_MQD, 4, 4 },
+	{ MEM_SDMA0_RING, 64, 4 },
+	{ MEM_SDMA0_MQD, 4, 4 },
+	{ MEM_GFX_IB, 64, 4 },
+};
+
+static const struct bench_op bench_vf_trace[] = {
+	{ MEM_GPUIOV_CSA, 64, 64 },
+	{ MEM_GPUIOV_SCHED_LOG, 4, 4 },
+	{ MEM_GPUIOV_SCHED_CFG_DESC, 4, 4 },
+	{ MEM_COMPUTE0_MQD, 4, 4 },
+	{ MEM_COMPUTE0_RING, 64, 4 },
+	{ MEM_MIGRATION_PSP_STATIC_DATA, 128, 4 },
+	{ MEM_MIGRATION_PSP_DYNAMIC_DATA, 512, 4 },
+};
+
+#define BENCH_INIT_NUM	ARRAY_SIZE(bench_init_trace)
+#define BENCH_VF_OPS	ARRAY_SIZE(bench_vf_trace)
+#define BENCH_HEAP_SIZE	(0x1ULL << 36)
+#define BENCH_SEED	0x9E3779B9
+#define BENCH_SLOTS(bad_pages) \
+	(BENCH_INIT_NUM + (bad_pages) + AMDGV_MAX_VF_NUM * BENCH_VF_OPS)
+
+struct bench_stat {
+	uint64_t ops;
+	uint64_t ns;
+};
+
+static struct amdgv_adapter bench_adapt;
+static uint32_t bench_seed = BENCH_SEED;
+
+/* xorshift32, runs must not depend on the libc generator */
+static uint32_t bench_rand(void)
+{
+	uint32_t x = bench_seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	bench_seed = x;
+
+	return x;
+}
+
+static struct amdgv_memmgr_mem *bench_mem_alloc(struct amdgv_memmgr *memmgr,
+						const struct bench_op *op)
+{
+	return amdgv_memmgr_alloc_align(memmgr, (uint64_t)op->len_kb << 10,
+					(uint64_t)op->align_kb << 10, op->id);
+}
+
+/* Walk the list and make sure treap and hash still agree with it */
+static int bench_check(struct amdgv_memmgr *memmgr, uint32_t live)
+{
+	struct amdgv_list_head *head = &memmgr->allocs->node;
+	struct amdgv_memmgr_mem *alloc;
+	uint64_t end = memmgr->offset;
+	uint32_t count = 0;
+
+	amdgv_list_for_each_entry(alloc, head, struct amdgv_memmgr_mem, node) {
+		if (alloc->alloc_off - alloc->len < end ||
+		    amdgv_memmgr_find_id(memmgr, alloc->id) != alloc)
+			return 1;
+		end = alloc->alloc_off;
+		count++;
+	}
+
+	if (count != live || (memmgr->root && memmgr->root->max_gap != MEMMGR_GAP_UNBOUND))
+		return 1;
+
+	return 0;
+}
+
+static void bench_report(const char *name, struct bench_stat *stat)
+{
+	printf("%-8s %10llu %12.1f\n", name, (unsigned long long)stat->ops,
+	       stat->ops ? (double)stat->ns / stat->ops : 0.0);
+}
+
+static int bench_run(uint32_t rounds, uint32_t bad_pages)
+{
+	struct bench_stat alloc_stat = { 0 }, at_stat = { 0 };
+	struct bench_stat free_stat = { 0 }, lookup_stat = { 0 };
+	struct amdgv_memmgr_mem **slots;
+	struct amdgv_memmgr_mem *mem;
+	struct amdgv_memmgr memmgr = { 0 };
+	uint32_t num_slots = BENCH_SLOTS(bad_pages);
+	uint32_t i, j, vf, round, live = 0, bad = 0;
+	uint64_t start, offset;
+	int ret = 1;
+
+	slots = calloc(num_slots, sizeof(struct amdgv_memmgr_mem *));
+	if (!slots) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	if (amdgv_memmgr_init(&bench_adapt, &memmgr, 0, BENCH_HEAP_SIZE, 0, false)) {
+		free(slots);
+		return 1;
+	}
+
+	/* driver load */
+	start = amdgv_tools_now_ns();
+	for (i = 0; i < BENCH_INIT_NUM; i++) {
+		slots[i] = bench_mem_alloc(&memmgr, &bench_init_trace[i]);
+		if (!slots[i])
+			goto fini;
+		live++;
+	}
+	alloc_stat.ns += amdgv_tools_now_ns() - start;
+	alloc_stat.ops += BENCH_INIT_NUM;
+
+	/* retired pages scattered over the upper half of the heap */
+	start = amdgv_tools_now_ns();
+	for (i = 0; i < bad_pages; i++) {
+		offset = bench_rand() % (BENCH_HEAP_SIZE >> (AMDGV_GPU_PAGE_SHIFT + 1));
+		offset = (BENCH_HEAP_SIZE >> 1) + (offset << AMDGV_GPU_PAGE_SHIFT);
+		mem = amdgv_memmgr_alloc_align_at(&memmgr, offset, AMDGV_GPU_PAGE_SIZE,
+						  MEM_ECC_BAD_PAGE);
+		/* page already retired */
+		if (!mem)
+			continue;
+		slots[BENCH_INIT_NUM + i] = mem;
+		live++;
+		bad++;
+	}
+	at_stat.ns += amdgv_tools_now_ns() - start;
+	at_stat.ops += bad_pages;
+
+	/* VFs get created and destroyed in random order */
+	for (round = 0; round < rounds; round++) {
+		vf = bench_rand() % AMDGV_MAX_VF_NUM;
+		j = BENCH_INIT_NUM + bad_pages + vf * BENCH_VF_OPS;
+
+		if (slots[j]) {
+			start = amdgv_tools_now_ns();
+			for (i = 0; i < BENCH_VF_OPS; i++) {
+				amdgv_memmgr_free(slots[j + i]);
+				slots[j + i] = NULL;
+			}
+			free_stat.ns += amdgv_tools_now_ns() - start;
+			free_stat.ops += BENCH_VF_OPS;
+			live -= BENCH_VF_OPS;
+		} else {
+			start = amdgv_tools_now_ns();
+			for (i = 0; i < BENCH_VF_OPS; i++) {
+				slots[j + i] = bench_mem_alloc(&memmgr, &bench_vf_trace[i]);
+				if (!slots[j + i])
+					goto fini;
+				live++;
+			}
+			alloc_stat.ns += amdgv_tools_now_ns() - start;
+			alloc_stat.ops += BENCH_VF_OPS;
+		}
+
+		/* live update looks up every allocation by id */
+		start = amdgv_tools_now_ns();
+		for (i = 0; i < num_slots; i++) {
+			if (slots[i] && amdgv_memmgr_find_id(&memmgr, slots[i]->id) != slots[i])
+				goto fini;
+		}
+		lookup_stat.ns += amdgv_tools_now_ns() - start;
+		lookup_stat.ops += live;
+	}
+
+	ret = bench_check(&memmgr, live);
+
+fini:
+	for (i = 0; i < num_slots; i++) {
+		if (slots[i])
+			amdgv_memmgr_free(slots[i]);
+	}
+	amdgv_memmgr_fini(&bench_adapt, &memmgr);
+	free(slots);
+
+	printf("%u rounds, %u bad pages, %u allocs live at end, %s\n", rounds, bad, live,
+	       ret ? "FAILED" : "passed");
+	printf("%-8s %10s %12s\n", "op", "count", "ns/op");
+	bench_report("alloc", &alloc_stat);
+	bench_report("alloc_at", &at_stat);
+	bench_report("free", &free_stat);
+	bench_report("lookup", &lookup_stat);
+
+	return ret;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [-n rounds] [-b bad_pages] [-r seed]\n"
+		"  -n  VF create/destroy rounds (default 100000)\n"
+		"  -b  retired pages placed before the rounds (default 192, at most %u)\n"
+		"  -r  random seed (default 0x%x)\n",
+		name, MAX_MEM_COUNT, BENCH_SEED);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t rounds = 100000;
+	uint32_t bad_pages = 192;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:b:r:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			rounds = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			bad_pages = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			bench_seed = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (rounds == 0 || bench_seed == 0 || bad_pages > MAX_MEM_COUNT) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	return bench_run(rounds, bad_pages);
+}
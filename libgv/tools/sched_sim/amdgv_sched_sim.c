@@ -0,0 +1,736 @@
+/*
+ * Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Offline world switch simulator.
+ *
+ * Links the scheduling policies of amdgv_sched_policy.c into a userspace
+ * program and drives them with synthetic (or recorded) VF workloads on a
+ * virtual clock. The switch thread of amdgv_sched_switch.c is modelled by
+ * sim_process(): save the current VF, rotate it to the list tail, ask the
+ * policy for the next VF and time slice, load it and arm the timer. Save
+ * and load cost a configurable world switch overhead. Hybrid liquid mode
+ * additionally switches out a VF when its work is done (context empty),
+ * honouring hliquid_min_ts.
+ *
+ * Output is the per-VF achieved GPU share, the scheduling latency of jobs
+ * (arrival to first run) and the number of world switches. The run is
+ * fully deterministic for a given set of options and seed.
+ */
+
+/* libgv has its own fixed width types, keep the glibc ones out */
+#include "amdgv_basetypes.h"
+#define _BITS_STDINT_INTN_H
+#define _BITS_STDINT_UINTN_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <math.h>
+
+#include "amdgv_device.h"
+#include "amdgv_oss_wrapper.h"
+#include "amdgv_sched_internal.h"
+#include "amdgv_list.h"
+#include "amdgv_tools_oss.h"
+
+#define SIM_MAX_VF		AMDGV_MAX_VF_NUM
+#define SIM_NO_EVENT		(~0ULL)
+#define SIM_MAX_TRACE_JOBS	(1 << 20)
+
+struct sim_job {
+	uint64_t arrival;
+	uint64_t work;
+};
+
+struct sim_vf {
+	/* workload: generated jobs (mean size and mean gap between arrivals)
+	 * or a trace sorted by arrival
+	 */
+	uint64_t mean_work;
+	uint64_t mean_gap;
+	struct sim_job *trace;
+	uint64_t trace_num;
+	uint64_t trace_cap;
+	uint64_t trace_next;
+	uint64_t next_arrival;
+	uint64_t next_work;
+
+	/* queued jobs not yet started, and remaining work of all jobs */
+	struct sim_job *pending;
+	uint64_t pending_num;
+	uint64_t pending_cap;
+	uint64_t backlog;
+
+	/* statistics */
+	uint64_t loaded_time;
+	uint64_t run_time;
+	uint64_t switches;
+	uint64_t jobs;
+	uint64_t *latency;
+	uint64_t latency_num;
+	uint64_t latency_cap;
+};
+
+struct sim {
+	struct amdgv_adapter *adapt;
+	struct amdgv_sched_world_switch *world_switch;
+	amdgv_sched_policy_func policy;
+	enum amdgv_sched_mode mode;
+
+	uint32_t num_vf;
+	uint32_t num_active;
+	uint64_t time_slice[SIM_MAX_VF];
+	uint64_t overhead;
+	uint64_t duration;
+	uint64_t seed;
+
+	uint64_t now;
+	uint64_t timer;
+	bool loaded;
+	uint32_t curr;
+	uint64_t switches;
+	uint64_t overhead_time;
+	uint64_t pf_time;
+
+	struct sim_vf vf[SIM_MAX_VF];
+};
+
+/**********************************************************************
+ * libgv environment
+ **********************************************************************/
+const char *amdgv_idx_to_str(uint32_t idx)
+{
+	static char str[8];
+
+	if (idx == AMDGV_PF_IDX)
+		return "PF";
+
+	snprintf(str, sizeof(str), "VF%u", idx);
+	return str;
+}
+
+/**********************************************************************
+ * Workload
+ **********************************************************************/
+/* xorshift64*, the simulation must not depend on the libc generator */
+static uint64_t sim_rand(struct sim *sim)
+{
+	sim->seed ^= sim->seed >> 12;
+	sim->seed ^= sim->seed << 25;
+	sim->seed ^= sim->seed >> 27;
+	return sim->seed * 2685821657736338717ULL;
+}
+
+static uint64_t sim_rand_exp(struct sim *sim, uint64_t mean)
+{
+	double u = ((sim_rand(sim) >> 11) + 1) * (1.0 / 9007199254740993.0);
+
+	if (mean == 0)
+		return 0;
+
+	return (uint64_t)(-log(u) * mean) + 1;
+}
+
+/* pick the arrival time and size of the next job of a VF */
+static void sim_next_job(struct sim *sim, struct sim_vf *vf, uint64_t from)
+{
+	struct sim_job *job;
+
+	if (vf->trace) {
+		if (vf->trace_next == vf->trace_num) {
+			vf->next_arrival = SIM_NO_EVENT;
+			return;
+		}
+		job = &vf->trace[vf->trace_next++];
+		vf->next_arrival = job->arrival;
+		vf->next_work = job->work;
+		return;
+	}
+
+	if (vf->mean_work == 0) {
+		vf->next_arrival = SIM_NO_EVENT;
+		return;
+	}
+
+	vf->next_arrival = from + sim_rand_exp(sim, vf->mean_gap);
+	vf->next_work = sim_rand_exp(sim, vf->mean_work);
+}
+
+static void sim_push(void **array, uint64_t *num, uint64_t *cap, size_t size)
+{
+	if (*num < *cap)
+		return;
+
+	*cap = *cap ? *cap * 2 : 64;
+	*array = realloc(*array, *cap * size);
+	if (*array == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+}
+
+static void sim_arrive(struct sim *sim, uint32_t idx)
+{
+	struct sim_vf *vf = &sim->vf[idx];
+
+	sim_push((void **)&vf->pending, &vf->pending_num, &vf->pending_cap,
+		 sizeof(*vf->pending));
+	vf->pending[vf->pending_num].arrival = vf->next_arrival;
+	vf->pending[vf->pending_num].work = vf->next_work;
+	vf->pending_num++;
+	vf->backlog += vf->next_work;
+	vf->jobs++;
+
+	sim->world_switch->vf_busy_status |= 1 << idx;
+
+	sim_next_job(sim, vf, vf->next_arrival);
+}
+
+/* the loaded VF starts on its queued jobs, record their wait */
+static void sim_start_pending(struct sim *sim, uint32_t idx)
+{
+	struct sim_vf *vf = &sim->vf[idx];
+	uint64_t i;
+
+	for (i = 0; i < vf->pending_num; i++) {
+		sim_push((void **)&vf->latency, &vf->latency_num, &vf->latency_cap,
+			 sizeof(*vf->latency));
+		vf->latency[vf->latency_num++] = sim->now - vf->pending[i].arrival;
+	}
+	vf->pending_num = 0;
+}
+
+/**********************************************************************
+ * World switch model
+ **********************************************************************/
+static void sim_init_world_switch(struct sim *sim)
+{
+	struct amdgv_adapter *adapt = sim->adapt;
+	struct amdgv_sched_world_switch *world_switch = sim->world_switch;
+	struct amdgv_sched_active_vf_entry *entry;
+	uint32_t i;
+
+	world_switch->sched_block = AMDGV_SCHED_BLOCK_GFX;
+	world_switch->sched_mode = sim->mode;
+	world_switch->manual.adapt = adapt;
+	world_switch->manual.fairness_mode = sim->mode == AMDGV_SCHED_FAIRNESS;
+	AMDGV_INIT_LIST_HEAD(&world_switch->manual.active_vf_list);
+
+	for (i = 0; i < AMDGV_MAX_VF_SLOT; i++) {
+		entry = &world_switch->manual.array_vf[i];
+		AMDGV_INIT_LIST_HEAD(&entry->list);
+		entry->idx_vf = i;
+		entry->vt_heap_pos = AMDGV_SCHED_VT_NOT_QUEUED;
+	}
+
+	/* PF is not part of the rotation, it only backs dummy VFs */
+	entry = &world_switch->manual.array_vf[AMDGV_PF_IDX];
+	entry->time_slice = DEFAULT_GFX_TIME_SLICE;
+
+	for (i = 0; i < sim->num_vf; i++) {
+		entry = &world_switch->manual.array_vf[i];
+		entry->time_slice = sim->time_slice[i];
+
+		/* fairness mode keeps every configured VF in the list, the ones
+		 * not started by a guest are dummies that hand their slice to
+		 * the PF. The other modes only list the active VFs.
+		 */
+		if (i < sim->num_active) {
+			adapt->sched.array_vf[i].state = AMDGV_SCHED_ACTIVE;
+			world_switch->vf_inited |= 1 << i;
+			entry->dummy_vf = false;
+		} else if (world_switch->manual.fairness_mode) {
+			entry->dummy_vf = true;
+			entry->time_slice = DEFAULT_GFX_TIME_SLICE;
+		} else {
+			continue;
+		}
+
+		amdgv_list_add_tail(&entry->list, &world_switch->manual.active_vf_list);
+		amdgv_sched_vt_enqueue(world_switch, entry);
+	}
+}
+
+static void sim_save(struct sim *sim)
+{
+	struct amdgv_adapter *adapt = sim->adapt;
+	struct amdgv_sched_world_switch *world_switch = sim->world_switch;
+	struct amdgv_sched_active_vf_entry *entry = &world_switch->manual.array_vf[sim->curr];
+
+	sim->now += sim->overhead / 2;
+	sim->overhead_time += sim->overhead / 2;
+
+	/* time is recorded after the save, like amdgv_sched_stop_record_vf_time */
+	if (entry->start_ts) {
+		if (sim->curr == AMDGV_PF_IDX)
+			sim->pf_time += sim->now - entry->start_ts;
+		else
+			sim->vf[sim->curr].loaded_time += sim->now - entry->start_ts;
+		amdgv_sched_policy_account(adapt, entry, sim->now);
+	}
+
+	sim->loaded = false;
+	if (sim->curr != AMDGV_PF_IDX)
+		amdgv_list_move_tail(&entry->list, &world_switch->manual.active_vf_list);
+}
+
+static void sim_load(struct sim *sim, uint32_t idx, uint64_t time_slice)
+{
+	struct amdgv_sched_world_switch *world_switch = sim->world_switch;
+
+	sim->now += sim->overhead - sim->overhead / 2;
+	sim->overhead_time += sim->overhead - sim->overhead / 2;
+
+	if (world_switch->sched_mode == AMDGV_SCHED_HYBRID_LIQUID_MODE)
+		world_switch->vf_timeout &= ~(1 << idx);
+
+	world_switch->manual.array_vf[idx].start_ts = sim->now;
+	world_switch->curr_idx_vf = idx;
+	sim->curr = idx;
+	sim->loaded = true;
+	sim->switches++;
+
+	if (idx != AMDGV_PF_IDX) {
+		sim->vf[idx].switches++;
+		sim_start_pending(sim, idx);
+	}
+
+	sim->timer = time_slice == DEFAULT_GFX_TIME_SLICE_1VF ? SIM_NO_EVENT :
+								 sim->now + time_slice;
+}
+
+/* mirror of amdgv_sched_manual_switch_process() */
+static void sim_process(struct sim *sim)
+{
+	struct amdgv_sched_world_switch *world_switch = sim->world_switch;
+	struct amdgv_sched_active_vf_entry *entry;
+	uint32_t vf_status;
+	int64_t left_ts = 0;
+	uint64_t time_slice;
+	int idx_vf;
+
+	if (amdgv_list_empty(&world_switch->manual.active_vf_list))
+		return;
+
+	if (world_switch->sched_mode == AMDGV_SCHED_HYBRID_LIQUID_MODE && sim->loaded) {
+		if (sim->num_active == 1)
+			return;
+
+		vf_status = world_switch->vf_busy_status | world_switch->vf_timeout;
+		entry = &world_switch->manual.array_vf[sim->curr];
+
+		if (world_switch->hliquid_min_ts)
+			left_ts = world_switch->hliquid_min_ts - (sim->now - entry->start_ts);
+		else if (!vf_status)
+			left_ts = HLIQUID_ALL_VF_IDLE_MIN_TS - (sim->now - entry->start_ts);
+
+		if (left_ts > 0) {
+			sim->timer = sim->now + left_ts;
+			return;
+		}
+	}
+
+	if (sim->loaded) {
+		sim_save(sim);
+	} else {
+		entry = amdgv_list_last_entry(&world_switch->manual.active_vf_list,
+					      struct amdgv_sched_active_vf_entry, list);
+		if (entry->dummy_vf && world_switch->manual.fairness_mode && entry->start_ts)
+			amdgv_sched_policy_account(sim->adapt, entry, sim->now);
+	}
+
+	/* a dummy VF in fairness mode comes back as the PF with its slice */
+	if (sim->policy(world_switch, &world_switch->manual.active_vf_list, &idx_vf, &time_slice))
+		return;
+
+	sim_load(sim, idx_vf, time_slice);
+}
+
+/* advance the clock to t, the loaded VF burns its backlog meanwhile */
+static void sim_advance(struct sim *sim, uint64_t t)
+{
+	struct sim_vf *vf;
+	uint64_t run;
+
+	if (t <= sim->now)
+		return;
+
+	if (sim->loaded && sim->curr != AMDGV_PF_IDX) {
+		vf = &sim->vf[sim->curr];
+		run = t - sim->now;
+		if (run > vf->backlog)
+			run = vf->backlog;
+		vf->backlog -= run;
+		vf->run_time += run;
+	}
+	sim->now = t;
+}
+
+static void sim_run(struct sim *sim)
+{
+	struct amdgv_sched_world_switch *world_switch = sim->world_switch;
+	uint64_t next, done;
+	uint32_t i, arrival;
+	bool ctx_empty;
+
+	for (i = 0; i < sim->num_active; i++)
+		sim_next_job(sim, &sim->vf[i], 0);
+
+	sim->timer = SIM_NO_EVENT;
+	sim_process(sim);
+
+	while (sim->now < sim->duration) {
+		/* the earliest of: timer, job arrival, loaded VF running dry */
+		next = sim->timer;
+		arrival = SIM_MAX_VF;
+		for (i = 0; i < sim->num_active; i++) {
+			if (sim->vf[i].next_arrival < next) {
+				next = sim->vf[i].next_arrival;
+				arrival = i;
+			}
+		}
+
+		done = SIM_NO_EVENT;
+		if (sim->loaded && sim->curr != AMDGV_PF_IDX && sim->vf[sim->curr].backlog)
+			done = sim->now + sim->vf[sim->curr].backlog;
+
+		ctx_empty = done < next;
+		if (ctx_empty)
+			next = done;
+		if (next > sim->duration)
+			next = sim->duration;
+
+		sim_advance(sim, next);
+		if (sim->now >= sim->duration)
+			break;
+
+		if (ctx_empty) {
+			world_switch->vf_busy_status &= ~(1 << sim->curr);
+			/* only hybrid liquid reacts to the context empty interrupt */
+			if (sim->mode == AMDGV_SCHED_HYBRID_LIQUID_MODE)
+				sim_process(sim);
+			continue;
+		}
+
+		if (arrival != SIM_MAX_VF) {
+			sim_arrive(sim, arrival);
+			if (sim->loaded && sim->curr == arrival)
+				sim_start_pending(sim, arrival);
+			continue;
+		}
+
+		/* timer expired */
+		sim->timer = SIM_NO_EVENT;
+		if (sim->mode == AMDGV_SCHED_HYBRID_LIQUID_MODE && sim->loaded)
+			world_switch->vf_timeout |= 1 << sim->curr;
+		sim_process(sim);
+	}
+
+	if (sim->loaded && sim->curr != AMDGV_PF_IDX)
+		sim->vf[sim->curr].loaded_time += sim->now -
+			world_switch->manual.array_vf[sim->curr].start_ts;
+}
+
+/**********************************************************************
+ * Report
+ **********************************************************************/
+static int sim_cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static uint64_t sim_percentile(struct sim_vf *vf, uint32_t pct)
+{
+	if (vf->latency_num == 0)
+		return 0;
+
+	return vf->latency[(vf->latency_num - 1) * pct / 100];
+}
+
+static const char *sim_mode_name(enum amdgv_sched_mode mode)
+{
+	switch (mode) {
+	case AMDGV_SCHED_FAIRNESS:
+		return "fairness";
+	case AMDGV_SCHED_ROUND_ROBIN:
+		return "round robin";
+	case AMDGV_SCHED_HYBRID_LIQUID_MODE:
+		return "hybrid liquid";
+	case AMDGV_SCHED_VIRTUAL_TIME_MODE:
+		return "virtual time";
+	default:
+		return "unknown";
+	}
+}
+
+static void sim_report(struct sim *sim)
+{
+	struct sim_vf *vf;
+	uint64_t demand;
+	uint32_t i;
+
+	printf("mode %s, %u VFs (%u active), overhead %lluus, hliquid_min_ts %uus, %llums\n",
+	       sim_mode_name(sim->mode), sim->num_vf, sim->num_active,
+	       (unsigned long long)sim->overhead, sim->world_switch->hliquid_min_ts,
+	       (unsigned long long)sim->duration / 1000);
+	printf("%-4s %9s %8s %8s %8s %8s %9s %9s %9s %9s %9s\n", "VF", "slice(us)", "loaded%",
+	       "share%", "demand%", "jobs", "p50(us)", "p90(us)", "p99(us)", "max(us)",
+	       "switches");
+
+	for (i = 0; i < sim->num_active; i++) {
+		vf = &sim->vf[i];
+		qsort(vf->latency, vf->latency_num, sizeof(*vf->latency), sim_cmp_u64);
+		/* offered load, above 100% the VF never runs dry */
+		demand = vf->mean_gap ? 100 * vf->mean_work / vf->mean_gap : 0;
+
+		printf("%-4u %9llu %8.2f %8.2f %8llu %8llu %9llu %9llu %9llu %9llu %9llu\n", i,
+		       (unsigned long long)sim->time_slice[i],
+		       100.0 * vf->loaded_time / sim->now, 100.0 * vf->run_time / sim->now,
+		       (unsigned long long)(vf->trace ? 0 : demand),
+		       (unsigned long long)vf->jobs,
+		       (unsigned long long)sim_percentile(vf, 50),
+		       (unsigned long long)sim_percentile(vf, 90),
+		       (unsigned long long)sim_percentile(vf, 99),
+		       (unsigned long long)sim_percentile(vf, 100),
+		       (unsigned long long)vf->switches);
+	}
+
+	printf("world switches %llu, overhead %.2f%%, PF %.2f%%\n",
+	       (unsigned long long)sim->switches, 100.0 * sim->overhead_time / sim->now,
+	       100.0 * sim->pf_time / sim->now);
+}
+
+/**********************************************************************
+ * Options
+ **********************************************************************/
+static void sim_usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -m mode       3 fairness, 4 round robin, 5 hybrid liquid, 6 virtual time (4)\n"
+		"  -n num_vf     configured VFs (4)\n"
+		"  -a active     VFs started by a guest, the rest are idle (num_vf)\n"
+		"  -s ts[,ts..]  time slice per VF in us, last value repeats (%u)\n"
+		"  -w w:g[,w:g]  mean job size and mean gap between job arrivals per VF\n"
+		"                in us, last value repeats (5000:20000)\n"
+		"  -t file       job trace, one \"<vf> <arrival_us> <work_us>\" per line,\n"
+		"                replaces the generated load\n"
+		"  -o overhead   world switch cost in us, save plus load (300)\n"
+		"  -l min_ts     hliquid_min_ts in us (0)\n"
+		"  -d duration   simulated time in ms (10000)\n"
+		"  -r seed       random seed (1)\n",
+		name, DEFAULT_GFX_TIME_SLICE);
+}
+
+static int sim_parse_list(const char *arg, uint64_t *a, uint64_t *b, uint32_t num)
+{
+	char *end = NULL;
+	uint32_t i = 0;
+
+	while (i < num) {
+		a[i] = strtoull(arg, &end, 0);
+		if (end == arg)
+			return -1;
+		if (b) {
+			if (*end != ':')
+				return -1;
+			arg = end + 1;
+			b[i] = strtoull(arg, &end, 0);
+			if (end == arg)
+				return -1;
+		}
+		i++;
+		if (*end != ',')
+			break;
+		arg = end + 1;
+	}
+	if (end == NULL || (*end != '\0' && *end != ','))
+		return -1;
+
+	/* the last value applies to the remaining VFs */
+	for (; i && i < num; i++) {
+		a[i] = a[i - 1];
+		if (b)
+			b[i] = b[i - 1];
+	}
+
+	return 0;
+}
+
+static int sim_load_trace(struct sim *sim, const char *path)
+{
+	struct sim_vf *vf;
+	struct sim_job job;
+	unsigned long long arrival, work;
+	unsigned int idx;
+	FILE *file;
+	char line[256];
+	uint64_t i;
+	uint32_t n = 0;
+
+	file = fopen(path, "r");
+	if (file == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), file)) {
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+		if (sscanf(line, "%u %llu %llu", &idx, &arrival, &work) != 3 ||
+		    idx >= sim->num_active || ++n > SIM_MAX_TRACE_JOBS) {
+			fprintf(stderr, "%s: bad trace line: %s", path, line);
+			fclose(file);
+			return -1;
+		}
+
+		vf = &sim->vf[idx];
+		sim_push((void **)&vf->trace, &vf->trace_num, &vf->trace_cap, sizeof(*vf->trace));
+		vf->trace[vf->trace_num].arrival = arrival;
+		vf->trace[vf->trace_num].work = work;
+		vf->trace_num++;
+		/* keep it sorted by arrival, traces are mostly ordered already */
+		for (i = vf->trace_num - 1; i && vf->trace[i - 1].arrival > arrival; i--) {
+			job = vf->trace[i];
+			vf->trace[i] = vf->trace[i - 1];
+			vf->trace[i - 1] = job;
+		}
+	}
+	fclose(file);
+
+	/* a VF without jobs in the trace stays idle */
+	for (i = 0; i < sim->num_active; i++) {
+		vf = &sim->vf[i];
+		vf->mean_work = 0;
+		vf->mean_gap = 0;
+		if (vf->trace == NULL)
+			vf->trace = calloc(1, sizeof(*vf->trace));
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	static struct sim sim;
+	uint64_t work[SIM_MAX_VF], gap[SIM_MAX_VF];
+	const char *ts_arg = NULL, *load_arg = NULL, *trace = NULL;
+	uint64_t min_ts = 0;
+	uint32_t i;
+	int opt;
+
+	sim.mode = AMDGV_SCHED_ROUND_ROBIN;
+	sim.num_vf = 4;
+	sim.num_active = SIM_MAX_VF + 1;
+	sim.overhead = 300;
+	sim.duration = 10000;
+	sim.seed = 1;
+
+	while ((opt = getopt(argc, argv, "m:n:a:s:w:t:o:l:d:r:h")) != -1) {
+		switch (opt) {
+		case 'm':
+			sim.mode = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			sim.num_vf = strtoul(optarg, NULL, 0);
+			break;
+		case 'a':
+			sim.num_active = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			ts_arg = optarg;
+			break;
+		case 'w':
+			load_arg = optarg;
+			break;
+		case 't':
+			trace = optarg;
+			break;
+		case 'o':
+			sim.overhead = strtoull(optarg, NULL, 0);
+			break;
+		case 'l':
+			min_ts = strtoull(optarg, NULL, 0);
+			break;
+		case 'd':
+			sim.duration = strtoull(optarg, NULL, 0);
+			break;
+		case 'r':
+			sim.seed = strtoull(optarg, NULL, 0) | 1;
+			break;
+		default:
+			sim_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (sim.mode <= AMDGV_SCHED_MAX_HW_SCHED_MODE || sim.mode > AMDGV_SCHED_MAX_SW_SCHED_MODE ||
+	    sim.num_vf == 0 || sim.num_vf > SIM_MAX_VF) {
+		sim_usage(argv[0]);
+		return 1;
+	}
+	if (sim.num_active > sim.num_vf)
+		sim.num_active = sim.num_vf;
+	sim.duration *= 1000;
+
+	sim.time_slice[0] = DEFAULT_GFX_TIME_SLICE;
+	work[0] = 5000;
+	gap[0] = 20000;
+	if ((ts_arg && sim_parse_list(ts_arg, sim.time_slice, NULL, sim.num_vf)) ||
+	    (load_arg && sim_parse_list(load_arg, work, gap, sim.num_vf))) {
+		sim_usage(argv[0]);
+		return 1;
+	}
+	for (i = 1; !ts_arg && i < sim.num_vf; i++)
+		sim.time_slice[i] = sim.time_slice[0];
+	for (i = 0; i < sim.num_vf; i++) {
+		if (!load_arg) {
+			work[i] = work[0];
+			gap[i] = gap[0];
+		}
+		sim.vf[i].mean_work = work[i];
+		sim.vf[i].mean_gap = gap[i];
+	}
+
+	sim.adapt = calloc(1, sizeof(*sim.adapt));
+	if (sim.adapt == NULL)
+		return 1;
+	sim.adapt->num_vf = sim.num_vf;
+	sim.adapt->max_num_vf = sim.num_vf;
+	sim.adapt->bp_mode = AMDGV_BP_MODE_DISABLE;
+	sim.world_switch = &sim.adapt->sched.world_switch[0];
+	sim.world_switch->hliquid_min_ts = min_ts;
+
+	if (trace && sim_load_trace(&sim, trace))
+		return 1;
+
+	sim.policy = amdgv_sched_policy_select(sim.adapt, sim.mode);
+	sim_init_world_switch(&sim);
+	sim_run(&sim);
+	sim_report(&sim);
+
+	return 0;
+}
@@ -39,6 +39,7 @@ EXAMPLES_DIR          := $(PROJECT_ROOT)/examples
 TEST_DIR              := $(PROJECT_ROOT)/tests
 TEST_UNIT_DIR         := $(TEST_DIR)/unit
 TEST_INTEGRATION_DIR  := $(TEST_DIR)/integration
+TEST_BENCHMARK_DIR    := $(TEST_DIR)/benchmark
 PY_DIR                := $(PROJECT_ROOT)/py
 PY_INTERFACE_DIR      := $(PY_DIR)/interface
 
@@ -551,6 +551,129 @@ int smi_get_gpu_cache_info(struct smi_ctx *ctx, void *inb,
 	return smi_convert_ret_value(ERROR_OTHER, ret);
 }
 
+static uint32_t smi_histogram_p99(struct amdgv_histogram *hist, uint32_t max)
+{
+	uint64_t need, seen = 0;
+	int i;
+
+	if (hist->total == 0)
+		return 0;
+
+	need = hist->total - hist->total / 100;
+	for (i = 0; i < AMDGV_HISTOGRAM_SIZE - 1; i++) {
+		seen += hist->count[i];
+		if (seen >= need)
+			return hist->range[i] < max ? hist->range[i] : max;
+	}
+
+	return max;
+}
+
+int smi_get_sched_event_stats(struct smi_ctx *ctx, void *inb,
+				void *outb, uint16_t in_len, uint16_t out_len)
+{
+	struct smi_device_info *id = NULL;
+	struct smi_sched_event_stats *info = NULL;
+	struct smi_sched_event_stat *stat = NULL;
+	struct amdgv_sched_event_stats *event_stats = NULL;
+	struct amdgv_sched_event_queue_stats queue_stats;
+	amdgv_dev_t *adev = NULL;
+	bool dev_busy = false;
+	int ret = 0;
+	uint32_t i = 0;
+	/* Check version */
+	if ((in_len != sizeof(struct smi_device_info)) ||
+		(out_len != sizeof(struct smi_sched_event_stats)))
+		return SMI_STATUS_INVAL;
+	info = (struct smi_sched_event_stats *) outb;
+	id = (struct smi_device_info *) inb;
+	event_stats = smi_oss_funcs->alloc_memory(sizeof(struct amdgv_sched_event_stats));
+	if (event_stats == NULL)
+		return SMI_STATUS_OUT_OF_RESOURCES;
+	adev = smi_get_handle(ctx, &id->dev_id, NULL, &dev_busy);
+	if (!adev) {
+		smi_oss_funcs->free_memory(event_stats);
+		return SMI_STATUS_NOT_FOUND;
+	}
+	if (dev_busy) {
+		smi_oss_funcs->free_memory(event_stats);
+		return SMI_STATUS_BUSY;
+	}
+	ret = amdgv_sched_get_event_queue_stats(adev, &queue_stats);
+	if (ret)
+		goto end;
+	info->depth = queue_stats.depth;
+	info->max_depth = queue_stats.max_depth;
+	info->num_events = 0;
+	for (i = 0; i < AMDGV_SCHED_EVENT_STATS_NUM &&
+		    info->num_events < SMI_MAX_SCHED_EVENT_STATS; i++) {
+		ret = amdgv_sched_get_event_stats(adev, i, event_stats);
+		if (ret)
+			goto end;
+		stat = &info->event[info->num_events++];
+		stat->event_id = event_stats->event_id;
+		stat->queued = event_stats->queued;
+		stat->coalesced = event_stats->coalesced;
+		stat->skipped = event_stats->skipped;
+		stat->handled = event_stats->handled;
+		stat->wait_sum = event_stats->wait_sum_us;
+		stat->run_sum = event_stats->run_sum_us;
+		stat->wait_max = event_stats->wait_max_us;
+		stat->wait_p99 = smi_histogram_p99(&event_stats->wait_us,
+						   event_stats->wait_max_us);
+		stat->run_max = event_stats->run_max_us;
+		stat->run_p99 = smi_histogram_p99(&event_stats->run_us,
+						  event_stats->run_max_us);
+	}
+end:
+	smi_oss_funcs->free_memory(event_stats);
+	smi_put_handle(adev, ctx);
+	return smi_convert_ret_value(ERROR_OTHER, ret);
+}
+
+int smi_get_event_format(struct smi_ctx *ctx, void *inb,
+				void *outb, uint16_t in_len, uint16_t out_len)
+{
+	struct smi_event_format_query *query = NULL;
+	struct smi_event_format *format = NULL;
+	uint32_t arg_type = 0;
+
+	/* Check version */
+	if ((in_len != sizeof(struct smi_event_format_query)) ||
+		(out_len != sizeof(struct smi_event_format)))
+		return SMI_STATUS_INVAL;
+
+	query = (struct smi_event_format_query *) inb;
+	format = (struct smi_event_format *) outb;
+
+	/* the text table is shared by all devices, no handle to look up */
+	if (!amdgv_error_get_error_format(AMDGV_ERROR_CODE(query->category, query->subcode),
+					  format->text, SMI_EVENT_MSG_SIZE, &arg_type))
+		return SMI_STATUS_NOT_SUPPORTED;
+
+	switch (arg_type) {
+	case AMDGV_ERROR_TEXT_ARG_NONE:
+		format->arg_type = SMI_EVENT_ARG_NONE;
+		break;
+	case AMDGV_ERROR_TEXT_ARG_64:
+		format->arg_type = SMI_EVENT_ARG_64;
+		break;
+	case AMDGV_ERROR_TEXT_ARG_32_32:
+		format->arg_type = SMI_EVENT_ARG_32_32;
+		break;
+	case AMDGV_ERROR_TEXT_ARG_16_16_32:
+		format->arg_type = SMI_EVENT_ARG_16_16_32;
+		break;
+	case AMDGV_ERROR_TEXT_ARG_16_16_16_16:
+		format->arg_type = SMI_EVENT_ARG_16_16_16_16;
+		break;
+	default:
+		return SMI_STATUS_NOT_SUPPORTED;
+	}
+
+	return SMI_STATUS_SUCCESS;
+}
+
 int smi_set_gpu_power_cap(struct smi_ctx *ctx, void *inb,
 				void *outb, uint16_t in_len, uint16_t out_len)
 {
@@ -683,35 +806,17 @@ end:
 	return smi_convert_ret_value(ERROR_OTHER, ret);
 }
 
-int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
-				void *outb, uint16_t in_len, uint16_t out_len)
+static int smi_fill_gpu_performance_info(amdgv_dev_t adev,
+				struct smi_gpu_performance_info *info)
 {
-	struct smi_device_info *id = NULL;
-	struct smi_gpu_performance_info *info = NULL;
-	amdgv_dev_t *adev = NULL;
-	bool dev_busy = false;
 	struct amdgv_gpumon_metrics metrics;
 	int ret = SMI_STATUS_SUCCESS;
 	int mm_ret;
 
-	/* Check version */
-	if ((in_len != sizeof(struct smi_device_info_ex)) || (out_len !=
-			sizeof(struct smi_gpu_performance_info)))
-		return SMI_STATUS_INVAL;
-
-	info = (struct smi_gpu_performance_info *) outb;
-	id = (struct smi_device_info *) inb;
-
-	adev = smi_get_handle(ctx, &id->dev_id, NULL, &dev_busy);
-	if (!adev)
-		return SMI_STATUS_NOT_FOUND;
-	if (dev_busy)
-		return SMI_STATUS_BUSY;
-
 	/* Fill the data */
 	ret = amdgv_gpumon_get_metrics(adev, &metrics);
 	if (ret)
-		goto end;
+		return ret;
 
 	smi_oss_funcs->memset(info, 0, sizeof(*info));
 
@@ -759,14 +864,14 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 
 	ret = amdgv_gpumon_get_max_sclk(adev, &info->clock.max_clk[SMI_CLK_TYPE_GFX]);
 	if (ret)
-		goto end;
+		return ret;
 
 
 	amdgv_gpumon_get_min_sclk(adev, &info->clock.min_clk[SMI_CLK_TYPE_GFX]);
 
 	ret = amdgv_gpumon_get_max_mclk(adev, &info->clock.max_clk[SMI_CLK_TYPE_MEM]);
 	if (ret)
-		goto end;
+		return ret;
 
 	amdgv_gpumon_get_min_mclk(adev, &info->clock.min_clk[SMI_CLK_TYPE_MEM]);
 
@@ -774,7 +879,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	mm_ret = amdgv_gpumon_get_max_vclk0(adev, &info->clock.max_clk[SMI_CLK_TYPE_VCLK0]);
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.max_clk[SMI_CLK_TYPE_VCLK0] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -784,7 +889,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.min_clk[SMI_CLK_TYPE_VCLK0] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -793,7 +898,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	mm_ret = amdgv_gpumon_get_max_vclk1(adev, &info->clock.max_clk[SMI_CLK_TYPE_VCLK1]);
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.max_clk[SMI_CLK_TYPE_VCLK1] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -802,7 +907,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	mm_ret = amdgv_gpumon_get_min_vclk1(adev, &info->clock.min_clk[SMI_CLK_TYPE_VCLK1]);
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.min_clk[SMI_CLK_TYPE_VCLK1] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -811,7 +916,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	mm_ret = amdgv_gpumon_get_max_dclk0(adev, &info->clock.max_clk[SMI_CLK_TYPE_DCLK0]);
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.max_clk[SMI_CLK_TYPE_DCLK0] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -820,7 +925,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	mm_ret = amdgv_gpumon_get_min_dclk0(adev, &info->clock.min_clk[SMI_CLK_TYPE_DCLK0]);
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.min_clk[SMI_CLK_TYPE_DCLK0] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -829,7 +934,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	mm_ret = amdgv_gpumon_get_max_dclk1(adev, &info->clock.max_clk[SMI_CLK_TYPE_DCLK1]);
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.max_clk[SMI_CLK_TYPE_DCLK1] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -838,7 +943,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	mm_ret = amdgv_gpumon_get_min_dclk1(adev, &info->clock.min_clk[SMI_CLK_TYPE_DCLK1]);
 	// ret can be not supported for GPUs that don't support MM1 and MM2 domains
 	if (mm_ret && mm_ret != AMDGV_ERROR_GPUMON_NOT_SUPPORTED)
-		goto end;
+		return ret;
 	else if (mm_ret == AMDGV_ERROR_GPUMON_NOT_SUPPORTED){
 		info->clock.min_clk[SMI_CLK_TYPE_DCLK1] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
@@ -849,7 +954,7 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 		info->clock.clk_locked[SMI_CLK_TYPE_GFX] = SMI_NOT_SUPPORTED;
 		ret = SMI_STATUS_SUCCESS;
 	} else if (ret != SMI_STATUS_SUCCESS)
-		goto end;
+		return ret;
 	else
 		ret = SMI_STATUS_SUCCESS;
 	info->power.socket_power = metrics.power;
@@ -872,12 +977,63 @@ int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 	info->temp_limit.temp[SMI_TEMPERATURE_TYPE_HOTSPOT] = metrics.temp_hotspot_limit;
 	info->temp_limit.temp[SMI_TEMPERATURE_TYPE_VRAM] = metrics.temp_mem_limit;
 
-end:
+	return ret;
+}
+
+int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
+				void *outb, uint16_t in_len, uint16_t out_len)
+{
+	struct smi_device_info *id = NULL;
+	struct smi_gpu_performance_info *info = NULL;
+	amdgv_dev_t *adev = NULL;
+	bool dev_busy = false;
+	int ret = SMI_STATUS_SUCCESS;
+
+	/* Check version */
+	if ((in_len != sizeof(struct smi_device_info_ex)) || (out_len !=
+			sizeof(struct smi_gpu_performance_info)))
+		return SMI_STATUS_INVAL;
+
+	info = (struct smi_gpu_performance_info *) outb;
+	id = (struct smi_device_info *) inb;
+
+	adev = smi_get_handle(ctx, &id->dev_id, NULL, &dev_busy);
+	if (!adev)
+		return SMI_STATUS_NOT_FOUND;
+	if (dev_busy)
+		return SMI_STATUS_BUSY;
+
+	ret = smi_fill_gpu_performance_info(adev, info);
+
 	smi_put_handle(adev, ctx);
 
 	return smi_convert_ret_value(ERROR_OTHER, ret);
 }
 
+/*
+ * Same data as SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO for callers outside of
+ * an ioctl, such as the metrics snapshot refresh.
+ */
+int smi_get_gpu_performance_snapshot(amdgv_dev_t adev,
+				struct smi_gpu_performance_info *info)
+{
+	struct smi_device_data dev_data = {0};
+	bool dev_busy = false;
+	int ret;
+
+	smi_get_device_data(adev, &dev_data, &dev_busy, NULL);
+	if (!dev_data.adev)
+		return SMI_STATUS_NOT_FOUND;
+	if (dev_busy)
+		return SMI_STATUS_BUSY;
+
+	ret = smi_fill_gpu_performance_info(adev, info);
+
+	smi_put_handle(adev, NULL);
+
+	return smi_convert_ret_value(ERROR_OTHER, ret);
+}
+
 int smi_get_data(struct smi_ctx *ctx, void *inb,
 		     void *outb, uint16_t in_len, uint16_t out_len)
 {
@@ -2629,6 +2785,24 @@ int smi_set_soc_pstate(struct smi_ctx *ctx, void *inb,
 	return smi_convert_ret_value(ERROR_OTHER, ret);
 }
 
+/*
+ * Translate the library severity_mask into one bit per cper_error_severity.
+ * SMI_CPER_SEV_NUM selects every severity, otherwise a severity is picked
+ * when it shares a bit with the mask.
+ */
+static uint32_t smi_cper_sev_mask(uint32_t severity_mask)
+{
+	uint32_t sev_mask = 0;
+	uint32_t sev;
+
+	for (sev = 0; sev < SMI_CPER_SEV_NUM; sev++) {
+		if (severity_mask == SMI_CPER_SEV_NUM || (sev & severity_mask) != 0)
+			sev_mask |= 1U << sev;
+	}
+
+	return sev_mask;
+}
+
 int smi_get_cper_error(struct smi_ctx *ctx, void *inb,
 			    void *outb, uint16_t in_len, uint16_t out_len)
 {
@@ -2641,6 +2815,8 @@ int smi_get_cper_error(struct smi_ctx *ctx, void *inb,
 	uint64_t write_count = 0;
 	uint64_t overflow_count = 0;
 	uint64_t left_size = 0;
+	uint64_t next_cursor = 0;
+	uint32_t sev_mask = 0;
 	char *buf = NULL;
 	uint32_t smi_cper_hdrs[SMI_MAX_CPER_HDRS];
 
@@ -2670,7 +2846,16 @@ int smi_get_cper_error(struct smi_ctx *ctx, void *inb,
 		return SMI_STATUS_BUSY;
 	}
 
-	ret = amdgv_gpumon_cper_get_entries(adev, config->input_cursor, buf, size, &write_count, &overflow_count, &left_size);
+	/*
+	 * Filter by severity in the driver so only the requested records are
+	 * copied. Libraries older than BETA_5 filter on their own and advance
+	 * the cursor by entry_count, so hand them every record.
+	 */
+	sev_mask = smi_cper_sev_mask(ctx->version >= SMI_VERSION_BETA_5 ?
+				     config->severity_mask : SMI_CPER_SEV_NUM);
+	ret = amdgv_gpumon_cper_get_entries(adev, config->input_cursor, sev_mask,
+					    buf, size, SMI_MAX_CPER_HDRS, &write_count,
+					    &overflow_count, &left_size, &next_cursor);
 	if (ret) {
 		goto end;
 	}
@@ -2678,8 +2863,6 @@ int smi_get_cper_error(struct smi_ctx *ctx, void *inb,
 	hdr = (struct smi_cper_hdr*)(buf);
 	smi_cper_hdrs[0] = 0;
 
-	write_count = write_count >= SMI_MAX_CPER_HDRS ? SMI_MAX_CPER_HDRS : write_count;
-
 	for (i = 1; i < write_count; i++) {
 		smi_cper_hdrs[i] = smi_cper_hdrs[i-1] + hdr->record_length;
 
@@ -2687,7 +2870,7 @@ int smi_get_cper_error(struct smi_ctx *ctx, void *inb,
 		hdr = (struct smi_cper_hdr*)((char *)hdr + hdr->record_length);
 	}
 
-	ret = smi_get_cper_data(config, in_len, size, buf, write_count, smi_cper_hdrs);
+	ret = smi_get_cper_data(config, in_len, size, buf, write_count, smi_cper_hdrs, next_cursor);
 	if (ret)
 		goto end;
 
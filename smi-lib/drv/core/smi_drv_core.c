@@ -26,6 +26,7 @@
 #include <amdgv_gpumon.h>
 
 #include "smi_drv_oss_wrapper.h"
+#include "smi_drv_cmd.h"
 
 struct oss_interface *smi_oss_funcs;
 struct smi_shim_interface *smi_shim_funcs;
@@ -242,6 +243,149 @@ int smi_core_release(file_t filp)
 	return 0;
 }
 
+int smi_core_get_metrics_snapshot(struct smi_metrics_snapshot *slots,
+		uint32_t max_slots, uint32_t *num_slots)
+{
+	struct smi_device_data *dev_list = NULL;
+	struct amdgv_vbios_info vbios;
+	uint32_t dev_list_size = 0;
+	uint64_t pf_id;
+	uint32_t i;
+
+	*num_slots = 0;
+
+	dev_list = smi_oss_funcs->alloc_small_zero_memory(
+			AMDGV_MAX_GPU_NUM * sizeof(struct smi_device_data));
+	if (!dev_list)
+		return -SMI_ENOMEM;
+
+	smi_lock_device_list();
+	smi_get_device_list(dev_list, &dev_list_size);
+	smi_unlock_device_list();
+
+	for (i = 0; i < dev_list_size && i < max_slots; i++) {
+		if (amdgv_gpumon_get_vbios_info(dev_list[i].adev, &vbios))
+			vbios.serial = 0ULL;
+
+		/* same PF handle as handed out by smi_core_open */
+		pf_id = smi_hash_64(dev_list[i].init_data.info.bdf ^ vbios.serial, 32);
+
+		slots[i].version = SMI_METRICS_SNAPSHOT_VERSION;
+		slots[i].dev_id.handle = pf_id | pf_id << 32;
+		slots[i].status = smi_get_gpu_performance_snapshot(dev_list[i].adev,
+				&slots[i].info);
+		slots[i].timestamp = smi_oss_funcs->get_time_stamp();
+	}
+	*num_slots = i;
+
+	smi_oss_funcs->free_small_memory(dev_list);
+
+	return 0;
+}
+
+static unsigned int smi_core_find_cmd(struct smi_ctx *ctx, uint32_t code)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->max_cmd; i++)
+		if (ctx->tbl_cmd[i].cmd == code)
+			break;
+
+	return i;
+}
+
+static bool smi_core_batchable_cmd(uint32_t code)
+{
+	switch (code) {
+	case SMI_CMD_CODE_HANDSHAKE:
+	case SMI_CMD_CODE_BATCH:
+	case SMI_CMD_CODE_CREATE_EVENT:
+	case SMI_CMD_CODE_READ_EVENT:
+	case SMI_CMD_CODE_DESTROY_EVENT:
+		return false;
+	default:
+		return true;
+	}
+}
+
+int smi_cmd_batch(struct smi_ctx *ctx, void *inb, void *outb,
+		uint16_t in_len, uint16_t out_len)
+{
+	struct smi_batch_request req;
+	struct smi_batch_entry *entries;
+	struct smi_batch_entry *entry;
+	unsigned int i, j;
+	int ret = SMI_STATUS_SUCCESS;
+
+	if ((in_len != sizeof(req)) || (out_len != 0))
+		return SMI_STATUS_INVAL;
+
+	/* inb and outb are reused as scratch space for every entry */
+	smi_oss_funcs->memcpy(&req, inb, sizeof(req));
+
+	if (req.num_entries == 0 || req.num_entries > SMI_MAX_BATCH_ENTRIES ||
+	    req.buffer_size > SMI_MAX_BATCH_BUFFER_SIZE)
+		return SMI_STATUS_INVAL;
+
+	entries = smi_oss_funcs->alloc_small_zero_memory(
+			req.num_entries * sizeof(struct smi_batch_entry));
+	if (!entries)
+		return SMI_STATUS_OUT_OF_RESOURCES;
+
+	if (smi_oss_funcs->copy_from_user(entries, req.entries,
+			req.num_entries * sizeof(struct smi_batch_entry))) {
+		ret = SMI_STATUS_ADDRESS_FAULT;
+		goto free_entries;
+	}
+
+	for (i = 0; i < req.num_entries; i++) {
+		entry = &entries[i];
+
+		j = smi_core_find_cmd(ctx, entry->code);
+		if (j == ctx->max_cmd || !smi_core_batchable_cmd(entry->code)) {
+			entry->status = SMI_STATUS_NOT_SUPPORTED;
+			continue;
+		}
+
+		if (entry->in_len < 0 || entry->out_len < 0 ||
+		    entry->in_len > sizeof(ctx->in_command.payload) ||
+		    entry->out_len > sizeof(ctx->out_response.payload) ||
+		    entry->in_offset > req.buffer_size ||
+		    entry->out_offset > req.buffer_size ||
+		    entry->in_len > req.buffer_size - entry->in_offset ||
+		    entry->out_len > req.buffer_size - entry->out_offset) {
+			entry->status = SMI_STATUS_INVAL;
+			continue;
+		}
+
+		if (smi_oss_funcs->copy_from_user(inb, req.buffer + entry->in_offset,
+				smi_min(entry->in_len, ctx->tbl_cmd[j].in_buffer_len))) {
+			entry->status = SMI_STATUS_ADDRESS_FAULT;
+			continue;
+		}
+
+		smi_oss_funcs->memset(outb, 0, entry->out_len);
+
+		entry->status = ctx->tbl_cmd[j].func(ctx, inb, outb,
+				entry->in_len, entry->out_len);
+		if (entry->status)
+			continue;
+
+		if (smi_oss_funcs->copy_to_user(req.buffer + entry->out_offset, outb,
+				smi_min(entry->out_len, ctx->tbl_cmd[j].out_buffer_len)))
+			entry->status = SMI_STATUS_ADDRESS_FAULT;
+	}
+
+	if (smi_oss_funcs->copy_to_user(req.entries, entries,
+			req.num_entries * sizeof(struct smi_batch_entry)))
+		ret = SMI_STATUS_ADDRESS_FAULT;
+
+free_entries:
+	smi_oss_funcs->free_small_memory(entries);
+
+	return ret;
+}
+
 int smi_core_ioctl_handler(file_t filp, unsigned int cmd, void *arg)
 {
 	long ret = 0;
@@ -321,10 +465,7 @@ int smi_core_ioctl_handler(file_t filp, unsigned int cmd, void *arg)
 	}
 
 	/* find the entry */
-	for (i = 0; i < ctx->max_cmd; i++)
-		if (ctx->tbl_cmd[i].cmd == ctx->in_command.hdr.code)
-			break;
-
+	i = smi_core_find_cmd(ctx, ctx->in_command.hdr.code);
 	if (i == ctx->max_cmd) {
 		ret = -SMI_EINVAL;
 		goto unlock_mutex;
@@ -60,6 +60,7 @@ int smi_cmd_handshake(struct smi_ctx *ctx, void *inb, void *outb,
 	case SMI_VERSION_BETA_2:
 	case SMI_VERSION_BETA_3:
 	case SMI_VERSION_BETA_4:
+	case SMI_VERSION_BETA_5:
 		ctx->tbl_cmd = smi_oss_funcs->alloc_small_zero_memory(
 			SMI_VERSION_BETA_1_NUM_CMD * sizeof(struct smi_cmd_entry));
 		max = SMI_VERSION_BETA_1_NUM_CMD;
@@ -260,6 +261,18 @@ int smi_cmd_handshake(struct smi_ctx *ctx, void *inb, void *outb,
 			smi_get_cper_error,
 			sizeof(struct smi_cper_config),
 			0);
+		SMI_ASSIGN_FUNC(ctx, cmd, SMI_CMD_CODE_BATCH,
+			smi_cmd_batch,
+			sizeof(struct smi_batch_request),
+			0);
+		SMI_ASSIGN_FUNC(ctx, cmd, SMI_CMD_CODE_GET_SCHED_EVENT_STATS,
+			smi_get_sched_event_stats,
+			sizeof(struct smi_device_info),
+			sizeof(struct smi_sched_event_stats));
+		SMI_ASSIGN_FUNC(ctx, cmd, SMI_CMD_CODE_GET_EVENT_FORMAT,
+			smi_get_event_format,
+			sizeof(struct smi_event_format_query),
+			sizeof(struct smi_event_format));
 
 		/* Set max num of commands
 		 * This needs to be set to the number of functions
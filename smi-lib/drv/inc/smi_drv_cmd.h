@@ -43,12 +43,18 @@ int smi_get_gpu_fb_info(struct smi_ctx *ctx, void *inb,
 				void *outb, uint16_t in_len, uint16_t out_len);
 int smi_get_gpu_cache_info(struct smi_ctx *ctx, void *inb,
 				void *outb, uint16_t in_len, uint16_t out_len);
+int smi_get_sched_event_stats(struct smi_ctx *ctx, void *inb,
+				void *outb, uint16_t in_len, uint16_t out_len);
+int smi_get_event_format(struct smi_ctx *ctx, void *inb,
+				void *outb, uint16_t in_len, uint16_t out_len);
 int smi_set_gpu_power_cap(struct smi_ctx *ctx, void *inb,
 			  void *outb, uint16_t in_len, uint16_t out_len);
 int smi_get_gpu_fw_info(struct smi_ctx *ctx, void *inb,
 				void *outb, uint16_t in_len, uint16_t out_len);
 int smi_get_gpu_performance_info(struct smi_ctx *ctx, void *inb,
 				void *outb, uint16_t in_len, uint16_t out_len);
+int smi_get_gpu_performance_snapshot(amdgv_dev_t adev,
+				struct smi_gpu_performance_info *info);
 int smi_get_is_power_management_enabled(struct smi_ctx *ctx, void *inb,
 				void *outb, uint16_t in_len, uint16_t out_len);
 int smi_get_vf_static_info(struct smi_ctx *ctx, void *inb,
@@ -93,6 +93,10 @@ int smi_cmd_handshake(struct smi_ctx *ctx,
 		void *inb, void *outb,
 		uint16_t ins, uint16_t outs);
 
+int smi_cmd_batch(struct smi_ctx *ctx,
+		void *inb, void *outb,
+		uint16_t ins, uint16_t outs);
+
 int smi_vf_map_update(struct smi_ctx *ctx, void *adev);
 int smi_get_vf_index(struct smi_ctx *ctx, struct smi_vf_handle *vf_handle);
 uint64_t smi_get_vf_handle(struct smi_ctx *ctx, smi_device_handle_t *dev, int idx_vf);
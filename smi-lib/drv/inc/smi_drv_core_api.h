@@ -29,6 +29,7 @@
 #include "smi_cmd_ioctl.h"
 
 struct oss_interface;
+struct smi_metrics_snapshot;
 
 struct smi_device_data {
 	struct amdgv_init_data init_data;
@@ -44,4 +45,11 @@ int smi_core_open(file_t filp, bool is_privileged);
 int smi_core_release(file_t filp);
 int smi_core_ioctl_handler(file_t filp, unsigned int cmd, void *arg);
 
+/*
+ * Fill one slot per device with the current performance info. Publishing
+ * the slots to readers is left to the OS layer.
+ */
+int smi_core_get_metrics_snapshot(struct smi_metrics_snapshot *slots,
+		uint32_t max_slots, uint32_t *num_slots);
+
 #endif // __SMI_DRV_CORE_API_H__
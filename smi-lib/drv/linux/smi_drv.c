@@ -78,6 +78,20 @@ static struct class	*smi_class;
 static struct device	*smi_dev;
 static dev_t devid;
 
+static uint metrics_snapshot_interval = 100;
+module_param(metrics_snapshot_interval, uint, 0644);
+MODULE_PARM_DESC(metrics_snapshot_interval, "Refresh interval of the mmap-able SMI metrics snapshot in ms\n\t"
+				"metrics_snapshot_interval=D\n\t"
+				"100(default): refresh every 100 ms while the snapshot is mapped\n\t"
+				"0: snapshot disabled, clients fall back to ioctl\n\t");
+
+/* read-only region mapped by clients, one slot per device */
+static void *smi_snapshot;
+/* private copy the slots are filled into before being published */
+static struct smi_metrics_snapshot *smi_snapshot_staging;
+static struct task_struct *smi_snapshot_thread;
+static atomic_t smi_snapshot_users = ATOMIC_INIT(0);
+
 /* shim interface function */
 static void gim_lock_device_list(void)
 {
@@ -555,7 +569,7 @@ static int gim_get_eeprom_table(struct smi_bad_page_info *eeprom_table, uint16_t
 }
 
 static inline int gim_get_cper_data(struct smi_cper_config *cper_config, uint16_t in_len, uint64_t size, char* buffer, uint64_t write_count,
-									uint32_t* smi_cper_hdrs)
+									uint32_t* smi_cper_hdrs, uint64_t cursor)
 {
 	struct smi_cper *cper = NULL;
 	long num_pages = 0;
@@ -611,7 +625,7 @@ static inline int gim_get_cper_data(struct smi_cper_config *cper_config, uint16_
 	for (i = 0; i < write_count; i++) {
 		cper->cper_hdrs[i] = smi_cper_hdrs[i];
 	}
-	cper->cursor = write_count;
+	cper->cursor = cursor;
 	// Unmap and release mapped pages and
 	// free the virtual contiguous memory
 	vunmap(cper);
@@ -666,6 +680,7 @@ struct smi_shim_interface gim_smi_interface = {
 static int smi_lnx_drv_open(struct inode *, smi_process_handle);
 static int smi_lnx_drv_release(struct inode *, smi_process_handle);
 static long smi_lnx_ioctl_handler(smi_process_handle file, unsigned int cmd, unsigned long arg);
+static int smi_lnx_mmap(smi_process_handle file, struct vm_area_struct *vma);
 
 static const struct file_operations smi_file_ops = {
 	.owner                  = THIS_MODULE,
@@ -675,6 +690,7 @@ static const struct file_operations smi_file_ops = {
 #endif
 	.open                   = smi_lnx_drv_open,
 	.release                = smi_lnx_drv_release,
+	.mmap                   = smi_lnx_mmap,
 };
 
 /* smi device file interface */
@@ -700,6 +716,176 @@ static int smi_verify_file_descriptor(file_t filp)
 	return file->f_op != &smi_file_ops;
 }
 
+/* metrics snapshot */
+static struct smi_metrics_snapshot *smi_snapshot_slot(uint32_t idx)
+{
+	return (struct smi_metrics_snapshot *)((uint8_t *)smi_snapshot +
+			idx * SMI_METRICS_SNAPSHOT_STRIDE);
+}
+
+/* seqcount style write, readers retry while seq is odd or has changed */
+static void smi_snapshot_publish(uint32_t idx, const struct smi_metrics_snapshot *src)
+{
+	struct smi_metrics_snapshot *dst = smi_snapshot_slot(idx);
+	uint32_t seq = READ_ONCE(dst->seq);
+
+	WRITE_ONCE(dst->seq, seq + 1);
+	smp_wmb();
+	memcpy((uint8_t *)dst + sizeof(dst->seq), (const uint8_t *)src + sizeof(src->seq),
+		sizeof(*src) - sizeof(src->seq));
+	smp_wmb();
+	WRITE_ONCE(dst->seq, seq + 2);
+}
+
+static void smi_snapshot_refresh(void)
+{
+	uint32_t num_slots = 0;
+	uint32_t i;
+
+	if (smi_core_get_metrics_snapshot(smi_snapshot_staging, SMI_MAX_DEVICES, &num_slots))
+		return;
+
+	for (i = 0; i < SMI_MAX_DEVICES; i++) {
+		if (i >= num_slots) {
+			memset(&smi_snapshot_staging[i], 0, sizeof(smi_snapshot_staging[i]));
+			smi_snapshot_staging[i].status = SMI_STATUS_NOT_FOUND;
+		}
+		smi_snapshot_publish(i, &smi_snapshot_staging[i]);
+	}
+}
+
+static void smi_snapshot_invalidate(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < SMI_MAX_DEVICES; i++) {
+		smi_snapshot_staging[i].status = SMI_STATUS_NOT_SUPPORTED;
+		smi_snapshot_publish(i, &smi_snapshot_staging[i]);
+	}
+}
+
+static int smi_snapshot_thread_fn(void *data)
+{
+	bool valid = false;
+	long timeout;
+	uint interval;
+
+	while (!kthread_should_stop()) {
+		interval = READ_ONCE(metrics_snapshot_interval);
+
+		/* only poll the devices while somebody has the snapshot mapped */
+		if (interval && atomic_read(&smi_snapshot_users)) {
+			smi_snapshot_refresh();
+			valid = true;
+		} else if (valid) {
+			smi_snapshot_invalidate();
+			valid = false;
+		}
+
+		set_current_state(TASK_INTERRUPTIBLE);
+		if (atomic_read(&smi_snapshot_users))
+			timeout = msecs_to_jiffies(interval ? interval : MSEC_PER_SEC);
+		else
+			timeout = MAX_SCHEDULE_TIMEOUT;
+		if (!kthread_should_stop())
+			schedule_timeout(timeout);
+		__set_current_state(TASK_RUNNING);
+	}
+
+	return 0;
+}
+
+static void smi_snapshot_vm_open(struct vm_area_struct *vma)
+{
+	atomic_inc(&smi_snapshot_users);
+}
+
+static void smi_snapshot_vm_close(struct vm_area_struct *vma)
+{
+	atomic_dec(&smi_snapshot_users);
+}
+
+static const struct vm_operations_struct smi_snapshot_vm_ops = {
+	.open  = smi_snapshot_vm_open,
+	.close = smi_snapshot_vm_close,
+};
+
+static int smi_lnx_mmap(smi_process_handle file, struct vm_area_struct *vma)
+{
+	struct smi_ctx *ctx = NULL;
+	int ret;
+
+	/* same privilege level the ioctl path requires */
+	smi_get_file_private_data((file_t)file, &ctx);
+	if (!ctx || !ctx->privileged)
+		return -EACCES;
+
+	if (!smi_snapshot)
+		return -ENODEV;
+
+	if (vma->vm_pgoff != 0 || vma->vm_end - vma->vm_start > SMI_METRICS_SNAPSHOT_SIZE)
+		return -EINVAL;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+#if defined(HAVE_VM_FLAGS_SET)
+	vm_flags_clear(vma, VM_MAYWRITE);
+#else
+	vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+
+	ret = remap_vmalloc_range(vma, smi_snapshot, 0);
+	if (ret)
+		return ret;
+
+	vma->vm_ops = &smi_snapshot_vm_ops;
+	smi_snapshot_vm_open(vma);
+
+	/* fill the slots right away instead of waiting for the next period */
+	wake_up_process(smi_snapshot_thread);
+
+	return 0;
+}
+
+static int smi_snapshot_init(void)
+{
+	smi_snapshot = vmalloc_user(SMI_METRICS_SNAPSHOT_SIZE);
+	smi_snapshot_staging = vzalloc(SMI_MAX_DEVICES * sizeof(struct smi_metrics_snapshot));
+	if (!smi_snapshot || !smi_snapshot_staging)
+		goto failed;
+
+	smi_snapshot_invalidate();
+
+	smi_snapshot_thread = kthread_run(smi_snapshot_thread_fn, NULL, "gim_smi_snapshot");
+	if (IS_ERR(smi_snapshot_thread)) {
+		smi_snapshot_thread = NULL;
+		goto failed;
+	}
+
+	return 0;
+
+failed:
+	vfree(smi_snapshot_staging);
+	vfree(smi_snapshot);
+	smi_snapshot_staging = NULL;
+	smi_snapshot = NULL;
+
+	return -ENOMEM;
+}
+
+static void smi_snapshot_fini(void)
+{
+	if (smi_snapshot_thread)
+		kthread_stop(smi_snapshot_thread);
+	smi_snapshot_thread = NULL;
+
+	/* a mapping pins the file and so the module, no client can still see it */
+	vfree(smi_snapshot_staging);
+	vfree(smi_snapshot);
+	smi_snapshot_staging = NULL;
+	smi_snapshot = NULL;
+}
+
 int smi_init(struct oss_interface *oss_interface,
 		struct smi_shim_interface *shim_interface)
 {
@@ -736,6 +922,10 @@ int smi_init(struct oss_interface *oss_interface,
 	if (res < 0)
 		goto err_class;
 
+	/* the snapshot is optional, clients keep using ioctl without it */
+	if (smi_snapshot_init())
+		gim_warn("SMI metrics snapshot not available\n");
+
 	goto out;
 err_class:
 	cdev_del(&smi_cdev);
@@ -750,6 +940,8 @@ out:
 
 void smi_cleanup(void)
 {
+	smi_snapshot_fini();
+
 	kobject_uevent(&smi_cdev.kobj, KOBJ_REMOVE);
 	cdev_del(&smi_cdev);
 	device_destroy(smi_class, smi_dev->devt);
@@ -36,6 +36,10 @@
 #include <linux/poll.h>
 #include <linux/anon_inodes.h>
 #include <linux/file.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/vmalloc.h>
+#include <linux/workqueue.h>
 #include <smi_drv_core.h>
 #include <smi_drv_core_api.h>
 
@@ -53,8 +57,14 @@ static unsigned smi_event_poll(smi_process_handle filep,
 static ssize_t smi_lnx_event_read(smi_process_handle filp, char __user *buf, size_t size, loff_t *off);
 
 static int smi_event_release(struct inode *inode, smi_process_handle filp);
+static int smi_event_mmap(smi_process_handle filp, struct vm_area_struct *vma);
 static void smi_event_free(struct kref *refcount);
 
+#if defined(HAVE_WAIT_QUEUE_ENTRY)
+typedef wait_queue_entry_t smi_wait_queue_entry_t;
+#else
+typedef wait_queue_t smi_wait_queue_entry_t;
+#endif
 
 struct smi_lnx_event_ctx {
 	struct smi_ctx *smi;
@@ -65,6 +75,14 @@ struct smi_lnx_event_ctx {
 	struct amdgv_error_notifier *notifier;
 	/* scratch buffer for entries */
 	struct smi_event_entry event;
+	/* serializes draining the notifier, read() against the ring */
+	struct mutex lock;
+	/* push ring, allocated by the first mmap of the event file */
+	struct smi_event_ring *ring;
+	smi_wait_queue_entry_t ring_wake;
+	struct work_struct ring_work;
+	wait_queue_head_t ring_wait;
+	uint64_t poll_head;
 };
 
 static const struct file_operations smi_event_fops = {
@@ -72,6 +90,7 @@ static const struct file_operations smi_event_fops = {
 	.release = smi_event_release,
 	.read = smi_lnx_event_read,
 	.poll = smi_event_poll,
+	.mmap = smi_event_mmap,
 };
 
 static int smi_event_release(struct inode *inode, smi_process_handle filp)
@@ -96,6 +115,14 @@ static ssize_t smi_lnx_event_read(smi_process_handle filp, char __user *buf, siz
 		return -EINVAL;
 
 	kref_get(&ctx->refcount);
+	mutex_lock(&ctx->lock);
+
+	/* once the ring is mapped it is the only consumer of the notifier */
+	if (ctx->ring) {
+		mutex_unlock(&ctx->lock);
+		kref_put(&ctx->refcount, smi_event_free);
+		return -EBUSY;
+	}
 
 	ptr = *off;
 
@@ -136,17 +163,132 @@ static ssize_t smi_lnx_event_read(smi_process_handle filp, char __user *buf, siz
 			break;
 	}
 
+	mutex_unlock(&ctx->lock);
 	kref_put(&ctx->refcount, smi_event_free);
 
 	return ret;
 }
 
+/* event ring */
+static void smi_event_ring_fill(struct smi_lnx_event_ctx *ctx)
+{
+	struct smi_event_ring *ring = ctx->ring;
+	struct smi_event_record *records;
+	struct smi_event_record *rec;
+	struct amdgv_error_entry *entry;
+	uint64_t head = ring->head;
+	uint64_t start = head;
+
+	records = (struct smi_event_record *)((uint8_t *)ring + SMI_EVENT_RING_RECORD_OFFSET);
+
+	/* no formatting and no copy to user, readers render the text */
+	while (!amdgv_error_get_error(ctx->adev, ctx->notifier, &entry) && entry) {
+		rec = &records[head & (SMI_EVENT_RING_ENTRIES - 1)];
+		rec->timestamp = gim_gpumon_ktime_to_utc(entry->timestamp);
+		rec->data = entry->error_data;
+		rec->category = AMDGV_ERROR_CATEGORY(entry->error_code);
+		rec->subcode = AMDGV_ERROR_SUBCODE(entry->error_code);
+		rec->vf_idx = (uint8_t)entry->vf_idx;
+		rec->level = entry->error_level;
+		rec->reserved = 0;
+
+		/* pairs with the acquire of head in the library */
+		smp_store_release(&ring->head, ++head);
+	}
+
+	if (head != start)
+		wake_up_interruptible_all(&ctx->ring_wait);
+}
+
+static void smi_event_ring_work(struct work_struct *work)
+{
+	struct smi_lnx_event_ctx *ctx = container_of(work, struct smi_lnx_event_ctx,
+				ring_work);
+
+	mutex_lock(&ctx->lock);
+	smi_event_ring_fill(ctx);
+	mutex_unlock(&ctx->lock);
+}
+
+/*
+ * Called from the notifier wakeup with the wait queue lock held, drain the
+ * notifier from process context so a storm does not overflow its queue
+ * while the reader is busy.
+ */
+static int smi_event_ring_wake(smi_wait_queue_entry_t *wait, unsigned int mode,
+			       int sync, void *key)
+{
+	struct smi_lnx_event_ctx *ctx = container_of(wait, struct smi_lnx_event_ctx,
+				ring_wake);
+
+	schedule_work(&ctx->ring_work);
+
+	return 0;
+}
+
+static int smi_event_ring_init(struct smi_lnx_event_ctx *ctx)
+{
+	struct smi_event_ring *ring;
+
+	ring = vmalloc_user(SMI_EVENT_RING_SIZE);
+	if (ring == NULL)
+		return -ENOMEM;
+
+	ring->version = SMI_EVENT_RING_VERSION;
+	ring->num_entries = SMI_EVENT_RING_ENTRIES;
+	ring->dev_id = ctx->dev_id.handle;
+	ring->head = 0;
+
+	INIT_WORK(&ctx->ring_work, smi_event_ring_work);
+	init_waitqueue_func_entry(&ctx->ring_wake, smi_event_ring_wake);
+	smp_store_release(&ctx->ring, ring);
+	add_wait_queue(&ctx->wait, &ctx->ring_wake);
+
+	/* pick up whatever queued up before the ring existed */
+	schedule_work(&ctx->ring_work);
+
+	return 0;
+}
+
+static int smi_event_mmap(smi_process_handle filp, struct vm_area_struct *vma)
+{
+	struct smi_lnx_event_ctx *ctx = filp->private_data;
+	int ret = 0;
+
+	if (vma->vm_pgoff != 0 || vma->vm_end - vma->vm_start != PAGE_ALIGN(SMI_EVENT_RING_SIZE))
+		return -EINVAL;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+#if defined(HAVE_VM_FLAGS_SET)
+	vm_flags_clear(vma, VM_MAYWRITE);
+#else
+	vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+
+	mutex_lock(&ctx->lock);
+	if (ctx->ring == NULL)
+		ret = smi_event_ring_init(ctx);
+	mutex_unlock(&ctx->lock);
+	if (ret)
+		return ret;
+
+	/* the mapping holds the file, the ring lives until the last unmap */
+	return remap_vmalloc_range(vma, ctx->ring, 0);
+}
+
 static void smi_event_free(struct kref *refcount)
 {
 	struct smi_lnx_event_ctx *set = container_of(refcount, struct smi_lnx_event_ctx,
 				refcount);
 	amdgv_dev_t adev = set->adev;
 
+	if (set->ring) {
+		remove_wait_queue(&set->wait, &set->ring_wake);
+		cancel_work_sync(&set->ring_work);
+		vfree(set->ring);
+	}
+
 	amdgv_error_delete_notifier(adev, set->notifier);
 #if !defined(HAVE_KFREE_SENSITIVE)
 	kzfree(set);
@@ -184,6 +326,8 @@ int smi_create_event(struct smi_ctx *smi, amdgv_dev_t *adev, struct smi_event_se
 
 	kref_init(&set->refcount);
 	init_waitqueue_head(&set->wait);
+	init_waitqueue_head(&set->ring_wait);
+	mutex_init(&set->lock);
 	set->smi = smi;
 	set->adev = adev;
 	set->dev_id.handle = config->dev_id.handle;
@@ -225,8 +369,28 @@ static unsigned smi_event_poll(smi_process_handle filep,
 #else
 	unsigned events = 0;
 #endif
+	struct smi_event_ring *ring;
+	uint64_t head;
 	kref_get(&ctx->refcount);
 
+	/* pairs with the release in smi_event_ring_init */
+	ring = smp_load_acquire(&ctx->ring);
+	if (ring) {
+		/*
+		 * The driver cannot see how far the reader got in the ring,
+		 * report readable once for every batch pushed since the last
+		 * readable poll. A reader that already drained it polls again.
+		 */
+		poll_wait(filep, &ctx->ring_wait, wait);
+		head = smp_load_acquire(&ring->head);
+		if (head != ctx->poll_head) {
+			ctx->poll_head = head;
+			events = POLLIN | POLLRDNORM;
+		}
+		kref_put(&ctx->refcount, smi_event_free);
+		return events;
+	}
+
 	poll_wait(filep, &ctx->wait, wait);
 
 	if (amdgv_error_is_pending(ctx->adev, ctx->notifier))
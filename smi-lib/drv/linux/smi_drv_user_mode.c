@@ -320,7 +320,7 @@ static int gim_get_eeprom_table(struct smi_bad_page_info *eeprom_table, uint16_t
 }
 
 static int gim_get_cper_data(struct smi_cper_config *cper_config, uint16_t in_len, uint64_t size, char* buffer, uint64_t write_count,
-				   uint32_t* smi_cper_hdrs)
+				   uint32_t* smi_cper_hdrs, uint64_t cursor)
 {
 	return SMI_STATUS_NOT_SUPPORTED;
 }
@@ -97,6 +97,9 @@ enum smi_cmd_code {
 	SMI_CMD_CODE_GET_POWER_CAP_INFO				= SMI_IOCTL | 0x00000030,
 	SMI_CMD_CODE_GET_PF_FB_INFO				= SMI_IOCTL | 0x00000031,
 	SMI_CMD_CODE_GET_GPU_CACHE_INFO				= SMI_IOCTL | 0x00000032,
+	SMI_CMD_CODE_BATCH					= SMI_IOCTL | 0x00000033,
+	SMI_CMD_CODE_GET_SCHED_EVENT_STATS			= SMI_IOCTL | 0x00000034,
+	SMI_CMD_CODE_GET_EVENT_FORMAT				= SMI_IOCTL | 0x00000035,
 	SMI_CMD_CODE__MAX					= 0xffffffff
 };
 
@@ -108,6 +111,8 @@ enum smi_cmd_code {
 #define SMI_VERSION_BETA_2  0x00000005
 #define SMI_VERSION_BETA_3  0x00000006
 #define SMI_VERSION_BETA_4  0x00000007
+/* GET_CPER filters by severity in the driver and returns an absolute cursor */
+#define SMI_VERSION_BETA_5  0x00000008
 
 #define SMI_MAX_CMD_V1 256
 #define SMI_MAX_CMD SMI_MAX_CMD_V1
@@ -115,7 +120,7 @@ enum smi_cmd_code {
 #define SMI_VERSION_BETA_1_NUM_CMD SMI_MAX_CMD
 
 #define SMI_VERSION_MIN SMI_VERSION_BETA_0
-#define SMI_VERSION_MAX SMI_VERSION_BETA_4
+#define SMI_VERSION_MAX SMI_VERSION_BETA_5
 
 #define SMI_NOT_SUPPORTED -1
 
@@ -175,6 +180,25 @@ enum smi_cmd_code {
 #define SMI_MAX_CPER_SIZE (10*1024)
 #define SMI_MAX_CPER_HDRS 10
 
+#define SMI_MAX_SCHED_EVENT_STATS 52
+
+#define SMI_MAX_BATCH_ENTRIES 64
+#define SMI_MAX_BATCH_BUFFER_SIZE (SMI_MAX_BATCH_ENTRIES * SMI_MAX_PAYLOAD * 4)
+
+/* Metrics snapshot region, one slot per device, exposed read-only via mmap */
+#define SMI_METRICS_SNAPSHOT_VERSION 1
+#define SMI_METRICS_SNAPSHOT_STRIDE 8192
+#define SMI_METRICS_SNAPSHOT_SIZE (SMI_MAX_DEVICES * SMI_METRICS_SNAPSHOT_STRIDE)
+/* Slots whose timestamp is older than this are ignored by the library */
+#define SMI_METRICS_SNAPSHOT_MAX_AGE_US 1000000
+
+/* Event ring of an event set, exposed read-only via mmap of the event fd */
+#define SMI_EVENT_RING_VERSION 1
+#define SMI_EVENT_RING_ENTRIES 4096
+#define SMI_EVENT_RING_RECORD_OFFSET 4096
+#define SMI_EVENT_RING_SIZE (SMI_EVENT_RING_RECORD_OFFSET + \
+		SMI_EVENT_RING_ENTRIES * sizeof(struct smi_event_record))
+
 // >>>>>>>>>>>>>>>>>>>> ENUM TYPE DEFINITIONS >>>>>>>>>>>>>>>>>>>>
 
 // Mapped AMDSMI library enums
@@ -771,6 +795,30 @@ struct smi_gpu_cache_info {
 	uint32_t reserved[15];
 };
 
+/* Scheduler event thread counters of one event id, latencies in us */
+struct smi_sched_event_stat {
+	uint32_t event_id;
+	uint32_t reserved;
+	uint64_t queued;
+	uint64_t coalesced;
+	uint64_t skipped;
+	uint64_t handled;
+	uint64_t wait_sum;
+	uint64_t run_sum;
+	uint32_t wait_max;
+	uint32_t wait_p99; /* upper bound of the 99th percentile bucket */
+	uint32_t run_max;
+	uint32_t run_p99;
+};
+
+struct smi_sched_event_stats {
+	uint32_t num_events;
+	uint32_t reserved;
+	uint64_t depth;
+	uint64_t max_depth;
+	struct smi_sched_event_stat event[SMI_MAX_SCHED_EVENT_STATS];
+};
+
 struct smi_fw_info {
 	uint8_t num_fw_info;
 	struct fw_info_list__ {
@@ -930,6 +978,55 @@ struct smi_event_entry {
 	uint64_t		reserved[6];
 };
 
+/*
+ * Binary form of an event as pushed into the event ring. The date, the
+ * message text and the VF handle are rendered by the library.
+ */
+struct smi_event_record {
+	uint64_t timestamp; //!< UTC microseconds
+	uint64_t data;
+	uint16_t category;
+	uint16_t subcode;
+	uint8_t vf_idx; //!< SMI_PF_INDEX for the PF
+	uint8_t level;
+	uint16_t reserved;
+};
+
+/*
+ * Header of the event ring. head counts the records written so far, record
+ * head - 1 lives in slot (head - 1) % num_entries. The driver overwrites
+ * the oldest record when the ring is full, a reader that fell more than
+ * num_entries behind has lost the difference.
+ */
+struct smi_event_ring {
+	uint32_t version;
+	uint32_t num_entries;
+	uint64_t dev_id;
+	uint64_t head;
+	uint64_t reserved[5];
+};
+
+enum smi_event_arg_type {
+	SMI_EVENT_ARG_NONE = 0,
+	SMI_EVENT_ARG_64,
+	SMI_EVENT_ARG_32_32,
+	SMI_EVENT_ARG_16_16_32,
+	SMI_EVENT_ARG_16_16_16_16,
+	SMI_EVENT_ARG_UNSUPPORTED = 0xff
+};
+
+struct smi_event_format_query {
+	uint32_t category;
+	uint32_t subcode;
+};
+
+/* printf format of an event message and how the event data feeds it */
+struct smi_event_format {
+	uint32_t arg_type; //!< enum smi_event_arg_type
+	uint32_t reserved;
+	char text[SMI_EVENT_MSG_SIZE];
+};
+
 struct smi_ras_feature {
 	uint32_t ras_eeprom_version;
 	uint32_t supported_ecc_correction_schema; //!< ecc_correction_schema mask used with enum smi_ecc_correction_schema_support flags
@@ -1118,7 +1215,8 @@ struct smi_event_set_s {
 	smi_event_handle_t	*handles;
 	void			*_private;
 	smi_device_handle_t	*devices;
-	uint64_t reserved[4];
+	void			*rings;
+	uint64_t reserved[3];
 };
 
 struct smi_ras_common_if {
@@ -1262,6 +1360,20 @@ struct smi_gpu_performance_info {
 	uint64_t reserved[440]; // expanded to MAX IOCTL copy size
 };
 
+/*
+ * One slot of the metrics snapshot region. The driver makes seq odd before
+ * updating the slot and even again afterwards, readers retry on a changed seq.
+ */
+struct smi_metrics_snapshot {
+	uint32_t seq;
+	uint32_t version;
+	smi_device_handle_t dev_id;
+	uint64_t timestamp; // usec, monotonic time of the last update
+	int32_t status;
+	uint32_t reserved[9];
+	struct smi_gpu_performance_info info;
+};
+
 struct smi_data_query {
 	struct smi_device_info dev;
 	enum smi_data_query_type type;
@@ -1344,6 +1456,29 @@ struct smi_metrics_table {
 	uint32_t reserved[9];
 };
 
+/*
+ * One command inside an SMI_CMD_CODE_BATCH request. The command input is
+ * read from buffer + in_offset and its output is written to
+ * buffer + out_offset. status is filled in by the driver per entry.
+ */
+struct smi_batch_entry {
+	uint32_t code;
+	int32_t status;
+	uint32_t in_offset;
+	uint32_t out_offset;
+	int16_t in_len;
+	int16_t out_len;
+	uint32_t reserved;
+};
+
+struct smi_batch_request {
+	uint32_t num_entries;
+	uint32_t buffer_size;
+	struct smi_batch_entry *entries;
+	uint8_t *buffer;
+	uint32_t reserved[8];
+};
+
 struct smi_bad_page_record {
 	uint32_t num_bad_page;
 	struct smi_eeprom_table_record bad_page[SMI_MAX_BAD_PAGE_RECORD];
@@ -1444,7 +1579,7 @@ struct smi_cper {
 	uint64_t 	buf_size;
 	uint32_t	cper_hdrs[SMI_MAX_CPER_HDRS];
 	uint64_t 	entry_count;
-	uint64_t	cursor;
+	uint64_t	cursor;		/* input_cursor for the next request */
 };
 
 struct smi_cper_config {
@@ -44,19 +44,36 @@ typedef int smi_file_handle;
 
 typedef struct smi_req_ctx_s smi_req_ctx;
 
+typedef struct smi_thread_ctx_s smi_thread_ctx;
+
 typedef struct {
 	smi_file_handle fd;
 	int version;
 	bool init;
-	uint8_t padding[3];
+	bool concurrent;
+	uint8_t padding[2];
+	/* access mode fd was opened with, per-thread fds use the same one */
+	int mode;
+	/* read-only metrics snapshot mapped from the driver, NULL if not mapped */
+	void *snapshot;
 #ifdef THREAD_SAFE
 	smi_mutex_t lock;
+	/* threads owning a dedicated fd in concurrent mode */
+	smi_thread_ctx *threads;
 #endif
 } smi_handle_struct;
 
-typedef struct {
+struct smi_thread_ctx_s {
 	smi_ioctl_cmd ioctl_cmd;
-} smi_thread_ctx;
+#ifdef THREAD_SAFE
+	/* per-thread driver connection, only valid in concurrent mode */
+	smi_file_handle fd;
+	bool has_fd;
+	/* dropped by shutdown, the owning thread closes fd on its next request */
+	bool detached;
+	smi_thread_ctx *next;
+#endif
+};
 
 struct smi_req_ctx_s {
 	smi_handle_struct *handle;
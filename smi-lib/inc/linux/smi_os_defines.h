@@ -31,4 +31,7 @@
 #define SMI_LAST_ERROR errno
 #define SMI_EXPORT
 
+#define SMI_LOAD_ACQUIRE(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define SMI_READ_BARRIER() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
 #endif // __SMI_OS_DEFINES_H__
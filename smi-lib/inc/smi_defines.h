@@ -39,6 +39,36 @@ extern smi_handle_struct g_smi_handle;
 extern smi_once_t smi_init_flag;
 extern smi_tss_t smi_thread_key;
 void smi_free_handle(void *thread);
+
+/**
+ *  \brief  Opens a dedicated driver connection for the calling thread.
+ *
+ *  \note   Only used in concurrent mode, must be called with the handle lock held.
+ *
+ *  \param [in] smi_req - Request context of the calling thread.
+ *
+ *  \return AMDSMI_RET_CODE indicating result.
+ */
+amdsmi_status_t smi_thread_attach(smi_req_ctx *smi_req);
+
+/**
+ *  \brief  Detaches the dedicated driver connections of all threads.
+ *
+ *  \note   Must be called with the handle lock held. The fds stay open until
+ *          their thread calls smi_thread_release() or exits.
+ *
+ *  \param [in] handle - Global library handle.
+ */
+void smi_thread_detach_all(smi_handle_struct *handle);
+
+/**
+ *  \brief  Closes the calling thread's connection if shutdown detached it.
+ *
+ *  \note   Must be called with the handle lock held.
+ *
+ *  \param [in] thread - Context of the calling thread, may be NULL.
+ */
+void smi_thread_release(smi_thread_ctx *thread);
 #ifdef _WIN64
 BOOL init_smi_once(PINIT_ONCE InitOnce, PVOID Parameter, PVOID * lpContext);
 #else
@@ -57,6 +87,7 @@ void init_smi_once(void);
 				return AMDSMI_STATUS_OUT_OF_RESOURCES;                                        \
 			}                                                                     \
 		}                                                                             \
+		smi_thread_release(smi_req.thread);                                           \
 	} while (0)
 
 #define AMDSMI_ESCAPE_IF_NOT_INIT_ON_FINI                                                    \
@@ -69,12 +100,14 @@ void init_smi_once(void);
 		}                                                                             \
 		smi_req.handle = &g_smi_handle;                                               \
 		smi_req.thread = smi_tss_get(smi_thread_key);                                 \
+		smi_thread_release(smi_req.thread);                                           \
 	} while (0)
 
 #define AMDSMI_ESCAPE_IF_NOT_INIT                                                            \
 	do {                                                                                  \
 		smi_run_once(&smi_init_flag, init_smi_once);                                  \
 		smi_mutex_lock(&g_smi_handle.lock);                                           \
+		smi_thread_release(smi_tss_get(smi_thread_key));                              \
 		if (!g_smi_handle.init) {                                                     \
 			smi_mutex_unlock(&g_smi_handle.lock);                                 \
 			SMI_ERROR("Call to %s failed. Handle not initialized. Return code: %d",               \
@@ -94,6 +127,14 @@ void init_smi_once(void);
 			smi_tss_set(smi_thread_key, smi_req.thread);                          \
 		}                                                                             \
 																					\
+		if (g_smi_handle.concurrent && !smi_req.thread->has_fd) {                     \
+			amdsmi_status_t attach_ret = smi_thread_attach(&smi_req);             \
+			if (attach_ret != AMDSMI_STATUS_SUCCESS) {                            \
+				smi_mutex_unlock(&g_smi_handle.lock);                         \
+				return attach_ret;                                            \
+			}                                                                     \
+		}                                                                             \
+																					\
 		smi_mutex_unlock(&g_smi_handle.lock);                                         \
 	} while (0)
 
@@ -44,6 +44,9 @@ typedef struct {
 	void* (*aligned_alloc)(void **mem, size_t alignment, size_t size);
 	void (*aligned_free)(void *);
 	int (*strncpy)(char *dest, size_t destsz, const char *src, size_t count);
+	void *(*mmap)(smi_file_handle, size_t);
+	int (*munmap)(void *, size_t);
+	uint64_t (*get_time_us)(void);
 } system_wrapper;
 
 extern system_wrapper *get_system_wrapper(void);
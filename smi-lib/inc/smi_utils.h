@@ -38,6 +38,66 @@ enum smi_metric_type {
 	SMI_METRIC_TYPE_ACC
 };
 
+enum smi_batch_query_type {
+	SMI_BATCH_QUERY_GPU_ACTIVITY,
+	SMI_BATCH_QUERY_POWER_INFO,
+	SMI_BATCH_QUERY_CLOCK_INFO,
+	SMI_BATCH_QUERY_TEMP_METRIC,
+	SMI_BATCH_QUERY_TOTAL_ECC_COUNT
+};
+
+struct smi_batch_query {
+	enum smi_batch_query_type type;
+	uint32_t entry;
+	uint32_t arg[2];
+	void *out;
+	amdsmi_status_t status;
+};
+
+/* Private layout behind the public amdsmi_batch handle */
+struct smi_batch_s {
+	uint32_t num_entries;
+	uint32_t num_queries;
+	uint32_t buffer_size;
+	uint32_t buffer_capacity;
+	bool serial;
+	struct smi_batch_entry entries[SMI_MAX_BATCH_ENTRIES];
+	struct smi_batch_query queries[SMI_MAX_BATCH_ENTRIES];
+	uint8_t *buffer;
+};
+
+#define SMI_EVENT_FORMAT_CACHE_SIZE 64
+
+/* Message format of one event code, as fetched from the driver */
+struct smi_event_format_cache {
+	bool valid;
+	uint32_t key;
+	uint32_t arg_type;
+	char text[SMI_EVENT_MSG_SIZE];
+};
+
+/* Reader state of the event ring of one device */
+struct smi_event_ring_dev {
+	const struct smi_event_ring *ring;
+	smi_device_handle_t dev_id;
+	uint64_t tail;
+	uint64_t lost;
+	bool has_pending;
+	struct smi_event_record pending;
+	uint64_t vf_handles[SMI_MAX_VF_COUNT];
+};
+
+/* Private layout behind the rings member of an event set */
+struct smi_event_rings_s {
+#ifdef THREAD_SAFE
+	smi_mutex_t lock;
+#endif
+	uint32_t num_devices;
+	uint32_t next;
+	struct smi_event_ring_dev dev[SMI_MAX_DEVICES];
+	struct smi_event_format_cache formats[SMI_EVENT_FORMAT_CACHE_SIZE];
+};
+
 /**
  *  \brief  Util function for dispaching IOCTL call to the KMD.
  *
@@ -58,6 +118,44 @@ enum smi_metric_type {
 amdsmi_status_t amdsmi_request(smi_req_ctx *smi_req, uint32_t cmd_code, size_t input_size,
 		size_t output_size);
 
+/**
+ *  \brief  Util function for adding a driver command to a batch.
+ *
+ *  \note   A command with the same code and input as an existing entry is
+ * not added again, the existing entry index is returned instead.
+ *
+ *  \param [in] batch - Batch to extend.
+ *
+ *  \param [in] cmd_code - Code of the command issued to the KMD.
+ *
+ *  \param [in] input - Input structure of the command.
+ *
+ *  \param [in] input_size - Size of the input structure expected by the
+ * command.
+ *
+ *  \param [in] output_size - Size of the output structure returned by the
+ * command.
+ *
+ *  \param [out] entry - Index of the entry holding the command.
+ *
+ *  \return AMDSMI_RET_CODE indicating result.
+ */
+amdsmi_status_t amdsmi_batch_add_entry(struct smi_batch_s *batch, uint32_t cmd_code, const void *input,
+		size_t input_size, size_t output_size, uint32_t *entry);
+
+/**
+ *  \brief  Util function for dispatching all batch entries to the KMD.
+ *
+ *  \note   Uses a single SMI_CMD_CODE_BATCH request when the driver supports
+ * it and falls back to one request per entry otherwise. The status of every
+ * entry is stored in the entry itself.
+ *
+ *  \param [in] batch - Batch to execute.
+ *
+ *  \return AMDSMI_RET_CODE indicating result.
+ */
+amdsmi_status_t amdsmi_ioctl_batch(smi_req_ctx *smi_req, struct smi_batch_s *batch);
+
 /**
  *  \brief  Util function for querying vf partitioning info.
  *
@@ -86,7 +184,8 @@ amdsmi_status_t amdsmi_ioctl_get_vf_static_info(smi_req_ctx *smi_req, smi_device
  *  \brief  Util function for querying gpu performance info.
  *
  *  \note   The result of the KMD command will be stored in the handle.output
- * buff.
+ * buff. When the metrics snapshot is mapped, the result is copied from it
+ * and no KMD command is issued.
  *
  *  \param [in] handle - Amdsmi processor handle.
  *
@@ -118,6 +217,64 @@ amdsmi_status_t amdsmi_ioctl_get_ecc_error_count(smi_req_ctx *smi_req, smi_devic
  */
 amdsmi_status_t amdsmi_ioctl_get_vf_dynamic_info(smi_req_ctx *smi_req, smi_device_handle_t vf_handle);
 
+/**
+ *  \brief  Maps the event ring of every device of an event set.
+ *
+ *  \note   When the driver offers no ring the set is left without rings and
+ * keeps reading formatted events from the event fds. Failing after the first
+ * ring got mapped is an error, a mapped event fd no longer serves read().
+ *
+ *  \param [in,out] event_set - Event set with its event fds opened.
+ *
+ *  \return AMDSMI_RET_CODE indicating result.
+ */
+amdsmi_status_t amdsmi_event_ring_map(struct smi_event_set_s *event_set);
+
+/**
+ *  \brief  Unmaps and frees the event rings of an event set, if any.
+ *
+ *  \param [in,out] event_set - Event set to release the rings of.
+ */
+void amdsmi_event_ring_unmap(struct smi_event_set_s *event_set);
+
+/**
+ *  \brief  Takes the next record from the event rings, visiting the
+ * devices round robin.
+ *
+ *  \note   Records the reader fell too far behind on are reported as a
+ * single driver buffer overflow event carrying the number of lost records.
+ *
+ *  \param [in,out] rings - Event rings of the set.
+ *
+ *  \param [out] record - Next record.
+ *
+ *  \param [out] dev_idx - Index of the device the record belongs to.
+ *
+ *  \return true if a record was taken, false if all rings are empty.
+ */
+bool amdsmi_event_ring_next(struct smi_event_rings_s *rings, struct smi_event_record *record,
+			    uint32_t *dev_idx);
+
+/**
+ *  \brief  Renders a ring record into an event entry: date, message text
+ * and VF handle.
+ *
+ *  \note   Message formats and VF handles are fetched from the KMD on first
+ * use and cached in the rings. A field that cannot be rendered is left empty.
+ *
+ *  \param [in] smi_req - Request context used for the KMD queries.
+ *
+ *  \param [in,out] rings - Event rings of the set.
+ *
+ *  \param [in] dev_idx - Index of the device the record belongs to.
+ *
+ *  \param [in] record - Record to render.
+ *
+ *  \param [out] event - Rendered event.
+ */
+void amdsmi_event_render(smi_req_ctx *smi_req, struct smi_event_rings_s *rings, uint32_t dev_idx,
+			 const struct smi_event_record *record, amdsmi_event_entry_t *event);
+
 /**
  *  \brief  Util function for converting pcie speed from pcie type.
  *
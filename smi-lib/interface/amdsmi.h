@@ -49,6 +49,27 @@ typedef enum {
 	AMDSMI_INIT_AMD_APUS = (AMDSMI_INIT_AMD_CPUS | AMDSMI_INIT_AMD_GPUS) // Default option
 } amdsmi_init_flags_t;
 
+/**
+ * @brief Give every calling thread its own driver connection.
+ *
+ * May be OR'd with ::amdsmi_init_flags_t values. Each thread that calls into the library
+ * opens a dedicated file handle on first use, so requests issued from different threads
+ * are not serialized on a single connection. Has no effect if the library is built
+ * without THREAD_SAFE.
+ */
+#define AMDSMI_INIT_CONCURRENT (1ULL << 32)
+
+/**
+ * @brief Serve telemetry reads from the driver's shared metrics snapshot.
+ *
+ * May be OR'd with ::amdsmi_init_flags_t values. The library maps a read-only region that
+ * the driver refreshes periodically and answers GPU activity, power, clock and temperature
+ * queries from it without a call into the driver, so values may be as old as the driver's
+ * refresh interval. Queries go to the driver as usual when the snapshot is not available
+ * or was last refreshed more than a second ago.
+ */
+#define AMDSMI_INIT_METRICS_SNAPSHOT (1ULL << 33)
+
 /**
  * @brief Maximum size definitions AMDSMI
  */
@@ -59,6 +80,7 @@ typedef enum {
 #define AMDSMI_MAX_DRIVER_INFO_RSVD	 64
 #define AMDSMI_MAX_MM_IP_COUNT		 8
 #define AMDSMI_MAX_CACHE_TYPES 10
+#define AMDSMI_MAX_SCHED_EVENT_STATS 52
 #define AMDSMI_MAX_NUM_PM_POLICIES 32
 #define AMDSMI_MAX_NAME 32
 
@@ -145,6 +167,7 @@ typedef enum {
 typedef void *amdsmi_socket_handle;
 typedef void *amdsmi_event_set;
 typedef void *amdsmi_processor_handle;
+typedef void *amdsmi_batch;
 
 /**
  * @brief ENUMERATORS
@@ -1184,6 +1207,30 @@ typedef struct {
 	uint32_t reserved[15];
 } amdsmi_gpu_cache_info_t;
 
+typedef struct {
+	uint32_t event_id; /* scheduler event id, 0xffffffff for ids without a bucket of their own */
+	uint32_t reserved;
+	uint64_t queued; /* requests queued */
+	uint64_t coalesced; /* requests answered together with an identical queued request */
+	uint64_t skipped; /* requests dropped without being handled */
+	uint64_t handled; /* requests that went through a handler */
+	uint64_t wait_sum; /* us from queueing to handler start, summed over handled requests */
+	uint64_t run_sum; /* us from handler start to completion, summed over handled requests */
+	uint32_t wait_max;
+	uint32_t wait_p99; /* upper bound in us of the 99th percentile */
+	uint32_t run_max;
+	uint32_t run_p99;
+} amdsmi_sched_event_stat_t;
+
+typedef struct {
+	uint32_t num_events;
+	uint32_t reserved;
+	uint64_t depth; /* requests queued or being handled */
+	uint64_t max_depth;
+	amdsmi_sched_event_stat_t event[AMDSMI_MAX_SCHED_EVENT_STATS];
+	uint64_t reserved1;
+} amdsmi_sched_event_stats_t;
+
 typedef struct {
 	uint8_t num_fw_info;
 	struct {
@@ -1649,7 +1696,9 @@ typedef struct {
  *
  *  @param[in] init_flags Bit flags that tell AMDSMI how to initialize. Values of
  *  amdsmi_init_flags_t enum may be OR'd together and passed through init_flags parameter
- *  to modify how AMDSMI initializes.
+ *  to modify how AMDSMI initializes. ::AMDSMI_INIT_CONCURRENT may be added to open a
+ *  separate driver connection per calling thread. ::AMDSMI_INIT_METRICS_SNAPSHOT may be
+ *  added to read telemetry from the driver's shared metrics snapshot.
  *
  *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
  */
@@ -2177,6 +2226,20 @@ amdsmi_status_t amdsmi_get_temp_metric(amdsmi_processor_handle processor_handle,
  */
 amdsmi_status_t amdsmi_get_gpu_cache_info(amdsmi_processor_handle processor_handle, amdsmi_gpu_cache_info_t *info);
 
+/**
+ *  @brief Returns per event counters and latencies of the driver scheduler
+ *  event thread, along with its queue depth.
+ *
+ *  @param[in] processor_handle PF of a processor for which to query
+ *
+ *  @param[out] stats reference to the scheduler event stats struct.
+ *  Must be allocated by user.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_get_gpu_sched_event_stats(amdsmi_processor_handle processor_handle,
+						 amdsmi_sched_event_stats_t *stats);
+
 /**
  *  @brief Returns metrics information
  *
@@ -2236,6 +2299,144 @@ amdsmi_status_t amdsmi_set_soc_pstate(amdsmi_processor_handle processor_handle,
 
 /** @} */  // end of gpumon
 
+/*****************************************************************************/
+/** @defgroup batch Batched Queries
+ *  A batch collects several monitoring queries and resolves all of them
+ *  with a single driver request. Queries that need the same data from the
+ *  same processor share one driver command. A batch can be executed any
+ *  number of times; every execution refreshes all of its output buffers.
+ *  A batch must not be used from several threads at the same time.
+ *  @{
+ */
+
+/**
+ *  @brief Allocates an empty batch.
+ *
+ *  @param[out] batch Reference to the batch created by the library.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_create(amdsmi_batch *batch);
+
+/**
+ *  @brief Frees a batch. Output buffers registered in the batch are not touched.
+ *
+ *  @param[in] batch Batch to destroy.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_destroy(amdsmi_batch batch);
+
+/**
+ *  @brief Adds an ::amdsmi_get_gpu_activity query to the batch.
+ *
+ *  @param[in] batch Batch to extend.
+ *
+ *  @param[in] processor_handle PF of a processor for which to query
+ *
+ *  @param[out] info Reference to the gpu engine usage structure, filled on
+ *  every ::amdsmi_batch_execute call. Must stay valid while the batch is used.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_add_gpu_activity(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					      amdsmi_engine_usage_t *info);
+
+/**
+ *  @brief Adds an ::amdsmi_get_power_info query to the batch.
+ *
+ *  @param[in] batch Batch to extend.
+ *
+ *  @param[in] processor_handle PF of a processor for which to query
+ *
+ *  @param[out] info Reference to the gpu power structure, filled on
+ *  every ::amdsmi_batch_execute call. Must stay valid while the batch is used.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_add_power_info(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					    amdsmi_power_info_t *info);
+
+/**
+ *  @brief Adds an ::amdsmi_get_clock_info query to the batch.
+ *
+ *  @param[in] batch Batch to extend.
+ *
+ *  @param[in] processor_handle PF of a processor for which to query
+ *
+ *  @param[in] clk_type Enum representing the clock type to query.
+ *
+ *  @param[out] info Reference to the gpu clock structure, filled on
+ *  every ::amdsmi_batch_execute call. Must stay valid while the batch is used.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_add_clock_info(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					    amdsmi_clk_type_t clk_type, amdsmi_clk_info_t *info);
+
+/**
+ *  @brief Adds an ::amdsmi_get_temp_metric query to the batch.
+ *
+ *  @param[in] batch Batch to extend.
+ *
+ *  @param[in] processor_handle PF of a processor for which to query
+ *
+ *  @param[in] sensor_type Part of device from which temperature should be obtained.
+ *
+ *  @param[in] metric Enum indicating which temperature value should be retrieved.
+ *
+ *  @param[out] temperature Reference to the temperature value, filled on
+ *  every ::amdsmi_batch_execute call. Must stay valid while the batch is used.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_add_temp_metric(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					     amdsmi_temperature_type_t sensor_type,
+					     amdsmi_temperature_metric_t metric, int64_t *temperature);
+
+/**
+ *  @brief Adds an ::amdsmi_get_gpu_total_ecc_count query to the batch.
+ *
+ *  @param[in] batch Batch to extend.
+ *
+ *  @param[in] processor_handle PF of a processor for which to query
+ *
+ *  @param[out] ec Reference to the error count structure, filled on
+ *  every ::amdsmi_batch_execute call. Must stay valid while the batch is used.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_add_gpu_total_ecc_count(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+						     amdsmi_error_count_t *ec);
+
+/**
+ *  @brief Executes every query in the batch with a single driver request.
+ *
+ *  @note Failure of an individual query does not fail the call; use
+ *  ::amdsmi_batch_get_status to check each query. If the driver does not
+ *  support batching the queries are issued one by one.
+ *
+ *  @param[in] batch Batch to execute.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_execute(amdsmi_batch batch);
+
+/**
+ *  @brief Returns the result of one query from the last ::amdsmi_batch_execute call.
+ *
+ *  @param[in] batch Batch that was executed.
+ *
+ *  @param[in] index Index of the query, in the order the queries were added.
+ *
+ *  @param[out] status Status of the query.
+ *
+ *  @return ::amdsmi_status_t | ::AMDSMI_STATUS_SUCCESS on success, non-zero on fail
+ */
+amdsmi_status_t amdsmi_batch_get_status(amdsmi_batch batch, uint32_t index, amdsmi_status_t *status);
+
+/** @} */  // end of batch
+
 /*****************************************************************************/
 /** @defgroup eccinfo ECC information
  *  @{
@@ -2456,6 +2657,11 @@ amdsmi_event_create(amdsmi_processor_handle *processor_list, uint32_t num_device
  *  and GPU handles that originated the error and a 256B text buffer
  *  with a human-readable description of the error.
  *
+ *  @note When the driver exposes an event ring, events already queued for the
+ *  set are read from memory shared with the driver without entering it; if the
+ *  reader falls behind, the dropped events are reported as one
+ *  ::AMDSMI_EVENT_DRIVER_BUFFER_OVERFLOW event with their count in data.
+ *
  *  @param[in] set Event set to read from. Use the same variable set that was used
  *  in the ::amdsmi_event_create call.
  *
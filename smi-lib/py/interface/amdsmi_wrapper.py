@@ -192,6 +192,7 @@ amdsmi_init_flags_t__enumvalues = c__EA_amdsmi_init_flags_t__enumvalues
 amdsmi_socket_handle = ctypes.POINTER(None)
 amdsmi_event_set = ctypes.POINTER(None)
 amdsmi_processor_handle = ctypes.POINTER(None)
+amdsmi_batch = ctypes.POINTER(None)
 
 # values for enumeration 'c__EA_amdsmi_status_t'
 c__EA_amdsmi_status_t__enumvalues = {
@@ -2050,6 +2051,40 @@ struct_c__SA_amdsmi_gpu_cache_info_t._fields_ = [
 ]
 
 amdsmi_gpu_cache_info_t = struct_c__SA_amdsmi_gpu_cache_info_t
+class struct_c__SA_amdsmi_sched_event_stat_t(Structure):
+    pass
+
+struct_c__SA_amdsmi_sched_event_stat_t._pack_ = 1 # source:False
+struct_c__SA_amdsmi_sched_event_stat_t._fields_ = [
+    ('event_id', ctypes.c_uint32),
+    ('reserved', ctypes.c_uint32),
+    ('queued', ctypes.c_uint64),
+    ('coalesced', ctypes.c_uint64),
+    ('skipped', ctypes.c_uint64),
+    ('handled', ctypes.c_uint64),
+    ('wait_sum', ctypes.c_uint64),
+    ('run_sum', ctypes.c_uint64),
+    ('wait_max', ctypes.c_uint32),
+    ('wait_p99', ctypes.c_uint32),
+    ('run_max', ctypes.c_uint32),
+    ('run_p99', ctypes.c_uint32),
+]
+
+amdsmi_sched_event_stat_t = struct_c__SA_amdsmi_sched_event_stat_t
+class struct_c__SA_amdsmi_sched_event_stats_t(Structure):
+    pass
+
+struct_c__SA_amdsmi_sched_event_stats_t._pack_ = 1 # source:False
+struct_c__SA_amdsmi_sched_event_stats_t._fields_ = [
+    ('num_events', ctypes.c_uint32),
+    ('reserved', ctypes.c_uint32),
+    ('depth', ctypes.c_uint64),
+    ('max_depth', ctypes.c_uint64),
+    ('event', struct_c__SA_amdsmi_sched_event_stat_t * 52),
+    ('reserved1', ctypes.c_uint64),
+]
+
+amdsmi_sched_event_stats_t = struct_c__SA_amdsmi_sched_event_stats_t
 class struct_c__SA_amdsmi_fw_info_t(Structure):
     pass
 
@@ -2905,6 +2940,9 @@ amdsmi_get_temp_metric.argtypes = [amdsmi_processor_handle, amdsmi_temperature_t
 amdsmi_get_gpu_cache_info = _libraries['libamdsmi.so'].amdsmi_get_gpu_cache_info
 amdsmi_get_gpu_cache_info.restype = amdsmi_status_t
 amdsmi_get_gpu_cache_info.argtypes = [amdsmi_processor_handle, ctypes.POINTER(struct_c__SA_amdsmi_gpu_cache_info_t)]
+amdsmi_get_gpu_sched_event_stats = _libraries['libamdsmi.so'].amdsmi_get_gpu_sched_event_stats
+amdsmi_get_gpu_sched_event_stats.restype = amdsmi_status_t
+amdsmi_get_gpu_sched_event_stats.argtypes = [amdsmi_processor_handle, ctypes.POINTER(struct_c__SA_amdsmi_sched_event_stats_t)]
 amdsmi_get_gpu_metrics = _libraries['libamdsmi.so'].amdsmi_get_gpu_metrics
 amdsmi_get_gpu_metrics.restype = amdsmi_status_t
 amdsmi_get_gpu_metrics.argtypes = [amdsmi_processor_handle, ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(struct_c__SA_amdsmi_metric_t)]
@@ -2914,6 +2952,33 @@ amdsmi_get_soc_pstate.argtypes = [amdsmi_processor_handle, ctypes.POINTER(struct
 amdsmi_set_soc_pstate = _libraries['libamdsmi.so'].amdsmi_set_soc_pstate
 amdsmi_set_soc_pstate.restype = amdsmi_status_t
 amdsmi_set_soc_pstate.argtypes = [amdsmi_processor_handle, uint32_t]
+amdsmi_batch_create = _libraries['libamdsmi.so'].amdsmi_batch_create
+amdsmi_batch_create.restype = amdsmi_status_t
+amdsmi_batch_create.argtypes = [ctypes.POINTER(ctypes.POINTER(None))]
+amdsmi_batch_destroy = _libraries['libamdsmi.so'].amdsmi_batch_destroy
+amdsmi_batch_destroy.restype = amdsmi_status_t
+amdsmi_batch_destroy.argtypes = [amdsmi_batch]
+amdsmi_batch_add_gpu_activity = _libraries['libamdsmi.so'].amdsmi_batch_add_gpu_activity
+amdsmi_batch_add_gpu_activity.restype = amdsmi_status_t
+amdsmi_batch_add_gpu_activity.argtypes = [amdsmi_batch, amdsmi_processor_handle, ctypes.POINTER(struct_c__SA_amdsmi_engine_usage_t)]
+amdsmi_batch_add_power_info = _libraries['libamdsmi.so'].amdsmi_batch_add_power_info
+amdsmi_batch_add_power_info.restype = amdsmi_status_t
+amdsmi_batch_add_power_info.argtypes = [amdsmi_batch, amdsmi_processor_handle, ctypes.POINTER(struct_c__SA_amdsmi_power_info_t)]
+amdsmi_batch_add_clock_info = _libraries['libamdsmi.so'].amdsmi_batch_add_clock_info
+amdsmi_batch_add_clock_info.restype = amdsmi_status_t
+amdsmi_batch_add_clock_info.argtypes = [amdsmi_batch, amdsmi_processor_handle, amdsmi_clk_type_t, ctypes.POINTER(struct_c__SA_amdsmi_clk_info_t)]
+amdsmi_batch_add_temp_metric = _libraries['libamdsmi.so'].amdsmi_batch_add_temp_metric
+amdsmi_batch_add_temp_metric.restype = amdsmi_status_t
+amdsmi_batch_add_temp_metric.argtypes = [amdsmi_batch, amdsmi_processor_handle, amdsmi_temperature_type_t, amdsmi_temperature_metric_t, ctypes.POINTER(ctypes.c_int64)]
+amdsmi_batch_add_gpu_total_ecc_count = _libraries['libamdsmi.so'].amdsmi_batch_add_gpu_total_ecc_count
+amdsmi_batch_add_gpu_total_ecc_count.restype = amdsmi_status_t
+amdsmi_batch_add_gpu_total_ecc_count.argtypes = [amdsmi_batch, amdsmi_processor_handle, ctypes.POINTER(struct_c__SA_amdsmi_error_count_t)]
+amdsmi_batch_execute = _libraries['libamdsmi.so'].amdsmi_batch_execute
+amdsmi_batch_execute.restype = amdsmi_status_t
+amdsmi_batch_execute.argtypes = [amdsmi_batch]
+amdsmi_batch_get_status = _libraries['libamdsmi.so'].amdsmi_batch_get_status
+amdsmi_batch_get_status.restype = amdsmi_status_t
+amdsmi_batch_get_status.argtypes = [amdsmi_batch, uint32_t, ctypes.POINTER(c__EA_amdsmi_status_t)]
 amdsmi_get_gpu_total_ecc_count = _libraries['libamdsmi.so'].amdsmi_get_gpu_total_ecc_count
 amdsmi_get_gpu_total_ecc_count.restype = amdsmi_status_t
 amdsmi_get_gpu_total_ecc_count.argtypes = [amdsmi_processor_handle, ctypes.POINTER(struct_c__SA_amdsmi_error_count_t)]
@@ -3498,8 +3563,13 @@ __all__ = \
     'amdsmi_accelerator_partition_resource_type_t__enumvalues',
     'amdsmi_accelerator_partition_type_t',
     'amdsmi_accelerator_partition_type_t__enumvalues',
-    'amdsmi_asic_info_t', 'amdsmi_bdf_t', 'amdsmi_board_info_t',
-    'amdsmi_cache_property_type_t',
+    'amdsmi_asic_info_t', 'amdsmi_batch',
+    'amdsmi_batch_add_clock_info', 'amdsmi_batch_add_gpu_activity',
+    'amdsmi_batch_add_gpu_total_ecc_count',
+    'amdsmi_batch_add_power_info', 'amdsmi_batch_add_temp_metric',
+    'amdsmi_batch_create', 'amdsmi_batch_destroy',
+    'amdsmi_batch_execute', 'amdsmi_batch_get_status', 'amdsmi_bdf_t',
+    'amdsmi_board_info_t', 'amdsmi_cache_property_type_t',
     'amdsmi_cache_property_type_t__enumvalues',
     'amdsmi_card_form_factor_t',
     'amdsmi_card_form_factor_t__enumvalues', 'amdsmi_clear_vf_fb',
@@ -3550,6 +3620,7 @@ __all__ = \
     'amdsmi_get_gpu_ecc_enabled',
     'amdsmi_get_gpu_memory_partition_config',
     'amdsmi_get_gpu_metrics', 'amdsmi_get_gpu_ras_feature_info',
+    'amdsmi_get_gpu_sched_event_stats',
     'amdsmi_get_gpu_total_ecc_count', 'amdsmi_get_gpu_vbios_info',
     'amdsmi_get_gpu_vram_info', 'amdsmi_get_guest_data',
     'amdsmi_get_index_from_processor_handle',
@@ -3599,7 +3670,8 @@ __all__ = \
     'amdsmi_profile_capability_type_t__enumvalues',
     'amdsmi_profile_caps_info_t', 'amdsmi_profile_info_t',
     'amdsmi_ras_feature_t', 'amdsmi_sched_block_t',
-    'amdsmi_sched_block_t__enumvalues', 'amdsmi_sched_info_t',
+    'amdsmi_sched_block_t__enumvalues', 'amdsmi_sched_event_stat_t',
+    'amdsmi_sched_event_stats_t', 'amdsmi_sched_info_t',
     'amdsmi_set_gpu_accelerator_partition_profile',
     'amdsmi_set_gpu_memory_partition_mode', 'amdsmi_set_num_vf',
     'amdsmi_set_power_cap', 'amdsmi_set_soc_pstate',
@@ -3694,6 +3766,8 @@ __all__ = \
     'struct_c__SA_amdsmi_profile_info_t',
     'struct_c__SA_amdsmi_profile_info_t_0',
     'struct_c__SA_amdsmi_ras_feature_t',
+    'struct_c__SA_amdsmi_sched_event_stat_t',
+    'struct_c__SA_amdsmi_sched_event_stats_t',
     'struct_c__SA_amdsmi_sched_info_t',
     'struct_c__SA_amdsmi_vbios_info_t',
     'struct_c__SA_amdsmi_version_t', 'struct_c__SA_amdsmi_vf_data_t',
@@ -111,7 +111,6 @@ static int get_available_devices(smi_req_ctx *smi_req)
 
 amdsmi_status_t amdsmi_init(uint64_t init_flags)
 {
-	AMDSMI_UNUSED(init_flags);
 	#pragma SMI_EXPORT
 	smi_req_ctx smi_req;
 	system_wrapper *sys_wrapper = get_system_wrapper();
@@ -128,9 +127,11 @@ amdsmi_status_t amdsmi_init(uint64_t init_flags)
 		return AMDSMI_STATUS_DRIVER_NOT_LOADED;
 	}
 
+	smi_req.handle->mode = SMI_RDWR;
 	smi_req.handle->fd = sys_wrapper->open(SMI_RDWR);
 	if (smi_req.handle->fd == SMI_INVAL_HANDLE) {
 		// fallback to not privileged
+		smi_req.handle->mode = SMI_READONLY;
 		smi_req.handle->fd = sys_wrapper->open(SMI_READONLY);
 		if (smi_req.handle->fd == SMI_INVAL_HANDLE) {
 			if (SMI_LAST_ERROR == SMI_ACCESS_DENIED) {
@@ -157,6 +158,19 @@ amdsmi_status_t amdsmi_init(uint64_t init_flags)
 		return ret;
 	}
 
+#ifdef THREAD_SAFE
+	smi_req.handle->concurrent = (init_flags & AMDSMI_INIT_CONCURRENT) != 0;
+#endif
+
+	smi_req.handle->snapshot = NULL;
+	if (init_flags & AMDSMI_INIT_METRICS_SNAPSHOT) {
+		smi_req.handle->snapshot = sys_wrapper->mmap(smi_req.handle->fd,
+							     SMI_METRICS_SNAPSHOT_SIZE);
+		if (smi_req.handle->snapshot == NULL) {
+			SMI_DEBUG("Metrics snapshot not available, using ioctl for telemetry");
+		}
+	}
+
 	AMDSMI_HANDLE_SET;
 
 	return AMDSMI_STATUS_SUCCESS;
@@ -170,6 +184,18 @@ amdsmi_status_t amdsmi_shut_down(void)
 
 	AMDSMI_ESCAPE_IF_NOT_INIT_ON_FINI;
 
+#ifdef THREAD_SAFE
+	smi_thread_detach_all(smi_req.handle);
+	/* the calling thread is not in an ioctl, close its own fd now */
+	smi_thread_release(smi_req.thread);
+	smi_req.handle->concurrent = false;
+#endif
+
+	if (smi_req.handle->snapshot != NULL) {
+		sys_wrapper->munmap(smi_req.handle->snapshot, SMI_METRICS_SNAPSHOT_SIZE);
+		smi_req.handle->snapshot = NULL;
+	}
+
 	if ((int)(intptr_t)smi_req.handle->fd != (int)(intptr_t)SMI_INVAL_HANDLE) {
 		if (sys_wrapper->close(smi_req.handle->fd) == -1) {
 			SMI_ERROR("Couldn't close the fd. Return code: %d", AMDSMI_STATUS_IO);
@@ -1192,6 +1218,55 @@ amdsmi_status_t amdsmi_get_dfc_fw_table(amdsmi_processor_handle processor_handle
 #endif
 }
 
+static void smi_fill_gpu_activity(const struct smi_gpu_performance_info *gpu_performance_info,
+				  amdsmi_engine_usage_t *info)
+{
+	memset(info, 0, sizeof(amdsmi_engine_usage_t));
+	info->gfx_activity = gpu_performance_info->usage.gfx_activity;
+	info->umc_activity = gpu_performance_info->usage.umc_activity;
+	info->mm_activity = gpu_performance_info->usage.mm_activity;
+}
+
+static void smi_fill_power_info(const struct smi_gpu_performance_info *gpu_performance_info,
+				amdsmi_power_info_t *info)
+{
+	memset(info, 0, sizeof(amdsmi_power_info_t));
+	info->socket_power = gpu_performance_info->power.socket_power;
+	info->gfx_voltage = gpu_performance_info->power.gfx_voltage;
+	info->soc_voltage = gpu_performance_info->power.soc_voltage;
+	info->mem_voltage = gpu_performance_info->power.mem_voltage;
+}
+
+static void smi_fill_clock_info(const struct smi_gpu_performance_info *gpu_performance_info,
+				amdsmi_clk_type_t clk_type, amdsmi_clk_info_t *info)
+{
+	memset(info, 0, sizeof(amdsmi_clk_info_t));
+	info->clk = gpu_performance_info->clock.cur_clk[clk_type];
+	info->max_clk = gpu_performance_info->clock.max_clk[clk_type];
+	info->min_clk = gpu_performance_info->clock.min_clk[clk_type];
+	info->clk_locked = gpu_performance_info->clock.clk_locked[clk_type];
+	info->clk_deep_sleep = gpu_performance_info->clock.clk_deep_sleep[clk_type];
+}
+
+static void smi_fill_temp_metric(const struct smi_gpu_performance_info *gpu_performance_info,
+				 amdsmi_temperature_type_t sensor_type,
+				 amdsmi_temperature_metric_t metric, int64_t *temperature)
+{
+	switch (metric) {
+	case AMDSMI_TEMP_CURRENT:
+		*temperature = gpu_performance_info->temp.temp[sensor_type];
+		break;
+	case AMDSMI_TEMP_CRITICAL:
+		*temperature = gpu_performance_info->temp_limit.temp[sensor_type];
+		break;
+	case AMDSMI_TEMP_SHUTDOWN:
+		*temperature = gpu_performance_info->temp_shutdown.temp[sensor_type];
+		break;
+	default:
+		*temperature = (int64_t)0;
+	}
+}
+
 amdsmi_status_t amdsmi_get_gpu_activity(amdsmi_processor_handle processor_handle, amdsmi_engine_usage_t *info)
 {
 	#pragma SMI_EXPORT
@@ -1216,11 +1291,7 @@ amdsmi_status_t amdsmi_get_gpu_activity(amdsmi_processor_handle processor_handle
 
 	gpu_performance_info = (struct smi_gpu_performance_info *)&smi_req.thread->ioctl_cmd.payload;
 
-	memset(info, 0, sizeof(amdsmi_engine_usage_t));
-	info->gfx_activity = gpu_performance_info->usage.gfx_activity;
-	info->umc_activity = gpu_performance_info->usage.umc_activity;
-	info->mm_activity = gpu_performance_info->usage.mm_activity;
-
+	smi_fill_gpu_activity(gpu_performance_info, info);
 
 	return AMDSMI_STATUS_SUCCESS;
 }
@@ -1250,11 +1321,7 @@ amdsmi_status_t amdsmi_get_power_info(amdsmi_processor_handle processor_handle,
 
 	gpu_performance_info = (struct smi_gpu_performance_info *)&smi_req.thread->ioctl_cmd.payload;
 
-	memset(info, 0, sizeof(amdsmi_power_info_t));
-	info->socket_power = gpu_performance_info->power.socket_power;
-	info->gfx_voltage = gpu_performance_info->power.gfx_voltage;
-	info->soc_voltage = gpu_performance_info->power.soc_voltage;
-	info->mem_voltage = gpu_performance_info->power.mem_voltage;
+	smi_fill_power_info(gpu_performance_info, info);
 
 	return AMDSMI_STATUS_SUCCESS;
 }
@@ -1355,12 +1422,7 @@ amdsmi_status_t amdsmi_get_clock_info(amdsmi_processor_handle processor_handle,
 
 	gpu_performance_info = (struct smi_gpu_performance_info *)&smi_req.thread->ioctl_cmd.payload;
 
-	memset(info, 0, sizeof(amdsmi_clk_info_t));
-	info->clk = gpu_performance_info->clock.cur_clk[clk_type];
-	info->max_clk = gpu_performance_info->clock.max_clk[clk_type];
-	info->min_clk = gpu_performance_info->clock.min_clk[clk_type];
-	info->clk_locked = gpu_performance_info->clock.clk_locked[clk_type];
-	info->clk_deep_sleep = gpu_performance_info->clock.clk_deep_sleep[clk_type];
+	smi_fill_clock_info(gpu_performance_info, clk_type, info);
 
 	return AMDSMI_STATUS_SUCCESS;
 }
@@ -1412,19 +1474,7 @@ amdsmi_status_t amdsmi_get_temp_metric(amdsmi_processor_handle processor_handle,
 
 	gpu_performance_info = (struct smi_gpu_performance_info *)&smi_req.thread->ioctl_cmd.payload;
 
-	switch (metric) {
-	case AMDSMI_TEMP_CURRENT:
-		*temperature = gpu_performance_info->temp.temp[sensor_type];
-		break;
-	case AMDSMI_TEMP_CRITICAL:
-		*temperature = gpu_performance_info->temp_limit.temp[sensor_type];
-		break;
-	case AMDSMI_TEMP_SHUTDOWN:
-		*temperature = gpu_performance_info->temp_shutdown.temp[sensor_type];
-		break;
-	default:
-		*temperature = (int64_t)0;
-	}
+	smi_fill_temp_metric(gpu_performance_info, sensor_type, metric, temperature);
 
 	return AMDSMI_STATUS_SUCCESS;
 }
@@ -1474,6 +1524,66 @@ amdsmi_status_t amdsmi_get_gpu_cache_info(amdsmi_processor_handle processor_hand
 	return AMDSMI_STATUS_SUCCESS;
 }
 
+amdsmi_status_t amdsmi_get_gpu_sched_event_stats(amdsmi_processor_handle processor_handle,
+						 amdsmi_sched_event_stats_t *stats)
+{
+	#pragma SMI_EXPORT
+	struct smi_sched_event_stats *sched_stats = NULL;
+	struct smi_device_info *gpu = NULL;
+	smi_device_handle_t pf;
+	smi_req_ctx smi_req;
+
+	AMDSMI_ESCAPE_IF_NOT_INIT;
+
+	if (processor_handle == NULL || stats == NULL) {
+		SMI_ERROR("Nullpointer given as input. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	smi_device_handle_t *dev_handle = ((smi_device_handle_t *)processor_handle);
+	pf.handle = dev_handle->handle;
+	gpu = (struct smi_device_info *)&smi_req.thread->ioctl_cmd.payload;
+	gpu->dev_id.handle = pf.handle;
+	int code = amdsmi_request(&smi_req, (uint32_t)SMI_CMD_CODE_GET_SCHED_EVENT_STATS,
+			sizeof(struct smi_device_info),
+			sizeof(struct smi_sched_event_stats));
+	if (code != AMDSMI_STATUS_SUCCESS) {
+		SMI_ERROR("Ioctl call failed. Return code: %d", code);
+		return code;
+	}
+
+	sched_stats = (struct smi_sched_event_stats *)&smi_req.thread->ioctl_cmd.payload;
+
+	memset(stats, 0, sizeof(amdsmi_sched_event_stats_t));
+	stats->num_events = sched_stats->num_events < AMDSMI_MAX_SCHED_EVENT_STATS ?
+			    sched_stats->num_events : AMDSMI_MAX_SCHED_EVENT_STATS;
+	stats->depth = sched_stats->depth;
+	stats->max_depth = sched_stats->max_depth;
+	for (uint32_t i = 0; i < stats->num_events; i++) {
+		stats->event[i].event_id = sched_stats->event[i].event_id;
+		stats->event[i].queued = sched_stats->event[i].queued;
+		stats->event[i].coalesced = sched_stats->event[i].coalesced;
+		stats->event[i].skipped = sched_stats->event[i].skipped;
+		stats->event[i].handled = sched_stats->event[i].handled;
+		stats->event[i].wait_sum = sched_stats->event[i].wait_sum;
+		stats->event[i].run_sum = sched_stats->event[i].run_sum;
+		stats->event[i].wait_max = sched_stats->event[i].wait_max;
+		stats->event[i].wait_p99 = sched_stats->event[i].wait_p99;
+		stats->event[i].run_max = sched_stats->event[i].run_max;
+		stats->event[i].run_p99 = sched_stats->event[i].run_p99;
+	}
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+static void smi_fill_total_ecc_count(const struct smi_ecc_info *ecc_info, amdsmi_error_count_t *ec)
+{
+	memset(ec, 0, sizeof(amdsmi_error_count_t));
+	ec->correctable_count = ecc_info->err_count.correctable_count;
+	ec->uncorrectable_count = ecc_info->err_count.uncorrectable_count;
+	ec->deferred_count = ecc_info->err_count.deferred_count;
+}
+
 amdsmi_status_t amdsmi_get_gpu_total_ecc_count(amdsmi_processor_handle processor_handle, amdsmi_error_count_t *ec)
 {
 	#pragma SMI_EXPORT
@@ -1498,10 +1608,224 @@ amdsmi_status_t amdsmi_get_gpu_total_ecc_count(amdsmi_processor_handle processor
 
 	ecc_info = (struct smi_ecc_info *)&smi_req.thread->ioctl_cmd.payload;
 
-	memset(ec, 0, sizeof(amdsmi_error_count_t));
-	ec->correctable_count = ecc_info->err_count.correctable_count;
-	ec->uncorrectable_count = ecc_info->err_count.uncorrectable_count;
-	ec->deferred_count = ecc_info->err_count.deferred_count;
+	smi_fill_total_ecc_count(ecc_info, ec);
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t amdsmi_batch_create(amdsmi_batch *batch)
+{
+	#pragma SMI_EXPORT
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	struct smi_batch_s *batch_handle = NULL;
+
+	if (batch == NULL) {
+		SMI_ERROR("Nullpointer given as input. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	batch_handle = sys_wrapper->calloc(1, sizeof(struct smi_batch_s));
+	if (batch_handle == NULL) {
+		SMI_ERROR("Failed to allocate memory for batch. Return code: %d", AMDSMI_STATUS_OUT_OF_RESOURCES);
+		return AMDSMI_STATUS_OUT_OF_RESOURCES;
+	}
+
+	*batch = batch_handle;
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t amdsmi_batch_destroy(amdsmi_batch batch)
+{
+	#pragma SMI_EXPORT
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	struct smi_batch_s *batch_handle = (struct smi_batch_s *)batch;
+
+	if (batch_handle == NULL)
+		return AMDSMI_STATUS_SUCCESS;
+
+	sys_wrapper->free(batch_handle->buffer);
+	sys_wrapper->free(batch_handle);
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+static amdsmi_status_t smi_batch_add_query(struct smi_batch_s *batch, amdsmi_processor_handle processor_handle,
+					   enum smi_batch_query_type type, uint32_t arg0, uint32_t arg1, void *out)
+{
+	struct smi_batch_query *query;
+	struct smi_device_info_ex gpu_ex;
+	struct smi_device_info gpu;
+	amdsmi_status_t code;
+	uint32_t entry;
+
+	if (batch == NULL || processor_handle == NULL || out == NULL) {
+		SMI_ERROR("Nullpointer given as input. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	if (batch->num_queries == SMI_MAX_BATCH_ENTRIES) {
+		SMI_ERROR("Batch is full. Return code: %d", AMDSMI_STATUS_OUT_OF_RESOURCES);
+		return AMDSMI_STATUS_OUT_OF_RESOURCES;
+	}
+
+	if (type == SMI_BATCH_QUERY_TOTAL_ECC_COUNT) {
+		memset(&gpu, 0, sizeof(gpu));
+		gpu.dev_id.handle = ((smi_device_handle_t *)processor_handle)->handle;
+		code = amdsmi_batch_add_entry(batch, (uint32_t)SMI_CMD_CODE_GET_ECC_STATUS,
+					      &gpu, sizeof(struct smi_device_info),
+					      sizeof(struct smi_ecc_info), &entry);
+	} else {
+		memset(&gpu_ex, 0, sizeof(gpu_ex));
+		gpu_ex.dev_id.handle = ((smi_device_handle_t *)processor_handle)->handle;
+		code = amdsmi_batch_add_entry(batch, (uint32_t)SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO,
+					      &gpu_ex, sizeof(struct smi_device_info_ex),
+					      sizeof(struct smi_gpu_performance_info), &entry);
+	}
+	if (code != AMDSMI_STATUS_SUCCESS)
+		return code;
+
+	query = &batch->queries[batch->num_queries++];
+	query->type = type;
+	query->entry = entry;
+	query->arg[0] = arg0;
+	query->arg[1] = arg1;
+	query->out = out;
+	query->status = AMDSMI_STATUS_NO_DATA;
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t amdsmi_batch_add_gpu_activity(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					      amdsmi_engine_usage_t *info)
+{
+	#pragma SMI_EXPORT
+	return smi_batch_add_query((struct smi_batch_s *)batch, processor_handle,
+				   SMI_BATCH_QUERY_GPU_ACTIVITY, 0, 0, info);
+}
+
+amdsmi_status_t amdsmi_batch_add_power_info(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					    amdsmi_power_info_t *info)
+{
+	#pragma SMI_EXPORT
+	return smi_batch_add_query((struct smi_batch_s *)batch, processor_handle,
+				   SMI_BATCH_QUERY_POWER_INFO, 0, 0, info);
+}
+
+amdsmi_status_t amdsmi_batch_add_clock_info(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					    amdsmi_clk_type_t clk_type, amdsmi_clk_info_t *info)
+{
+	#pragma SMI_EXPORT
+	if (clk_type > AMDSMI_CLK_TYPE__MAX) {
+		SMI_ERROR("Passed GPU clock type is not valid. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	return smi_batch_add_query((struct smi_batch_s *)batch, processor_handle,
+				   SMI_BATCH_QUERY_CLOCK_INFO, (uint32_t)clk_type, 0, info);
+}
+
+amdsmi_status_t amdsmi_batch_add_temp_metric(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+					     amdsmi_temperature_type_t sensor_type,
+					     amdsmi_temperature_metric_t metric, int64_t *temperature)
+{
+	#pragma SMI_EXPORT
+	if (sensor_type > AMDSMI_TEMPERATURE_TYPE__MAX) {
+		SMI_ERROR("Passed GPU sensor type is not valid. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	return smi_batch_add_query((struct smi_batch_s *)batch, processor_handle,
+				   SMI_BATCH_QUERY_TEMP_METRIC, (uint32_t)sensor_type, (uint32_t)metric,
+				   temperature);
+}
+
+amdsmi_status_t amdsmi_batch_add_gpu_total_ecc_count(amdsmi_batch batch, amdsmi_processor_handle processor_handle,
+						     amdsmi_error_count_t *ec)
+{
+	#pragma SMI_EXPORT
+	return smi_batch_add_query((struct smi_batch_s *)batch, processor_handle,
+				   SMI_BATCH_QUERY_TOTAL_ECC_COUNT, 0, 0, ec);
+}
+
+static void smi_batch_fill_query(struct smi_batch_s *batch, struct smi_batch_query *query)
+{
+	struct smi_batch_entry *entry = &batch->entries[query->entry];
+	const void *data = batch->buffer + entry->out_offset;
+
+	query->status = (amdsmi_status_t)entry->status;
+	if (query->status != AMDSMI_STATUS_SUCCESS)
+		return;
+
+	switch (query->type) {
+	case SMI_BATCH_QUERY_GPU_ACTIVITY:
+		smi_fill_gpu_activity(data, query->out);
+		break;
+	case SMI_BATCH_QUERY_POWER_INFO:
+		smi_fill_power_info(data, query->out);
+		break;
+	case SMI_BATCH_QUERY_CLOCK_INFO:
+		smi_fill_clock_info(data, (amdsmi_clk_type_t)query->arg[0], query->out);
+		break;
+	case SMI_BATCH_QUERY_TEMP_METRIC:
+		/* Same sensors as amdsmi_get_temp_metric reports as zero */
+		if (query->arg[0] > AMDSMI_TEMPERATURE_TYPE_VRAM)
+			*(int64_t *)query->out = (int64_t)0;
+		else
+			smi_fill_temp_metric(data, (amdsmi_temperature_type_t)query->arg[0],
+					     (amdsmi_temperature_metric_t)query->arg[1], query->out);
+		break;
+	case SMI_BATCH_QUERY_TOTAL_ECC_COUNT:
+		smi_fill_total_ecc_count(data, query->out);
+		break;
+	}
+}
+
+amdsmi_status_t amdsmi_batch_execute(amdsmi_batch batch)
+{
+	#pragma SMI_EXPORT
+	struct smi_batch_s *batch_handle = (struct smi_batch_s *)batch;
+	smi_req_ctx smi_req;
+	uint32_t i;
+
+	AMDSMI_ESCAPE_IF_NOT_INIT;
+
+	if (batch_handle == NULL) {
+		SMI_ERROR("Nullpointer given as input. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	if (batch_handle->num_entries == 0)
+		return AMDSMI_STATUS_SUCCESS;
+
+	const int code = amdsmi_ioctl_batch(&smi_req, batch_handle);
+	if (code != AMDSMI_STATUS_SUCCESS) {
+		SMI_ERROR("Ioctl call failed. Return code: %d", code);
+		return code;
+	}
+
+	for (i = 0; i < batch_handle->num_queries; i++)
+		smi_batch_fill_query(batch_handle, &batch_handle->queries[i]);
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t amdsmi_batch_get_status(amdsmi_batch batch, uint32_t index, amdsmi_status_t *status)
+{
+	#pragma SMI_EXPORT
+	struct smi_batch_s *batch_handle = (struct smi_batch_s *)batch;
+
+	if (batch_handle == NULL || status == NULL) {
+		SMI_ERROR("Nullpointer given as input. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	if (index >= batch_handle->num_queries) {
+		SMI_ERROR("Query index out of range. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	*status = batch_handle->queries[index].status;
 
 	return AMDSMI_STATUS_SUCCESS;
 }
@@ -1972,6 +2296,7 @@ amdsmi_status_t amdsmi_event_create(amdsmi_processor_handle *processor_list, uin
 	}
 
 	event_set_handle->num_handles = num_devices;
+	event_set_handle->rings = NULL;
 
 	config = (struct smi_event_set_config *)&smi_req.thread->ioctl_cmd.payload;
 	event_set = (smi_event_handle_t *)&smi_req.thread->ioctl_cmd.payload;
@@ -2012,6 +2337,17 @@ amdsmi_status_t amdsmi_event_create(amdsmi_processor_handle *processor_list, uin
 		event_set_handle->handles[i].as_ptr = event_set->as_ptr;
 #endif
 	}
+#ifndef _WIN64
+	const int ring_code = amdsmi_event_ring_map(event_set_handle);
+	if (ring_code != AMDSMI_STATUS_SUCCESS) {
+		for (uint32_t i = 0; i < num_devices; ++i)
+			sys_wrapper->close(event_set_handle->handles[i].fd);
+		sys_wrapper->free(event_set_handle->devices);
+		sys_wrapper->free(event_set_handle->handles);
+		sys_wrapper->free(event_set_handle);
+		return ring_code;
+	}
+#endif
 	event_set_handle->_private = sys_wrapper->poll_alloc(event_set_handle->handles,
 							     event_set_handle->num_handles);
 	*set = event_set_handle;
@@ -2019,6 +2355,47 @@ amdsmi_status_t amdsmi_event_create(amdsmi_processor_handle *processor_list, uin
 	return AMDSMI_STATUS_SUCCESS;
 }
 
+#ifndef _WIN64
+/* Records are pushed by the driver, the poll only waits for the next batch */
+static amdsmi_status_t amdsmi_event_read_ring(struct smi_event_set_s *event_set, int64_t timeout_usec,
+					      amdsmi_event_entry_t *event)
+{
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	struct smi_event_rings_s *rings = event_set->rings;
+	struct smi_event_record record;
+	smi_req_ctx smi_req;
+	uint32_t dev_idx;
+	int poll_res;
+
+	AMDSMI_ESCAPE_IF_NOT_INIT;
+
+	for (;;) {
+#ifdef THREAD_SAFE
+		smi_mutex_lock(&rings->lock);
+#endif
+		if (amdsmi_event_ring_next(rings, &record, &dev_idx)) {
+			amdsmi_event_render(&smi_req, rings, dev_idx, &record, event);
+#ifdef THREAD_SAFE
+			smi_mutex_unlock(&rings->lock);
+#endif
+			return AMDSMI_STATUS_SUCCESS;
+		}
+#ifdef THREAD_SAFE
+		smi_mutex_unlock(&rings->lock);
+#endif
+
+		poll_res = sys_wrapper->poll(event_set, NULL, timeout_usec);
+		if (poll_res == AMDSMI_STATUS_TIMEOUT) {
+			SMI_ERROR("Result of poll call is AMDSMI_STATUS_TIMEOUT. Return code: %d", AMDSMI_STATUS_TIMEOUT);
+			return AMDSMI_STATUS_TIMEOUT;
+		} else if (poll_res != AMDSMI_STATUS_SUCCESS) {
+			SMI_ERROR("Poll call failed. Return code: %d", AMDSMI_STATUS_API_FAILED);
+			return AMDSMI_STATUS_API_FAILED;
+		}
+	}
+}
+#endif
+
 amdsmi_status_t amdsmi_event_read(amdsmi_event_set set, int64_t timeout_usec, amdsmi_event_entry_t *event)
 {
 	#pragma SMI_EXPORT
@@ -2037,6 +2414,11 @@ amdsmi_status_t amdsmi_event_read(amdsmi_event_set set, int64_t timeout_usec, am
 		return AMDSMI_STATUS_INVAL;
 	}
 
+#ifndef _WIN64
+	if (event_set->rings != NULL)
+		return amdsmi_event_read_ring(event_set, timeout_usec, event);
+#endif
+
 	int poll_res = sys_wrapper->poll(event_set, event, timeout_usec);
 
 	if (poll_res == AMDSMI_STATUS_TIMEOUT) {
@@ -2091,6 +2473,9 @@ amdsmi_status_t amdsmi_event_destroy(amdsmi_event_set set)
 		return AMDSMI_STATUS_SUCCESS;
 	}
 
+#ifndef _WIN64
+	amdsmi_event_ring_unmap(amdsmi_event_set);
+#endif
 	for (uint32_t i = 0; i < amdsmi_event_set->num_handles; ++i) {
 #ifdef _WIN64
 		gpu = (struct smi_device_info *)&smi_req.thread->ioctl_cmd.payload;
@@ -2971,6 +3356,7 @@ amdsmi_status_t amdsmi_gpu_get_cper_entries(amdsmi_processor_handle processor_ha
 	amdsmi_cper_hdr *hdr = NULL;
 	uint32_t entries_count = 0;
 	uint32_t real_buffer_size = 0;
+	bool legacy = false;
 	system_wrapper *sys_wrapper = get_system_wrapper();
 
 	AMDSMI_ESCAPE_IF_NOT_INIT;
@@ -3009,33 +3395,35 @@ amdsmi_status_t amdsmi_gpu_get_cper_entries(amdsmi_processor_handle processor_ha
 	const int code = amdsmi_request(&smi_req, (uint32_t)SMI_CMD_CODE_GET_CPER,
 					sizeof(struct smi_cper_config),
 					0);
-	if (code != AMDSMI_STATUS_SUCCESS) {
+	// MORE_DATA still carries the entries that fit
+	if (code != AMDSMI_STATUS_SUCCESS && code != AMDSMI_STATUS_MORE_DATA) {
 		SMI_ERROR("Ioctl call failed. Return code: %d", code);
 		sys_wrapper->free(cper);
 		return code;
 	}
 
-	*cursor = *cursor + cper_config->cper->entry_count;
+	// Since BETA_5 the driver filters by severity_mask and reports where to resume,
+	// older drivers return every record and expect a relative cursor
+	legacy = smi_req.handle->version < SMI_VERSION_BETA_5;
+	*cursor = legacy ? *cursor + cper->entry_count : cper->cursor;
 
-	for (uint32_t i = 0; i < cper_config->cper->entry_count; i++) {
-		hdr = (amdsmi_cper_hdr*)(cper_config->cper->cper_data + cper_config->cper->cper_hdrs[i]);
-		if (((hdr->error_severity & severity_mask) != 0) || (severity_mask == AMDSMI_CPER_SEV_NUM)) {
-			// add cper with appropriate severity
-			cper_hdrs[entries_count] = (amdsmi_cper_hdr*)(cper_config->cper->cper_data + cper_config->cper->cper_hdrs[i]);
-			memcpy(cper_data + cper_config->cper->cper_hdrs[i],
-					cper_config->cper->cper_data + cper_config->cper->cper_hdrs[i],
-					hdr->record_length);
+	for (uint32_t i = 0; i < cper->entry_count; i++) {
+		hdr = (amdsmi_cper_hdr*)(cper->cper_data + cper->cper_hdrs[i]);
+		if (legacy && (hdr->error_severity & severity_mask) == 0 &&
+		    severity_mask != AMDSMI_CPER_SEV_NUM)
+			continue;
+		memcpy(cper_data + real_buffer_size, hdr, hdr->record_length);
+		cper_hdrs[entries_count] = (amdsmi_cper_hdr*)(cper_data + real_buffer_size);
 
-			entries_count++;
-			real_buffer_size += hdr->record_length;
-		}
+		entries_count++;
+		real_buffer_size += hdr->record_length;
 	}
 
 	*entry_count = entries_count;
 	*buf_size = real_buffer_size;
 
 	sys_wrapper->free(cper);
-	return AMDSMI_STATUS_SUCCESS;
+	return code;
 }
 
 #ifdef __linux__
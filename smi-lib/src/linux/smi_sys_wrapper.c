@@ -34,10 +34,12 @@
 #include <stdlib.h>
 #include <poll.h>
 #include <sys/time.h>
+#include <time.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <string.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 
 #ifndef _WIN64
 #include "gim_ioctl.h"
@@ -106,6 +108,10 @@ static int amdsmi_lnx_poll(struct smi_event_set_s *event_set, amdsmi_event_entry
 		return AMDSMI_STATUS_TIMEOUT;
 	}
 
+	/* event sets with rings read the records themselves */
+	if (event == NULL)
+		return AMDSMI_STATUS_SUCCESS;
+
 	for (size_t i = 0; i < event_set->num_handles; ++i) {
 		if (poll_fds[i].revents & POLLIN) {
 			read_res = read(poll_fds[i].fd, event, sizeof(amdsmi_event_entry_t));
@@ -241,6 +247,40 @@ static int amdsmi_strncpy(char *dest, size_t destsz, const char *src, size_t cou
 	return AMDSMI_STATUS_SUCCESS;
 }
 
+static void *amdsmi_mmap_read_only(smi_file_handle fd, size_t size)
+{
+	void *addr;
+
+	/* the user mode driver lives in another process, there is nothing to map */
+	if (amdsmi_is_user_mode())
+		return NULL;
+
+	addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		SMI_DEBUG("failed to map SMI ioctl interface: error=%s\n",
+			strerror(errno));
+		return NULL;
+	}
+
+	return addr;
+}
+
+static int amdsmi_munmap(void *addr, size_t size)
+{
+	return munmap(addr, size);
+}
+
+/* Same clock the driver stamps the metrics snapshot with */
+static uint64_t amdsmi_get_time_us(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+		return 0;
+
+	return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
 system_wrapper *get_system_wrapper(void)
 {
 	static system_wrapper wrapper = {
@@ -256,7 +296,10 @@ system_wrapper *get_system_wrapper(void)
 		.is_user_mode = amdsmi_is_user_mode,
 		.aligned_alloc = amdsmi_aligned_alloc,
 		.aligned_free = free,
-		.strncpy = amdsmi_strncpy
+		.strncpy = amdsmi_strncpy,
+		.mmap = amdsmi_mmap_read_only,
+		.munmap = amdsmi_munmap,
+		.get_time_us = amdsmi_get_time_us
 	};
 
 	return &wrapper;
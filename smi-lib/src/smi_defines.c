@@ -22,6 +22,9 @@
 
 #include <stdlib.h>
 #include "smi_defines.h"
+#include "smi_utils.h"
+#include "smi_debug.h"
+#include "smi_sys_wrapper.h"
 
 smi_handle_struct g_smi_handle;
 
@@ -30,15 +33,105 @@ SMI_DEFINE_ONCE(smi_init_flag);
 
 smi_tss_t smi_thread_key;
 
+static void smi_thread_unlink(smi_handle_struct *handle, smi_thread_ctx *thread)
+{
+	smi_thread_ctx **it;
+
+	for (it = &handle->threads; *it != NULL; it = &(*it)->next) {
+		if (*it == thread) {
+			*it = thread->next;
+			break;
+		}
+	}
+	thread->next = NULL;
+}
+
+amdsmi_status_t smi_thread_attach(smi_req_ctx *smi_req)
+{
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	smi_thread_ctx *thread = smi_req->thread;
+	struct smi_handshake *in_out;
+	smi_file_handle fd;
+	int code;
+
+	/* same access as the init fd, so the thread gets the same permissions */
+	fd = sys_wrapper->open((enum smi_file_access_mode)smi_req->handle->mode);
+	if (fd == SMI_INVAL_HANDLE) {
+		SMI_ERROR("Couldn't open per-thread fd. Return code: %d", AMDSMI_STATUS_API_FAILED);
+		return AMDSMI_STATUS_API_FAILED;
+	}
+
+	thread->fd = fd;
+	thread->has_fd = true;
+	thread->detached = false;
+
+	/* Each connection holds its own command table, pin it to the version negotiated on init */
+	in_out = (struct smi_handshake *)&thread->ioctl_cmd.payload;
+	in_out->version = (uint32_t)smi_req->handle->version;
+	code = amdsmi_request(smi_req, (uint32_t)SMI_CMD_CODE_HANDSHAKE, sizeof(struct smi_handshake),
+			   sizeof(struct smi_handshake));
+	if (code != AMDSMI_STATUS_SUCCESS) {
+		SMI_ERROR("Handshake on per-thread fd failed. Return code: %d", code);
+		sys_wrapper->close(fd);
+		thread->has_fd = false;
+		return code;
+	}
+
+	thread->next = smi_req->handle->threads;
+	smi_req->handle->threads = thread;
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+void smi_thread_detach_all(smi_handle_struct *handle)
+{
+	smi_thread_ctx *thread = handle->threads;
+	smi_thread_ctx *next;
+
+	/*
+	 * Other threads may be inside an ioctl on their fd, so they are only
+	 * marked here and close it themselves, see smi_thread_release().
+	 */
+	while (thread != NULL) {
+		next = thread->next;
+		thread->detached = true;
+		thread->next = NULL;
+		thread = next;
+	}
+	handle->threads = NULL;
+}
+
+void smi_thread_release(smi_thread_ctx *thread)
+{
+	if (thread == NULL || !thread->has_fd || !thread->detached)
+		return;
+
+	get_system_wrapper()->close(thread->fd);
+	thread->has_fd = false;
+	thread->detached = false;
+}
+
 void smi_free_handle(void *thread)
 {
+	smi_thread_ctx *ctx = (smi_thread_ctx *)thread;
+
+	if (ctx != NULL) {
+		smi_mutex_lock(&g_smi_handle.lock);
+		if (ctx->has_fd) {
+			if (!ctx->detached)
+				smi_thread_unlink(&g_smi_handle, ctx);
+			get_system_wrapper()->close(ctx->fd);
+			ctx->has_fd = false;
+		}
+		smi_mutex_unlock(&g_smi_handle.lock);
+	}
 	free(thread);
 }
 
 static void cleanup(void)
 {
 	void *thread = smi_tss_get(smi_thread_key);
-	free(thread);
+	smi_free_handle(thread);
 	smi_tss_set(smi_thread_key, NULL);
 	smi_mutex_destroy(&g_smi_handle.lock);
 }
@@ -47,6 +140,7 @@ BOOL init_smi_once(PINIT_ONCE InitOnce, PVOID Parameter, PVOID *lpContext)
 {
 	if (smi_tss_create(&smi_thread_key, smi_free_handle) == 0) {
 		g_smi_handle.init = false;
+		g_smi_handle.threads = NULL;
 		smi_mutex_init(&g_smi_handle.lock);
 		atexit(cleanup);
 		return TRUE;
@@ -59,6 +153,7 @@ void init_smi_once(void)
 {
 	if (smi_tss_create(&smi_thread_key, smi_free_handle) == 0) {
 		g_smi_handle.init = false;
+		g_smi_handle.threads = NULL;
 		smi_mutex_init(&g_smi_handle.lock);
 		atexit(cleanup);
 	}
@@ -30,16 +30,29 @@
 #include <string.h>
 #include <errno.h>
 #include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#define SMI_METRICS_SNAPSHOT_RETRIES 64
+
+/* level the driver gives its own buffer overflow event, error medium */
+#define SMI_EVENT_OVERFLOW_LEVEL 1
 
 amdsmi_status_t amdsmi_request(smi_req_ctx *smi_req, uint32_t cmd_code, size_t input_size, size_t output_size)
 {
 	system_wrapper *sys_wrapper;
+	smi_file_handle fd;
 
 	if (smi_req == NULL) {
 		SMI_ERROR("Invalid param value, NULL pointer passed as smi_req parameter. Return code: %d", AMDSMI_STATUS_INVAL);
 		return AMDSMI_STATUS_INVAL;
 	}
 	sys_wrapper = get_system_wrapper();
+	fd = smi_req->handle->fd;
+#ifdef THREAD_SAFE
+	if (smi_req->thread->has_fd)
+		fd = smi_req->thread->fd;
+#endif
 	if (!smi_is_supported((enum smi_cmd_code)cmd_code, smi_req->handle->version)) {
 		SMI_ERROR("Specified command is not compatible with the negotiated API version. Return code: %d", AMDSMI_STATUS_NOT_SUPPORTED);
 		return AMDSMI_STATUS_NOT_SUPPORTED;
@@ -47,7 +60,7 @@ amdsmi_status_t amdsmi_request(smi_req_ctx *smi_req, uint32_t cmd_code, size_t i
 		smi_req->thread->ioctl_cmd.in_hdr.code = cmd_code;
 		smi_req->thread->ioctl_cmd.in_hdr.in_len = (int16_t) input_size;
 		smi_req->thread->ioctl_cmd.in_hdr.out_len = (int16_t) output_size;
-		const int ret = sys_wrapper->ioctl(smi_req->handle->fd, &smi_req->thread->ioctl_cmd);
+		const int ret = sys_wrapper->ioctl(fd, &smi_req->thread->ioctl_cmd);
 		if (ret != 0) {
 			if (SMI_LAST_ERROR == SMI_EIO) {
 				SMI_ERROR("SMI_LAST_ERROR errno code equals to AMDSMI_EIO error code. Return code: %d", smi_req->thread->ioctl_cmd.out_hdr.status);
@@ -69,6 +82,132 @@ amdsmi_status_t amdsmi_request(smi_req_ctx *smi_req, uint32_t cmd_code, size_t i
 	return AMDSMI_STATUS_SUCCESS;
 }
 
+#define SMI_BATCH_ALIGN(x) (((x) + 7U) & ~7U)
+
+amdsmi_status_t amdsmi_batch_add_entry(struct smi_batch_s *batch, uint32_t cmd_code, const void *input,
+		size_t input_size, size_t output_size, uint32_t *entry)
+{
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	struct smi_batch_entry *new_entry;
+	uint32_t needed;
+	uint32_t capacity;
+	uint8_t *buffer;
+	uint32_t i;
+
+	if (batch == NULL || entry == NULL || (input == NULL && input_size != 0)) {
+		SMI_ERROR("Nullpointer given as input. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	if (input_size > sizeof(((smi_ioctl_cmd *)0)->payload) ||
+		output_size > sizeof(((smi_ioctl_cmd *)0)->payload)) {
+		SMI_ERROR("Command does not fit into the ioctl payload. Return code: %d", AMDSMI_STATUS_INVAL);
+		return AMDSMI_STATUS_INVAL;
+	}
+
+	for (i = 0; i < batch->num_entries; i++) {
+		if (batch->entries[i].code == cmd_code &&
+			batch->entries[i].in_len == (int16_t)input_size &&
+			batch->entries[i].out_len == (int16_t)output_size &&
+			memcmp(batch->buffer + batch->entries[i].in_offset, input, input_size) == 0) {
+			*entry = i;
+			return AMDSMI_STATUS_SUCCESS;
+		}
+	}
+
+	if (batch->num_entries == SMI_MAX_BATCH_ENTRIES) {
+		SMI_ERROR("Batch is full. Return code: %d", AMDSMI_STATUS_OUT_OF_RESOURCES);
+		return AMDSMI_STATUS_OUT_OF_RESOURCES;
+	}
+
+	needed = batch->buffer_size + SMI_BATCH_ALIGN((uint32_t)input_size) + SMI_BATCH_ALIGN((uint32_t)output_size);
+	if (needed > SMI_MAX_BATCH_BUFFER_SIZE) {
+		SMI_ERROR("Batch buffer is full. Return code: %d", AMDSMI_STATUS_OUT_OF_RESOURCES);
+		return AMDSMI_STATUS_OUT_OF_RESOURCES;
+	}
+
+	if (needed > batch->buffer_capacity) {
+		capacity = batch->buffer_capacity ? batch->buffer_capacity : SMI_MAX_PAYLOAD * sizeof(uint32_t);
+		while (capacity < needed)
+			capacity *= 2;
+		if (capacity > SMI_MAX_BATCH_BUFFER_SIZE)
+			capacity = SMI_MAX_BATCH_BUFFER_SIZE;
+
+		buffer = sys_wrapper->calloc(1, capacity);
+		if (buffer == NULL) {
+			SMI_ERROR("Failed to allocate batch buffer. Return code: %d", AMDSMI_STATUS_OUT_OF_RESOURCES);
+			return AMDSMI_STATUS_OUT_OF_RESOURCES;
+		}
+		if (batch->buffer != NULL) {
+			memcpy(buffer, batch->buffer, batch->buffer_size);
+			sys_wrapper->free(batch->buffer);
+		}
+		batch->buffer = buffer;
+		batch->buffer_capacity = capacity;
+	}
+
+	new_entry = &batch->entries[batch->num_entries];
+	memset(new_entry, 0, sizeof(*new_entry));
+	new_entry->code = cmd_code;
+	new_entry->in_offset = batch->buffer_size;
+	new_entry->in_len = (int16_t)input_size;
+	new_entry->out_offset = batch->buffer_size + SMI_BATCH_ALIGN((uint32_t)input_size);
+	new_entry->out_len = (int16_t)output_size;
+	if (input_size != 0)
+		memcpy(batch->buffer + new_entry->in_offset, input, input_size);
+
+	batch->buffer_size = needed;
+	*entry = batch->num_entries++;
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+static amdsmi_status_t amdsmi_ioctl_batch_serial(smi_req_ctx *smi_req, struct smi_batch_s *batch)
+{
+	struct smi_batch_entry *entry;
+	size_t in_len, out_len;
+	uint32_t i;
+
+	for (i = 0; i < batch->num_entries; i++) {
+		entry = &batch->entries[i];
+		in_len = (size_t)(uint16_t)entry->in_len;
+		out_len = (size_t)(uint16_t)entry->out_len;
+		memcpy(&smi_req->thread->ioctl_cmd.payload, batch->buffer + entry->in_offset, in_len);
+		entry->status = amdsmi_request(smi_req, entry->code, in_len, out_len);
+		if (entry->status == AMDSMI_STATUS_SUCCESS)
+			memcpy(batch->buffer + entry->out_offset, &smi_req->thread->ioctl_cmd.payload, out_len);
+	}
+
+	return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t amdsmi_ioctl_batch(smi_req_ctx *smi_req, struct smi_batch_s *batch)
+{
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	struct smi_batch_request *req;
+	amdsmi_status_t code;
+
+	/* The user mode driver cannot reach the buffers of this process */
+	if (batch->serial || sys_wrapper->is_user_mode())
+		return amdsmi_ioctl_batch_serial(smi_req, batch);
+
+	req = (struct smi_batch_request *)&smi_req->thread->ioctl_cmd.payload;
+	memset(req, 0, sizeof(*req));
+	req->num_entries = batch->num_entries;
+	req->buffer_size = batch->buffer_size;
+	req->entries = batch->entries;
+	req->buffer = batch->buffer;
+
+	code = amdsmi_request(smi_req, (uint32_t)SMI_CMD_CODE_BATCH, sizeof(struct smi_batch_request), 0);
+	if (code == AMDSMI_STATUS_NOT_SUPPORTED) {
+		/* Older driver, remember it and stop asking */
+		batch->serial = true;
+		return amdsmi_ioctl_batch_serial(smi_req, batch);
+	}
+
+	return code;
+}
+
 amdsmi_status_t amdsmi_ioctl_get_vf_partitioning_info(smi_req_ctx *smi_req, smi_device_handle_t handle)
 {
 	struct smi_device_info *gpu =
@@ -94,10 +233,62 @@ amdsmi_status_t amdsmi_ioctl_get_vf_static_info(smi_req_ctx *smi_req, smi_device
 	return code;
 }
 
+static bool amdsmi_read_metrics_snapshot(const void *snapshot, uint64_t handle,
+					 struct smi_gpu_performance_info *info)
+{
+	const struct smi_metrics_snapshot *slot;
+	uint64_t dev_handle;
+	uint64_t timestamp;
+	uint64_t now;
+	uint32_t version;
+	uint32_t seq;
+	int32_t status;
+
+	for (uint32_t i = 0; i < SMI_MAX_DEVICES; i++) {
+		slot = (const struct smi_metrics_snapshot *)((const uint8_t *)snapshot +
+				(size_t)i * SMI_METRICS_SNAPSHOT_STRIDE);
+
+		for (uint32_t retry = 0; retry < SMI_METRICS_SNAPSHOT_RETRIES; retry++) {
+			seq = SMI_LOAD_ACQUIRE(&slot->seq);
+			if (seq & 1)
+				continue;
+
+			version = slot->version;
+			dev_handle = slot->dev_id.handle;
+			status = slot->status;
+			timestamp = slot->timestamp;
+			if (dev_handle == handle)
+				memcpy(info, &slot->info, sizeof(*info));
+
+			SMI_READ_BARRIER();
+			if (SMI_LOAD_ACQUIRE(&slot->seq) != seq)
+				continue;
+
+			if (dev_handle != handle)
+				break;
+
+			if (version != SMI_METRICS_SNAPSHOT_VERSION || status != SMI_STATUS_SUCCESS)
+				return false;
+
+			/* The driver may have stopped refreshing without invalidating the slot */
+			now = get_system_wrapper()->get_time_us();
+			return now < timestamp || now - timestamp <= SMI_METRICS_SNAPSHOT_MAX_AGE_US;
+		}
+	}
+
+	return false;
+}
+
 amdsmi_status_t amdsmi_ioctl_get_gpu_performance_info(smi_req_ctx *smi_req, smi_device_handle_t handle)
 {
 	struct smi_device_info_ex *gpu =
 		(struct smi_device_info_ex *)&smi_req->thread->ioctl_cmd.payload;
+
+	if (smi_req->handle->snapshot != NULL &&
+	    amdsmi_read_metrics_snapshot(smi_req->handle->snapshot, handle.handle,
+					 (struct smi_gpu_performance_info *)gpu))
+		return AMDSMI_STATUS_SUCCESS;
+
 	gpu->dev_id.handle = handle.handle;
 
 	const int code = amdsmi_request(smi_req, (uint32_t)SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO,
@@ -131,6 +322,343 @@ amdsmi_status_t amdsmi_ioctl_get_vf_dynamic_info(smi_req_ctx *smi_req, smi_devic
 	return code;
 }
 
+amdsmi_status_t amdsmi_event_ring_map(struct smi_event_set_s *event_set)
+{
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	struct smi_event_rings_s *rings;
+	const struct smi_event_ring *ring;
+	uint32_t i;
+
+	event_set->rings = NULL;
+
+	if (event_set->num_handles > SMI_MAX_DEVICES)
+		return AMDSMI_STATUS_SUCCESS;
+
+	rings = sys_wrapper->malloc(sizeof(struct smi_event_rings_s));
+	if (rings == NULL)
+		return AMDSMI_STATUS_SUCCESS;
+	memset(rings, 0, sizeof(struct smi_event_rings_s));
+
+	for (i = 0; i < event_set->num_handles; i++) {
+		ring = sys_wrapper->mmap(event_set->handles[i].fd, SMI_EVENT_RING_SIZE);
+		if (ring == NULL) {
+			/* older driver or user mode driver, keep reading the fds */
+			if (i == 0) {
+				sys_wrapper->free(rings);
+				return AMDSMI_STATUS_SUCCESS;
+			}
+			goto unmap;
+		}
+
+		rings->dev[i].ring = ring;
+		rings->num_devices = i + 1;
+		if (ring->version != SMI_EVENT_RING_VERSION ||
+		    ring->num_entries != SMI_EVENT_RING_ENTRIES)
+			goto unmap;
+
+		rings->dev[i].dev_id.handle = ring->dev_id;
+		rings->dev[i].tail = SMI_LOAD_ACQUIRE(&ring->head);
+	}
+
+#ifdef THREAD_SAFE
+	smi_mutex_init(&rings->lock);
+#endif
+	event_set->rings = rings;
+
+	return AMDSMI_STATUS_SUCCESS;
+
+unmap:
+	/* a mapped event fd no longer serves read(), the set is unusable */
+	SMI_ERROR("Failed to map the event ring of processor %u", i);
+	for (i = 0; i < rings->num_devices; i++)
+		sys_wrapper->munmap((void *)rings->dev[i].ring, SMI_EVENT_RING_SIZE);
+	sys_wrapper->free(rings);
+
+	return AMDSMI_STATUS_API_FAILED;
+}
+
+void amdsmi_event_ring_unmap(struct smi_event_set_s *event_set)
+{
+	system_wrapper *sys_wrapper = get_system_wrapper();
+	struct smi_event_rings_s *rings = event_set->rings;
+
+	if (rings == NULL)
+		return;
+
+	for (uint32_t i = 0; i < rings->num_devices; i++)
+		sys_wrapper->munmap((void *)rings->dev[i].ring, SMI_EVENT_RING_SIZE);
+#ifdef THREAD_SAFE
+	smi_mutex_destroy(&rings->lock);
+#endif
+	sys_wrapper->free(rings);
+	event_set->rings = NULL;
+}
+
+static bool amdsmi_event_ring_pop(struct smi_event_ring_dev *dev, struct smi_event_record *record)
+{
+	const struct smi_event_record *records = (const struct smi_event_record *)
+		((const uint8_t *)dev->ring + SMI_EVENT_RING_RECORD_OFFSET);
+	uint64_t head = SMI_LOAD_ACQUIRE(&dev->ring->head);
+	uint64_t oldest;
+
+	while (dev->tail != head) {
+		/* the slot of record head is the one the driver rewrites next */
+		if (head - dev->tail >= SMI_EVENT_RING_ENTRIES) {
+			oldest = head - SMI_EVENT_RING_ENTRIES + 1;
+			dev->lost += oldest - dev->tail;
+			dev->tail = oldest;
+		}
+
+		memcpy(record, &records[dev->tail & (SMI_EVENT_RING_ENTRIES - 1)], sizeof(*record));
+
+		/* the copy only counts if the driver did not lap it meanwhile */
+		SMI_READ_BARRIER();
+		head = SMI_LOAD_ACQUIRE(&dev->ring->head);
+		if (head - dev->tail >= SMI_EVENT_RING_ENTRIES)
+			continue;
+
+		dev->tail++;
+		return true;
+	}
+
+	return false;
+}
+
+bool amdsmi_event_ring_next(struct smi_event_rings_s *rings, struct smi_event_record *record,
+			    uint32_t *dev_idx)
+{
+	struct smi_event_ring_dev *dev;
+	uint32_t idx;
+
+	for (uint32_t i = 0; i < rings->num_devices; i++) {
+		idx = (rings->next + i) % rings->num_devices;
+		dev = &rings->dev[idx];
+
+		if (dev->has_pending) {
+			*record = dev->pending;
+			dev->has_pending = false;
+		} else if (!amdsmi_event_ring_pop(dev, record)) {
+			continue;
+		}
+
+		/* report the gap first, the record itself comes with the next call */
+		if (dev->lost) {
+			dev->pending = *record;
+			dev->has_pending = true;
+
+			memset(record, 0, sizeof(*record));
+			record->timestamp = dev->pending.timestamp;
+			record->data = dev->lost;
+			record->category = AMDSMI_EVENT_CATEGORY_DRIVER;
+			record->subcode = AMDSMI_EVENT_DRIVER_BUFFER_OVERFLOW;
+			record->vf_idx = SMI_PF_INDEX;
+			record->level = SMI_EVENT_OVERFLOW_LEVEL;
+			dev->lost = 0;
+		}
+
+		rings->next = (idx + 1) % rings->num_devices;
+		*dev_idx = idx;
+		return true;
+	}
+
+	return false;
+}
+
+/* days since 1970-01-01 to a civil date, proleptic gregorian calendar */
+static void amdsmi_event_date_string(char *buf, uint64_t timestamp)
+{
+	uint64_t secs = timestamp / 1000000;
+	uint64_t days = secs / 86400 + 719468;
+	uint64_t sod = secs % 86400;
+	uint64_t era = days / 146097;
+	uint64_t doe = days - era * 146097;
+	uint64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint64_t mp = (5 * doy + 2) / 153;
+	uint64_t day = doy - (153 * mp + 2) / 5 + 1;
+	uint64_t month = mp < 10 ? mp + 3 : mp - 9;
+	uint64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+	if (timestamp == 0) {
+		snprintf(buf, SMI_MAX_DATE_LENGTH, "--N/A--");
+		return;
+	}
+
+	/* narrow types keep the output provably within SMI_MAX_DATE_LENGTH */
+	snprintf(buf, SMI_MAX_DATE_LENGTH, SMI_DATE_FORMAT,
+		 (uint16_t)year, (uint8_t)month, (uint8_t)day,
+		 (uint8_t)(sod / 3600), (uint8_t)(sod / 60 % 60), (uint8_t)(sod % 60),
+		 (uint16_t)(timestamp / 1000 % 1000));
+}
+
+/*
+ * The format comes from the driver's error table. Only accept the integer
+ * conversions the event data can feed, never more of them than it has.
+ */
+static bool amdsmi_event_format_is_safe(const char *fmt, uint32_t num_args)
+{
+	uint32_t count = 0;
+
+	while ((fmt = strchr(fmt, '%')) != NULL) {
+		fmt++;
+		if (*fmt == '%') {
+			fmt++;
+			continue;
+		}
+
+		while (*fmt == '-' || *fmt == '+' || *fmt == ' ' || *fmt == '#' ||
+		       *fmt == '.' || isdigit((unsigned char)*fmt))
+			fmt++;
+		while (*fmt == 'l' || *fmt == 'h')
+			fmt++;
+
+		if (*fmt == '\0' || strchr("diuxXo", *fmt) == NULL)
+			return false;
+		if (++count > num_args)
+			return false;
+	}
+
+	return true;
+}
+
+static const struct smi_event_format_cache *amdsmi_event_get_format(smi_req_ctx *smi_req,
+		struct smi_event_rings_s *rings, uint16_t category, uint16_t subcode)
+{
+	static const uint32_t num_args[] = {
+		[SMI_EVENT_ARG_NONE] = 0,
+		[SMI_EVENT_ARG_64] = 1,
+		[SMI_EVENT_ARG_32_32] = 2,
+		[SMI_EVENT_ARG_16_16_32] = 3,
+		[SMI_EVENT_ARG_16_16_16_16] = 4,
+	};
+	struct smi_event_format_query *query =
+		(struct smi_event_format_query *)&smi_req->thread->ioctl_cmd.payload;
+	const struct smi_event_format *format =
+		(const struct smi_event_format *)&smi_req->thread->ioctl_cmd.payload;
+	uint32_t key = ((uint32_t)category << 16) | subcode;
+	struct smi_event_format_cache *entry =
+		&rings->formats[(key * 2654435761u) >> 26];
+	amdsmi_status_t code;
+
+	if (entry->valid && entry->key == key)
+		return entry;
+
+	query->category = category;
+	query->subcode = subcode;
+	code = amdsmi_request(smi_req, (uint32_t)SMI_CMD_CODE_GET_EVENT_FORMAT,
+			      sizeof(struct smi_event_format_query),
+			      sizeof(struct smi_event_format));
+	if (code == AMDSMI_STATUS_SUCCESS &&
+	    format->arg_type < sizeof(num_args) / sizeof(num_args[0]) &&
+	    memchr(format->text, '\0', sizeof(format->text)) != NULL &&
+	    amdsmi_event_format_is_safe(format->text, num_args[format->arg_type])) {
+		entry->arg_type = format->arg_type;
+		memcpy(entry->text, format->text, sizeof(entry->text));
+	} else if (code == AMDSMI_STATUS_SUCCESS || code == AMDSMI_STATUS_NOT_SUPPORTED) {
+		/* nothing to render for this code, do not ask again */
+		entry->arg_type = SMI_EVENT_ARG_UNSUPPORTED;
+		entry->text[0] = '\0';
+	} else {
+		return NULL;
+	}
+
+	entry->key = key;
+	entry->valid = true;
+
+	return entry;
+}
+
+static void amdsmi_event_format_message(char *buf, size_t size, const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vsnprintf(buf, size, fmt, args);
+	va_end(args);
+}
+
+static void amdsmi_event_render_message(smi_req_ctx *smi_req, struct smi_event_rings_s *rings,
+					const struct smi_event_record *record, char *buf)
+{
+	const struct smi_event_format_cache *format;
+	uint64_t data = record->data;
+
+	format = amdsmi_event_get_format(smi_req, rings, record->category, record->subcode);
+	if (format == NULL)
+		return;
+
+	/* split the data the same way the driver log does */
+	switch (format->arg_type) {
+	case SMI_EVENT_ARG_NONE:
+		amdsmi_event_format_message(buf, SMI_EVENT_MSG_SIZE, format->text);
+		break;
+	case SMI_EVENT_ARG_64:
+		amdsmi_event_format_message(buf, SMI_EVENT_MSG_SIZE, format->text,
+					    (unsigned long long)data);
+		break;
+	case SMI_EVENT_ARG_32_32:
+		amdsmi_event_format_message(buf, SMI_EVENT_MSG_SIZE, format->text,
+					    (uint32_t)(data >> 32),
+					    (uint32_t)(data & 0xFFFFFFFF));
+		break;
+	case SMI_EVENT_ARG_16_16_32:
+		amdsmi_event_format_message(buf, SMI_EVENT_MSG_SIZE, format->text,
+					    (uint16_t)(data >> 48),
+					    (uint16_t)((data >> 32) & 0xFFFF),
+					    (uint32_t)(data & 0xFFFFFFFF));
+		break;
+	case SMI_EVENT_ARG_16_16_16_16:
+		amdsmi_event_format_message(buf, SMI_EVENT_MSG_SIZE, format->text,
+					    (uint16_t)(data >> 48),
+					    (uint16_t)((data >> 32) & 0xFFFF),
+					    (uint16_t)((data >> 16) & 0xFFFF),
+					    (uint16_t)(data & 0xFFFF));
+		break;
+	default:
+		break;
+	}
+}
+
+static uint64_t amdsmi_event_vf_handle(smi_req_ctx *smi_req, struct smi_event_ring_dev *dev,
+				       uint8_t vf_idx)
+{
+	const struct smi_vf_partition_info *info =
+		(const struct smi_vf_partition_info *)&smi_req->thread->ioctl_cmd.payload;
+
+	if (vf_idx == SMI_PF_INDEX)
+		return dev->dev_id.handle;
+
+	if (vf_idx >= SMI_MAX_VF_COUNT)
+		return 0;
+
+	/* like the driver, refresh the map whenever a handle is unknown */
+	if (dev->vf_handles[vf_idx] == 0 &&
+	    amdsmi_ioctl_get_vf_partitioning_info(smi_req, dev->dev_id) == AMDSMI_STATUS_SUCCESS) {
+		for (uint32_t i = 0; i < SMI_MAX_VF_COUNT; i++)
+			dev->vf_handles[i] = i < info->num_vf_enabled ?
+				info->partition[i].id.handle : 0;
+	}
+
+	return dev->vf_handles[vf_idx];
+}
+
+void amdsmi_event_render(smi_req_ctx *smi_req, struct smi_event_rings_s *rings, uint32_t dev_idx,
+			 const struct smi_event_record *record, amdsmi_event_entry_t *event)
+{
+	struct smi_event_ring_dev *dev = &rings->dev[dev_idx];
+
+	memset(event, 0, sizeof(amdsmi_event_entry_t));
+	event->timestamp = record->timestamp;
+	event->category = record->category;
+	event->subcode = record->subcode;
+	event->level = record->level;
+	event->data = record->data;
+	event->dev_id = dev->dev_id.handle;
+	event->fcn_id.handle = amdsmi_event_vf_handle(smi_req, dev, record->vf_idx);
+	amdsmi_event_date_string(event->date, record->timestamp);
+	amdsmi_event_render_message(smi_req, rings, record, event->message);
+}
+
 amdsmi_status_t amdsmi_get_pcie_speed_from_pcie_type(uint32_t pcie_type, uint32_t *pcie_speed, uint64_t dev_id)
 {
 	uint64_t case_start_from_zero = 0x73a1;
@@ -42,6 +42,7 @@ static void smi_get_max_supported_cmds(int api_version, unsigned *max_public)
 		break;
 	case SMI_VERSION_BETA_3:
 	case SMI_VERSION_BETA_4:
+	case SMI_VERSION_BETA_5:
 		*max_public = SMI_CMD_CODE__MAX - 1;
 		break;
 	default:
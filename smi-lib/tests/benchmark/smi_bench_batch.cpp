@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "smi_bench.hpp"
+#include "smi_bench_fake_driver.hpp"
+
+extern "C" {
+#include "amdsmi.h"
+}
+
+using namespace std::chrono;
+
+#define BENCH_NUM_DEVICES 8
+
+static const milliseconds run_time(500);
+
+struct sample {
+	amdsmi_engine_usage_t usage;
+	amdsmi_power_info_t power;
+	amdsmi_clk_info_t gfx_clk;
+	amdsmi_clk_info_t mem_clk;
+	int64_t edge_temp;
+	int64_t hotspot_temp;
+	amdsmi_error_count_t ecc;
+};
+
+static int sample_single(std::vector<amdsmi_processor_handle> &handles, std::vector<sample> &samples)
+{
+	int failures = 0;
+
+	for (size_t i = 0; i < handles.size(); i++) {
+		sample &s = samples[i];
+
+		failures += amdsmi_get_gpu_activity(handles[i], &s.usage) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_power_info(handles[i], 0, &s.power) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_clock_info(handles[i], AMDSMI_CLK_TYPE_GFX, &s.gfx_clk) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_clock_info(handles[i], AMDSMI_CLK_TYPE_MEM, &s.mem_clk) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_temp_metric(handles[i], AMDSMI_TEMPERATURE_TYPE_EDGE,
+						   AMDSMI_TEMP_CURRENT, &s.edge_temp) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_temp_metric(handles[i], AMDSMI_TEMPERATURE_TYPE_HOTSPOT,
+						   AMDSMI_TEMP_CURRENT, &s.hotspot_temp) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_gpu_total_ecc_count(handles[i], &s.ecc) != AMDSMI_STATUS_SUCCESS;
+	}
+
+	return failures;
+}
+
+static int build_batch(amdsmi_batch batch, std::vector<amdsmi_processor_handle> &handles,
+		       std::vector<sample> &samples)
+{
+	int failures = 0;
+
+	for (size_t i = 0; i < handles.size(); i++) {
+		sample &s = samples[i];
+
+		failures += amdsmi_batch_add_gpu_activity(batch, handles[i], &s.usage) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_batch_add_power_info(batch, handles[i], &s.power) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_batch_add_clock_info(batch, handles[i], AMDSMI_CLK_TYPE_GFX,
+							&s.gfx_clk) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_batch_add_clock_info(batch, handles[i], AMDSMI_CLK_TYPE_MEM,
+							&s.mem_clk) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_batch_add_temp_metric(batch, handles[i], AMDSMI_TEMPERATURE_TYPE_EDGE,
+							 AMDSMI_TEMP_CURRENT, &s.edge_temp) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_batch_add_temp_metric(batch, handles[i], AMDSMI_TEMPERATURE_TYPE_HOTSPOT,
+							 AMDSMI_TEMP_CURRENT, &s.hotspot_temp) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_batch_add_gpu_total_ecc_count(batch, handles[i], &s.ecc) != AMDSMI_STATUS_SUCCESS;
+	}
+
+	return failures;
+}
+
+template <class F>
+static double run_samples(F take_sample, uint64_t &ioctls)
+{
+	uint64_t num_samples = 0;
+	int failures = 0;
+
+	amdsmi_bench::fake_driver_reset_stats();
+
+	auto start = steady_clock::now();
+	auto end = start + run_time;
+	while (steady_clock::now() < end) {
+		failures += take_sample();
+		num_samples++;
+	}
+	auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start);
+
+	if (failures)
+		std::printf("warning: %d queries failed\n", failures);
+
+	ioctls = amdsmi_bench::fake_driver_stats().ioctls.load() / num_samples;
+
+	return (double)num_samples / elapsed.count();
+}
+
+int amdsmi_bench::bench_batch()
+{
+	std::vector<amdsmi_processor_handle> handles(BENCH_NUM_DEVICES);
+	std::vector<sample> samples(BENCH_NUM_DEVICES);
+	uint32_t count = BENCH_NUM_DEVICES;
+	amdsmi_batch batch = NULL;
+	uint64_t single_ioctls = 0;
+	uint64_t batch_ioctls = 0;
+
+	std::printf("== batched queries ==\n");
+	amdsmi_bench::fake_driver_set_num_devices(BENCH_NUM_DEVICES);
+	amdsmi_bench::fake_driver_set_ioctl_overhead(microseconds(5));
+	amdsmi_bench::fake_driver_set_service_time(microseconds(0));
+
+	if (amdsmi_init(AMDSMI_INIT_AMD_GPUS) != AMDSMI_STATUS_SUCCESS) {
+		std::printf("batch: amdsmi_init failed\n");
+		return -1;
+	}
+
+	if (amdsmi_get_processor_handles(NULL, &count, handles.data()) != AMDSMI_STATUS_SUCCESS ||
+	    count != BENCH_NUM_DEVICES) {
+		std::printf("batch: no processor handles\n");
+		amdsmi_shut_down();
+		return -1;
+	}
+
+	if (amdsmi_batch_create(&batch) != AMDSMI_STATUS_SUCCESS ||
+	    build_batch(batch, handles, samples)) {
+		std::printf("batch: failed to build the batch\n");
+		amdsmi_batch_destroy(batch);
+		amdsmi_shut_down();
+		return -1;
+	}
+
+	double single = run_samples([&]() { return sample_single(handles, samples); }, single_ioctls);
+	double batched = run_samples([&]() { return amdsmi_batch_execute(batch) != AMDSMI_STATUS_SUCCESS; },
+				     batch_ioctls);
+
+	amdsmi_batch_destroy(batch);
+	amdsmi_shut_down();
+
+	std::printf("%u devices, 7 queries per device per sample\n", BENCH_NUM_DEVICES);
+	std::printf("%-8s %14s %14s\n", "mode", "samples/s", "ioctls/sample");
+	std::printf("%-8s %14.0f %14llu\n", "single", single, (unsigned long long)single_ioctls);
+	std::printf("%-8s %14.0f %14llu\n", "batch", batched, (unsigned long long)batch_ioctls);
+	std::printf("speedup: %.2fx\n", batched / single);
+
+	return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "smi_bench_fake_driver.hpp"
+
+extern "C" {
+#include "smi_sys_wrapper.h"
+#include "common/smi_handle.h"
+#include "common/smi_cmd.h"
+#include "smi_defines.h"
+}
+
+namespace amdsmi_bench
+{
+
+#define FAKE_DRIVER_MAX_FD		1024
+#define FAKE_DRIVER_FIRST_FD		100
+#define FAKE_DRIVER_DEVICE_HANDLE	0x1234567812345678ULL
+
+static std::mutex fd_mutex[FAKE_DRIVER_MAX_FD];
+static std::atomic<int> next_fd{FAKE_DRIVER_FIRST_FD};
+static std::chrono::microseconds cmd_service_time{20};
+static std::chrono::microseconds ioctl_overhead{0};
+static uint32_t num_devices = 1;
+static FakeDriverStats stats;
+static bool snapshot_enabled;
+static uint8_t *snapshot;
+
+void fake_driver_set_service_time(std::chrono::microseconds service_time)
+{
+	cmd_service_time = service_time;
+}
+
+void fake_driver_set_ioctl_overhead(std::chrono::microseconds overhead)
+{
+	ioctl_overhead = overhead;
+}
+
+void fake_driver_set_num_devices(uint32_t devices)
+{
+	num_devices = devices;
+}
+
+void fake_driver_set_snapshot(bool enabled)
+{
+	snapshot_enabled = enabled;
+}
+
+void fake_driver_reset_stats()
+{
+	stats.opens = 0;
+	stats.ioctls = 0;
+	stats.commands = 0;
+}
+
+FakeDriverStats &fake_driver_stats()
+{
+	return stats;
+}
+
+static void spin_for(std::chrono::microseconds duration)
+{
+	auto end = std::chrono::steady_clock::now() + duration;
+
+	while (std::chrono::steady_clock::now() < end)
+		;
+}
+
+static void run_command(uint32_t code, void *out, size_t out_len)
+{
+	(void)code;
+
+	stats.commands++;
+	std::memset(out, 0, out_len);
+	/* the real handler mostly waits on the SMU or PSP mailbox */
+	if (cmd_service_time.count())
+		std::this_thread::sleep_for(cmd_service_time);
+}
+
+static void run_batch(struct smi_batch_request *req)
+{
+	for (uint32_t i = 0; i < req->num_entries; i++) {
+		struct smi_batch_entry *entry = &req->entries[i];
+
+		run_command(entry->code, req->buffer + entry->out_offset, (size_t)entry->out_len);
+		entry->status = AMDSMI_STATUS_SUCCESS;
+	}
+}
+
+static uint64_t get_time_us(void)
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void fake_driver_refresh_snapshot()
+{
+	struct smi_metrics_snapshot *slot;
+	struct smi_gpu_performance_info info;
+	uint32_t seq;
+
+	if (snapshot == NULL)
+		return;
+
+	for (uint32_t i = 0; i < num_devices; i++) {
+		slot = (struct smi_metrics_snapshot *)(snapshot + i * SMI_METRICS_SNAPSHOT_STRIDE);
+		run_command(SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO, &info, sizeof(info));
+
+		/* same ordering as the driver's seqcount write */
+		seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+		__atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		slot->version = SMI_METRICS_SNAPSHOT_VERSION;
+		slot->dev_id.handle = FAKE_DRIVER_DEVICE_HANDLE + i;
+		slot->timestamp = get_time_us();
+		slot->status = AMDSMI_STATUS_SUCCESS;
+		std::memcpy(&slot->info, &info, sizeof(info));
+		__atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+	}
+}
+
+static int ioctl(smi_file_handle fd, smi_ioctl_cmd *ioctl_cmd)
+{
+	if (fd < 0 || fd >= FAKE_DRIVER_MAX_FD)
+		return -1;
+
+	std::lock_guard<std::mutex> guard(fd_mutex[fd]);
+
+	stats.ioctls++;
+	ioctl_cmd->out_hdr.status = AMDSMI_STATUS_SUCCESS;
+	spin_for(ioctl_overhead);
+
+	switch (ioctl_cmd->in_hdr.code) {
+	case SMI_CMD_CODE_HANDSHAKE:
+		/* accept whatever version was requested */
+		break;
+	case SMI_CMD_CODE_GET_SERVER_STATIC_INFO: {
+		struct smi_server_static_info *info =
+			(struct smi_server_static_info *)ioctl_cmd->payload;
+
+		std::memset(info, 0, sizeof(*info));
+		info->num_devices = num_devices;
+		for (uint32_t i = 0; i < num_devices; i++)
+			info->devices[i].dev_id.handle = FAKE_DRIVER_DEVICE_HANDLE + i;
+		break;
+	}
+	case SMI_CMD_CODE_BATCH:
+		run_batch((struct smi_batch_request *)ioctl_cmd->payload);
+		break;
+	default:
+		run_command(ioctl_cmd->in_hdr.code, ioctl_cmd->payload,
+			    (size_t)ioctl_cmd->in_hdr.out_len);
+		break;
+	}
+
+	return 0;
+}
+
+static smi_file_handle open(enum smi_file_access_mode mode)
+{
+	(void)mode;
+
+	stats.opens++;
+	return next_fd.fetch_add(1) % FAKE_DRIVER_MAX_FD;
+}
+
+static int access(void)
+{
+	return 0;
+}
+
+static int close(smi_file_handle fd)
+{
+	(void)fd;
+	return 0;
+}
+
+static int poll(struct smi_event_set_s *event_set, amdsmi_event_entry_t *event, int64_t timeout)
+{
+	(void)event_set;
+	(void)event;
+	(void)timeout;
+	return AMDSMI_STATUS_NOT_SUPPORTED;
+}
+
+static void *poll_alloc(smi_event_handle_t *event_handle, uint32_t num_handles)
+{
+	(void)event_handle;
+	(void)num_handles;
+	return NULL;
+}
+
+static void *aligned_alloc(void **mem, size_t alignment, size_t size)
+{
+	return posix_memalign(mem, alignment, size) == 0 ? *mem : NULL;
+}
+
+static int strncpy(char *dest, size_t destsz, const char *src, size_t count)
+{
+	if (count >= destsz)
+		count = destsz - 1;
+	std::strncpy(dest, src, count);
+	dest[count] = '\0';
+	return 0;
+}
+
+static bool is_user_mode(void)
+{
+	return false;
+}
+
+static void *mmap(smi_file_handle fd, size_t size)
+{
+	(void)fd;
+
+	if (!snapshot_enabled || size != SMI_METRICS_SNAPSHOT_SIZE)
+		return NULL;
+
+	if (snapshot == NULL) {
+		snapshot = (uint8_t *)std::calloc(1, SMI_METRICS_SNAPSHOT_SIZE);
+		fake_driver_refresh_snapshot();
+	}
+
+	return snapshot;
+}
+
+static int munmap(void *addr, size_t size)
+{
+	(void)addr;
+	(void)size;
+	return 0;
+}
+
+} // namespace amdsmi_bench
+
+static system_wrapper wrapper = {
+	std::malloc,
+	std::calloc,
+	std::free,
+	amdsmi_bench::ioctl,
+	amdsmi_bench::open,
+	amdsmi_bench::access,
+	amdsmi_bench::close,
+	amdsmi_bench::poll,
+	amdsmi_bench::poll_alloc,
+	amdsmi_bench::is_user_mode,
+	amdsmi_bench::aligned_alloc,
+	std::free,
+	amdsmi_bench::strncpy,
+	amdsmi_bench::mmap,
+	amdsmi_bench::munmap,
+	amdsmi_bench::get_time_us
+};
+
+extern "C" {
+
+system_wrapper *get_system_wrapper()
+{
+	return &wrapper;
+}
+}
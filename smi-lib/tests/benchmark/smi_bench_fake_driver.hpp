@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __AMDSMI_BENCH_FAKE_DRIVER_HPP__
+#define __AMDSMI_BENCH_FAKE_DRIVER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace amdsmi_bench
+{
+
+/*
+ * Minimal in-process stand-in for the SMI driver. Like the real driver, every
+ * open file handle owns one ioctl mutex, so requests sent over the same handle
+ * are serialized while requests on different handles run in parallel.
+ */
+struct FakeDriverStats {
+	std::atomic<uint64_t> opens;
+	std::atomic<uint64_t> ioctls;
+	std::atomic<uint64_t> commands;
+};
+
+/* Time a single command spends waiting on the firmware */
+void fake_driver_set_service_time(std::chrono::microseconds service_time);
+
+/* Time burned on every ioctl for the user/kernel round trip and copies */
+void fake_driver_set_ioctl_overhead(std::chrono::microseconds overhead);
+
+void fake_driver_set_num_devices(uint32_t num_devices);
+
+/* Whether clients may map the metrics snapshot region */
+void fake_driver_set_snapshot(bool enabled);
+
+/* One refresh pass over the snapshot, as done periodically by the driver */
+void fake_driver_refresh_snapshot();
+
+void fake_driver_reset_stats();
+
+FakeDriverStats &fake_driver_stats();
+
+} // namespace amdsmi_bench
+
+#endif // __AMDSMI_BENCH_FAKE_DRIVER_HPP__
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "smi_bench.hpp"
+#include "smi_bench_fake_driver.hpp"
+
+extern "C" {
+#include "amdsmi.h"
+}
+
+using namespace std::chrono;
+
+#define BENCH_NUM_DEVICES 8
+
+static const milliseconds run_time(500);
+static const milliseconds refresh_interval(100);
+
+struct sample {
+	amdsmi_engine_usage_t usage;
+	amdsmi_power_info_t power;
+	amdsmi_clk_info_t gfx_clk;
+	amdsmi_clk_info_t mem_clk;
+	int64_t edge_temp;
+	int64_t hotspot_temp;
+};
+
+static int take_sample(std::vector<amdsmi_processor_handle> &handles, std::vector<sample> &samples)
+{
+	int failures = 0;
+
+	for (size_t i = 0; i < handles.size(); i++) {
+		sample &s = samples[i];
+
+		failures += amdsmi_get_gpu_activity(handles[i], &s.usage) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_power_info(handles[i], 0, &s.power) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_clock_info(handles[i], AMDSMI_CLK_TYPE_GFX, &s.gfx_clk) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_clock_info(handles[i], AMDSMI_CLK_TYPE_MEM, &s.mem_clk) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_temp_metric(handles[i], AMDSMI_TEMPERATURE_TYPE_EDGE,
+						   AMDSMI_TEMP_CURRENT, &s.edge_temp) != AMDSMI_STATUS_SUCCESS;
+		failures += amdsmi_get_temp_metric(handles[i], AMDSMI_TEMPERATURE_TYPE_HOTSPOT,
+						   AMDSMI_TEMP_CURRENT, &s.hotspot_temp) != AMDSMI_STATUS_SUCCESS;
+	}
+
+	return failures;
+}
+
+static int run_mode(uint64_t init_flags, double &rate, uint64_t &ioctls, uint64_t &commands)
+{
+	std::vector<amdsmi_processor_handle> handles(BENCH_NUM_DEVICES);
+	std::vector<sample> samples(BENCH_NUM_DEVICES);
+	uint32_t count = BENCH_NUM_DEVICES;
+	std::atomic<bool> stop{false};
+	uint64_t num_samples = 0;
+	int failures = 0;
+
+	if (amdsmi_init(init_flags) != AMDSMI_STATUS_SUCCESS) {
+		std::printf("snapshot: amdsmi_init failed\n");
+		return -1;
+	}
+
+	if (amdsmi_get_processor_handles(NULL, &count, handles.data()) != AMDSMI_STATUS_SUCCESS ||
+	    count != BENCH_NUM_DEVICES) {
+		std::printf("snapshot: no processor handles\n");
+		amdsmi_shut_down();
+		return -1;
+	}
+
+	/* stands in for the driver's refresh thread */
+	std::thread refresher([&]() {
+		while (!stop.load()) {
+			amdsmi_bench::fake_driver_refresh_snapshot();
+			std::this_thread::sleep_for(refresh_interval);
+		}
+	});
+
+	amdsmi_bench::fake_driver_reset_stats();
+
+	auto start = steady_clock::now();
+	auto end = start + run_time;
+	while (steady_clock::now() < end) {
+		failures += take_sample(handles, samples);
+		num_samples++;
+	}
+	auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start);
+
+	stop = true;
+	refresher.join();
+	amdsmi_shut_down();
+
+	if (failures)
+		std::printf("warning: %d queries failed\n", failures);
+
+	rate = (double)num_samples / elapsed.count();
+	ioctls = amdsmi_bench::fake_driver_stats().ioctls.load() / num_samples;
+	commands = amdsmi_bench::fake_driver_stats().commands.load();
+
+	return 0;
+}
+
+int amdsmi_bench::bench_snapshot()
+{
+	double ioctl_rate = 0;
+	double snapshot_rate = 0;
+	uint64_t ioctl_ioctls = 0;
+	uint64_t snapshot_ioctls = 0;
+	uint64_t ioctl_commands = 0;
+	uint64_t snapshot_commands = 0;
+
+	std::printf("== metrics snapshot ==\n");
+	amdsmi_bench::fake_driver_set_num_devices(BENCH_NUM_DEVICES);
+	amdsmi_bench::fake_driver_set_ioctl_overhead(microseconds(5));
+	amdsmi_bench::fake_driver_set_service_time(microseconds(0));
+	amdsmi_bench::fake_driver_set_snapshot(true);
+
+	if (run_mode(AMDSMI_INIT_AMD_GPUS, ioctl_rate, ioctl_ioctls, ioctl_commands) ||
+	    run_mode(AMDSMI_INIT_AMD_GPUS | AMDSMI_INIT_METRICS_SNAPSHOT, snapshot_rate,
+		     snapshot_ioctls, snapshot_commands))
+		return -1;
+
+	amdsmi_bench::fake_driver_set_snapshot(false);
+
+	std::printf("%u devices, 6 queries per device per sample, refresh every %lld ms\n",
+		    BENCH_NUM_DEVICES, (long long)refresh_interval.count());
+	std::printf("%-9s %14s %14s %16s\n", "mode", "samples/s", "ioctls/sample", "driver commands");
+	std::printf("%-9s %14.0f %14llu %16llu\n", "ioctl", ioctl_rate,
+		    (unsigned long long)ioctl_ioctls, (unsigned long long)ioctl_commands);
+	std::printf("%-9s %14.0f %14llu %16llu\n", "snapshot", snapshot_rate,
+		    (unsigned long long)snapshot_ioctls, (unsigned long long)snapshot_commands);
+	std::printf("speedup: %.2fx\n", snapshot_rate / ioctl_rate);
+
+	return 0;
+}
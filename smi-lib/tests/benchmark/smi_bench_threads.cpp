@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "smi_bench.hpp"
+#include "smi_bench_fake_driver.hpp"
+
+extern "C" {
+#include "amdsmi.h"
+}
+
+using namespace std::chrono;
+
+static const unsigned thread_counts[] = { 1, 2, 4, 8, 16 };
+static const milliseconds run_time(500);
+
+static double run_threads(amdsmi_processor_handle handle, unsigned num_threads)
+{
+	std::atomic<bool> stop{false};
+	std::atomic<uint64_t> calls{0};
+	std::atomic<uint64_t> failures{0};
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 0; i < num_threads; i++) {
+		threads.emplace_back([&]() {
+			amdsmi_engine_usage_t usage;
+			uint64_t local_calls = 0;
+
+			while (!stop.load(std::memory_order_relaxed)) {
+				if (amdsmi_get_gpu_activity(handle, &usage) != AMDSMI_STATUS_SUCCESS)
+					failures++;
+				local_calls++;
+			}
+			calls += local_calls;
+		});
+	}
+
+	auto start = steady_clock::now();
+	std::this_thread::sleep_for(run_time);
+	stop = true;
+	for (auto &t : threads)
+		t.join();
+	auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start);
+
+	if (failures)
+		std::printf("warning: %llu calls failed\n", (unsigned long long)failures.load());
+
+	return (double)calls.load() / elapsed.count();
+}
+
+static int run_mode(const char *name, uint64_t init_flags, std::vector<double> &result)
+{
+	amdsmi_processor_handle handle;
+	uint32_t count = 1;
+
+	if (amdsmi_init(init_flags) != AMDSMI_STATUS_SUCCESS) {
+		std::printf("%s: amdsmi_init failed\n", name);
+		return -1;
+	}
+
+	if (amdsmi_get_processor_handles(NULL, &count, &handle) != AMDSMI_STATUS_SUCCESS || count == 0) {
+		std::printf("%s: no processor handles\n", name);
+		amdsmi_shut_down();
+		return -1;
+	}
+
+	for (unsigned num_threads : thread_counts)
+		result.push_back(run_threads(handle, num_threads));
+
+	amdsmi_shut_down();
+
+	return 0;
+}
+
+int amdsmi_bench::bench_threads()
+{
+	std::vector<double> shared;
+	std::vector<double> concurrent;
+
+	std::printf("== per-thread driver connections ==\n");
+	amdsmi_bench::fake_driver_reset_stats();
+	amdsmi_bench::fake_driver_set_num_devices(1);
+	amdsmi_bench::fake_driver_set_ioctl_overhead(microseconds(0));
+	amdsmi_bench::fake_driver_set_service_time(microseconds(50));
+
+	if (run_mode("shared", AMDSMI_INIT_AMD_GPUS, shared) ||
+	    run_mode("concurrent", AMDSMI_INIT_AMD_GPUS | AMDSMI_INIT_CONCURRENT, concurrent))
+		return 1;
+
+	std::printf("%-8s %16s %16s %8s\n", "threads", "shared calls/s", "concurrent calls/s", "speedup");
+	for (size_t i = 0; i < shared.size(); i++)
+		std::printf("%-8u %16.0f %18.0f %7.2fx\n", thread_counts[i], shared[i],
+			    concurrent[i], concurrent[i] / shared[i]);
+
+	std::printf("driver opens: %llu, ioctls: %llu\n",
+		    (unsigned long long)amdsmi_bench::fake_driver_stats().opens.load(),
+		    (unsigned long long)amdsmi_bench::fake_driver_stats().ioctls.load());
+
+	return 0;
+}
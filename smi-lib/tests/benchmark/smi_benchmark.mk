@@ -0,0 +1,87 @@
+#
+# Copyright (c) 2025 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+include ../defines.mk
+
+OUTPUT_DIR := $(BUILD_DIR)/amdsmi/test/amdsmi_benchmark
+
+EXCLUDE_LIN_LIB_SRCS := smi_sys_wrapper.c
+
+LIB_SRCS := $(filter-out $(EXCLUDE_LIB_SRCS),$(notdir $(wildcard $(SOURCE_DIR)/*.c)))
+LIB_SRCS += $(addprefix $(LIN_HOST_FOLDER)/,$(filter-out $(EXCLUDE_LIN_LIB_SRCS),$(notdir $(wildcard $(LIN_SOURCE_DIR)/*.c))))
+
+BENCH_SRCS := smi_bench_main.cpp
+BENCH_SRCS += smi_bench_threads.cpp
+BENCH_SRCS += smi_bench_batch.cpp
+BENCH_SRCS += smi_bench_snapshot.cpp
+BENCH_SRCS += smi_bench_fake_driver.cpp
+
+OBJSC   := $(addprefix $(OUTPUT_DIR)/,$(LIB_SRCS:.c=.c.o))
+OBJSCPP := $(addprefix $(OUTPUT_DIR)/,$(BENCH_SRCS:.cpp=.cpp.o))
+
+DEPS := $(OBJSC:.o=.d) $(OBJSCPP:.o=.d)
+
+TARGET := amdsmi_benchmark
+
+INCLUDE := $(addprefix -I,\
+  $(INCLUDE_DIR)\
+  $(INTERFACE_DIR)\
+  $(LIN_HOST_INCLUDE_DIR)\
+  $(GIM_COMS_INCLUDE_DIR))
+
+# benchmarks always need the thread safe library
+CFLAGS   = -std=c11 $(DEFAULT_CFLAGS) $(INCLUDE) -O2 -D_XOPEN_SOURCE=700 -DTHREAD_SAFE
+CXXFLAGS = -std=c++17 $(DEFAULT_CXXFLAGS) $(INCLUDE) -O2 -D_XOPEN_SOURCE=700 -DTHREAD_SAFE
+
+LDFLAGS = -pthread
+
+ifeq ($(THREAD_SANITIZER), True)
+	CFLAGS  += -fsanitize=thread
+	CXXFLAGS += -fsanitize=thread
+	LDFLAGS += -fsanitize=thread
+endif
+
+vpath %.c $(SOURCE_DIR)
+vpath %.cpp $(TEST_BENCHMARK_DIR)
+
+default: $(OUTPUT_DIR)/$(TARGET)
+
+.PHONY: clean
+clean:
+	$(RM) $(OBJSC) $(OBJSCPP) $(OUTPUT_DIR)/$(TARGET) $(DEPS)
+
+.PHONY: run
+run: $(OUTPUT_DIR)/$(TARGET)
+	$(OUTPUT_DIR)/$(TARGET)
+
+-include $(DEPS)
+
+$(OUTPUT_DIR)/%.c.o: %.c Makefile | $(OUTPUT_DIR)
+	$(CC) $(CFLAGS) -DVERSION_FILE_PATH=$(VERSION_FILE_PATH) -MMD -MP -c $< -o $@
+
+$(OUTPUT_DIR)/%.cpp.o: %.cpp Makefile | $(OUTPUT_DIR)
+	$(CXX) $(CXXFLAGS) -MMD -MP -c $< -o $@
+
+$(OUTPUT_DIR)/$(TARGET): $(OBJSC) $(OBJSCPP)| $(OUTPUT_DIR)
+	$(CXX) -o $@ $^ $(LDFLAGS)
+
+$(OUTPUT_DIR):
+	mkdir -p $(OUTPUT_DIR)/$(LIN_HOST_FOLDER)
@@ -65,6 +65,11 @@ static int close(smi_file_handle fd)
 	return GetSystemMock()->Close(fd);
 }
 
+static bool is_user_mode(void)
+{
+	return GetSystemMock()->GetDriverMode() == 0;
+}
+
 static void *malloc(size_t size)
 {
 	return GetSystemMock()->Malloc(size);
@@ -95,6 +100,21 @@ static int strncpy(char *dest, size_t destsz, const char *src, size_t count)
 	return GetSystemMock()->Strncpy(dest, destsz, src, count);
 }
 
+static void *mmap(smi_file_handle fd, size_t size)
+{
+	return GetSystemMock()->Mmap(fd, size);
+}
+
+static int munmap(void *addr, size_t size)
+{
+	return GetSystemMock()->Munmap(addr, size);
+}
+
+static uint64_t get_time_us(void)
+{
+	return GetSystemMock()->GetTimeUs();
+}
+
 } // namespace amdsmi
 
 static system_wrapper wrapper = {
@@ -107,10 +127,13 @@ static system_wrapper wrapper = {
 	(int (*)(smi_file_handle))amdsmi::close,
 	(int (*)(struct smi_event_set_s *, amdsmi_event_entry_t *, int64_t))amdsmi::poll,
 	(void *(*)(smi_event_handle_t *, uint32_t))amdsmi::poll_alloc,
-	NULL,
+	(bool (*)(void))amdsmi::is_user_mode,
 	(void *(*)(void**, size_t, size_t))amdsmi::aligned_alloc,
 	(void (*)(void *))amdsmi::aligned_free,
-	(int (*)(char *, size_t, const char *, size_t))amdsmi::strncpy
+	(int (*)(char *, size_t, const char *, size_t))amdsmi::strncpy,
+	(void *(*)(smi_file_handle, size_t))amdsmi::mmap,
+	(int (*)(void *, size_t))amdsmi::munmap,
+	(uint64_t (*)(void))amdsmi::get_time_us
 };
 
 extern "C" {
@@ -58,6 +58,7 @@ LDFLAGS += -Wl,--wrap=write
 LDFLAGS += -Wl,--wrap=ioctl
 LDFLAGS += -Wl,--wrap=open
 LDFLAGS += -Wl,--wrap=access
+LDFLAGS += -Wl,--wrap=mmap
 
 ifeq ($(GEN_COVERAGE), YES)
 	CFLAGS += --coverage
@@ -209,6 +209,9 @@ public:
 		ON_CALL(*this, AlignedFree(testing::_)).WillByDefault(AlignedFreePasstrough());
 		ON_CALL(*this, GetDriverMode()).WillByDefault(Return(0));
 		ON_CALL(*this, Strncpy(testing::_, testing::_,testing::_, testing::_)).WillByDefault(StrncpyPasstrough());
+		ON_CALL(*this, Mmap(testing::_, testing::_)).WillByDefault(Return(nullptr));
+		ON_CALL(*this, Munmap(testing::_, testing::_)).WillByDefault(Return(0));
+		ON_CALL(*this, GetTimeUs()).WillByDefault(Return(0));
 	}
 
 	MOCK_METHOD1(Ioctl, int(smi_ioctl_cmd *));
@@ -227,6 +230,9 @@ public:
 	MOCK_METHOD1(AlignedFree, void(void *));
 	MOCK_METHOD0(GetDriverMode, int(void));
 	MOCK_METHOD4(Strncpy, int(char *, size_t, const char *, size_t));
+	MOCK_METHOD2(Mmap, void *(smi_file_handle, size_t));
+	MOCK_METHOD2(Munmap, int(void *, size_t));
+	MOCK_METHOD0(GetTimeUs, uint64_t(void));
 
 	virtual ~SystemMock()
 	{
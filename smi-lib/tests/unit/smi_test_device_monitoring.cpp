@@ -20,6 +20,8 @@
  * THE SOFTWARE.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 extern "C" {
@@ -208,6 +210,9 @@ TEST_F(AmdsmiGpuMonitoring, InvalidParams)
 	ret = amdsmi_get_gpu_cache_info(MOCK_GPU_HANDLE, NULL);
 	ASSERT_EQ(ret, AMDSMI_STATUS_INVAL);
 
+	ret = amdsmi_get_gpu_sched_event_stats(MOCK_GPU_HANDLE, NULL);
+	ASSERT_EQ(ret, AMDSMI_STATUS_INVAL);
+
 	ret = amdsmi_get_soc_pstate(MOCK_GPU_HANDLE, NULL);
 	ASSERT_EQ(ret, AMDSMI_STATUS_INVAL);
 }
@@ -233,6 +238,7 @@ TEST_F(AmdsmiGpuMonitoring, IoctlFailed)
 	int64_t temperature_res;
 	int64_t temperature_limit_res;
 	amdsmi_gpu_cache_info_t cache_res;
+	amdsmi_sched_event_stats_t sched_stats;
 	amdsmi_pcie_info_t pcie_info;
 	amdsmi_dpm_policy_t dpm_policy_info;
 	uint32_t sensor_ind = 0;
@@ -263,6 +269,9 @@ TEST_F(AmdsmiGpuMonitoring, IoctlFailed)
 	ret = amdsmi_get_gpu_cache_info(MOCK_GPU_HANDLE, &cache_res);
 	ASSERT_EQ(ret, AMDSMI_STATUS_API_FAILED);
 
+	ret = amdsmi_get_gpu_sched_event_stats(MOCK_GPU_HANDLE, &sched_stats);
+	ASSERT_EQ(ret, AMDSMI_STATUS_API_FAILED);
+
 	ret = amdsmi_get_pcie_info(MOCK_GPU_HANDLE, &pcie_info);
 	ASSERT_EQ(ret, AMDSMI_STATUS_API_FAILED);
 
@@ -739,6 +748,78 @@ TEST_F(AmdsmiGpuMonitoring, TestCacheInfWrongNumCacheType)
 	ASSERT_EQ(ret, AMDSMI_STATUS_NOT_SUPPORTED);
 }
 
+TEST_F(AmdsmiGpuMonitoring, TestSchedEventStats)
+{
+	int ret;
+	amdsmi_sched_event_stats_t stats;
+	smi_device_info in_payload;
+	smi_sched_event_stats mocked_resp = {};
+
+	mocked_resp.num_events = 3;
+	mocked_resp.depth = 2;
+	mocked_resp.max_depth = 17;
+	for (uint32_t i = 0; i < mocked_resp.num_events; i++) {
+		mocked_resp.event[i].event_id = 0xff0e + i;
+		mocked_resp.event[i].queued = i * 10 + 1;
+		mocked_resp.event[i].coalesced = i * 10 + 2;
+		mocked_resp.event[i].skipped = i * 10 + 3;
+		mocked_resp.event[i].handled = i * 10 + 4;
+		mocked_resp.event[i].wait_sum = i * 10 + 5;
+		mocked_resp.event[i].run_sum = i * 10 + 6;
+		mocked_resp.event[i].wait_max = i * 10 + 7;
+		mocked_resp.event[i].wait_p99 = i * 10 + 8;
+		mocked_resp.event[i].run_max = i * 10 + 9;
+		mocked_resp.event[i].run_p99 = i * 10 + 10;
+	}
+
+	amdsmi_processor_handle MOCK_GPU_HANDLE = &GPU_MOCK_HANDLE;
+	WhenCalling(std::bind(amdsmi_get_gpu_sched_event_stats, MOCK_GPU_HANDLE, &stats));
+	ExpectCommand(SMI_CMD_CODE_GET_SCHED_EVENT_STATS);
+	SaveInputPayloadIn(&in_payload);
+	PlantMockOutput(&mocked_resp);
+	ret = performCall();
+
+	ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(amdsmi::equal_handles(in_payload.dev_id, GPU_MOCK_HANDLE));
+	ASSERT_EQ(stats.num_events, mocked_resp.num_events);
+	ASSERT_EQ(stats.depth, mocked_resp.depth);
+	ASSERT_EQ(stats.max_depth, mocked_resp.max_depth);
+	for (uint32_t i = 0; i < stats.num_events; i++) {
+		ASSERT_EQ(stats.event[i].event_id, mocked_resp.event[i].event_id);
+		ASSERT_EQ(stats.event[i].queued, mocked_resp.event[i].queued);
+		ASSERT_EQ(stats.event[i].coalesced, mocked_resp.event[i].coalesced);
+		ASSERT_EQ(stats.event[i].skipped, mocked_resp.event[i].skipped);
+		ASSERT_EQ(stats.event[i].handled, mocked_resp.event[i].handled);
+		ASSERT_EQ(stats.event[i].wait_sum, mocked_resp.event[i].wait_sum);
+		ASSERT_EQ(stats.event[i].run_sum, mocked_resp.event[i].run_sum);
+		ASSERT_EQ(stats.event[i].wait_max, mocked_resp.event[i].wait_max);
+		ASSERT_EQ(stats.event[i].wait_p99, mocked_resp.event[i].wait_p99);
+		ASSERT_EQ(stats.event[i].run_max, mocked_resp.event[i].run_max);
+		ASSERT_EQ(stats.event[i].run_p99, mocked_resp.event[i].run_p99);
+	}
+	ASSERT_EQ(stats.event[3].queued, 0u);
+}
+
+TEST_F(AmdsmiGpuMonitoring, TestSchedEventStatsNumEventsClamped)
+{
+	int ret;
+	amdsmi_sched_event_stats_t stats;
+	smi_device_info in_payload;
+	smi_sched_event_stats mocked_resp = {};
+
+	mocked_resp.num_events = 0xFFFFFFFF;
+
+	amdsmi_processor_handle MOCK_GPU_HANDLE = &GPU_MOCK_HANDLE;
+	WhenCalling(std::bind(amdsmi_get_gpu_sched_event_stats, MOCK_GPU_HANDLE, &stats));
+	ExpectCommand(SMI_CMD_CODE_GET_SCHED_EVENT_STATS);
+	SaveInputPayloadIn(&in_payload);
+	PlantMockOutput(&mocked_resp);
+	ret = performCall();
+
+	ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(stats.num_events, (uint32_t)AMDSMI_MAX_SCHED_EVENT_STATS);
+}
+
 TEST_F(AmdsmiGpuMonitoring, GetSocPstate)
 {
 	int ret;
@@ -798,3 +879,240 @@ TEST_F(AmdsmiGpuMonitoring, SetSocPstate)
 
 	ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
 }
+
+ACTION_P(ServeBatchRequest, perf_resp)
+{
+	struct smi_batch_request *req = (struct smi_batch_request *)arg0->payload;
+
+	for (uint32_t i = 0; i < req->num_entries; i++) {
+		struct smi_batch_entry *entry = &req->entries[i];
+
+		if (entry->code == SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO) {
+			std::memcpy(req->buffer + entry->out_offset, perf_resp, sizeof(*perf_resp));
+			entry->status = AMDSMI_STATUS_SUCCESS;
+		} else {
+			entry->status = AMDSMI_STATUS_NOT_SUPPORTED;
+		}
+	}
+	arg0->out_hdr.status = AMDSMI_STATUS_SUCCESS;
+	return 0;
+}
+
+TEST_F(AmdsmiGpuMonitoring, BatchInvalidParams)
+{
+	amdsmi_batch batch = NULL;
+	amdsmi_engine_usage_t engine_usage;
+	amdsmi_clk_info_t clock_info;
+	amdsmi_status_t status;
+	amdsmi_processor_handle MOCK_GPU_HANDLE = &GPU_MOCK_HANDLE;
+
+	ASSERT_EQ(amdsmi_batch_create(NULL), AMDSMI_STATUS_INVAL);
+	ASSERT_EQ(amdsmi_batch_create(&batch), AMDSMI_STATUS_SUCCESS);
+
+	ASSERT_EQ(amdsmi_batch_add_gpu_activity(batch, NULL, &engine_usage), AMDSMI_STATUS_INVAL);
+	ASSERT_EQ(amdsmi_batch_add_gpu_activity(batch, MOCK_GPU_HANDLE, NULL), AMDSMI_STATUS_INVAL);
+	ASSERT_EQ(amdsmi_batch_add_gpu_activity(NULL, MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_INVAL);
+	ASSERT_EQ(amdsmi_batch_add_clock_info(batch, MOCK_GPU_HANDLE,
+					      (amdsmi_clk_type_t)(AMDSMI_CLK_TYPE__MAX + 1), &clock_info),
+		  AMDSMI_STATUS_INVAL);
+	ASSERT_EQ(amdsmi_batch_get_status(batch, 0, &status), AMDSMI_STATUS_INVAL);
+	ASSERT_EQ(amdsmi_batch_execute(NULL), AMDSMI_STATUS_INVAL);
+
+	ASSERT_EQ(amdsmi_batch_destroy(batch), AMDSMI_STATUS_SUCCESS);
+}
+
+TEST_F(AmdsmiGpuMonitoring, BatchSingleIoctl)
+{
+	amdsmi_batch batch = NULL;
+	amdsmi_engine_usage_t engine_usage;
+	amdsmi_power_info_t power_info;
+	amdsmi_clk_info_t clock_info;
+	int64_t temperature;
+	amdsmi_error_count_t ecc_count;
+	amdsmi_status_t status;
+	smi_gpu_performance_info mocked_resp = {};
+	amdsmi_processor_handle MOCK_GPU_HANDLE = &GPU_MOCK_HANDLE;
+
+	mocked_resp.usage.gfx_activity = 30;
+	mocked_resp.usage.umc_activity = 40;
+	mocked_resp.power.socket_power = 200;
+	mocked_resp.clock.cur_clk[AMDSMI_CLK_TYPE_MEM] = 900;
+	mocked_resp.clock.max_clk[AMDSMI_CLK_TYPE_MEM] = 1200;
+	mocked_resp.temp.temp[AMDSMI_TEMPERATURE_TYPE_EDGE] = 55;
+
+	EXPECT_CALL(*g_system_mock, GetDriverMode())
+		.WillRepeatedly(Return(1));
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_BATCH)))
+		.Times(2)
+		.WillRepeatedly(ServeBatchRequest(&mocked_resp));
+
+	ASSERT_EQ(amdsmi_batch_create(&batch), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_gpu_activity(batch, MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_power_info(batch, MOCK_GPU_HANDLE, &power_info), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_clock_info(batch, MOCK_GPU_HANDLE, AMDSMI_CLK_TYPE_MEM, &clock_info),
+		  AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_temp_metric(batch, MOCK_GPU_HANDLE, AMDSMI_TEMPERATURE_TYPE_EDGE,
+					       AMDSMI_TEMP_CURRENT, &temperature),
+		  AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_gpu_total_ecc_count(batch, MOCK_GPU_HANDLE, &ecc_count), AMDSMI_STATUS_SUCCESS);
+
+	/* the batch may be executed repeatedly */
+	for (int i = 0; i < 2; i++) {
+		ASSERT_EQ(amdsmi_batch_execute(batch), AMDSMI_STATUS_SUCCESS);
+
+		ASSERT_TRUE(equal_engine_usage(mocked_resp.usage, engine_usage));
+		ASSERT_TRUE(equal_power_measure(mocked_resp.power, power_info));
+		ASSERT_TRUE(equal_clock_measure(mocked_resp.clock, clock_info, AMDSMI_CLK_TYPE_MEM));
+		ASSERT_EQ(temperature, 55);
+
+		for (uint32_t query = 0; query < 4; query++) {
+			ASSERT_EQ(amdsmi_batch_get_status(batch, query, &status), AMDSMI_STATUS_SUCCESS);
+			ASSERT_EQ(status, AMDSMI_STATUS_SUCCESS);
+		}
+		ASSERT_EQ(amdsmi_batch_get_status(batch, 4, &status), AMDSMI_STATUS_SUCCESS);
+		ASSERT_EQ(status, AMDSMI_STATUS_NOT_SUPPORTED);
+	}
+
+	ASSERT_EQ(amdsmi_batch_destroy(batch), AMDSMI_STATUS_SUCCESS);
+}
+
+TEST_F(AmdsmiGpuMonitoring, BatchUserModeFallback)
+{
+	amdsmi_batch batch = NULL;
+	amdsmi_engine_usage_t engine_usage;
+	amdsmi_power_info_t power_info;
+	amdsmi_error_count_t ecc_count;
+	amdsmi_status_t status;
+	smi_gpu_performance_info mocked_resp = {};
+	amdsmi_processor_handle MOCK_GPU_HANDLE = &GPU_MOCK_HANDLE;
+
+	mocked_resp.usage.gfx_activity = 70;
+	mocked_resp.power.gfx_voltage = 800;
+
+	EXPECT_CALL(*g_system_mock, GetDriverMode())
+		.WillRepeatedly(Return(0));
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO)))
+		.WillOnce(DoAll(amdsmi::SetPayload(mocked_resp), Return(0)));
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_ECC_STATUS)))
+		.WillOnce(SetResponseStatus(AMDSMI_STATUS_API_FAILED));
+
+	ASSERT_EQ(amdsmi_batch_create(&batch), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_gpu_activity(batch, MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_power_info(batch, MOCK_GPU_HANDLE, &power_info), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_add_gpu_total_ecc_count(batch, MOCK_GPU_HANDLE, &ecc_count), AMDSMI_STATUS_SUCCESS);
+
+	ASSERT_EQ(amdsmi_batch_execute(batch), AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(equal_engine_usage(mocked_resp.usage, engine_usage));
+	ASSERT_TRUE(equal_power_measure(mocked_resp.power, power_info));
+
+	ASSERT_EQ(amdsmi_batch_get_status(batch, 1, &status), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(status, AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(amdsmi_batch_get_status(batch, 2, &status), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(status, AMDSMI_STATUS_API_FAILED);
+
+	ASSERT_EQ(amdsmi_batch_destroy(batch), AMDSMI_STATUS_SUCCESS);
+}
+
+static struct smi_metrics_snapshot *snapshot_slot(std::vector<uint8_t> &region, uint32_t idx)
+{
+	return (struct smi_metrics_snapshot *)(region.data() + idx * SMI_METRICS_SNAPSHOT_STRIDE);
+}
+
+TEST_F(AmdsmiGpuMonitoring, MetricsSnapshotServesQueries)
+{
+	std::vector<uint8_t> region(SMI_METRICS_SNAPSHOT_SIZE);
+	struct smi_metrics_snapshot *slot;
+	amdsmi_engine_usage_t engine_usage;
+	amdsmi_power_info_t power_info;
+	amdsmi_clk_info_t clock_info;
+	int64_t temperature;
+	amdsmi_processor_handle MOCK_GPU_HANDLE = &GPU_MOCK_HANDLE;
+
+	/* another device in front of ours */
+	slot = snapshot_slot(region, 0);
+	slot->version = SMI_METRICS_SNAPSHOT_VERSION;
+	slot->dev_id.handle = GPU_MOCK_HANDLE.handle + 1;
+	slot->status = AMDSMI_STATUS_SUCCESS;
+	slot->info.usage.gfx_activity = 99;
+
+	slot = snapshot_slot(region, 1);
+	slot->seq = 2;
+	slot->version = SMI_METRICS_SNAPSHOT_VERSION;
+	slot->dev_id = GPU_MOCK_HANDLE;
+	slot->status = AMDSMI_STATUS_SUCCESS;
+	slot->info.usage.gfx_activity = 30;
+	slot->info.usage.umc_activity = 40;
+	slot->info.power.socket_power = 200;
+	slot->info.clock.cur_clk[AMDSMI_CLK_TYPE_MEM] = 900;
+	slot->info.clock.max_clk[AMDSMI_CLK_TYPE_MEM] = 1200;
+	slot->info.temp.temp[AMDSMI_TEMPERATURE_TYPE_EDGE] = 55;
+
+	finalize_smi_lib();
+	EXPECT_CALL(*g_system_mock, Mmap(_, SMI_METRICS_SNAPSHOT_SIZE))
+		.WillOnce(Return(region.data()));
+	initialize_smi_lib(SMI_VERSION_MAX, AMDSMI_INIT_AMD_GPUS | AMDSMI_INIT_METRICS_SNAPSHOT);
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO)))
+		.Times(0);
+
+	ASSERT_EQ(amdsmi_get_gpu_activity(MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(equal_engine_usage(slot->info.usage, engine_usage));
+	ASSERT_EQ(amdsmi_get_power_info(MOCK_GPU_HANDLE, 0, &power_info), AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(equal_power_measure(slot->info.power, power_info));
+	ASSERT_EQ(amdsmi_get_clock_info(MOCK_GPU_HANDLE, AMDSMI_CLK_TYPE_MEM, &clock_info),
+		  AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(equal_clock_measure(slot->info.clock, clock_info, AMDSMI_CLK_TYPE_MEM));
+	ASSERT_EQ(amdsmi_get_temp_metric(MOCK_GPU_HANDLE, AMDSMI_TEMPERATURE_TYPE_EDGE,
+					 AMDSMI_TEMP_CURRENT, &temperature),
+		  AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(temperature, 55);
+
+	EXPECT_CALL(*g_system_mock, Munmap(region.data(), SMI_METRICS_SNAPSHOT_SIZE))
+		.WillOnce(Return(0));
+}
+
+TEST_F(AmdsmiGpuMonitoring, MetricsSnapshotFallback)
+{
+	std::vector<uint8_t> region(SMI_METRICS_SNAPSHOT_SIZE);
+	struct smi_metrics_snapshot *slot = snapshot_slot(region, 0);
+	amdsmi_engine_usage_t engine_usage;
+	smi_gpu_performance_info mocked_resp = {};
+	amdsmi_processor_handle MOCK_GPU_HANDLE = &GPU_MOCK_HANDLE;
+
+	mocked_resp.usage.gfx_activity = 70;
+
+	slot->version = SMI_METRICS_SNAPSHOT_VERSION;
+	slot->dev_id = GPU_MOCK_HANDLE;
+	slot->status = AMDSMI_STATUS_NOT_SUPPORTED;
+	slot->info.usage.gfx_activity = 30;
+
+	finalize_smi_lib();
+	EXPECT_CALL(*g_system_mock, Mmap(_, SMI_METRICS_SNAPSHOT_SIZE))
+		.WillOnce(Return(region.data()));
+	initialize_smi_lib(SMI_VERSION_MAX, AMDSMI_INIT_AMD_GPUS | AMDSMI_INIT_METRICS_SNAPSHOT);
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_GPU_PERFORMANCE_INFO)))
+		.Times(3)
+		.WillRepeatedly(DoAll(amdsmi::SetPayload(mocked_resp), Return(0)));
+
+	/* the driver stopped refreshing the snapshot */
+	ASSERT_EQ(amdsmi_get_gpu_activity(MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(equal_engine_usage(mocked_resp.usage, engine_usage));
+
+	/* the slot stays in the middle of an update */
+	slot->seq = 1;
+	slot->status = AMDSMI_STATUS_SUCCESS;
+	ASSERT_EQ(amdsmi_get_gpu_activity(MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(equal_engine_usage(mocked_resp.usage, engine_usage));
+
+	/* the slot is valid but was last refreshed too long ago */
+	slot->seq = 2;
+	slot->timestamp = 5000;
+	EXPECT_CALL(*g_system_mock, GetTimeUs())
+		.WillOnce(Return(5000 + SMI_METRICS_SNAPSHOT_MAX_AGE_US + 1))
+		.WillOnce(Return(5000 + SMI_METRICS_SNAPSHOT_MAX_AGE_US));
+	ASSERT_EQ(amdsmi_get_gpu_activity(MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_SUCCESS);
+	ASSERT_TRUE(equal_engine_usage(mocked_resp.usage, engine_usage));
+	ASSERT_EQ(amdsmi_get_gpu_activity(MOCK_GPU_HANDLE, &engine_usage), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(engine_usage.gfx_activity, 30u);
+}
@@ -20,6 +20,8 @@
  * THE SOFTWARE.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 extern "C" {
@@ -78,6 +80,8 @@ TEST_F(AmdSmiEventsTests, EventCreate)
 	ret = performCall();
 
 	ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
+	/* the mock driver has no event ring, the set keeps reading the fd */
+	ASSERT_EQ(((struct smi_event_set_s*)set)->rings, nullptr);
 
 	sys_wrapper->free(((struct smi_event_set_s*)set)->handles);
 	sys_wrapper->free(((struct smi_event_set_s*)set)->devices);
@@ -215,7 +219,7 @@ TEST_F(AmdSmiEventsTests, EventDestroy)
 TEST_F(AmdSmiEventsTests, EventRead)
 {
 	int ret;
-	struct smi_event_set_s set_s;
+	struct smi_event_set_s set_s = {};
 	amdsmi_event_set set = &set_s;
 	amdsmi_event_entry_t event;
 
@@ -247,9 +251,209 @@ TEST_F(AmdSmiEventsTests, EventDestroy)
 	handle_s->devices = (smi_device_handle_t*)sys_wrapper->malloc(sizeof(smi_device_handle_t));
 	handle_s->handles[0].fd = 0;
 	handle_s->_private = sys_wrapper->malloc(4);
+	handle_s->rings = NULL;
 	ret = amdsmi_event_destroy(NULL);
 	ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
 	ret = amdsmi_event_destroy(handle_s);
 	ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
 }
+
+class AmdSmiEventRingTests : public AmdSmiEventsTests {
+protected:
+	void SetUp() override
+	{
+		AmdSmiEventsTests::SetUp();
+
+		region.assign(SMI_EVENT_RING_SIZE, 0);
+		ring()->version = SMI_EVENT_RING_VERSION;
+		ring()->num_entries = SMI_EVENT_RING_ENTRIES;
+		ring()->dev_id = GPU_MOCK_HANDLE.handle;
+	}
+
+	struct smi_event_ring *ring()
+	{
+		return (struct smi_event_ring *)region.data();
+	}
+
+	void push(uint16_t category, uint16_t subcode, uint8_t vf_idx, uint64_t data,
+		  uint64_t timestamp)
+	{
+		struct smi_event_record *records = (struct smi_event_record *)
+			(region.data() + SMI_EVENT_RING_RECORD_OFFSET);
+		struct smi_event_record *rec =
+			&records[ring()->head & (SMI_EVENT_RING_ENTRIES - 1)];
+
+		rec->category = category;
+		rec->subcode = subcode;
+		rec->vf_idx = vf_idx;
+		rec->level = 2;
+		rec->data = data;
+		rec->timestamp = timestamp;
+		ring()->head++;
+	}
+
+	amdsmi_event_set create()
+	{
+		amdsmi_processor_handle processor = &GPU_MOCK_HANDLE;
+		smi_event_handle_t mocked_resp = {};
+		smi_event_set_config in_payload;
+		smi_in_hdr in_hdr;
+		amdsmi_event_set set = NULL;
+
+		PrepareIoctl(SMI_CMD_CODE_CREATE_EVENT, &in_hdr, &in_payload, mocked_resp);
+		EXPECT_CALL(*g_system_mock, Mmap(_, SMI_EVENT_RING_SIZE))
+			.WillOnce(Return(region.data()));
+		EXPECT_EQ(amdsmi_event_create(&processor, 1, 0xC0FFEE, &set), AMDSMI_STATUS_SUCCESS);
+
+		return set;
+	}
+
+	void expect_format(uint32_t arg_type, const char *text)
+	{
+		smi_event_format format = {};
+
+		format.arg_type = arg_type;
+		strcpy(format.text, text);
+		EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_EVENT_FORMAT)))
+			.WillOnce(DoAll(amdsmi::SaveInputPayload(&format_query),
+					amdsmi::SetPayload(format),
+					Return(0)))
+			.RetiresOnSaturation();
+	}
+
+	void destroy(amdsmi_event_set set)
+	{
+		EXPECT_CALL(*g_system_mock, Munmap(region.data(), SMI_EVENT_RING_SIZE))
+			.WillOnce(Return(0));
+		ASSERT_EQ(amdsmi_event_destroy(set), AMDSMI_STATUS_SUCCESS);
+	}
+
+	std::vector<uint8_t> region;
+	smi_event_format_query format_query;
+};
+
+TEST_F(AmdSmiEventRingTests, RendersRecordsInLibrary)
+{
+	amdsmi_event_set set = create();
+	amdsmi_event_entry_t event;
+	smi_vf_partition_info partition = {};
+	const uint64_t vf_handle = (0x1234ULL << 32) | 0x4567;
+	smi_device_info in_payload;
+	smi_in_hdr in_hdr;
+
+	ASSERT_NE(((struct smi_event_set_s *)set)->rings, nullptr);
+
+	push(AMDSMI_EVENT_CATEGORY_PP, 3, SMI_PF_INDEX, (5ULL << 32) | 6, 1709210096789000ULL);
+	push(AMDSMI_EVENT_CATEGORY_VF, 1, 2, 0xABCD, 946684799001000ULL);
+	push(AMDSMI_EVENT_CATEGORY_PP, 3, 2, (7ULL << 32) | 8, 946684799001000ULL);
+
+	/* queued records are served without waiting on the fd */
+	EXPECT_CALL(*g_system_mock, Poll(_, _, _)).Times(0);
+
+	expect_format(SMI_EVENT_ARG_32_32, "first %u second %u");
+	ASSERT_EQ(amdsmi_event_read(set, 0, &event), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(format_query.category, (uint32_t)AMDSMI_EVENT_CATEGORY_PP);
+	ASSERT_EQ(format_query.subcode, 3u);
+	ASSERT_EQ(event.category, (uint32_t)AMDSMI_EVENT_CATEGORY_PP);
+	ASSERT_EQ(event.subcode, 3u);
+	ASSERT_EQ(event.level, 2u);
+	ASSERT_EQ(event.data, (5ULL << 32) | 6);
+	ASSERT_EQ(event.dev_id, GPU_MOCK_HANDLE.handle);
+	ASSERT_EQ(event.fcn_id.handle, GPU_MOCK_HANDLE.handle);
+	ASSERT_STREQ(event.date, "2024-02-29:12:34:56.789");
+	ASSERT_STREQ(event.message, "first 5 second 6");
+
+	/* driver formats are not trusted beyond integer conversions */
+	partition.num_vf_enabled = 4;
+	partition.partition[2].id.handle = vf_handle;
+	PrepareIoctl(SMI_CMD_CODE_GET_VF_PARTITIONING_INFO, &in_hdr, &in_payload, partition);
+	expect_format(SMI_EVENT_ARG_64, "vf %s");
+	ASSERT_EQ(amdsmi_event_read(set, 0, &event), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(in_payload.dev_id.handle, GPU_MOCK_HANDLE.handle);
+	ASSERT_EQ(event.fcn_id.handle, vf_handle);
+	ASSERT_STREQ(event.date, "1999-12-31:23:59:59.001");
+	ASSERT_STREQ(event.message, "");
+
+	/* formats and VF handles come from the caches now */
+	EXPECT_CALL(*g_system_mock, Ioctl(_)).Times(0);
+	ASSERT_EQ(amdsmi_event_read(set, 0, &event), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(event.fcn_id.handle, vf_handle);
+	ASSERT_STREQ(event.message, "first 7 second 8");
+
+	EXPECT_CALL(*g_system_mock, Poll(_, nullptr, 0)).WillOnce(Return(AMDSMI_STATUS_TIMEOUT));
+	ASSERT_EQ(amdsmi_event_read(set, 0, &event), AMDSMI_STATUS_TIMEOUT);
+
+	destroy(set);
+}
+
+TEST_F(AmdSmiEventRingTests, WaitsForNextBatch)
+{
+	amdsmi_event_set set = create();
+	amdsmi_event_entry_t event;
+
+	expect_format(SMI_EVENT_ARG_NONE, "no data 100%%");
+
+	/* a readable fd with nothing new is polled again */
+	EXPECT_CALL(*g_system_mock, Poll(_, nullptr, 1000))
+		.WillOnce(Return(AMDSMI_STATUS_SUCCESS))
+		.WillOnce(DoAll(InvokeWithoutArgs([this]() {
+					push(AMDSMI_EVENT_CATEGORY_PP, 1, SMI_PF_INDEX, 0, 0);
+				}),
+				Return(AMDSMI_STATUS_SUCCESS)));
+	ASSERT_EQ(amdsmi_event_read(set, 1000, &event), AMDSMI_STATUS_SUCCESS);
+	ASSERT_STREQ(event.message, "no data 100%");
+	ASSERT_STREQ(event.date, "--N/A--");
+
+	EXPECT_CALL(*g_system_mock, Poll(_, nullptr, 1000))
+		.WillOnce(Return(AMDSMI_STATUS_UNKNOWN_ERROR));
+	ASSERT_EQ(amdsmi_event_read(set, 1000, &event), AMDSMI_STATUS_API_FAILED);
+
+	destroy(set);
+}
+
+TEST_F(AmdSmiEventRingTests, ReportsLostRecords)
+{
+	amdsmi_event_set set = create();
+	amdsmi_event_entry_t event;
+	uint64_t i;
+
+	/* the reader starts at the head seen when the ring got mapped */
+	for (i = 0; i < SMI_EVENT_RING_ENTRIES + 10; i++)
+		push(AMDSMI_EVENT_CATEGORY_PP, 2, SMI_PF_INDEX, i, 1000);
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_EVENT_FORMAT)))
+		.WillOnce(amdsmi::SetResponseStatus(AMDSMI_STATUS_NOT_SUPPORTED));
+	ASSERT_EQ(amdsmi_event_read(set, 0, &event), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(event.category, (uint32_t)AMDSMI_EVENT_CATEGORY_DRIVER);
+	ASSERT_EQ(event.subcode, (uint32_t)AMDSMI_EVENT_DRIVER_BUFFER_OVERFLOW);
+	ASSERT_EQ(event.data, 11u);
+	ASSERT_STREQ(event.message, "");
+
+	/* then the oldest record that survived */
+	expect_format(SMI_EVENT_ARG_64, "value %llu");
+	ASSERT_EQ(amdsmi_event_read(set, 0, &event), AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(event.category, (uint32_t)AMDSMI_EVENT_CATEGORY_PP);
+	ASSERT_EQ(event.data, 11u);
+	ASSERT_STREQ(event.message, "value 11");
+
+	destroy(set);
+}
+
+TEST_F(AmdSmiEventRingTests, FailsWhenRingIsUnknown)
+{
+	amdsmi_processor_handle processor = &GPU_MOCK_HANDLE;
+	smi_event_handle_t mocked_resp = {};
+	smi_event_set_config in_payload;
+	smi_in_hdr in_hdr;
+	amdsmi_event_set set = NULL;
+
+	ring()->version = SMI_EVENT_RING_VERSION + 1;
+
+	PrepareIoctl(SMI_CMD_CODE_CREATE_EVENT, &in_hdr, &in_payload, mocked_resp);
+	EXPECT_CALL(*g_system_mock, Mmap(_, SMI_EVENT_RING_SIZE))
+		.WillOnce(Return(region.data()));
+	EXPECT_CALL(*g_system_mock, Munmap(region.data(), SMI_EVENT_RING_SIZE))
+		.WillOnce(Return(0));
+	ASSERT_EQ(amdsmi_event_create(&processor, 1, 0xC0FFEE, &set), AMDSMI_STATUS_API_FAILED);
+}
 #endif
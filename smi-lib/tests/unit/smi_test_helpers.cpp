@@ -46,7 +46,7 @@ SystemMock *GetSystemMock()
 	return g_system_mock.get();
 }
 
-void AmdSmiTest::initialize_smi_lib(uint32_t version)
+void AmdSmiTest::initialize_smi_lib(uint32_t version, uint64_t init_flags)
 {
 	handshake_version = version;
 	// set the appropriate version for successful handshake
@@ -62,7 +62,7 @@ void AmdSmiTest::initialize_smi_lib(uint32_t version)
 	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_SERVER_STATIC_INFO)))
 		.WillOnce(testing::DoAll(SetPayload(server_info_mock), testing::Return(0)));
 
-	int res = amdsmi_init(AMDSMI_INIT_ALL_PROCESSORS);
+	int res = amdsmi_init(init_flags);
 	ASSERT_EQ(res, AMDSMI_STATUS_SUCCESS);
 
 	Mock::VerifyAndClearExpectations(GetSystemMock());
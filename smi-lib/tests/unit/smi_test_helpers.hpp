@@ -83,7 +83,8 @@ void *mem_aligned_alloc(void **mem, size_t alignment, size_t size);
 class AmdSmiTest : public ::testing::Test {
 protected:
 
-	void initialize_smi_lib(uint32_t version = SMI_VERSION_MAX);
+	void initialize_smi_lib(uint32_t version = SMI_VERSION_MAX,
+				uint64_t init_flags = AMDSMI_INIT_ALL_PROCESSORS);
 
 	void finalize_smi_lib();
 
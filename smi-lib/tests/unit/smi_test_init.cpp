@@ -20,6 +20,7 @@
  * THE SOFTWARE.
  */
 
+#include <future>
 #include <memory>
 #include <thread>
 
@@ -448,3 +449,141 @@ TEST_F(AmdSmiInitTests, InitTest_TwoThreadsFiniAtEnd)
 	ASSERT_EQ(dev_cnt_res, AMDSMI_STATUS_SUCCESS);
 	ASSERT_EQ(dev_cnt, server_info_mock.num_devices);
 }
+
+TEST_F(AmdSmiInitTests, InitTest_ConcurrentFdPerThread)
+{
+	int dev_cnt_res = AMDSMI_STATUS_NOT_SUPPORTED;
+	unsigned int dev_cnt = 0;
+	smi_server_static_info server_info_mock = {};
+	server_info_mock.num_devices = 7;
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_HANDSHAKE)))
+		.Times(2)
+		.WillRepeatedly(SetResponse(
+			smi_ioctl_cmd{ {}, { AMDSMI_STATUS_SUCCESS }, { SMI_VERSION_MAX } }));
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_SERVER_STATIC_INFO)))
+		.WillOnce(DoAll(SetPayload(server_info_mock), Return(0)));
+
+	/* one fd for init, one for the worker thread */
+	EXPECT_CALL(*g_system_mock, Open(_))
+		.Times(2)
+		.WillRepeatedly(Return(0));
+
+	int res = amdsmi_init(AMDSMI_INIT_AMD_GPUS | AMDSMI_INIT_CONCURRENT);
+	EXPECT_EQ(res, AMDSMI_STATUS_SUCCESS);
+
+	/* the worker's fd is closed when the thread exits */
+	EXPECT_CALL(*g_system_mock, Close(_))
+		.Times(1)
+		.WillOnce(Return(0));
+
+	std::thread tt([&dev_cnt_res, &dev_cnt]() {
+		dev_cnt_res = amdsmi_get_processor_handles(NULL, &dev_cnt, NULL);
+	});
+	tt.join();
+
+	testing::Mock::VerifyAndClearExpectations(g_system_mock.get());
+
+	ASSERT_EQ(dev_cnt_res, AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(dev_cnt, server_info_mock.num_devices);
+
+	EXPECT_CALL(*g_system_mock, Close(_))
+		.Times(1)
+		.WillOnce(Return(0));
+
+	ASSERT_EQ(amdsmi_shut_down(), AMDSMI_STATUS_SUCCESS);
+}
+
+TEST_F(AmdSmiInitTests, InitTest_ConcurrentFdKeepsInitMode)
+{
+	int dev_cnt_res = AMDSMI_STATUS_NOT_SUPPORTED;
+	unsigned int dev_cnt = 0;
+	smi_server_static_info server_info_mock = {};
+	server_info_mock.num_devices = 7;
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_HANDSHAKE)))
+		.Times(2)
+		.WillRepeatedly(SetResponse(
+			smi_ioctl_cmd{ {}, { AMDSMI_STATUS_SUCCESS }, { SMI_VERSION_MAX } }));
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_SERVER_STATIC_INFO)))
+		.WillOnce(DoAll(SetPayload(server_info_mock), Return(0)));
+
+	/* init falls back to read only, the worker must not try read write again */
+	EXPECT_CALL(*g_system_mock, Open(SMI_RDWR))
+		.WillOnce(Return(SMI_INVAL_HANDLE));
+	EXPECT_CALL(*g_system_mock, Open(SMI_READONLY))
+		.Times(2)
+		.WillRepeatedly(Return(0));
+
+	int res = amdsmi_init(AMDSMI_INIT_AMD_GPUS | AMDSMI_INIT_CONCURRENT);
+	EXPECT_EQ(res, AMDSMI_STATUS_SUCCESS);
+
+	std::thread tt([&dev_cnt_res, &dev_cnt]() {
+		dev_cnt_res = amdsmi_get_processor_handles(NULL, &dev_cnt, NULL);
+	});
+	tt.join();
+
+	testing::Mock::VerifyAndClearExpectations(g_system_mock.get());
+
+	ASSERT_EQ(dev_cnt_res, AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(dev_cnt, server_info_mock.num_devices);
+}
+
+TEST_F(AmdSmiInitTests, InitTest_ConcurrentShutdownLeavesThreadFd)
+{
+	const smi_file_handle init_fd = 3;
+	const smi_file_handle thread_fd = 5;
+	int first_res = AMDSMI_STATUS_NOT_SUPPORTED;
+	int second_res = AMDSMI_STATUS_SUCCESS;
+	unsigned int dev_cnt = 0;
+	smi_server_static_info server_info_mock = {};
+	server_info_mock.num_devices = 7;
+	std::promise<void> attached;
+	std::promise<void> shut_down;
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_HANDSHAKE)))
+		.Times(2)
+		.WillRepeatedly(SetResponse(
+			smi_ioctl_cmd{ {}, { AMDSMI_STATUS_SUCCESS }, { SMI_VERSION_MAX } }));
+
+	EXPECT_CALL(*g_system_mock, Ioctl(amdsmi::SmiCmd(SMI_CMD_CODE_GET_SERVER_STATIC_INFO)))
+		.WillOnce(DoAll(SetPayload(server_info_mock), Return(0)));
+
+	EXPECT_CALL(*g_system_mock, Open(_))
+		.WillOnce(Return(init_fd))
+		.WillOnce(Return(thread_fd));
+
+	int res = amdsmi_init(AMDSMI_INIT_AMD_GPUS | AMDSMI_INIT_CONCURRENT);
+	EXPECT_EQ(res, AMDSMI_STATUS_SUCCESS);
+
+	std::thread tt([&]() {
+		first_res = amdsmi_get_processor_handles(NULL, &dev_cnt, NULL);
+		attached.set_value();
+		shut_down.get_future().wait();
+		/* the thread closes its detached fd itself on its next request */
+		second_res = amdsmi_get_processor_handles(NULL, &dev_cnt, NULL);
+	});
+	attached.get_future().wait();
+
+	/* shutdown only closes the init fd, the worker may still be using its own */
+	EXPECT_CALL(*g_system_mock, Close(init_fd))
+		.WillOnce(Return(0));
+	EXPECT_CALL(*g_system_mock, Close(thread_fd))
+		.Times(0);
+
+	ASSERT_EQ(amdsmi_shut_down(), AMDSMI_STATUS_SUCCESS);
+	testing::Mock::VerifyAndClearExpectations(g_system_mock.get());
+
+	EXPECT_CALL(*g_system_mock, Close(thread_fd))
+		.WillOnce(Return(0));
+
+	shut_down.set_value();
+	tt.join();
+
+	testing::Mock::VerifyAndClearExpectations(g_system_mock.get());
+
+	ASSERT_EQ(first_res, AMDSMI_STATUS_SUCCESS);
+	ASSERT_EQ(second_res, AMDSMI_STATUS_NOT_INIT);
+}
@@ -152,3 +152,104 @@ TEST_F(AmdSmiRasCperTests, MoreData) {
     ret = amdsmi_gpu_get_cper_entries(&GPU_MOCK_HANDLE, severity_mask, cper_data, &buf_size, cper_hdrs, &entry_count, &cursor);
     ASSERT_EQ(ret, AMDSMI_STATUS_MORE_DATA);
 }
+
+TEST_F(AmdSmiRasCperTests, MoreDataReturnsPartialEntries) {
+    int ret;
+    char cper_data[1024];
+    uint64_t buf_size = sizeof(cper_data);
+    amdsmi_cper_hdr* cper_hdrs[10];
+    uint64_t entry_count = 10;
+    uint64_t cursor = 5;
+    uint32_t severity_mask = AMDSMI_CPER_SEV_NUM;
+    const uint32_t record_length = sizeof(struct smi_cper_hdr);
+
+    struct smi_cper *cper;
+#ifdef _WIN64
+    cper = (struct smi_cper*)calloc(1, sizeof(struct smi_cper));
+#else
+    cper = (struct smi_cper*)amdsmi::mem_aligned_alloc((void**)&cper, 4096, sizeof(struct smi_cper));
+#endif
+    memset(cper, 0, sizeof(struct smi_cper));
+
+#ifdef _WIN64
+    EXPECT_CALL(*g_system_mock, Calloc(testing::_, testing::_)).WillOnce(testing::Return(cper));
+#else
+    EXPECT_CALL(*g_system_mock, AlignedAlloc(testing::_, testing::_, testing::_)).WillOnce(testing::Return(cper));
+#endif
+    EXPECT_CALL(*g_system_mock, Ioctl(_)).WillOnce(testing::DoAll(
+        testing::Invoke([cper, record_length](smi_ioctl_cmd *) {
+            struct smi_cper_hdr *hdr;
+
+            for (uint32_t i = 0; i < 2; i++) {
+                hdr = (struct smi_cper_hdr *)(cper->cper_data + i * record_length);
+                hdr->record_length = record_length;
+                hdr->error_severity = SMI_CPER_SEV_FATAL;
+                hdr->record_id[0] = (char)('a' + i);
+                cper->cper_hdrs[i] = i * record_length;
+            }
+            cper->entry_count = 2;
+            cper->cursor = 42;
+        }),
+        SetResponseStatus(SMI_STATUS_MORE_DATA)));
+
+    ret = amdsmi_gpu_get_cper_entries(&GPU_MOCK_HANDLE, severity_mask, cper_data, &buf_size, cper_hdrs, &entry_count, &cursor);
+
+    ASSERT_EQ(ret, AMDSMI_STATUS_MORE_DATA);
+    ASSERT_EQ(entry_count, 2u);
+    ASSERT_EQ(buf_size, 2u * record_length);
+    ASSERT_EQ(cursor, 42u);
+    ASSERT_EQ((char *)cper_hdrs[1], cper_data + record_length);
+    ASSERT_EQ(cper_hdrs[0]->record_id[0], 'a');
+    ASSERT_EQ(cper_hdrs[1]->record_id[0], 'b');
+}
+
+TEST_F(AmdSmiRasCperTests, LegacyVersionFiltersAndAdvancesCursor) {
+    int ret;
+    char cper_data[1024];
+    uint64_t buf_size = sizeof(cper_data);
+    amdsmi_cper_hdr* cper_hdrs[10];
+    uint64_t entry_count = 10;
+    uint64_t cursor = 5;
+    uint32_t severity_mask = SMI_CPER_SEV_FATAL;
+    const uint32_t record_length = sizeof(struct smi_cper_hdr);
+
+    finalize_smi_lib();
+    initialize_smi_lib(SMI_VERSION_BETA_4);
+
+    struct smi_cper *cper;
+#ifdef _WIN64
+    cper = (struct smi_cper*)calloc(1, sizeof(struct smi_cper));
+#else
+    cper = (struct smi_cper*)amdsmi::mem_aligned_alloc((void**)&cper, 4096, sizeof(struct smi_cper));
+#endif
+    memset(cper, 0, sizeof(struct smi_cper));
+
+#ifdef _WIN64
+    EXPECT_CALL(*g_system_mock, Calloc(testing::_, testing::_)).WillOnce(testing::Return(cper));
+#else
+    EXPECT_CALL(*g_system_mock, AlignedAlloc(testing::_, testing::_, testing::_)).WillOnce(testing::Return(cper));
+#endif
+    EXPECT_CALL(*g_system_mock, Ioctl(_)).WillOnce(testing::DoAll(
+        testing::Invoke([cper, record_length](smi_ioctl_cmd *) {
+            struct smi_cper_hdr *hdr;
+
+            for (uint32_t i = 0; i < 3; i++) {
+                hdr = (struct smi_cper_hdr *)(cper->cper_data + i * record_length);
+                hdr->record_length = record_length;
+                hdr->error_severity = (i == 1) ? SMI_CPER_SEV_FATAL : SMI_CPER_SEV_NON_FATAL_CORRECTED;
+                hdr->record_id[0] = (char)('a' + i);
+                cper->cper_hdrs[i] = i * record_length;
+            }
+            cper->entry_count = 3;
+            cper->cursor = 42;
+        }),
+        SetResponseStatus(SMI_STATUS_SUCCESS)));
+
+    ret = amdsmi_gpu_get_cper_entries(&GPU_MOCK_HANDLE, severity_mask, cper_data, &buf_size, cper_hdrs, &entry_count, &cursor);
+
+    ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
+    ASSERT_EQ(entry_count, 1u);
+    ASSERT_EQ(buf_size, (uint64_t)record_length);
+    ASSERT_EQ(cursor, 8u);
+    ASSERT_EQ(cper_hdrs[0]->record_id[0], 'b');
+}
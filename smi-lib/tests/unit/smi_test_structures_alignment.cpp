@@ -56,6 +56,7 @@ TODO: Fix memory layout for these structures:
 	X(amdsmi_power_cap_info_t) \
 	X(amdsmi_vbios_info_t) \
 	X(amdsmi_gpu_cache_info_t) \
+	X(amdsmi_sched_event_stats_t) \
 	X(amdsmi_fw_info_t) \
 	X(amdsmi_asic_info_t) \
 	X(amdsmi_driver_info_t) \
@@ -30,6 +30,7 @@ extern "C" {
 #include <poll.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 }
 
 using namespace ::testing;
@@ -51,6 +52,7 @@ extern int __real_ioctl(int fd, unsigned long request, void* buffer);
 extern int __real_open(const char *pathname, int flags, int mode);
 extern int __real_access(const char *pathname, int mode);
 extern ssize_t __real_write(int fd, void *buf, size_t count);
+extern void *__real_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset);
 
 
 static const int MAGIC_FD = 0x12345578;
@@ -62,12 +64,14 @@ static int write_cnt;
 static int ioctl_cnt;
 static int open_cnt;
 static int access_cnt;
+static int mmap_cnt;
 
 static int poll_ret;
 static ssize_t read_ret;
 static int ioctl_ret;
 static int open_ret;
 static int access_ret;
+static void *mmap_ret;
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-declarations"
@@ -127,6 +131,17 @@ int __wrap_access(const char *pathname, int mode)
 	return __real_access(pathname, mode);
 }
 
+void *__wrap_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset)
+{
+	if (fd == MAGIC_FD) {
+		mmap_cnt++;
+		/* the snapshot must never be mapped writable */
+		if (prot != PROT_READ || flags != MAP_SHARED)
+			return MAP_FAILED;
+		return mmap_ret;
+	}
+	return __real_mmap(addr, length, prot, flags, fd, offset);
+}
 
 #pragma GCC diagnostic pop
 }
@@ -142,6 +157,7 @@ protected:
 		ioctl_cnt = 0;
 		open_cnt = 0;
 		access_cnt = 0;
+		mmap_cnt = 0;
 
 		poll_ret = 0; // timeout by default
 		read_ret = 0; // EOF by default
@@ -149,6 +165,7 @@ protected:
 		ioctl_ret = -1; // error by default
 		open_ret = -1; // error by default
 		access_ret = -1; // error by default
+		mmap_ret = MAP_FAILED; // error by default
 	}
 
 	void TearDown() override
@@ -571,3 +588,39 @@ TEST_F(AmdSmiLnxWrapperTests, TestStrncpyCount)
 
 	ASSERT_EQ(ret, AMDSMI_STATUS_SUCCESS);
 }
+
+TEST_F(AmdSmiLnxWrapperTests, TestMmapUserModeDriver)
+{
+	auto wrapper = get_system_wrapper();
+
+	void *addr = wrapper->mmap(MAGIC_FD, SMI_METRICS_SNAPSHOT_SIZE);
+
+	ASSERT_EQ(addr, nullptr);
+	ASSERT_EQ(mmap_cnt, 0);
+}
+
+TEST_F(AmdSmiLnxWrapperTests, TestMmapSuccess)
+{
+	EXPECT_CALL(*amdsmi::g_system_mock, GetDriverMode())
+		.WillRepeatedly(Return(1));
+	auto wrapper = get_system_wrapper();
+	static uint8_t region[64];
+	mmap_ret = region;
+
+	void *addr = wrapper->mmap(MAGIC_FD, SMI_METRICS_SNAPSHOT_SIZE);
+
+	ASSERT_EQ(addr, region);
+	ASSERT_EQ(mmap_cnt, 1);
+}
+
+TEST_F(AmdSmiLnxWrapperTests, TestMmapFailed)
+{
+	EXPECT_CALL(*amdsmi::g_system_mock, GetDriverMode())
+		.WillRepeatedly(Return(1));
+	auto wrapper = get_system_wrapper();
+
+	void *addr = wrapper->mmap(MAGIC_FD, SMI_METRICS_SNAPSHOT_SIZE);
+
+	ASSERT_EQ(addr, nullptr);
+	ASSERT_EQ(mmap_cnt, 1);
+}